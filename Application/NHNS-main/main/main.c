@@ -2,23 +2,218 @@
 #include <string.h>
 #include "nhns_status_codes.h"
 #include "board.h"
+#include "build_stamp.h"
+#include "cdc.h"
+#include "clock.h"
+#include "completion.h"
+#include "crc.h"
+#include "dlog.h"
+#include "dmacopy.h"
+#include "dspbench.h"
+#include "dspfix.h"
+#include "dspgraph.h"
+#include "emac.h"
+#include "heap.h"
+#include "kvstore.h"
+#include "lowpower.h"
+#include "net.h"
+#include "nnrt.h"
+#include "pool.h"
+#include "profiler.h"
+#include "rtos.h"
+#include "rtstats.h"
+#include "sampler.h"
+#include "spectrum.h"
+#include "telemetry.h"
 #include "uart.h"
 
 // --- Defines ---
 
+#define MAIN_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+#define MAIN_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define MAIN_POLL_PERIOD_MS  100
+
 // --- Types ---
 
 // --- Global Variables ---
 
+static const char gszBanner[] = PRJ_NAME " " APPLICATION_NAME " " PRJ_GIT_HASH "\r\n";
+
+RTOS_TASK_DEFINE(main, MAIN_TASK_STACK_SIZE);
+
 // --- Functions ---
 
+/**
+ * @brief Handle single-key commands received on the debug console
+ */
+static void MAIN_PollConsole(void)
+{
+    uint8_t abInput[16];
+    uint16_t bRead = 0;
+
+    if (UART_Read(UART_INSTANCE_DEBUG, abInput, sizeof(abInput), &bRead) != NHNS_STATUS_OK)
+    {
+        return;
+    }
+
+    for (uint16_t bIndex = 0; bIndex < bRead; bIndex++)
+    {
+        DLOG_DEBUG("console: key '%c'", abInput[bIndex]);
+
+        switch (abInput[bIndex])
+        {
+            case 'p':
+                PROFILER_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'P':
+                PROFILER_Reset();
+                break;
+            case 's':
+                RTSTATS_SetStreaming(!RTSTATS_IsStreaming());
+                break;
+            case 'h':
+                HEAP_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'm':
+                POOL_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'M':
+                POOL_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'l':
+                LOWPOWER_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'e':
+                EMAC_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'n':
+                NET_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 't':
+                TELEMETRY_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'T':
+                TELEMETRY_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'u':
+                CDC_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'U':
+                CDC_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'k':
+                KVSTORE_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'K':
+                KVSTORE_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'c':
+                CRC_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'd':
+                DMACOPY_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'D':
+                DMACOPY_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'a':
+                SAMPLER_Dump(UART_INSTANCE_DEBUG);
+                break;
+            case 'A':
+                SAMPLER_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'g':
+                DSPGRAPH_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'b':
+                DSPBENCH_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'q':
+                DSPFIX_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'i':
+                NNRT_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'f':
+                SPECTRUM_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+            case 'w':
+                COMPLETION_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+#ifdef FW_DEBUG
+            case 'r':
+                UART_Benchmark(UART_INSTANCE_DEBUG);
+                break;
+#endif
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Application entry task
+ * @param pvParameters - Unused
+ */
+static void MAIN_Task(void *pvParameters)
+{
+    uint32_t dwBoots   = 0;
+    uint16_t wLength   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    (void)pvParameters;
+
+    UART_TransmitAsync(UART_INSTANCE_DEBUG, (const uint8_t *)gszBanner, sizeof(gszBanner) - 1);
+    DLOG_INFO("main: running, %u heap allocations at start-up", RTOS_GetHeapAllocations());
+
+    // Every kernel object so far is static, see Service/rtos
+    configASSERT(RTOS_GetHeapAllocations() == 0);
+
+    // Count resets in the key-value store, a missing or damaged counter starts over
+    if (KVSTORE_Get("boot_count", &dwBoots, sizeof(dwBoots), &wLength) != NHNS_STATUS_OK || wLength != sizeof(dwBoots))
+    {
+        dwBoots = 0;
+    }
+    dwBoots++;
+    nRet = KVSTORE_Set("boot_count", &dwBoots, sizeof(dwBoots));
+    DLOG_INFO("main: boot %u, saved (%d)", dwBoots, nRet);
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(MAIN_POLL_PERIOD_MS));
+        MAIN_PollConsole();
+    }
+}
+
 int main(void)
 {
-    // 1) STM32 HAL library initialization
+    // 1) STM32 HAL library initialization, then the heap regions and pools before anything can allocate
     HAL_Init();
+    HEAP_Init();
+    POOL_Init();
 
-    // 2) Configure the system clock
+    // 2) Configure the system clock, then start the microsecond clock from it
     SystemClock_Config();
+    CLOCK_Init();
+
+    // 3) Bring up the debug console, the cycle counter, the completion benchmark, the STOP timebase, the CRC unit, the copy engine and the ADCs
+    UART_Init(UART_INSTANCE_DEBUG);
+    PROFILER_Init();
+    COMPLETION_Init();
+    LOWPOWER_Init();
+    CRC_Init();
+    DMACOPY_Init();
+    SAMPLER_Init();
+
+    // 4) Create the application tasks and hand over to the scheduler, the net task brings the link up
+    RTSTATS_Init(UART_INSTANCE_DEBUG);
+    DLOG_Init(UART_INSTANCE_DEBUG);
+    NET_Init();
+    TELEMETRY_Init();
+    CDC_Init();
+    KVSTORE_Init();
+    RTOS_TASK_CREATE(main, MAIN_Task, NULL, MAIN_TASK_PRIORITY);
+    vTaskStartScheduler();
 
     while (1)
     {
@@ -27,6 +27,21 @@ void SystemClock_Config(void)
     HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_3);
 }
 
+void SystemClock_Restore(void)
+{
+    // 1) STOP left the HSI as system clock and the PLL off, its configuration is kept
+    __HAL_RCC_PLL_ENABLE();
+    while (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == 0U)
+    {
+    }
+
+    // 2) Switch back to the PLL
+    __HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+    while (__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+    {
+    }
+}
+
 /**
  * @brief Initialize the global MSP
  */
@@ -65,6 +80,48 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
         GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
         GPIO_InitStruct.Alternate = UART_DEBUG_AF;
         HAL_GPIO_Init(UART_DEBUG_RX_PORT, &GPIO_InitStruct);
+
+        // Configure the DMA streams linked by the driver
+        __HAL_RCC_DMA1_CLK_ENABLE();
+
+        if (huart->hdmatx != NULL)
+        {
+            huart->hdmatx->Instance                 = UART_DEBUG_TX_DMA_STREAM;
+            huart->hdmatx->Init.Channel             = UART_DEBUG_TX_DMA_CHANNEL;
+            huart->hdmatx->Init.Direction           = DMA_MEMORY_TO_PERIPH;
+            huart->hdmatx->Init.PeriphInc           = DMA_PINC_DISABLE;
+            huart->hdmatx->Init.MemInc              = DMA_MINC_ENABLE;
+            huart->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            huart->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+            huart->hdmatx->Init.Mode                = DMA_NORMAL;
+            huart->hdmatx->Init.Priority            = DMA_PRIORITY_LOW;
+            huart->hdmatx->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+            HAL_DMA_Init(huart->hdmatx);
+
+            HAL_NVIC_SetPriority(UART_DEBUG_TX_DMA_IRQn, UART_DEBUG_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(UART_DEBUG_TX_DMA_IRQn);
+        }
+
+        if (huart->hdmarx != NULL)
+        {
+            huart->hdmarx->Instance                 = UART_DEBUG_RX_DMA_STREAM;
+            huart->hdmarx->Init.Channel             = UART_DEBUG_RX_DMA_CHANNEL;
+            huart->hdmarx->Init.Direction           = DMA_PERIPH_TO_MEMORY;
+            huart->hdmarx->Init.PeriphInc           = DMA_PINC_DISABLE;
+            huart->hdmarx->Init.MemInc              = DMA_MINC_ENABLE;
+            huart->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+            huart->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+            huart->hdmarx->Init.Mode                = DMA_CIRCULAR;
+            huart->hdmarx->Init.Priority            = DMA_PRIORITY_MEDIUM;
+            huart->hdmarx->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+            HAL_DMA_Init(huart->hdmarx);
+
+            HAL_NVIC_SetPriority(UART_DEBUG_RX_DMA_IRQn, UART_DEBUG_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(UART_DEBUG_RX_DMA_IRQn);
+        }
+
+        HAL_NVIC_SetPriority(UART_DEBUG_IRQn, UART_DEBUG_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(UART_DEBUG_IRQn);
     }
 }
 
@@ -81,5 +138,298 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
 
         HAL_GPIO_DeInit(UART_DEBUG_TX_PORT, UART_DEBUG_TX_PIN);
         HAL_GPIO_DeInit(UART_DEBUG_RX_PORT, UART_DEBUG_RX_PIN);
+
+        // Release the DMA streams and interrupts
+        if (huart->hdmatx != NULL)
+        {
+            HAL_NVIC_DisableIRQ(UART_DEBUG_TX_DMA_IRQn);
+            HAL_DMA_DeInit(huart->hdmatx);
+        }
+
+        if (huart->hdmarx != NULL)
+        {
+            HAL_NVIC_DisableIRQ(UART_DEBUG_RX_DMA_IRQn);
+            HAL_DMA_DeInit(huart->hdmarx);
+        }
+
+        HAL_NVIC_DisableIRQ(UART_DEBUG_IRQn);
+    }
+}
+
+/**
+ * @brief Clock the run-time statistics, microsecond clock and sampler trigger timers
+ * @param htim - TIM handle pointer
+ */
+void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == STATS_TIM)
+    {
+        STATS_TIM_CLOCK_ENABLE();
+    }
+    else if (htim->Instance == CLOCK_TIM)
+    {
+        CLOCK_TIM_CLOCK_ENABLE();
+    }
+    else if (htim->Instance == ADC_TIM)
+    {
+        ADC_TIM_CLOCK_ENABLE();
+    }
+}
+
+/**
+ * @brief Stop clocking the run-time statistics, microsecond clock and sampler trigger timers
+ * @param htim - TIM handle pointer
+ */
+void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == STATS_TIM)
+    {
+        STATS_TIM_CLOCK_DISABLE();
+    }
+    else if (htim->Instance == CLOCK_TIM)
+    {
+        HAL_NVIC_DisableIRQ(CLOCK_TIM_IRQn);
+        CLOCK_TIM_CLOCK_DISABLE();
+    }
+    else if (htim->Instance == ADC_TIM)
+    {
+        ADC_TIM_CLOCK_DISABLE();
+    }
+}
+
+/**
+ * @brief Configure the RMII pins and clocks of the Ethernet MAC
+ * @param heth - ETH handle pointer
+ */
+void HAL_ETH_MspInit(ETH_HandleTypeDef *heth)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    if (heth->Instance == ETH)
+    {
+        // Enable the MAC, MAC TX and MAC RX clocks
+        EMAC_CLOCK_ENABLE();
+
+        // Enable the GPIO clock(s)
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        __HAL_RCC_GPIOC_CLK_ENABLE();
+        __HAL_RCC_GPIOG_CLK_ENABLE();
+
+        GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+        GPIO_InitStruct.Pull      = GPIO_NOPULL;
+        GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+        GPIO_InitStruct.Alternate = EMAC_AF;
+
+        GPIO_InitStruct.Pin = EMAC_PORTA_PINS;
+        HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+        GPIO_InitStruct.Pin = EMAC_PORTB_PINS;
+        HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+        GPIO_InitStruct.Pin = EMAC_PORTC_PINS;
+        HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+        GPIO_InitStruct.Pin = EMAC_PORTG_PINS;
+        HAL_GPIO_Init(GPIOG, &GPIO_InitStruct);
+
+        HAL_NVIC_SetPriority(EMAC_IRQn, EMAC_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(EMAC_IRQn);
+    }
+}
+
+/**
+ * @brief Release the RMII pins and stop clocking the Ethernet MAC
+ * @param heth - ETH handle pointer
+ */
+void HAL_ETH_MspDeInit(ETH_HandleTypeDef *heth)
+{
+    if (heth->Instance == ETH)
+    {
+        HAL_NVIC_DisableIRQ(EMAC_IRQn);
+
+        // Disable the MAC clocks
+        EMAC_CLOCK_DISABLE();
+
+        HAL_GPIO_DeInit(GPIOA, EMAC_PORTA_PINS);
+        HAL_GPIO_DeInit(GPIOB, EMAC_PORTB_PINS);
+        HAL_GPIO_DeInit(GPIOC, EMAC_PORTC_PINS);
+        HAL_GPIO_DeInit(GPIOG, EMAC_PORTG_PINS);
+    }
+}
+
+/**
+ * @brief Configure the data and VBUS pins and the clock of the USB OTG_FS core
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_MspInit(PCD_HandleTypeDef *hpcd)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    if (hpcd->Instance == USB_INSTANCE)
+    {
+        // Enable the GPIO clock(s)
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+
+        GPIO_InitStruct.Pin       = USB_DATA_PINS;
+        GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+        GPIO_InitStruct.Pull      = GPIO_NOPULL;
+        GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+        GPIO_InitStruct.Alternate = USB_AF;
+        HAL_GPIO_Init(USB_PORT, &GPIO_InitStruct);
+
+        // VBUS sensing reads the pin directly, it only has to be an input
+        GPIO_InitStruct.Pin  = USB_VBUS_PIN;
+        GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(USB_PORT, &GPIO_InitStruct);
+
+        // Enable USB clock
+        USB_CLOCK_ENABLE();
+
+        HAL_NVIC_SetPriority(USB_IRQn, USB_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(USB_IRQn);
+    }
+}
+
+/**
+ * @brief Release the USB pins and stop clocking the OTG_FS core
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_MspDeInit(PCD_HandleTypeDef *hpcd)
+{
+    if (hpcd->Instance == USB_INSTANCE)
+    {
+        HAL_NVIC_DisableIRQ(USB_IRQn);
+        USB_CLOCK_DISABLE();
+        HAL_GPIO_DeInit(USB_PORT, USB_DATA_PINS | USB_VBUS_PIN);
+    }
+}
+
+/**
+ * @brief Clock the RTC from the LSE crystal
+ * @param hrtc - RTC handle pointer
+ */
+void HAL_RTC_MspInit(RTC_HandleTypeDef *hrtc)
+{
+    RCC_OscInitTypeDef RCC_OscInitStruct        = {0};
+    RCC_PeriphCLKInitTypeDef PeriphClkInitStruct = {0};
+
+    if (hrtc->Instance == RTC)
+    {
+        // The RTC clock selection lives in the backup domain
+        HAL_PWR_EnableBkUpAccess();
+
+        RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+        RCC_OscInitStruct.LSEState       = RCC_LSE_ON;
+        RCC_OscInitStruct.PLL.PLLState   = RCC_PLL_NONE;
+        HAL_RCC_OscConfig(&RCC_OscInitStruct);
+
+        PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_RTC;
+        PeriphClkInitStruct.RTCClockSelection    = RCC_RTCCLKSOURCE_LSE;
+        HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct);
+
+        __HAL_RCC_RTC_ENABLE();
+    }
+}
+
+/**
+ * @brief Stop clocking the RTC
+ * @param hrtc - RTC handle pointer
+ */
+void HAL_RTC_MspDeInit(RTC_HandleTypeDef *hrtc)
+{
+    if (hrtc->Instance == RTC)
+    {
+        __HAL_RCC_RTC_DISABLE();
+    }
+}
+
+/**
+ * @brief Clock the CRC unit and the DMA2 controller that feeds it
+ * @param hcrc - CRC handle pointer
+ */
+void HAL_CRC_MspInit(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc->Instance == CRC)
+    {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        HAL_NVIC_SetPriority(CRC_DMA_IRQn, CRC_DMA_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(CRC_DMA_IRQn);
+    }
+}
+
+/**
+ * @brief Stop clocking the CRC unit, DMA2 stays on for its other users
+ * @param hcrc - CRC handle pointer
+ */
+void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc->Instance == CRC)
+    {
+        HAL_NVIC_DisableIRQ(CRC_DMA_IRQn);
+        __HAL_RCC_CRC_CLK_DISABLE();
+    }
+}
+
+/**
+ * @brief Clock the ADCs, set the sampler input to analog and enable the overrun and DMA interrupts
+ * @param hadc - ADC handle pointer
+ * @note ADC2 and ADC3 only convert in triple mode, slaved to ADC1, and need nothing but their clock
+ */
+void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    if (hadc->Instance == ADC1)
+    {
+        __HAL_RCC_ADC1_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        // Enable the GPIO clock(s)
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+
+        GPIO_InitStruct.Pin  = SAMPLER_PIN;
+        GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(SAMPLER_PORT, &GPIO_InitStruct);
+
+        HAL_NVIC_SetPriority(SAMPLER_IRQn, SAMPLER_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(SAMPLER_IRQn);
+        HAL_NVIC_SetPriority(SAMPLER_DMA_IRQn, SAMPLER_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(SAMPLER_DMA_IRQn);
+    }
+    else if (hadc->Instance == ADC2)
+    {
+        __HAL_RCC_ADC2_CLK_ENABLE();
+    }
+    else if (hadc->Instance == ADC3)
+    {
+        __HAL_RCC_ADC3_CLK_ENABLE();
+    }
+}
+
+/**
+ * @brief Stop clocking the ADCs and release the sampler input, DMA2 stays on for its other users
+ * @param hadc - ADC handle pointer
+ */
+void HAL_ADC_MspDeInit(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+    {
+        HAL_NVIC_DisableIRQ(SAMPLER_IRQn);
+        HAL_NVIC_DisableIRQ(SAMPLER_DMA_IRQn);
+        __HAL_RCC_ADC1_CLK_DISABLE();
+        HAL_GPIO_DeInit(SAMPLER_PORT, SAMPLER_PIN);
+    }
+    else if (hadc->Instance == ADC2)
+    {
+        __HAL_RCC_ADC2_CLK_DISABLE();
+    }
+    else if (hadc->Instance == ADC3)
+    {
+        __HAL_RCC_ADC3_CLK_DISABLE();
     }
 }
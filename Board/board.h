@@ -19,6 +19,106 @@
 
 #define UART_DEBUG_AF              GPIO_AF7_USART3
 
+#define UART_DEBUG_IRQn            USART3_IRQn
+#define UART_DEBUG_IRQ_PRIORITY    6
+
+#define UART_DEBUG_TX_DMA_STREAM   DMA1_Stream3
+#define UART_DEBUG_TX_DMA_CHANNEL  DMA_CHANNEL_4
+#define UART_DEBUG_TX_DMA_IRQn     DMA1_Stream3_IRQn
+
+#define UART_DEBUG_RX_DMA_STREAM   DMA1_Stream1
+#define UART_DEBUG_RX_DMA_CHANNEL  DMA_CHANNEL_4
+#define UART_DEBUG_RX_DMA_IRQn     DMA1_Stream1_IRQn
+
+// Run-time statistics counter, must be one of the 32-bit timers on APB1
+#define STATS_TIM                  TIM2
+#define STATS_TIM_CLOCK_ENABLE()   __HAL_RCC_TIM2_CLK_ENABLE()
+#define STATS_TIM_CLOCK_DISABLE()  __HAL_RCC_TIM2_CLK_DISABLE()
+
+// Microsecond clock, a basic timer on APB1 (TIM6 is the HAL tick, see stm32f2xx_hal_timebase_tim.c)
+#define CLOCK_TIM                  TIM7
+#define CLOCK_TIM_CLOCK_ENABLE()   __HAL_RCC_TIM7_CLK_ENABLE()
+#define CLOCK_TIM_CLOCK_DISABLE()  __HAL_RCC_TIM7_CLK_DISABLE()
+#define CLOCK_TIM_IRQn             TIM7_IRQn
+#define CLOCK_TIM_IRQ_PRIORITY     0
+
+// Ethernet, RMII to the LAN8742A PHY
+#define EMAC_CLOCK_ENABLE()        __HAL_RCC_ETH_CLK_ENABLE()
+#define EMAC_CLOCK_DISABLE()       __HAL_RCC_ETH_CLK_DISABLE()
+
+#define EMAC_PORTA_PINS            (GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_7)    // REF_CLK, MDIO, CRS_DV
+#define EMAC_PORTB_PINS            GPIO_PIN_13                               // TXD1
+#define EMAC_PORTC_PINS            (GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5)    // MDC, RXD0, RXD1
+#define EMAC_PORTG_PINS            (GPIO_PIN_11 | GPIO_PIN_13)               // TX_EN, TXD0
+
+#define EMAC_AF                    GPIO_AF11_ETH
+#define EMAC_PHY_ADDRESS           LAN8742A_PHY_ADDRESS
+
+#define EMAC_IRQn                  ETH_IRQn
+#define EMAC_IRQ_PRIORITY          6
+
+// USB full-speed device on OTG_FS, 48 MHz from PLLQ. The PLL runs from the HSI, whose +-1 % is outside
+// the +-0.25 % USB allows, fit an HSE crystal before relying on the port across temperature
+#define USB_INSTANCE               USB_OTG_FS
+#define USB_CLOCK_ENABLE()         __HAL_RCC_USB_OTG_FS_CLK_ENABLE()
+#define USB_CLOCK_DISABLE()        __HAL_RCC_USB_OTG_FS_CLK_DISABLE()
+
+#define USB_PORT                   GPIOA
+#define USB_DATA_PINS              (GPIO_PIN_11 | GPIO_PIN_12)    // DM, DP
+#define USB_VBUS_PIN               GPIO_PIN_9
+#define USB_AF                     GPIO_AF10_OTG_FS
+
+#define USB_IRQn                   OTG_FS_IRQn
+#define USB_IRQ_PRIORITY           6
+
+// CRC unit, fed by DMA2 in memory-to-memory mode, which DMA1 cannot do. Any free DMA2 stream works
+#define CRC_DMA_STREAM             DMA2_Stream7
+#define CRC_DMA_CHANNEL            DMA_CHANNEL_0
+#define CRC_DMA_IRQn               DMA2_Stream7_IRQn
+#define CRC_DMA_IRQ_PRIORITY       6
+
+// Copy engine, a second DMA2 stream in memory-to-memory mode. The lowest stream number wins arbitration
+// ties, so bulk copies on stream 0 go ahead of the CRC feed on stream 7
+#define DMACOPY_DMA_STREAM         DMA2_Stream0
+#define DMACOPY_DMA_CHANNEL        DMA_CHANNEL_0
+#define DMACOPY_DMA_IRQn           DMA2_Stream0_IRQn
+#define DMACOPY_DMA_IRQ_PRIORITY   6
+
+// Completion benchmark, a vector with nothing behind it, pended from software in place of a peripheral
+#define COMPLETION_IRQn            EXTI0_IRQn
+#define COMPLETION_IRQ_PRIORITY    6
+
+// Sampler, ADC1 alone or ADC1 to ADC3 interleaved on PA3 (A0 of the Nucleo Arduino header). ADC1 has
+// DMA2 stream 0 or 4 on channel 0, and stream 0 is the copy engine
+#define SAMPLER_PORT               GPIOA
+#define SAMPLER_PIN                GPIO_PIN_3
+#define SAMPLER_CHANNEL            ADC_CHANNEL_3
+#define SAMPLER_IRQn               ADC_IRQn
+#define SAMPLER_DMA_STREAM         DMA2_Stream4
+#define SAMPLER_DMA_CHANNEL        DMA_CHANNEL_0
+#define SAMPLER_DMA_IRQn           DMA2_Stream4_IRQn
+#define SAMPLER_IRQ_PRIORITY       6
+
+// Sampler trigger, a timer on APB1 whose TRGO can start a regular conversion
+#define ADC_TIM                    TIM3
+#define ADC_TIM_CLOCK_ENABLE()     __HAL_RCC_TIM3_CLK_ENABLE()
+#define ADC_TIM_CLOCK_DISABLE()    __HAL_RCC_TIM3_CLK_DISABLE()
+#define ADC_TIM_TRIGGER            ADC_EXTERNALTRIGCONV_T3_TRGO
+
+// Key-value store in the last two 128K sectors, kept out of the image by the KVSTORE region of
+// STM32F207ZGTX_FLASH.ld. The store needs at least two sectors, all of the same size
+#define KVSTORE_FLASH_ADDRESS      0x080C0000U
+#define KVSTORE_FIRST_SECTOR       FLASH_SECTOR_10
+#define KVSTORE_SECTOR_COUNT       2
+#define KVSTORE_SECTOR_SIZE        0x20000U
+
+// Tickless idle, the RTC wake-up timer on the LSE is the STOP timebase and the console RX pin also wakes
+#define LOWPOWER_RTC_IRQn          RTC_WKUP_IRQn
+#define LOWPOWER_WAKEUP_PIN        UART_DEBUG_RX_PIN
+#define LOWPOWER_WAKEUP_PORT       UART_DEBUG_RX_PORT
+#define LOWPOWER_WAKEUP_IRQn       EXTI9_5_IRQn
+#define LOWPOWER_IRQ_PRIORITY      15
+
 // --- Functions ---
 
 /**
@@ -26,4 +126,10 @@
  */
 void SystemClock_Config(void);
 
+/**
+ * @brief Switch back to the PLL configured by SystemClock_Config after a wake-up from STOP
+ * @note Bus prescalers and flash wait states survive STOP, only the PLL has to be restarted
+ */
+void SystemClock_Restore(void);
+
 #endif    // __BOARD_H__
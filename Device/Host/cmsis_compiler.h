@@ -0,0 +1,105 @@
+#ifndef __CMSIS_COMPILER_HOST_H__
+#define __CMSIS_COMPILER_HOST_H__
+
+#include <stdint.h>
+
+/*
+ * Host stand-in for CMSIS/Include/cmsis_compiler.h, so the CMSIS-DSP headers
+ * and sources build with the host compiler. It defines the attribute macros
+ * and, as portable C, the few core intrinsics that the kernels use without
+ * ARM_MATH_DSP, the same versions cmsis_gcc.h gives an architecture without
+ * the saturating instructions. Core register access and barriers are left
+ * out: the host HAL has its own __DSB, and the library does not use them.
+ */
+
+// --- Attributes ---
+
+#define __ASM                  __asm
+#define __INLINE               inline
+#define __STATIC_INLINE        static inline
+#define __STATIC_FORCEINLINE   __attribute__((always_inline)) static inline
+#define __NO_RETURN            __attribute__((__noreturn__))
+#define __USED                 __attribute__((used))
+#define __WEAK                 __attribute__((weak))
+#define __PACKED               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT        struct __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)           __attribute__((aligned(x)))
+#define __RESTRICT             __restrict
+
+// --- Intrinsics ---
+
+/**
+ * @brief Count leading zeros
+ * @param dwValue - Value to count in
+ * @retval Number of leading zero bits, 32 for zero
+ */
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t dwValue)
+{
+    return (dwValue == 0U) ? 32U : (uint8_t)__builtin_clz(dwValue);
+}
+
+/**
+ * @brief Saturate to a signed bit width
+ * @param nValue - Value to saturate
+ * @param dwBits - Width, 1 to 32
+ * @retval Saturated value
+ */
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t nValue, uint32_t dwBits)
+{
+    if (dwBits >= 1U && dwBits <= 32U)
+    {
+        const int32_t nMax = (int32_t)((1U << (dwBits - 1U)) - 1U);
+        const int32_t nMin = -1 - nMax;
+
+        if (nValue > nMax)
+        {
+            return nMax;
+        }
+        if (nValue < nMin)
+        {
+            return nMin;
+        }
+    }
+
+    return nValue;
+}
+
+/**
+ * @brief Saturate to an unsigned bit width
+ * @param nValue - Value to saturate
+ * @param dwBits - Width, 0 to 31
+ * @retval Saturated value
+ */
+__STATIC_FORCEINLINE uint32_t __USAT(int32_t nValue, uint32_t dwBits)
+{
+    if (dwBits <= 31U)
+    {
+        const uint32_t dwMax = (1U << dwBits) - 1U;
+
+        if (nValue > (int32_t)dwMax)
+        {
+            return dwMax;
+        }
+        if (nValue < 0)
+        {
+            return 0U;
+        }
+    }
+
+    return (uint32_t)nValue;
+}
+
+/**
+ * @brief Rotate right
+ * @param dwValue - Value to rotate
+ * @param dwShift - Bits to rotate by
+ * @retval Rotated value
+ */
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t dwValue, uint32_t dwShift)
+{
+    dwShift %= 32U;
+
+    return (dwShift == 0U) ? dwValue : (dwValue >> dwShift) | (dwValue << (32U - dwShift));
+}
+
+#endif    // __CMSIS_COMPILER_HOST_H__
@@ -0,0 +1,946 @@
+#ifndef __STM32F2XX_HAL_HOST_H__
+#define __STM32F2XX_HAL_HOST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Host stand-in for the STM32F2xx HAL. It mirrors the subset of types, constants
+ * and calls used by Board/, Driver/ and Service/ so those layers build unchanged
+ * for the POSIX simulator. Register-level peripherals become small host structs
+ * and configuration calls are accepted and ignored. Peripherals with observable
+ * behaviour (UART, ETH) are backed by host file descriptors and complete their
+ * "DMA" transfers from the emulated interrupt handlers in stm32f2xx_it.c.
+ */
+
+// --- Common ---
+
+#define __IO      volatile
+
+#define UNUSED(X) (void)X
+
+#define __DSB()   __sync_synchronize()
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do                                                               \
+    {                                                                \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);         \
+        (__DMA_HANDLE__).Parent         = (__HANDLE__);              \
+    } while (0U)
+
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UNLOCKED = 0x00U,
+    HAL_LOCKED   = 0x01U
+} HAL_LockTypeDef;
+
+typedef enum
+{
+    DISABLE = 0U,
+    ENABLE  = !DISABLE
+} FunctionalState;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+extern uint32_t SystemCoreClock;
+
+// --- Interrupts ---
+
+typedef enum
+{
+    RTC_WKUP_IRQn     = 3,
+    EXTI0_IRQn        = 6,
+    DMA1_Stream1_IRQn = 12,
+    DMA1_Stream3_IRQn = 14,
+    ADC_IRQn          = 18,
+    EXTI9_5_IRQn      = 23,
+    USART3_IRQn       = 39,
+    TIM7_IRQn         = 55,
+    DMA2_Stream0_IRQn = 56,
+    DMA2_Stream4_IRQn = 60,
+    ETH_IRQn          = 61,
+    OTG_FS_IRQn       = 67,
+    DMA2_Stream7_IRQn = 70,
+    HOST_IRQn_MAX     = 82
+} IRQn_Type;
+
+#define NVIC_PRIORITYGROUP_4 0x00000003U
+
+// --- RCC ---
+
+typedef struct
+{
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLM;
+    uint32_t PLLN;
+    uint32_t PLLP;
+    uint32_t PLLQ;
+} RCC_PLLInitTypeDef;
+
+typedef struct
+{
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    uint32_t LSEState;
+    uint32_t HSIState;
+    uint32_t HSICalibrationValue;
+    uint32_t LSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct
+{
+    uint32_t PeriphClockSelection;
+    uint32_t RTCClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+typedef struct
+{
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSI         0x00000002U
+#define RCC_OSCILLATORTYPE_LSE         0x00000004U
+#define RCC_HSI_ON                     0x00000001U
+#define RCC_HSICALIBRATION_DEFAULT     0x10U
+#define RCC_LSE_ON                     0x00000001U
+#define RCC_PLL_NONE                   0x00000000U
+#define RCC_PLL_ON                     0x00000002U
+#define RCC_PLLSOURCE_HSI              0x00000000U
+#define RCC_PLLP_DIV2                  0x00000002U
+
+#define RCC_CLOCKTYPE_SYSCLK           0x00000001U
+#define RCC_CLOCKTYPE_HCLK             0x00000002U
+#define RCC_CLOCKTYPE_PCLK1            0x00000004U
+#define RCC_CLOCKTYPE_PCLK2            0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK        0x00000002U
+#define RCC_SYSCLK_DIV1                0x00000000U
+#define RCC_HCLK_DIV2                  0x00001000U
+#define RCC_HCLK_DIV4                  0x00001400U
+#define RCC_SYSCLKSOURCE_STATUS_PLLCLK 0x00000008U
+#define RCC_FLAG_PLLRDY                0x39U
+
+#define RCC_PERIPHCLK_RTC              0x00000004U
+#define RCC_RTCCLKSOURCE_LSE           0x00000100U
+
+#define FLASH_LATENCY_3                0x00000003U
+
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_PWR_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOG_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_CRC_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_CRC_CLK_DISABLE()    ((void)0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_ADC2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC2_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_ADC3_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC3_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_USART3_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_USART3_CLK_DISABLE() ((void)0)
+#define __HAL_RCC_TIM2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM2_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM3_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM3_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM7_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM7_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_ETH_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_ETH_CLK_DISABLE()    ((void)0)
+#define __HAL_RCC_RTC_ENABLE()         ((void)0)
+#define __HAL_RCC_RTC_DISABLE()        ((void)0)
+
+// The host never leaves its clock configuration, so the PLL always reads as running
+#define __HAL_RCC_PLL_ENABLE()         ((void)0)
+#define __HAL_RCC_GET_FLAG(__FLAG__)   (1U)
+#define __HAL_RCC_SYSCLK_CONFIG(SRC)   ((void)(SRC))
+#define __HAL_RCC_GET_SYSCLK_SOURCE()  RCC_SYSCLKSOURCE_STATUS_PLLCLK
+
+// --- GPIO ---
+
+typedef struct
+{
+    const char *pName;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+extern GPIO_TypeDef HOST_GPIOA;
+extern GPIO_TypeDef HOST_GPIOB;
+extern GPIO_TypeDef HOST_GPIOC;
+extern GPIO_TypeDef HOST_GPIOD;
+extern GPIO_TypeDef HOST_GPIOG;
+#define GPIOA                     (&HOST_GPIOA)
+#define GPIOB                     (&HOST_GPIOB)
+#define GPIOC                     (&HOST_GPIOC)
+#define GPIOD                     (&HOST_GPIOD)
+#define GPIOG                     (&HOST_GPIOG)
+
+#define GPIO_PIN_1                ((uint16_t)0x0002)
+#define GPIO_PIN_2                ((uint16_t)0x0004)
+#define GPIO_PIN_3                ((uint16_t)0x0008)
+#define GPIO_PIN_4                ((uint16_t)0x0010)
+#define GPIO_PIN_5                ((uint16_t)0x0020)
+#define GPIO_PIN_7                ((uint16_t)0x0080)
+#define GPIO_PIN_8                ((uint16_t)0x0100)
+#define GPIO_PIN_9                ((uint16_t)0x0200)
+#define GPIO_PIN_11               ((uint16_t)0x0800)
+#define GPIO_PIN_12               ((uint16_t)0x1000)
+#define GPIO_PIN_13               ((uint16_t)0x2000)
+
+#define GPIO_MODE_INPUT           0x00000000U
+#define GPIO_MODE_AF_PP           0x00000002U
+#define GPIO_MODE_ANALOG          0x00000003U
+#define GPIO_NOPULL               0x00000000U
+#define GPIO_SPEED_FREQ_VERY_HIGH 0x00000003U
+#define GPIO_AF7_USART3           ((uint8_t)0x07)
+#define GPIO_AF10_OTG_FS          ((uint8_t)0x0A)
+#define GPIO_AF11_ETH             ((uint8_t)0x0B)
+
+// --- CRC ---
+
+/*
+ * The CRC unit computes CRC-32/MPEG-2 over every word accumulated into DR, as
+ * on the target. Words the emulated DMA writes into DR are not accumulated, so
+ * the host feeds it from the CPU only.
+ */
+typedef struct
+{
+    const char *pName;
+    volatile uint32_t DR;
+} CRC_TypeDef;
+
+typedef struct
+{
+    CRC_TypeDef *Instance;
+} CRC_HandleTypeDef;
+
+extern CRC_TypeDef HOST_CRC;
+#define CRC                            (&HOST_CRC)
+
+#define __HAL_CRC_DR_RESET(__HANDLE__) ((__HANDLE__)->Instance->DR = 0xFFFFFFFFU)
+
+// --- FLASH ---
+
+/*
+ * The host maps 1 MB of emulated flash at the real FLASH_BASE, read-only, so
+ * code reads it in place as on the target. HAL_FLASH_Program and
+ * HAL_FLASHEx_Erase write it through a second mapping with NOR semantics:
+ * programming can only clear bits, erasing sets a whole sector to 0xFF. The
+ * content lives in NHNS_HOST_FLASH when that names a file, and is lost at exit
+ * otherwise. NHNS_HOST_FLASH_FAIL=<n> cuts the power during the n-th program
+ * or erase: half of it is done, then the process exits with status 75.
+ */
+typedef struct
+{
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_BASE                 0x08000000UL
+#define HOST_FLASH_SIZE            0x00100000UL
+
+#define FLASH_TYPEPROGRAM_BYTE     0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD     0x02U
+#define FLASH_TYPEERASE_SECTORS    0x00000000U
+#define FLASH_VOLTAGE_RANGE_3      0x00000002U
+#define FLASH_BANK_1               1U
+#define FLASH_SECTOR_10            10U
+#define FLASH_SECTOR_11            11U
+
+#define HAL_FLASH_ERROR_NONE       0x00000000U
+#define HAL_FLASH_ERROR_PGS        0x00000002U
+#define HAL_FLASH_ERROR_WRP        0x00000010U
+
+// --- DMA ---
+
+/*
+ * Peripheral streams are moved by the emulated peripherals. Memory-to-memory
+ * transfers are started by HAL_DMA_Start_IT and run in one go by the next
+ * HAL_DMA_IRQHandler, from the emulated interrupt, as a real stream would finish
+ * some time later. Addresses are host pointers, so they are uintptr_t here.
+ */
+typedef struct
+{
+    const char *pName;
+    uintptr_t dwSrc;
+    uintptr_t dwDst;
+    uint32_t dwItems;
+    volatile int fActive;
+} DMA_Stream_TypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+    uint32_t FIFOMode;
+    uint32_t FIFOThreshold;
+    uint32_t MemBurst;
+    uint32_t PeriphBurst;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+    DMA_Stream_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    void *Parent;
+    uint32_t ErrorCode;
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferErrorCallback)(struct __DMA_HandleTypeDef *hdma);
+} DMA_HandleTypeDef;
+
+extern DMA_Stream_TypeDef HOST_DMA1_Stream1;
+extern DMA_Stream_TypeDef HOST_DMA1_Stream3;
+extern DMA_Stream_TypeDef HOST_DMA2_Stream0;
+extern DMA_Stream_TypeDef HOST_DMA2_Stream4;
+#define DMA1_Stream1            (&HOST_DMA1_Stream1)
+#define DMA1_Stream3            (&HOST_DMA1_Stream3)
+#define DMA2_Stream0            (&HOST_DMA2_Stream0)
+#define DMA2_Stream4            (&HOST_DMA2_Stream4)
+
+#define DMA_CHANNEL_0           0x00000000U
+#define DMA_CHANNEL_4           0x08000000U
+#define DMA_PERIPH_TO_MEMORY    0x00000000U
+#define DMA_MEMORY_TO_PERIPH    0x00000040U
+#define DMA_MEMORY_TO_MEMORY    0x00000080U
+#define DMA_PINC_DISABLE        0x00000000U
+#define DMA_PINC_ENABLE         0x00000200U
+#define DMA_MINC_DISABLE        0x00000000U
+#define DMA_MINC_ENABLE         0x00000400U
+#define DMA_PDATAALIGN_BYTE     0x00000000U
+#define DMA_PDATAALIGN_HALFWORD 0x00000800U
+#define DMA_PDATAALIGN_WORD     0x00001000U
+#define DMA_MDATAALIGN_BYTE     0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00002000U
+#define DMA_MDATAALIGN_WORD     0x00004000U
+#define DMA_NORMAL              0x00000000U
+#define DMA_CIRCULAR            0x00000100U
+#define DMA_PRIORITY_LOW        0x00000000U
+#define DMA_PRIORITY_MEDIUM     0x00010000U
+#define DMA_PRIORITY_HIGH       0x00020000U
+#define DMA_FIFOMODE_DISABLE    0x00000000U
+#define DMA_FIFOMODE_ENABLE     0x00000004U
+#define DMA_FIFO_THRESHOLD_FULL 0x00000003U
+#define DMA_MBURST_SINGLE       0x00000000U
+#define DMA_PBURST_SINGLE       0x00000000U
+
+#define HAL_DMA_ERROR_NONE      0x00000000U
+#define HAL_DMA_ERROR_TE        0x00000001U
+
+// --- ADC ---
+
+/*
+ * The host ADC converts from NHNS_HOST_ADC, a file of raw little-endian 16-bit
+ * samples read in a loop and cut to 12 bits, or from a 12-bit ramp that steps
+ * by one per conversion without the variable. Timers are not emulated, so the
+ * trigger rate is set with HAL_HOST_ADC_SetTriggerRate instead of a TRGO. The
+ * conversions due since the start are written to the circular buffer from
+ * HAL_ADC_IRQHandler, the emulated ADC interrupt, which also calls the half
+ * and full transfer callbacks the DMA stream would. Several ticks worth of
+ * conversions can wrap round the buffer in one call, as the stream does at
+ * high rates. Falling more than a few buffers behind, when the simulator
+ * stalls, is reported as an overrun, as the real ADC does when the DMA misses
+ * a request.
+ */
+typedef struct
+{
+    const char *pName;
+    int nFd;                     // NHNS_HOST_ADC, -1 for the ramp
+    int fRunning;
+    uint32_t dwConversions;      // Per trigger, 3 in triple interleaved mode
+    uint32_t dwTriggerHz;
+    uint16_t *pwBuffer;
+    uint32_t dwLength;           // Samples in the circular buffer
+    uint32_t dwPosition;         // Next sample to write
+    uint64_t qwConverted;        // Conversions since the start
+    uint64_t qwStartNs;
+    uint16_t wRamp;
+    __IO uint32_t SR;
+} ADC_TypeDef;
+
+typedef struct
+{
+    uint32_t ClockPrescaler;
+    uint32_t Resolution;
+    uint32_t DataAlign;
+    uint32_t ScanConvMode;
+    uint32_t EOCSelection;
+    FunctionalState ContinuousConvMode;
+    uint32_t NbrOfConversion;
+    FunctionalState DiscontinuousConvMode;
+    uint32_t NbrOfDiscConversion;
+    uint32_t ExternalTrigConv;
+    uint32_t ExternalTrigConvEdge;
+    FunctionalState DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t DMAAccessMode;
+    uint32_t TwoSamplingDelay;
+} ADC_MultiModeTypeDef;
+
+typedef struct __ADC_HandleTypeDef
+{
+    ADC_TypeDef *Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef *DMA_Handle;
+    __IO uint32_t State;
+    __IO uint32_t ErrorCode;
+} ADC_HandleTypeDef;
+
+extern ADC_TypeDef HOST_ADC1;
+extern ADC_TypeDef HOST_ADC2;
+extern ADC_TypeDef HOST_ADC3;
+#define ADC1                              (&HOST_ADC1)
+#define ADC2                              (&HOST_ADC2)
+#define ADC3                              (&HOST_ADC3)
+
+#define ADC_CLOCK_SYNC_PCLK_DIV2          0x00000000U
+#define ADC_RESOLUTION_12B                0x00000000U
+#define ADC_DATAALIGN_RIGHT               0x00000000U
+#define ADC_EOC_SINGLE_CONV               0x00000001U
+#define ADC_EXTERNALTRIGCONVEDGE_NONE     0x00000000U
+#define ADC_EXTERNALTRIGCONVEDGE_RISING   0x10000000U
+#define ADC_EXTERNALTRIGCONV_T3_TRGO      0x08000000U
+#define ADC_CHANNEL_3                     0x00000003U
+#define ADC_SAMPLETIME_3CYCLES            0x00000000U
+#define ADC_MODE_INDEPENDENT              0x00000000U
+#define ADC_TRIPLEMODE_INTERL             0x00000017U
+#define ADC_DMAACCESSMODE_DISABLED        0x00000000U
+#define ADC_DMAACCESSMODE_2               0x00008000U
+#define ADC_TWOSAMPLINGDELAY_5CYCLES      0x00000000U
+
+#define ADC_FLAG_OVR                      0x00000020U
+
+#define HAL_ADC_STATE_READY               0x00000001U
+#define HAL_ADC_STATE_ERROR_INTERNAL      0x00000010U
+#define HAL_ADC_STATE_ERROR_DMA           0x00000040U
+#define HAL_ADC_STATE_REG_BUSY            0x00000100U
+#define HAL_ADC_STATE_REG_OVR             0x00000400U
+
+#define HAL_ADC_ERROR_NONE                0x00U
+#define HAL_ADC_ERROR_OVR                 0x02U
+#define HAL_ADC_ERROR_DMA                 0x04U
+
+#define __HAL_ADC_CLEAR_FLAG(__HANDLE__, __FLAG__) (((__HANDLE__)->Instance->SR) = ~(__FLAG__))
+
+// --- TIM ---
+
+/*
+ * Timers are not emulated, only the handle exists so board code builds. The
+ * run-time statistics counter reads CLOCK_MONOTONIC directly on the host.
+ */
+typedef struct
+{
+    const char *pName;
+} TIM_TypeDef;
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+extern TIM_TypeDef HOST_TIM2;
+extern TIM_TypeDef HOST_TIM3;
+extern TIM_TypeDef HOST_TIM7;
+#define TIM2 (&HOST_TIM2)
+#define TIM3 (&HOST_TIM3)
+#define TIM7 (&HOST_TIM7)
+
+// --- RTC ---
+
+/*
+ * The host has no low-power modes (configUSE_TICKLESS_IDLE is 0), only the
+ * handle exists so board code builds. No RTC register is modelled, neither the
+ * calendar nor the write protection (WPR) guarding ISR, so the STOP path of
+ * lowpower.c is target-only and host runs do not exercise it.
+ */
+typedef struct
+{
+    const char *pName;
+} RTC_TypeDef;
+
+typedef struct
+{
+    uint32_t HourFormat;
+    uint32_t AsynchPrediv;
+    uint32_t SynchPrediv;
+    uint32_t OutPut;
+    uint32_t OutPutPolarity;
+    uint32_t OutPutType;
+} RTC_InitTypeDef;
+
+typedef struct
+{
+    RTC_TypeDef *Instance;
+    RTC_InitTypeDef Init;
+} RTC_HandleTypeDef;
+
+extern RTC_TypeDef HOST_RTC;
+#define RTC (&HOST_RTC)
+
+// --- ETH ---
+
+/*
+ * The host MAC is backed by NHNS_HOST_ETH: "tap" or "tap:<name>" attaches a
+ * Linux TAP interface (nhns0 by default), any other value is a pcap file whose
+ * frames are received in a loop and transmitted frames are discarded. Without
+ * the variable the PHY never reports a link. The emulated DMA walks the same
+ * descriptor chains as the real one from HAL_ETH_IRQHandler, so descriptor
+ * addresses are pointer-sized here.
+ */
+typedef struct
+{
+    const char *pName;
+    int nFd;
+    int fPcap;
+    __IO uint32_t DMASR;
+    __IO uint32_t DMAIER;
+    __IO uint32_t DMARPDR;
+    __IO uint32_t DMATPDR;
+    int fRunning;
+    struct ETH_DMADescTypeDef *psRxDesc;
+    struct ETH_DMADescTypeDef *psTxDesc;
+} ETH_TypeDef;
+
+typedef enum
+{
+    HAL_ETH_STATE_RESET = 0x00U,
+    HAL_ETH_STATE_READY = 0x01U,
+    HAL_ETH_STATE_BUSY  = 0x02U
+} HAL_ETH_StateTypeDef;
+
+typedef struct
+{
+    uint32_t AutoNegotiation;
+    uint32_t Speed;
+    uint32_t DuplexMode;
+    uint16_t PhyAddress;
+    uint8_t *MACAddr;
+    uint32_t RxMode;
+    uint32_t ChecksumMode;
+    uint32_t MediaInterface;
+} ETH_InitTypeDef;
+
+typedef struct ETH_DMADescTypeDef
+{
+    __IO uint32_t Status;
+    uint32_t ControlBufferSize;
+    uintptr_t Buffer1Addr;
+    uintptr_t Buffer2NextDescAddr;
+} ETH_DMADescTypeDef;
+
+typedef struct
+{
+    ETH_DMADescTypeDef *FSRxDesc;
+    ETH_DMADescTypeDef *LSRxDesc;
+    uint32_t SegCount;
+    uint32_t length;
+    uintptr_t buffer;
+} ETH_DMARxFrameInfos;
+
+typedef struct
+{
+    ETH_TypeDef *Instance;
+    ETH_InitTypeDef Init;
+    uint32_t LinkStatus;
+    ETH_DMADescTypeDef *RxDesc;
+    ETH_DMADescTypeDef *TxDesc;
+    ETH_DMARxFrameInfos RxFrameInfos;
+    __IO HAL_ETH_StateTypeDef State;
+} ETH_HandleTypeDef;
+
+extern ETH_TypeDef HOST_ETH;
+#define ETH                            (&HOST_ETH)
+
+#define MAC_ADDR0                      2U
+#define MAC_ADDR1                      0U
+#define MAC_ADDR2                      0U
+#define MAC_ADDR3                      0U
+#define MAC_ADDR4                      0U
+#define MAC_ADDR5                      0U
+
+#define ETH_MAX_PACKET_SIZE            1524U
+#define ETH_RX_BUF_SIZE                ETH_MAX_PACKET_SIZE
+#define ETH_TX_BUF_SIZE                ETH_MAX_PACKET_SIZE
+#define ETH_RXBUFNB                    8U
+#define ETH_TXBUFNB                    8U
+#define LAN8742A_PHY_ADDRESS           0U
+
+#define ETH_AUTONEGOTIATION_ENABLE     0x00000001U
+#define ETH_SPEED_100M                 0x00004000U
+#define ETH_MODE_FULLDUPLEX            0x00000800U
+#define ETH_RXINTERRUPT_MODE           0x00000001U
+#define ETH_CHECKSUM_BY_HARDWARE       0x00000000U
+#define ETH_MEDIA_INTERFACE_RMII       0x00800000U
+
+#define ETH_DMATXDESC_OWN              0x80000000U
+#define ETH_DMATXDESC_IC               0x40000000U
+#define ETH_DMATXDESC_LS               0x20000000U
+#define ETH_DMATXDESC_FS               0x10000000U
+#define ETH_DMATXDESC_TCH              0x00100000U
+#define ETH_DMATXDESC_ES               0x00008000U
+#define ETH_DMATXDESC_TBS1             0x00001FFFU
+
+#define ETH_DMARXDESC_OWN              0x80000000U
+#define ETH_DMARXDESC_FL               0x3FFF0000U
+#define ETH_DMARXDESC_ES               0x00008000U
+#define ETH_DMARXDESC_FS               0x00000200U
+#define ETH_DMARXDESC_LS               0x00000100U
+#define ETH_DMARXDESC_RCH              0x00004000U
+#define ETH_DMARXDESC_RBS1             0x00001FFFU
+#define ETH_DMARXDESC_FRAMELENGTHSHIFT 16U
+
+#define ETH_DMA_FLAG_RBU               0x00000080U
+#define ETH_DMA_FLAG_R                 0x00000040U
+#define ETH_DMA_FLAG_TBU               0x00000004U
+#define ETH_DMA_FLAG_T                 0x00000001U
+#define ETH_DMA_IT_R                   0x00000040U
+#define ETH_DMA_IT_T                   0x00000001U
+
+// DMASR is write-one-to-clear on the target
+#define __HAL_ETH_DMA_ENABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->DMAIER |= (__INTERRUPT__))
+#define __HAL_ETH_DMA_CLEAR_IT(__HANDLE__, __INTERRUPT__)  ((__HANDLE__)->Instance->DMASR &= ~(__INTERRUPT__))
+#define __HAL_ETH_DMA_GET_FLAG(__HANDLE__, __FLAG__)       (((__HANDLE__)->Instance->DMASR & (__FLAG__)) == (__FLAG__))
+
+// --- UART ---
+
+/*
+ * A host USART is a pair of file descriptors. By default it is bound to the
+ * process stdin/stdout; setting NHNS_HOST_<NAME> (e.g. NHNS_HOST_USART3) to
+ * "pty" allocates a pseudo-terminal instead, any other value is opened as a
+ * path (FIFO, tty or plain file).
+ */
+typedef struct
+{
+    const char *pName;
+    int nRxFd;
+    int nTxFd;
+} USART_TypeDef;
+
+typedef enum
+{
+    HAL_UART_STATE_RESET      = 0x00U,
+    HAL_UART_STATE_READY      = 0x20U,
+    HAL_UART_STATE_BUSY       = 0x24U,
+    HAL_UART_STATE_BUSY_TX    = 0x21U,
+    HAL_UART_STATE_BUSY_RX    = 0x22U,
+    HAL_UART_STATE_BUSY_TX_RX = 0x23U,
+    HAL_UART_STATE_TIMEOUT    = 0xA0U,
+    HAL_UART_STATE_ERROR      = 0xE0U
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    const uint8_t *pTxBuffPtr;
+    uint16_t TxXferSize;
+    __IO uint16_t TxXferCount;
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    __IO uint16_t RxXferCount;
+    __IO uint32_t ReceptionType;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    __IO HAL_UART_StateTypeDef gState;
+    __IO HAL_UART_StateTypeDef RxState;
+    __IO uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+extern USART_TypeDef HOST_USART3;
+#define USART3                      (&HOST_USART3)
+
+#define UART_WORDLENGTH_8B          0x00000000U
+#define UART_STOPBITS_1             0x00000000U
+#define UART_PARITY_NONE            0x00000000U
+#define UART_MODE_TX_RX             0x0000000CU
+#define UART_HWCONTROL_NONE         0x00000000U
+#define UART_OVERSAMPLING_16        0x00000000U
+
+#define HAL_UART_RECEPTION_STANDARD 0x00000000U
+#define HAL_UART_RECEPTION_TOIDLE   0x00000001U
+
+// --- PCD ---
+
+/*
+ * The host OTG_FS core comes with a simulated USB host on the other end of the
+ * cable. Once HAL_PCD_Start connects, HAL_PCD_IRQHandler runs one 1 ms frame
+ * per call: it resets the bus, enumerates the device the way an OS would and
+ * then polls the bulk endpoints, at most 19 full-size packets per frame like a
+ * real full-speed host. Bulk data goes to NHNS_HOST_OTG_FS: "pty" allocates a
+ * pseudo-terminal, any other value is opened as a path. Without the variable
+ * IN data is read and discarded as fast as the bus allows and no OUT data is
+ * sent. Endpoint 0 moves one packet per transfer as on the real core.
+ */
+typedef struct
+{
+    const char *pName;
+    int nFd;
+    int fConnected;
+} USB_OTG_GlobalTypeDef;
+
+typedef USB_OTG_GlobalTypeDef PCD_TypeDef;
+
+typedef enum
+{
+    HAL_PCD_STATE_RESET   = 0x00U,
+    HAL_PCD_STATE_READY   = 0x01U,
+    HAL_PCD_STATE_ERROR   = 0x02U,
+    HAL_PCD_STATE_BUSY    = 0x03U,
+    HAL_PCD_STATE_TIMEOUT = 0x04U
+} PCD_StateTypeDef;
+
+typedef struct
+{
+    uint32_t dev_endpoints;
+    uint32_t dma_enable;
+    uint32_t speed;
+    uint32_t ep0_mps;
+    uint32_t phy_itface;
+    uint32_t Sof_enable;
+    uint32_t low_power_enable;
+    uint32_t lpm_enable;
+    uint32_t vbus_sensing_enable;
+    uint32_t use_dedicated_ep1;
+} PCD_InitTypeDef;
+
+typedef struct
+{
+    uint8_t num;
+    uint8_t is_in;
+    uint8_t is_stall;
+    uint8_t type;
+    uint32_t maxpacket;
+    uint8_t *xfer_buff;
+    uint32_t xfer_len;
+    uint32_t xfer_count;
+    uint16_t tx_fifo_num;
+    uint8_t is_armed;    // Host only: a transfer is queued, the endpoint ACKs instead of NAKing
+} PCD_EPTypeDef;
+
+typedef struct
+{
+    PCD_TypeDef *Instance;
+    PCD_InitTypeDef Init;
+    __IO uint8_t USB_Address;
+    PCD_EPTypeDef IN_ep[16];
+    PCD_EPTypeDef OUT_ep[16];
+    HAL_LockTypeDef Lock;
+    __IO PCD_StateTypeDef State;
+    uint32_t Setup[12];
+    void *pData;
+} PCD_HandleTypeDef;
+
+extern USB_OTG_GlobalTypeDef HOST_USB_OTG_FS;
+#define USB_OTG_FS                         (&HOST_USB_OTG_FS)
+
+#define PCD_SPEED_FULL                     2U
+#define PCD_PHY_EMBEDDED                   2U
+
+#define EP_TYPE_CTRL                       0U
+#define EP_TYPE_BULK                       2U
+#define EP_TYPE_INTR                       3U
+
+#define __HAL_RCC_USB_OTG_FS_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_USB_OTG_FS_CLK_DISABLE() ((void)0)
+
+// --- Functions ---
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_MspInit(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetUIDw0(void);
+uint32_t HAL_GetUIDw1(void);
+uint32_t HAL_GetUIDw2(void);
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+
+void HAL_PWR_EnableBkUpAccess(void);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn);
+uint32_t HAL_NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+uint32_t HAL_FLASH_GetError(void);
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc);
+HAL_StatusTypeDef HAL_CRC_DeInit(CRC_HandleTypeDef *hcrc);
+void HAL_CRC_MspInit(CRC_HandleTypeDef *hcrc);
+void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc);
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef *hadc);
+void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc);
+void HAL_ADC_MspDeInit(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef *hadc, ADC_MultiModeTypeDef *multimode);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef *hadc);
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc);
+
+HAL_StatusTypeDef HAL_ETH_Init(ETH_HandleTypeDef *heth);
+HAL_StatusTypeDef HAL_ETH_DeInit(ETH_HandleTypeDef *heth);
+void HAL_ETH_MspInit(ETH_HandleTypeDef *heth);
+void HAL_ETH_MspDeInit(ETH_HandleTypeDef *heth);
+HAL_StatusTypeDef HAL_ETH_DMATxDescListInit(ETH_HandleTypeDef *heth, ETH_DMADescTypeDef *DMATxDescTab, uint8_t *TxBuff, uint32_t TxBuffCount);
+HAL_StatusTypeDef HAL_ETH_DMARxDescListInit(ETH_HandleTypeDef *heth, ETH_DMADescTypeDef *DMARxDescTab, uint8_t *RxBuff, uint32_t RxBuffCount);
+HAL_StatusTypeDef HAL_ETH_Start(ETH_HandleTypeDef *heth);
+HAL_StatusTypeDef HAL_ETH_Stop(ETH_HandleTypeDef *heth);
+HAL_StatusTypeDef HAL_ETH_GetReceivedFrame_IT(ETH_HandleTypeDef *heth);
+void HAL_ETH_IRQHandler(ETH_HandleTypeDef *heth);
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth);
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth);
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart);
+void HAL_UART_MspInit(UART_HandleTypeDef *huart);
+void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart);
+HAL_UART_StateTypeDef HAL_UART_GetState(const UART_HandleTypeDef *huart);
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_DeInit(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_MspInit(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_MspDeInit(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_Stop(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_IRQHandler(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address);
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type);
+HAL_StatusTypeDef HAL_PCD_EP_Close(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len);
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len);
+uint32_t HAL_PCD_EP_GetRxCount(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_SetStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCDEx_SetRxFiFo(PCD_HandleTypeDef *hpcd, uint16_t size);
+HAL_StatusTypeDef HAL_PCDEx_SetTxFiFo(PCD_HandleTypeDef *hpcd, uint8_t fifo, uint16_t size);
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum);
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum);
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_ConnectCallback(PCD_HandleTypeDef *hpcd);
+void HAL_PCD_DisconnectCallback(PCD_HandleTypeDef *hpcd);
+
+/**
+ * @brief Check whether an emulated interrupt line is enabled
+ * @param IRQn - Interrupt number
+ * @retval Non-zero when enabled through HAL_NVIC_EnableIRQ
+ */
+int HAL_HOST_IsIRQEnabled(IRQn_Type IRQn);
+
+/**
+ * @brief Set the rate of the emulated conversion trigger, the TRGO of the timer on the target
+ * @param ADCx - ADC the trigger starts, ADC1 in multi mode
+ * @param dwHz - Triggers per second
+ */
+void HAL_HOST_ADC_SetTriggerRate(ADC_TypeDef *ADCx, uint32_t dwHz);
+
+#endif    // __STM32F2XX_HAL_HOST_H__
@@ -0,0 +1,2244 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "stm32f2xx_hal.h"
+
+// --- Definitions ---
+
+#define HOST_UART_ENV_PREFIX "NHNS_HOST_"
+
+#define HOST_FLASH_ENV       "NHNS_HOST_FLASH"
+#define HOST_FLASH_FAIL_ENV  "NHNS_HOST_FLASH_FAIL"
+#define HOST_FLASH_SECTORS   12
+#define HOST_FLASH_FAIL_EXIT 75
+
+#define HOST_ETH_ENV         "NHNS_HOST_ETH"
+#define HOST_ETH_TAP_DEFAULT "nhns0"
+
+// pcap file layout: 24-byte global header, then a 16-byte header before every frame
+#define HOST_PCAP_HEADER     24
+#define HOST_PCAP_RECORD     16
+#define HOST_PCAP_MAGIC_US   0xA1B2C3D4U
+#define HOST_PCAP_MAGIC_NS   0xA1B23C4DU
+#define HOST_PCAP_LINK_ETH   1U
+#define HOST_PCAP_NATIVE     1
+#define HOST_PCAP_SWAPPED    2
+
+#define HOST_ADC_ENV         "NHNS_HOST_ADC"
+#define HOST_ADC_MASK        0x0FFFU    // 12-bit right-aligned results
+#define HOST_NS_PER_S        1000000000ULL
+#define HOST_ADC_MAX_LAG     4          // Buffers of conversions due before it counts as an overrun
+
+#define HOST_USB_ENV         "NHNS_HOST_OTG_FS"
+#define HOST_USB_PACKETS     19    // Full-size bulk packets that fit a full-speed frame
+#define HOST_USB_TIMEOUT     50    // Frames a control transfer may take before enumeration gives up
+#define HOST_USB_DATA_SIZE   320   // Longest control read asked for, plus a packet of slack
+#define HOST_USB_NAK         (-1)
+#define HOST_USB_STALL       (-2)
+
+// --- Types ---
+
+typedef enum
+{
+    HOST_USB_PHASE_SETUP = 0,
+    HOST_USB_PHASE_DATA,
+    HOST_USB_PHASE_STATUS,
+} host_usb_phase_t;
+
+// One control transfer of the enumeration script
+typedef struct
+{
+    const char *szName;
+    uint8_t abSetup[8];
+    const uint8_t *pbOut;    // Data stage of OUT requests
+    int fExpectStall;
+} host_usb_request_t;
+
+// The simulated host on the other end of the OTG_FS cable
+typedef struct
+{
+    int fReset;
+    int fEnumerated;
+    int fFailed;
+    uint8_t bAddress;    // Address the device is expected to answer at
+
+    // Control transfer in progress
+    uint32_t dwStep;
+    host_usb_phase_t nPhase;
+    uint32_t dwFrames;
+    uint16_t wDone;
+    uint8_t abData[HOST_USB_DATA_SIZE];
+
+    // What the descriptors said, for the log
+    uint16_t wVID;
+    uint16_t wPID;
+    uint16_t wConfigLength;
+    char szProduct[33];
+    char szSerial[33];
+
+    // Bulk OUT packet read from the backing file, waiting for the device to take it
+    uint8_t abOut[64];
+    uint16_t wOutLength;
+} host_usb_t;
+
+// --- Global Variables ---
+
+uint32_t SystemCoreClock = 120000000U;
+
+GPIO_TypeDef HOST_GPIOA = {"GPIOA"};
+GPIO_TypeDef HOST_GPIOB = {"GPIOB"};
+GPIO_TypeDef HOST_GPIOC = {"GPIOC"};
+GPIO_TypeDef HOST_GPIOD = {"GPIOD"};
+GPIO_TypeDef HOST_GPIOG = {"GPIOG"};
+
+DMA_Stream_TypeDef HOST_DMA1_Stream1 = {"DMA1_Stream1"};
+DMA_Stream_TypeDef HOST_DMA1_Stream3 = {"DMA1_Stream3"};
+DMA_Stream_TypeDef HOST_DMA2_Stream0 = {"DMA2_Stream0"};
+DMA_Stream_TypeDef HOST_DMA2_Stream4 = {"DMA2_Stream4"};
+
+ADC_TypeDef HOST_ADC1 = {.pName = "ADC1", .nFd = -1, .dwConversions = 1};
+ADC_TypeDef HOST_ADC2 = {.pName = "ADC2", .nFd = -1, .dwConversions = 1};
+ADC_TypeDef HOST_ADC3 = {.pName = "ADC3", .nFd = -1, .dwConversions = 1};
+
+TIM_TypeDef HOST_TIM2 = {"TIM2"};
+TIM_TypeDef HOST_TIM3 = {"TIM3"};
+TIM_TypeDef HOST_TIM7 = {"TIM7"};
+
+RTC_TypeDef HOST_RTC = {"RTC"};
+
+USART_TypeDef HOST_USART3 = {"USART3", -1, -1};
+
+ETH_TypeDef HOST_ETH = {.pName = "ETH", .nFd = -1};
+
+USB_OTG_GlobalTypeDef HOST_USB_OTG_FS = {.pName = "OTG_FS", .nFd = -1};
+
+CRC_TypeDef HOST_CRC = {"CRC", 0xFFFFFFFFU};
+
+static struct timespec gsStartTime;
+
+// STM32F207 sector layout: 4 x 16K, 64K, 7 x 128K
+static const uint32_t gadwHostFlashSectors[HOST_FLASH_SECTORS + 1] = {
+    0x00000, 0x04000, 0x08000, 0x0C000, 0x10000, 0x20000, 0x40000,
+    0x60000, 0x80000, 0xA0000, 0xC0000, 0xE0000, HOST_FLASH_SIZE,
+};
+
+static uint8_t *gpbHostFlash;          // Writable alias of the emulated flash
+static int gfHostFlashUnlocked;
+static uint32_t gdwHostFlashError;
+static long glHostFlashFailAt;         // Operations left until the injected power failure, 0 for none
+static volatile uint8_t gabIRQEnabled[HOST_IRQn_MAX];
+static volatile uint8_t gabIRQPending[HOST_IRQn_MAX];    // Set from software, peripherals are polled every tick instead
+
+// Line coding the host sets and reads back, 921600 baud 8N1
+static const uint8_t gabHostLineCoding[7] = {0x00, 0x10, 0x0E, 0x00, 0, 0, 8};
+
+// What an OS does with a newly attached CDC-ACM device, strings in US English
+static const host_usb_request_t gasHostUsbScript[] = {
+    {"GET_DESCRIPTOR device",           {0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00}, NULL,              0},
+    {"SET_ADDRESS",                     {0x00, 0x05, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR device",           {0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x12, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR configuration",    {0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0x09, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR configuration",    {0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0xFF, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR string 0",         {0x80, 0x06, 0x00, 0x03, 0x00, 0x00, 0xFF, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR string 2",         {0x80, 0x06, 0x02, 0x03, 0x09, 0x04, 0xFF, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR string 3",         {0x80, 0x06, 0x03, 0x03, 0x09, 0x04, 0xFF, 0x00}, NULL,              0},
+    {"GET_DESCRIPTOR device qualifier", {0x80, 0x06, 0x00, 0x06, 0x00, 0x00, 0x0A, 0x00}, NULL,              1},
+    {"SET_CONFIGURATION",               {0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, NULL,              0},
+    {"SET_LINE_CODING",                 {0x21, 0x20, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00}, gabHostLineCoding, 0},
+    {"GET_LINE_CODING",                 {0xA1, 0x21, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00}, NULL,              0},
+    {"SET_CONTROL_LINE_STATE",          {0x21, 0x22, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, NULL,              0},
+};
+
+static host_usb_t gsHostUsb;
+
+// --- Static Functions ---
+
+/**
+ * @brief Map the emulated flash at FLASH_BASE, backed by NHNS_HOST_FLASH or by memory
+ * @retval HAL_OK on success, HAL_ERROR if the file cannot be opened or the address range is taken
+ */
+static HAL_StatusTypeDef HOST_FLASH_Map(void)
+{
+    const char *pPath = getenv(HOST_FLASH_ENV);
+    const char *pFail = getenv(HOST_FLASH_FAIL_ENV);
+    struct stat sStat = {0};
+    void *pvView      = MAP_FAILED;
+    int nFd           = -1;
+
+    // 1) Backing file, whatever it lacks of the full size reads as erased
+    nFd = (pPath != NULL) ? open(pPath, O_RDWR | O_CREAT, 0644) : memfd_create("flash", 0);
+    if (nFd < 0 || fstat(nFd, &sStat) != 0 || (sStat.st_size < (off_t)HOST_FLASH_SIZE && ftruncate(nFd, HOST_FLASH_SIZE) != 0))
+    {
+        return HAL_ERROR;
+    }
+
+    // 2) Writable alias for the HAL, read-only view where the firmware expects it
+    gpbHostFlash = mmap(NULL, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, nFd, 0);
+    pvView       = mmap((void *)FLASH_BASE, HOST_FLASH_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED_NOREPLACE, nFd, 0);
+    close(nFd);
+    if (gpbHostFlash == MAP_FAILED || pvView != (void *)FLASH_BASE)
+    {
+        gpbHostFlash = NULL;
+        return HAL_ERROR;
+    }
+    if (sStat.st_size < (off_t)HOST_FLASH_SIZE)
+    {
+        memset(&gpbHostFlash[sStat.st_size], 0xFF, HOST_FLASH_SIZE - (size_t)sStat.st_size);
+    }
+
+    glHostFlashFailAt = (pFail != NULL) ? atol(pFail) : 0;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Count a program or erase towards the injected power failure
+ * @retval Non-zero when the power fails during this operation
+ */
+static int HOST_FLASH_PowerFails(void)
+{
+    return glHostFlashFailAt > 0 && --glHostFlashFailAt == 0;
+}
+
+/**
+ * @brief End the process as a power failure would, the flash keeps what was done so far
+ * @param szOperation - What was interrupted
+ * @param dwAddress - Where
+ */
+static void HOST_FLASH_PowerOff(const char *szOperation, uint32_t dwAddress)
+{
+    fprintf(stderr, "FLASH: power lost during %s at 0x%08lX\n", szOperation, (unsigned long)dwAddress);
+    _exit(HOST_FLASH_FAIL_EXIT);
+}
+
+/**
+ * @brief Bind a host USART to its file descriptors on first use
+ * @param psUSART - Host USART instance
+ * @retval HAL_OK on success, HAL_ERROR if the backing file could not be opened
+ */
+static HAL_StatusTypeDef HOST_UART_Open(USART_TypeDef *psUSART)
+{
+    char szEnv[32]    = {0};
+    const char *pPath = NULL;
+    int nFd           = -1;
+
+    // 1) Already bound
+    if (psUSART->nRxFd >= 0)
+    {
+        return HAL_OK;
+    }
+
+    snprintf(szEnv, sizeof(szEnv), HOST_UART_ENV_PREFIX "%s", psUSART->pName);
+    pPath = getenv(szEnv);
+
+    // 2) Default to the process stdio
+    if (pPath == NULL || strcmp(pPath, "-") == 0)
+    {
+        psUSART->nRxFd = STDIN_FILENO;
+        psUSART->nTxFd = STDOUT_FILENO;
+        return HAL_OK;
+    }
+
+    // 3) Allocate a pseudo-terminal and tell the user where it is
+    if (strcmp(pPath, "pty") == 0)
+    {
+        nFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (nFd < 0 || grantpt(nFd) != 0 || unlockpt(nFd) != 0)
+        {
+            return HAL_ERROR;
+        }
+        fprintf(stderr, "%s attached to %s\n", psUSART->pName, ptsname(nFd));
+    }
+    // 4) Anything else is a path
+    else
+    {
+        nFd = open(pPath, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (nFd < 0)
+        {
+            return HAL_ERROR;
+        }
+    }
+
+    psUSART->nRxFd = nFd;
+    psUSART->nTxFd = nFd;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Write as much as the backing file accepts right now
+ * @param psUSART - Host USART instance
+ * @param pData - Data to write
+ * @param bLength - Length of data
+ * @retval Number of bytes written
+ */
+static uint16_t HOST_UART_Write(USART_TypeDef *psUSART, const uint8_t *pData, uint16_t bLength)
+{
+    struct pollfd sPoll = {.fd = psUSART->nTxFd, .events = POLLOUT};
+    ssize_t nWritten    = 0;
+
+    if (poll(&sPoll, 1, 0) <= 0 || (sPoll.revents & POLLOUT) == 0)
+    {
+        return 0;
+    }
+
+    nWritten = write(psUSART->nTxFd, pData, bLength);
+
+    return (nWritten > 0) ? (uint16_t)nWritten : 0;
+}
+
+/**
+ * @brief Read whatever the backing file has available right now
+ * @param psUSART - Host USART instance
+ * @param pData - Destination buffer
+ * @param bLength - Size of pData
+ * @retval Number of bytes read
+ */
+static uint16_t HOST_UART_ReadAvailable(USART_TypeDef *psUSART, uint8_t *pData, uint16_t bLength)
+{
+    struct pollfd sPoll = {.fd = psUSART->nRxFd, .events = POLLIN};
+    ssize_t nRead       = 0;
+
+    if (bLength == 0 || poll(&sPoll, 1, 0) <= 0 || (sPoll.revents & POLLIN) == 0)
+    {
+        return 0;
+    }
+
+    nRead = read(psUSART->nRxFd, pData, bLength);
+
+    return (nRead > 0) ? (uint16_t)nRead : 0;
+}
+
+/**
+ * @brief Read a 32-bit pcap header field
+ * @param pbField - Field in the file
+ * @param fSwap - Non-zero when the file was written with the other byte order
+ * @retval Field value
+ */
+static uint32_t HOST_PCAP_Get32(const uint8_t *pbField, int fSwap)
+{
+    uint32_t dwValue = 0;
+
+    memcpy(&dwValue, pbField, sizeof(dwValue));
+
+    return fSwap ? __builtin_bswap32(dwValue) : dwValue;
+}
+
+/**
+ * @brief Attach the host MAC to its backing TAP interface or pcap file
+ * @param psETH - Host ETH instance
+ * @retval HAL_OK on success, HAL_TIMEOUT when nothing is configured (no link), HAL_ERROR if it could not be opened
+ */
+static HAL_StatusTypeDef HOST_ETH_Open(ETH_TypeDef *psETH)
+{
+    const char *pPath = getenv(HOST_ETH_ENV);
+    struct ifreq sReq = {0};
+    uint8_t abHeader[HOST_PCAP_HEADER];
+    uint32_t dwMagic = 0;
+    int nFd          = -1;
+    int fSwap        = 0;
+
+    // 1) Already attached
+    if (psETH->nFd >= 0)
+    {
+        return HAL_OK;
+    }
+
+    // 2) Nothing plugged in
+    if (pPath == NULL || pPath[0] == '\0')
+    {
+        return HAL_TIMEOUT;
+    }
+
+    // 3) TAP interface, frames without the packet information header
+    if (strncmp(pPath, "tap", 3) == 0 && (pPath[3] == '\0' || pPath[3] == ':'))
+    {
+        nFd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+        if (nFd < 0)
+        {
+            return HAL_ERROR;
+        }
+
+        sReq.ifr_flags = IFF_TAP | IFF_NO_PI;
+        snprintf(sReq.ifr_name, IFNAMSIZ, "%s", (pPath[3] == ':') ? &pPath[4] : HOST_ETH_TAP_DEFAULT);
+        if (ioctl(nFd, TUNSETIFF, &sReq) != 0)
+        {
+            close(nFd);
+            return HAL_ERROR;
+        }
+        fprintf(stderr, "%s attached to %s\n", psETH->pName, sReq.ifr_name);
+
+        psETH->nFd   = nFd;
+        psETH->fPcap = 0;
+        return HAL_OK;
+    }
+
+    // 4) Anything else is an Ethernet capture to replay
+    nFd = open(pPath, O_RDONLY);
+    if (nFd < 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if (read(nFd, abHeader, sizeof(abHeader)) != sizeof(abHeader))
+    {
+        close(nFd);
+        return HAL_ERROR;
+    }
+
+    memcpy(&dwMagic, abHeader, sizeof(dwMagic));
+    fSwap = (dwMagic != HOST_PCAP_MAGIC_US && dwMagic != HOST_PCAP_MAGIC_NS);
+    dwMagic = HOST_PCAP_Get32(abHeader, fSwap);
+    if ((dwMagic != HOST_PCAP_MAGIC_US && dwMagic != HOST_PCAP_MAGIC_NS) || HOST_PCAP_Get32(&abHeader[20], fSwap) != HOST_PCAP_LINK_ETH)
+    {
+        close(nFd);
+        return HAL_ERROR;
+    }
+
+    psETH->nFd   = nFd;
+    psETH->fPcap = fSwap ? HOST_PCAP_SWAPPED : HOST_PCAP_NATIVE;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Take the next frame from the backing file
+ * @param psETH - Host ETH instance
+ * @param pbFrame - Destination buffer
+ * @param dwSize - Size of pbFrame
+ * @retval Frame length, 0 if none is waiting
+ */
+static uint32_t HOST_ETH_Read(ETH_TypeDef *psETH, uint8_t *pbFrame, uint32_t dwSize)
+{
+    uint8_t abRecord[HOST_PCAP_RECORD];
+    uint32_t dwLength = 0;
+    ssize_t nRead     = 0;
+
+    // 1) A TAP read returns exactly one frame
+    if (!psETH->fPcap)
+    {
+        nRead = read(psETH->nFd, pbFrame, dwSize);
+        return (nRead > 0) ? (uint32_t)nRead : 0;
+    }
+
+    // 2) Replay the capture in a loop, a file without any frame never delivers one
+    nRead = read(psETH->nFd, abRecord, sizeof(abRecord));
+    if (nRead == 0 && lseek(psETH->nFd, HOST_PCAP_HEADER, SEEK_SET) == HOST_PCAP_HEADER)
+    {
+        nRead = read(psETH->nFd, abRecord, sizeof(abRecord));
+    }
+    if (nRead != sizeof(abRecord))
+    {
+        return 0;
+    }
+
+    // 3) Frames that do not fit a receive buffer are skipped, as the MAC would flag them as giants
+    dwLength = HOST_PCAP_Get32(&abRecord[8], psETH->fPcap == HOST_PCAP_SWAPPED);
+    if (dwLength > dwSize)
+    {
+        lseek(psETH->nFd, dwLength, SEEK_CUR);
+        return 0;
+    }
+
+    return (read(psETH->nFd, pbFrame, dwLength) == (ssize_t)dwLength) ? dwLength : 0;
+}
+
+/**
+ * @brief Emulated Ethernet DMA: send every frame handed over, fill every receive descriptor owned
+ * @param psETH - Host ETH instance
+ */
+static void HOST_ETH_RunDMA(ETH_TypeDef *psETH)
+{
+    static uint8_t abTxFrame[ETH_MAX_PACKET_SIZE];
+    static uint32_t dwTxLength = 0;
+    ETH_DMADescTypeDef *psDesc = NULL;
+    uint32_t dwLength          = 0;
+
+    if (!psETH->fRunning)
+    {
+        return;
+    }
+
+    // 1) Gather the segments of each frame, the capture replay has nowhere to send them
+    while ((psDesc = psETH->psTxDesc) != NULL && (psDesc->Status & ETH_DMATXDESC_OWN) != 0)
+    {
+        if ((psDesc->Status & ETH_DMATXDESC_FS) != 0)
+        {
+            dwTxLength = 0;
+        }
+
+        dwLength = psDesc->ControlBufferSize & ETH_DMATXDESC_TBS1;
+        if (dwTxLength + dwLength <= sizeof(abTxFrame))
+        {
+            memcpy(&abTxFrame[dwTxLength], (const void *)psDesc->Buffer1Addr, dwLength);
+            dwTxLength += dwLength;
+        }
+
+        if ((psDesc->Status & ETH_DMATXDESC_LS) != 0)
+        {
+            if (!psETH->fPcap && write(psETH->nFd, abTxFrame, dwTxLength) < 0)
+            {
+                psDesc->Status |= ETH_DMATXDESC_ES;
+            }
+            if ((psDesc->Status & ETH_DMATXDESC_IC) != 0)
+            {
+                psETH->DMASR |= ETH_DMA_FLAG_T;
+            }
+        }
+
+        psDesc->Status &= ~ETH_DMATXDESC_OWN;
+        psETH->psTxDesc = (ETH_DMADescTypeDef *)psDesc->Buffer2NextDescAddr;
+    }
+    psETH->DMASR |= ETH_DMA_FLAG_TBU;
+
+    // 2) One frame per receive descriptor, the length includes the FCS like on the wire
+    while ((psDesc = psETH->psRxDesc) != NULL && (psDesc->Status & ETH_DMARXDESC_OWN) != 0)
+    {
+        dwLength = HOST_ETH_Read(psETH, (uint8_t *)psDesc->Buffer1Addr, psDesc->ControlBufferSize & ETH_DMARXDESC_RBS1);
+        if (dwLength == 0)
+        {
+            return;
+        }
+
+        psDesc->Status  = ETH_DMARXDESC_FS | ETH_DMARXDESC_LS | ((dwLength + 4) << ETH_DMARXDESC_FRAMELENGTHSHIFT);
+        psETH->DMASR   |= ETH_DMA_FLAG_R;
+        psETH->psRxDesc = (ETH_DMADescTypeDef *)psDesc->Buffer2NextDescAddr;
+    }
+    psETH->DMASR |= ETH_DMA_FLAG_RBU;
+}
+
+/**
+ * @brief Bind the bulk data of the host USB port to its backing file
+ * @param psUSB - Host OTG core
+ * @retval HAL_OK on success, HAL_ERROR if the backing file could not be opened
+ */
+static HAL_StatusTypeDef HOST_USB_Open(USB_OTG_GlobalTypeDef *psUSB)
+{
+    const char *pPath = getenv(HOST_USB_ENV);
+    int nFd           = -1;
+
+    // 1) Already bound, or nothing to bind to and the data is discarded
+    if (psUSB->nFd >= 0 || pPath == NULL)
+    {
+        return HAL_OK;
+    }
+
+    // 2) Allocate a pseudo-terminal and tell the user where it is
+    if (strcmp(pPath, "pty") == 0)
+    {
+        nFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (nFd < 0 || grantpt(nFd) != 0 || unlockpt(nFd) != 0)
+        {
+            return HAL_ERROR;
+        }
+        fprintf(stderr, "%s attached to %s\n", psUSB->pName, ptsname(nFd));
+    }
+    // 3) Anything else is a path
+    else
+    {
+        nFd = open(pPath, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (nFd < 0)
+        {
+            return HAL_ERROR;
+        }
+    }
+
+    psUSB->nFd = nFd;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Check whether a backing file is ready for reading or writing right now
+ * @param nFd - File descriptor
+ * @param nEvents - POLLIN or POLLOUT
+ * @retval Non-zero when ready
+ */
+static int HOST_USB_Ready(int nFd, short nEvents)
+{
+    struct pollfd sPoll = {.fd = nFd, .events = nEvents};
+
+    return poll(&sPoll, 1, 0) > 0 && (sPoll.revents & nEvents) != 0;
+}
+
+/**
+ * @brief Deliver a SETUP packet, which the device cannot refuse. It also clears an EP0 stall
+ * @param hpcd - PCD handle pointer
+ * @param pbSetup - The eight bytes of the request
+ */
+static void HOST_USB_Setup(PCD_HandleTypeDef *hpcd, const uint8_t *pbSetup)
+{
+    memcpy(hpcd->Setup, pbSetup, 8);
+    hpcd->IN_ep[0].is_stall  = 0;
+    hpcd->OUT_ep[0].is_stall = 0;
+    hpcd->IN_ep[0].is_armed  = 0;
+    hpcd->OUT_ep[0].is_armed = 0;
+    HAL_PCD_SetupStageCallback(hpcd);
+}
+
+/**
+ * @brief Run one IN transaction, the device completes the transfer on its last packet
+ * @param hpcd - PCD handle pointer
+ * @param bEpNum - Endpoint number
+ * @param pbData - Destination of up to maxpacket bytes, NULL to drop the data
+ * @retval Bytes received, HOST_USB_NAK or HOST_USB_STALL
+ */
+static int HOST_USB_In(PCD_HandleTypeDef *hpcd, uint8_t bEpNum, uint8_t *pbData)
+{
+    PCD_EPTypeDef *psEp = &hpcd->IN_ep[bEpNum];
+    uint32_t dwPacket   = 0;
+
+    if (psEp->is_stall)
+    {
+        return HOST_USB_STALL;
+    }
+    if (!psEp->is_armed)
+    {
+        return HOST_USB_NAK;
+    }
+
+    dwPacket = psEp->xfer_len - psEp->xfer_count;
+    if (dwPacket > psEp->maxpacket)
+    {
+        dwPacket = psEp->maxpacket;
+    }
+    if (dwPacket != 0 && pbData != NULL)
+    {
+        memcpy(pbData, &psEp->xfer_buff[psEp->xfer_count], dwPacket);
+    }
+    psEp->xfer_count += dwPacket;
+
+    if (psEp->xfer_count >= psEp->xfer_len)
+    {
+        psEp->is_armed = 0;
+        HAL_PCD_DataInStageCallback(hpcd, bEpNum);
+    }
+
+    return (int)dwPacket;
+}
+
+/**
+ * @brief Run one OUT transaction, a short packet or a full buffer completes the transfer
+ * @param hpcd - PCD handle pointer
+ * @param bEpNum - Endpoint number
+ * @param pbData - Packet, may be NULL for a zero-length packet
+ * @param wLength - Packet length, at most maxpacket
+ * @retval Bytes sent, HOST_USB_NAK or HOST_USB_STALL
+ */
+static int HOST_USB_Out(PCD_HandleTypeDef *hpcd, uint8_t bEpNum, const uint8_t *pbData, uint16_t wLength)
+{
+    PCD_EPTypeDef *psEp = &hpcd->OUT_ep[bEpNum];
+    uint32_t dwRoom     = 0;
+
+    if (psEp->is_stall)
+    {
+        return HOST_USB_STALL;
+    }
+    if (!psEp->is_armed)
+    {
+        return HOST_USB_NAK;
+    }
+
+    // A packet larger than the room left is a babble, the excess is lost
+    dwRoom = psEp->xfer_len - psEp->xfer_count;
+    if (wLength != 0 && pbData != NULL)
+    {
+        memcpy(&psEp->xfer_buff[psEp->xfer_count], pbData, (wLength < dwRoom) ? wLength : dwRoom);
+    }
+    psEp->xfer_count += (wLength < dwRoom) ? wLength : dwRoom;
+
+    if (wLength < psEp->maxpacket || psEp->xfer_count >= psEp->xfer_len)
+    {
+        psEp->is_armed = 0;
+        HAL_PCD_DataOutStageCallback(hpcd, bEpNum);
+    }
+
+    return wLength;
+}
+
+/**
+ * @brief Copy the text of a string descriptor for the log, non-ASCII characters become '?'
+ * @param szText - Destination, 33 bytes
+ * @param pbDescriptor - String descriptor
+ * @param wLength - Bytes received
+ */
+static void HOST_USB_CopyString(char *szText, const uint8_t *pbDescriptor, uint16_t wLength)
+{
+    const uint8_t *pbChar = &pbDescriptor[2];
+    uint16_t wChars       = 0;
+
+    while (wChars < 32 && 2 + 2 * wChars + 1 < wLength)
+    {
+        szText[wChars] = (pbChar[1] == 0 && pbChar[0] >= 0x20 && pbChar[0] < 0x7F) ? (char)pbChar[0] : '?';
+        pbChar += 2;
+        wChars++;
+    }
+    szText[wChars] = '\0';
+}
+
+/**
+ * @brief Check what the device answered to a request the way a host driver would
+ * @param hpcd - PCD handle pointer
+ * @param psRequest - Request just completed
+ * @retval NULL when the answer is acceptable, otherwise what is wrong with it
+ */
+static const char *HOST_USB_Verify(PCD_HandleTypeDef *hpcd, const host_usb_request_t *psRequest)
+{
+    const uint8_t *pbSetup = psRequest->abSetup;
+    const uint8_t *pbData  = gsHostUsb.abData;
+    uint16_t wAsked        = (uint16_t)(pbSetup[6] | (pbSetup[7] << 8));
+    uint16_t wFull         = 0;
+
+    // 1) The device must take the new address by the end of the status stage
+    if (pbSetup[0] == 0x00 && pbSetup[1] == 0x05)
+    {
+        if (hpcd->USB_Address != pbSetup[2])
+        {
+            return "address not taken";
+        }
+        gsHostUsb.bAddress = pbSetup[2];
+        return NULL;
+    }
+
+    // 2) A descriptor is of the type asked for and exactly as long as it says, or cut at wLength
+    if (pbSetup[0] == 0x80 && pbSetup[1] == 0x06)
+    {
+        if (gsHostUsb.wDone < 4 || pbData[1] != pbSetup[3])
+        {
+            return "malformed descriptor";
+        }
+        wFull = (pbSetup[3] == 0x02) ? (uint16_t)(pbData[2] | (pbData[3] << 8)) : pbData[0];
+        if (gsHostUsb.wDone != ((wFull < wAsked) ? wFull : wAsked))
+        {
+            return "descriptor length mismatch";
+        }
+
+        switch (pbSetup[3])
+        {
+            case 0x01:
+                if (gsHostUsb.wDone >= 12)
+                {
+                    gsHostUsb.wVID = (uint16_t)(pbData[8] | (pbData[9] << 8));
+                    gsHostUsb.wPID = (uint16_t)(pbData[10] | (pbData[11] << 8));
+                }
+                break;
+            case 0x02:
+                gsHostUsb.wConfigLength = wFull;
+                break;
+            case 0x03:
+                if (pbSetup[2] == 2)
+                {
+                    HOST_USB_CopyString(gsHostUsb.szProduct, pbData, gsHostUsb.wDone);
+                }
+                else if (pbSetup[2] == 3)
+                {
+                    HOST_USB_CopyString(gsHostUsb.szSerial, pbData, gsHostUsb.wDone);
+                }
+                break;
+            default:
+                break;
+        }
+        return NULL;
+    }
+
+    // 3) GET_LINE_CODING returns what SET_LINE_CODING stored
+    if (pbSetup[0] == 0xA1 && pbSetup[1] == 0x21 &&
+        (gsHostUsb.wDone != sizeof(gabHostLineCoding) || memcmp(pbData, gabHostLineCoding, sizeof(gabHostLineCoding)) != 0))
+    {
+        return "line coding not kept";
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Give up on enumerating the device, as a host does after a failed request
+ * @param psRequest - Request that failed
+ * @param szWhy - What went wrong
+ */
+static void HOST_USB_Fail(const host_usb_request_t *psRequest, const char *szWhy)
+{
+    fprintf(stderr, "OTG_FS enumeration failed at %s: %s\n", psRequest->szName, szWhy);
+    gsHostUsb.fFailed = 1;
+}
+
+/**
+ * @brief Move the current control transfer of the enumeration script on by as much as the device allows in one frame
+ * @param hpcd - PCD handle pointer
+ */
+static void HOST_USB_Control(PCD_HandleTypeDef *hpcd)
+{
+    const host_usb_request_t *psRequest = &gasHostUsbScript[gsHostUsb.dwStep];
+    uint16_t wLength                    = (uint16_t)(psRequest->abSetup[6] | (psRequest->abSetup[7] << 8));
+    int fIn                             = (psRequest->abSetup[0] & 0x80) != 0;
+    const char *szWhy                   = NULL;
+    uint16_t wPacket                    = 0;
+    int nRet                            = 0;
+
+    if (++gsHostUsb.dwFrames > HOST_USB_TIMEOUT)
+    {
+        HOST_USB_Fail(psRequest, "timed out");
+        return;
+    }
+
+    // 1) SETUP, nobody answers at the wrong address
+    if (gsHostUsb.nPhase == HOST_USB_PHASE_SETUP)
+    {
+        if (hpcd->USB_Address != gsHostUsb.bAddress)
+        {
+            return;
+        }
+        gsHostUsb.wDone  = 0;
+        gsHostUsb.nPhase = (wLength != 0) ? HOST_USB_PHASE_DATA : HOST_USB_PHASE_STATUS;
+        HOST_USB_Setup(hpcd, psRequest->abSetup);
+    }
+
+    // 2) Data stage, as many packets as the device has ready. An IN stage ends on a short packet
+    while (gsHostUsb.nPhase == HOST_USB_PHASE_DATA)
+    {
+        if (fIn)
+        {
+            nRet = HOST_USB_In(hpcd, 0, &gsHostUsb.abData[gsHostUsb.wDone]);
+        }
+        else
+        {
+            wPacket = (wLength - gsHostUsb.wDone > 64) ? 64 : (uint16_t)(wLength - gsHostUsb.wDone);
+            nRet    = HOST_USB_Out(hpcd, 0, &psRequest->pbOut[gsHostUsb.wDone], wPacket);
+        }
+        if (nRet == HOST_USB_NAK)
+        {
+            return;
+        }
+        if (nRet == HOST_USB_STALL)
+        {
+            break;
+        }
+
+        gsHostUsb.wDone += fIn ? (uint16_t)nRet : wPacket;
+        if (gsHostUsb.wDone >= wLength || (fIn && nRet < 64))
+        {
+            gsHostUsb.nPhase = HOST_USB_PHASE_STATUS;
+        }
+        if (gsHostUsb.wDone > wLength)
+        {
+            HOST_USB_Fail(psRequest, "device sent more than asked for");
+            return;
+        }
+    }
+
+    // 3) Status stage in the other direction, always zero-length
+    if (nRet != HOST_USB_STALL)
+    {
+        nRet = (fIn && wLength != 0) ? HOST_USB_Out(hpcd, 0, NULL, 0) : HOST_USB_In(hpcd, 0, NULL);
+        if (nRet == HOST_USB_NAK)
+        {
+            return;
+        }
+        if (nRet > 0)
+        {
+            HOST_USB_Fail(psRequest, "data in the status stage");
+            return;
+        }
+    }
+
+    // 4) Judge the transfer and go to the next one
+    if (nRet == HOST_USB_STALL)
+    {
+        szWhy = psRequest->fExpectStall ? NULL : "stalled";
+    }
+    else
+    {
+        szWhy = psRequest->fExpectStall ? "not stalled" : HOST_USB_Verify(hpcd, psRequest);
+    }
+    if (szWhy != NULL)
+    {
+        HOST_USB_Fail(psRequest, szWhy);
+        return;
+    }
+
+    gsHostUsb.nPhase   = HOST_USB_PHASE_SETUP;
+    gsHostUsb.dwFrames = 0;
+    if (++gsHostUsb.dwStep == sizeof(gasHostUsbScript) / sizeof(gasHostUsbScript[0]))
+    {
+        gsHostUsb.fEnumerated = 1;
+        fprintf(stderr, "OTG_FS enumerated at address %u: %04X:%04X \"%s\" serial %s, %u-byte configuration\n",
+                gsHostUsb.bAddress, gsHostUsb.wVID, gsHostUsb.wPID, gsHostUsb.szProduct, gsHostUsb.szSerial, gsHostUsb.wConfigLength);
+    }
+}
+
+/**
+ * @brief Poll the open data endpoints for one frame, IN data goes to the backing file and OUT data comes from it
+ * @param hpcd - PCD handle pointer
+ */
+static void HOST_USB_Bulk(PCD_HandleTypeDef *hpcd)
+{
+    int nFd             = hpcd->Instance->nFd;
+    uint32_t dwPackets  = 0;
+    uint8_t abPacket[64];
+    PCD_EPTypeDef *psEp = NULL;
+    ssize_t nRead       = 0;
+    int nRet            = 0;
+
+    // 1) IN endpoints while the backing file takes data, an interrupt endpoint gets one poll per frame
+    for (uint8_t bEpNum = 1; bEpNum < 16 && dwPackets < HOST_USB_PACKETS; bEpNum++)
+    {
+        psEp = &hpcd->IN_ep[bEpNum];
+        while (psEp->maxpacket != 0 && dwPackets < HOST_USB_PACKETS && (nFd < 0 || HOST_USB_Ready(nFd, POLLOUT)))
+        {
+            nRet = HOST_USB_In(hpcd, bEpNum, abPacket);
+            if (nRet < 0)
+            {
+                break;
+            }
+            dwPackets++;
+            if (psEp->type == EP_TYPE_BULK && nFd >= 0 && nRet > 0 && write(nFd, abPacket, (size_t)nRet) < 0)
+            {
+                break;
+            }
+            if (psEp->type != EP_TYPE_BULK || (uint32_t)nRet < psEp->maxpacket)
+            {
+                break;
+            }
+        }
+    }
+
+    // 2) OUT bulk endpoints with what the backing file has, a short packet hands over partial data at once
+    for (uint8_t bEpNum = 1; bEpNum < 16 && dwPackets < HOST_USB_PACKETS && nFd >= 0; bEpNum++)
+    {
+        psEp = &hpcd->OUT_ep[bEpNum];
+        while (psEp->maxpacket != 0 && psEp->type == EP_TYPE_BULK && dwPackets < HOST_USB_PACKETS)
+        {
+            if (gsHostUsb.wOutLength == 0 && HOST_USB_Ready(nFd, POLLIN))
+            {
+                nRead                = read(nFd, gsHostUsb.abOut, psEp->maxpacket);
+                gsHostUsb.wOutLength = (nRead > 0) ? (uint16_t)nRead : 0;
+            }
+            if (gsHostUsb.wOutLength == 0 || HOST_USB_Out(hpcd, bEpNum, gsHostUsb.abOut, gsHostUsb.wOutLength) < 0)
+            {
+                break;
+            }
+            gsHostUsb.wOutLength = 0;
+            dwPackets++;
+        }
+    }
+}
+
+/**
+ * @brief Open the sample file named by NHNS_HOST_ADC, once
+ * @param psADC - Host ADC instance
+ * @note The ramp stands in when the variable is not set or the file cannot be opened
+ */
+static void HOST_ADC_Open(ADC_TypeDef *psADC)
+{
+    const char *pPath = getenv(HOST_ADC_ENV);
+
+    if (psADC->nFd >= 0 || pPath == NULL || pPath[0] == '\0')
+    {
+        return;
+    }
+
+    psADC->nFd = open(pPath, O_RDONLY);
+    if (psADC->nFd < 0)
+    {
+        fprintf(stderr, "%s: cannot open %s, %s, converting a ramp\n", psADC->pName, pPath, strerror(errno));
+    }
+}
+
+/**
+ * @brief Nanoseconds on the monotonic clock
+ * @retval Current time
+ */
+static uint64_t HOST_ADC_Now(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (uint64_t)sNow.tv_sec * HOST_NS_PER_S + (uint64_t)sNow.tv_nsec;
+}
+
+/**
+ * @brief Produce the next conversions
+ * @param psADC - Host ADC instance
+ * @param pwSamples - Destination in the circular buffer
+ * @param dwCount - Number of conversions
+ */
+static void HOST_ADC_Convert(ADC_TypeDef *psADC, uint16_t *pwSamples, uint32_t dwCount)
+{
+    size_t dwDone = 0;
+    ssize_t nRead = 0;
+
+    // 1) From the file, little-endian like the host, starting over at the end
+    while (psADC->nFd >= 0 && dwDone < dwCount * sizeof(uint16_t))
+    {
+        nRead = read(psADC->nFd, (uint8_t *)pwSamples + dwDone, dwCount * sizeof(uint16_t) - dwDone);
+        if (nRead > 0)
+        {
+            dwDone += (size_t)nRead;
+        }
+        else if (nRead == 0 && dwDone % sizeof(uint16_t) == 0 && lseek(psADC->nFd, 0, SEEK_SET) == 0 &&
+                 read(psADC->nFd, (uint8_t *)pwSamples + dwDone, sizeof(uint16_t)) == sizeof(uint16_t))
+        {
+            dwDone += sizeof(uint16_t);
+        }
+        else
+        {
+            // Empty, shorter than a sample or unreadable: the ramp takes over
+            fprintf(stderr, "%s: sample file unusable, converting a ramp\n", psADC->pName);
+            close(psADC->nFd);
+            psADC->nFd = -1;
+        }
+    }
+    if (psADC->nFd >= 0)
+    {
+        for (uint32_t i = 0; i < dwCount; i++)
+        {
+            pwSamples[i] &= HOST_ADC_MASK;
+        }
+        return;
+    }
+
+    // 2) Or the ramp, one step per conversion
+    for (uint32_t i = (uint32_t)(dwDone / sizeof(uint16_t)); i < dwCount; i++)
+    {
+        pwSamples[i] = psADC->wRamp;
+        psADC->wRamp = (psADC->wRamp + 1U) & HOST_ADC_MASK;
+    }
+}
+
+/**
+ * @brief Start converting into a circular buffer
+ * @param hadc - ADC handle pointer
+ * @param pData - Circular buffer
+ * @param dwSamples - Conversions the buffer holds
+ * @retval HAL_OK on success, HAL_BUSY if already converting, HAL_ERROR on bad arguments
+ */
+static HAL_StatusTypeDef HOST_ADC_Begin(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t dwSamples)
+{
+    ADC_TypeDef *psADC = hadc->Instance;
+
+    if (pData == NULL || dwSamples < 2 || (dwSamples & 1U) != 0 || hadc->DMA_Handle == NULL)
+    {
+        return HAL_ERROR;
+    }
+    if (psADC->fRunning)
+    {
+        return HAL_BUSY;
+    }
+    HOST_ADC_Open(psADC);
+
+    psADC->pwBuffer    = (uint16_t *)pData;
+    psADC->dwLength    = dwSamples;
+    psADC->dwPosition  = 0;
+    psADC->qwConverted = 0;
+    psADC->qwStartNs   = HOST_ADC_Now();
+    psADC->SR          = 0;
+    psADC->fRunning    = 1;
+
+    // Error states are left for the owner to clear, as on the target
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+    hadc->State     = (hadc->State & ~(HAL_ADC_STATE_READY | HAL_ADC_STATE_REG_OVR)) | HAL_ADC_STATE_REG_BUSY;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Stop converting
+ * @param hadc - ADC handle pointer
+ * @retval HAL_OK
+ */
+static HAL_StatusTypeDef HOST_ADC_End(ADC_HandleTypeDef *hadc)
+{
+    hadc->Instance->fRunning = 0;
+    hadc->State              = (hadc->State & ~HAL_ADC_STATE_REG_BUSY) | HAL_ADC_STATE_READY;
+
+    return HAL_OK;
+}
+
+// --- Functions ---
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &gsStartTime);
+
+    // Firmware reads flash in place, there is no running without it
+    if (HOST_FLASH_Map() != HAL_OK)
+    {
+        fprintf(stderr, "FLASH: cannot map 0x%08lX, %s\n", (unsigned long)FLASH_BASE, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    HAL_MspInit();
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_MspInit(void)
+{
+}
+
+uint32_t HAL_GetTick(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (uint32_t)((sNow.tv_sec - gsStartTime.tv_sec) * 1000 + (sNow.tv_nsec - gsStartTime.tv_nsec) / 1000000);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t dwStart = HAL_GetTick();
+
+    while ((HAL_GetTick() - dwStart) < Delay)
+    {
+    }
+}
+
+// A fixed unique ID, the host stands for one board
+uint32_t HAL_GetUIDw0(void)
+{
+    return 0x00360027U;
+}
+
+uint32_t HAL_GetUIDw1(void)
+{
+    return 0x3131510CU;
+}
+
+uint32_t HAL_GetUIDw2(void)
+{
+    return 0x38363735U;
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    UNUSED(RCC_OscInitStruct);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    UNUSED(RCC_ClkInitStruct);
+    UNUSED(FLatency);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    UNUSED(PeriphClkInit);
+    return HAL_OK;
+}
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    UNUSED(IRQn);
+    UNUSED(PreemptPriority);
+    UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0 && IRQn < HOST_IRQn_MAX)
+    {
+        gabIRQEnabled[IRQn] = 1;
+    }
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0 && IRQn < HOST_IRQn_MAX)
+    {
+        gabIRQEnabled[IRQn] = 0;
+    }
+}
+
+void HAL_NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0 && IRQn < HOST_IRQn_MAX)
+    {
+        gabIRQPending[IRQn] = 1;
+    }
+}
+
+uint32_t HAL_NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    return (IRQn >= 0 && IRQn < HOST_IRQn_MAX) ? gabIRQPending[IRQn] : 0;
+}
+
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn >= 0 && IRQn < HOST_IRQn_MAX)
+    {
+        gabIRQPending[IRQn] = 0;
+    }
+}
+
+int HAL_HOST_IsIRQEnabled(IRQn_Type IRQn)
+{
+    return (IRQn >= 0 && IRQn < HOST_IRQn_MAX) ? gabIRQEnabled[IRQn] : 0;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    gfHostFlashUnlocked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    gfHostFlashUnlocked = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint32_t dwWidth  = 1U << TypeProgram;
+    uint32_t dwOffset = Address - (uint32_t)FLASH_BASE;
+    uint8_t bWanted   = 0;
+    int fTorn         = 0;
+    int fNotErased    = 0;
+
+    // 1) Locked, outside the flash or misaligned
+    if (gpbHostFlash == NULL || !gfHostFlashUnlocked || TypeProgram > FLASH_TYPEPROGRAM_WORD || Address < FLASH_BASE ||
+        dwOffset + dwWidth > HOST_FLASH_SIZE || (Address & (dwWidth - 1)) != 0)
+    {
+        gdwHostFlashError |= HAL_FLASH_ERROR_PGS;
+        return HAL_ERROR;
+    }
+
+    // 2) Cells only go from 1 to 0. The target silently stores the AND, the host also reports it
+    fTorn = HOST_FLASH_PowerFails();
+    for (uint32_t dwByte = 0; dwByte < dwWidth && !(fTorn && dwByte >= dwWidth / 2); dwByte++)
+    {
+        bWanted = (uint8_t)(Data >> (8 * dwByte));
+        fNotErased |= (gpbHostFlash[dwOffset + dwByte] & bWanted) != bWanted;
+        gpbHostFlash[dwOffset + dwByte] &= bWanted;
+    }
+    if (fTorn)
+    {
+        HOST_FLASH_PowerOff("program", Address);
+    }
+    if (fNotErased)
+    {
+        gdwHostFlashError |= HAL_FLASH_ERROR_PGS;
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+    uint32_t dwStart = 0;
+    uint32_t dwSize  = 0;
+
+    *SectorError = 0xFFFFFFFFU;
+    if (gpbHostFlash == NULL || !gfHostFlashUnlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS ||
+        pEraseInit->Sector + pEraseInit->NbSectors > HOST_FLASH_SECTORS)
+    {
+        gdwHostFlashError |= HAL_FLASH_ERROR_WRP;
+        return HAL_ERROR;
+    }
+
+    // Instant here, a 128K sector takes 1 to 2 s on the target and stalls every flash read meanwhile
+    for (uint32_t dwSector = pEraseInit->Sector; dwSector < pEraseInit->Sector + pEraseInit->NbSectors; dwSector++)
+    {
+        dwStart = gadwHostFlashSectors[dwSector];
+        dwSize  = gadwHostFlashSectors[dwSector + 1] - dwStart;
+        if (HOST_FLASH_PowerFails())
+        {
+            memset(&gpbHostFlash[dwStart], 0xFF, dwSize / 2);
+            HOST_FLASH_PowerOff("erase", (uint32_t)FLASH_BASE + dwStart);
+        }
+        memset(&gpbHostFlash[dwStart], 0xFF, dwSize);
+    }
+
+    return HAL_OK;
+}
+
+uint32_t HAL_FLASH_GetError(void)
+{
+    return gdwHostFlashError;
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_CRC_MspInit(hcrc);
+    __HAL_CRC_DR_RESET(hcrc);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRC_DeInit(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_CRC_MspDeInit(hcrc);
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_CRC_MspInit(CRC_HandleTypeDef *hcrc)
+{
+    (void)hcrc;
+}
+
+__attribute__((weak)) void HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc)
+{
+    (void)hcrc;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    uint32_t dwCrc = hcrc->Instance->DR;
+
+    // One bit at a time, most significant first, the way the unit shifts each word in
+    for (uint32_t dwIndex = 0; dwIndex < BufferLength; dwIndex++)
+    {
+        dwCrc ^= pBuffer[dwIndex];
+        for (uint32_t dwBit = 0; dwBit < 32; dwBit++)
+        {
+            dwCrc = (dwCrc & 0x80000000U) ? (dwCrc << 1) ^ 0x04C11DB7U : (dwCrc << 1);
+        }
+    }
+    hcrc->Instance->DR = dwCrc;
+
+    return dwCrc;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    __HAL_CRC_DR_RESET(hcrc);
+
+    return HAL_CRC_Accumulate(hcrc, pBuffer, BufferLength);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    UNUSED(GPIOx);
+    UNUSED(GPIO_Init);
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    UNUSED(GPIOx);
+    UNUSED(GPIO_Pin);
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    return (hdma == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+    return (hdma == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength)
+{
+    DMA_Stream_TypeDef *psStream = hdma->Instance;
+
+    if (hdma->Init.Direction != DMA_MEMORY_TO_MEMORY || DataLength == 0 || DataLength > 0xFFFFU)
+    {
+        return HAL_ERROR;
+    }
+    if (psStream->fActive)
+    {
+        return HAL_BUSY;
+    }
+
+    psStream->dwSrc   = SrcAddress;
+    psStream->dwDst   = DstAddress;
+    psStream->dwItems = DataLength;
+    psStream->fActive = 1;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    hdma->Instance->fActive = 0;
+
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    DMA_Stream_TypeDef *psStream = hdma->Instance;
+    size_t dwSize                = 1;
+
+    // Peripheral DMA transfers are completed by the owning peripheral's IRQ handler
+    if (hdma->Init.Direction != DMA_MEMORY_TO_MEMORY || !psStream->fActive)
+    {
+        return;
+    }
+
+    // Memory to memory: move every item, then report the transfer complete
+    if (hdma->Init.PeriphDataAlignment == DMA_PDATAALIGN_WORD)
+    {
+        dwSize = 4;
+    }
+    else if (hdma->Init.PeriphDataAlignment == DMA_PDATAALIGN_HALFWORD)
+    {
+        dwSize = 2;
+    }
+    for (uint32_t i = 0; i < psStream->dwItems; i++)
+    {
+        memcpy((void *)(psStream->dwDst + ((hdma->Init.MemInc == DMA_MINC_ENABLE) ? i * dwSize : 0)),
+               (const void *)(psStream->dwSrc + ((hdma->Init.PeriphInc == DMA_PINC_ENABLE) ? i * dwSize : 0)), dwSize);
+    }
+    psStream->fActive = 0;
+
+    if (hdma->XferCpltCallback != NULL)
+    {
+        hdma->XferCpltCallback(hdma);
+    }
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == NULL || hadc->Instance == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_ADC_MspInit(hadc);
+    hadc->State     = HAL_ADC_STATE_READY;
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == NULL || hadc->Instance == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HOST_ADC_End(hadc);
+    HAL_ADC_MspDeInit(hadc);
+    hadc->State = 0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    UNUSED(hadc);
+    UNUSED(sConfig);
+    return HAL_OK;
+}
+
+// ADC2 and ADC3 follow ADC1 in multi mode, starting them only powers them up
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc)
+{
+    UNUSED(hadc);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *hadc)
+{
+    UNUSED(hadc);
+    return HAL_OK;
+}
+
+// One conversion per DMA item, halfwords
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    return HOST_ADC_Begin(hadc, pData, Length);
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+    return HOST_ADC_End(hadc);
+}
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef *hadc, ADC_MultiModeTypeDef *multimode)
+{
+    hadc->Instance->dwConversions = (multimode->Mode == ADC_TRIPLEMODE_INTERL) ? 3U : 1U;
+
+    return HAL_OK;
+}
+
+// Two conversions per DMA item, DMA mode 2 packs them in a word
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    return HOST_ADC_Begin(hadc, pData, Length * 2U);
+}
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef *hadc)
+{
+    return HOST_ADC_End(hadc);
+}
+
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *psADC = hadc->Instance;
+    uint64_t qwStart   = psADC->qwStartNs;
+    uint64_t qwElapsed = 0;
+    uint64_t qwDue     = 0;
+    uint32_t dwEnd     = 0;
+    uint32_t dwCount   = 0;
+
+    if (!psADC->fRunning || psADC->dwTriggerHz == 0)
+    {
+        return;
+    }
+
+    // 1) Conversions the trigger has asked for since the last call
+    qwElapsed = HOST_ADC_Now() - qwStart;
+    qwDue     = ((qwElapsed / HOST_NS_PER_S) * psADC->dwTriggerHz +
+             (qwElapsed % HOST_NS_PER_S) * psADC->dwTriggerHz / HOST_NS_PER_S) * psADC->dwConversions -
+            psADC->qwConverted;
+
+    // 2) Too far behind to catch up: the stream would have missed a request, which stops it
+    if (qwDue > (uint64_t)psADC->dwLength * HOST_ADC_MAX_LAG)
+    {
+        psADC->fRunning = 0;
+        psADC->SR |= ADC_FLAG_OVR;
+        hadc->State |= HAL_ADC_STATE_REG_OVR;
+        hadc->ErrorCode |= HAL_ADC_ERROR_OVR;
+        HAL_ADC_ErrorCallback(hadc);
+        return;
+    }
+
+    // 3) Fill up to each half and report it as the stream does, unless a callback restarts the ADC
+    while (qwDue > 0 && psADC->fRunning && psADC->qwStartNs == qwStart)
+    {
+        dwEnd   = (psADC->dwPosition < psADC->dwLength / 2) ? psADC->dwLength / 2 : psADC->dwLength;
+        dwCount = (qwDue < dwEnd - psADC->dwPosition) ? (uint32_t)qwDue : dwEnd - psADC->dwPosition;
+        HOST_ADC_Convert(psADC, &psADC->pwBuffer[psADC->dwPosition], dwCount);
+        psADC->dwPosition += dwCount;
+        psADC->qwConverted += dwCount;
+        qwDue -= dwCount;
+
+        if (psADC->dwPosition == psADC->dwLength / 2)
+        {
+            HAL_ADC_ConvHalfCpltCallback(hadc);
+        }
+        else if (psADC->dwPosition == psADC->dwLength)
+        {
+            psADC->dwPosition = 0;
+            if (hadc->DMA_Handle->Init.Mode != DMA_CIRCULAR)
+            {
+                HOST_ADC_End(hadc);
+            }
+            HAL_ADC_ConvCpltCallback(hadc);
+        }
+    }
+}
+
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    UNUSED(hadc);
+}
+
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    UNUSED(hadc);
+}
+
+__attribute__((weak)) void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    UNUSED(hadc);
+}
+
+void HAL_HOST_ADC_SetTriggerRate(ADC_TypeDef *ADCx, uint32_t dwHz)
+{
+    ADCx->dwTriggerHz = dwHz;
+}
+
+HAL_StatusTypeDef HAL_ETH_Init(ETH_HandleTypeDef *heth)
+{
+    HAL_StatusTypeDef nRet = HAL_OK;
+
+    if (heth == NULL || heth->Instance == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    if (heth->State == HAL_ETH_STATE_RESET)
+    {
+        HAL_ETH_MspInit(heth);
+    }
+
+    // Like a PHY without a cable, a missing backing file times out waiting for the link
+    nRet = HOST_ETH_Open(heth->Instance);
+
+    heth->Instance->DMASR  = 0;
+    heth->Instance->DMAIER = (heth->Init.RxMode == ETH_RXINTERRUPT_MODE) ? ETH_DMA_IT_R : 0;
+    heth->State            = HAL_ETH_STATE_READY;
+
+    return nRet;
+}
+
+HAL_StatusTypeDef HAL_ETH_DeInit(ETH_HandleTypeDef *heth)
+{
+    HAL_ETH_MspDeInit(heth);
+
+    if (heth->Instance->nFd >= 0)
+    {
+        close(heth->Instance->nFd);
+        heth->Instance->nFd = -1;
+    }
+    heth->Instance->fRunning = 0;
+    heth->State              = HAL_ETH_STATE_RESET;
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_ETH_MspInit(ETH_HandleTypeDef *heth)
+{
+    UNUSED(heth);
+}
+
+__attribute__((weak)) void HAL_ETH_MspDeInit(ETH_HandleTypeDef *heth)
+{
+    UNUSED(heth);
+}
+
+HAL_StatusTypeDef HAL_ETH_DMATxDescListInit(ETH_HandleTypeDef *heth, ETH_DMADescTypeDef *DMATxDescTab, uint8_t *TxBuff, uint32_t TxBuffCount)
+{
+    heth->TxDesc = DMATxDescTab;
+
+    for (uint32_t i = 0; i < TxBuffCount; i++)
+    {
+        DMATxDescTab[i].Status              = ETH_DMATXDESC_TCH;
+        DMATxDescTab[i].Buffer1Addr         = (uintptr_t)TxBuff + i * ETH_TX_BUF_SIZE;
+        DMATxDescTab[i].Buffer2NextDescAddr = (uintptr_t)&DMATxDescTab[(i + 1) % TxBuffCount];
+    }
+
+    heth->Instance->psTxDesc = DMATxDescTab;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_DMARxDescListInit(ETH_HandleTypeDef *heth, ETH_DMADescTypeDef *DMARxDescTab, uint8_t *RxBuff, uint32_t RxBuffCount)
+{
+    heth->RxDesc = DMARxDescTab;
+
+    for (uint32_t i = 0; i < RxBuffCount; i++)
+    {
+        DMARxDescTab[i].Status              = ETH_DMARXDESC_OWN;
+        DMARxDescTab[i].ControlBufferSize   = ETH_DMARXDESC_RCH | ETH_RX_BUF_SIZE;
+        DMARxDescTab[i].Buffer1Addr         = (uintptr_t)RxBuff + i * ETH_RX_BUF_SIZE;
+        DMARxDescTab[i].Buffer2NextDescAddr = (uintptr_t)&DMARxDescTab[(i + 1) % RxBuffCount];
+    }
+
+    heth->Instance->psRxDesc = DMARxDescTab;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_Start(ETH_HandleTypeDef *heth)
+{
+    heth->Instance->fRunning = 1;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_Stop(ETH_HandleTypeDef *heth)
+{
+    heth->Instance->fRunning = 0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ETH_GetReceivedFrame_IT(ETH_HandleTypeDef *heth)
+{
+    uint32_t dwScanned = 0;
+
+    // Same walk as the HAL: collect the descriptors of one frame, at most one ring's worth
+    while ((heth->RxDesc->Status & ETH_DMARXDESC_OWN) == 0 && dwScanned < ETH_RXBUFNB)
+    {
+        dwScanned++;
+
+        if ((heth->RxDesc->Status & (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) == ETH_DMARXDESC_FS)
+        {
+            heth->RxFrameInfos.FSRxDesc = heth->RxDesc;
+            heth->RxFrameInfos.SegCount = 1;
+        }
+        else if ((heth->RxDesc->Status & (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) == 0)
+        {
+            heth->RxFrameInfos.SegCount++;
+        }
+        else
+        {
+            heth->RxFrameInfos.LSRxDesc = heth->RxDesc;
+            heth->RxFrameInfos.SegCount++;
+            if (heth->RxFrameInfos.SegCount == 1)
+            {
+                heth->RxFrameInfos.FSRxDesc = heth->RxDesc;
+            }
+
+            heth->RxFrameInfos.length = ((heth->RxDesc->Status & ETH_DMARXDESC_FL) >> ETH_DMARXDESC_FRAMELENGTHSHIFT) - 4;
+            heth->RxFrameInfos.buffer = heth->RxFrameInfos.FSRxDesc->Buffer1Addr;
+            heth->RxDesc              = (ETH_DMADescTypeDef *)heth->RxDesc->Buffer2NextDescAddr;
+            return HAL_OK;
+        }
+
+        heth->RxDesc = (ETH_DMADescTypeDef *)heth->RxDesc->Buffer2NextDescAddr;
+    }
+
+    return HAL_ERROR;
+}
+
+void HAL_ETH_IRQHandler(ETH_HandleTypeDef *heth)
+{
+    ETH_TypeDef *psETH = heth->Instance;
+
+    // 1) Move the emulated DMA forward
+    HOST_ETH_RunDMA(psETH);
+
+    // 2) Dispatch the enabled events like the HAL handler
+    if ((psETH->DMASR & psETH->DMAIER & ETH_DMA_FLAG_R) != 0)
+    {
+        HAL_ETH_RxCpltCallback(heth);
+        psETH->DMASR &= ~ETH_DMA_FLAG_R;
+    }
+    if ((psETH->DMASR & psETH->DMAIER & ETH_DMA_FLAG_T) != 0)
+    {
+        HAL_ETH_TxCpltCallback(heth);
+        psETH->DMASR &= ~ETH_DMA_FLAG_T;
+    }
+}
+
+__attribute__((weak)) void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    UNUSED(heth);
+}
+
+__attribute__((weak)) void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    UNUSED(heth);
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL || huart->Instance == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_UART_MspInit(huart);
+
+    if (HOST_UART_Open(huart->Instance) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    huart->ErrorCode   = 0;
+    huart->TxXferCount = 0;
+    huart->RxXferCount = 0;
+    huart->gState      = HAL_UART_STATE_READY;
+    huart->RxState     = HAL_UART_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_UART_MspDeInit(huart);
+
+    huart->gState  = HAL_UART_STATE_RESET;
+    huart->RxState = HAL_UART_STATE_RESET;
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+    UNUSED(huart);
+}
+
+__attribute__((weak)) void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
+{
+    UNUSED(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    uint32_t dwStart = HAL_GetTick();
+    uint16_t bSent   = 0;
+
+    if (pData == NULL || Size == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if (huart->gState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    huart->TxXferCount = 0;
+    huart->gState      = HAL_UART_STATE_BUSY_TX;
+
+    while (bSent < Size)
+    {
+        bSent += HOST_UART_Write(huart->Instance, &pData[bSent], Size - bSent);
+
+        if (bSent < Size && (HAL_GetTick() - dwStart) > Timeout)
+        {
+            huart->gState = HAL_UART_STATE_READY;
+            return HAL_TIMEOUT;
+        }
+    }
+
+    huart->gState = HAL_UART_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    uint32_t dwStart   = HAL_GetTick();
+    uint16_t bReceived = 0;
+
+    if (pData == NULL || Size == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if (huart->RxState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+
+    while (bReceived < Size)
+    {
+        bReceived += HOST_UART_ReadAvailable(huart->Instance, &pData[bReceived], Size - bReceived);
+
+        if (bReceived < Size && (HAL_GetTick() - dwStart) > Timeout)
+        {
+            huart->RxState = HAL_UART_STATE_READY;
+            return HAL_TIMEOUT;
+        }
+    }
+
+    huart->RxState = HAL_UART_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (pData == NULL || Size == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if (huart->gState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    // The emulated DMA drains the buffer from HAL_UART_IRQHandler
+    huart->pTxBuffPtr  = pData;
+    huart->TxXferSize  = Size;
+    huart->TxXferCount = Size;
+    huart->gState      = HAL_UART_STATE_BUSY_TX;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (pData == NULL || Size == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if (huart->RxState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    // RxXferCount plays the part of the DMA NDTR register
+    huart->pRxBuffPtr    = pData;
+    huart->RxXferSize    = Size;
+    huart->RxXferCount   = Size;
+    huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+    huart->RxState       = HAL_UART_STATE_BUSY_RX;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
+{
+    huart->TxXferCount   = 0;
+    huart->RxXferCount   = 0;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+    huart->gState        = HAL_UART_STATE_READY;
+    huart->RxState       = HAL_UART_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
+{
+    huart->TxXferCount = 0;
+    huart->gState      = HAL_UART_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_UART_StateTypeDef HAL_UART_GetState(const UART_HandleTypeDef *huart)
+{
+    return (HAL_UART_StateTypeDef)(huart->gState | huart->RxState);
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+    uint16_t bPos   = 0;
+    uint16_t bRead  = 0;
+    int fCircular   = 0;
+    int fIdleEvent  = 0;
+    uint16_t bWrote = 0;
+
+    // 1) Emulated TX DMA: push what the backing file takes, complete when drained
+    if (huart->gState == HAL_UART_STATE_BUSY_TX && huart->TxXferCount > 0)
+    {
+        bWrote = HOST_UART_Write(huart->Instance, &huart->pTxBuffPtr[huart->TxXferSize - huart->TxXferCount], huart->TxXferCount);
+        huart->TxXferCount -= bWrote;
+
+        if (huart->TxXferCount == 0)
+        {
+            huart->gState = HAL_UART_STATE_READY;
+            HAL_UART_TxCpltCallback(huart);
+        }
+    }
+
+    // 2) Emulated RX DMA with idle-line detection
+    if (huart->RxState == HAL_UART_STATE_BUSY_RX && huart->ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+    {
+        fCircular = (huart->hdmarx != NULL && huart->hdmarx->Init.Mode == DMA_CIRCULAR);
+        bPos      = huart->RxXferSize - huart->RxXferCount;
+
+        while ((bRead = HOST_UART_ReadAvailable(huart->Instance, &huart->pRxBuffPtr[bPos], huart->RxXferSize - bPos)) > 0)
+        {
+            bPos += bRead;
+            fIdleEvent = 1;
+
+            // Transfer complete, wrap in circular mode or finish
+            if (bPos == huart->RxXferSize)
+            {
+                huart->RxXferCount = huart->RxXferSize;
+                fIdleEvent         = 0;
+
+                if (!fCircular)
+                {
+                    huart->RxState       = HAL_UART_STATE_READY;
+                    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+                    HAL_UARTEx_RxEventCallback(huart, huart->RxXferSize);
+                    return;
+                }
+
+                HAL_UARTEx_RxEventCallback(huart, huart->RxXferSize);
+                bPos = 0;
+            }
+        }
+
+        huart->RxXferCount = huart->RxXferSize - bPos;
+
+        // The line went idle with a partially filled buffer
+        if (fIdleEvent)
+        {
+            HAL_UARTEx_RxEventCallback(huart, bPos);
+        }
+    }
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    UNUSED(huart);
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    UNUSED(huart);
+}
+
+__attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    UNUSED(huart);
+    UNUSED(Size);
+}
+
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd)
+{
+    HAL_StatusTypeDef nRet = HAL_OK;
+
+    if (hpcd == NULL || hpcd->Instance == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    if (hpcd->State == HAL_PCD_STATE_RESET)
+    {
+        hpcd->Lock = HAL_UNLOCKED;
+        HAL_PCD_MspInit(hpcd);
+    }
+
+    nRet = HOST_USB_Open(hpcd->Instance);
+    if (nRet != HAL_OK)
+    {
+        hpcd->State = HAL_PCD_STATE_ERROR;
+        return nRet;
+    }
+
+    for (uint8_t bEpNum = 0; bEpNum < 16; bEpNum++)
+    {
+        memset(&hpcd->IN_ep[bEpNum], 0, sizeof(hpcd->IN_ep[bEpNum]));
+        memset(&hpcd->OUT_ep[bEpNum], 0, sizeof(hpcd->OUT_ep[bEpNum]));
+        hpcd->IN_ep[bEpNum].num         = bEpNum;
+        hpcd->IN_ep[bEpNum].is_in       = 1;
+        hpcd->IN_ep[bEpNum].tx_fifo_num = bEpNum;
+        hpcd->OUT_ep[bEpNum].num        = bEpNum;
+    }
+    hpcd->USB_Address = 0;
+    hpcd->State       = HAL_PCD_STATE_READY;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_DeInit(PCD_HandleTypeDef *hpcd)
+{
+    if (hpcd == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_PCD_Stop(hpcd);
+    HAL_PCD_MspDeInit(hpcd);
+    hpcd->State = HAL_PCD_STATE_RESET;
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_PCD_MspInit(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_MspDeInit(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd)
+{
+    // The simulated host sees the pull-up and resets the bus on the next frame
+    memset(&gsHostUsb, 0, sizeof(gsHostUsb));
+    hpcd->Instance->fConnected = 1;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_Stop(PCD_HandleTypeDef *hpcd)
+{
+    hpcd->Instance->fConnected = 0;
+
+    return HAL_OK;
+}
+
+void HAL_PCD_IRQHandler(PCD_HandleTypeDef *hpcd)
+{
+    if (!hpcd->Instance->fConnected || gsHostUsb.fFailed)
+    {
+        return;
+    }
+
+    // 1) A newly attached device gets a bus reset first, it comes out at address 0 with nothing armed
+    if (!gsHostUsb.fReset)
+    {
+        gsHostUsb.fReset  = 1;
+        hpcd->USB_Address = 0;
+        for (uint8_t bEpNum = 0; bEpNum < 16; bEpNum++)
+        {
+            hpcd->IN_ep[bEpNum].is_armed  = 0;
+            hpcd->IN_ep[bEpNum].is_stall  = 0;
+            hpcd->OUT_ep[bEpNum].is_armed = 0;
+            hpcd->OUT_ep[bEpNum].is_stall = 0;
+        }
+        HAL_PCD_ResetCallback(hpcd);
+        return;
+    }
+
+    // 2) Enumerate, then move data
+    if (!gsHostUsb.fEnumerated)
+    {
+        HOST_USB_Control(hpcd);
+    }
+    else
+    {
+        HOST_USB_Bulk(hpcd);
+    }
+}
+
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address)
+{
+    hpcd->USB_Address = address;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type)
+{
+    PCD_EPTypeDef *psEp = ((ep_addr & 0x80U) != 0) ? &hpcd->IN_ep[ep_addr & 0x0FU] : &hpcd->OUT_ep[ep_addr & 0x0FU];
+
+    psEp->maxpacket = ep_mps;
+    psEp->type      = ep_type;
+    psEp->is_armed  = 0;
+    psEp->is_stall  = 0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Close(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    PCD_EPTypeDef *psEp = ((ep_addr & 0x80U) != 0) ? &hpcd->IN_ep[ep_addr & 0x0FU] : &hpcd->OUT_ep[ep_addr & 0x0FU];
+
+    // A zero packet size marks the endpoint closed for the simulated host
+    psEp->maxpacket = 0;
+    psEp->is_armed  = 0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len)
+{
+    PCD_EPTypeDef *psEp = &hpcd->OUT_ep[ep_addr & 0x0FU];
+
+    // The core takes a single EP0 packet per transfer
+    psEp->xfer_buff  = pBuf;
+    psEp->xfer_len   = ((ep_addr & 0x0FU) == 0 && len > psEp->maxpacket) ? psEp->maxpacket : len;
+    psEp->xfer_count = 0;
+    psEp->is_armed   = 1;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pBuf, uint32_t len)
+{
+    PCD_EPTypeDef *psEp = &hpcd->IN_ep[ep_addr & 0x0FU];
+
+    psEp->xfer_buff  = pBuf;
+    psEp->xfer_len   = ((ep_addr & 0x0FU) == 0 && len > psEp->maxpacket) ? psEp->maxpacket : len;
+    psEp->xfer_count = 0;
+    psEp->is_armed   = 1;
+
+    return HAL_OK;
+}
+
+uint32_t HAL_PCD_EP_GetRxCount(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    return hpcd->OUT_ep[ep_addr & 0x0FU].xfer_count;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_SetStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    PCD_EPTypeDef *psEp = ((ep_addr & 0x80U) != 0) ? &hpcd->IN_ep[ep_addr & 0x0FU] : &hpcd->OUT_ep[ep_addr & 0x0FU];
+
+    psEp->is_stall = 1;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    PCD_EPTypeDef *psEp = ((ep_addr & 0x80U) != 0) ? &hpcd->IN_ep[ep_addr & 0x0FU] : &hpcd->OUT_ep[ep_addr & 0x0FU];
+
+    psEp->is_stall = 0;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCDEx_SetRxFiFo(PCD_HandleTypeDef *hpcd, uint16_t size)
+{
+    UNUSED(hpcd);
+    UNUSED(size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCDEx_SetTxFiFo(PCD_HandleTypeDef *hpcd, uint8_t fifo, uint16_t size)
+{
+    UNUSED(hpcd);
+    UNUSED(fifo);
+    UNUSED(size);
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    UNUSED(hpcd);
+    UNUSED(epnum);
+}
+
+__attribute__((weak)) void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    UNUSED(hpcd);
+    UNUSED(epnum);
+}
+
+__attribute__((weak)) void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_ConnectCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
+
+__attribute__((weak)) void HAL_PCD_DisconnectCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+}
@@ -0,0 +1,135 @@
+#include "stm32f2xx_it.h"
+#include "stm32f2xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "completion.h"
+#include "dmacopy.h"
+#include "emac.h"
+#include "pool.h"
+#include "rtstats.h"
+#include "sampler.h"
+#include "uart.h"
+#include "usb.h"
+
+// --- Types ---
+
+typedef struct host_vector
+{
+    IRQn_Type nIRQ;
+    void (*pfnHandler)(void);
+} host_vector_t;
+
+// --- Global Variables ---
+
+static const host_vector_t gasVectorTable[] = {
+    {EXTI0_IRQn,        EXTI0_IRQHandler       },
+    {DMA1_Stream1_IRQn, DMA1_Stream1_IRQHandler},
+    {DMA1_Stream3_IRQn, DMA1_Stream3_IRQHandler},
+    {ADC_IRQn,          ADC_IRQHandler         },
+    {USART3_IRQn,       USART3_IRQHandler      },
+    {DMA2_Stream0_IRQn, DMA2_Stream0_IRQHandler},
+    {DMA2_Stream4_IRQn, DMA2_Stream4_IRQHandler},
+    {ETH_IRQn,          ETH_IRQHandler         },
+    {OTG_FS_IRQn,       OTG_FS_IRQHandler      },
+};
+
+// --- Functions ---
+
+void EXTI0_IRQHandler(void)
+{
+    uint32_t dwStart = 0;
+
+    // Only ever pended from software, and taken like the NVIC would
+    if (!HAL_NVIC_GetPendingIRQ(EXTI0_IRQn))
+    {
+        return;
+    }
+    HAL_NVIC_ClearPendingIRQ(EXTI0_IRQn);
+
+    dwStart = RTSTATS_IsrEnter();
+    COMPLETION_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_EXTI0, dwStart);
+}
+
+void DMA1_Stream1_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    UART_RxDMA_IRQHandler(UART_INSTANCE_DEBUG);
+    RTSTATS_IsrExit(RTSTATS_ISR_DMA1_STREAM1, dwStart);
+}
+
+void DMA1_Stream3_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    UART_TxDMA_IRQHandler(UART_INSTANCE_DEBUG);
+    RTSTATS_IsrExit(RTSTATS_ISR_DMA1_STREAM3, dwStart);
+}
+
+void ADC_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    SAMPLER_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_ADC, dwStart);
+}
+
+void USART3_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    UART_IRQHandler(UART_INSTANCE_DEBUG);
+    RTSTATS_IsrExit(RTSTATS_ISR_USART3, dwStart);
+}
+
+void DMA2_Stream0_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    DMACOPY_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_DMA2_STREAM0, dwStart);
+}
+
+void DMA2_Stream4_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    SAMPLER_DMA_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_DMA2_STREAM4, dwStart);
+}
+
+void ETH_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    EMAC_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_ETH, dwStart);
+}
+
+void OTG_FS_IRQHandler(void)
+{
+    uint32_t dwStart = RTSTATS_IsrEnter();
+
+    USB_IRQHandler();
+    RTSTATS_IsrExit(RTSTATS_ISR_OTG_FS, dwStart);
+}
+
+/**
+ * @brief Emulated NVIC: run every enabled peripheral handler once per kernel tick
+ */
+void vApplicationTickHook(void)
+{
+    for (size_t i = 0; i < sizeof(gasVectorTable) / sizeof(gasVectorTable[0]); i++)
+    {
+        if (HAL_HOST_IsIRQEnabled(gasVectorTable[i].nIRQ))
+        {
+            gasVectorTable[i].pfnHandler();
+        }
+    }
+
+#ifdef FW_DEBUG
+    // The target runs it from the HAL tick (TIM6)
+    POOL_StressIRQHandler();
+#endif
+}
@@ -0,0 +1,22 @@
+#ifndef __STM32F2XX_IT_HOST_H__
+#define __STM32F2XX_IT_HOST_H__
+
+// --- Functions ---
+
+/*
+ * Same handler names as the target vector table. On the host they are invoked
+ * from the FreeRTOS tick hook, which runs in the simulator's tick signal
+ * handler and therefore behaves like an interrupt for FromISR APIs.
+ */
+
+void EXTI0_IRQHandler(void);
+void DMA1_Stream1_IRQHandler(void);
+void DMA1_Stream3_IRQHandler(void);
+void ADC_IRQHandler(void);
+void USART3_IRQHandler(void);
+void DMA2_Stream0_IRQHandler(void);
+void DMA2_Stream4_IRQHandler(void);
+void ETH_IRQHandler(void);
+void OTG_FS_IRQHandler(void);
+
+#endif    // __STM32F2XX_IT_HOST_H__
@@ -22,6 +22,17 @@
 #include "stm32f2xx_hal.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "clock.h"
+#include "completion.h"
+#include "crc.h"
+#include "dmacopy.h"
+#include "emac.h"
+#include "lowpower.h"
+#include "pool.h"
+#include "rtstats.h"
+#include "sampler.h"
+#include "uart.h"
+#include "usb.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -55,6 +66,7 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern TIM_HandleTypeDef htim6;
 
 /* USER CODE BEGIN EV */
 
@@ -158,6 +170,179 @@ void DebugMon_Handler(void)
 /* please refer to the startup file (startup_stm32f2xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles RTC wake-up interrupt through EXTI line 22.
+  */
+void RTC_WKUP_IRQHandler(void)
+{
+  /* USER CODE BEGIN RTC_WKUP_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  LOWPOWER_WakeupIRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_RTC_WKUP, dwStart);
+  /* USER CODE END RTC_WKUP_IRQn 0 */
+}
+
+/**
+  * @brief This function handles EXTI line0 interrupt.
+  */
+void EXTI0_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI0_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  COMPLETION_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_EXTI0, dwStart);
+  /* USER CODE END EXTI0_IRQn 0 */
+}
+
+/**
+  * @brief This function handles DMA1 stream1 global interrupt.
+  */
+void DMA1_Stream1_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream1_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  UART_RxDMA_IRQHandler(UART_INSTANCE_DEBUG);
+  RTSTATS_IsrExit(RTSTATS_ISR_DMA1_STREAM1, dwStart);
+  /* USER CODE END DMA1_Stream1_IRQn 0 */
+}
+
+/**
+  * @brief This function handles DMA1 stream3 global interrupt.
+  */
+void DMA1_Stream3_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream3_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  UART_TxDMA_IRQHandler(UART_INSTANCE_DEBUG);
+  RTSTATS_IsrExit(RTSTATS_ISR_DMA1_STREAM3, dwStart);
+  /* USER CODE END DMA1_Stream3_IRQn 0 */
+}
+
+/**
+  * @brief This function handles ADC1, ADC2 and ADC3 global interrupts.
+  */
+void ADC_IRQHandler(void)
+{
+  /* USER CODE BEGIN ADC_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  SAMPLER_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_ADC, dwStart);
+  /* USER CODE END ADC_IRQn 0 */
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts.
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI9_5_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  LOWPOWER_WakeupIRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_EXTI9_5, dwStart);
+  /* USER CODE END EXTI9_5_IRQn 0 */
+}
+
+/**
+  * @brief This function handles USART3 global interrupt.
+  */
+void USART3_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART3_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  UART_IRQHandler(UART_INSTANCE_DEBUG);
+  RTSTATS_IsrExit(RTSTATS_ISR_USART3, dwStart);
+  /* USER CODE END USART3_IRQn 0 */
+}
+
+/**
+  * @brief This function handles TIM6 global interrupt, DAC1 and DAC2 underrun error interrupts.
+  */
+void TIM6_DAC_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  /* USER CODE END TIM6_DAC_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim6);
+  /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
+#ifdef FW_DEBUG
+  POOL_StressIRQHandler();
+#endif
+  RTSTATS_IsrExit(RTSTATS_ISR_TIM6_DAC, dwStart);
+  /* USER CODE END TIM6_DAC_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM7 global interrupt.
+  */
+void TIM7_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM7_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  CLOCK_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_TIM7, dwStart);
+  /* USER CODE END TIM7_IRQn 0 */
+}
+
+/**
+  * @brief This function handles DMA2 stream0 global interrupt.
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream0_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  DMACOPY_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_DMA2_STREAM0, dwStart);
+  /* USER CODE END DMA2_Stream0_IRQn 0 */
+}
+
+/**
+  * @brief This function handles DMA2 stream4 global interrupt.
+  */
+void DMA2_Stream4_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream4_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  SAMPLER_DMA_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_DMA2_STREAM4, dwStart);
+  /* USER CODE END DMA2_Stream4_IRQn 0 */
+}
+
+/**
+  * @brief This function handles Ethernet global interrupt.
+  */
+void ETH_IRQHandler(void)
+{
+  /* USER CODE BEGIN ETH_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  EMAC_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_ETH, dwStart);
+  /* USER CODE END ETH_IRQn 0 */
+}
+
+/**
+  * @brief This function handles USB On The Go FS global interrupt.
+  */
+void OTG_FS_IRQHandler(void)
+{
+  /* USER CODE BEGIN OTG_FS_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  USB_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_OTG_FS, dwStart);
+  /* USER CODE END OTG_FS_IRQn 0 */
+}
+
+/**
+  * @brief This function handles DMA2 stream7 global interrupt.
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream7_IRQn 0 */
+  uint32_t dwStart = RTSTATS_IsrEnter();
+  CRC_DMA_IRQHandler();
+  RTSTATS_IsrExit(RTSTATS_ISR_DMA2_STREAM7, dwStart);
+  /* USER CODE END DMA2_Stream7_IRQn 0 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
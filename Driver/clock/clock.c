@@ -0,0 +1,135 @@
+#include <stdbool.h>
+#include "clock.h"
+#include "board.h"
+#ifdef NHNS_HOST
+#include <time.h>
+#endif
+
+// --- Types ---
+
+typedef struct clock_context
+{
+    bool fInitDone;
+
+    // Counter overflows, each one is 65536 us
+    volatile uint32_t dwOverflows;
+
+    // Time added for STOP periods, only written by the idle task with interrupts masked
+    volatile uint64_t qwOffset;
+} clock_context_t;
+
+// --- Global Variables ---
+
+static clock_context_t gsClock = {0};
+
+#ifndef NHNS_HOST
+static TIM_HandleTypeDef gsTimer = {0};
+#endif
+
+// --- Functions ---
+
+nhns_status_t CLOCK_Init(void)
+{
+#ifndef NHNS_HOST
+    uint32_t dwTimerClock = HAL_RCC_GetPCLK1Freq();
+#endif
+
+    // 1) Check if module is already initialized
+    if (gsClock.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+#ifndef NHNS_HOST
+    // 2) APB1 timers are clocked at twice PCLK1 whenever the bus is divided
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        dwTimerClock *= 2;
+    }
+
+    // 3) Free-running 16-bit up-counter, the update interrupt marks each wrap
+    gsTimer.Instance               = CLOCK_TIM;
+    gsTimer.Init.Prescaler         = dwTimerClock / CLOCK_HZ - 1;
+    gsTimer.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    gsTimer.Init.Period            = 0xFFFF;
+    gsTimer.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    gsTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&gsTimer) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 4) Count wraps in the interrupt
+    HAL_NVIC_SetPriority(CLOCK_TIM_IRQn, CLOCK_TIM_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(CLOCK_TIM_IRQn);
+    if (HAL_TIM_Base_Start_IT(&gsTimer) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+#endif
+
+    gsClock.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+uint64_t CLOCK_GetMicros(void)
+{
+#ifdef NHNS_HOST
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (uint64_t)sNow.tv_sec * CLOCK_HZ + (uint64_t)sNow.tv_nsec / (1000000000UL / CLOCK_HZ);
+#else
+    uint32_t dwPrimask   = __get_PRIMASK();
+    uint32_t dwOverflows = 0;
+    uint32_t dwCount     = 0;
+    uint64_t qwOffset    = 0;
+
+    if (!gsClock.fInitDone)
+    {
+        return 0;
+    }
+
+    // 1) Take the overflow count and the counter as one snapshot
+    __disable_irq();
+    dwOverflows = gsClock.dwOverflows;
+    dwCount     = gsTimer.Instance->CNT;
+    qwOffset    = gsClock.qwOffset;
+
+    // 2) A wrap the handler has not counted yet, the counter is read again since it may have been taken before it
+    if (__HAL_TIM_GET_FLAG(&gsTimer, TIM_FLAG_UPDATE))
+    {
+        dwCount = gsTimer.Instance->CNT;
+        dwOverflows++;
+    }
+    __set_PRIMASK(dwPrimask);
+
+    return qwOffset + (((uint64_t)dwOverflows << 16) | dwCount);
+#endif
+}
+
+void CLOCK_Advance(uint32_t dwMicros)
+{
+#ifdef NHNS_HOST
+    (void)dwMicros;
+#else
+    uint32_t dwPrimask = __get_PRIMASK();
+
+    __disable_irq();
+    gsClock.qwOffset += dwMicros;
+    __set_PRIMASK(dwPrimask);
+#endif
+}
+
+void CLOCK_IRQHandler(void)
+{
+#ifndef NHNS_HOST
+    if (__HAL_TIM_GET_FLAG(&gsTimer, TIM_FLAG_UPDATE))
+    {
+        __HAL_TIM_CLEAR_FLAG(&gsTimer, TIM_FLAG_UPDATE);
+        gsClock.dwOverflows++;
+    }
+#endif
+}
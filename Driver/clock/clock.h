@@ -0,0 +1,47 @@
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+
+// --- Definitions ---
+
+/*
+ * 64-bit monotonic microsecond clock, independent of the kernel tick (SysTick)
+ * and of the HAL tick (TIM6). A basic timer free-runs at 1 MHz and its
+ * overflow interrupt extends the 16-bit counter, so a read costs a few register
+ * accesses and works from tasks and ISRs of any priority. Time spent in STOP,
+ * where the timer has no clock, is added back by Driver/lowpower.
+ */
+
+#define CLOCK_HZ 1000000UL
+
+// --- Functions ---
+
+/**
+ * @brief Start the microsecond clock
+ * @retval Status code indicating operation success or reason for failure
+ * @note Call after SystemClock_Config, the prescaler is derived from the APB1 clock
+ */
+nhns_status_t CLOCK_Init(void);
+
+/**
+ * @brief Read the clock, callable from tasks and ISRs
+ * @retval Microseconds since CLOCK_Init
+ */
+uint64_t CLOCK_GetMicros(void);
+
+/**
+ * @brief Account for time the clock's timer did not see
+ * @param dwMicros - Microseconds to add
+ * @note Called by Driver/lowpower after a STOP period
+ */
+void CLOCK_Advance(uint32_t dwMicros);
+
+/**
+ * @brief Extend the counter on overflow
+ * @note Called from the clock timer's interrupt handler
+ */
+void CLOCK_IRQHandler(void);
+
+#endif    // __CLOCK_H__
@@ -0,0 +1,318 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "completion.h"
+#include "board.h"
+#include "profiler.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#if COMPLETION_NOTIFY_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES
+#error "COMPLETION_NOTIFY_INDEX needs configTASK_NOTIFICATION_ARRAY_ENTRIES raised in FreeRTOSConfig.h"
+#endif
+
+#define COMPLETION_LINE_SIZE        128
+
+#define COMPLETION_BENCH_ROUNDS     64
+#define COMPLETION_BENCH_TIMEOUT_MS 100
+
+// --- Types ---
+
+typedef struct completion_context
+{
+    bool fInitDone;
+    TimerHandle_t xTimer;             // Pends the spare interrupt, one tick after the waiter went to sleep
+    SemaphoreHandle_t xSemaphore;     // What the drivers used before, for comparison
+
+    // The handler signals sBench, or gives xSemaphore while fSemaphore is set
+    completion_t sBench;
+    volatile bool fSemaphore;
+    volatile uint32_t dwGiven;        // PROFILER_GetCycles when xSemaphore was given
+} completion_context_t;
+
+typedef struct completion_latency
+{
+    uint32_t dwMin;
+    uint32_t dwMax;
+    uint64_t qwSum;
+    uint32_t dwRounds;
+} completion_latency_t;
+
+// --- Global Variables ---
+
+static completion_context_t gsCompletion = {0};
+
+RTOS_TIMER_DEFINE(completion_pend);
+RTOS_SEMAPHORE_DEFINE(completion_bench);
+
+// --- Static Functions ---
+
+/**
+ * @brief Pend the spare interrupt, the stand-in for a peripheral finishing a transfer
+ * @param xTimer - Unused
+ */
+static void COMPLETION_TimerCallback(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    HAL_NVIC_SetPendingIRQ(COMPLETION_IRQn);
+}
+
+/**
+ * @brief Sleep until the spare interrupt wakes the caller, and time the wake-up
+ * @param fSemaphore - Wait on the binary semaphore instead of the notification
+ * @param pdwLatency - Returns the cycles from the handler to the caller running again
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t COMPLETION_Measure(bool fSemaphore, uint32_t *pdwLatency)
+{
+    uint32_t dwWoken   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Arm the mechanism under test, a give left over from a timed-out round is dropped
+    gsCompletion.fSemaphore = fSemaphore;
+    if (fSemaphore)
+    {
+        xSemaphoreTake(gsCompletion.xSemaphore, 0);
+    }
+    else
+    {
+        nRet = COMPLETION_Arm(&gsCompletion.sBench);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            return nRet;
+        }
+    }
+
+    // 2) The timer task runs once the caller sleeps, so the interrupt finds it waiting
+    if (xTimerStart(gsCompletion.xTimer, 0) != pdPASS)
+    {
+        if (!fSemaphore)
+        {
+            COMPLETION_Cancel(&gsCompletion.sBench);
+        }
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 3) Take the time first thing after waking
+    if (fSemaphore)
+    {
+        if (xSemaphoreTake(gsCompletion.xSemaphore, pdMS_TO_TICKS(COMPLETION_BENCH_TIMEOUT_MS)) != pdTRUE)
+        {
+            nRet = NHNS_STATUS_TIMEOUT;
+        }
+        dwWoken     = PROFILER_GetCycles();
+        *pdwLatency = dwWoken - gsCompletion.dwGiven;
+    }
+    else
+    {
+        nRet        = COMPLETION_Wait(&gsCompletion.sBench, COMPLETION_BENCH_TIMEOUT_MS);
+        dwWoken     = PROFILER_GetCycles();
+        *pdwLatency = dwWoken - gsCompletion.sBench.dwSignalled;
+    }
+
+    return nRet;
+}
+
+/**
+ * @brief Print the spread of one mechanism
+ * @param nID - UART instance to print on
+ * @param szName - Mechanism
+ * @param psLatency - Rounds measured
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t COMPLETION_PrintLatency(uart_instance_t nID, const char *szName, const completion_latency_t *psLatency)
+{
+    uint64_t qwHz      = PROFILER_GetCyclesPerSecond();
+    uint32_t dwAverage = (psLatency->dwRounds != 0) ? (uint32_t)(psLatency->qwSum / psLatency->dwRounds) : 0;
+    char szLine[COMPLETION_LINE_SIZE];
+
+    return UART_PrintLine(nID, szLine,
+                          snprintf(szLine, sizeof(szLine), "completion %-12s %3lu rounds: min %6lu, avg %6lu, max %6lu cycles, avg %6lu ns\r\n",
+                                   szName, (unsigned long)psLatency->dwRounds, (unsigned long)psLatency->dwMin,
+                                   (unsigned long)dwAverage, (unsigned long)psLatency->dwMax,
+                                   (unsigned long)((qwHz != 0) ? (uint64_t)dwAverage * 1000000000ULL / qwHz : 0)),
+                          COMPLETION_LINE_SIZE);
+}
+
+// --- Functions ---
+
+nhns_status_t COMPLETION_Init(void)
+{
+    // 1) Check if module is already initialized
+    if (gsCompletion.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) The spare interrupt, at a priority allowed to call the FromISR API
+    HAL_NVIC_SetPriority(COMPLETION_IRQn, COMPLETION_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(COMPLETION_IRQn);
+
+    // 3) The one-shot timer pending it and the semaphore to compare against
+    gsCompletion.xTimer     = RTOS_TIMER_CREATE(completion_pend, 1, pdFALSE, NULL, COMPLETION_TimerCallback);
+    gsCompletion.xSemaphore = RTOS_BINARY_SEMAPHORE_CREATE(completion_bench);
+    if (gsCompletion.xTimer == NULL || gsCompletion.xSemaphore == NULL)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    gsCompletion.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t COMPLETION_Arm(completion_t *psCompletion)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify argument
+    if (psCompletion == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Nothing can sleep on it before the scheduler runs
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return NHNS_STATUS_UNSUPPORTED;
+    }
+
+    // 3) Claim it, a signal can only come once the caller starts the transfer
+    taskENTER_CRITICAL();
+    if (psCompletion->xWaiter != NULL)
+    {
+        nRet = NHNS_STATUS_BUSY;
+    }
+    else
+    {
+        psCompletion->nStatus = NHNS_STATUS_OK;
+        psCompletion->xWaiter = xTaskGetCurrentTaskHandle();
+    }
+    taskEXIT_CRITICAL();
+
+    return nRet;
+}
+
+void COMPLETION_Signal(completion_t *psCompletion, nhns_status_t nStatus)
+{
+    UBaseType_t uxSaved = 0;
+    BaseType_t xWoken   = pdFALSE;
+
+    // 1) Take the waiter and notify it in one go, a waiter timing out sees either nothing or both
+    uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    if (psCompletion->xWaiter != NULL)
+    {
+        psCompletion->nStatus     = nStatus;
+        psCompletion->dwSignalled = PROFILER_GetCycles();
+        vTaskNotifyGiveIndexedFromISR(psCompletion->xWaiter, COMPLETION_NOTIFY_INDEX, &xWoken);
+        psCompletion->xWaiter = NULL;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+
+    // 2) Switch straight to the waiter if it outranks the interrupted task
+    portYIELD_FROM_ISR(xWoken);
+}
+
+nhns_status_t COMPLETION_Wait(completion_t *psCompletion, uint32_t dwTimeoutMs)
+{
+    TickType_t xTicks = (dwTimeoutMs == COMPLETION_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(dwTimeoutMs);
+    bool fSignalled   = false;
+
+    // 1) Only the signal of the armed completion counts up this index
+    if (ulTaskNotifyTakeIndexed(COMPLETION_NOTIFY_INDEX, pdTRUE, xTicks) != 0)
+    {
+        return psCompletion->nStatus;
+    }
+
+    // 2) Timed out, give up unless the signal came in since
+    taskENTER_CRITICAL();
+    fSignalled            = (psCompletion->xWaiter == NULL);
+    psCompletion->xWaiter = NULL;
+    taskEXIT_CRITICAL();
+    if (!fSignalled)
+    {
+        return NHNS_STATUS_TIMEOUT;
+    }
+
+    // 3) It did, take its notification so it does not end the next wait early
+    ulTaskNotifyTakeIndexed(COMPLETION_NOTIFY_INDEX, pdTRUE, 0);
+
+    return psCompletion->nStatus;
+}
+
+void COMPLETION_Cancel(completion_t *psCompletion)
+{
+    bool fSignalled = false;
+
+    // 1) Disarm, unless the signal already came
+    taskENTER_CRITICAL();
+    fSignalled            = (psCompletion->xWaiter == NULL);
+    psCompletion->xWaiter = NULL;
+    taskEXIT_CRITICAL();
+
+    // 2) It did, take its notification so it does not end the next wait early
+    if (fSignalled)
+    {
+        ulTaskNotifyTakeIndexed(COMPLETION_NOTIFY_INDEX, pdTRUE, 0);
+    }
+}
+
+nhns_status_t COMPLETION_Benchmark(uart_instance_t nID)
+{
+    static const char *const aszNames[] = {"notification", "semaphore"};
+    completion_latency_t asLatency[2]   = {0};
+    UBaseType_t uxPriority              = uxTaskPriorityGet(NULL);
+    uint32_t dwLatency                  = 0;
+    nhns_status_t nRet                  = NHNS_STATUS_OK;
+
+    // 1) Check if module is initialized
+    if (!gsCompletion.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 2) Outrank the timer task, so the handler switches straight back to the caller
+    vTaskPrioritySet(NULL, configMAX_PRIORITIES - 1);
+    for (uint32_t dwMode = 0; dwMode < 2 && nRet == NHNS_STATUS_OK; dwMode++)
+    {
+        asLatency[dwMode].dwMin = UINT32_MAX;
+        for (uint32_t dwRound = 0; dwRound < COMPLETION_BENCH_ROUNDS && nRet == NHNS_STATUS_OK; dwRound++)
+        {
+            nRet = COMPLETION_Measure(dwMode != 0, &dwLatency);
+            if (nRet == NHNS_STATUS_OK)
+            {
+                asLatency[dwMode].dwMin = (dwLatency < asLatency[dwMode].dwMin) ? dwLatency : asLatency[dwMode].dwMin;
+                asLatency[dwMode].dwMax = (dwLatency > asLatency[dwMode].dwMax) ? dwLatency : asLatency[dwMode].dwMax;
+                asLatency[dwMode].qwSum += dwLatency;
+                asLatency[dwMode].dwRounds++;
+            }
+        }
+    }
+    gsCompletion.fSemaphore = false;
+    vTaskPrioritySet(NULL, uxPriority);
+
+    // 3) Both mechanisms, from the give in the handler to the waiter running
+    for (uint32_t dwMode = 0; dwMode < 2 && nRet == NHNS_STATUS_OK; dwMode++)
+    {
+        nRet = COMPLETION_PrintLatency(nID, aszNames[dwMode], &asLatency[dwMode]);
+    }
+
+    return nRet;
+}
+
+void COMPLETION_IRQHandler(void)
+{
+    BaseType_t xWoken = pdFALSE;
+
+    if (gsCompletion.fSemaphore)
+    {
+        gsCompletion.dwGiven = PROFILER_GetCycles();
+        xSemaphoreGiveFromISR(gsCompletion.xSemaphore, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+    else
+    {
+        COMPLETION_Signal(&gsCompletion.sBench, NHNS_STATUS_OK);
+    }
+}
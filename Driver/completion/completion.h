@@ -0,0 +1,93 @@
+#ifndef __COMPLETION_H__
+#define __COMPLETION_H__
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Interrupt-to-task completion of a driver transfer on a task notification.
+ * The task arms the completion, starts the transfer and waits; the interrupt
+ * that ends the transfer signals it with a status, which wakes the task
+ * directly, with no semaphore or queue between the two. Completions use
+ * notification index COMPLETION_NOTIFY_INDEX, so index 0 stays with stream
+ * buffers and the plain xTaskNotifyGive users.
+ *
+ * A completion has one waiter at a time, and a task waits on one completion
+ * at a time. A signal with nobody armed, or after the waiter timed out, is
+ * dropped, so a late interrupt of an abandoned transfer does not carry over
+ * into the next wait.
+ *
+ * COMPLETION_Benchmark times the wake-up from an interrupt handler to the
+ * waiting task, against a binary semaphore given from the same handler. The
+ * interrupt is a spare vector pended from software.
+ */
+
+#define COMPLETION_NOTIFY_INDEX  1             // Below configTASK_NOTIFICATION_ARRAY_ENTRIES
+#define COMPLETION_WAIT_FOREVER  0xFFFFFFFFU    // Timeout of COMPLETION_Wait
+
+// --- Types ---
+
+typedef struct completion
+{
+    TaskHandle_t volatile xWaiter;    // Armed task, NULL once signalled or given up
+    volatile nhns_status_t nStatus;   // Passed to COMPLETION_Signal
+    volatile uint32_t dwSignalled;    // PROFILER_GetCycles when signalled
+} completion_t;
+
+// --- Functions ---
+
+/**
+ * @brief Configure the spare interrupt and the timer of the benchmark
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t COMPLETION_Init(void);
+
+/**
+ * @brief Make the calling task the waiter, before starting the transfer
+ * @param psCompletion - Completion to arm
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BUSY while another task is armed on it, NHNS_STATUS_UNSUPPORTED before the scheduler runs
+ */
+nhns_status_t COMPLETION_Arm(completion_t *psCompletion);
+
+/**
+ * @brief Wake the armed task, from the interrupt that ended the transfer
+ * @param psCompletion - Completion to signal
+ * @param nStatus - Outcome of the transfer, returned by COMPLETION_Wait
+ * @note Does nothing with nobody armed, so handlers can signal on every event
+ */
+void COMPLETION_Signal(completion_t *psCompletion, nhns_status_t nStatus);
+
+/**
+ * @brief Sleep until the completion is signalled
+ * @param psCompletion - Completion armed by the calling task
+ * @param dwTimeoutMs - Longest wait, COMPLETION_WAIT_FOREVER for none, 0 to only check
+ * @retval The status given to COMPLETION_Signal, NHNS_STATUS_TIMEOUT if it was not signalled in time
+ * @note Disarms the completion either way
+ */
+nhns_status_t COMPLETION_Wait(completion_t *psCompletion, uint32_t dwTimeoutMs);
+
+/**
+ * @brief Disarm a completion whose transfer was not started or is no longer waited for
+ * @param psCompletion - Completion armed by the calling task
+ */
+void COMPLETION_Cancel(completion_t *psCompletion);
+
+/**
+ * @brief Print the interrupt-to-task wake-up time of a notification and of a binary semaphore
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t COMPLETION_Benchmark(uart_instance_t nID);
+
+/**
+ * @brief Spare interrupt entry point, called from the vector table
+ */
+void COMPLETION_IRQHandler(void);
+
+#endif    // __COMPLETION_H__
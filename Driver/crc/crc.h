@@ -0,0 +1,90 @@
+#ifndef __CRC_H__
+#define __CRC_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * CRC-32/MPEG-2 as the CRC unit computes it: polynomial 0x04C11DB7, initial
+ * value 0xFFFFFFFF, no reflection and no final XOR, over 32-bit words taken
+ * little-endian from memory. Each CRC_Update pads its last partial word with
+ * 0xFF, the value of erased flash.
+ *
+ * The unit holds one running CRC, so a computation takes it with CRC_Begin and
+ * gives it back with CRC_End. Word-aligned runs of CRC_DMA_THRESHOLD bytes or
+ * more are fed by DMA2 in memory-to-memory mode while the caller sleeps until
+ * the transfer-complete interrupt; the CPU writes shorter or unaligned data,
+ * and everything before the scheduler starts. CRC_Software gives the same
+ * results from a 256-entry table, without the unit.
+ */
+
+#define CRC_INITIAL_VALUE 0xFFFFFFFFU
+
+// Below this the DMA set-up and the context switches cost more than the CPU writing the words
+#define CRC_DMA_THRESHOLD 256
+
+// --- Functions ---
+
+/**
+ * @brief Create the lock and start the unit
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CRC_Init(void);
+
+/**
+ * @brief Take the unit and reset it to CRC_INITIAL_VALUE, waiting while another task has it
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CRC_Begin(void);
+
+/**
+ * @brief Feed bytes to the unit taken with CRC_Begin
+ * @param pvData - Bytes, in RAM or in the flash
+ * @param dwLength - Number of bytes, a partial last word is padded with 0xFF
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_TIMEOUT when a DMA transfer never completes, the CRC is then lost
+ */
+nhns_status_t CRC_Update(const void *pvData, uint32_t dwLength);
+
+/**
+ * @brief Read the result and give the unit back
+ * @param pdwCrc - Returns the CRC
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CRC_End(uint32_t *pdwCrc);
+
+/**
+ * @brief Compute the CRC of one buffer with the unit
+ * @param pvData - Bytes, in RAM or in the flash
+ * @param dwLength - Number of bytes
+ * @param pdwCrc - Returns the CRC
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CRC_Compute(const void *pvData, uint32_t dwLength, uint32_t *pdwCrc);
+
+/**
+ * @brief Continue a CRC in software, matching the unit bit for bit
+ * @param dwCrc - CRC so far, CRC_INITIAL_VALUE to start
+ * @param pvData - Bytes
+ * @param dwLength - Number of bytes, a partial last word is padded with 0xFF
+ * @retval Updated CRC
+ */
+uint32_t CRC_Software(uint32_t dwCrc, const void *pvData, uint32_t dwLength);
+
+/**
+ * @brief Checksum the start of the flash with the table, the CPU-fed unit and the DMA-fed unit, and print bytes per cycle
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when the paths disagree
+ */
+nhns_status_t CRC_Benchmark(uart_instance_t nID);
+
+/**
+ * @brief DMA2 stream interrupt, call from CRC_DMA_IRQn
+ */
+void CRC_DMA_IRQHandler(void);
+
+#endif    // __CRC_H__
@@ -0,0 +1,612 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "dmacopy.h"
+#include "board.h"
+#include "completion.h"
+#include "heap.h"
+#include "lowpower.h"
+#include "profiler.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define DMACOPY_LINE_SIZE    128
+
+#define DMACOPY_MAX_BYTES    (0xFFFFU * 4U)    // NDTR is 16 bits, counted in words
+
+#define DMACOPY_BENCH_MIN    16
+#define DMACOPY_BENCH_MAX    8192
+#define DMACOPY_BENCH_ROUNDS 8
+
+// --- Types ---
+
+typedef struct dmacopy_request
+{
+    uint8_t *pbDst;          // Word aligned
+    const uint8_t *pbSrc;    // Word aligned, NULL for a fill
+    uint32_t dwLength;       // Multiple of 4
+    uint32_t dwPattern;      // Fill value in every byte, the stream reads it in place
+    dmacopy_callback_t pfnDone;
+    void *pvContext;
+} dmacopy_request_t;
+
+typedef struct dmacopy_context
+{
+    bool fInitDone;
+    QueueHandle_t xQueue;
+    DMA_HandleTypeDef sDMAHandle;
+
+    // The interrupt owns these while fBusy is set
+    volatile bool fBusy;
+    dmacopy_request_t sActive;
+    uint32_t dwOffset;    // Bytes of sActive already moved
+    uint32_t dwChunk;     // Bytes of the transfer in flight
+
+    dmacopy_stats_t sStats;
+} dmacopy_context_t;
+
+// --- Global Variables ---
+
+static dmacopy_context_t gsDmacopy = {0};
+
+RTOS_QUEUE_DEFINE(dmacopy, DMACOPY_QUEUE_LENGTH, sizeof(dmacopy_request_t));
+
+// --- Static Functions ---
+
+/**
+ * @brief Copy or fill with the CPU
+ * @param pbDst - Destination
+ * @param pbSrc - Source, NULL to fill
+ * @param bValue - Fill value
+ * @param dwLength - Number of bytes
+ */
+static void DMACOPY_Cpu(uint8_t *pbDst, const uint8_t *pbSrc, uint8_t bValue, uint32_t dwLength)
+{
+    if (pbSrc != NULL)
+    {
+        memcpy(pbDst, pbSrc, dwLength);
+    }
+    else
+    {
+        memset(pbDst, bValue, dwLength);
+    }
+}
+
+/**
+ * @brief Start the next chunk of the active request
+ * @retval HAL status of the start
+ * @note Called with the stream idle, from the interrupt or inside a critical section
+ */
+static HAL_StatusTypeDef DMACOPY_Transfer(void)
+{
+    dmacopy_request_t *psRequest = &gsDmacopy.sActive;
+    uintptr_t dwSrc              = 0;
+
+    gsDmacopy.dwChunk = psRequest->dwLength - gsDmacopy.dwOffset;
+    if (gsDmacopy.dwChunk > DMACOPY_MAX_BYTES)
+    {
+        gsDmacopy.dwChunk = DMACOPY_MAX_BYTES;
+    }
+
+    // 1) The source is the "peripheral" port, a fill reads the same pattern word over and over
+    if (psRequest->pbSrc != NULL)
+    {
+        gsDmacopy.sDMAHandle.Init.PeriphInc = DMA_PINC_ENABLE;
+        dwSrc                               = (uintptr_t)&psRequest->pbSrc[gsDmacopy.dwOffset];
+    }
+    else
+    {
+        gsDmacopy.sDMAHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+        dwSrc                               = (uintptr_t)&psRequest->dwPattern;
+    }
+#ifndef NHNS_HOST
+    // HAL_DMA_Start_IT only loads the addresses and the count
+    MODIFY_REG(gsDmacopy.sDMAHandle.Instance->CR, DMA_SxCR_PINC, gsDmacopy.sDMAHandle.Init.PeriphInc);
+#endif
+
+    // 2) Words from here on
+    return HAL_DMA_Start_IT(&gsDmacopy.sDMAHandle, dwSrc, (uintptr_t)&psRequest->pbDst[gsDmacopy.dwOffset],
+                            gsDmacopy.dwChunk / sizeof(uint32_t));
+}
+
+/**
+ * @brief Start queued requests until one is under way, or leave the stream idle
+ * @param pxWoken - Set when a task waiting to queue should run
+ * @note Called from the interrupt. A request that fails to start is reported at once
+ */
+static void DMACOPY_Next(BaseType_t *pxWoken)
+{
+    while (xQueueReceiveFromISR(gsDmacopy.xQueue, &gsDmacopy.sActive, pxWoken) == pdPASS)
+    {
+        gsDmacopy.dwOffset = 0;
+        if (DMACOPY_Transfer() == HAL_OK)
+        {
+            return;
+        }
+
+        gsDmacopy.sStats.dwErrors++;
+        if (gsDmacopy.sActive.pfnDone != NULL)
+        {
+            gsDmacopy.sActive.pfnDone(gsDmacopy.sActive.pvContext, NHNS_STATUS_FAIL);
+        }
+    }
+
+    gsDmacopy.fBusy = false;
+    LOWPOWER_Unlock();
+}
+
+/**
+ * @brief End the active request, start the next and report the first
+ * @param nStatus - Outcome of the request
+ */
+static void DMACOPY_Finish(nhns_status_t nStatus)
+{
+    dmacopy_request_t sDone = gsDmacopy.sActive;
+    BaseType_t xWoken       = pdFALSE;
+
+    if (nStatus == NHNS_STATUS_OK)
+    {
+        gsDmacopy.sStats.dwDmaRequests++;
+        gsDmacopy.sStats.dwDmaBytes += sDone.dwLength;
+    }
+    else
+    {
+        gsDmacopy.sStats.dwErrors++;
+    }
+
+    // 1) The stream moves on while the callback runs
+    DMACOPY_Next(&xWoken);
+
+    // 2) Then the owner hears about its request
+    if (sDone.pfnDone != NULL)
+    {
+        sDone.pfnDone(sDone.pvContext, nStatus);
+    }
+    portYIELD_FROM_ISR(xWoken);
+}
+
+/**
+ * @brief Transfer complete, go on with the request or finish it
+ * @param hdma - DMA handle pointer
+ */
+static void DMACOPY_DMACpltCallback(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+
+    gsDmacopy.dwOffset += gsDmacopy.dwChunk;
+    if (gsDmacopy.dwOffset < gsDmacopy.sActive.dwLength)
+    {
+        if (DMACOPY_Transfer() != HAL_OK)
+        {
+            DMACOPY_Finish(NHNS_STATUS_FAIL);
+        }
+        return;
+    }
+    DMACOPY_Finish(NHNS_STATUS_OK);
+}
+
+/**
+ * @brief Bus error, the HAL has stopped the stream
+ * @param hdma - DMA handle pointer
+ * @note FIFO and direct mode errors are reported here too but the transfer goes on, they are ignored
+ */
+static void DMACOPY_DMAErrorCallback(DMA_HandleTypeDef *hdma)
+{
+    if ((hdma->ErrorCode & HAL_DMA_ERROR_TE) != 0)
+    {
+        DMACOPY_Finish(NHNS_STATUS_FAIL);
+    }
+}
+
+/**
+ * @brief Wake a task sleeping in DMACOPY_Run
+ * @param pvContext - The completion it waits on
+ * @param nStatus - Outcome of the request
+ */
+static void DMACOPY_Wake(void *pvContext, nhns_status_t nStatus)
+{
+    COMPLETION_Signal(pvContext, nStatus);
+}
+
+/**
+ * @brief Hand the aligned words of a request to the stream, or do it all with the CPU
+ * @param pbDst - Destination
+ * @param pbSrc - Source, NULL to fill
+ * @param bValue - Fill value
+ * @param dwLength - Number of bytes
+ * @param pfnDone - Called from the interrupt once the stream is done
+ * @param pvContext - Passed to pfnDone
+ * @param dwThreshold - Fewest bytes worth the stream
+ * @param pfQueued - Returns true when pfnDone will be called, false when the CPU already did the work
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BUSY with the queue full, the unaligned ends may be written already
+ */
+static nhns_status_t DMACOPY_Start(uint8_t *pbDst, const uint8_t *pbSrc, uint8_t bValue, uint32_t dwLength,
+                                   dmacopy_callback_t pfnDone, void *pvContext, uint32_t dwThreshold, bool *pfQueued)
+{
+    dmacopy_request_t sRequest = {0};
+    uint32_t dwHead            = (uint32_t)(0U - (uintptr_t)pbDst) & 3U;
+    uint32_t dwTail            = 0;
+    nhns_status_t nRet         = NHNS_STATUS_OK;
+
+    *pfQueued = false;
+
+    // 1) Short, aligned unalike or no scheduler to sleep on: the CPU does it all
+    if (dwLength < dwThreshold || dwLength < dwHead + sizeof(uint32_t) ||
+        (pbSrc != NULL && (((uintptr_t)pbDst ^ (uintptr_t)pbSrc) & 3U) != 0) ||
+        xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        DMACOPY_Cpu(pbDst, pbSrc, bValue, dwLength);
+        taskENTER_CRITICAL();
+        gsDmacopy.sStats.dwCpuRequests++;
+        gsDmacopy.sStats.dwCpuBytes += dwLength;
+        taskEXIT_CRITICAL();
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) The CPU does the unaligned ends before the stream can report the request done
+    dwTail = (dwLength - dwHead) & 3U;
+    DMACOPY_Cpu(pbDst, pbSrc, bValue, dwHead);
+    DMACOPY_Cpu(&pbDst[dwLength - dwTail], (pbSrc != NULL) ? &pbSrc[dwLength - dwTail] : NULL, bValue, dwTail);
+
+    sRequest.pbDst     = &pbDst[dwHead];
+    sRequest.pbSrc     = (pbSrc != NULL) ? &pbSrc[dwHead] : NULL;
+    sRequest.dwLength  = dwLength - dwHead - dwTail;
+    sRequest.dwPattern = bValue * 0x01010101U;
+    sRequest.pfnDone   = pfnDone;
+    sRequest.pvContext = pvContext;
+
+    // 3) Straight to an idle stream, otherwise behind the others
+    taskENTER_CRITICAL();
+    if (!gsDmacopy.fBusy)
+    {
+        gsDmacopy.fBusy    = true;
+        gsDmacopy.sActive  = sRequest;
+        gsDmacopy.dwOffset = 0;
+        LOWPOWER_Lock();
+        if (DMACOPY_Transfer() != HAL_OK)
+        {
+            gsDmacopy.fBusy = false;
+            LOWPOWER_Unlock();
+            gsDmacopy.sStats.dwErrors++;
+            nRet = NHNS_STATUS_FAIL;
+        }
+    }
+    else if (xQueueSendToBack(gsDmacopy.xQueue, &sRequest, 0) != pdPASS)
+    {
+        gsDmacopy.sStats.dwRefused++;
+        nRet = NHNS_STATUS_BUSY;
+    }
+    else if (uxQueueMessagesWaiting(gsDmacopy.xQueue) > gsDmacopy.sStats.dwMaxQueued)
+    {
+        gsDmacopy.sStats.dwMaxQueued = uxQueueMessagesWaiting(gsDmacopy.xQueue);
+    }
+    taskEXIT_CRITICAL();
+
+    *pfQueued = (nRet == NHNS_STATUS_OK);
+
+    return nRet;
+}
+
+/**
+ * @brief Copy or fill and sleep until it is done
+ * @param pvDst - Destination
+ * @param pvSrc - Source, NULL to fill
+ * @param bValue - Fill value
+ * @param dwLength - Number of bytes
+ * @param dwThreshold - Fewest bytes worth the stream
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t DMACOPY_Run(void *pvDst, const void *pvSrc, uint8_t bValue, uint32_t dwLength,
+                                 uint32_t dwThreshold)
+{
+    completion_t sDone = {0};
+    bool fQueued       = false;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Nobody to wake before the scheduler runs, DMACOPY_Start does it all with the CPU then
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return DMACOPY_Start(pvDst, pvSrc, bValue, dwLength, NULL, NULL, dwThreshold, &fQueued);
+    }
+
+    // 2) Armed before the request goes in, the stream may finish before DMACOPY_Start returns
+    nRet = COMPLETION_Arm(&sDone);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+    nRet = DMACOPY_Start(pvDst, pvSrc, bValue, dwLength, DMACOPY_Wake, &sDone, dwThreshold, &fQueued);
+
+    // 3) A full queue would keep the caller longer than doing it here
+    if (nRet == NHNS_STATUS_BUSY)
+    {
+        COMPLETION_Cancel(&sDone);
+        DMACOPY_Cpu(pvDst, pvSrc, bValue, dwLength);
+        return NHNS_STATUS_OK;
+    }
+    if (nRet != NHNS_STATUS_OK || !fQueued)
+    {
+        COMPLETION_Cancel(&sDone);
+        return nRet;
+    }
+
+    // 4) Sleep until the stream interrupt reports the request done
+    return COMPLETION_Wait(&sDone, COMPLETION_WAIT_FOREVER);
+}
+
+// --- Functions ---
+
+nhns_status_t DMACOPY_Init(void)
+{
+    // 1) Check if module is already initialized
+    if (gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    gsDmacopy.xQueue = RTOS_QUEUE_CREATE(dmacopy);
+
+    // 2) Memory to memory in words, through the FIFO with single beats so any word address works
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    gsDmacopy.sDMAHandle.Instance                 = DMACOPY_DMA_STREAM;
+    gsDmacopy.sDMAHandle.Init.Channel             = DMACOPY_DMA_CHANNEL;
+    gsDmacopy.sDMAHandle.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+    gsDmacopy.sDMAHandle.Init.PeriphInc           = DMA_PINC_ENABLE;
+    gsDmacopy.sDMAHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    gsDmacopy.sDMAHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    gsDmacopy.sDMAHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    gsDmacopy.sDMAHandle.Init.Mode                = DMA_NORMAL;
+    gsDmacopy.sDMAHandle.Init.Priority            = DMA_PRIORITY_LOW;
+    gsDmacopy.sDMAHandle.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;
+    gsDmacopy.sDMAHandle.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+    gsDmacopy.sDMAHandle.Init.MemBurst            = DMA_MBURST_SINGLE;
+    gsDmacopy.sDMAHandle.Init.PeriphBurst         = DMA_PBURST_SINGLE;
+    if (HAL_DMA_Init(&gsDmacopy.sDMAHandle) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+    gsDmacopy.sDMAHandle.XferCpltCallback  = DMACOPY_DMACpltCallback;
+    gsDmacopy.sDMAHandle.XferErrorCallback = DMACOPY_DMAErrorCallback;
+
+    // 3) The completion interrupt starts the queued requests
+    HAL_NVIC_SetPriority(DMACOPY_DMA_IRQn, DMACOPY_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMACOPY_DMA_IRQn);
+
+    gsDmacopy.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DMACOPY_Copy(void *pvDst, const void *pvSrc, uint32_t dwLength)
+{
+    // 1) Verify arguments
+    if ((pvDst == NULL || pvSrc == NULL) && dwLength != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    return DMACOPY_Run(pvDst, pvSrc, 0, dwLength, DMACOPY_THRESHOLD);
+}
+
+nhns_status_t DMACOPY_Fill(void *pvDst, uint8_t bValue, uint32_t dwLength)
+{
+    // 1) Verify arguments
+    if (pvDst == NULL && dwLength != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    return DMACOPY_Run(pvDst, NULL, bValue, dwLength, DMACOPY_THRESHOLD);
+}
+
+nhns_status_t DMACOPY_CopyAsync(void *pvDst, const void *pvSrc, uint32_t dwLength, dmacopy_callback_t pfnDone,
+                                void *pvContext)
+{
+    bool fQueued       = false;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if ((pvDst == NULL || pvSrc == NULL) && dwLength != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Queue it, or report now what the CPU did
+    nRet = DMACOPY_Start(pvDst, pvSrc, 0, dwLength, pfnDone, pvContext, DMACOPY_THRESHOLD, &fQueued);
+    if (nRet == NHNS_STATUS_OK && !fQueued && pfnDone != NULL)
+    {
+        pfnDone(pvContext, NHNS_STATUS_OK);
+    }
+
+    return nRet;
+}
+
+nhns_status_t DMACOPY_FillAsync(void *pvDst, uint8_t bValue, uint32_t dwLength, dmacopy_callback_t pfnDone,
+                                void *pvContext)
+{
+    bool fQueued       = false;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (pvDst == NULL && dwLength != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Queue it, or report now what the CPU did
+    nRet = DMACOPY_Start(pvDst, NULL, bValue, dwLength, pfnDone, pvContext, DMACOPY_THRESHOLD, &fQueued);
+    if (nRet == NHNS_STATUS_OK && !fQueued && pfnDone != NULL)
+    {
+        pfnDone(pvContext, NHNS_STATUS_OK);
+    }
+
+    return nRet;
+}
+
+nhns_status_t DMACOPY_GetStats(dmacopy_stats_t *psStats)
+{
+    // 1) Verify arguments
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) The interrupt updates the counters too
+    taskENTER_CRITICAL();
+    *psStats = gsDmacopy.sStats;
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DMACOPY_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    dmacopy_stats_t sStats;
+    char szLine[DMACOPY_LINE_SIZE];
+    int nLength = 0;
+
+    nRet = DMACOPY_GetStats(&sStats);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine), "dmacopy: %lu requests %lu bytes by the stream, %lu requests %lu bytes by the CPU\r\n",
+                       (unsigned long)sStats.dwDmaRequests, (unsigned long)sStats.dwDmaBytes,
+                       (unsigned long)sStats.dwCpuRequests, (unsigned long)sStats.dwCpuBytes);
+    nRet    = UART_PrintLine(nID, szLine, nLength, DMACOPY_LINE_SIZE);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "%lu refused, %lu errors, queue depth %lu of %u, stream %s\r\n",
+                           (unsigned long)sStats.dwRefused, (unsigned long)sStats.dwErrors,
+                           (unsigned long)sStats.dwMaxQueued, DMACOPY_QUEUE_LENGTH, gsDmacopy.fBusy ? "busy" : "idle");
+        nRet    = UART_PrintLine(nID, szLine, nLength, DMACOPY_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t DMACOPY_Benchmark(uart_instance_t nID)
+{
+    uint8_t *pbSrc       = NULL;
+    uint8_t *pbDst       = NULL;
+    uint32_t dwCpu       = 0;
+    uint32_t dwDma       = 0;
+    uint32_t dwStart     = 0;
+    uint32_t dwCrossover = 0;
+    uint64_t qwHz        = PROFILER_GetCyclesPerSecond();
+    nhns_status_t nRet   = NHNS_STATUS_OK;
+    char szLine[DMACOPY_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Check if module is initialized
+    if (!gsDmacopy.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 2) SRAM1 to SRAM2, the way received data moves into DMA buffers
+    pbSrc = HEAP_Alloc(DMACOPY_BENCH_MAX, HEAP_REGION_DEFAULT);
+    pbDst = HEAP_Alloc(DMACOPY_BENCH_MAX, HEAP_REGION_DMA);
+    if (pbSrc == NULL || pbDst == NULL)
+    {
+        HEAP_Free(pbSrc);
+        HEAP_Free(pbDst);
+        return NHNS_STATUS_NO_MEMORY;
+    }
+    for (uint32_t dwIndex = 0; dwIndex < DMACOPY_BENCH_MAX; dwIndex++)
+    {
+        pbSrc[dwIndex] = (uint8_t)(dwIndex * 7 + 1);
+    }
+
+    // 3) Average of a few rounds per size, the stream timed from the request to the wake-up of the caller
+    for (uint32_t dwSize = DMACOPY_BENCH_MIN; dwSize <= DMACOPY_BENCH_MAX && nRet == NHNS_STATUS_OK; dwSize *= 2)
+    {
+        dwStart = PROFILER_GetCycles();
+        for (uint32_t dwRound = 0; dwRound < DMACOPY_BENCH_ROUNDS; dwRound++)
+        {
+            memcpy(pbDst, pbSrc, dwSize);
+        }
+        dwCpu = (PROFILER_GetCycles() - dwStart) / DMACOPY_BENCH_ROUNDS;
+
+        memset(pbDst, 0, dwSize);
+        dwStart = PROFILER_GetCycles();
+        for (uint32_t dwRound = 0; dwRound < DMACOPY_BENCH_ROUNDS && nRet == NHNS_STATUS_OK; dwRound++)
+        {
+            nRet = DMACOPY_Run(pbDst, pbSrc, 0, dwSize, 0);
+        }
+        dwDma = (PROFILER_GetCycles() - dwStart) / DMACOPY_BENCH_ROUNDS;
+        if (nRet == NHNS_STATUS_OK && memcmp(pbDst, pbSrc, dwSize) != 0)
+        {
+            nRet = NHNS_STATUS_DATA_MISMATCH;
+        }
+        if (dwCrossover == 0 && dwDma < dwCpu)
+        {
+            dwCrossover = dwSize;
+        }
+
+        nLength = snprintf(szLine, sizeof(szLine), "dmacopy %5lu bytes: cpu %7lu cycles %6lu KB/s, dma %7lu cycles %6lu KB/s\r\n",
+                           (unsigned long)dwSize, (unsigned long)dwCpu,
+                           (unsigned long)((dwCpu != 0) ? dwSize * qwHz / dwCpu / 1024 : 0), (unsigned long)dwDma,
+                           (unsigned long)((dwDma != 0) ? dwSize * qwHz / dwDma / 1024 : 0));
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = UART_PrintLine(nID, szLine, nLength, DMACOPY_LINE_SIZE);
+        }
+    }
+
+    // 4) Where the stream starts to pay, against the compiled-in threshold
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = (dwCrossover != 0)
+                      ? snprintf(szLine, sizeof(szLine), "dmacopy: the stream wins from %lu bytes, DMACOPY_THRESHOLD is %u\r\n",
+                                 (unsigned long)dwCrossover, DMACOPY_THRESHOLD)
+                      : snprintf(szLine, sizeof(szLine), "dmacopy: memcpy wins up to %u bytes, DMACOPY_THRESHOLD is %u\r\n",
+                                 DMACOPY_BENCH_MAX, DMACOPY_THRESHOLD);
+        nRet = UART_PrintLine(nID, szLine, nLength, DMACOPY_LINE_SIZE);
+    }
+
+    HEAP_Free(pbSrc);
+    HEAP_Free(pbDst);
+
+    return nRet;
+}
+
+void DMACOPY_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&gsDmacopy.sDMAHandle);
+}
@@ -0,0 +1,128 @@
+#ifndef __DMACOPY_H__
+#define __DMACOPY_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Copy and fill engine on a DMA2 stream in memory-to-memory mode. Requests
+ * wait in a queue and the completion interrupt starts the next one, so the
+ * stream runs back to back without a task in the loop. The stream moves
+ * 32-bit words between SRAM1, SRAM2 and the flash; the CPU does the unaligned
+ * head and tail bytes before the request is queued.
+ *
+ * Requests shorter than DMACOPY_THRESHOLD, copies whose source and destination
+ * are not aligned alike, and everything before the scheduler starts are done
+ * with memcpy/memset right away, and complete before the call returns. Those
+ * are not ordered against requests still in the queue.
+ */
+
+#define DMACOPY_THRESHOLD    256    // Bytes, below this memcpy is faster, see DMACOPY_Benchmark
+#define DMACOPY_QUEUE_LENGTH 8
+
+// --- Types ---
+
+/**
+ * @brief Completion of an asynchronous request
+ * @param pvContext - Context given with the request
+ * @param nStatus - NHNS_STATUS_OK, or the failure of the transfer
+ * @note Runs in the DMA interrupt, or in the caller when the CPU did the work
+ */
+typedef void (*dmacopy_callback_t)(void *pvContext, nhns_status_t nStatus);
+
+typedef struct dmacopy_stats
+{
+    uint32_t dwDmaRequests;    // Requests moved by the stream
+    uint32_t dwDmaBytes;
+    uint32_t dwCpuRequests;    // Requests done with memcpy or memset
+    uint32_t dwCpuBytes;
+    uint32_t dwRefused;        // Asynchronous requests turned away with a full queue
+    uint32_t dwErrors;         // Transfers that failed to start or ended in a bus error
+    uint32_t dwMaxQueued;      // Deepest the queue has been
+} dmacopy_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Create the request queue and configure the stream
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DMACOPY_Init(void);
+
+/**
+ * @brief Copy bytes, the calling task sleeps until the stream is done
+ * @param pvDst - Destination
+ * @param pvSrc - Source, must not overlap pvDst
+ * @param dwLength - Number of bytes
+ * @retval Status code indicating operation success or reason for failure
+ * @note Waits on the task notification of the caller. With a full queue the CPU does the copy
+ */
+nhns_status_t DMACOPY_Copy(void *pvDst, const void *pvSrc, uint32_t dwLength);
+
+/**
+ * @brief Set bytes to a value, the calling task sleeps until the stream is done
+ * @param pvDst - Destination
+ * @param bValue - Value of every byte
+ * @param dwLength - Number of bytes
+ * @retval Status code indicating operation success or reason for failure
+ * @note As DMACOPY_Copy
+ */
+nhns_status_t DMACOPY_Fill(void *pvDst, uint8_t bValue, uint32_t dwLength);
+
+/**
+ * @brief Queue a copy and return at once
+ * @param pvDst - Destination, left alone by the caller until completion
+ * @param pvSrc - Source, left unchanged until completion
+ * @param dwLength - Number of bytes
+ * @param pfnDone - Called on completion, may be NULL
+ * @param pvContext - Passed to pfnDone
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BUSY with the queue full, nothing is copied and pfnDone is not called
+ */
+nhns_status_t DMACOPY_CopyAsync(void *pvDst, const void *pvSrc, uint32_t dwLength, dmacopy_callback_t pfnDone,
+                                void *pvContext);
+
+/**
+ * @brief Queue a fill and return at once
+ * @param pvDst - Destination, left alone by the caller until completion
+ * @param bValue - Value of every byte
+ * @param dwLength - Number of bytes
+ * @param pfnDone - Called on completion, may be NULL
+ * @param pvContext - Passed to pfnDone
+ * @retval Status code indicating operation success or reason for failure
+ * @note As DMACOPY_CopyAsync
+ */
+nhns_status_t DMACOPY_FillAsync(void *pvDst, uint8_t bValue, uint32_t dwLength, dmacopy_callback_t pfnDone,
+                                void *pvContext);
+
+/**
+ * @brief Get the engine counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DMACOPY_GetStats(dmacopy_stats_t *psStats);
+
+/**
+ * @brief Print the engine counters
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DMACOPY_Dump(uart_instance_t nID);
+
+/**
+ * @brief Time memcpy against the stream from 16 bytes to 8K, print the throughput of both and the crossover size
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a copy by the stream reads back wrong
+ */
+nhns_status_t DMACOPY_Benchmark(uart_instance_t nID);
+
+/**
+ * @brief DMA2 stream interrupt, call from DMACOPY_DMA_IRQn
+ */
+void DMACOPY_IRQHandler(void);
+
+#endif    // __DMACOPY_H__
@@ -0,0 +1,561 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "emac.h"
+#include "board.h"
+#include "clock.h"
+#include "heap.h"
+#include "lowpower.h"
+#include "profiler.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define EMAC_LINE_SIZE 128
+
+#define EMAC_CHECK_HAL_RETURN(nHALRet)               \
+    do                                               \
+    {                                                \
+        if (nHALRet != HAL_OK)                       \
+        {                                            \
+            return (NHNS_STATUS_BASE_STM + nHALRet); \
+        }                                            \
+    } while (0)
+
+_Static_assert(ETH_RX_BUF_SIZE <= 1536, "EMAC_POOL blocks must hold a whole RX buffer");
+
+// --- Types ---
+
+typedef struct emac_context
+{
+    bool fInitDone;
+    ETH_HandleTypeDef sETHHandle;
+
+    // Descriptors the DMA has not given back yet are reclaimed from dwTxTail, new frames go to dwTxHead
+    uint32_t dwTxHead;
+    uint32_t dwTxTail;
+    uint32_t dwTxFree;
+    uint32_t dwTxStatus;
+    void *apvTxBlocks[ETH_TXBUFNB];
+
+    QueueHandle_t xRxQueue;
+
+    emac_stats_t sStats;
+
+    // Counters at the previous EMAC_Dump, for the rates
+    uint64_t qwDumpTime;
+    uint32_t dwDumpRxFrames;
+    uint32_t dwDumpRxBytes;
+    uint32_t dwDumpTxFrames;
+    uint32_t dwDumpTxBytes;
+} emac_context_t;
+
+// --- Global Variables ---
+
+static emac_context_t gsEmac = {0};
+
+static uint8_t gabMacAddress[6] = {MAC_ADDR0, MAC_ADDR1, MAC_ADDR2, MAC_ADDR3, MAC_ADDR4, MAC_ADDR5};
+
+// The descriptors are rewritten at every start, SRAM2 keeps the DMA off the CPU's port
+static ETH_DMADescTypeDef gasRxDesc[ETH_RXBUFNB] HEAP_DMA_BUFFER;
+static ETH_DMADescTypeDef gasTxDesc[ETH_TXBUFNB] HEAP_DMA_BUFFER;
+
+RTOS_QUEUE_DEFINE(emac_rx, EMAC_RX_QUEUE_LENGTH, sizeof(emac_frame_t));
+
+// --- Static Functions ---
+
+/**
+ * @brief Give the descriptors of a dropped frame back to the DMA with their buffers
+ * @param psDesc - First descriptor of the frame
+ * @param dwSegments - Number of descriptors the frame spans
+ */
+static void EMAC_RecycleRx(ETH_DMADescTypeDef *psDesc, uint32_t dwSegments)
+{
+    for (uint32_t dwSegment = 0; dwSegment < dwSegments; dwSegment++)
+    {
+        psDesc->Status = ETH_DMARXDESC_OWN;
+        psDesc         = (ETH_DMADescTypeDef *)psDesc->Buffer2NextDescAddr;
+    }
+}
+
+/**
+ * @brief Resume a DMA engine that suspended on a descriptor it did not own
+ * @param dwFlag - ETH_DMA_FLAG_RBU or ETH_DMA_FLAG_TBU
+ */
+static void EMAC_ResumeDMA(uint32_t dwFlag)
+{
+    if (!__HAL_ETH_DMA_GET_FLAG(&gsEmac.sETHHandle, dwFlag))
+    {
+        return;
+    }
+
+    // Any write to the poll demand register restarts the descriptor fetch
+    __HAL_ETH_DMA_CLEAR_IT(&gsEmac.sETHHandle, dwFlag);
+    if (dwFlag == ETH_DMA_FLAG_RBU)
+    {
+        gsEmac.sETHHandle.Instance->DMARPDR = 0;
+    }
+    else
+    {
+        gsEmac.sETHHandle.Instance->DMATPDR = 0;
+    }
+}
+
+/**
+ * @brief Free the blocks of every descriptor the DMA has finished with
+ * @note Runs in the ETH interrupt, or with it masked
+ */
+static void EMAC_ReclaimTx(void)
+{
+    ETH_DMADescTypeDef *psDesc = NULL;
+
+    while (gsEmac.dwTxFree < ETH_TXBUFNB)
+    {
+        psDesc = &gasTxDesc[gsEmac.dwTxTail];
+        if ((psDesc->Status & ETH_DMATXDESC_OWN) != 0)
+        {
+            break;
+        }
+
+        // The MAC writes the frame status back to the last descriptor
+        if ((psDesc->Status & ETH_DMATXDESC_LS) != 0)
+        {
+            if ((psDesc->Status & ETH_DMATXDESC_ES) != 0)
+            {
+                gsEmac.sStats.dwTxErrors++;
+            }
+            else
+            {
+                gsEmac.sStats.dwTxFrames++;
+            }
+        }
+
+        POOL_Free(gsEmac.apvTxBlocks[gsEmac.dwTxTail]);
+        gsEmac.apvTxBlocks[gsEmac.dwTxTail] = NULL;
+        gsEmac.dwTxTail                     = (gsEmac.dwTxTail + 1) % ETH_TXBUFNB;
+        gsEmac.dwTxFree++;
+    }
+}
+
+/**
+ * @brief Return every block held by the rings and the RX queue to the pool
+ */
+static void EMAC_ReleaseBuffers(void)
+{
+    emac_frame_t sFrame;
+
+    for (uint32_t dwIndex = 0; dwIndex < ETH_RXBUFNB; dwIndex++)
+    {
+        POOL_Free((void *)gasRxDesc[dwIndex].Buffer1Addr);
+        gasRxDesc[dwIndex].Buffer1Addr = 0;
+    }
+
+    for (uint32_t dwIndex = 0; dwIndex < ETH_TXBUFNB; dwIndex++)
+    {
+        POOL_Free(gsEmac.apvTxBlocks[dwIndex]);
+        gsEmac.apvTxBlocks[dwIndex] = NULL;
+    }
+
+    while (gsEmac.xRxQueue != NULL && xQueueReceive(gsEmac.xRxQueue, &sFrame, 0) == pdTRUE)
+    {
+        EMAC_Release(sFrame.pbData);
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t EMAC_Init(void)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+    void *pvBlock             = NULL;
+
+    // 1) Check if module has been previously initialized
+    if (gsEmac.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Configure the MAC, the HAL resets the PHY and waits for the link
+    gsEmac.sETHHandle.Instance             = ETH;
+    gsEmac.sETHHandle.Init.AutoNegotiation = ETH_AUTONEGOTIATION_ENABLE;
+    gsEmac.sETHHandle.Init.Speed           = ETH_SPEED_100M;
+    gsEmac.sETHHandle.Init.DuplexMode      = ETH_MODE_FULLDUPLEX;
+    gsEmac.sETHHandle.Init.PhyAddress      = EMAC_PHY_ADDRESS;
+    gsEmac.sETHHandle.Init.MACAddr         = gabMacAddress;
+    gsEmac.sETHHandle.Init.RxMode          = ETH_RXINTERRUPT_MODE;
+    gsEmac.sETHHandle.Init.ChecksumMode    = ETH_CHECKSUM_BY_HARDWARE;
+    gsEmac.sETHHandle.Init.MediaInterface  = ETH_MEDIA_INTERFACE_RMII;
+
+    nHalRet = HAL_ETH_Init(&gsEmac.sETHHandle);
+    if (nHalRet != HAL_OK)
+    {
+        HAL_ETH_DeInit(&gsEmac.sETHHandle);
+        return (nHalRet == HAL_TIMEOUT) ? NHNS_STATUS_TIMEOUT : (NHNS_STATUS_BASE_STM + nHalRet);
+    }
+
+    // 3) Chain the descriptors, buffer addresses are filled in below and per TX frame
+    HAL_ETH_DMATxDescListInit(&gsEmac.sETHHandle, gasTxDesc, NULL, ETH_TXBUFNB);
+    HAL_ETH_DMARxDescListInit(&gsEmac.sETHHandle, gasRxDesc, NULL, ETH_RXBUFNB);
+    gsEmac.dwTxHead   = 0;
+    gsEmac.dwTxTail   = 0;
+    gsEmac.dwTxFree   = ETH_TXBUFNB;
+    gsEmac.dwTxStatus = gasTxDesc[0].Status;
+
+    // 4) Every RX descriptor gets a pool block, the ring is the only place buffers wait for the DMA
+    for (uint32_t dwIndex = 0; dwIndex < ETH_RXBUFNB; dwIndex++)
+    {
+        gasRxDesc[dwIndex].Buffer1Addr = 0;
+    }
+    for (uint32_t dwIndex = 0; dwIndex < ETH_RXBUFNB; dwIndex++)
+    {
+        pvBlock = POOL_AllocFrom(EMAC_POOL);
+        if (pvBlock == NULL)
+        {
+            EMAC_ReleaseBuffers();
+            HAL_ETH_DeInit(&gsEmac.sETHHandle);
+            return NHNS_STATUS_NO_MEMORY;
+        }
+        gasRxDesc[dwIndex].Buffer1Addr = (uintptr_t)pvBlock;
+    }
+
+    if (gsEmac.xRxQueue == NULL)
+    {
+        gsEmac.xRxQueue = RTOS_QUEUE_CREATE(emac_rx);
+    }
+
+    // 5) Completed transmissions interrupt too, so their blocks return to the pool promptly
+    __HAL_ETH_DMA_ENABLE_IT(&gsEmac.sETHHandle, ETH_DMA_IT_T);
+
+    // 6) Start the MAC and DMA, frames can arrive at any time from now on so STOP is kept off
+    nHalRet = HAL_ETH_Start(&gsEmac.sETHHandle);
+    if (nHalRet != HAL_OK)
+    {
+        EMAC_ReleaseBuffers();
+        HAL_ETH_DeInit(&gsEmac.sETHHandle);
+        EMAC_CHECK_HAL_RETURN(nHalRet);
+    }
+    LOWPOWER_Lock();
+
+    // 7) Mark as initialized
+    gsEmac.qwDumpTime = CLOCK_GetMicros();
+    gsEmac.fInitDone  = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t EMAC_DeInit(void)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    // 1) Check if already deinitialized
+    if (!gsEmac.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Stop the MAC and DMA before their buffers go away
+    gsEmac.fInitDone = false;
+    HAL_ETH_Stop(&gsEmac.sETHHandle);
+    HAL_NVIC_DisableIRQ(EMAC_IRQn);
+    EMAC_ReleaseBuffers();
+    gsEmac.dwTxFree = ETH_TXBUFNB;
+    LOWPOWER_Unlock();
+
+    // 3) Deinitialize the peripheral
+    nHalRet = HAL_ETH_DeInit(&gsEmac.sETHHandle);
+    EMAC_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t EMAC_Receive(emac_frame_t *psFrame, uint32_t dwTimeoutMs)
+{
+    TickType_t xTimeout = (dwTimeoutMs == EMAC_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(dwTimeoutMs);
+
+    // 1) Verify argument
+    if (psFrame == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) The queue outlives EMAC_DeInit, a receiver blocked on it simply keeps waiting
+    if (gsEmac.xRxQueue == NULL)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Wait for a frame
+    if (xQueueReceive(gsEmac.xRxQueue, psFrame, xTimeout) != pdTRUE)
+    {
+        return NHNS_STATUS_TIMEOUT;
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t EMAC_Release(uint8_t *pbData)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    if (pbData == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    nRet = POOL_Free(pbData);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        __atomic_sub_fetch(&gsEmac.sStats.dwRxLoaned, 1, __ATOMIC_RELAXED);
+    }
+
+    return nRet;
+}
+
+nhns_status_t EMAC_Transmit(const emac_segment_t *pasSegments, uint32_t dwCount)
+{
+    ETH_DMADescTypeDef *psFirst = NULL;
+    ETH_DMADescTypeDef *psDesc  = NULL;
+    uint32_t dwIndex            = 0;
+    uint32_t dwLength           = 0;
+    uint32_t dwStatus           = 0;
+
+    PROFILER_SCOPE(PROFILER_PROBE_EMAC_TX);
+
+    // 1) Verify arguments
+    if (pasSegments == NULL || dwCount == 0 || dwCount > ETH_TXBUFNB)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    for (uint32_t dwSegment = 0; dwSegment < dwCount; dwSegment++)
+    {
+        if (pasSegments[dwSegment].pvBlock == NULL || pasSegments[dwSegment].wLength == 0)
+        {
+            return NHNS_STATUS_INVALID_ARGUMENT;
+        }
+        dwLength += pasSegments[dwSegment].wLength;
+    }
+    if (dwLength > ETH_MAX_PACKET_SIZE)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsEmac.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) The ETH interrupt reclaims descriptors, keep it out while the ring is updated
+    taskENTER_CRITICAL();
+    EMAC_ReclaimTx();
+    if (gsEmac.dwTxFree < dwCount)
+    {
+        gsEmac.sStats.dwTxBusy++;
+        taskEXIT_CRITICAL();
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 4) Point one descriptor at each segment, all but the first are handed over right away
+    dwIndex = gsEmac.dwTxHead;
+    psFirst = &gasTxDesc[dwIndex];
+    for (uint32_t dwSegment = 0; dwSegment < dwCount; dwSegment++)
+    {
+        psDesc                      = &gasTxDesc[dwIndex];
+        gsEmac.apvTxBlocks[dwIndex] = pasSegments[dwSegment].pvBlock;
+
+        psDesc->Buffer1Addr       = (uintptr_t)pasSegments[dwSegment].pvBlock + pasSegments[dwSegment].wOffset;
+        psDesc->ControlBufferSize = pasSegments[dwSegment].wLength & ETH_DMATXDESC_TBS1;
+
+        dwStatus = gsEmac.dwTxStatus;
+        if (dwSegment == 0)
+        {
+            dwStatus |= ETH_DMATXDESC_FS;
+        }
+        else
+        {
+            dwStatus |= ETH_DMATXDESC_OWN;
+        }
+        if (dwSegment == dwCount - 1)
+        {
+            dwStatus |= ETH_DMATXDESC_LS | ETH_DMATXDESC_IC;
+        }
+        psDesc->Status = dwStatus;
+
+        dwIndex = (dwIndex + 1) % ETH_TXBUFNB;
+    }
+
+    // 5) Owning the first descriptor releases the whole chain to the DMA
+    __DSB();
+    psFirst->Status |= ETH_DMATXDESC_OWN;
+    gsEmac.dwTxHead = dwIndex;
+    gsEmac.dwTxFree -= dwCount;
+    gsEmac.sStats.dwTxBytes += dwLength;
+    EMAC_ResumeDMA(ETH_DMA_FLAG_TBU);
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+const uint8_t *EMAC_GetMacAddress(void)
+{
+    return gabMacAddress;
+}
+
+nhns_status_t EMAC_GetStats(emac_stats_t *psStats)
+{
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Counters are read one by one, each is exact but they may be from different moments
+    *psStats = gsEmac.sStats;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t EMAC_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    emac_stats_t sStats;
+    uint64_t qwNow       = CLOCK_GetMicros();
+    uint32_t dwElapsedMs = (uint32_t)((qwNow - gsEmac.qwDumpTime) / 1000);
+    uint32_t dwRxRate    = 0;
+    uint32_t dwRxKBps    = 0;
+    uint32_t dwTxRate    = 0;
+    uint32_t dwTxKBps    = 0;
+    char szLine[EMAC_LINE_SIZE];
+    int nLength = 0;
+
+    EMAC_GetStats(&sStats);
+
+    // 1) Rates since the previous dump
+    if (dwElapsedMs != 0)
+    {
+        dwRxRate = (uint32_t)(((uint64_t)(sStats.dwRxFrames - gsEmac.dwDumpRxFrames) * 1000) / dwElapsedMs);
+        dwRxKBps = (sStats.dwRxBytes - gsEmac.dwDumpRxBytes) / dwElapsedMs;
+        dwTxRate = (uint32_t)(((uint64_t)(sStats.dwTxFrames - gsEmac.dwDumpTxFrames) * 1000) / dwElapsedMs);
+        dwTxKBps = (sStats.dwTxBytes - gsEmac.dwDumpTxBytes) / dwElapsedMs;
+    }
+    gsEmac.qwDumpTime     = qwNow;
+    gsEmac.dwDumpRxFrames = sStats.dwRxFrames;
+    gsEmac.dwDumpRxBytes  = sStats.dwRxBytes;
+    gsEmac.dwDumpTxFrames = sStats.dwTxFrames;
+    gsEmac.dwDumpTxBytes  = sStats.dwTxBytes;
+
+    // 2) One line per direction
+    nLength = snprintf(szLine, sizeof(szLine), "emac: %s, last %lu ms\r\n", gsEmac.fInitDone ? "up" : "down",
+                       (unsigned long)dwElapsedMs);
+    nRet    = UART_PrintLine(nID, szLine, nLength, EMAC_LINE_SIZE);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "rx %lu frames (%lu/s, %lu kB/s), %lu loaned, drop %lu error %lu no buffer %lu queue\r\n",
+                           (unsigned long)sStats.dwRxFrames, (unsigned long)dwRxRate, (unsigned long)dwRxKBps,
+                           (unsigned long)sStats.dwRxLoaned, (unsigned long)sStats.dwRxErrors,
+                           (unsigned long)sStats.dwRxNoBuffer, (unsigned long)sStats.dwRxQueueFull);
+        nRet    = UART_PrintLine(nID, szLine, nLength, EMAC_LINE_SIZE);
+    }
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "tx %lu frames (%lu/s, %lu kB/s), %lu errors, %lu busy\r\n",
+                           (unsigned long)sStats.dwTxFrames, (unsigned long)dwTxRate, (unsigned long)dwTxKBps,
+                           (unsigned long)sStats.dwTxErrors, (unsigned long)sStats.dwTxBusy);
+        nRet    = UART_PrintLine(nID, szLine, nLength, EMAC_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+void EMAC_IRQHandler(void)
+{
+    HAL_ETH_IRQHandler(&gsEmac.sETHHandle);
+}
+
+// --- HAL Callbacks ---
+
+/**
+ * @brief Loan every completed frame to the consumers and refill its descriptor from the pool
+ * @param heth - ETH handle pointer
+ */
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    BaseType_t xWoken           = pdFALSE;
+    ETH_DMARxFrameInfos *psInfo = &heth->RxFrameInfos;
+    ETH_DMADescTypeDef *psDesc  = NULL;
+    emac_frame_t sFrame;
+    void *pvSpare       = NULL;
+    uint32_t dwSegCount = 0;
+
+    PROFILER_SCOPE(PROFILER_PROBE_EMAC_RX_ISR);
+
+    if (!gsEmac.fInitDone)
+    {
+        return;
+    }
+
+    while (HAL_ETH_GetReceivedFrame_IT(heth) == HAL_OK)
+    {
+        // The HAL leaves resetting the segment count of a completed frame to the caller
+        psDesc           = psInfo->FSRxDesc;
+        dwSegCount       = psInfo->SegCount;
+        psInfo->SegCount = 0;
+
+        // 1) Buffers hold a whole frame, one spanning several descriptors is oversized
+        if (dwSegCount != 1 || (psDesc->Status & ETH_DMARXDESC_ES) != 0)
+        {
+            gsEmac.sStats.dwRxErrors++;
+            EMAC_RecycleRx(psDesc, dwSegCount);
+            continue;
+        }
+
+        // 2) The descriptor keeps its buffer unless a spare can take its place
+        pvSpare = POOL_AllocFrom(EMAC_POOL);
+        if (pvSpare == NULL)
+        {
+            gsEmac.sStats.dwRxNoBuffer++;
+            EMAC_RecycleRx(psDesc, 1);
+            continue;
+        }
+
+        sFrame.pbData  = (uint8_t *)psDesc->Buffer1Addr;
+        sFrame.wLength = (uint16_t)psInfo->length;
+        if (xQueueSendFromISR(gsEmac.xRxQueue, &sFrame, &xWoken) != pdTRUE)
+        {
+            gsEmac.sStats.dwRxQueueFull++;
+            POOL_Free(pvSpare);
+            EMAC_RecycleRx(psDesc, 1);
+            continue;
+        }
+
+        // 3) Swap the buffers and hand the descriptor back
+        psDesc->Buffer1Addr = (uintptr_t)pvSpare;
+        __DSB();
+        psDesc->Status = ETH_DMARXDESC_OWN;
+
+        gsEmac.sStats.dwRxFrames++;
+        gsEmac.sStats.dwRxBytes += sFrame.wLength;
+        __atomic_add_fetch(&gsEmac.sStats.dwRxLoaned, 1, __ATOMIC_RELAXED);
+    }
+
+    // 4) The DMA suspends when it catches up with the CPU, restart it now that descriptors are free
+    EMAC_ResumeDMA(ETH_DMA_FLAG_RBU);
+
+    portYIELD_FROM_ISR(xWoken);
+}
+
+/**
+ * @brief Free the blocks of the frames sent so far
+ * @param heth - ETH handle pointer
+ */
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    (void)heth;
+
+    if (gsEmac.fInitDone)
+    {
+        EMAC_ReclaimTx();
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef __EMAC_H__
+#define __EMAC_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "pool.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Interrupt-driven Ethernet MAC driver on the HAL_ETH descriptor rings, without
+ * copies in either direction. Every RX descriptor holds a block of EMAC_POOL.
+ * When a frame lands, the ETH interrupt swaps in a fresh block, gives the
+ * descriptor back to the DMA and queues the filled block, which is loaned to
+ * the consumer until EMAC_Release returns it to the pool. Frames that find no
+ * spare block or no room in the queue are dropped and their buffer stays in
+ * the ring, so reception never stalls on a slow consumer.
+ *
+ * TX is scatter-gather: each segment of a frame is a pool block chained onto
+ * its own descriptor, and the block is freed once the DMA has sent it.
+ *
+ * Only the descriptors are in SRAM2. The frame buffers are EMAC_POOL blocks in
+ * SRAM1, for two reasons. First, loaning rotates every block of the pool
+ * through the RX ring, the TX queue and Service/net, so SRAM2 would have to
+ * hold the whole pool, not just the ETH_RXBUFNB blocks in the ring. Even the
+ * ring alone is 12K of the 16K, and the sampler's 4K DMA buffer and the 8K the
+ * copy benchmark takes from the DMA heap already live there. Second, the cost
+ * is small. At 100 Mbit/s line rate one direction moves about 3.1 M words/s,
+ * which is under 3% of SRAM1's cycles at 120 MHz. The bus matrix arbitrates per
+ * access and the MAC's DMA FIFO absorbs a lost slot, so the CPU waits at most
+ * one cycle on a collision. The descriptors are re-read on every frame and by
+ * each poll demand, so they stay in SRAM2.
+ */
+
+// Pool the descriptors draw their buffers from, blocks must hold ETH_RX_BUF_SIZE
+#define EMAC_POOL              POOL_ID_1536
+
+// Received frames waiting for EMAC_Receive
+#define EMAC_RX_QUEUE_LENGTH   8
+
+// EMAC_Receive timeout that waits until a frame arrives
+#define EMAC_WAIT_FOREVER      0xFFFFFFFFUL
+
+// --- Types ---
+
+typedef struct emac_frame
+{
+    uint8_t *pbData;     // Start of a pool block, loaned until EMAC_Release
+    uint16_t wLength;    // Frame length without the FCS
+} emac_frame_t;
+
+typedef struct emac_segment
+{
+    void *pvBlock;       // Pool block, owned by the driver once EMAC_Transmit succeeds
+    uint16_t wOffset;    // Start of the data in the block
+    uint16_t wLength;    // Number of bytes to send from the block
+} emac_segment_t;
+
+typedef struct emac_stats
+{
+    uint32_t dwRxFrames;       // Frames handed to consumers
+    uint32_t dwRxBytes;
+    uint32_t dwRxErrors;       // Frames with an error or spanning several descriptors, dropped
+    uint32_t dwRxNoBuffer;     // Frames dropped because EMAC_POOL was empty
+    uint32_t dwRxQueueFull;    // Frames dropped because the consumer fell behind
+    uint32_t dwRxLoaned;       // Buffers currently held by consumers
+    uint32_t dwTxFrames;       // Frames sent
+    uint32_t dwTxBytes;
+    uint32_t dwTxErrors;       // Frames the MAC reported an error for
+    uint32_t dwTxBusy;         // EMAC_Transmit calls refused for lack of descriptors
+} emac_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Reset the PHY, fill the RX ring from EMAC_POOL and start the MAC
+ * @retval Status code indicating operation success or reason for failure
+ * @note Waits for the PHY link and auto-negotiation, up to several seconds. Without a
+ *       link NHNS_STATUS_TIMEOUT is returned and the MAC stays off, call again later
+ */
+nhns_status_t EMAC_Init(void);
+
+/**
+ * @brief Stop the MAC and return the ring and queued buffers to the pool
+ * @retval Status code indicating operation success or reason for failure
+ * @note Frames still loaned to consumers remain valid until they are released
+ */
+nhns_status_t EMAC_DeInit(void);
+
+/**
+ * @brief Wait for the next received frame
+ * @param psFrame - Receives the frame, its buffer is loaned until EMAC_Release
+ * @param dwTimeoutMs - Time to wait in milliseconds, EMAC_WAIT_FOREVER to block
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t EMAC_Receive(emac_frame_t *psFrame, uint32_t dwTimeoutMs);
+
+/**
+ * @brief Return a received frame's buffer, callable from tasks and ISRs
+ * @param pbData - Buffer from EMAC_Receive
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t EMAC_Release(uint8_t *pbData);
+
+/**
+ * @brief Queue a frame made of pool blocks for transmission without copying
+ * @param pasSegments - Segments in wire order, each a different block
+ * @param dwCount - Number of segments, at most ETH_TXBUFNB
+ * @retval Status code indicating operation success or reason for failure
+ * @note On success the driver owns the blocks and frees them once they are sent.
+ *       NHNS_STATUS_BUSY means the descriptors are in use, the caller keeps the blocks.
+ *       Callable from tasks only
+ */
+nhns_status_t EMAC_Transmit(const emac_segment_t *pasSegments, uint32_t dwCount);
+
+/**
+ * @brief Get the MAC address the driver was started with
+ * @retval Six bytes in wire order
+ */
+const uint8_t *EMAC_GetMacAddress(void);
+
+/**
+ * @brief Get the frame counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t EMAC_GetStats(emac_stats_t *psStats);
+
+/**
+ * @brief Print the frame counters and the rates since the previous dump
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t EMAC_Dump(uart_instance_t nID);
+
+/**
+ * @brief ETH global interrupt entry point, called from the vector table
+ */
+void EMAC_IRQHandler(void);
+
+#endif    // __EMAC_H__
@@ -0,0 +1,68 @@
+#include <stddef.h>
+#include <string.h>
+#include "flash.h"
+#include "board.h"
+
+// --- Definitions ---
+
+#define FLASH_CHECK_HAL_RETURN(nHALRet)              \
+    do                                               \
+    {                                                \
+        if (nHALRet != HAL_OK)                       \
+        {                                            \
+            return (NHNS_STATUS_BASE_STM + nHALRet); \
+        }                                            \
+    } while (0)
+
+// --- Functions ---
+
+nhns_status_t FLASH_Program(uint32_t dwAddress, const void *pvData, uint32_t dwLength)
+{
+    const uint8_t *pbData     = pvData;
+    uint32_t dwWord           = 0;
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    // 1) Verify arguments
+    if (pvData == NULL || (dwAddress & 3U) != 0 || (dwLength & 3U) != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) One word per operation, the widest the voltage range allows
+    HAL_FLASH_Unlock();
+    for (uint32_t dwOffset = 0; dwOffset < dwLength && nHalRet == HAL_OK; dwOffset += sizeof(dwWord))
+    {
+        memcpy(&dwWord, &pbData[dwOffset], sizeof(dwWord));
+        nHalRet = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, dwAddress + dwOffset, dwWord);
+    }
+    HAL_FLASH_Lock();
+
+    // 3) A word that was not erased keeps the AND of both values
+    if (nHalRet == HAL_OK && memcmp((const void *)(uintptr_t)dwAddress, pvData, dwLength) != 0)
+    {
+        return NHNS_STATUS_DATA_MISMATCH;
+    }
+    FLASH_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t FLASH_EraseSector(uint32_t dwSector)
+{
+    FLASH_EraseInitTypeDef sErase = {0};
+    uint32_t dwSectorError        = 0;
+    HAL_StatusTypeDef nHalRet     = HAL_OK;
+
+    sErase.TypeErase    = FLASH_TYPEERASE_SECTORS;
+    sErase.Banks        = FLASH_BANK_1;
+    sErase.Sector       = dwSector;
+    sErase.NbSectors    = 1;
+    sErase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    HAL_FLASH_Unlock();
+    nHalRet = HAL_FLASHEx_Erase(&sErase, &dwSectorError);
+    HAL_FLASH_Lock();
+    FLASH_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
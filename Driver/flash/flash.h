@@ -0,0 +1,38 @@
+#ifndef __FLASH_H__
+#define __FLASH_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+
+// --- Definitions ---
+
+/*
+ * Programming and erasing of the internal flash at 2.7 to 3.6 V, with 32-bit
+ * parallelism. Reads need no driver, the flash is memory mapped. The F207 has
+ * a single bank: while a program or erase runs, every flash read, instruction
+ * fetches and vector fetches included, stalls until it ends. A word takes
+ * about 16 us, a 128K sector 1 to 2 s.
+ */
+
+#define FLASH_ERASED_WORD 0xFFFFFFFFU
+
+// --- Functions ---
+
+/**
+ * @brief Program erased words and read them back
+ * @param dwAddress - Flash address, word aligned
+ * @param pvData - Data, any alignment
+ * @param dwLength - Number of bytes, a multiple of 4
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a word was not erased before, cells only go from 1 to 0
+ */
+nhns_status_t FLASH_Program(uint32_t dwAddress, const void *pvData, uint32_t dwLength);
+
+/**
+ * @brief Erase one sector, the calling task waits until it is done
+ * @param dwSector - Sector number, FLASH_SECTOR_x
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t FLASH_EraseSector(uint32_t dwSector);
+
+#endif    // __FLASH_H__
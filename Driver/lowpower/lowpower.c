@@ -0,0 +1,391 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "lowpower.h"
+#include "board.h"
+#include "clock.h"
+#include "profiler.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// --- Definitions ---
+
+#define LOWPOWER_LINE_SIZE          128
+
+#ifndef NHNS_HOST
+// The wake-up timer counts RTCCLK / 16, 2048 Hz from the LSE. One count is 15625 / 32 us
+#define LOWPOWER_WUT_HZ             (LSE_VALUE / 16)
+#define LOWPOWER_WUT_MAX_COUNTS     0x10000UL
+#define LOWPOWER_COUNT_US_32        15625UL
+
+// Longest STOP period the 16-bit wake-up timer can time
+#define LOWPOWER_MAX_TICKS          ((TickType_t)((LOWPOWER_WUT_MAX_COUNTS * configTICK_RATE_HZ) / LOWPOWER_WUT_HZ))
+
+// The calendar times early wake-ups: its "seconds" tick at LSE / 32, 1024 Hz, so a day of it is 84 s, longer than
+// LOWPOWER_MAX_TICKS. One unit is 31250 / 32 us
+#define LOWPOWER_CAL_PREDIV_A       31
+#define LOWPOWER_CAL_PREDIV_S       0
+#define LOWPOWER_CAL_UNITS          (24UL * 60 * 60)
+#define LOWPOWER_CAL_UNIT_US_32     31250UL
+
+// Bound on the wait for the calendar shadow registers, which take two RTCCLK periods (61 us) to resync
+#define LOWPOWER_RSF_SPINS          20000
+
+// Regulator and HSI start-up before the first instruction runs, allowance on top of the measured relock
+#define LOWPOWER_STOP_WAKEUP_US     20
+
+// The core runs from the HSI between the wake-up and the switch back to the PLL
+#define LOWPOWER_HSI_CYCLES_PER_US  (HSI_VALUE / 1000000UL)
+#endif
+
+// --- Types ---
+
+typedef struct lowpower_context
+{
+    bool fInitDone;
+    volatile uint32_t dwLocks;
+
+    // Time slept but not yet stepped into the kernel tick, in 1/32 us
+    uint32_t dwResidue;
+
+    lowpower_stats_t sStats;
+} lowpower_context_t;
+
+// --- Global Variables ---
+
+static lowpower_context_t gsLowpower = {0};
+
+#ifndef NHNS_HOST
+static RTC_HandleTypeDef gsRtc = {0};
+#endif
+
+// --- Static Functions ---
+
+#ifndef NHNS_HOST
+/**
+ * @brief Route the console RX pin to its EXTI line, its falling edge is only unmasked during STOP
+ */
+static void LOWPOWER_InitWakeupPin(void)
+{
+    uint32_t dwPin   = POSITION_VAL(LOWPOWER_WAKEUP_PIN);
+    uint32_t dwShift = 4 * (dwPin & 3);
+
+    // 1) The pin stays in its alternate function, the EXTI taps the input stage
+    MODIFY_REG(SYSCFG->EXTICR[dwPin >> 2], 0xFUL << dwShift, (uint32_t)GPIO_GET_INDEX(LOWPOWER_WAKEUP_PORT) << dwShift);
+    EXTI->IMR &= ~LOWPOWER_WAKEUP_PIN;
+    EXTI->FTSR |= LOWPOWER_WAKEUP_PIN;
+
+    HAL_NVIC_SetPriority(LOWPOWER_WAKEUP_IRQn, LOWPOWER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(LOWPOWER_WAKEUP_IRQn);
+}
+
+/**
+ * @brief Clear every wake-up source so nothing is left pending once interrupts are enabled again
+ */
+static void LOWPOWER_ClearWakeup(void)
+{
+    __HAL_RTC_WAKEUPTIMER_CLEAR_FLAG(&gsRtc, RTC_FLAG_WUTF);
+    __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG();
+    __HAL_GPIO_EXTI_CLEAR_IT(LOWPOWER_WAKEUP_PIN);
+    HAL_NVIC_ClearPendingIRQ(LOWPOWER_RTC_IRQn);
+    HAL_NVIC_ClearPendingIRQ(LOWPOWER_WAKEUP_IRQn);
+}
+
+/**
+ * @brief Read the calendar as a running count of units
+ * @retval Units of 1/1024 s, wrapping at LOWPOWER_CAL_UNITS
+ * @note Waits for RSF first, so clear it after STOP to get the time of the wake-up rather than of the entry
+ */
+static uint32_t LOWPOWER_ReadCalendar(void)
+{
+    uint32_t dwTime = 0;
+
+    // 1) The shadow registers are not updated in STOP
+    for (uint32_t dwSpin = 0; (RTC->ISR & RTC_ISR_RSF) == 0U && dwSpin < LOWPOWER_RSF_SPINS; dwSpin++)
+    {
+    }
+
+    // 2) Reading TR locks the shadow DR until DR is read
+    dwTime = RTC->TR;
+    (void)RTC->DR;
+
+    return RTC_Bcd2ToByte((uint8_t)((dwTime & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos)) * 3600UL +
+           RTC_Bcd2ToByte((uint8_t)((dwTime & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos)) * 60UL +
+           RTC_Bcd2ToByte((uint8_t)((dwTime & (RTC_TR_ST | RTC_TR_SU)) >> RTC_TR_SU_Pos));
+}
+
+/**
+ * @brief Idle without stopping any clock, the next interrupt (at the latest SysTick) wakes the core
+ */
+static void LOWPOWER_Sleep(void)
+{
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        gsLowpower.sStats.dwAborted++;
+    }
+    else
+    {
+        gsLowpower.sStats.dwSleepPeriods++;
+        __DSB();
+        __WFI();
+    }
+
+    __enable_irq();
+}
+
+/**
+ * @brief Record the time from the wake-up event until the PLL runs again
+ * @param dwCycles - Cycles counted from the first instruction after STOP until the switch to the PLL
+ * @retval Latency in us
+ */
+static uint32_t LOWPOWER_RecordLatency(uint32_t dwCycles)
+{
+    lowpower_stats_t *psStats = &gsLowpower.sStats;
+    uint32_t dwLatency        = LOWPOWER_STOP_WAKEUP_US + dwCycles / LOWPOWER_HSI_CYCLES_PER_US;
+
+    psStats->dwWakeLatencyLast = dwLatency;
+    if (dwLatency < psStats->dwWakeLatencyMin || psStats->dwStopPeriods == 1)
+    {
+        psStats->dwWakeLatencyMin = dwLatency;
+    }
+    if (dwLatency > psStats->dwWakeLatencyMax)
+    {
+        psStats->dwWakeLatencyMax = dwLatency;
+    }
+    if (dwLatency > LOWPOWER_BUDGET_TICKS * (1000000UL / configTICK_RATE_HZ))
+    {
+        psStats->dwOverBudget++;
+    }
+
+    return dwLatency;
+}
+#endif
+
+// --- Functions ---
+
+nhns_status_t LOWPOWER_Init(void)
+{
+    // 1) Check if module is already initialized
+    if (gsLowpower.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+#ifndef NHNS_HOST
+    // 2) The RTC runs from the LSE through STOP, the calendar counts 1024 Hz units instead of seconds
+    gsRtc.Instance            = RTC;
+    gsRtc.Init.HourFormat     = RTC_HOURFORMAT_24;
+    gsRtc.Init.AsynchPrediv   = LOWPOWER_CAL_PREDIV_A;
+    gsRtc.Init.SynchPrediv    = LOWPOWER_CAL_PREDIV_S;
+    gsRtc.Init.OutPut         = RTC_OUTPUT_DISABLE;
+    gsRtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+    gsRtc.Init.OutPutType     = RTC_OUTPUT_TYPE_OPENDRAIN;
+    if (HAL_RTC_Init(&gsRtc) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 3) Both wake-up sources must reach the NVIC to end the WFI that enters STOP
+    HAL_NVIC_SetPriority(LOWPOWER_RTC_IRQn, LOWPOWER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(LOWPOWER_RTC_IRQn);
+    LOWPOWER_InitWakeupPin();
+
+#ifdef FW_DEBUG
+    // 4) Keep the debugger attached through STOP
+    HAL_DBGMCU_EnableDBGStopMode();
+#endif
+#endif
+
+    gsLowpower.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+void LOWPOWER_Lock(void)
+{
+    __atomic_fetch_add(&gsLowpower.dwLocks, 1, __ATOMIC_RELAXED);
+}
+
+void LOWPOWER_Unlock(void)
+{
+    __atomic_fetch_sub(&gsLowpower.dwLocks, 1, __ATOMIC_RELAXED);
+}
+
+nhns_status_t LOWPOWER_GetStats(lowpower_stats_t *psStats)
+{
+    // 1) Verify argument
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) The idle task updates the counters with interrupts masked
+    taskENTER_CRITICAL();
+    *psStats = gsLowpower.sStats;
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t LOWPOWER_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    lowpower_stats_t sStats;
+    TickType_t xUptime = xTaskGetTickCount();
+    uint32_t dwShare   = 0;
+    char szLine[LOWPOWER_LINE_SIZE];
+    int nLength = 0;
+
+    LOWPOWER_GetStats(&sStats);
+    if (xUptime != 0)
+    {
+        dwShare = (uint32_t)(((uint64_t)sStats.dwStopTicks * 1000) / xUptime);
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine), "lowpower:\r\nstop    %lu periods, %lu ticks (%lu.%lu %% of %lu), %lu early\r\n",
+                       (unsigned long)sStats.dwStopPeriods, (unsigned long)sStats.dwStopTicks,
+                       (unsigned long)(dwShare / 10), (unsigned long)(dwShare % 10), (unsigned long)xUptime,
+                       (unsigned long)sStats.dwEarlyWakes);
+    nRet    = UART_PrintLine(nID, szLine, nLength, LOWPOWER_LINE_SIZE);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "sleep   %lu periods, %lu locked, %lu aborted\r\n",
+                           (unsigned long)sStats.dwSleepPeriods, (unsigned long)sStats.dwLocked,
+                           (unsigned long)sStats.dwAborted);
+        nRet    = UART_PrintLine(nID, szLine, nLength, LOWPOWER_LINE_SIZE);
+    }
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "wake-up last %lu us, min %lu, max %lu, budget %lu us, %lu over\r\n",
+                           (unsigned long)sStats.dwWakeLatencyLast, (unsigned long)sStats.dwWakeLatencyMin,
+                           (unsigned long)sStats.dwWakeLatencyMax,
+                           (unsigned long)(LOWPOWER_BUDGET_TICKS * (1000000UL / configTICK_RATE_HZ)),
+                           (unsigned long)sStats.dwOverBudget);
+        nRet    = UART_PrintLine(nID, szLine, nLength, LOWPOWER_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+void LOWPOWER_WakeupIRQHandler(void)
+{
+#ifndef NHNS_HOST
+    LOWPOWER_ClearWakeup();
+#endif
+}
+
+#ifndef NHNS_HOST
+/**
+ * @brief Idle until the next kernel deadline, in STOP when it is far enough away
+ * @param xExpectedIdleTime - Ticks until the next task unblocks, from the idle task with the scheduler suspended
+ * @note Called by the kernel through portSUPPRESS_TICKS_AND_SLEEP (configUSE_TICKLESS_IDLE 2)
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t dwCounts    = 0;
+    uint32_t dwPartialUs = 0;
+    uint32_t dwWake      = 0;
+    uint32_t dwLatency   = 0;
+    uint32_t dwCalendar  = 0;
+    uint32_t dwSlept     = 0;
+    TickType_t xElapsed  = 0;
+    bool fTimerExpired   = false;
+
+    // 1) Short periods, and any period while a driver needs its clock, sleep with SysTick running
+    if (!gsLowpower.fInitDone || xExpectedIdleTime < LOWPOWER_STOP_MIN_TICKS || gsLowpower.dwLocks != 0)
+    {
+        if (gsLowpower.fInitDone && xExpectedIdleTime >= LOWPOWER_STOP_MIN_TICKS)
+        {
+            gsLowpower.sStats.dwLocked++;
+        }
+        LOWPOWER_Sleep();
+        return;
+    }
+
+    // 2) Wake up the budget ahead of the deadline, within the range of the wake-up timer
+    if (xExpectedIdleTime > LOWPOWER_MAX_TICKS)
+    {
+        xExpectedIdleTime = LOWPOWER_MAX_TICKS;
+    }
+    dwCounts = (uint32_t)(((uint64_t)(xExpectedIdleTime - LOWPOWER_BUDGET_TICKS) * LOWPOWER_WUT_HZ) / configTICK_RATE_HZ);
+
+    // 3) From here on nothing may run until the kernel tick is corrected
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep || gsLowpower.dwLocks != 0)
+    {
+        gsLowpower.sStats.dwAborted++;
+        __enable_irq();
+        return;
+    }
+
+    // 4) Stop SysTick, the part of the current tick already counted is carried over
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    dwPartialUs = (uint32_t)(((uint64_t)(SysTick->LOAD - SysTick->VAL) * 1000000UL) / SystemCoreClock);
+
+    // 5) Note the time for an early wake-up, arm the wake-up sources and stop
+    dwCalendar = LOWPOWER_ReadCalendar();
+    HAL_RTCEx_SetWakeUpTimer_IT(&gsRtc, dwCounts - 1, RTC_WAKEUPCLOCK_RTCCLK_DIV16);
+    __HAL_GPIO_EXTI_CLEAR_IT(LOWPOWER_WAKEUP_PIN);
+    EXTI->IMR |= LOWPOWER_WAKEUP_PIN;
+
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // 6) Running from the HSI, bring the PLL back before anything else
+    dwWake = PROFILER_GetCycles();
+    SystemClock_Restore();
+    gsLowpower.sStats.dwStopPeriods++;
+    dwLatency = LOWPOWER_RecordLatency(PROFILER_GetCycles() - dwWake);
+
+    // 7) Disarm, the RTC flag tells a timed wake-up from an early one. Clearing RSF resyncs the calendar,
+    //    ISR[7:0] ignore writes while the RTC is write-protected, which the deactivation just turned back on
+    fTimerExpired = __HAL_RTC_WAKEUPTIMER_GET_FLAG(&gsRtc, RTC_FLAG_WUTF) != 0U;
+    EXTI->IMR &= ~LOWPOWER_WAKEUP_PIN;
+    HAL_RTCEx_DeactivateWakeUpTimer(&gsRtc);
+    LOWPOWER_ClearWakeup();
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&gsRtc);
+    RTC->ISR = (uint32_t)(RTC_RSF_MASK & RTC_ISR_RESERVED_MASK);
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&gsRtc);
+
+    // 8) Time slept in 1/32 us: the timer's counts plus the relock, or the calendar after an early wake-up,
+    //    which already includes the relock and is exact to one unit
+    if (fTimerExpired)
+    {
+        dwSlept = dwCounts * LOWPOWER_COUNT_US_32 + dwLatency * 32;
+    }
+    else
+    {
+        dwCalendar = (LOWPOWER_ReadCalendar() + LOWPOWER_CAL_UNITS - dwCalendar) % LOWPOWER_CAL_UNITS;
+        dwSlept    = dwCalendar * LOWPOWER_CAL_UNIT_US_32;
+        gsLowpower.sStats.dwEarlyWakes++;
+    }
+
+    // 9) Step the kernel by whole ticks, carrying the rest over to the next period
+    gsLowpower.dwResidue += dwSlept + dwPartialUs * 32;
+    xElapsed              = gsLowpower.dwResidue / (32 * (1000000UL / configTICK_RATE_HZ));
+    gsLowpower.dwResidue -= xElapsed * (32 * (1000000UL / configTICK_RATE_HZ));
+    if (xElapsed > xExpectedIdleTime)
+    {
+        xElapsed             = xExpectedIdleTime;
+        gsLowpower.dwResidue = 0;
+    }
+
+    vTaskStepTick(xElapsed);
+    gsLowpower.sStats.dwStopTicks += xElapsed;
+
+    // The microsecond clock's timer had no clock either
+    CLOCK_Advance(dwSlept / 32);
+
+    // 10) Restart SysTick on a tick boundary and let the pending interrupts run
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    __enable_irq();
+}
+#endif
@@ -0,0 +1,87 @@
+#ifndef __LOWPOWER_H__
+#define __LOWPOWER_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Tickless idle for the STM32F207 (configUSE_TICKLESS_IDLE 2). When the kernel
+ * expects to stay idle for at least LOWPOWER_STOP_MIN_TICKS, the idle task
+ * stops SysTick, arms the RTC wake-up timer and enters STOP mode. The wake-up
+ * is scheduled LOWPOWER_BUDGET_TICKS ahead of the next deadline, which covers
+ * the regulator start-up and the PLL relock, and the kernel tick is stepped by
+ * the time actually slept. Shorter idle periods sleep with SysTick running.
+ *
+ * Peripherals lose their clock in STOP. Drivers with a transfer in flight hold
+ * LOWPOWER_Lock() until it completes, the debug console RX pin is armed as an
+ * extra wake-up source so typing still wakes the system (the first character
+ * is lost). The wake-up timer cannot be read back, so such an early wake-up is
+ * timed from the RTC calendar instead, which counts in 1/1024 s units.
+ */
+
+// Shortest expected idle time in ticks that is spent in STOP
+#define LOWPOWER_STOP_MIN_TICKS 3
+
+// Ticks reserved ahead of each deadline for the wake-up from STOP
+#define LOWPOWER_BUDGET_TICKS   1
+
+// --- Types ---
+
+typedef struct lowpower_stats
+{
+    uint32_t dwStopPeriods;      // Idle periods spent in STOP
+    uint32_t dwStopTicks;        // Kernel ticks stepped over while in STOP
+    uint32_t dwEarlyWakes;       // STOP periods ended by another source than the RTC, timed from the calendar
+    uint32_t dwLocked;           // Idle periods long enough for STOP that a held lock kept in sleep
+    uint32_t dwAborted;          // Idle periods cancelled because a task became ready
+    uint32_t dwSleepPeriods;     // Idle periods spent in sleep with SysTick running
+    uint32_t dwWakeLatencyLast;  // Time from the wake-up event until the PLL runs again, in us
+    uint32_t dwWakeLatencyMin;
+    uint32_t dwWakeLatencyMax;
+    uint32_t dwOverBudget;       // Wake-ups slower than LOWPOWER_BUDGET_TICKS
+} lowpower_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Start the RTC used as the sleep timebase and prepare the wake-up sources
+ * @retval Status code indicating operation success or reason for failure
+ * @note Call before the scheduler starts, the kernel stays out of STOP until this succeeded
+ */
+nhns_status_t LOWPOWER_Init(void);
+
+/**
+ * @brief Keep the system out of STOP, callable from tasks and ISRs
+ * @note Every call must be balanced by LOWPOWER_Unlock
+ */
+void LOWPOWER_Lock(void);
+
+/**
+ * @brief Release a lock taken with LOWPOWER_Lock, callable from tasks and ISRs
+ */
+void LOWPOWER_Unlock(void);
+
+/**
+ * @brief Get the idle accounting and wake-up latencies
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t LOWPOWER_GetStats(lowpower_stats_t *psStats);
+
+/**
+ * @brief Print the idle accounting and wake-up latencies
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t LOWPOWER_Dump(uart_instance_t nID);
+
+/**
+ * @brief Clear wake-up events left pending outside of a STOP period
+ * @note Called from the RTC wake-up and console EXTI interrupt handlers
+ */
+void LOWPOWER_WakeupIRQHandler(void);
+
+#endif    // __LOWPOWER_H__
@@ -0,0 +1,223 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+#include "stm32f2xx_hal.h"
+#ifdef NHNS_HOST
+#include <time.h>
+#endif
+
+// --- Definitions ---
+
+#define PROFILER_LINE_SIZE 128
+
+#ifdef NHNS_HOST
+// Emulated interrupts run from the tick signal, a torn sample only skews diagnostics
+#define PROFILER_LOCK()       (0U)
+#define PROFILER_UNLOCK(dwPM) ((void)(dwPM))
+#else
+#define PROFILER_LOCK()       PROFILER_Lock()
+#define PROFILER_UNLOCK(dwPM) __set_PRIMASK(dwPM)
+#endif
+
+// --- Global Variables ---
+
+static profiler_stats_t gasProbes[PROFILER_PROBE_MAX];
+
+static const char *const gaszProbeNames[PROFILER_PROBE_MAX] = {
+    [PROFILER_PROBE_UART_TX_QUEUE] = "uart_tx_queue",
+    [PROFILER_PROBE_UART_TX_ISR]   = "uart_tx_isr",
+    [PROFILER_PROBE_UART_RX_ISR]   = "uart_rx_isr",
+    [PROFILER_PROBE_EMAC_TX]       = "emac_tx",
+    [PROFILER_PROBE_EMAC_RX_ISR]   = "emac_rx_isr",
+    [PROFILER_PROBE_CDC_TX_ISR]    = "cdc_tx_isr",
+    [PROFILER_PROBE_CDC_RX_ISR]    = "cdc_rx_isr",
+    [PROFILER_PROBE_SAMPLER_ISR]   = "sampler_isr",
+};
+
+// --- Static Functions ---
+
+#ifndef NHNS_HOST
+/**
+ * @brief Mask all configurable interrupts, probes may sit in ISRs of any priority
+ * @retval Previous PRIMASK to restore
+ */
+static inline uint32_t PROFILER_Lock(void)
+{
+    uint32_t dwPrimask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return dwPrimask;
+}
+#endif
+
+/**
+ * @brief Clear one probe, min starts at the largest value so the first sample replaces it
+ * @param psStats - Statistics to clear
+ */
+static void PROFILER_Clear(profiler_stats_t *psStats)
+{
+    memset(psStats, 0, sizeof(*psStats));
+    psStats->dwMin = UINT32_MAX;
+}
+
+// --- Functions ---
+
+nhns_status_t PROFILER_Init(void)
+{
+#ifndef NHNS_HOST
+    // 1) Enable the trace block, only then are the DWT registers accessible
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    if (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk)
+    {
+        return NHNS_STATUS_UNSUPPORTED;
+    }
+
+    // 2) Start the cycle counter
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    PROFILER_Reset();
+
+    return NHNS_STATUS_OK;
+}
+
+uint32_t PROFILER_GetCycles(void)
+{
+#ifdef NHNS_HOST
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (uint32_t)((uint64_t)sNow.tv_sec * 1000000000ULL + (uint64_t)sNow.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+uint32_t PROFILER_GetCyclesPerSecond(void)
+{
+#ifdef NHNS_HOST
+    return 1000000000UL;
+#else
+    return SystemCoreClock;
+#endif
+}
+
+void PROFILER_Record(profiler_probe_t nProbe, uint32_t dwCycles)
+{
+    profiler_stats_t *psStats = NULL;
+    uint32_t dwBucket         = 0;
+    uint32_t dwPrimask        = 0;
+
+    if (nProbe <= PROFILER_PROBE_INVALID || nProbe >= PROFILER_PROBE_MAX)
+    {
+        return;
+    }
+
+    // 1) Bucket by bit length, computed outside the critical section
+    dwBucket = (dwCycles == 0) ? 0 : (32 - __builtin_clz(dwCycles));
+    if (dwBucket >= PROFILER_HISTOGRAM_BUCKETS)
+    {
+        dwBucket = PROFILER_HISTOGRAM_BUCKETS - 1;
+    }
+
+    // 2) Accumulate
+    psStats   = &gasProbes[nProbe];
+    dwPrimask = PROFILER_LOCK();
+    psStats->dwCount++;
+    psStats->qwTotal += dwCycles;
+    if (dwCycles < psStats->dwMin)
+    {
+        psStats->dwMin = dwCycles;
+    }
+    if (dwCycles > psStats->dwMax)
+    {
+        psStats->dwMax = dwCycles;
+    }
+    psStats->adwHistogram[dwBucket]++;
+    PROFILER_UNLOCK(dwPrimask);
+}
+
+nhns_status_t PROFILER_GetStats(profiler_probe_t nProbe, profiler_stats_t *psStats)
+{
+    uint32_t dwPrimask = 0;
+
+    // 1) Verify arguments
+    if (nProbe <= PROFILER_PROBE_INVALID || nProbe >= PROFILER_PROBE_MAX || psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Copy under lock so count, total and histogram agree
+    dwPrimask = PROFILER_LOCK();
+    *psStats  = gasProbes[nProbe];
+    PROFILER_UNLOCK(dwPrimask);
+
+    return NHNS_STATUS_OK;
+}
+
+void PROFILER_Reset(void)
+{
+    uint32_t dwPrimask = PROFILER_LOCK();
+
+    for (int nProbe = 0; nProbe < PROFILER_PROBE_MAX; nProbe++)
+    {
+        PROFILER_Clear(&gasProbes[nProbe]);
+    }
+
+    PROFILER_UNLOCK(dwPrimask);
+}
+
+nhns_status_t PROFILER_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    profiler_stats_t sStats;
+    char szLine[PROFILER_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Header with the counter rate so cycles can be converted
+    nLength = snprintf(szLine, sizeof(szLine), "profiler: %lu ticks/s%s\r\n%-16s %10s %10s %10s %10s\r\n",
+                       (unsigned long)PROFILER_GetCyclesPerSecond(), PROFILER_ENABLED ? "" : " (probes disabled)",
+                       "probe", "count", "min", "mean", "max");
+    nRet = UART_PrintLine(nID, szLine, nLength, PROFILER_LINE_SIZE);
+
+    // 2) One row per probe with samples, followed by its non-empty histogram buckets
+    for (int nProbe = 0; nProbe < PROFILER_PROBE_MAX && nRet == NHNS_STATUS_OK; nProbe++)
+    {
+        PROFILER_GetStats((profiler_probe_t)nProbe, &sStats);
+        if (sStats.dwCount == 0)
+        {
+            continue;
+        }
+
+        nLength = snprintf(szLine, sizeof(szLine), "%-16s %10lu %10lu %10lu %10lu\r\n", gaszProbeNames[nProbe],
+                           (unsigned long)sStats.dwCount, (unsigned long)sStats.dwMin,
+                           (unsigned long)(sStats.qwTotal / sStats.dwCount), (unsigned long)sStats.dwMax);
+        nRet = UART_PrintLine(nID, szLine, nLength, PROFILER_LINE_SIZE);
+
+        for (int nBucket = 0; nBucket < PROFILER_HISTOGRAM_BUCKETS && nRet == NHNS_STATUS_OK; nBucket++)
+        {
+            if (sStats.adwHistogram[nBucket] == 0)
+            {
+                continue;
+            }
+
+            // Bucket n holds [2^(n-1), 2^n), the last one also everything above
+            nLength = snprintf(szLine, sizeof(szLine), "  %s%-10lu %10lu\r\n",
+                               (nBucket == PROFILER_HISTOGRAM_BUCKETS - 1) ? ">=" : "< ",
+                               (nBucket == PROFILER_HISTOGRAM_BUCKETS - 1) ? (1UL << (nBucket - 1)) : (1UL << nBucket),
+                               (unsigned long)sStats.adwHistogram[nBucket]);
+            nRet = UART_PrintLine(nID, szLine, nLength, PROFILER_LINE_SIZE);
+        }
+    }
+
+    return nRet;
+}
+
+void PROFILER_ScopeExit(profiler_scope_t *psScope)
+{
+    PROFILER_Record(psScope->nProbe, PROFILER_GetCycles() - psScope->dwStart);
+}
@@ -0,0 +1,134 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Probes are enabled in debug builds only. In other profiles every probe macro
+ * expands to nothing, so instrumentation can stay in hot paths for good.
+ * Define PROFILER_ENABLED=1 to force them on in an optimized build.
+ */
+#ifndef PROFILER_ENABLED
+#ifdef FW_DEBUG
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+#endif
+
+// Samples land in power-of-two buckets, bucket n holds durations with bit length n
+#define PROFILER_HISTOGRAM_BUCKETS 24
+
+typedef enum profiler_probe
+{
+    PROFILER_PROBE_INVALID = -1,
+    PROFILER_PROBE_UART_TX_QUEUE,
+    PROFILER_PROBE_UART_TX_ISR,
+    PROFILER_PROBE_UART_RX_ISR,
+    PROFILER_PROBE_EMAC_TX,
+    PROFILER_PROBE_EMAC_RX_ISR,
+    PROFILER_PROBE_CDC_TX_ISR,
+    PROFILER_PROBE_CDC_RX_ISR,
+    PROFILER_PROBE_SAMPLER_ISR,
+    PROFILER_PROBE_MAX,
+} profiler_probe_t;
+
+// --- Types ---
+
+typedef struct profiler_stats
+{
+    uint32_t dwCount;
+    uint32_t dwMin;
+    uint32_t dwMax;
+    uint64_t qwTotal;
+    uint32_t adwHistogram[PROFILER_HISTOGRAM_BUCKETS];
+} profiler_stats_t;
+
+typedef struct profiler_scope
+{
+    profiler_probe_t nProbe;
+    uint32_t dwStart;
+} profiler_scope_t;
+
+// --- Functions ---
+
+/**
+ * @brief Start the cycle counter and clear all probes
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t PROFILER_Init(void);
+
+/**
+ * @brief Read the free-running timestamp counter
+ * @retval Core cycles (DWT CYCCNT) on the target, nanoseconds on the host
+ */
+uint32_t PROFILER_GetCycles(void);
+
+/**
+ * @brief Get the rate of the timestamp counter
+ * @retval Counter ticks per second
+ */
+uint32_t PROFILER_GetCyclesPerSecond(void);
+
+/**
+ * @brief Accumulate one duration sample, callable from tasks and ISRs
+ * @param nProbe - Probe to accumulate into
+ * @param dwCycles - Duration in counter ticks
+ */
+void PROFILER_Record(profiler_probe_t nProbe, uint32_t dwCycles);
+
+/**
+ * @brief Take a consistent copy of a probe's statistics
+ * @param nProbe - Probe to read
+ * @param psStats - Receives the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t PROFILER_GetStats(profiler_probe_t nProbe, profiler_stats_t *psStats);
+
+/**
+ * @brief Clear all probes
+ */
+void PROFILER_Reset(void);
+
+/**
+ * @brief Print a table of all probes that have samples
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t PROFILER_Dump(uart_instance_t nID);
+
+/**
+ * @brief Cleanup handler for PROFILER_SCOPE, not meant to be called directly
+ * @param psScope - Scope being left
+ */
+void PROFILER_ScopeExit(profiler_scope_t *psScope);
+
+// --- Probe Macros ---
+
+#if PROFILER_ENABLED
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b)  PROFILER_CONCAT_(a, b)
+
+/** Measure from this point to the end of the enclosing block */
+#define PROFILER_SCOPE(nProbe)                                                             \
+    profiler_scope_t PROFILER_CONCAT(sProfilerScope, __LINE__)                             \
+        __attribute__((cleanup(PROFILER_ScopeExit))) = {(nProbe), PROFILER_GetCycles()}
+
+/** Explicit start/stop pair sharing a local timestamp */
+#define PROFILER_START(nProbe)  uint32_t dwProfilerStart_##nProbe = PROFILER_GetCycles()
+#define PROFILER_STOP(nProbe)   PROFILER_Record((nProbe), PROFILER_GetCycles() - dwProfilerStart_##nProbe)
+
+#else
+
+#define PROFILER_SCOPE(nProbe)  ((void)0)
+#define PROFILER_START(nProbe)  ((void)0)
+#define PROFILER_STOP(nProbe)   ((void)0)
+
+#endif
+
+#endif    // __PROFILER_H__
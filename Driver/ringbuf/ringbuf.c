@@ -0,0 +1,121 @@
+#include <stddef.h>
+#include <string.h>
+#include "ringbuf.h"
+
+// --- Definitions ---
+
+// Orders the payload copy against the index update that publishes it
+#define RINGBUF_BARRIER() __sync_synchronize()
+
+// --- Functions ---
+
+nhns_status_t RINGBUF_Init(ringbuf_t *psRing, uint8_t *pBuffer, uint32_t dwSize)
+{
+    // 1) Verify arguments
+    if (psRing == NULL || pBuffer == NULL || dwSize == 0 || (dwSize & (dwSize - 1)) != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Attach storage and start empty
+    psRing->pBuffer = pBuffer;
+    psRing->dwSize  = dwSize;
+    psRing->dwMask  = dwSize - 1;
+    psRing->dwHead  = 0;
+    psRing->dwTail  = 0;
+
+    return NHNS_STATUS_OK;
+}
+
+void RINGBUF_Reset(ringbuf_t *psRing)
+{
+    psRing->dwTail = psRing->dwHead;
+}
+
+uint32_t RINGBUF_Used(const ringbuf_t *psRing)
+{
+    return psRing->dwHead - psRing->dwTail;
+}
+
+uint32_t RINGBUF_Free(const ringbuf_t *psRing)
+{
+    return psRing->dwSize - (psRing->dwHead - psRing->dwTail);
+}
+
+uint32_t RINGBUF_Write(ringbuf_t *psRing, const uint8_t *pData, uint32_t dwLength)
+{
+    uint32_t dwHead  = psRing->dwHead;
+    uint32_t dwFree  = psRing->dwSize - (dwHead - psRing->dwTail);
+    uint32_t dwIndex = dwHead & psRing->dwMask;
+    uint32_t dwFirst = 0;
+
+    // 1) Clamp to available space
+    if (dwLength > dwFree)
+    {
+        dwLength = dwFree;
+    }
+
+    // 2) Copy up to the end of storage, then wrap
+    dwFirst = psRing->dwSize - dwIndex;
+    if (dwFirst > dwLength)
+    {
+        dwFirst = dwLength;
+    }
+    memcpy(&psRing->pBuffer[dwIndex], pData, dwFirst);
+    memcpy(psRing->pBuffer, pData + dwFirst, dwLength - dwFirst);
+
+    // 3) Publish
+    RINGBUF_BARRIER();
+    psRing->dwHead = dwHead + dwLength;
+
+    return dwLength;
+}
+
+uint32_t RINGBUF_Read(ringbuf_t *psRing, uint8_t *pData, uint32_t dwLength)
+{
+    uint32_t dwTail  = psRing->dwTail;
+    uint32_t dwUsed  = psRing->dwHead - dwTail;
+    uint32_t dwIndex = dwTail & psRing->dwMask;
+    uint32_t dwFirst = 0;
+
+    // 1) Clamp to buffered data
+    if (dwLength > dwUsed)
+    {
+        dwLength = dwUsed;
+    }
+    RINGBUF_BARRIER();
+
+    // 2) Copy up to the end of storage, then wrap
+    dwFirst = psRing->dwSize - dwIndex;
+    if (dwFirst > dwLength)
+    {
+        dwFirst = dwLength;
+    }
+    memcpy(pData, &psRing->pBuffer[dwIndex], dwFirst);
+    memcpy(pData + dwFirst, psRing->pBuffer, dwLength - dwFirst);
+
+    // 3) Release the space
+    RINGBUF_BARRIER();
+    psRing->dwTail = dwTail + dwLength;
+
+    return dwLength;
+}
+
+uint32_t RINGBUF_PeekContiguous(const ringbuf_t *psRing, uint8_t **ppData)
+{
+    uint32_t dwTail  = psRing->dwTail;
+    uint32_t dwUsed  = psRing->dwHead - dwTail;
+    uint32_t dwIndex = dwTail & psRing->dwMask;
+    uint32_t dwFirst = psRing->dwSize - dwIndex;
+
+    RINGBUF_BARRIER();
+    *ppData = &psRing->pBuffer[dwIndex];
+
+    return (dwUsed < dwFirst) ? dwUsed : dwFirst;
+}
+
+void RINGBUF_Consume(ringbuf_t *psRing, uint32_t dwLength)
+{
+    RINGBUF_BARRIER();
+    psRing->dwTail += dwLength;
+}
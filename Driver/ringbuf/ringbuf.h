@@ -0,0 +1,98 @@
+#ifndef __RINGBUF_H__
+#define __RINGBUF_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+
+// --- Definitions ---
+
+/*
+ * Single-producer/single-consumer byte ring. The producer only ever moves
+ * dwHead and the consumer only ever moves dwTail, so one side may run in a
+ * task while the other runs in an ISR without locking. Indices are
+ * free-running and wrap naturally, which is why the size must be a power of
+ * two.
+ *
+ * Several producers, or several consumers, have to be serialized by the
+ * caller so the ring still sees one of each. The UART TX ring is written by
+ * any task under taskENTER_CRITICAL, which also covers the free-space check
+ * before the write, and drained by its DMA interrupt alone.
+ */
+
+// --- Types ---
+
+typedef struct ringbuf
+{
+    uint8_t *pBuffer;
+    uint32_t dwSize;
+    uint32_t dwMask;
+    volatile uint32_t dwHead;
+    volatile uint32_t dwTail;
+} ringbuf_t;
+
+// --- Functions ---
+
+/**
+ * @brief Initialize a ring over caller-provided storage
+ * @param psRing - Ring to initialize
+ * @param pBuffer - Backing storage
+ * @param dwSize - Size of pBuffer in bytes, must be a power of two
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t RINGBUF_Init(ringbuf_t *psRing, uint8_t *pBuffer, uint32_t dwSize);
+
+/**
+ * @brief Discard all buffered data (consumer side only)
+ * @param psRing - Ring to reset
+ */
+void RINGBUF_Reset(ringbuf_t *psRing);
+
+/**
+ * @brief Get the number of bytes available to read
+ * @param psRing - Ring to query
+ * @retval Number of buffered bytes
+ */
+uint32_t RINGBUF_Used(const ringbuf_t *psRing);
+
+/**
+ * @brief Get the number of bytes that can be written without overwriting
+ * @param psRing - Ring to query
+ * @retval Number of free bytes
+ */
+uint32_t RINGBUF_Free(const ringbuf_t *psRing);
+
+/**
+ * @brief Copy data into the ring (producer side)
+ * @param psRing - Ring to write into
+ * @param pData - Data to copy
+ * @param dwLength - Number of bytes to copy
+ * @retval Number of bytes actually written, less than dwLength if the ring filled up
+ */
+uint32_t RINGBUF_Write(ringbuf_t *psRing, const uint8_t *pData, uint32_t dwLength);
+
+/**
+ * @brief Copy data out of the ring (consumer side)
+ * @param psRing - Ring to read from
+ * @param pData - Destination buffer
+ * @param dwLength - Size of pData
+ * @retval Number of bytes actually read
+ */
+uint32_t RINGBUF_Read(ringbuf_t *psRing, uint8_t *pData, uint32_t dwLength);
+
+/**
+ * @brief Get the oldest contiguous run of buffered bytes without consuming it
+ * @param psRing - Ring to peek into
+ * @param ppData - Receives a pointer to the first buffered byte
+ * @retval Length of the contiguous run, 0 if the ring is empty
+ * @note Intended for handing ring storage directly to a DMA engine; follow with RINGBUF_Consume
+ */
+uint32_t RINGBUF_PeekContiguous(const ringbuf_t *psRing, uint8_t **ppData);
+
+/**
+ * @brief Release bytes previously obtained with RINGBUF_PeekContiguous
+ * @param psRing - Ring to consume from
+ * @param dwLength - Number of bytes to release
+ */
+void RINGBUF_Consume(ringbuf_t *psRing, uint32_t dwLength);
+
+#endif    // __RINGBUF_H__
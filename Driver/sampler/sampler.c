@@ -0,0 +1,723 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "sampler.h"
+#include "board.h"
+#include "clock.h"
+#include "heap.h"
+#include "lowpower.h"
+#include "profiler.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define SAMPLER_LINE_SIZE  128
+
+#define SAMPLER_HALVES     2
+#define SAMPLER_ADC_COUNT  3
+
+#define SAMPLER_BENCH_MS   1000
+#define SAMPLER_BENCH_WAIT 100    // Ms without a block before a run gives up
+
+// --- Types ---
+
+typedef enum sampler_half
+{
+    SAMPLER_HALF_FREE = 0,    // The stream may fill it
+    SAMPLER_HALF_QUEUED,      // Filled, waiting for SAMPLER_Receive
+    SAMPLER_HALF_HELD,        // Loaned to the task until SAMPLER_Release
+} sampler_half_t;
+
+typedef struct sampler_bench_run
+{
+    sampler_mode_t nMode;
+    uint32_t dwRate;
+} sampler_bench_run_t;
+
+typedef struct sampler_context
+{
+    bool fInitDone;
+    volatile bool fRunning;
+    sampler_mode_t nMode;
+    QueueHandle_t xQueue;
+    ADC_HandleTypeDef asADC[SAMPLER_ADC_COUNT];
+    DMA_HandleTypeDef sDMAHandle;
+#ifndef NHNS_HOST
+    TIM_HandleTypeDef sTimer;
+#endif
+
+    // The interrupt owns these while running, tasks change them in critical sections
+    volatile sampler_half_t anHalf[SAMPLER_HALVES];
+    volatile bool afOverwritten[SAMPLER_HALVES];    // The stream wrote into the half since it was filled
+    uint32_t dwSequence;
+
+    sampler_stats_t sStats;
+} sampler_context_t;
+
+// --- Global Variables ---
+
+static sampler_context_t gsSampler = {0};
+
+// Both halves, written as halfwords in single mode and as pairs of samples in triple mode
+static uint32_t gadwSamplerBuffer[SAMPLER_HALVES * SAMPLER_BLOCK_SAMPLES / 2] HEAP_DMA_BUFFER;
+
+static const sampler_bench_run_t gasSamplerBench[] = {
+    {SAMPLER_MODE_SINGLE, 250000                 },
+    {SAMPLER_MODE_SINGLE, 1000000                },
+    {SAMPLER_MODE_SINGLE, SAMPLER_MAX_RATE_SINGLE},
+    {SAMPLER_MODE_TRIPLE, SAMPLER_MAX_RATE_TRIPLE},
+};
+
+RTOS_QUEUE_DEFINE(sampler, SAMPLER_HALVES, sizeof(sampler_block_t));
+
+// --- Static Functions ---
+
+/**
+ * @brief First sample of a half of the DMA buffer
+ * @param dwHalf - 0 or 1
+ * @retval Start of the half
+ */
+static uint16_t *SAMPLER_Half(uint32_t dwHalf)
+{
+    return &((uint16_t *)gadwSamplerBuffer)[dwHalf * SAMPLER_BLOCK_SAMPLES];
+}
+
+/**
+ * @brief Configure an ADC to convert the sampler channel on its own or as a slave of ADC1
+ * @param psADC - ADC handle with the instance set
+ * @param dwTrigger - External trigger edge, none for the slaves
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef SAMPLER_ConfigADC(ADC_HandleTypeDef *psADC, uint32_t dwTrigger)
+{
+    ADC_ChannelConfTypeDef sChannel = {0};
+
+    psADC->Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV2;
+    psADC->Init.Resolution            = ADC_RESOLUTION_12B;
+    psADC->Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    psADC->Init.ScanConvMode          = DISABLE;
+    psADC->Init.EOCSelection          = ADC_EOC_SINGLE_CONV;
+    psADC->Init.ContinuousConvMode    = DISABLE;
+    psADC->Init.NbrOfConversion       = 1;
+    psADC->Init.DiscontinuousConvMode = DISABLE;
+    psADC->Init.NbrOfDiscConversion   = 0;
+    psADC->Init.ExternalTrigConv      = ADC_TIM_TRIGGER;
+    psADC->Init.ExternalTrigConvEdge  = dwTrigger;
+    psADC->Init.DMAContinuousRequests = ENABLE;
+    if (HAL_ADC_Init(psADC) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    // The shortest sampling time, the source must settle a 4 pF sampling capacitor in 100 ns
+    sChannel.Channel      = SAMPLER_CHANNEL;
+    sChannel.Rank         = 1;
+    sChannel.SamplingTime = ADC_SAMPLETIME_3CYCLES;
+
+    return HAL_ADC_ConfigChannel(psADC, &sChannel);
+}
+
+/**
+ * @brief Set the trigger timer to the nearest rate it can make
+ * @param dwTriggers - Triggers per second
+ * @retval Triggers per second the timer makes
+ */
+static uint32_t SAMPLER_SetTrigger(uint32_t dwTriggers)
+{
+#ifdef NHNS_HOST
+    HAL_HOST_ADC_SetTriggerRate(gsSampler.asADC[0].Instance, dwTriggers);
+
+    return dwTriggers;
+#else
+    TIM_MasterConfigTypeDef sMaster = {0};
+    uint32_t dwTimerClock           = HAL_RCC_GetPCLK1Freq();
+    uint32_t dwTicks                = 0;
+    uint32_t dwPrescaler            = 0;
+    uint32_t dwPeriod               = 0;
+
+    // 1) APB1 timers are clocked at twice PCLK1 whenever the bus is divided
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        dwTimerClock *= 2;
+    }
+
+    // 2) The smallest prescaler that fits the period in 16 bits keeps the rate closest
+    dwTicks     = (dwTimerClock + dwTriggers / 2) / dwTriggers;
+    dwPrescaler = dwTicks / 0x10000U + 1;
+    dwPeriod    = (dwTicks + dwPrescaler / 2) / dwPrescaler;
+
+    // 3) An update event on TRGO per period
+    gsSampler.sTimer.Instance               = ADC_TIM;
+    gsSampler.sTimer.Init.Prescaler         = dwPrescaler - 1;
+    gsSampler.sTimer.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    gsSampler.sTimer.Init.Period            = dwPeriod - 1;
+    gsSampler.sTimer.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    gsSampler.sTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&gsSampler.sTimer) != HAL_OK)
+    {
+        return 0;
+    }
+    sMaster.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMaster.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(&gsSampler.sTimer, &sMaster) != HAL_OK)
+    {
+        return 0;
+    }
+
+    return dwTimerClock / (dwPrescaler * dwPeriod);
+#endif
+}
+
+/**
+ * @brief Start the stream at the first half, the ADCs then convert on the next trigger
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef SAMPLER_StartStream(void)
+{
+    if (gsSampler.nMode == SAMPLER_MODE_TRIPLE)
+    {
+        return HAL_ADCEx_MultiModeStart_DMA(&gsSampler.asADC[0], gadwSamplerBuffer,
+                                            sizeof(gadwSamplerBuffer) / sizeof(uint32_t));
+    }
+
+    return HAL_ADC_Start_DMA(&gsSampler.asADC[0], gadwSamplerBuffer, sizeof(gadwSamplerBuffer) / sizeof(uint16_t));
+}
+
+/**
+ * @brief Stop the stream and clear the overrun and error states that would keep it from starting again
+ */
+static void SAMPLER_StopStream(void)
+{
+    if (gsSampler.nMode == SAMPLER_MODE_TRIPLE)
+    {
+        HAL_ADCEx_MultiModeStop_DMA(&gsSampler.asADC[0]);
+        __HAL_ADC_CLEAR_FLAG(&gsSampler.asADC[1], ADC_FLAG_OVR);
+        __HAL_ADC_CLEAR_FLAG(&gsSampler.asADC[2], ADC_FLAG_OVR);
+    }
+    else
+    {
+        HAL_ADC_Stop_DMA(&gsSampler.asADC[0]);
+    }
+    __HAL_ADC_CLEAR_FLAG(&gsSampler.asADC[0], ADC_FLAG_OVR);
+    gsSampler.asADC[0].State &= ~(HAL_ADC_STATE_ERROR_DMA | HAL_ADC_STATE_ERROR_INTERNAL);
+}
+
+/**
+ * @brief The stream starts writing a half, whatever is in it now is lost
+ * @param dwHalf - 0 or 1
+ * @note Called from the interrupt, or in a critical section
+ */
+static void SAMPLER_Overwrite(uint32_t dwHalf)
+{
+    if (gsSampler.anHalf[dwHalf] == SAMPLER_HALF_FREE || gsSampler.afOverwritten[dwHalf])
+    {
+        return;
+    }
+
+    // A queued block is counted as dropped when SAMPLER_Receive skips it
+    gsSampler.afOverwritten[dwHalf] = true;
+    if (gsSampler.anHalf[dwHalf] == SAMPLER_HALF_HELD)
+    {
+        gsSampler.sStats.dwLate++;
+    }
+}
+
+/**
+ * @brief A half is full, hand it to the task
+ * @param dwHalf - 0 or 1
+ */
+static void SAMPLER_Filled(uint32_t dwHalf)
+{
+    sampler_block_t sBlock = {0};
+    BaseType_t xWoken      = pdFALSE;
+
+    PROFILER_SCOPE(PROFILER_PROBE_SAMPLER_ISR);
+
+    // 1) The stream has moved on to the other half
+    SAMPLER_Overwrite(dwHalf ^ 1U);
+
+    // 2) This one goes to the task, unless it never gave back the previous block in it
+    if (gsSampler.anHalf[dwHalf] == SAMPLER_HALF_FREE)
+    {
+        sBlock.pwSamples   = SAMPLER_Half(dwHalf);
+        sBlock.dwCount     = SAMPLER_BLOCK_SAMPLES;
+        sBlock.dwSequence  = gsSampler.dwSequence;
+        sBlock.qwTimestamp = CLOCK_GetMicros();
+
+        gsSampler.anHalf[dwHalf] = SAMPLER_HALF_QUEUED;
+        xQueueSendToBackFromISR(gsSampler.xQueue, &sBlock, &xWoken);
+        gsSampler.sStats.dwBlocks++;
+    }
+    else
+    {
+        gsSampler.sStats.dwDropped++;
+    }
+    gsSampler.dwSequence++;
+
+    portYIELD_FROM_ISR(xWoken);
+}
+
+/**
+ * @brief Start over from the first half after an overrun or a DMA error
+ * @note Called from the interrupt. The trigger keeps running
+ */
+static void SAMPLER_Restart(void)
+{
+    SAMPLER_StopStream();
+    SAMPLER_Overwrite(0);
+    if (SAMPLER_StartStream() != HAL_OK)
+    {
+        gsSampler.sStats.dwErrors++;
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t SAMPLER_Init(void)
+{
+    static ADC_TypeDef *const apsInstances[SAMPLER_ADC_COUNT] = {ADC1, ADC2, ADC3};
+
+    // 1) Check if module is already initialized
+    if (gsSampler.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    gsSampler.xQueue = RTOS_QUEUE_CREATE(sampler);
+
+    // 2) ADC1 waits for the trigger, ADC2 and ADC3 only ever convert as its slaves
+    for (uint32_t dwIndex = 0; dwIndex < SAMPLER_ADC_COUNT; dwIndex++)
+    {
+        gsSampler.asADC[dwIndex].Instance = apsInstances[dwIndex];
+        if (SAMPLER_ConfigADC(&gsSampler.asADC[dwIndex],
+                              (dwIndex == 0) ? ADC_EXTERNALTRIGCONVEDGE_RISING : ADC_EXTERNALTRIGCONVEDGE_NONE) != HAL_OK)
+        {
+            return NHNS_STATUS_FAIL;
+        }
+    }
+
+    // 3) Peripheral to memory in circular mode, the widths are set by SAMPLER_Start
+    gsSampler.sDMAHandle.Instance           = SAMPLER_DMA_STREAM;
+    gsSampler.sDMAHandle.Init.Channel       = SAMPLER_DMA_CHANNEL;
+    gsSampler.sDMAHandle.Init.Direction     = DMA_PERIPH_TO_MEMORY;
+    gsSampler.sDMAHandle.Init.PeriphInc     = DMA_PINC_DISABLE;
+    gsSampler.sDMAHandle.Init.MemInc        = DMA_MINC_ENABLE;
+    gsSampler.sDMAHandle.Init.Mode          = DMA_CIRCULAR;
+    gsSampler.sDMAHandle.Init.Priority      = DMA_PRIORITY_HIGH;
+    gsSampler.sDMAHandle.Init.FIFOMode      = DMA_FIFOMODE_DISABLE;
+    gsSampler.sDMAHandle.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    gsSampler.sDMAHandle.Init.MemBurst      = DMA_MBURST_SINGLE;
+    gsSampler.sDMAHandle.Init.PeriphBurst   = DMA_PBURST_SINGLE;
+    __HAL_LINKDMA(&gsSampler.asADC[0], DMA_Handle, gsSampler.sDMAHandle);
+
+    gsSampler.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SAMPLER_Start(sampler_mode_t nMode, uint32_t dwRate)
+{
+    ADC_MultiModeTypeDef sMulti = {0};
+    uint32_t dwConversions      = (nMode == SAMPLER_MODE_TRIPLE) ? SAMPLER_ADC_COUNT : 1;
+    uint32_t dwTriggers         = 0;
+
+    // 1) Verify arguments
+    if ((nMode != SAMPLER_MODE_SINGLE && nMode != SAMPLER_MODE_TRIPLE) || dwRate < dwConversions ||
+        dwRate > ((nMode == SAMPLER_MODE_TRIPLE) ? SAMPLER_MAX_RATE_TRIPLE : SAMPLER_MAX_RATE_SINGLE))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsSampler.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    if (gsSampler.fRunning)
+    {
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 3) Blocks left from the previous run are gone, held ones stay with the task
+    xQueueReset(gsSampler.xQueue);
+    taskENTER_CRITICAL();
+    for (uint32_t dwHalf = 0; dwHalf < SAMPLER_HALVES; dwHalf++)
+    {
+        if (gsSampler.anHalf[dwHalf] == SAMPLER_HALF_QUEUED)
+        {
+            gsSampler.anHalf[dwHalf]        = SAMPLER_HALF_FREE;
+            gsSampler.afOverwritten[dwHalf] = false;
+        }
+    }
+    gsSampler.dwSequence = 0;
+    taskEXIT_CRITICAL();
+
+    // 4) Halfwords from ADC1, or words from the common data register holding two results
+    gsSampler.nMode = nMode;
+
+    gsSampler.sDMAHandle.Init.PeriphDataAlignment = (nMode == SAMPLER_MODE_TRIPLE) ? DMA_PDATAALIGN_WORD : DMA_PDATAALIGN_HALFWORD;
+    gsSampler.sDMAHandle.Init.MemDataAlignment    = (nMode == SAMPLER_MODE_TRIPLE) ? DMA_MDATAALIGN_WORD : DMA_MDATAALIGN_HALFWORD;
+    HAL_DMA_DeInit(&gsSampler.sDMAHandle);
+    if (HAL_DMA_Init(&gsSampler.sDMAHandle) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 5) The multi mode is set with the ADCs off, the slaves are then powered up to follow ADC1
+    sMulti.Mode             = (nMode == SAMPLER_MODE_TRIPLE) ? ADC_TRIPLEMODE_INTERL : ADC_MODE_INDEPENDENT;
+    sMulti.DMAAccessMode    = (nMode == SAMPLER_MODE_TRIPLE) ? ADC_DMAACCESSMODE_2 : ADC_DMAACCESSMODE_DISABLED;
+    sMulti.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES;
+    if (HAL_ADCEx_MultiModeConfigChannel(&gsSampler.asADC[0], &sMulti) != HAL_OK)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+    if (nMode == SAMPLER_MODE_TRIPLE &&
+        (HAL_ADC_Start(&gsSampler.asADC[1]) != HAL_OK || HAL_ADC_Start(&gsSampler.asADC[2]) != HAL_OK))
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 6) Each trigger starts one conversion per ADC
+    dwTriggers = SAMPLER_SetTrigger(dwRate / dwConversions);
+    if (dwTriggers == 0)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 7) Stream first, then the trigger
+    LOWPOWER_Lock();
+    gsSampler.fRunning = true;
+    if (SAMPLER_StartStream() != HAL_OK)
+    {
+        gsSampler.fRunning = false;
+        LOWPOWER_Unlock();
+        return NHNS_STATUS_FAIL;
+    }
+#ifndef NHNS_HOST
+    HAL_TIM_Base_Start(&gsSampler.sTimer);
+#endif
+
+    taskENTER_CRITICAL();
+    gsSampler.sStats.dwRate = dwTriggers * dwConversions;
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SAMPLER_Stop(void)
+{
+    // 1) Check if module is initialized
+    if (!gsSampler.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    if (!gsSampler.fRunning)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Trigger first, so no conversion is left without a stream to take it
+#ifndef NHNS_HOST
+    HAL_TIM_Base_Stop(&gsSampler.sTimer);
+#endif
+    taskENTER_CRITICAL();
+    SAMPLER_StopStream();
+    gsSampler.fRunning      = false;
+    gsSampler.sStats.dwRate = 0;
+    taskEXIT_CRITICAL();
+    if (gsSampler.nMode == SAMPLER_MODE_TRIPLE)
+    {
+        HAL_ADC_Stop(&gsSampler.asADC[1]);
+        HAL_ADC_Stop(&gsSampler.asADC[2]);
+    }
+    LOWPOWER_Unlock();
+
+    // 3) Nobody will take the queued blocks now
+    xQueueReset(gsSampler.xQueue);
+    taskENTER_CRITICAL();
+    for (uint32_t dwHalf = 0; dwHalf < SAMPLER_HALVES; dwHalf++)
+    {
+        if (gsSampler.anHalf[dwHalf] == SAMPLER_HALF_QUEUED)
+        {
+            gsSampler.anHalf[dwHalf]        = SAMPLER_HALF_FREE;
+            gsSampler.afOverwritten[dwHalf] = false;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SAMPLER_Receive(sampler_block_t *psBlock, uint32_t dwTimeoutMs)
+{
+    TickType_t xTimeout = (dwTimeoutMs == SAMPLER_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(dwTimeoutMs);
+    uint32_t dwHalf     = 0;
+    bool fStale         = true;
+
+    // 1) Verify argument
+    if (psBlock == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsSampler.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Wait for a block the stream has not come back to yet
+    while (fStale)
+    {
+        if (xQueueReceive(gsSampler.xQueue, psBlock, xTimeout) != pdTRUE)
+        {
+            return NHNS_STATUS_TIMEOUT;
+        }
+        dwHalf = (psBlock->pwSamples == SAMPLER_Half(0)) ? 0 : 1;
+
+        taskENTER_CRITICAL();
+        fStale = gsSampler.afOverwritten[dwHalf];
+        if (fStale)
+        {
+            gsSampler.anHalf[dwHalf]        = SAMPLER_HALF_FREE;
+            gsSampler.afOverwritten[dwHalf] = false;
+            gsSampler.sStats.dwDropped++;
+        }
+        else
+        {
+            gsSampler.anHalf[dwHalf] = SAMPLER_HALF_HELD;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SAMPLER_Release(const uint16_t *pwSamples)
+{
+    uint32_t dwHalf    = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify argument
+    if (pwSamples == SAMPLER_Half(0))
+    {
+        dwHalf = 0;
+    }
+    else if (pwSamples == SAMPLER_Half(1))
+    {
+        dwHalf = 1;
+    }
+    else
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Give it back, telling whether the stream got there first
+    taskENTER_CRITICAL();
+    if (gsSampler.anHalf[dwHalf] != SAMPLER_HALF_HELD)
+    {
+        nRet = NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    else
+    {
+        nRet = gsSampler.afOverwritten[dwHalf] ? NHNS_STATUS_BAD_DATA : NHNS_STATUS_OK;
+
+        gsSampler.anHalf[dwHalf]        = SAMPLER_HALF_FREE;
+        gsSampler.afOverwritten[dwHalf] = false;
+    }
+    taskEXIT_CRITICAL();
+
+    return nRet;
+}
+
+nhns_status_t SAMPLER_GetStats(sampler_stats_t *psStats)
+{
+    // 1) Verify arguments
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsSampler.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) The interrupt updates the counters too
+    taskENTER_CRITICAL();
+    *psStats = gsSampler.sStats;
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SAMPLER_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    sampler_stats_t sStats;
+    char szLine[SAMPLER_LINE_SIZE];
+    int nLength = 0;
+
+    nRet = SAMPLER_GetStats(&sStats);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    nLength = (sStats.dwRate != 0)
+                  ? snprintf(szLine, sizeof(szLine), "sampler: %s mode at %lu S/s\r\n",
+                             (gsSampler.nMode == SAMPLER_MODE_TRIPLE) ? "triple" : "single", (unsigned long)sStats.dwRate)
+                  : snprintf(szLine, sizeof(szLine), "sampler: stopped\r\n");
+    nRet    = UART_PrintLine(nID, szLine, nLength, SAMPLER_LINE_SIZE);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "%lu blocks, %lu dropped, %lu late, %lu overruns, %lu errors\r\n",
+                           (unsigned long)sStats.dwBlocks, (unsigned long)sStats.dwDropped,
+                           (unsigned long)sStats.dwLate, (unsigned long)sStats.dwOverruns,
+                           (unsigned long)sStats.dwErrors);
+        nRet    = UART_PrintLine(nID, szLine, nLength, SAMPLER_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t SAMPLER_Benchmark(uart_instance_t nID)
+{
+    sampler_stats_t sBefore;
+    sampler_stats_t sAfter;
+    sampler_block_t sBlock;
+    uint64_t qwStart   = 0;
+    uint64_t qwLatency = 0;
+    uint64_t qwSum     = 0;
+    uint32_t dwMaxWait = 0;
+    uint32_t dwMin     = 0;
+    uint32_t dwMax     = 0;
+    uint32_t dwSeen    = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    char szLine[SAMPLER_LINE_SIZE];
+    int nLength = 0;
+
+    for (uint32_t dwRun = 0; dwRun < sizeof(gasSamplerBench) / sizeof(gasSamplerBench[0]) && nRet == NHNS_STATUS_OK;
+         dwRun++)
+    {
+        // 1) Counters before the run, the difference is what this run did
+        nRet = SAMPLER_GetStats(&sBefore);
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = SAMPLER_Start(gasSamplerBench[dwRun].nMode, gasSamplerBench[dwRun].dwRate);
+        }
+        if (nRet != NHNS_STATUS_OK)
+        {
+            break;
+        }
+
+        // 2) Process every block as it comes: how long it waited for the task, and its range and mean
+        qwLatency = 0;
+        qwSum     = 0;
+        dwMaxWait = 0;
+        dwMin     = 0xFFFF;
+        dwMax     = 0;
+        dwSeen    = 0;
+        qwStart   = CLOCK_GetMicros();
+        while (CLOCK_GetMicros() - qwStart < SAMPLER_BENCH_MS * 1000ULL &&
+               SAMPLER_Receive(&sBlock, SAMPLER_BENCH_WAIT) == NHNS_STATUS_OK)
+        {
+            uint32_t dwWait = (uint32_t)(CLOCK_GetMicros() - sBlock.qwTimestamp);
+
+            qwLatency += dwWait;
+            if (dwWait > dwMaxWait)
+            {
+                dwMaxWait = dwWait;
+            }
+            for (uint32_t dwIndex = 0; dwIndex < sBlock.dwCount; dwIndex++)
+            {
+                uint32_t dwSample = sBlock.pwSamples[dwIndex];
+
+                qwSum += dwSample;
+                dwMin = (dwSample < dwMin) ? dwSample : dwMin;
+                dwMax = (dwSample > dwMax) ? dwSample : dwMax;
+            }
+            SAMPLER_Release(sBlock.pwSamples);
+            dwSeen++;
+        }
+        SAMPLER_GetStats(&sAfter);
+        SAMPLER_Stop();
+
+        // 3) One line per run
+        nLength = snprintf(szLine, sizeof(szLine), "sampler %s %7lu S/s: %5lu blocks %4lu dropped %4lu late %4lu overruns\r\n",
+                           (gasSamplerBench[dwRun].nMode == SAMPLER_MODE_TRIPLE) ? "triple" : "single",
+                           (unsigned long)sAfter.dwRate, (unsigned long)(sAfter.dwBlocks - sBefore.dwBlocks),
+                           (unsigned long)(sAfter.dwDropped - sBefore.dwDropped),
+                           (unsigned long)(sAfter.dwLate - sBefore.dwLate),
+                           (unsigned long)(sAfter.dwOverruns - sBefore.dwOverruns));
+        nRet    = UART_PrintLine(nID, szLine, nLength, SAMPLER_LINE_SIZE);
+        if (nRet == NHNS_STATUS_OK && dwSeen != 0)
+        {
+            nLength = snprintf(szLine, sizeof(szLine), "  handoff %lu us avg %lu us max, samples %lu to %lu mean %lu\r\n",
+                               (unsigned long)(qwLatency / dwSeen), (unsigned long)dwMaxWait, (unsigned long)dwMin,
+                               (unsigned long)dwMax, (unsigned long)(qwSum / ((uint64_t)dwSeen * SAMPLER_BLOCK_SAMPLES)));
+            nRet    = UART_PrintLine(nID, szLine, nLength, SAMPLER_LINE_SIZE);
+        }
+    }
+
+    return nRet;
+}
+
+void SAMPLER_IRQHandler(void)
+{
+    HAL_ADC_IRQHandler(&gsSampler.asADC[0]);
+}
+
+void SAMPLER_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&gsSampler.sDMAHandle);
+}
+
+// --- HAL Callbacks ---
+
+/**
+ * @brief The stream has filled the first half and goes on with the second
+ * @param hadc - ADC handle pointer
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == &gsSampler.asADC[0] && gsSampler.fRunning)
+    {
+        SAMPLER_Filled(0);
+    }
+}
+
+/**
+ * @brief The stream has filled the second half and wraps to the first
+ * @param hadc - ADC handle pointer
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == &gsSampler.asADC[0] && gsSampler.fRunning)
+    {
+        SAMPLER_Filled(1);
+    }
+}
+
+/**
+ * @brief Overrun or DMA error, either way the stream has stopped: count it and start again
+ * @param hadc - ADC handle pointer
+ */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc != &gsSampler.asADC[0] || !gsSampler.fRunning)
+    {
+        return;
+    }
+
+    if ((hadc->ErrorCode & HAL_ADC_ERROR_OVR) != 0)
+    {
+        gsSampler.sStats.dwOverruns++;
+    }
+    else
+    {
+        gsSampler.sStats.dwErrors++;
+    }
+    SAMPLER_Restart();
+}
@@ -0,0 +1,141 @@
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Continuous acquisition on the SAMPLER pin. The TRGO of ADC_TIM starts the
+ * conversions and a DMA2 stream in circular mode writes the results to a
+ * buffer of two blocks in SRAM2. The half and full transfer interrupts hand
+ * the block just filled to the processing task in place: SAMPLER_Receive
+ * returns a pointer into the DMA buffer, and the task gives the block back
+ * with SAMPLER_Release before the stream comes round to it again, one block
+ * time later.
+ *
+ * Single mode converts with ADC1 alone, up to 2 MSPS at 3 + 12 cycles of the
+ * 30 MHz ADC clock. Triple mode interleaves ADC1, ADC2 and ADC3 five ADC
+ * clocks apart after each trigger, up to 6 MSPS. Triple mode samples are
+ * evenly spaced only at 6 MSPS, below that they come in groups of three.
+ *
+ * A block that fills a half the task has not released yet is dropped, and so
+ * is a queued block the stream overwrites before
+ * SAMPLER_Receive takes it. A held block the stream overwrites is reported by
+ * SAMPLER_Release. An ADC overrun or a DMA error stops the stream; the
+ * interrupt counts it and restarts the acquisition from the first half.
+ */
+
+#define SAMPLER_BLOCK_SAMPLES   1024       // Per half of the DMA buffer, even
+#define SAMPLER_MAX_RATE_SINGLE 2000000    // Samples per second
+#define SAMPLER_MAX_RATE_TRIPLE 6000000
+
+// SAMPLER_Receive timeout that waits until a block arrives
+#define SAMPLER_WAIT_FOREVER    0xFFFFFFFFUL
+
+// --- Types ---
+
+typedef enum sampler_mode
+{
+    SAMPLER_MODE_SINGLE = 0,    // ADC1 alone
+    SAMPLER_MODE_TRIPLE,        // ADC1 to ADC3 interleaved, results packed in pairs by DMA mode 2
+} sampler_mode_t;
+
+typedef struct sampler_block
+{
+    const uint16_t *pwSamples;    // 12-bit right-aligned, oldest first, loaned until SAMPLER_Release
+    uint32_t dwCount;             // SAMPLER_BLOCK_SAMPLES
+    uint32_t dwSequence;          // Blocks filled since SAMPLER_Start, a gap means lost blocks
+    uint64_t qwTimestamp;         // CLOCK_GetMicros when the last sample landed
+} sampler_block_t;
+
+typedef struct sampler_stats
+{
+    uint32_t dwRate;        // Samples per second of the acquisition, 0 when stopped
+    uint32_t dwBlocks;      // Blocks handed to SAMPLER_Receive
+    uint32_t dwDropped;     // Blocks the task never saw, it kept their half too long
+    uint32_t dwLate;        // Blocks the stream overwrote while the task held them
+    uint32_t dwOverruns;    // ADC overruns, the DMA missed a conversion
+    uint32_t dwErrors;      // DMA errors and failed restarts
+} sampler_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Create the block queue and configure the three ADCs
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SAMPLER_Init(void);
+
+/**
+ * @brief Start the acquisition
+ * @param nMode - ADC1 alone or the three ADCs interleaved
+ * @param dwRate - Samples per second, up to SAMPLER_MAX_RATE_SINGLE or SAMPLER_MAX_RATE_TRIPLE
+ * @retval Status code indicating operation success or reason for failure
+ * @note The trigger timer rounds the rate, SAMPLER_GetStats gives the one in use.
+ *       NHNS_STATUS_BUSY if already running. Holds LOWPOWER_Lock() until SAMPLER_Stop
+ */
+nhns_status_t SAMPLER_Start(sampler_mode_t nMode, uint32_t dwRate);
+
+/**
+ * @brief Stop the acquisition and discard the blocks waiting for SAMPLER_Receive
+ * @retval Status code indicating operation success or reason for failure
+ * @note Blocks held by the task stay valid until they are released
+ */
+nhns_status_t SAMPLER_Stop(void);
+
+/**
+ * @brief Wait for the next block
+ * @param psBlock - Receives the block, its samples are loaned until SAMPLER_Release
+ * @param dwTimeoutMs - Time to wait in milliseconds, SAMPLER_WAIT_FOREVER to block
+ * @retval Status code indicating operation success or reason for failure
+ * @note Callable from one task at a time. Blocks overwritten in the queue are skipped
+ *       and counted as dropped, each skip starts the timeout over
+ */
+nhns_status_t SAMPLER_Receive(sampler_block_t *psBlock, uint32_t dwTimeoutMs);
+
+/**
+ * @brief Give a block back to the stream
+ * @param pwSamples - Samples from SAMPLER_Receive
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BAD_DATA when the stream overwrote the block before it was released,
+ *       whatever was computed from it is not to be trusted
+ */
+nhns_status_t SAMPLER_Release(const uint16_t *pwSamples);
+
+/**
+ * @brief Get the acquisition counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SAMPLER_GetStats(sampler_stats_t *psStats);
+
+/**
+ * @brief Print the acquisition counters
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SAMPLER_Dump(uart_instance_t nID);
+
+/**
+ * @brief Acquire for a second at each of several rates up to 6 MSPS and print what the calling task kept up with
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note The caller is the processing task: it takes the minimum, maximum and mean of every block.
+ *       NHNS_STATUS_BUSY if an acquisition is already running
+ */
+nhns_status_t SAMPLER_Benchmark(uart_instance_t nID);
+
+/**
+ * @brief ADC interrupt, call from SAMPLER_IRQn
+ */
+void SAMPLER_IRQHandler(void);
+
+/**
+ * @brief DMA2 stream interrupt, call from SAMPLER_DMA_IRQn
+ */
+void SAMPLER_DMA_IRQHandler(void);
+
+#endif    // __SAMPLER_H__
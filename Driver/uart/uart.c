@@ -1,11 +1,29 @@
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 #include "uart.h"
+#include "completion.h"
+#include "lowpower.h"
+#include "profiler.h"
+#include "ringbuf.h"
+#include "rtos.h"
 #include "board.h"
 #include "stm32f2xx_hal.h"
 
 // --- Definitions ---
 
-#define UART_RX_TX_TIMEOUT 5000
+#define UART_RX_TX_TIMEOUT 5000    // Milliseconds without progress
+
+#define UART_LINE_SIZE 128
+
+#ifdef FW_DEBUG
+// UART_Benchmark: producer tasks, lines each, and the ring exercised on its own
+#define UART_BENCH_PRODUCERS  3    // One RTOS_TASK_DEFINE each below
+#define UART_BENCH_LINES      16
+#define UART_BENCH_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+#define UART_CHECK_RING_SIZE  16
+#define UART_CHECK_ROUNDS     200
+#endif
 
 #define UART_CHECK_RETURN(nRet)     \
     do                              \
@@ -31,12 +49,220 @@ typedef struct uart_context
 {
     bool fInitDone;
     UART_HandleTypeDef sUARTHandle;
+    DMA_HandleTypeDef sTxDMAHandle;
+    DMA_HandleTypeDef sRxDMAHandle;
+
+    // Tasks fill the TX ring under a critical section, the DMA drains one contiguous run at a time
+    ringbuf_t sTxRing;
+    volatile uint16_t bTxInFlight;
+    volatile uint32_t dwTxQueued;    // Bytes written to the TX ring
+    volatile uint32_t dwTxDone;      // Bytes sent or dropped from it
+    volatile bool fTxDirect;    // UART_Transmit has the DMA on its own buffer
+    completion_t sTxDone;       // Signalled as each run or direct transfer finishes
+    uint8_t abTxBuffer[UART_TX_RING_SIZE];
+
+    // The DMA fills abRxDMABuffer circularly, the ISR moves new bytes into the RX ring
+    ringbuf_t sRxRing;
+    uint16_t bRxDMAPos;
+    completion_t sRxDone;       // Signalled as bytes arrive, UART_Receive waits on it
+    uint8_t abRxBuffer[UART_RX_RING_SIZE];
+    uint8_t abRxDMABuffer[UART_RX_DMA_SIZE];
 } uart_context_t;
 
+#ifdef FW_DEBUG
+typedef struct uart_bench
+{
+    bool fCreated;
+    uart_instance_t nID;
+    SemaphoreHandle_t xDone;    // Given by each producer at the end of its lines
+    TaskHandle_t axProducers[UART_BENCH_PRODUCERS];
+    uint32_t dwRetries;         // NHNS_STATUS_NO_MEMORY results, only accessed through atomics
+} uart_bench_t;
+#endif
+
 // --- Global Variables ---
 
 uart_context_t gsCntxt[UART_INSTANCE_MAX] = {0};
 
+#ifdef FW_DEBUG
+static uart_bench_t gsBench = {0};
+
+RTOS_TASK_DEFINE(uart_bench0, UART_BENCH_STACK_SIZE);
+RTOS_TASK_DEFINE(uart_bench1, UART_BENCH_STACK_SIZE);
+RTOS_TASK_DEFINE(uart_bench2, UART_BENCH_STACK_SIZE);
+RTOS_SEMAPHORE_DEFINE(uart_bench);
+#endif
+
+// --- Static Functions ---
+
+/**
+ * @brief Find the context owning a HAL handle
+ * @param huart - UART handle pointer
+ * @retval Matching context, NULL if the handle is not ours
+ */
+static uart_context_t *UART_GetContext(UART_HandleTypeDef *huart)
+{
+    for (int nID = 0; nID < UART_INSTANCE_MAX; nID++)
+    {
+        if (&gsCntxt[nID].sUARTHandle == huart)
+        {
+            return &gsCntxt[nID];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Hand the oldest contiguous run of the TX ring to the DMA if it is idle
+ * @param psCntxt - UART context
+ * @note Call from the UART interrupts or inside taskENTER_CRITICAL, so the check and the claim of bTxInFlight are one step
+ */
+static void UART_StartTx(uart_context_t *psCntxt)
+{
+    uint8_t *pData    = NULL;
+    uint32_t dwLength = 0;
+
+    // 1) Only one run in flight at a time, and none while UART_Transmit has the DMA
+    if (psCntxt->bTxInFlight != 0 || psCntxt->fTxDirect)
+    {
+        return;
+    }
+
+    // 2) Get the next contiguous run
+    dwLength = RINGBUF_PeekContiguous(&psCntxt->sTxRing, &pData);
+    if (dwLength == 0)
+    {
+        return;
+    }
+
+    // 3) Start the transfer, STOP would freeze it
+    psCntxt->bTxInFlight = (uint16_t)dwLength;
+    LOWPOWER_Lock();
+    if (HAL_UART_Transmit_DMA(&psCntxt->sUARTHandle, pData, (uint16_t)dwLength) != HAL_OK)
+    {
+        psCntxt->bTxInFlight = 0;
+        LOWPOWER_Unlock();
+    }
+}
+
+/**
+ * @brief Start circular DMA reception with idle-line detection
+ * @param psCntxt - UART context
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t UART_StartRx(uart_context_t *psCntxt)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    psCntxt->bRxDMAPos = 0;
+    nHalRet            = HAL_UARTEx_ReceiveToIdle_DMA(&psCntxt->sUARTHandle, psCntxt->abRxDMABuffer, UART_RX_DMA_SIZE);
+    UART_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+#ifdef FW_DEBUG
+/**
+ * @brief Run a small ring through every wrap position the way the UART uses it, and check what comes out
+ * @retval true if every byte came out once and in order, and Used and Free always added up to the size
+ */
+static bool UART_CheckRing(void)
+{
+    uint8_t abStorage[UART_CHECK_RING_SIZE];
+    uint8_t abData[UART_CHECK_RING_SIZE];
+    ringbuf_t sRing;
+    uint8_t *pData     = NULL;
+    uint32_t dwWritten = 0;    // Bytes in, the pattern is the running count
+    uint32_t dwRead    = 0;    // Bytes out
+    uint32_t dwLength  = 0;
+    uint32_t dwExpect  = 0;
+
+    RINGBUF_Init(&sRing, abStorage, sizeof(abStorage));
+
+    for (uint32_t dwRound = 0; dwRound < UART_CHECK_ROUNDS; dwRound++)
+    {
+        // 1) Producer: lengths from 0 to the full size, so the ring fills up now and then and writes get cut short
+        dwLength = (dwRound * 5) % (UART_CHECK_RING_SIZE + 1);
+        dwExpect = (dwLength < RINGBUF_Free(&sRing)) ? dwLength : RINGBUF_Free(&sRing);
+        for (uint32_t dwIndex = 0; dwIndex < dwLength; dwIndex++)
+        {
+            abData[dwIndex] = (uint8_t)(dwWritten + dwIndex);
+        }
+        if (RINGBUF_Write(&sRing, abData, dwLength) != dwExpect)
+        {
+            return false;
+        }
+        dwWritten += dwExpect;
+
+        // 2) DMA side: peek the oldest run, check it stays inside the storage, release part of it
+        dwLength = RINGBUF_PeekContiguous(&sRing, &pData);
+        if (dwLength > RINGBUF_Used(&sRing) || (dwLength != 0 && pData + dwLength > abStorage + sizeof(abStorage)))
+        {
+            return false;
+        }
+        dwLength = (dwLength + 1) / 2;
+        for (uint32_t dwIndex = 0; dwIndex < dwLength; dwIndex++)
+        {
+            if (pData[dwIndex] != (uint8_t)(dwRead + dwIndex))
+            {
+                return false;
+            }
+        }
+        RINGBUF_Consume(&sRing, dwLength);
+        dwRead += dwLength;
+
+        // 3) Reader side: copy out a few more, across the wrap when there is one
+        dwLength = RINGBUF_Read(&sRing, abData, dwRound % 7);
+        for (uint32_t dwIndex = 0; dwIndex < dwLength; dwIndex++)
+        {
+            if (abData[dwIndex] != (uint8_t)(dwRead + dwIndex))
+            {
+                return false;
+            }
+        }
+        dwRead += dwLength;
+
+        if (RINGBUF_Used(&sRing) != dwWritten - dwRead ||
+            RINGBUF_Used(&sRing) + RINGBUF_Free(&sRing) != UART_CHECK_RING_SIZE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Benchmark producer, queues its lines each time UART_Benchmark notifies it
+ * @param pvParameters - Producer number
+ */
+static void UART_BenchTask(void *pvParameters)
+{
+    uint32_t dwProducer = (uint32_t)(uintptr_t)pvParameters;
+    char szLine[UART_LINE_SIZE];
+    int nLength = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        for (uint32_t dwLine = 0; dwLine < UART_BENCH_LINES; dwLine++)
+        {
+            nLength = snprintf(szLine, sizeof(szLine), "uart: producer %lu line %lu of %u\r\n",
+                               (unsigned long)dwProducer, (unsigned long)dwLine + 1, UART_BENCH_LINES);
+            while (UART_TransmitAsync(gsBench.nID, (const uint8_t *)szLine, (uint16_t)nLength) == NHNS_STATUS_NO_MEMORY)
+            {
+                __atomic_add_fetch(&gsBench.dwRetries, 1, __ATOMIC_RELAXED);
+                vTaskDelay(1);
+            }
+        }
+
+        xSemaphoreGive(gsBench.xDone);
+    }
+}
+#endif
+
 // --- Functions ---
 
 nhns_status_t UART_Init(uart_instance_t nID)
@@ -69,11 +295,24 @@ nhns_status_t UART_Init(uart_instance_t nID)
         gsCntxt[nID].sUARTHandle.Init.OverSampling = UART_OVERSAMPLING_16;
     }
 
-    // 4) Initialize UART
+    // 4) Prepare the rings and link the DMA handles, the board MSP configures the streams
+    RINGBUF_Init(&gsCntxt[nID].sTxRing, gsCntxt[nID].abTxBuffer, UART_TX_RING_SIZE);
+    RINGBUF_Init(&gsCntxt[nID].sRxRing, gsCntxt[nID].abRxBuffer, UART_RX_RING_SIZE);
+    gsCntxt[nID].bTxInFlight = 0;
+    gsCntxt[nID].dwTxQueued  = 0;
+    gsCntxt[nID].dwTxDone    = 0;
+    __HAL_LINKDMA(&gsCntxt[nID].sUARTHandle, hdmatx, gsCntxt[nID].sTxDMAHandle);
+    __HAL_LINKDMA(&gsCntxt[nID].sUARTHandle, hdmarx, gsCntxt[nID].sRxDMAHandle);
+
+    // 5) Initialize UART
     nHalRet = HAL_UART_Init(&gsCntxt[nID].sUARTHandle);
     UART_CHECK_HAL_RETURN(nHalRet);
 
-    // 5) Mark as initialized
+    // 6) Start background reception
+    nRet = UART_StartRx(&gsCntxt[nID]);
+    UART_CHECK_RETURN(nRet);
+
+    // 7) Mark as initialized
     gsCntxt[nID].fInitDone = true;
 
     return nRet;
@@ -96,11 +335,21 @@ nhns_status_t UART_DeInit(uart_instance_t nID)
         return NHNS_STATUS_OK;
     }
 
-    // 3) Deinitialize UART
+    // 3) Stop any DMA transfers and drop queued data
+    HAL_UART_Abort(&gsCntxt[nID].sUARTHandle);
+    if (gsCntxt[nID].bTxInFlight != 0)
+    {
+        gsCntxt[nID].bTxInFlight = 0;
+        LOWPOWER_Unlock();
+    }
+    RINGBUF_Reset(&gsCntxt[nID].sTxRing);
+    RINGBUF_Reset(&gsCntxt[nID].sRxRing);
+
+    // 4) Deinitialize UART
     nHalRet = HAL_UART_DeInit(&gsCntxt[nID].sUARTHandle);
     UART_CHECK_HAL_RETURN(nHalRet);
 
-    // 4) Mark as deinitialized
+    // 5) Mark as deinitialized
     gsCntxt[nID].fInitDone = false;
 
     return nRet;
@@ -108,8 +357,10 @@ nhns_status_t UART_DeInit(uart_instance_t nID)
 
 nhns_status_t UART_Transmit(uart_instance_t nID, uint8_t *pTxData, uint16_t bLength)
 {
+    uart_context_t *psCntxt   = NULL;
     nhns_status_t nRet        = NHNS_STATUS_OK;
     HAL_StatusTypeDef nHalRet = HAL_OK;
+    bool fIdle                = false;
 
     // 1) Verify arguments
     if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX || pTxData == NULL || bLength == 0)
@@ -122,18 +373,98 @@ nhns_status_t UART_Transmit(uart_instance_t nID, uint8_t *pTxData, uint16_t bLen
     {
         return NHNS_STATUS_MODULE_NOT_INIT;
     }
+    psCntxt = &gsCntxt[nID];
+
+    // 3) Nothing to sleep on before the scheduler runs, poll the data out unless a DMA run still owns the UART
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        if (RINGBUF_Used(&psCntxt->sTxRing) != 0 || psCntxt->bTxInFlight != 0 || psCntxt->fTxDirect)
+        {
+            return NHNS_STATUS_BUSY;
+        }
+        nHalRet = HAL_UART_Transmit(&psCntxt->sUARTHandle, pTxData, bLength, UART_RX_TX_TIMEOUT);
+        UART_CHECK_HAL_RETURN(nHalRet);
+
+        return NHNS_STATUS_OK;
+    }
 
-    // 3) Tranmit data
-    nHalRet = HAL_UART_Transmit(&gsCntxt[nID].sUARTHandle, pTxData, bLength, UART_RX_TX_TIMEOUT);
+    // 4) Let queued asynchronous data drain first so output stays ordered, sleeping between runs
+    while (1)
+    {
+        nRet = COMPLETION_Arm(&psCntxt->sTxDone);
+        UART_CHECK_RETURN(nRet);
+
+        // Armed before looking, so the last run cannot finish unseen. Claiming the DMA in the same
+        // critical section keeps producers from starting a run in between, they only queue from here on
+        taskENTER_CRITICAL();
+        fIdle = (RINGBUF_Used(&psCntxt->sTxRing) == 0 && psCntxt->bTxInFlight == 0);
+        if (fIdle)
+        {
+            psCntxt->fTxDirect = true;
+        }
+        else
+        {
+            UART_StartTx(psCntxt);
+        }
+        taskEXIT_CRITICAL();
+        if (fIdle)
+        {
+            break;
+        }
+
+        nRet = COMPLETION_Wait(&psCntxt->sTxDone, UART_RX_TX_TIMEOUT);
+        UART_CHECK_RETURN(nRet);
+    }
+
+    // 5) Send straight from the caller's buffer by DMA and sleep on the completion armed above
+    LOWPOWER_Lock();
+    nHalRet = HAL_UART_Transmit_DMA(&psCntxt->sUARTHandle, pTxData, bLength);
+    if (nHalRet != HAL_OK)
+    {
+        COMPLETION_Cancel(&psCntxt->sTxDone);
+    }
+    else
+    {
+        nRet = COMPLETION_Wait(&psCntxt->sTxDone, UART_RX_TX_TIMEOUT);
+        if (nRet == NHNS_STATUS_TIMEOUT)
+        {
+            HAL_UART_AbortTransmit(&psCntxt->sUARTHandle);
+        }
+    }
+    LOWPOWER_Unlock();
+
+    // 6) Hand the DMA back and restart it for anything queued in the meantime
+    taskENTER_CRITICAL();
+    psCntxt->fTxDirect = false;
+    UART_StartTx(psCntxt);
+    taskEXIT_CRITICAL();
     UART_CHECK_HAL_RETURN(nHalRet);
 
     return nRet;
 }
 
+nhns_status_t UART_PrintLine(uart_instance_t nID, const char *szLine, int nLength, uint32_t dwSize)
+{
+    // 1) Nothing formatted, or nothing that fits
+    if (nLength <= 0 || dwSize <= 1)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) snprintf returns the length it wanted, the buffer holds at most dwSize - 1 of it
+    if ((uint32_t)nLength >= dwSize)
+    {
+        nLength = (int)dwSize - 1;
+    }
+
+    return UART_Transmit(nID, (uint8_t *)szLine, (uint16_t)nLength);
+}
+
 nhns_status_t UART_Receive(uart_instance_t nID, uint8_t *pRxData, uint16_t bLength)
 {
-    nhns_status_t nRet        = NHNS_STATUS_OK;
-    HAL_StatusTypeDef nHalRet = HAL_OK;
+    uart_context_t *psCntxt = NULL;
+    nhns_status_t nRet      = NHNS_STATUS_OK;
+    uint16_t bReceived      = 0;
 
     // 1) Verify arguments
     if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX || pRxData == NULL || bLength == 0)
@@ -146,10 +477,293 @@ nhns_status_t UART_Receive(uart_instance_t nID, uint8_t *pRxData, uint16_t bLeng
     {
         return NHNS_STATUS_MODULE_NOT_INIT;
     }
+    psCntxt = &gsCntxt[nID];
 
-    // 3) Receive data
-    nHalRet = HAL_UART_Receive(&gsCntxt[nID].sUARTHandle, pRxData, bLength, UART_RX_TX_TIMEOUT);
-    UART_CHECK_HAL_RETURN(nHalRet);
+    // 3) The DMA owns the peripheral, take from the RX ring and sleep until the next RX event
+    while (1)
+    {
+        nRet = COMPLETION_Arm(&psCntxt->sRxDone);
+        UART_CHECK_RETURN(nRet);
+
+        // 4) Armed before reading, so bytes landing in between still wake the wait
+        bReceived += (uint16_t)RINGBUF_Read(&psCntxt->sRxRing, &pRxData[bReceived], bLength - bReceived);
+        if (bReceived == bLength)
+        {
+            COMPLETION_Cancel(&psCntxt->sRxDone);
+            break;
+        }
+
+        nRet = COMPLETION_Wait(&psCntxt->sRxDone, UART_RX_TX_TIMEOUT);
+        UART_CHECK_RETURN(nRet);
+    }
 
     return nRet;
 }
+
+nhns_status_t UART_TransmitAsync(uart_instance_t nID, const uint8_t *pTxData, uint16_t bLength)
+{
+    PROFILER_SCOPE(PROFILER_PROBE_UART_TX_QUEUE);
+
+    // 1) Verify arguments
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX || pTxData == NULL || bLength == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsCntxt[nID].fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Several tasks produce into the ring, so room check, copy and DMA kick are one critical section
+    taskENTER_CRITICAL();
+    if (RINGBUF_Free(&gsCntxt[nID].sTxRing) < bLength)
+    {
+        taskEXIT_CRITICAL();
+        return NHNS_STATUS_NO_MEMORY;
+    }
+    RINGBUF_Write(&gsCntxt[nID].sTxRing, pTxData, bLength);
+    gsCntxt[nID].dwTxQueued += bLength;
+
+    // 4) Kick the DMA if it is idle
+    UART_StartTx(&gsCntxt[nID]);
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t UART_Read(uart_instance_t nID, uint8_t *pRxData, uint16_t bLength, uint16_t *pbRead)
+{
+    // 1) Verify arguments
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX || pRxData == NULL || pbRead == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsCntxt[nID].fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Copy out what is available
+    *pbRead = (uint16_t)RINGBUF_Read(&gsCntxt[nID].sRxRing, pRxData, bLength);
+
+    return NHNS_STATUS_OK;
+}
+
+uint32_t UART_GetTxPending(uart_instance_t nID)
+{
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX || !gsCntxt[nID].fInitDone)
+    {
+        return 0;
+    }
+
+    return RINGBUF_Used(&gsCntxt[nID].sTxRing);
+}
+
+#ifdef FW_DEBUG
+nhns_status_t UART_Benchmark(uart_instance_t nID)
+{
+    uart_context_t *psCntxt = NULL;
+    TickType_t xStart       = 0;
+    uint32_t dwQueued       = 0;
+    uint32_t dwOutstanding  = 0;
+    uint32_t dwPending      = 0;
+    bool fRingOk            = false;
+    bool fDrained           = true;
+    char szLine[UART_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Verify argument
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsCntxt[nID].fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    psCntxt = &gsCntxt[nID];
+
+    // 3) The ring on its own
+    fRingOk = UART_CheckRing();
+
+    // 4) The producers stay blocked between runs, staggered priorities make them preempt each other mid-line
+    if (!gsBench.fCreated)
+    {
+        gsBench.xDone          = RTOS_COUNTING_SEMAPHORE_CREATE(uart_bench, UART_BENCH_PRODUCERS, 0);
+        gsBench.axProducers[0] = RTOS_TASK_CREATE(uart_bench0, UART_BenchTask, (void *)0, tskIDLE_PRIORITY + 1);
+        gsBench.axProducers[1] = RTOS_TASK_CREATE(uart_bench1, UART_BenchTask, (void *)1, tskIDLE_PRIORITY + 2);
+        gsBench.axProducers[2] = RTOS_TASK_CREATE(uart_bench2, UART_BenchTask, (void *)2, tskIDLE_PRIORITY + 3);
+        gsBench.fCreated       = true;
+    }
+
+    // 5) Queue their lines alongside dlog and rtstats, then let the DMA drain the ring
+    gsBench.nID = nID;
+    __atomic_store_n(&gsBench.dwRetries, 0, __ATOMIC_RELAXED);
+    dwQueued = psCntxt->dwTxQueued;
+    for (uint32_t dwProducer = 0; dwProducer < UART_BENCH_PRODUCERS; dwProducer++)
+    {
+        xTaskNotifyGive(gsBench.axProducers[dwProducer]);
+    }
+    for (uint32_t dwProducer = 0; dwProducer < UART_BENCH_PRODUCERS && fDrained; dwProducer++)
+    {
+        fDrained = (xSemaphoreTake(gsBench.xDone, pdMS_TO_TICKS(UART_RX_TX_TIMEOUT)) == pdTRUE);
+    }
+    xStart = xTaskGetTickCount();
+    while (fDrained && UART_GetTxPending(nID) != 0)
+    {
+        fDrained = (xTaskGetTickCount() - xStart < pdMS_TO_TICKS(UART_RX_TX_TIMEOUT));
+        vTaskDelay(1);
+    }
+
+    // 6) Every byte written must have left the ring exactly once, what is still queued came in since
+    taskENTER_CRITICAL();
+    dwQueued      = psCntxt->dwTxQueued - dwQueued;
+    dwOutstanding = psCntxt->dwTxQueued - psCntxt->dwTxDone;
+    dwPending     = RINGBUF_Used(&psCntxt->sTxRing);
+    taskEXIT_CRITICAL();
+
+    nLength = snprintf(szLine, sizeof(szLine),
+                       "uart: ring check %s, %u producers x %u lines, %lu bytes queued, %lu retries, drained %s, accounting %s\r\n",
+                       fRingOk ? "ok" : "FAIL", UART_BENCH_PRODUCERS, UART_BENCH_LINES, (unsigned long)dwQueued,
+                       (unsigned long)__atomic_load_n(&gsBench.dwRetries, __ATOMIC_RELAXED), fDrained ? "ok" : "FAIL",
+                       (dwOutstanding == dwPending) ? "ok" : "FAIL");
+
+    return UART_PrintLine(nID, szLine, nLength, UART_LINE_SIZE);
+}
+#endif
+
+void UART_IRQHandler(uart_instance_t nID)
+{
+    if (nID > UART_INSTANCE_INVALID && nID < UART_INSTANCE_MAX)
+    {
+        HAL_UART_IRQHandler(&gsCntxt[nID].sUARTHandle);
+    }
+}
+
+void UART_TxDMA_IRQHandler(uart_instance_t nID)
+{
+    if (nID > UART_INSTANCE_INVALID && nID < UART_INSTANCE_MAX)
+    {
+        HAL_DMA_IRQHandler(&gsCntxt[nID].sTxDMAHandle);
+    }
+}
+
+void UART_RxDMA_IRQHandler(uart_instance_t nID)
+{
+    if (nID > UART_INSTANCE_INVALID && nID < UART_INSTANCE_MAX)
+    {
+        HAL_DMA_IRQHandler(&gsCntxt[nID].sRxDMAHandle);
+    }
+}
+
+// --- HAL Callbacks ---
+
+/**
+ * @brief TX DMA run finished, release it and start the next one
+ * @param huart - UART handle pointer
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    uart_context_t *psCntxt = UART_GetContext(huart);
+
+    PROFILER_SCOPE(PROFILER_PROBE_UART_TX_ISR);
+
+    if (psCntxt == NULL)
+    {
+        return;
+    }
+
+    // 1) A transfer of UART_Transmit, its caller does the rest
+    if (psCntxt->fTxDirect)
+    {
+        COMPLETION_Signal(&psCntxt->sTxDone, NHNS_STATUS_OK);
+        return;
+    }
+    if (psCntxt->bTxInFlight == 0)
+    {
+        return;
+    }
+
+    // 2) A run of the TX ring
+    RINGBUF_Consume(&psCntxt->sTxRing, psCntxt->bTxInFlight);
+    psCntxt->dwTxDone += psCntxt->bTxInFlight;
+    psCntxt->bTxInFlight = 0;
+    LOWPOWER_Unlock();
+    UART_StartTx(psCntxt);
+    COMPLETION_Signal(&psCntxt->sTxDone, NHNS_STATUS_OK);
+}
+
+/**
+ * @brief Half-transfer, transfer-complete or idle-line event on the RX DMA
+ * @param huart - UART handle pointer
+ * @param Size - Current write position of the DMA inside abRxDMABuffer
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    uart_context_t *psCntxt = UART_GetContext(huart);
+
+    PROFILER_SCOPE(PROFILER_PROBE_UART_RX_ISR);
+
+    if (psCntxt == NULL || Size == psCntxt->bRxDMAPos)
+    {
+        return;
+    }
+
+    // 1) Move everything since the previous event into the RX ring, bytes that do not fit are dropped
+    if (Size > psCntxt->bRxDMAPos)
+    {
+        RINGBUF_Write(&psCntxt->sRxRing, &psCntxt->abRxDMABuffer[psCntxt->bRxDMAPos], Size - psCntxt->bRxDMAPos);
+    }
+    else
+    {
+        RINGBUF_Write(&psCntxt->sRxRing, &psCntxt->abRxDMABuffer[psCntxt->bRxDMAPos], UART_RX_DMA_SIZE - psCntxt->bRxDMAPos);
+        RINGBUF_Write(&psCntxt->sRxRing, psCntxt->abRxDMABuffer, Size);
+    }
+
+    // 2) Remember where the DMA is, wrapping at the end of the circular buffer
+    psCntxt->bRxDMAPos = (Size == UART_RX_DMA_SIZE) ? 0 : Size;
+
+    // 3) Wake a task waiting in UART_Receive
+    COMPLETION_Signal(&psCntxt->sRxDone, NHNS_STATUS_OK);
+}
+
+/**
+ * @brief Recover from errors that aborted a DMA transfer
+ * @param huart - UART handle pointer
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    uart_context_t *psCntxt = UART_GetContext(huart);
+
+    if (psCntxt == NULL)
+    {
+        return;
+    }
+
+    // 1) A failed transfer of UART_Transmit is reported to its caller, an aborted TX run is dropped
+    if (huart->gState == HAL_UART_STATE_READY && psCntxt->fTxDirect)
+    {
+        COMPLETION_Signal(&psCntxt->sTxDone, NHNS_STATUS_FAIL);
+    }
+    else if (huart->gState == HAL_UART_STATE_READY && psCntxt->bTxInFlight != 0)
+    {
+        RINGBUF_Consume(&psCntxt->sTxRing, psCntxt->bTxInFlight);
+        psCntxt->dwTxDone += psCntxt->bTxInFlight;
+        psCntxt->bTxInFlight = 0;
+        LOWPOWER_Unlock();
+        UART_StartTx(psCntxt);
+        COMPLETION_Signal(&psCntxt->sTxDone, NHNS_STATUS_OK);
+    }
+
+    // 2) Re-arm reception if the error stopped it
+    if (huart->RxState == HAL_UART_STATE_READY)
+    {
+        UART_StartRx(psCntxt);
+    }
+}
@@ -1,8 +1,16 @@
+#ifndef __UART_H__
+#define __UART_H__
+
 #include <stdint.h>
 #include "nhns_status_codes.h"
 
 // --- Definitions ---
 
+// Per-instance buffer sizes, each must be a power of two
+#define UART_TX_RING_SIZE 1024
+#define UART_RX_RING_SIZE 512
+#define UART_RX_DMA_SIZE  64
+
 typedef enum uart_instance
 {
     UART_INSTANCE_INVALID = -1,
@@ -32,14 +40,86 @@ nhns_status_t UART_DeInit(uart_instance_t nID);
  * @param pTxData - Data to transmit
  * @param bLength - Length of data to transmit
  * @retval Status code indicating operation success or reason for failure
+ * @note The calling task sleeps until the DMA has sent the data, queued asynchronous data goes out first.
+ *       NHNS_STATUS_BUSY while another task is in UART_Transmit, NHNS_STATUS_TIMEOUT after 5 s without progress.
+ *       Before the scheduler runs the data is sent by polling instead, NHNS_STATUS_BUSY if queued data is pending
  */
 nhns_status_t UART_Transmit(uart_instance_t nID, uint8_t *pTxData, uint16_t bLength);
 
 /**
- * @brief Receive data from the UART interface
+ * @brief Transmit a line formatted with snprintf, blocking like UART_Transmit
+ * @param nID - UART instance to transmit data over
+ * @param szLine - Formatted line
+ * @param nLength - Length returned by snprintf, nothing is sent if it is 0 or negative
+ * @param dwSize - Size of the buffer szLine was formatted into, a longer line is sent as snprintf truncated it
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t UART_PrintLine(uart_instance_t nID, const char *szLine, int nLength, uint32_t dwSize);
+
+/**
+ * @brief Receive data from the UART interface, blocking until bLength bytes arrived
  * @param nID - UART instance to receive data from
  * @param pRxData - Buffer to store received data
  * @param bLength - Length of pRxData Buffer
  * @retval Status code indicating operation success or reason for failure
+ * @note The calling task sleeps between RX events, NHNS_STATUS_TIMEOUT after 5 s without a byte
  */
 nhns_status_t UART_Receive(uart_instance_t nID, uint8_t *pRxData, uint16_t bLength);
+
+/**
+ * @brief Queue data for transmission and return immediately
+ * @param nID - UART instance to transmit data over
+ * @param pTxData - Data to transmit, copied before returning
+ * @param bLength - Length of data to transmit
+ * @retval Status code indicating operation success or reason for failure
+ * @note Either the whole buffer is queued or nothing is (NHNS_STATUS_NO_MEMORY), so
+ *       lines are never torn. Any number of tasks may queue on the same instance.
+ */
+nhns_status_t UART_TransmitAsync(uart_instance_t nID, const uint8_t *pTxData, uint16_t bLength);
+
+/**
+ * @brief Copy out whatever has been received so far without blocking
+ * @param nID - UART instance to read from
+ * @param pRxData - Buffer to store received data
+ * @param bLength - Length of pRxData Buffer
+ * @param pbRead - Receives the number of bytes copied, may be 0
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t UART_Read(uart_instance_t nID, uint8_t *pRxData, uint16_t bLength, uint16_t *pbRead);
+
+/**
+ * @brief Get the number of bytes queued for transmission but not yet sent
+ * @param nID - UART instance to query
+ * @retval Pending byte count, 0 for an invalid or uninitialized instance
+ */
+uint32_t UART_GetTxPending(uart_instance_t nID);
+
+#ifdef FW_DEBUG
+/**
+ * @brief Check the ring on its own, then have several tasks queue lines at once and check the TX ring accounting
+ * @param nID - UART instance to run on and print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note Debug builds only, its producer tasks are not linked into release images
+ */
+nhns_status_t UART_Benchmark(uart_instance_t nID);
+#endif
+
+/**
+ * @brief UART global interrupt entry point, called from the vector table
+ * @param nID - UART instance that raised the interrupt
+ */
+void UART_IRQHandler(uart_instance_t nID);
+
+/**
+ * @brief TX DMA stream interrupt entry point, called from the vector table
+ * @param nID - UART instance owning the stream
+ */
+void UART_TxDMA_IRQHandler(uart_instance_t nID);
+
+/**
+ * @brief RX DMA stream interrupt entry point, called from the vector table
+ * @param nID - UART instance owning the stream
+ */
+void UART_RxDMA_IRQHandler(uart_instance_t nID);
+
+#endif    // __UART_H__
@@ -0,0 +1,604 @@
+#include <stdio.h>
+#include <string.h>
+#include "cdc.h"
+#include "clock.h"
+#include "profiler.h"
+#include "rtos.h"
+#include "usb.h"
+
+// --- Definitions ---
+
+#define CDC_LINE_SIZE                  128
+
+#define CDC_BENCH_MS                   1000
+#define CDC_BENCH_CHUNK                256
+
+// Class requests of the abstract control model
+#define CDC_REQ_SET_LINE_CODING        0x20
+#define CDC_REQ_GET_LINE_CODING        0x21
+#define CDC_REQ_SET_CONTROL_LINE_STATE 0x22
+#define CDC_REQ_SEND_BREAK             0x23
+
+#define CDC_CONTROL_DTR                0x01
+
+// Line coding on the wire: u32 baud rate, u8 stop bits, u8 parity, u8 data bits
+#define CDC_LINE_CODING_SIZE           7
+
+#define CDC_CONFIG_SIZE                67
+
+_Static_assert(CDC_TRANSFER_SIZE % USB_FS_MAX_PACKET == 0, "Transfers must end on a packet boundary");
+_Static_assert(CDC_TRANSFER_SIZE <= USB_TX1_FIFO_WORDS * 4, "An IN transfer must fit the TX FIFO of the data endpoint");
+
+// --- Types ---
+
+typedef struct cdc_context
+{
+    bool fInitDone;
+    bool fConfigured;
+    uint16_t wControlLines;                         // SET_CONTROL_LINE_STATE bits
+    uint8_t abLineCoding[CDC_LINE_CODING_SIZE];     // As sent by the host
+    uint8_t abLineCodingIn[CDC_LINE_CODING_SIZE];   // Data stage of SET_LINE_CODING lands here
+
+    StreamBufferHandle_t xTxStream;
+    StreamBufferHandle_t xRxStream;
+
+    // IN: buffer bTxActive is on the bus while the other one is staged
+    bool fTxBusy;
+    bool fTxZlp;    // The last transfer ended on a full packet
+    uint8_t bTxActive;
+    uint16_t awTxLength[2];
+
+    // OUT: buffers are armed and drained in turn, a full one holds awRxLength bytes from awRxOffset
+    bool fRxArmed;
+    uint8_t bRxArm;     // Next buffer to arm
+    uint8_t bRxHead;    // Oldest buffer holding data
+    uint8_t bRxFull;    // Buffers holding data
+    uint16_t awRxLength[2];
+    uint16_t awRxOffset[2];
+
+    cdc_stats_t sStats;
+
+    // Counters at the previous CDC_Dump, for the rates
+    uint64_t qwDumpTime;
+    uint32_t dwDumpTxBytes;
+    uint32_t dwDumpRxBytes;
+} cdc_context_t;
+
+// --- Global Variables ---
+
+static cdc_context_t gsCdc = {0};
+
+static uint8_t gaabTxBuffer[2][CDC_TRANSFER_SIZE] __attribute__((aligned(4)));
+static uint8_t gaabRxBuffer[2][CDC_TRANSFER_SIZE] __attribute__((aligned(4)));
+
+RTOS_STREAM_BUFFER_DEFINE(cdc_tx, CDC_TX_BUFFER_SIZE);
+RTOS_STREAM_BUFFER_DEFINE(cdc_rx, CDC_RX_BUFFER_SIZE);
+
+// Communication interface with the notification endpoint, data interface with the bulk pair
+static const uint8_t gabConfigDescriptor[CDC_CONFIG_SIZE] = {
+    // Configuration: 2 interfaces, bus powered, 100 mA
+    9, 0x02, CDC_CONFIG_SIZE, 0x00, 2, 1, 0, 0x80, 50,
+    // Interface 0: communication class, abstract control model, AT commands
+    9, 0x04, 0, 0, 1, 0x02, 0x02, 0x01, 0,
+    // Header functional descriptor, CDC 1.10
+    5, 0x24, 0x00, 0x10, 0x01,
+    // Call management: no call management, data interface 1
+    5, 0x24, 0x01, 0x00, 1,
+    // ACM: line coding and control line state requests
+    4, 0x24, 0x02, 0x02,
+    // Union: master interface 0, slave interface 1
+    5, 0x24, 0x06, 0, 1,
+    // Notification endpoint, interrupt IN, polled every 16 ms
+    7, 0x05, USB_EP_DIR_IN | CDC_EP_NOTIFY, USB_EP_TYPE_INTERRUPT, CDC_NOTIFY_PACKET, 0x00, 16,
+    // Interface 1: data class
+    9, 0x04, 1, 0, 2, 0x0A, 0x00, 0x00, 0,
+    // Bulk OUT
+    7, 0x05, CDC_EP_DATA_OUT, USB_EP_TYPE_BULK, USB_FS_MAX_PACKET, 0x00, 0,
+    // Bulk IN
+    7, 0x05, USB_EP_DIR_IN | CDC_EP_DATA_IN, USB_EP_TYPE_BULK, USB_FS_MAX_PACKET, 0x00, 0,
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Top up an IN buffer from the TX stream buffer
+ * @param bIndex - Buffer to fill
+ * @note Runs in the OTG_FS interrupt, or with it masked, which makes it the only reader of the stream
+ */
+static void CDC_TxFill(uint8_t bIndex)
+{
+    uint16_t wLength = gsCdc.awTxLength[bIndex];
+
+    if (wLength < CDC_TRANSFER_SIZE)
+    {
+        gsCdc.awTxLength[bIndex] += (uint16_t)xStreamBufferReceiveFromISR(gsCdc.xTxStream, &gaabTxBuffer[bIndex][wLength],
+                                                                          CDC_TRANSFER_SIZE - wLength, NULL);
+    }
+}
+
+/**
+ * @brief Put the staged buffer on the bus and stage the next one behind it
+ * @note Runs in the OTG_FS interrupt, or with it masked
+ */
+static void CDC_TxStart(void)
+{
+    uint8_t bNext = gsCdc.bTxActive ^ 1;
+
+    // 1) One transfer at a time on the endpoint
+    if (gsCdc.fTxBusy || !gsCdc.fConfigured)
+    {
+        return;
+    }
+
+    // 2) Take whatever was queued since the buffer was staged
+    CDC_TxFill(bNext);
+
+    // 3) Nothing to send, but the host is still waiting for the end of a transfer that filled its last packet
+    if (gsCdc.awTxLength[bNext] == 0)
+    {
+        if (gsCdc.fTxZlp && USB_Transmit(CDC_EP_DATA_IN, NULL, 0) == NHNS_STATUS_OK)
+        {
+            gsCdc.sStats.dwTxZlps++;
+            gsCdc.fTxZlp    = false;
+            gsCdc.fTxBusy   = true;
+            gsCdc.bTxActive = bNext;
+        }
+        return;
+    }
+
+    if (USB_Transmit(CDC_EP_DATA_IN, gaabTxBuffer[bNext], gsCdc.awTxLength[bNext]) != NHNS_STATUS_OK)
+    {
+        return;
+    }
+    gsCdc.fTxZlp    = false;
+    gsCdc.fTxBusy   = true;
+    gsCdc.bTxActive = bNext;
+
+    // 4) Fill the other buffer while this one drains through the FIFO
+    CDC_TxFill(bNext ^ 1);
+}
+
+/**
+ * @brief Hand received buffers to the RX stream buffer in order and keep one armed while any is free
+ * @note Runs in the OTG_FS interrupt, or with it masked, which makes it the only writer of the stream
+ */
+static void CDC_RxService(void)
+{
+    uint8_t bIndex  = 0;
+    uint16_t wMoved = 0;
+
+    // 1) Drain the oldest buffer first, stop at the first one that does not fit
+    while (gsCdc.bRxFull != 0)
+    {
+        bIndex = gsCdc.bRxHead;
+        wMoved = (uint16_t)xStreamBufferSendFromISR(gsCdc.xRxStream, &gaabRxBuffer[bIndex][gsCdc.awRxOffset[bIndex]],
+                                                    gsCdc.awRxLength[bIndex] - gsCdc.awRxOffset[bIndex], NULL);
+        gsCdc.awRxOffset[bIndex] += wMoved;
+        if (gsCdc.awRxOffset[bIndex] < gsCdc.awRxLength[bIndex])
+        {
+            break;
+        }
+
+        gsCdc.bRxFull--;
+        gsCdc.bRxHead ^= 1;
+    }
+
+    // 2) With both buffers full the endpoint NAKs, which holds the host back
+    if (!gsCdc.fRxArmed && gsCdc.bRxFull < 2 && gsCdc.fConfigured)
+    {
+        if (USB_Receive(CDC_EP_DATA_OUT, gaabRxBuffer[gsCdc.bRxArm], CDC_TRANSFER_SIZE) == NHNS_STATUS_OK)
+        {
+            gsCdc.fRxArmed = true;
+        }
+    }
+}
+
+/**
+ * @brief Open the endpoints and start receiving, or drop everything on the way out
+ * @param fConfigured - true when the host selected the configuration
+ */
+static void CDC_Configured(bool fConfigured)
+{
+    uint8_t abDiscard[USB_FS_MAX_PACKET];
+
+    // 1) Both directions start empty
+    gsCdc.fTxBusy       = false;
+    gsCdc.fTxZlp        = false;
+    gsCdc.bTxActive     = 0;
+    gsCdc.awTxLength[0] = 0;
+    gsCdc.awTxLength[1] = 0;
+    gsCdc.fRxArmed      = false;
+    gsCdc.bRxArm        = 0;
+    gsCdc.bRxHead       = 0;
+    gsCdc.bRxFull       = 0;
+    gsCdc.wControlLines = 0;
+
+    if (!fConfigured)
+    {
+        // 2) Writes are refused from now on, drop what the previous host did not collect
+        gsCdc.fConfigured = false;
+        while (xStreamBufferReceiveFromISR(gsCdc.xTxStream, abDiscard, sizeof(abDiscard), NULL) != 0)
+        {
+        }
+
+        USB_CloseEndpoint(USB_EP_DIR_IN | CDC_EP_NOTIFY);
+        USB_CloseEndpoint(CDC_EP_DATA_OUT);
+        USB_CloseEndpoint(USB_EP_DIR_IN | CDC_EP_DATA_IN);
+        return;
+    }
+
+    // 3) Open the endpoints and arm the first OUT buffer
+    USB_OpenEndpoint(USB_EP_DIR_IN | CDC_EP_NOTIFY, USB_EP_TYPE_INTERRUPT, CDC_NOTIFY_PACKET);
+    USB_OpenEndpoint(CDC_EP_DATA_OUT, USB_EP_TYPE_BULK, USB_FS_MAX_PACKET);
+    USB_OpenEndpoint(USB_EP_DIR_IN | CDC_EP_DATA_IN, USB_EP_TYPE_BULK, USB_FS_MAX_PACKET);
+
+    gsCdc.fConfigured = true;
+    CDC_RxService();
+}
+
+/**
+ * @brief Answer the ACM class requests
+ * @param psSetup - Request
+ * @param ppbData - Returns the reply or where the data stage goes
+ * @param pwLength - Returns the reply length or the room there
+ * @retval NHNS_STATUS_OK to accept, anything else stalls the request
+ */
+static nhns_status_t CDC_Setup(const usb_setup_t *psSetup, uint8_t **ppbData, uint16_t *pwLength)
+{
+    switch (psSetup->bRequest)
+    {
+        case CDC_REQ_SET_LINE_CODING:
+            *ppbData  = gsCdc.abLineCodingIn;
+            *pwLength = CDC_LINE_CODING_SIZE;
+            return NHNS_STATUS_OK;
+
+        case CDC_REQ_GET_LINE_CODING:
+            *ppbData  = gsCdc.abLineCoding;
+            *pwLength = CDC_LINE_CODING_SIZE;
+            return NHNS_STATUS_OK;
+
+        case CDC_REQ_SET_CONTROL_LINE_STATE:
+            gsCdc.wControlLines = psSetup->wValue;
+            return NHNS_STATUS_OK;
+
+        case CDC_REQ_SEND_BREAK:
+            // There is no line to break
+            return NHNS_STATUS_OK;
+
+        default:
+            return NHNS_STATUS_UNSUPPORTED;
+    }
+}
+
+/**
+ * @brief Take the line coding once its data stage is complete
+ * @param psSetup - Request
+ */
+static void CDC_ControlOut(const usb_setup_t *psSetup)
+{
+    if (psSetup->bRequest == CDC_REQ_SET_LINE_CODING && psSetup->wLength == CDC_LINE_CODING_SIZE)
+    {
+        memcpy(gsCdc.abLineCoding, gsCdc.abLineCodingIn, CDC_LINE_CODING_SIZE);
+    }
+}
+
+/**
+ * @brief A bulk IN transfer went out, start the staged one at once
+ * @param bEndpoint - Endpoint number
+ */
+static void CDC_DataIn(uint8_t bEndpoint)
+{
+    uint16_t wSent = 0;
+
+    PROFILER_SCOPE(PROFILER_PROBE_CDC_TX_ISR);
+
+    if (bEndpoint != CDC_EP_DATA_IN)
+    {
+        return;
+    }
+
+    wSent                              = gsCdc.awTxLength[gsCdc.bTxActive];
+    gsCdc.awTxLength[gsCdc.bTxActive] = 0;
+    gsCdc.fTxBusy                      = false;
+
+    if (wSent != 0)
+    {
+        gsCdc.sStats.dwTxBytes += wSent;
+        gsCdc.sStats.dwTxTransfers++;
+        gsCdc.fTxZlp = (wSent % USB_FS_MAX_PACKET) == 0;
+    }
+
+    CDC_TxStart();
+}
+
+/**
+ * @brief A bulk OUT transfer ended, arm the other buffer and drain this one
+ * @param bEndpoint - Endpoint number
+ * @param dwLength - Bytes received
+ */
+static void CDC_DataOut(uint8_t bEndpoint, uint32_t dwLength)
+{
+    PROFILER_SCOPE(PROFILER_PROBE_CDC_RX_ISR);
+
+    if (bEndpoint != CDC_EP_DATA_OUT || !gsCdc.fRxArmed)
+    {
+        return;
+    }
+
+    gsCdc.awRxLength[gsCdc.bRxArm] = (uint16_t)dwLength;
+    gsCdc.awRxOffset[gsCdc.bRxArm] = 0;
+    gsCdc.bRxArm ^= 1;
+    gsCdc.bRxFull++;
+    gsCdc.fRxArmed = false;
+    gsCdc.sStats.dwRxBytes += dwLength;
+    gsCdc.sStats.dwRxTransfers++;
+
+    CDC_RxService();
+    if (!gsCdc.fRxArmed)
+    {
+        gsCdc.sStats.dwRxStalls++;
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t CDC_Init(void)
+{
+    static const usb_class_t sClass = {
+        .bDeviceClass       = 0x02,
+        .pbConfigDescriptor = gabConfigDescriptor,
+        .wConfigLength      = sizeof(gabConfigDescriptor),
+        .pfnConfigured      = CDC_Configured,
+        .pfnSetup           = CDC_Setup,
+        .pfnControlOut      = CDC_ControlOut,
+        .pfnDataIn          = CDC_DataIn,
+        .pfnDataOut         = CDC_DataOut,
+    };
+
+    // 1) Check if module has been previously initialized
+    if (gsCdc.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Stream buffers between the tasks and the interrupt
+    gsCdc.xTxStream = RTOS_STREAM_BUFFER_CREATE(cdc_tx, 1);
+    gsCdc.xRxStream = RTOS_STREAM_BUFFER_CREATE(cdc_rx, 1);
+
+    // 3) 115200 8N1 until the host says otherwise
+    gsCdc.abLineCoding[0] = (uint8_t)115200;
+    gsCdc.abLineCoding[1] = (uint8_t)(115200 >> 8);
+    gsCdc.abLineCoding[2] = (uint8_t)(115200 >> 16);
+    gsCdc.abLineCoding[3] = 0;
+    gsCdc.abLineCoding[4] = 0;
+    gsCdc.abLineCoding[5] = 0;
+    gsCdc.abLineCoding[6] = 8;
+
+    // 4) Connect, the host takes it from there
+    gsCdc.qwDumpTime = CLOCK_GetMicros();
+    gsCdc.fInitDone  = true;
+
+    return USB_Init(&sClass);
+}
+
+nhns_status_t CDC_Write(const uint8_t *pbData, uint16_t wLength, uint16_t *pwWritten)
+{
+    uint16_t wWritten = 0;
+
+    // 1) Verify arguments
+    if (pbData == NULL || pwWritten == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    *pwWritten = 0;
+
+    // 2) Check if module is initialized and a host is there to take the data
+    if (!gsCdc.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    if (!gsCdc.fConfigured)
+    {
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 3) Queue what fits
+    wWritten = (uint16_t)xStreamBufferSend(gsCdc.xTxStream, pbData, wLength, 0);
+    gsCdc.sStats.dwTxRefused += wLength - wWritten;
+    *pwWritten = wWritten;
+
+    // 4) An idle endpoint needs a kick, a busy one picks the data up when its transfer completes
+    if (!gsCdc.fTxBusy)
+    {
+        taskENTER_CRITICAL();
+        CDC_TxStart();
+        taskEXIT_CRITICAL();
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t CDC_Read(uint8_t *pbData, uint16_t wLength, uint16_t *pwRead)
+{
+    // 1) Verify arguments
+    if (pbData == NULL || pwRead == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    *pwRead = 0;
+
+    // 2) Check if module is initialized
+    if (!gsCdc.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Take what is there, then move anything held back in the transfer buffers into the room just made
+    *pwRead = (uint16_t)xStreamBufferReceive(gsCdc.xRxStream, pbData, wLength, 0);
+    if (gsCdc.bRxFull != 0 || (!gsCdc.fRxArmed && gsCdc.fConfigured))
+    {
+        taskENTER_CRITICAL();
+        CDC_RxService();
+        taskEXIT_CRITICAL();
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+bool CDC_IsConnected(void)
+{
+    return gsCdc.fConfigured && (gsCdc.wControlLines & CDC_CONTROL_DTR) != 0;
+}
+
+nhns_status_t CDC_GetLineCoding(cdc_line_coding_t *psLineCoding)
+{
+    if (psLineCoding == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    taskENTER_CRITICAL();
+    psLineCoding->dwBaudRate = (uint32_t)gsCdc.abLineCoding[0] | ((uint32_t)gsCdc.abLineCoding[1] << 8) |
+                               ((uint32_t)gsCdc.abLineCoding[2] << 16) | ((uint32_t)gsCdc.abLineCoding[3] << 24);
+    psLineCoding->bStopBits  = gsCdc.abLineCoding[4];
+    psLineCoding->bParity    = gsCdc.abLineCoding[5];
+    psLineCoding->bDataBits  = gsCdc.abLineCoding[6];
+    taskEXIT_CRITICAL();
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t CDC_GetStats(cdc_stats_t *psStats)
+{
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Counters are read one by one, each is exact but they may be from different moments
+    *psStats = gsCdc.sStats;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t CDC_Dump(uart_instance_t nID)
+{
+    static const char *const aszStopBits[] = {"1", "1.5", "2"};
+    static const char acParity[]           = "NOEMS";
+    nhns_status_t nRet                     = NHNS_STATUS_OK;
+    cdc_stats_t sStats;
+    usb_stats_t sUsbStats;
+    cdc_line_coding_t sLineCoding;
+    uint64_t qwNow       = CLOCK_GetMicros();
+    uint32_t dwElapsedMs = (uint32_t)((qwNow - gsCdc.qwDumpTime) / 1000);
+    uint32_t dwTxKBps    = 0;
+    uint32_t dwRxKBps    = 0;
+    char szLine[CDC_LINE_SIZE];
+    int nLength = 0;
+
+    CDC_GetStats(&sStats);
+    USB_GetStats(&sUsbStats);
+    CDC_GetLineCoding(&sLineCoding);
+
+    // 1) Rates since the previous dump
+    if (dwElapsedMs != 0)
+    {
+        dwTxKBps = (sStats.dwTxBytes - gsCdc.dwDumpTxBytes) / dwElapsedMs;
+        dwRxKBps = (sStats.dwRxBytes - gsCdc.dwDumpRxBytes) / dwElapsedMs;
+    }
+    gsCdc.qwDumpTime    = qwNow;
+    gsCdc.dwDumpTxBytes = sStats.dwTxBytes;
+    gsCdc.dwDumpRxBytes = sStats.dwRxBytes;
+
+    // 2) Device state and line settings, then one line per direction
+    nLength = snprintf(szLine, sizeof(szLine), "cdc: usb %s, DTR %s, %lu %u%c%s, last %lu ms\r\n",
+                       USB_GetStateName(USB_GetState()), CDC_IsConnected() ? "on" : "off",
+                       (unsigned long)sLineCoding.dwBaudRate, sLineCoding.bDataBits,
+                       (sLineCoding.bParity < sizeof(acParity) - 1) ? acParity[sLineCoding.bParity] : '?',
+                       (sLineCoding.bStopBits < 3) ? aszStopBits[sLineCoding.bStopBits] : "?", (unsigned long)dwElapsedMs);
+    nRet    = UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "usb %lu resets, %lu setups, %lu stalls, %lu suspends\r\n",
+                           (unsigned long)sUsbStats.dwResets, (unsigned long)sUsbStats.dwSetups,
+                           (unsigned long)sUsbStats.dwStalls, (unsigned long)sUsbStats.dwSuspends);
+        nRet    = UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+    }
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "tx %lu bytes (%lu kB/s), %lu transfers, %lu zlp, %lu refused\r\n",
+                           (unsigned long)sStats.dwTxBytes, (unsigned long)dwTxKBps, (unsigned long)sStats.dwTxTransfers,
+                           (unsigned long)sStats.dwTxZlps, (unsigned long)sStats.dwTxRefused);
+        nRet    = UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+    }
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "rx %lu bytes (%lu kB/s), %lu transfers, %lu stalls\r\n",
+                           (unsigned long)sStats.dwRxBytes, (unsigned long)dwRxKBps, (unsigned long)sStats.dwRxTransfers,
+                           (unsigned long)sStats.dwRxStalls);
+        nRet    = UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t CDC_Benchmark(uart_instance_t nID)
+{
+    static uint8_t abPattern[CDC_BENCH_CHUNK + 256];
+    cdc_stats_t sBefore;
+    cdc_stats_t sAfter;
+    uint64_t qwStart     = 0;
+    uint32_t dwElapsedUs = 0;
+    uint32_t dwQueued    = 0;
+    uint32_t dwTaken     = 0;
+    uint16_t wWritten    = 0;
+    char szLine[CDC_LINE_SIZE];
+    int nLength = 0;
+
+    if (!gsCdc.fConfigured)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "cdc: not configured\r\n");
+        UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 1) The host sees a continuous 0..255 ramp, whatever way the writes were split
+    for (uint32_t dwIndex = 0; dwIndex < sizeof(abPattern); dwIndex++)
+    {
+        abPattern[dwIndex] = (uint8_t)dwIndex;
+    }
+    CDC_GetStats(&sBefore);
+
+    // 2) Keep the stream buffer full, waiting a tick whenever it is
+    qwStart = CLOCK_GetMicros();
+    while (CLOCK_GetMicros() - qwStart < CDC_BENCH_MS * 1000ULL)
+    {
+        if (CDC_Write(&abPattern[dwQueued & 0xFF], CDC_BENCH_CHUNK, &wWritten) != NHNS_STATUS_OK)
+        {
+            break;
+        }
+        dwQueued += wWritten;
+        if (wWritten < CDC_BENCH_CHUNK)
+        {
+            vTaskDelay(1);
+        }
+    }
+    dwElapsedUs = (uint32_t)(CLOCK_GetMicros() - qwStart);
+    CDC_GetStats(&sAfter);
+
+    // 3) Report what the host actually took in that time
+    dwTaken = sAfter.dwTxBytes - sBefore.dwTxBytes;
+    nLength = snprintf(szLine, sizeof(szLine), "cdc: %lu bytes queued, %lu taken in %lu transfers, %lu us\r\n",
+                       (unsigned long)dwQueued, (unsigned long)dwTaken,
+                       (unsigned long)(sAfter.dwTxTransfers - sBefore.dwTxTransfers), (unsigned long)dwElapsedUs);
+    UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+
+    nLength = snprintf(szLine, sizeof(szLine), "%lu kB/s, %lu kbit/s of payload\r\n",
+                       (unsigned long)(((uint64_t)dwTaken * 1000) / dwElapsedUs),
+                       (unsigned long)(((uint64_t)dwTaken * 8000) / dwElapsedUs));
+
+    return UART_PrintLine(nID, szLine, nLength, CDC_LINE_SIZE);
+}
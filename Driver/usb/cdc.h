@@ -0,0 +1,120 @@
+#ifndef __CDC_H__
+#define __CDC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * CDC-ACM virtual serial port on the USB core. Tasks exchange bytes through a
+ * stream buffer per direction and never wait on the bus.
+ *
+ * Each bulk endpoint has two transfer buffers. While one IN buffer is on the
+ * bus the interrupt fills the other from the TX stream buffer, so the next
+ * transfer starts as soon as the previous one completes and the TX FIFO never
+ * runs dry while data is queued. OUT transfers land in one buffer while the
+ * other is drained into the RX stream buffer; when that is full the data
+ * waits in its transfer buffer and the endpoint is left NAKing until CDC_Read
+ * makes room.
+ */
+
+#define CDC_EP_NOTIFY         2    // Interrupt IN, serial state notifications
+#define CDC_EP_DATA_OUT       1    // Bulk OUT
+#define CDC_EP_DATA_IN        1    // Bulk IN
+#define CDC_NOTIFY_PACKET     8
+
+// Bytes moved per bulk transfer, a multiple of the packet size that the TX FIFO holds at once
+#define CDC_TRANSFER_SIZE     512
+
+// Stream buffers between the tasks and the endpoints
+#define CDC_TX_BUFFER_SIZE    4096
+#define CDC_RX_BUFFER_SIZE    1024
+
+// --- Types ---
+
+typedef struct cdc_line_coding
+{
+    uint32_t dwBaudRate;
+    uint8_t bStopBits;    // 0: 1, 1: 1.5, 2: 2
+    uint8_t bParity;      // 0: none, 1: odd, 2: even, 3: mark, 4: space
+    uint8_t bDataBits;
+} cdc_line_coding_t;
+
+typedef struct cdc_stats
+{
+    uint32_t dwTxBytes;        // Bytes the host has taken
+    uint32_t dwTxTransfers;    // Bulk IN transfers, zero-length packets excluded
+    uint32_t dwTxZlps;         // Zero-length packets ending a transfer on a packet boundary
+    uint32_t dwTxRefused;      // Bytes CDC_Write could not queue
+    uint32_t dwRxBytes;
+    uint32_t dwRxTransfers;
+    uint32_t dwRxStalls;       // Times the OUT endpoint was left NAKing on a full RX buffer
+} cdc_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Create the stream buffers and start the USB device
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CDC_Init(void);
+
+/**
+ * @brief Queue bytes for the host without blocking
+ * @param pbData - Data, copied before returning
+ * @param wLength - Number of bytes
+ * @param pwWritten - Returns the number of bytes queued, fewer than wLength when the buffer filled up
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BUSY while no host has configured the device. Callers on
+ *       different tasks must serialize among themselves
+ */
+nhns_status_t CDC_Write(const uint8_t *pbData, uint16_t wLength, uint16_t *pwWritten);
+
+/**
+ * @brief Copy out whatever the host has sent so far without blocking
+ * @param pbData - Buffer to store received data
+ * @param wLength - Length of pbData
+ * @param pwRead - Returns the number of bytes copied, may be 0
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CDC_Read(uint8_t *pbData, uint16_t wLength, uint16_t *pwRead);
+
+/**
+ * @brief Check whether a terminal has the port open
+ * @retval true when configured and the host raised DTR
+ */
+bool CDC_IsConnected(void);
+
+/**
+ * @brief Get the line coding last set by the host, informational only
+ * @param psLineCoding - Returns the line coding
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CDC_GetLineCoding(cdc_line_coding_t *psLineCoding);
+
+/**
+ * @brief Get the port counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CDC_GetStats(cdc_stats_t *psStats);
+
+/**
+ * @brief Print the device state, the line settings and the counters with rates since the previous dump
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t CDC_Dump(uart_instance_t nID);
+
+/**
+ * @brief Write to the host for one second as fast as it takes the data and print the throughput
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note Needs a host reading the port, full speed tops out near 1.2 MB/s of bulk payload
+ */
+nhns_status_t CDC_Benchmark(uart_instance_t nID);
+
+#endif    // __CDC_H__
@@ -0,0 +1,766 @@
+#include <stddef.h>
+#include <string.h>
+#include "usb.h"
+#include "board.h"
+#include "lowpower.h"
+
+// --- Definitions ---
+
+#define USB_CHECK_HAL_RETURN(nHALRet)                \
+    do                                               \
+    {                                                \
+        if (nHALRet != HAL_OK)                       \
+        {                                            \
+            return (NHNS_STATUS_BASE_STM + nHALRet); \
+        }                                            \
+    } while (0)
+
+// Standard requests
+#define USB_REQ_GET_STATUS        0x00
+#define USB_REQ_CLEAR_FEATURE     0x01
+#define USB_REQ_SET_FEATURE       0x03
+#define USB_REQ_SET_ADDRESS       0x05
+#define USB_REQ_GET_DESCRIPTOR    0x06
+#define USB_REQ_GET_CONFIGURATION 0x08
+#define USB_REQ_SET_CONFIGURATION 0x09
+#define USB_REQ_GET_INTERFACE     0x0A
+#define USB_REQ_SET_INTERFACE     0x0B
+
+#define USB_FEATURE_ENDPOINT_HALT 0x00
+
+#define USB_DESC_DEVICE           0x01
+#define USB_DESC_CONFIGURATION    0x02
+#define USB_DESC_STRING           0x03
+
+#define USB_STRING_LANGID         0
+#define USB_STRING_MANUFACTURER   1
+#define USB_STRING_PRODUCT        2
+#define USB_STRING_SERIAL         3
+
+// Longest string descriptor, the 24 hex digits of the serial number are the longest text
+#define USB_STRING_MAX_CHARS      32
+
+// --- Types ---
+
+typedef enum usb_ep0_state
+{
+    USB_EP0_IDLE = 0,
+    USB_EP0_DATA_IN,
+    USB_EP0_DATA_OUT,
+    USB_EP0_STATUS_IN,
+    USB_EP0_STATUS_OUT,
+} usb_ep0_state_t;
+
+typedef struct usb_context
+{
+    bool fInitDone;
+    bool fLocked;    // Holding LOWPOWER_Lock while a bus is attached
+    PCD_HandleTypeDef sPCDHandle;
+    const usb_class_t *psClass;
+
+    usb_state_t nState;
+    usb_state_t nResumeState;    // State to return to when the bus resumes
+    uint8_t bConfiguration;
+
+    // Control transfer in progress, the data stage moves one packet per HAL call
+    usb_ep0_state_t nEp0State;
+    usb_setup_t sSetup;
+    uint8_t *pbEp0Data;
+    uint16_t wEp0Remaining;
+    uint16_t wEp0Packet;
+    bool fEp0Zlp;    // IN reply shorter than asked for and ending on a full packet
+
+    // Replies built on request, the string descriptor is the longest
+    uint8_t abEp0Reply[2 + 2 * USB_STRING_MAX_CHARS];
+
+    usb_stats_t sStats;
+} usb_context_t;
+
+// --- Global Variables ---
+
+static usb_context_t gsUsb = {0};
+
+static const char *const gaszStateNames[] = {
+    [USB_STATE_DETACHED]   = "detached",
+    [USB_STATE_DEFAULT]    = "default",
+    [USB_STATE_ADDRESSED]  = "addressed",
+    [USB_STATE_CONFIGURED] = "configured",
+    [USB_STATE_SUSPENDED]  = "suspended",
+};
+
+static const char *const gaszStrings[] = {
+    [USB_STRING_MANUFACTURER] = "NHNS",
+    [USB_STRING_PRODUCT]      = "NHNS Virtual COM Port",
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Build the device descriptor
+ * @param pbOut - Destination, 18 bytes
+ * @retval Descriptor length
+ */
+static uint16_t USB_DeviceDescriptor(uint8_t *pbOut)
+{
+    const uint8_t abDescriptor[] = {
+        18,                                           // bLength
+        USB_DESC_DEVICE,                              // bDescriptorType
+        0x00, 0x02,                                   // bcdUSB 2.00
+        gsUsb.psClass->bDeviceClass, 0x00, 0x00,      // bDeviceClass, bDeviceSubClass, bDeviceProtocol
+        USB_EP0_SIZE,                                 // bMaxPacketSize0
+        USB_VID & 0xFF, USB_VID >> 8,                 // idVendor
+        USB_PID & 0xFF, USB_PID >> 8,                 // idProduct
+        USB_BCD_DEVICE & 0xFF, USB_BCD_DEVICE >> 8,   // bcdDevice
+        USB_STRING_MANUFACTURER,                      // iManufacturer
+        USB_STRING_PRODUCT,                           // iProduct
+        USB_STRING_SERIAL,                            // iSerialNumber
+        1,                                            // bNumConfigurations
+    };
+
+    memcpy(pbOut, abDescriptor, sizeof(abDescriptor));
+
+    return sizeof(abDescriptor);
+}
+
+/**
+ * @brief Build a string descriptor, the serial number is the unique device ID in hex
+ * @param bIndex - String index
+ * @param pbOut - Destination, sizeof(gsUsb.abEp0Reply) bytes
+ * @retval Descriptor length, 0 for an unknown index
+ */
+static uint16_t USB_StringDescriptor(uint8_t bIndex, uint8_t *pbOut)
+{
+    static const char acHex[] = "0123456789ABCDEF";
+    const uint32_t adwUid[3]  = {HAL_GetUIDw0(), HAL_GetUIDw1(), HAL_GetUIDw2()};
+    const char *szText        = NULL;
+    uint16_t wChars           = 0;
+
+    // 1) Language table, US English only
+    if (bIndex == USB_STRING_LANGID)
+    {
+        pbOut[0] = 4;
+        pbOut[1] = USB_DESC_STRING;
+        pbOut[2] = 0x09;
+        pbOut[3] = 0x04;
+        return 4;
+    }
+
+    // 2) UTF-16LE text
+    if (bIndex == USB_STRING_SERIAL)
+    {
+        for (uint32_t dwWord = 0; dwWord < 3; dwWord++)
+        {
+            for (int nShift = 28; nShift >= 0; nShift -= 4)
+            {
+                pbOut[2 + 2 * wChars]     = (uint8_t)acHex[(adwUid[dwWord] >> nShift) & 0xF];
+                pbOut[2 + 2 * wChars + 1] = 0;
+                wChars++;
+            }
+        }
+    }
+    else
+    {
+        if (bIndex >= sizeof(gaszStrings) / sizeof(gaszStrings[0]) || gaszStrings[bIndex] == NULL)
+        {
+            return 0;
+        }
+
+        szText = gaszStrings[bIndex];
+        while (szText[wChars] != '\0' && wChars < USB_STRING_MAX_CHARS)
+        {
+            pbOut[2 + 2 * wChars]     = (uint8_t)szText[wChars];
+            pbOut[2 + 2 * wChars + 1] = 0;
+            wChars++;
+        }
+    }
+
+    pbOut[0] = (uint8_t)(2 + 2 * wChars);
+    pbOut[1] = USB_DESC_STRING;
+
+    return pbOut[0];
+}
+
+/**
+ * @brief Select or drop the configuration and tell the class
+ * @param bConfiguration - 0 or 1
+ */
+static void USB_SetConfiguration(uint8_t bConfiguration)
+{
+    if (bConfiguration == gsUsb.bConfiguration)
+    {
+        return;
+    }
+
+    if (gsUsb.bConfiguration != 0)
+    {
+        gsUsb.bConfiguration = 0;
+        gsUsb.nState         = USB_STATE_ADDRESSED;
+        gsUsb.psClass->pfnConfigured(false);
+    }
+    if (bConfiguration != 0)
+    {
+        gsUsb.bConfiguration = bConfiguration;
+        gsUsb.nState         = USB_STATE_CONFIGURED;
+        gsUsb.psClass->pfnConfigured(true);
+    }
+}
+
+/**
+ * @brief Answer a standard request
+ * @param psSetup - Request
+ * @param ppbData - Returns the reply of IN requests
+ * @param pwLength - Returns the reply length
+ * @retval NHNS_STATUS_OK to accept, anything else stalls the request
+ */
+static nhns_status_t USB_StandardRequest(const usb_setup_t *psSetup, uint8_t **ppbData, uint16_t *pwLength)
+{
+    uint8_t bRecipient  = psSetup->bmRequestType & USB_REQ_RECIPIENT_MASK;
+    uint8_t bEndpoint   = (uint8_t)psSetup->wIndex;
+    uint8_t *pbReply    = gsUsb.abEp0Reply;
+    PCD_EPTypeDef *psEp = NULL;
+
+    *ppbData  = pbReply;
+    *pwLength = 0;
+
+    switch (psSetup->bRequest)
+    {
+        case USB_REQ_GET_STATUS:
+            // Bus powered without remote wake-up, interfaces have no status, endpoints report their halt
+            pbReply[0] = 0;
+            pbReply[1] = 0;
+            if (bRecipient == USB_REQ_RECIPIENT_EP)
+            {
+                psEp       = (bEndpoint & USB_EP_DIR_IN) ? &gsUsb.sPCDHandle.IN_ep[USB_EP_NUMBER(bEndpoint)]
+                                                         : &gsUsb.sPCDHandle.OUT_ep[USB_EP_NUMBER(bEndpoint)];
+                pbReply[0] = psEp->is_stall;
+            }
+            *pwLength = 2;
+            return NHNS_STATUS_OK;
+
+        case USB_REQ_CLEAR_FEATURE:
+        case USB_REQ_SET_FEATURE:
+            // Only the halt of a class endpoint can be set or cleared, clearing also resets the data toggle
+            if (bRecipient != USB_REQ_RECIPIENT_EP || psSetup->wValue != USB_FEATURE_ENDPOINT_HALT ||
+                USB_EP_NUMBER(bEndpoint) == 0 || gsUsb.nState != USB_STATE_CONFIGURED)
+            {
+                return NHNS_STATUS_UNSUPPORTED;
+            }
+            if (psSetup->bRequest == USB_REQ_SET_FEATURE)
+            {
+                HAL_PCD_EP_SetStall(&gsUsb.sPCDHandle, bEndpoint);
+            }
+            else
+            {
+                HAL_PCD_EP_ClrStall(&gsUsb.sPCDHandle, bEndpoint);
+            }
+            return NHNS_STATUS_OK;
+
+        case USB_REQ_SET_ADDRESS:
+            // The OTG core wants the new address before the status stage, which it still answers at the old one
+            if (psSetup->wValue > 127 || gsUsb.nState == USB_STATE_CONFIGURED)
+            {
+                return NHNS_STATUS_UNSUPPORTED;
+            }
+            HAL_PCD_SetAddress(&gsUsb.sPCDHandle, (uint8_t)psSetup->wValue);
+            gsUsb.nState = (psSetup->wValue != 0) ? USB_STATE_ADDRESSED : USB_STATE_DEFAULT;
+            return NHNS_STATUS_OK;
+
+        case USB_REQ_GET_DESCRIPTOR:
+            // A full-speed only device stalls the device qualifier and other-speed requests
+            switch (psSetup->wValue >> 8)
+            {
+                case USB_DESC_DEVICE:
+                    *pwLength = USB_DeviceDescriptor(pbReply);
+                    break;
+                case USB_DESC_CONFIGURATION:
+                    *ppbData  = (uint8_t *)gsUsb.psClass->pbConfigDescriptor;
+                    *pwLength = gsUsb.psClass->wConfigLength;
+                    break;
+                case USB_DESC_STRING:
+                    *pwLength = USB_StringDescriptor((uint8_t)psSetup->wValue, pbReply);
+                    break;
+                default:
+                    break;
+            }
+            return (*pwLength != 0) ? NHNS_STATUS_OK : NHNS_STATUS_UNSUPPORTED;
+
+        case USB_REQ_GET_CONFIGURATION:
+            pbReply[0] = gsUsb.bConfiguration;
+            *pwLength  = 1;
+            return NHNS_STATUS_OK;
+
+        case USB_REQ_SET_CONFIGURATION:
+            if (psSetup->wValue > 1 || (gsUsb.nState != USB_STATE_ADDRESSED && gsUsb.nState != USB_STATE_CONFIGURED))
+            {
+                return NHNS_STATUS_UNSUPPORTED;
+            }
+            USB_SetConfiguration((uint8_t)psSetup->wValue);
+            return NHNS_STATUS_OK;
+
+        case USB_REQ_GET_INTERFACE:
+        case USB_REQ_SET_INTERFACE:
+            // Every interface has only alternate setting 0
+            if (gsUsb.nState != USB_STATE_CONFIGURED ||
+                (psSetup->bRequest == USB_REQ_SET_INTERFACE && psSetup->wValue != 0))
+            {
+                return NHNS_STATUS_UNSUPPORTED;
+            }
+            pbReply[0] = 0;
+            *pwLength  = (psSetup->bRequest == USB_REQ_GET_INTERFACE) ? 1 : 0;
+            return NHNS_STATUS_OK;
+
+        default:
+            return NHNS_STATUS_UNSUPPORTED;
+    }
+}
+
+/**
+ * @brief Refuse the current control transfer, the core clears the stall at the next SETUP
+ */
+static void USB_Ep0Stall(void)
+{
+    gsUsb.sStats.dwStalls++;
+    gsUsb.nEp0State = USB_EP0_IDLE;
+    HAL_PCD_EP_SetStall(&gsUsb.sPCDHandle, USB_EP_DIR_IN | 0);
+    HAL_PCD_EP_SetStall(&gsUsb.sPCDHandle, 0);
+}
+
+/**
+ * @brief Queue the next IN packet of the data stage, or the zero-length packet that ends it
+ */
+static void USB_Ep0SendPacket(void)
+{
+    gsUsb.wEp0Packet = (gsUsb.wEp0Remaining > USB_EP0_SIZE) ? USB_EP0_SIZE : gsUsb.wEp0Remaining;
+    HAL_PCD_EP_Transmit(&gsUsb.sPCDHandle, USB_EP_DIR_IN | 0, gsUsb.pbEp0Data, gsUsb.wEp0Packet);
+}
+
+/**
+ * @brief Queue the next OUT packet of the data stage
+ */
+static void USB_Ep0ReceivePacket(void)
+{
+    gsUsb.wEp0Packet = (gsUsb.wEp0Remaining > USB_EP0_SIZE) ? USB_EP0_SIZE : gsUsb.wEp0Remaining;
+    HAL_PCD_EP_Receive(&gsUsb.sPCDHandle, 0, gsUsb.pbEp0Data, gsUsb.wEp0Packet);
+}
+
+/**
+ * @brief Decode a SETUP packet, answer it and start the data or status stage
+ * @param pbSetup - The eight bytes of the request
+ */
+static void USB_Ep0Setup(const uint8_t *pbSetup)
+{
+    usb_setup_t *psSetup = &gsUsb.sSetup;
+    nhns_status_t nRet   = NHNS_STATUS_UNSUPPORTED;
+    uint8_t *pbData      = NULL;
+    uint16_t wLength     = 0;
+
+    gsUsb.sStats.dwSetups++;
+
+    // 1) A new SETUP aborts whatever control transfer was still going on
+    psSetup->bmRequestType = pbSetup[0];
+    psSetup->bRequest      = pbSetup[1];
+    psSetup->wValue        = (uint16_t)(pbSetup[2] | (pbSetup[3] << 8));
+    psSetup->wIndex        = (uint16_t)(pbSetup[4] | (pbSetup[5] << 8));
+    psSetup->wLength       = (uint16_t)(pbSetup[6] | (pbSetup[7] << 8));
+    gsUsb.nEp0State        = USB_EP0_IDLE;
+
+    // 2) Standard requests are answered here, class requests to an interface go to the class
+    switch (psSetup->bmRequestType & USB_REQ_TYPE_MASK)
+    {
+        case USB_REQ_TYPE_STANDARD:
+            nRet = USB_StandardRequest(psSetup, &pbData, &wLength);
+            break;
+        case USB_REQ_TYPE_CLASS:
+            if ((psSetup->bmRequestType & USB_REQ_RECIPIENT_MASK) == USB_REQ_RECIPIENT_IFACE &&
+                gsUsb.nState == USB_STATE_CONFIGURED)
+            {
+                nRet = gsUsb.psClass->pfnSetup(psSetup, &pbData, &wLength);
+            }
+            break;
+        default:
+            break;
+    }
+    if (nRet != NHNS_STATUS_OK)
+    {
+        USB_Ep0Stall();
+        return;
+    }
+
+    // 3) No data stage, acknowledge with a zero-length IN
+    if (psSetup->wLength == 0)
+    {
+        gsUsb.nEp0State = USB_EP0_STATUS_IN;
+        HAL_PCD_EP_Transmit(&gsUsb.sPCDHandle, USB_EP_DIR_IN | 0, NULL, 0);
+        return;
+    }
+
+    // 4) IN data stage, never longer than asked for. A shorter reply that ends on a full packet needs a ZLP
+    if ((psSetup->bmRequestType & USB_REQ_DIR_IN) != 0)
+    {
+        if (wLength > psSetup->wLength)
+        {
+            wLength = psSetup->wLength;
+        }
+        gsUsb.pbEp0Data     = pbData;
+        gsUsb.wEp0Remaining = wLength;
+        gsUsb.fEp0Zlp       = (wLength < psSetup->wLength) && ((wLength % USB_EP0_SIZE) == 0);
+        gsUsb.nEp0State     = USB_EP0_DATA_IN;
+        USB_Ep0SendPacket();
+        return;
+    }
+
+    // 5) OUT data stage into the buffer the class gave, which must hold all of it
+    if (pbData == NULL || wLength < psSetup->wLength)
+    {
+        USB_Ep0Stall();
+        return;
+    }
+    gsUsb.pbEp0Data     = pbData;
+    gsUsb.wEp0Remaining = psSetup->wLength;
+    gsUsb.nEp0State     = USB_EP0_DATA_OUT;
+    USB_Ep0ReceivePacket();
+}
+
+/**
+ * @brief Move the control transfer on once an EP0 IN packet went out
+ */
+static void USB_Ep0DataIn(void)
+{
+    switch (gsUsb.nEp0State)
+    {
+        case USB_EP0_DATA_IN:
+            gsUsb.pbEp0Data += gsUsb.wEp0Packet;
+            gsUsb.wEp0Remaining -= gsUsb.wEp0Packet;
+            if (gsUsb.wEp0Remaining != 0 || gsUsb.fEp0Zlp)
+            {
+                gsUsb.fEp0Zlp = (gsUsb.wEp0Remaining != 0) && gsUsb.fEp0Zlp;
+                USB_Ep0SendPacket();
+                break;
+            }
+
+            // Data stage done, the host acknowledges with a zero-length OUT
+            gsUsb.nEp0State = USB_EP0_STATUS_OUT;
+            HAL_PCD_EP_Receive(&gsUsb.sPCDHandle, 0, NULL, 0);
+            break;
+
+        case USB_EP0_STATUS_IN:
+            gsUsb.nEp0State = USB_EP0_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Move the control transfer on once an EP0 OUT packet landed
+ */
+static void USB_Ep0DataOut(void)
+{
+    uint16_t wReceived = (uint16_t)HAL_PCD_EP_GetRxCount(&gsUsb.sPCDHandle, 0);
+
+    switch (gsUsb.nEp0State)
+    {
+        case USB_EP0_DATA_OUT:
+            gsUsb.pbEp0Data += wReceived;
+            gsUsb.wEp0Remaining -= (wReceived < gsUsb.wEp0Remaining) ? wReceived : gsUsb.wEp0Remaining;
+            if (gsUsb.wEp0Remaining != 0 && wReceived == USB_EP0_SIZE)
+            {
+                USB_Ep0ReceivePacket();
+                break;
+            }
+
+            // All data in, let the class act on it before acknowledging
+            gsUsb.psClass->pfnControlOut(&gsUsb.sSetup);
+            gsUsb.nEp0State = USB_EP0_STATUS_IN;
+            HAL_PCD_EP_Transmit(&gsUsb.sPCDHandle, USB_EP_DIR_IN | 0, NULL, 0);
+            break;
+
+        case USB_EP0_STATUS_OUT:
+            gsUsb.nEp0State = USB_EP0_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t USB_Init(const usb_class_t *psClass)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    // 1) Check if module has been previously initialized
+    if (gsUsb.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Verify argument
+    if (psClass == NULL || psClass->pbConfigDescriptor == NULL || psClass->pfnConfigured == NULL ||
+        psClass->pfnSetup == NULL || psClass->pfnControlOut == NULL || psClass->pfnDataIn == NULL ||
+        psClass->pfnDataOut == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    gsUsb.psClass = psClass;
+
+    // 3) Full-speed device on the embedded PHY, FIFOs filled by the CPU, VBUS on PA9 tells when a host is there
+    gsUsb.sPCDHandle.Instance                 = USB_INSTANCE;
+    gsUsb.sPCDHandle.Init.dev_endpoints       = 4;
+    gsUsb.sPCDHandle.Init.speed               = PCD_SPEED_FULL;
+    gsUsb.sPCDHandle.Init.dma_enable          = 0;
+    gsUsb.sPCDHandle.Init.ep0_mps             = USB_EP0_SIZE;
+    gsUsb.sPCDHandle.Init.phy_itface          = PCD_PHY_EMBEDDED;
+    gsUsb.sPCDHandle.Init.Sof_enable          = 0;
+    gsUsb.sPCDHandle.Init.low_power_enable    = 0;
+    gsUsb.sPCDHandle.Init.lpm_enable          = 0;
+    gsUsb.sPCDHandle.Init.vbus_sensing_enable = 1;
+    gsUsb.sPCDHandle.Init.use_dedicated_ep1   = 0;
+
+    nHalRet = HAL_PCD_Init(&gsUsb.sPCDHandle);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    // 4) Size the FIFOs, a TX FIFO as large as the bulk transfers lets a whole buffer queue up
+    HAL_PCDEx_SetRxFiFo(&gsUsb.sPCDHandle, USB_RX_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&gsUsb.sPCDHandle, 0, USB_TX0_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&gsUsb.sPCDHandle, 1, USB_TX1_FIFO_WORDS);
+    HAL_PCDEx_SetTxFiFo(&gsUsb.sPCDHandle, 2, USB_TX2_FIFO_WORDS);
+
+    // 5) Turn on the D+ pull-up, the host resets the bus when it notices
+    gsUsb.nState    = USB_STATE_DETACHED;
+    gsUsb.fInitDone = true;
+    nHalRet         = HAL_PCD_Start(&gsUsb.sPCDHandle);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+usb_state_t USB_GetState(void)
+{
+    return gsUsb.nState;
+}
+
+nhns_status_t USB_OpenEndpoint(uint8_t bAddress, uint8_t bType, uint16_t wMaxPacket)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    if (USB_EP_NUMBER(bAddress) == 0 || wMaxPacket > USB_FS_MAX_PACKET)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    nHalRet = HAL_PCD_EP_Open(&gsUsb.sPCDHandle, bAddress, wMaxPacket, bType);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t USB_CloseEndpoint(uint8_t bAddress)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    if (USB_EP_NUMBER(bAddress) == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    nHalRet = HAL_PCD_EP_Close(&gsUsb.sPCDHandle, bAddress);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t USB_Transmit(uint8_t bEndpoint, uint8_t *pbData, uint32_t dwLength)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    if (bEndpoint == 0 || (pbData == NULL && dwLength != 0))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (gsUsb.nState != USB_STATE_CONFIGURED)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    nHalRet = HAL_PCD_EP_Transmit(&gsUsb.sPCDHandle, USB_EP_DIR_IN | bEndpoint, pbData, dwLength);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t USB_Receive(uint8_t bEndpoint, uint8_t *pbData, uint32_t dwLength)
+{
+    HAL_StatusTypeDef nHalRet = HAL_OK;
+
+    if (bEndpoint == 0 || pbData == NULL || dwLength == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (gsUsb.nState != USB_STATE_CONFIGURED)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    nHalRet = HAL_PCD_EP_Receive(&gsUsb.sPCDHandle, bEndpoint, pbData, dwLength);
+    USB_CHECK_HAL_RETURN(nHalRet);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t USB_GetStats(usb_stats_t *psStats)
+{
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    *psStats = gsUsb.sStats;
+
+    return NHNS_STATUS_OK;
+}
+
+const char *USB_GetStateName(usb_state_t nState)
+{
+    if ((uint32_t)nState >= sizeof(gaszStateNames) / sizeof(gaszStateNames[0]))
+    {
+        return "?";
+    }
+
+    return gaszStateNames[nState];
+}
+
+void USB_IRQHandler(void)
+{
+    HAL_PCD_IRQHandler(&gsUsb.sPCDHandle);
+}
+
+// --- HAL Callbacks ---
+
+/**
+ * @brief Bus reset: drop the configuration, reopen EP0 at address 0 and keep STOP off while attached
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
+{
+    if (!gsUsb.fInitDone)
+    {
+        return;
+    }
+
+    gsUsb.sStats.dwResets++;
+    USB_SetConfiguration(0);
+    gsUsb.nState    = USB_STATE_DEFAULT;
+    gsUsb.nEp0State = USB_EP0_IDLE;
+
+    HAL_PCD_EP_Open(hpcd, 0, USB_EP0_SIZE, USB_EP_TYPE_CONTROL);
+    HAL_PCD_EP_Open(hpcd, USB_EP_DIR_IN | 0, USB_EP0_SIZE, USB_EP_TYPE_CONTROL);
+
+    if (!gsUsb.fLocked)
+    {
+        gsUsb.fLocked = true;
+        LOWPOWER_Lock();
+    }
+}
+
+/**
+ * @brief VBUS went away: drop the configuration and let the system sleep again
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_DisconnectCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+
+    if (!gsUsb.fInitDone)
+    {
+        return;
+    }
+
+    USB_SetConfiguration(0);
+    gsUsb.nState    = USB_STATE_DETACHED;
+    gsUsb.nEp0State = USB_EP0_IDLE;
+
+    if (gsUsb.fLocked)
+    {
+        gsUsb.fLocked = false;
+        LOWPOWER_Unlock();
+    }
+}
+
+/**
+ * @brief The bus went idle for 3 ms
+ * @param hpcd - PCD handle pointer
+ * @note STOP stays off, waking from it on bus activity would need the OTG_FS_WKUP line
+ */
+void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+
+    if (gsUsb.nState != USB_STATE_SUSPENDED && gsUsb.nState != USB_STATE_DETACHED)
+    {
+        gsUsb.sStats.dwSuspends++;
+        gsUsb.nResumeState = gsUsb.nState;
+        gsUsb.nState       = USB_STATE_SUSPENDED;
+    }
+}
+
+/**
+ * @brief Bus activity after a suspend
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
+{
+    UNUSED(hpcd);
+
+    if (gsUsb.nState == USB_STATE_SUSPENDED)
+    {
+        gsUsb.nState = gsUsb.nResumeState;
+    }
+}
+
+/**
+ * @brief A SETUP packet arrived on EP0
+ * @param hpcd - PCD handle pointer
+ */
+void HAL_PCD_SetupStageCallback(PCD_HandleTypeDef *hpcd)
+{
+    USB_Ep0Setup((const uint8_t *)hpcd->Setup);
+}
+
+/**
+ * @brief An IN transfer completed
+ * @param hpcd - PCD handle pointer
+ * @param epnum - Endpoint number
+ */
+void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    UNUSED(hpcd);
+
+    if (epnum == 0)
+    {
+        USB_Ep0DataIn();
+    }
+    else if (gsUsb.nState == USB_STATE_CONFIGURED)
+    {
+        gsUsb.psClass->pfnDataIn(epnum);
+    }
+}
+
+/**
+ * @brief An OUT transfer completed
+ * @param hpcd - PCD handle pointer
+ * @param epnum - Endpoint number
+ */
+void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
+{
+    if (epnum == 0)
+    {
+        USB_Ep0DataOut();
+    }
+    else if (gsUsb.nState == USB_STATE_CONFIGURED)
+    {
+        gsUsb.psClass->pfnDataOut(epnum, HAL_PCD_EP_GetRxCount(hpcd, epnum));
+    }
+}
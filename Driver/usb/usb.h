@@ -0,0 +1,196 @@
+#ifndef __USB_H__
+#define __USB_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+
+// --- Definitions ---
+
+/*
+ * USB full-speed device core on OTG_FS through HAL_PCD. It answers the standard
+ * requests on endpoint 0 and hands class requests and the data endpoints to one
+ * class driver (see cdc.h). Everything runs in the OTG_FS interrupt: the HAL
+ * callbacks move the control state machine, and the class callbacks re-arm
+ * their endpoints from there. Control transfers longer than one packet go one
+ * packet per HAL call, as the OTG core only takes a single EP0 packet at a time.
+ *
+ * The core keeps the system out of STOP from the first bus reset until VBUS goes
+ * away, the USB clock does not run in STOP.
+ */
+
+#define USB_VID                  0x0483
+#define USB_PID                  0x5740
+#define USB_BCD_DEVICE           0x0200
+
+#define USB_EP0_SIZE             64
+#define USB_FS_MAX_PACKET        64
+
+// Data FIFO split of the 320 words of OTG_FS RAM, shared RX then one TX FIFO per IN endpoint
+#define USB_RX_FIFO_WORDS        0x80
+#define USB_TX0_FIFO_WORDS       0x20
+#define USB_TX1_FIFO_WORDS       0x80
+#define USB_TX2_FIFO_WORDS       0x10
+
+#define USB_EP_DIR_IN            0x80
+#define USB_EP_NUMBER(bAddress)  ((bAddress) & 0x0F)
+
+#define USB_EP_TYPE_CONTROL      0x00
+#define USB_EP_TYPE_BULK         0x02
+#define USB_EP_TYPE_INTERRUPT    0x03
+
+// bmRequestType fields
+#define USB_REQ_DIR_IN           0x80
+#define USB_REQ_TYPE_MASK        0x60
+#define USB_REQ_TYPE_STANDARD    0x00
+#define USB_REQ_TYPE_CLASS       0x20
+#define USB_REQ_RECIPIENT_MASK   0x1F
+#define USB_REQ_RECIPIENT_DEVICE 0x00
+#define USB_REQ_RECIPIENT_IFACE  0x01
+#define USB_REQ_RECIPIENT_EP     0x02
+
+// --- Types ---
+
+typedef struct usb_setup
+{
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} usb_setup_t;
+
+typedef enum usb_state
+{
+    USB_STATE_DETACHED = 0,
+    USB_STATE_DEFAULT,       // Reset seen, address 0
+    USB_STATE_ADDRESSED,
+    USB_STATE_CONFIGURED,
+    USB_STATE_SUSPENDED,
+} usb_state_t;
+
+/*
+ * Class driver, every callback runs in the OTG_FS interrupt. Endpoint numbers
+ * passed to the data callbacks are without the direction bit.
+ */
+typedef struct usb_class
+{
+    uint8_t bDeviceClass;               // Device descriptor class code, 0 to let the interfaces tell
+    const uint8_t *pbConfigDescriptor;  // Complete configuration descriptor, value 1
+    uint16_t wConfigLength;
+
+    /**
+     * @brief Open or close the class endpoints as configuration 1 is selected or dropped
+     * @param fConfigured - true when the host selected the configuration
+     */
+    void (*pfnConfigured)(bool fConfigured);
+
+    /**
+     * @brief Handle a class request addressed to one of the interfaces
+     * @param psSetup - Request
+     * @param ppbData - IN: returns the reply. OUT with a data stage: returns where the data goes
+     * @param pwLength - IN: returns the reply length. OUT: returns the room at *ppbData
+     * @retval NHNS_STATUS_OK to accept, anything else stalls the request
+     */
+    nhns_status_t (*pfnSetup)(const usb_setup_t *psSetup, uint8_t **ppbData, uint16_t *pwLength);
+
+    /**
+     * @brief The data stage of an OUT class request has landed where pfnSetup said
+     * @param psSetup - Request
+     */
+    void (*pfnControlOut)(const usb_setup_t *psSetup);
+
+    /**
+     * @brief A transfer started with USB_Transmit has gone out completely
+     * @param bEndpoint - Endpoint number
+     */
+    void (*pfnDataIn)(uint8_t bEndpoint);
+
+    /**
+     * @brief A transfer started with USB_Receive ended, full or on a short packet
+     * @param bEndpoint - Endpoint number
+     * @param dwLength - Bytes received
+     */
+    void (*pfnDataOut)(uint8_t bEndpoint, uint32_t dwLength);
+} usb_class_t;
+
+typedef struct usb_stats
+{
+    uint32_t dwResets;       // Bus resets
+    uint32_t dwSetups;       // SETUP packets received
+    uint32_t dwStalls;       // Requests refused with a STALL
+    uint32_t dwSuspends;
+} usb_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Start the OTG_FS core as a full-speed device and connect to the bus
+ * @param psClass - Class driver, must stay valid
+ * @retval Status code indicating operation success or reason for failure
+ * @note Enumeration proceeds in the interrupt, watch USB_GetState
+ */
+nhns_status_t USB_Init(const usb_class_t *psClass);
+
+/**
+ * @brief Get where the device is in the enumeration
+ * @retval Device state
+ */
+usb_state_t USB_GetState(void);
+
+/**
+ * @brief Open a class endpoint, from pfnConfigured
+ * @param bAddress - Endpoint address with USB_EP_DIR_IN for IN endpoints
+ * @param bType - USB_EP_TYPE_BULK or USB_EP_TYPE_INTERRUPT
+ * @param wMaxPacket - Largest packet
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t USB_OpenEndpoint(uint8_t bAddress, uint8_t bType, uint16_t wMaxPacket);
+
+/**
+ * @brief Close a class endpoint, dropping any transfer in progress
+ * @param bAddress - Endpoint address
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t USB_CloseEndpoint(uint8_t bAddress);
+
+/**
+ * @brief Send a buffer on an IN endpoint, pfnDataIn tells when it is done
+ * @param bEndpoint - Endpoint number
+ * @param pbData - Data, must stay valid until pfnDataIn, NULL for a zero-length packet
+ * @param dwLength - Number of bytes, split into packets by the core
+ * @retval Status code indicating operation success or reason for failure
+ * @note Call from the OTG_FS interrupt or with it masked, one transfer per endpoint at a time
+ */
+nhns_status_t USB_Transmit(uint8_t bEndpoint, uint8_t *pbData, uint32_t dwLength);
+
+/**
+ * @brief Let the host fill a buffer on an OUT endpoint, pfnDataOut tells when it is done
+ * @param bEndpoint - Endpoint number
+ * @param pbData - Buffer, must stay valid until pfnDataOut
+ * @param dwLength - Room in the buffer, a multiple of the packet size
+ * @retval Status code indicating operation success or reason for failure
+ * @note Call from the OTG_FS interrupt or with it masked
+ */
+nhns_status_t USB_Receive(uint8_t bEndpoint, uint8_t *pbData, uint32_t dwLength);
+
+/**
+ * @brief Get the core counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t USB_GetStats(usb_stats_t *psStats);
+
+/**
+ * @brief Get a printable name of a device state
+ * @param nState - State
+ * @retval Name
+ */
+const char *USB_GetStateName(usb_state_t nState);
+
+/**
+ * @brief OTG_FS global interrupt entry point, called from the vector table
+ */
+void USB_IRQHandler(void);
+
+#endif    // __USB_H__
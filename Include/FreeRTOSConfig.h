@@ -51,27 +51,40 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
 #include <stdint.h>
 extern uint32_t SystemCoreClock;
+void RTSTATS_TimerInit(void);
+uint32_t RTSTATS_GetCounter(void);
 #endif
-#define configENABLE_FPU                        1
+#define configENABLE_FPU                        0    /* Cortex-M3: no FPU, the ARM_CM3 port keeps no FP context */
 #define configENABLE_MPU                        0
 
 #define configUSE_PREEMPTION                    1
-#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_STATIC_ALLOCATION         1    /* See Service/rtos, start-up makes no heap calls */
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
 #define configUSE_IDLE_HOOK                     0
+#ifdef NHNS_HOST
+#define configUSE_TICK_HOOK                     1    /* Drives the emulated peripheral interrupts */
+#else
 #define configUSE_TICK_HOOK                     0
+#endif
+#ifdef NHNS_HOST
+#define configUSE_TICKLESS_IDLE                 0
+#else
+#define configUSE_TICKLESS_IDLE                 2    /* STOP-mode idle, see Driver/lowpower */
+#endif
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
 #define configCPU_CLOCK_HZ                      (SystemCoreClock)
 #define configTICK_RATE_HZ                      ((TickType_t)1000)
 #define configMAX_PRIORITIES                    (56)
 #define configMINIMAL_STACK_SIZE                ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE                   ((size_t)12000)
 #define configMAX_TASK_NAME_LEN                 (16)
 #define configUSE_TRACE_FACILITY                1
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_16_BIT_TICKS                  0
 #define configUSE_MUTEXES                       1
 #define configQUEUE_REGISTRY_SIZE               8
 #define configUSE_RECURSIVE_MUTEXES             1
 #define configUSE_COUNTING_SEMAPHORES           1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2    /* Index 1 is Driver/completion, see COMPLETION_NOTIFY_INDEX */
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
 /* USER CODE BEGIN MESSAGE_BUFFER_LENGTH_TYPE */
 /* Defaults to size_t for backward compatibility, but can be changed
@@ -153,6 +166,12 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Run-time stats are counted on TIM2 at 1 MHz, see Service/rtstats. The POSIX port defines its own
+   (no-op) timer setup and a coarse process-time counter, the ALT counter takes precedence over the latter. */
+#ifndef NHNS_HOST
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()   RTSTATS_TimerInit()
+#endif
+#define portALT_GET_RUN_TIME_COUNTER_VALUE(dwTime) ((dwTime) = RTSTATS_GetCounter())
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,208 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include "dlog.h"
+#include "frame.h"
+#include "ringbuf.h"
+#include "rtstats.h"
+#include "rtos.h"
+#include "stm32f2xx_hal.h"
+#ifdef NHNS_HOST
+#include <signal.h>
+#endif
+
+// --- Definitions ---
+
+#define DLOG_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+#define DLOG_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define DLOG_DRAIN_PERIOD_MS 10
+
+// Records are drained in batches of up to this many payload bytes per frame
+#define DLOG_FRAME_PAYLOAD   256
+
+#ifdef NHNS_HOST
+// Emulated interrupts are signals, keep them out while a record is reserved
+typedef sigset_t dlog_lock_t;
+#define DLOG_UNLOCK(sMask) pthread_sigmask(SIG_SETMASK, &(sMask), NULL)
+#else
+typedef uint32_t dlog_lock_t;
+#define DLOG_UNLOCK(dwPrimask) __set_PRIMASK(dwPrimask)
+#endif
+
+// --- Types ---
+
+typedef struct dlog_context
+{
+    bool fInitDone;
+    uart_instance_t nUART;
+    uint8_t bSequence;
+    volatile uint32_t dwDropped;
+
+    // Many producers under DLOG_Lock, the drain task is the only consumer
+    ringbuf_t sRing;
+    uint8_t abRing[DLOG_RING_SIZE] __attribute__((aligned(4)));
+    uint8_t abFrame[FRAME_OVERHEAD + DLOG_FRAME_PAYLOAD];
+} dlog_context_t;
+
+// --- Global Variables ---
+
+static dlog_context_t gsDlog = {0};
+
+RTOS_TASK_DEFINE(dlog, DLOG_TASK_STACK_SIZE);
+
+// Start of the format string section, provided by the linker
+extern const char __start_dlog_fmt[];
+
+// --- Static Functions ---
+
+/**
+ * @brief Mask interrupts of every priority, records are reserved and written in one go
+ * @retval State to hand to DLOG_UNLOCK
+ */
+static inline dlog_lock_t DLOG_Lock(void)
+{
+#ifdef NHNS_HOST
+    sigset_t sAll;
+    sigset_t sPrevious;
+
+    sigfillset(&sAll);
+    pthread_sigmask(SIG_BLOCK, &sAll, &sPrevious);
+
+    return sPrevious;
+#else
+    uint32_t dwPrimask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return dwPrimask;
+#endif
+}
+
+/**
+ * @brief Move as many whole records as fit into one frame
+ * @retval Frame length, 0 if the ring is empty
+ */
+static uint16_t DLOG_BuildFrame(void)
+{
+    uint8_t *pPayload = FRAME_Begin(gsDlog.abFrame, FRAME_TYPE_DLOG, gsDlog.bSequence);
+    uint8_t *pOut     = FRAME_Put32(pPayload, gsDlog.dwDropped);
+    uint8_t *pEnd     = pPayload + DLOG_FRAME_PAYLOAD;
+    uint8_t *pHeader  = NULL;
+    uint32_t dwHeader = 0;
+    uint32_t dwSize   = 0;
+
+    // Records are whole words in a power-of-two ring, so a header never wraps
+    while (RINGBUF_PeekContiguous(&gsDlog.sRing, &pHeader) >= sizeof(uint32_t))
+    {
+        dwHeader = (uint32_t)pHeader[0] | ((uint32_t)pHeader[1] << 8) | ((uint32_t)pHeader[2] << 16) |
+                   ((uint32_t)pHeader[3] << 24);
+        dwSize   = (2 + ((dwHeader >> DLOG_COUNT_SHIFT) & 0xF)) * sizeof(uint32_t);
+        if (pOut + dwSize > pEnd)
+        {
+            break;
+        }
+
+        pOut += RINGBUF_Read(&gsDlog.sRing, pOut, dwSize);
+    }
+
+    if (pOut == pPayload + sizeof(uint32_t))
+    {
+        return 0;
+    }
+
+    gsDlog.bSequence++;
+
+    return FRAME_End(gsDlog.abFrame, pOut);
+}
+
+/**
+ * @brief Drain the ring to the UART, waiting for room rather than dropping consumed records
+ * @param pvParameters - Unused
+ */
+static void DLOG_Task(void *pvParameters)
+{
+    uint16_t bLength = 0;
+
+    (void)pvParameters;
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+
+        while ((bLength = DLOG_BuildFrame()) != 0)
+        {
+            while (UART_TransmitAsync(gsDlog.nUART, gsDlog.abFrame, bLength) == NHNS_STATUS_NO_MEMORY)
+            {
+                vTaskDelay(1);
+            }
+        }
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t DLOG_Init(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is already initialized
+    if (gsDlog.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 3) Set up the ring and the drain task
+    nRet = RINGBUF_Init(&gsDlog.sRing, gsDlog.abRing, DLOG_RING_SIZE);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    gsDlog.nUART = nID;
+    RTOS_TASK_CREATE(dlog, DLOG_Task, NULL, DLOG_TASK_PRIORITY);
+
+    gsDlog.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+void DLOG_Write(uint32_t nLevel, const char *szFormat, const uint32_t *pdwArgs, uint32_t dwCount)
+{
+    uint32_t adwHeader[2];
+    uint32_t dwSize = 0;
+    dlog_lock_t sLock;
+
+    if (!gsDlog.fInitDone)
+    {
+        return;
+    }
+
+    // 1) Everything but the copy happens outside the critical section
+    adwHeader[0] = ((uint32_t)(szFormat - __start_dlog_fmt) & DLOG_OFFSET_MASK) | (dwCount << DLOG_COUNT_SHIFT) |
+                   (nLevel << DLOG_LEVEL_SHIFT);
+    adwHeader[1] = RTSTATS_GetCounter();
+    dwSize       = sizeof(adwHeader) + dwCount * sizeof(uint32_t);
+
+    // 2) Reserve and write the record as a unit, or drop it
+    sLock = DLOG_Lock();
+    if (RINGBUF_Free(&gsDlog.sRing) < dwSize)
+    {
+        gsDlog.dwDropped++;
+    }
+    else
+    {
+        RINGBUF_Write(&gsDlog.sRing, (const uint8_t *)adwHeader, sizeof(adwHeader));
+        RINGBUF_Write(&gsDlog.sRing, (const uint8_t *)pdwArgs, dwCount * sizeof(uint32_t));
+    }
+    DLOG_UNLOCK(sLock);
+}
+
+uint32_t DLOG_GetDropped(void)
+{
+    return gsDlog.dwDropped;
+}
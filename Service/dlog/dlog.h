@@ -0,0 +1,148 @@
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+#define DLOG_LEVEL_NONE  0
+#define DLOG_LEVEL_ERROR 1
+#define DLOG_LEVEL_WARN  2
+#define DLOG_LEVEL_INFO  3
+#define DLOG_LEVEL_DEBUG 4
+
+// Calls above this level compile to nothing
+#ifndef DLOG_LEVEL
+#ifdef FW_DEBUG
+#define DLOG_LEVEL DLOG_LEVEL_DEBUG
+#else
+#define DLOG_LEVEL DLOG_LEVEL_INFO
+#endif
+#endif
+
+// Record storage, must be a power of two
+#define DLOG_RING_SIZE 2048
+
+// Arguments are stored as 32-bit words: integers and pointers as is, float and double as float bits
+#define DLOG_MAX_ARGS  8
+
+/*
+ * Format strings are placed in this section and referenced by their offset in
+ * it. The target links it as a non-loaded (INFO) section, so the strings cost
+ * no flash; Tools/dlog_decode.py reads them back from the ELF.
+ *
+ * Records in the ring and on the wire are little-endian words:
+ *   u32 format offset (bits 0-23) | argument count (bits 24-27) | level (bits 28-31)
+ *   u32 timestamp, run-time counter ticks (RTSTATS_COUNTER_HZ)
+ *   u32 argument[argument count]
+ * A FRAME_TYPE_DLOG payload is a u32 count of records dropped so far, followed by whole records.
+ */
+#define DLOG_SECTION      "dlog_fmt"
+#define DLOG_OFFSET_MASK  0x00FFFFFFUL
+#define DLOG_COUNT_SHIFT  24
+#define DLOG_LEVEL_SHIFT  28
+
+// --- Functions ---
+
+/**
+ * @brief Set up the record ring and create the drain task
+ * @param nID - UART instance records are drained to
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DLOG_Init(uart_instance_t nID);
+
+/**
+ * @brief Queue one record, callable from tasks and ISRs. Use the DLOG_* macros instead
+ * @param nLevel - DLOG_LEVEL_* of the record
+ * @param szFormat - Format string placed in DLOG_SECTION
+ * @param pdwArgs - Arguments as words
+ * @param dwCount - Number of arguments
+ * @note Records that do not fit are dropped and counted
+ */
+void DLOG_Write(uint32_t nLevel, const char *szFormat, const uint32_t *pdwArgs, uint32_t dwCount);
+
+/**
+ * @brief Get the number of records dropped because the ring was full
+ * @retval Dropped records since DLOG_Init
+ */
+uint32_t DLOG_GetDropped(void);
+
+/**
+ * @brief Reinterpret a float as a word for the record
+ * @param fValue - Value to store
+ * @retval IEEE-754 single precision bits
+ */
+static inline uint32_t DLOG_FloatBits(float fValue)
+{
+    union
+    {
+        float f;
+        uint32_t dw;
+    } uValue = {fValue};
+
+    return uValue.dw;
+}
+
+// --- Log Macros ---
+
+// Every branch must compile for every argument type, so the float branch only sees (x) when it is one
+#define DLOG_FLOAT(x) _Generic((x), float: (x), double: (x), default: 0.0f)
+#define DLOG_ARG(x)                                   \
+    _Generic((x),                                     \
+        float: DLOG_FloatBits((float)DLOG_FLOAT(x)),  \
+        double: DLOG_FloatBits((float)DLOG_FLOAT(x)), \
+        default: (uint32_t)(uintptr_t)(x))
+
+#define DLOG_NARGS_(_, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+#define DLOG_NARGS(...) DLOG_NARGS_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define DLOG_MAP_0()
+#define DLOG_MAP_1(a)      DLOG_ARG(a)
+#define DLOG_MAP_2(a, ...) DLOG_ARG(a), DLOG_MAP_1(__VA_ARGS__)
+#define DLOG_MAP_3(a, ...) DLOG_ARG(a), DLOG_MAP_2(__VA_ARGS__)
+#define DLOG_MAP_4(a, ...) DLOG_ARG(a), DLOG_MAP_3(__VA_ARGS__)
+#define DLOG_MAP_5(a, ...) DLOG_ARG(a), DLOG_MAP_4(__VA_ARGS__)
+#define DLOG_MAP_6(a, ...) DLOG_ARG(a), DLOG_MAP_5(__VA_ARGS__)
+#define DLOG_MAP_7(a, ...) DLOG_ARG(a), DLOG_MAP_6(__VA_ARGS__)
+#define DLOG_MAP_8(a, ...) DLOG_ARG(a), DLOG_MAP_7(__VA_ARGS__)
+
+#define DLOG_CONCAT_(a, b) a##b
+#define DLOG_CONCAT(a, b)  DLOG_CONCAT_(a, b)
+#define DLOG_ARGS(...)     DLOG_CONCAT(DLOG_MAP_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+/** Store the format offset and raw arguments, formatting happens on the PC */
+#define DLOG_WRITE(nLevel, szFormat, ...)                                                         \
+    do                                                                                            \
+    {                                                                                             \
+        static const char szDlogFormat[] __attribute__((section(DLOG_SECTION), used)) = szFormat; \
+        const uint32_t adwDlogArgs[DLOG_NARGS(__VA_ARGS__) + 1] = {DLOG_ARGS(__VA_ARGS__)};       \
+        DLOG_Write((nLevel), szDlogFormat, adwDlogArgs, DLOG_NARGS(__VA_ARGS__));                 \
+    } while (0)
+
+#if DLOG_LEVEL >= DLOG_LEVEL_ERROR
+#define DLOG_ERROR(szFormat, ...) DLOG_WRITE(DLOG_LEVEL_ERROR, szFormat, ##__VA_ARGS__)
+#else
+#define DLOG_ERROR(szFormat, ...) ((void)0)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_WARN
+#define DLOG_WARN(szFormat, ...) DLOG_WRITE(DLOG_LEVEL_WARN, szFormat, ##__VA_ARGS__)
+#else
+#define DLOG_WARN(szFormat, ...) ((void)0)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_INFO
+#define DLOG_INFO(szFormat, ...) DLOG_WRITE(DLOG_LEVEL_INFO, szFormat, ##__VA_ARGS__)
+#else
+#define DLOG_INFO(szFormat, ...) ((void)0)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_DEBUG
+#define DLOG_DEBUG(szFormat, ...) DLOG_WRITE(DLOG_LEVEL_DEBUG, szFormat, ##__VA_ARGS__)
+#else
+#define DLOG_DEBUG(szFormat, ...) ((void)0)
+#endif
+
+#endif    // __DLOG_H__
@@ -0,0 +1,754 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "dspbench.h"
+#include "heap.h"
+#include "profiler.h"
+#include "ref.h"
+
+// --- Definitions ---
+
+#define DSPBENCH_LINE_SIZE      128
+#define DSPBENCH_ROUNDS         3       // Runs per block size, the fastest is kept
+#define DSPBENCH_SEED           0x2545F491UL
+
+#define DSPBENCH_FIR_TAPS       32      // Even and at least 4 for arm_fir_q15
+#define DSPBENCH_BIQUAD_STAGES  2
+#define DSPBENCH_BIQUAD_SHIFT   1       // Fixed-point coefficients are stored halved
+#define DSPBENCH_SAMPLES        (DSPBENCH_MAX_BLOCK + DSPBENCH_FIR_TAPS)
+#define DSPBENCH_COEFFS         (DSPBENCH_FIR_TAPS > 6 * DSPBENCH_BIQUAD_STAGES ? DSPBENCH_FIR_TAPS : 6 * DSPBENCH_BIQUAD_STAGES)
+
+// Reported for outputs identical to the reference
+#define DSPBENCH_SNR_EXACT      0xFFFFFFFFUL
+
+// SNR thresholds of DSP_Lib_TestSuite, in dB
+#define DSPBENCH_SNR_BASIC_F32  120
+#define DSPBENCH_SNR_BASIC_Q31  100
+#define DSPBENCH_SNR_BASIC_Q15  75
+#define DSPBENCH_SNR_BASIC_Q7   25
+#define DSPBENCH_SNR_FILTER_F32 99
+#define DSPBENCH_SNR_FILTER_Q31 90
+#define DSPBENCH_SNR_FILTER_Q15 60
+#define DSPBENCH_SNR_FILTER_Q7  30
+
+_Static_assert(DSPBENCH_MIN_BLOCK > 0 && DSPBENCH_MIN_BLOCK <= DSPBENCH_MAX_BLOCK, "Block sizes out of order");
+_Static_assert(DSPBENCH_MAX_BLOCK % DSPBENCH_MIN_BLOCK == 0 &&
+                   ((DSPBENCH_MAX_BLOCK / DSPBENCH_MIN_BLOCK) & (DSPBENCH_MAX_BLOCK / DSPBENCH_MIN_BLOCK - 1)) == 0,
+               "Block sizes are doubled from DSPBENCH_MIN_BLOCK to DSPBENCH_MAX_BLOCK");
+_Static_assert(DSPBENCH_FIR_TAPS >= 4 && DSPBENCH_FIR_TAPS % 2 == 0, "arm_fir_init_q15 takes an even number of taps from 4");
+
+// --- Types ---
+
+typedef enum dspbench_type
+{
+    DSPBENCH_TYPE_F32 = 0,
+    DSPBENCH_TYPE_Q63,    // Dot products of q31 and q15
+    DSPBENCH_TYPE_Q31,
+    DSPBENCH_TYPE_Q15,
+    DSPBENCH_TYPE_Q7,
+} dspbench_type_t;
+
+typedef union dspbench_samples
+{
+    float32_t af[DSPBENCH_SAMPLES];
+    q63_t aq[DSPBENCH_SAMPLES / 2];
+    q31_t an[DSPBENCH_SAMPLES];
+    q15_t aw[DSPBENCH_SAMPLES];
+    q7_t ab[DSPBENCH_SAMPLES];
+} dspbench_samples_t;
+
+typedef union dspbench_coeffs
+{
+    float32_t af[DSPBENCH_COEFFS];
+    q31_t an[DSPBENCH_COEFFS];
+    q15_t aw[DSPBENCH_COEFFS];
+    q7_t ab[DSPBENCH_COEFFS];
+} dspbench_coeffs_t;
+
+typedef struct dspbench_work
+{
+    float32_t afA[DSPBENCH_MAX_BLOCK];    // Inputs in [-0.5, 0.5), converted for each kernel
+    float32_t afB[DSPBENCH_MAX_BLOCK];
+    float32_t afTaps[DSPBENCH_FIR_TAPS];
+    dspbench_samples_t uA;
+    dspbench_samples_t uB;
+    dspbench_coeffs_t uCoeffs;
+    dspbench_samples_t uOut;              // Kernel under test
+    dspbench_samples_t uRef;              // RefLibs
+    dspbench_samples_t uState;
+    dspbench_samples_t uRefState;
+} dspbench_work_t;
+
+/**
+ * @brief Run a kernel and its reference once on fresh state
+ * @param psWork - Inputs and outputs
+ * @param dwBlock - Samples per call
+ * @param pdwTicks - Returns the PROFILER_GetCycles ticks of the kernel alone
+ * @retval Number of outputs in uOut and uRef
+ */
+typedef uint32_t (*dspbench_run_t)(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks);
+
+typedef struct dspbench_case
+{
+    const char *szName;
+    dspbench_type_t nOutput;
+    uint32_t dwSnr;    // Threshold in dB
+    dspbench_run_t pfnRun;
+} dspbench_case_t;
+
+// --- Static Functions ---
+
+/**
+ * @brief Convert to q31, values in [-1, 1)
+ * @param pfSrc - Values to convert
+ * @param pnDst - Returns the converted values
+ * @param dwCount - Number of values
+ */
+static void DSPBENCH_ToQ31(const float32_t *pfSrc, q31_t *pnDst, uint32_t dwCount)
+{
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        pnDst[dwIndex] = (q31_t)(pfSrc[dwIndex] * 2147483648.0f);
+    }
+}
+
+/**
+ * @brief Convert to q15, values in [-1, 1)
+ * @param pfSrc - Values to convert
+ * @param pwDst - Returns the converted values
+ * @param dwCount - Number of values
+ */
+static void DSPBENCH_ToQ15(const float32_t *pfSrc, q15_t *pwDst, uint32_t dwCount)
+{
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        pwDst[dwIndex] = (q15_t)(pfSrc[dwIndex] * 32768.0f);
+    }
+}
+
+/**
+ * @brief Convert to q7, values in [-1, 1)
+ * @param pfSrc - Values to convert
+ * @param pbDst - Returns the converted values
+ * @param dwCount - Number of values
+ */
+static void DSPBENCH_ToQ7(const float32_t *pfSrc, q7_t *pbDst, uint32_t dwCount)
+{
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        pbDst[dwIndex] = (q7_t)(pfSrc[dwIndex] * 128.0f);
+    }
+}
+
+/**
+ * @brief Get one output as a double, the scale of its format left out
+ * @param puSamples - Outputs
+ * @param nType - Their format
+ * @param dwIndex - Output to get
+ * @retval Raw value
+ */
+static double DSPBENCH_Value(const dspbench_samples_t *puSamples, dspbench_type_t nType, uint32_t dwIndex)
+{
+    switch (nType)
+    {
+        case DSPBENCH_TYPE_F32:
+            return (double)puSamples->af[dwIndex];
+        case DSPBENCH_TYPE_Q63:
+            return (double)puSamples->aq[dwIndex];
+        case DSPBENCH_TYPE_Q31:
+            return (double)puSamples->an[dwIndex];
+        case DSPBENCH_TYPE_Q15:
+            return (double)puSamples->aw[dwIndex];
+        case DSPBENCH_TYPE_Q7:
+        default:
+            return (double)puSamples->ab[dwIndex];
+    }
+}
+
+/**
+ * @brief Signal to noise ratio of the kernel output, with the reference as signal
+ * @param psWork - Outputs to compare
+ * @param nType - Their format
+ * @param dwCount - Number of outputs
+ * @retval Whole dB, DSPBENCH_SNR_EXACT when the outputs are identical
+ */
+static uint32_t DSPBENCH_Snr(const dspbench_work_t *psWork, dspbench_type_t nType, uint32_t dwCount)
+{
+    double dSignal = 0.0;
+    double dNoise  = 0.0;
+    double dSnr    = 0.0;
+
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        double dRef   = DSPBENCH_Value(&psWork->uRef, nType, dwIndex);
+        double dError = dRef - DSPBENCH_Value(&psWork->uOut, nType, dwIndex);
+
+        dSignal += dRef * dRef;
+        dNoise  += dError * dError;
+    }
+    if (dNoise == 0.0)
+    {
+        return DSPBENCH_SNR_EXACT;
+    }
+
+    dSnr = 10.0 * log10(dSignal / dNoise);
+    return (dSnr > 0.0) ? (uint32_t)dSnr : 0;
+}
+
+/**
+ * @brief Second-order Butterworth low-pass at a tenth of the sample rate, y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2
+ * @param pfCoeffs - Returns b0, b1, b2, a1, a2 for every stage
+ */
+static void DSPBENCH_DesignBiquad(float32_t *pfCoeffs)
+{
+    static const float32_t afStage[5] = {0.067455f, 0.134911f, 0.067455f, 1.142980f, -0.412802f};
+
+    for (uint32_t dwStage = 0; dwStage < DSPBENCH_BIQUAD_STAGES; dwStage++)
+    {
+        for (uint32_t dwIndex = 0; dwIndex < 5; dwIndex++)
+        {
+            pfCoeffs[dwStage * 5 + dwIndex] = afStage[dwIndex];
+        }
+    }
+}
+
+/*
+ * The cases below are dspbench_run_t: inputs converted from the master copy
+ * and instances set up untimed, the kernel timed on its own, then the
+ * RefLibs function on the same input and coefficients with its own state.
+ */
+
+static uint32_t DSPBENCH_DotProdF32(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = PROFILER_GetCycles();
+
+    arm_dot_prod_f32(psWork->afA, psWork->afB, dwBlock, &psWork->uOut.af[0]);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_dot_prod_f32(psWork->afA, psWork->afB, dwBlock, &psWork->uRef.af[0]);
+
+    return 1;
+}
+
+static uint32_t DSPBENCH_DotProdQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ31(psWork->afA, psWork->uA.an, dwBlock);
+    DSPBENCH_ToQ31(psWork->afB, psWork->uB.an, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_dot_prod_q31(psWork->uA.an, psWork->uB.an, dwBlock, &psWork->uOut.aq[0]);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_dot_prod_q31(psWork->uA.an, psWork->uB.an, dwBlock, &psWork->uRef.aq[0]);
+
+    return 1;
+}
+
+static uint32_t DSPBENCH_DotProdQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ15(psWork->afA, psWork->uA.aw, dwBlock);
+    DSPBENCH_ToQ15(psWork->afB, psWork->uB.aw, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_dot_prod_q15(psWork->uA.aw, psWork->uB.aw, dwBlock, &psWork->uOut.aq[0]);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_dot_prod_q15(psWork->uA.aw, psWork->uB.aw, dwBlock, &psWork->uRef.aq[0]);
+
+    return 1;
+}
+
+static uint32_t DSPBENCH_DotProdQ7(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ7(psWork->afA, psWork->uA.ab, dwBlock);
+    DSPBENCH_ToQ7(psWork->afB, psWork->uB.ab, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_dot_prod_q7(psWork->uA.ab, psWork->uB.ab, dwBlock, &psWork->uOut.an[0]);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_dot_prod_q7(psWork->uA.ab, psWork->uB.ab, dwBlock, &psWork->uRef.an[0]);
+
+    return 1;
+}
+
+static uint32_t DSPBENCH_MultF32(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = PROFILER_GetCycles();
+
+    arm_mult_f32(psWork->afA, psWork->afB, psWork->uOut.af, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_mult_f32(psWork->afA, psWork->afB, psWork->uRef.af, dwBlock);
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_MultQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ31(psWork->afA, psWork->uA.an, dwBlock);
+    DSPBENCH_ToQ31(psWork->afB, psWork->uB.an, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_mult_q31(psWork->uA.an, psWork->uB.an, psWork->uOut.an, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_mult_q31(psWork->uA.an, psWork->uB.an, psWork->uRef.an, dwBlock);
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_MultQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ15(psWork->afA, psWork->uA.aw, dwBlock);
+    DSPBENCH_ToQ15(psWork->afB, psWork->uB.aw, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_mult_q15(psWork->uA.aw, psWork->uB.aw, psWork->uOut.aw, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_mult_q15(psWork->uA.aw, psWork->uB.aw, psWork->uRef.aw, dwBlock);
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_MultQ7(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ7(psWork->afA, psWork->uA.ab, dwBlock);
+    DSPBENCH_ToQ7(psWork->afB, psWork->uB.ab, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_mult_q7(psWork->uA.ab, psWork->uB.ab, psWork->uOut.ab, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_mult_q7(psWork->uA.ab, psWork->uB.ab, psWork->uRef.ab, dwBlock);
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_FirF32(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    arm_fir_instance_f32 sFir;
+    arm_fir_instance_f32 sRef;
+    uint32_t dwStart = 0;
+
+    arm_fir_init_f32(&sFir, DSPBENCH_FIR_TAPS, psWork->afTaps, psWork->uState.af, dwBlock);
+    arm_fir_init_f32(&sRef, DSPBENCH_FIR_TAPS, psWork->afTaps, psWork->uRefState.af, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_fir_f32(&sFir, psWork->afA, psWork->uOut.af, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_fir_f32(&sRef, psWork->afA, psWork->uRef.af, dwBlock);
+
+    return dwBlock;
+}
+
+/**
+ * @brief Shared by arm_fir_q31 and arm_fir_fast_q31, which take the same instance
+ * @param psWork - Inputs and outputs
+ * @param dwBlock - Samples per call
+ * @param pdwTicks - Returns the ticks of the kernel alone
+ * @param fFast - Run arm_fir_fast_q31 and its reference
+ * @retval Number of outputs
+ */
+static uint32_t DSPBENCH_FirQ31Any(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks, bool fFast)
+{
+    arm_fir_instance_q31 sFir;
+    arm_fir_instance_q31 sRef;
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ31(psWork->afA, psWork->uA.an, dwBlock);
+    DSPBENCH_ToQ31(psWork->afTaps, psWork->uCoeffs.an, DSPBENCH_FIR_TAPS);
+    arm_fir_init_q31(&sFir, DSPBENCH_FIR_TAPS, psWork->uCoeffs.an, psWork->uState.an, dwBlock);
+    arm_fir_init_q31(&sRef, DSPBENCH_FIR_TAPS, psWork->uCoeffs.an, psWork->uRefState.an, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    if (fFast)
+    {
+        arm_fir_fast_q31(&sFir, psWork->uA.an, psWork->uOut.an, dwBlock);
+    }
+    else
+    {
+        arm_fir_q31(&sFir, psWork->uA.an, psWork->uOut.an, dwBlock);
+    }
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+
+    if (fFast)
+    {
+        ref_fir_fast_q31(&sRef, psWork->uA.an, psWork->uRef.an, dwBlock);
+    }
+    else
+    {
+        ref_fir_q31(&sRef, psWork->uA.an, psWork->uRef.an, dwBlock);
+    }
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_FirQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_FirQ31Any(psWork, dwBlock, pdwTicks, false);
+}
+
+static uint32_t DSPBENCH_FirFastQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_FirQ31Any(psWork, dwBlock, pdwTicks, true);
+}
+
+/**
+ * @brief Shared by arm_fir_q15 and arm_fir_fast_q15, which take the same instance
+ * @param psWork - Inputs and outputs
+ * @param dwBlock - Samples per call
+ * @param pdwTicks - Returns the ticks of the kernel alone
+ * @param fFast - Run arm_fir_fast_q15 and its reference
+ * @retval Number of outputs
+ */
+static uint32_t DSPBENCH_FirQ15Any(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks, bool fFast)
+{
+    arm_fir_instance_q15 sFir;
+    arm_fir_instance_q15 sRef;
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ15(psWork->afA, psWork->uA.aw, dwBlock);
+    DSPBENCH_ToQ15(psWork->afTaps, psWork->uCoeffs.aw, DSPBENCH_FIR_TAPS);
+    (void)arm_fir_init_q15(&sFir, DSPBENCH_FIR_TAPS, psWork->uCoeffs.aw, psWork->uState.aw, dwBlock);
+    (void)arm_fir_init_q15(&sRef, DSPBENCH_FIR_TAPS, psWork->uCoeffs.aw, psWork->uRefState.aw, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    if (fFast)
+    {
+        arm_fir_fast_q15(&sFir, psWork->uA.aw, psWork->uOut.aw, dwBlock);
+    }
+    else
+    {
+        arm_fir_q15(&sFir, psWork->uA.aw, psWork->uOut.aw, dwBlock);
+    }
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+
+    if (fFast)
+    {
+        ref_fir_fast_q15(&sRef, psWork->uA.aw, psWork->uRef.aw, dwBlock);
+    }
+    else
+    {
+        ref_fir_q15(&sRef, psWork->uA.aw, psWork->uRef.aw, dwBlock);
+    }
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_FirQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_FirQ15Any(psWork, dwBlock, pdwTicks, false);
+}
+
+static uint32_t DSPBENCH_FirFastQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_FirQ15Any(psWork, dwBlock, pdwTicks, true);
+}
+
+static uint32_t DSPBENCH_FirQ7(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    arm_fir_instance_q7 sFir;
+    arm_fir_instance_q7 sRef;
+    uint32_t dwStart = 0;
+
+    DSPBENCH_ToQ7(psWork->afA, psWork->uA.ab, dwBlock);
+    DSPBENCH_ToQ7(psWork->afTaps, psWork->uCoeffs.ab, DSPBENCH_FIR_TAPS);
+    arm_fir_init_q7(&sFir, DSPBENCH_FIR_TAPS, psWork->uCoeffs.ab, psWork->uState.ab, dwBlock);
+    arm_fir_init_q7(&sRef, DSPBENCH_FIR_TAPS, psWork->uCoeffs.ab, psWork->uRefState.ab, dwBlock);
+
+    dwStart = PROFILER_GetCycles();
+    arm_fir_q7(&sFir, psWork->uA.ab, psWork->uOut.ab, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_fir_q7(&sRef, psWork->uA.ab, psWork->uRef.ab, dwBlock);
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_BiquadF32(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    arm_biquad_cascade_df2T_instance_f32 sBiquad;
+    arm_biquad_cascade_df2T_instance_f32 sRef;
+    uint32_t dwStart = 0;
+
+    DSPBENCH_DesignBiquad(psWork->uCoeffs.af);
+    arm_biquad_cascade_df2T_init_f32(&sBiquad, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.af, psWork->uState.af);
+    arm_biquad_cascade_df2T_init_f32(&sRef, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.af, psWork->uRefState.af);
+
+    dwStart = PROFILER_GetCycles();
+    arm_biquad_cascade_df2T_f32(&sBiquad, psWork->afA, psWork->uOut.af, dwBlock);
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+    ref_biquad_cascade_df2T_f32(&sRef, psWork->afA, psWork->uRef.af, dwBlock);
+
+    return dwBlock;
+}
+
+/**
+ * @brief Shared by arm_biquad_cascade_df1_q31 and its fast version, which take the same instance
+ * @param psWork - Inputs and outputs
+ * @param dwBlock - Samples per call
+ * @param pdwTicks - Returns the ticks of the kernel alone
+ * @param fFast - Run arm_biquad_cascade_df1_fast_q31 and its reference
+ * @retval Number of outputs
+ */
+static uint32_t DSPBENCH_BiquadQ31Any(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks, bool fFast)
+{
+    arm_biquad_casd_df1_inst_q31 sBiquad;
+    arm_biquad_casd_df1_inst_q31 sRef;
+    float32_t afCoeffs[5 * DSPBENCH_BIQUAD_STAGES];
+    uint32_t dwStart = 0;
+
+    // 1) Halved into q31, the kernel shifts the sums back up
+    DSPBENCH_DesignBiquad(afCoeffs);
+    for (uint32_t dwIndex = 0; dwIndex < 5 * DSPBENCH_BIQUAD_STAGES; dwIndex++)
+    {
+        afCoeffs[dwIndex] /= (float32_t)(1 << DSPBENCH_BIQUAD_SHIFT);
+    }
+    DSPBENCH_ToQ31(afCoeffs, psWork->uCoeffs.an, 5 * DSPBENCH_BIQUAD_STAGES);
+    DSPBENCH_ToQ31(psWork->afA, psWork->uA.an, dwBlock);
+    arm_biquad_cascade_df1_init_q31(&sBiquad, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.an, psWork->uState.an,
+                                    DSPBENCH_BIQUAD_SHIFT);
+    arm_biquad_cascade_df1_init_q31(&sRef, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.an, psWork->uRefState.an,
+                                    DSPBENCH_BIQUAD_SHIFT);
+
+    // 2) Kernel timed, then the reference on the same input
+    dwStart = PROFILER_GetCycles();
+    if (fFast)
+    {
+        arm_biquad_cascade_df1_fast_q31(&sBiquad, psWork->uA.an, psWork->uOut.an, dwBlock);
+    }
+    else
+    {
+        arm_biquad_cascade_df1_q31(&sBiquad, psWork->uA.an, psWork->uOut.an, dwBlock);
+    }
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+
+    if (fFast)
+    {
+        ref_biquad_cascade_df1_fast_q31(&sRef, psWork->uA.an, psWork->uRef.an, dwBlock);
+    }
+    else
+    {
+        ref_biquad_cascade_df1_q31(&sRef, psWork->uA.an, psWork->uRef.an, dwBlock);
+    }
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_BiquadQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_BiquadQ31Any(psWork, dwBlock, pdwTicks, false);
+}
+
+static uint32_t DSPBENCH_BiquadFastQ31(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_BiquadQ31Any(psWork, dwBlock, pdwTicks, true);
+}
+
+/**
+ * @brief Shared by arm_biquad_cascade_df1_q15 and its fast version, which take the same instance
+ * @param psWork - Inputs and outputs
+ * @param dwBlock - Samples per call
+ * @param pdwTicks - Returns the ticks of the kernel alone
+ * @param fFast - Run arm_biquad_cascade_df1_fast_q15 and its reference
+ * @retval Number of outputs
+ */
+static uint32_t DSPBENCH_BiquadQ15Any(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks, bool fFast)
+{
+    arm_biquad_casd_df1_inst_q15 sBiquad;
+    arm_biquad_casd_df1_inst_q15 sRef;
+    float32_t afCoeffs[5 * DSPBENCH_BIQUAD_STAGES];
+    uint32_t dwStart = 0;
+
+    // 1) Halved into q15 with a zero after b0 in every stage: {b0, 0, b1, b2, a1, a2}
+    DSPBENCH_DesignBiquad(afCoeffs);
+    for (uint32_t dwStage = 0; dwStage < DSPBENCH_BIQUAD_STAGES; dwStage++)
+    {
+        q15_t *pwStage = &psWork->uCoeffs.aw[dwStage * 6];
+
+        for (uint32_t dwIndex = 0; dwIndex < 5; dwIndex++)
+        {
+            afCoeffs[dwStage * 5 + dwIndex] /= (float32_t)(1 << DSPBENCH_BIQUAD_SHIFT);
+        }
+        DSPBENCH_ToQ15(&afCoeffs[dwStage * 5], pwStage, 1);
+        pwStage[1] = 0;
+        DSPBENCH_ToQ15(&afCoeffs[dwStage * 5 + 1], &pwStage[2], 4);
+    }
+    DSPBENCH_ToQ15(psWork->afA, psWork->uA.aw, dwBlock);
+    arm_biquad_cascade_df1_init_q15(&sBiquad, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.aw, psWork->uState.aw,
+                                    DSPBENCH_BIQUAD_SHIFT);
+    arm_biquad_cascade_df1_init_q15(&sRef, DSPBENCH_BIQUAD_STAGES, psWork->uCoeffs.aw, psWork->uRefState.aw,
+                                    DSPBENCH_BIQUAD_SHIFT);
+
+    // 2) Kernel timed, then the reference on the same input
+    dwStart = PROFILER_GetCycles();
+    if (fFast)
+    {
+        arm_biquad_cascade_df1_fast_q15(&sBiquad, psWork->uA.aw, psWork->uOut.aw, dwBlock);
+    }
+    else
+    {
+        arm_biquad_cascade_df1_q15(&sBiquad, psWork->uA.aw, psWork->uOut.aw, dwBlock);
+    }
+    *pdwTicks = PROFILER_GetCycles() - dwStart;
+
+    if (fFast)
+    {
+        ref_biquad_cascade_df1_fast_q15(&sRef, psWork->uA.aw, psWork->uRef.aw, dwBlock);
+    }
+    else
+    {
+        ref_biquad_cascade_df1_q15(&sRef, psWork->uA.aw, psWork->uRef.aw, dwBlock);
+    }
+
+    return dwBlock;
+}
+
+static uint32_t DSPBENCH_BiquadQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_BiquadQ15Any(psWork, dwBlock, pdwTicks, false);
+}
+
+static uint32_t DSPBENCH_BiquadFastQ15(dspbench_work_t *psWork, uint32_t dwBlock, uint32_t *pdwTicks)
+{
+    return DSPBENCH_BiquadQ15Any(psWork, dwBlock, pdwTicks, true);
+}
+
+// --- Global Variables ---
+
+static const dspbench_case_t gasCases[] = {
+    {"arm_dot_prod_f32", DSPBENCH_TYPE_F32, DSPBENCH_SNR_BASIC_F32, DSPBENCH_DotProdF32},
+    {"arm_dot_prod_q31", DSPBENCH_TYPE_Q63, DSPBENCH_SNR_BASIC_Q31, DSPBENCH_DotProdQ31},
+    {"arm_dot_prod_q15", DSPBENCH_TYPE_Q63, DSPBENCH_SNR_BASIC_Q15, DSPBENCH_DotProdQ15},
+    {"arm_dot_prod_q7", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_BASIC_Q7, DSPBENCH_DotProdQ7},
+    {"arm_mult_f32", DSPBENCH_TYPE_F32, DSPBENCH_SNR_BASIC_F32, DSPBENCH_MultF32},
+    {"arm_mult_q31", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_BASIC_Q31, DSPBENCH_MultQ31},
+    {"arm_mult_q15", DSPBENCH_TYPE_Q15, DSPBENCH_SNR_BASIC_Q15, DSPBENCH_MultQ15},
+    {"arm_mult_q7", DSPBENCH_TYPE_Q7, DSPBENCH_SNR_BASIC_Q7, DSPBENCH_MultQ7},
+    {"arm_fir_f32", DSPBENCH_TYPE_F32, DSPBENCH_SNR_FILTER_F32, DSPBENCH_FirF32},
+    {"arm_fir_q31", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_FILTER_Q31, DSPBENCH_FirQ31},
+    {"arm_fir_fast_q31", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_FILTER_Q31, DSPBENCH_FirFastQ31},
+    {"arm_fir_q15", DSPBENCH_TYPE_Q15, DSPBENCH_SNR_FILTER_Q15, DSPBENCH_FirQ15},
+    {"arm_fir_fast_q15", DSPBENCH_TYPE_Q15, DSPBENCH_SNR_FILTER_Q15, DSPBENCH_FirFastQ15},
+    {"arm_fir_q7", DSPBENCH_TYPE_Q7, DSPBENCH_SNR_FILTER_Q7, DSPBENCH_FirQ7},
+    {"arm_biquad_df2T_f32", DSPBENCH_TYPE_F32, DSPBENCH_SNR_FILTER_F32, DSPBENCH_BiquadF32},
+    {"arm_biquad_df1_q31", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_FILTER_Q31, DSPBENCH_BiquadQ31},
+    {"arm_biquad_df1_fast_q31", DSPBENCH_TYPE_Q31, DSPBENCH_SNR_FILTER_Q31, DSPBENCH_BiquadFastQ31},
+    {"arm_biquad_df1_q15", DSPBENCH_TYPE_Q15, DSPBENCH_SNR_FILTER_Q15, DSPBENCH_BiquadQ15},
+    {"arm_biquad_df1_fast_q15", DSPBENCH_TYPE_Q15, DSPBENCH_SNR_FILTER_Q15, DSPBENCH_BiquadFastQ15},
+};
+
+// --- Functions ---
+
+nhns_status_t DSPBENCH_Benchmark(uart_instance_t nID)
+{
+    dspbench_work_t *psWork = NULL;
+    uint32_t dwSeed         = DSPBENCH_SEED;
+    uint32_t dwFailed       = 0;
+    nhns_status_t nRet      = NHNS_STATUS_OK;
+    char szLine[DSPBENCH_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Buffers for one kernel at a time, about 9 KB
+    psWork = HEAP_Alloc(sizeof(dspbench_work_t), HEAP_REGION_DEFAULT);
+    if (psWork == NULL)
+    {
+        return NHNS_STATUS_NO_MEMORY;
+    }
+
+    // 2) The same pseudo-random inputs on every run, and random taps kept small enough not to saturate
+    for (uint32_t dwIndex = 0; dwIndex < DSPBENCH_MAX_BLOCK; dwIndex++)
+    {
+        dwSeed               = dwSeed * 1664525UL + 1013904223UL;
+        psWork->afA[dwIndex] = (float32_t)(int32_t)dwSeed / 4294967296.0f;
+        dwSeed               = dwSeed * 1664525UL + 1013904223UL;
+        psWork->afB[dwIndex] = (float32_t)(int32_t)dwSeed / 4294967296.0f;
+    }
+    for (uint32_t dwIndex = 0; dwIndex < DSPBENCH_FIR_TAPS; dwIndex++)
+    {
+        dwSeed                  = dwSeed * 1664525UL + 1013904223UL;
+        psWork->afTaps[dwIndex] = (float32_t)(int32_t)dwSeed / 4294967296.0f / 4.0f;
+    }
+
+    // 3) Header, one column per block size
+    nLength = snprintf(szLine, sizeof(szLine), "dspbench: best of %u runs, %lu ticks/s\r\n  %-24s", DSPBENCH_ROUNDS,
+                       (unsigned long)PROFILER_GetCyclesPerSecond(), "kernel");
+    for (uint32_t dwBlock = DSPBENCH_MIN_BLOCK; dwBlock <= DSPBENCH_MAX_BLOCK && nLength < DSPBENCH_LINE_SIZE; dwBlock *= 2)
+    {
+        nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, " %8lu", (unsigned long)dwBlock);
+    }
+    if (nLength < DSPBENCH_LINE_SIZE)
+    {
+        nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, "  /sample    snr\r\n");
+    }
+    nRet = UART_PrintLine(nID, szLine, nLength, DSPBENCH_LINE_SIZE);
+
+    // 4) Each kernel at each block size, its worst SNR against the reference over all of them
+    for (uint32_t dwCase = 0; dwCase < sizeof(gasCases) / sizeof(gasCases[0]) && nRet == NHNS_STATUS_OK; dwCase++)
+    {
+        const dspbench_case_t *psCase = &gasCases[dwCase];
+        uint32_t dwSnr                = DSPBENCH_SNR_EXACT;
+        uint32_t dwBest               = 0;
+        uint32_t dwTenths             = 0;
+
+        nLength = snprintf(szLine, sizeof(szLine), "  %-24s", psCase->szName);
+        for (uint32_t dwBlock = DSPBENCH_MIN_BLOCK; dwBlock <= DSPBENCH_MAX_BLOCK; dwBlock *= 2)
+        {
+            uint32_t dwCount    = 0;
+            uint32_t dwTicks    = 0;
+            uint32_t dwBlockSnr = 0;
+
+            dwBest = UINT32_MAX;
+            for (uint32_t dwRound = 0; dwRound < DSPBENCH_ROUNDS; dwRound++)
+            {
+                dwCount = psCase->pfnRun(psWork, dwBlock, &dwTicks);
+                dwBest  = (dwTicks < dwBest) ? dwTicks : dwBest;
+            }
+
+            dwBlockSnr = DSPBENCH_Snr(psWork, psCase->nOutput, dwCount);
+            dwSnr      = (dwBlockSnr < dwSnr) ? dwBlockSnr : dwSnr;
+            if (nLength < DSPBENCH_LINE_SIZE)
+            {
+                nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, " %8lu", (unsigned long)dwBest);
+            }
+        }
+
+        // Ticks per sample at the largest block, and whether the kernel kept to its threshold
+        if (dwSnr != DSPBENCH_SNR_EXACT && dwSnr <= psCase->dwSnr)
+        {
+            dwFailed++;
+        }
+        dwTenths = (uint32_t)((uint64_t)dwBest * 10 / DSPBENCH_MAX_BLOCK);
+        if (nLength < DSPBENCH_LINE_SIZE)
+        {
+            nLength += (dwSnr == DSPBENCH_SNR_EXACT)
+                           ? snprintf(szLine + nLength, sizeof(szLine) - nLength, " %7lu.%lu  exact\r\n",
+                                      (unsigned long)(dwTenths / 10), (unsigned long)(dwTenths % 10))
+                           : snprintf(szLine + nLength, sizeof(szLine) - nLength, " %7lu.%lu %3lu dB%s\r\n",
+                                      (unsigned long)(dwTenths / 10), (unsigned long)(dwTenths % 10),
+                                      (unsigned long)dwSnr, (dwSnr <= psCase->dwSnr) ? " FAIL" : "");
+        }
+        nRet = UART_PrintLine(nID, szLine, nLength, DSPBENCH_LINE_SIZE);
+    }
+
+    // 5) Verdict
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "dspbench: %lu kernels, %lu below their SNR threshold\r\n",
+                           (unsigned long)(sizeof(gasCases) / sizeof(gasCases[0])), (unsigned long)dwFailed);
+        nRet    = UART_PrintLine(nID, szLine, nLength, DSPBENCH_LINE_SIZE);
+    }
+    if (nRet == NHNS_STATUS_OK && dwFailed != 0)
+    {
+        nRet = NHNS_STATUS_DATA_MISMATCH;
+    }
+
+    HEAP_Free(psWork);
+
+    return nRet;
+}
@@ -0,0 +1,36 @@
+#ifndef __DSPBENCH_H__
+#define __DSPBENCH_H__
+
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Regression and cycle tables for the CMSIS-DSP kernels, built from
+ * Library/CMSIS/DSP/Source the same way on the target and on the host. Each
+ * kernel runs on pseudo-random input at several block sizes next to its
+ * counterpart in DSP_Lib_TestSuite/RefLibs, and the two outputs must agree
+ * within the SNR the library's own test suite asks of that data type.
+ *
+ * The Cortex-M3 has no DSP extension, so the kernels take their plain C paths
+ * and the host runs the same code the target does. The times are
+ * PROFILER_GetCycles ticks: DWT cycles on the target, nanoseconds on the host,
+ * the best of a few runs so that interrupts and preemption drop out.
+ */
+
+#define DSPBENCH_MIN_BLOCK 32     // Samples, doubled up to DSPBENCH_MAX_BLOCK
+#define DSPBENCH_MAX_BLOCK 256
+
+// --- Functions ---
+
+/**
+ * @brief Check every kernel against its reference and print its ticks per call at each block size
+ * @param nID - UART instance to print the table on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a kernel falls below its SNR threshold,
+ *       NHNS_STATUS_NO_MEMORY when the buffers do not fit in the heap
+ */
+nhns_status_t DSPBENCH_Benchmark(uart_instance_t nID);
+
+#endif    // __DSPBENCH_H__
@@ -0,0 +1,776 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "dspfix.h"
+#include "heap.h"
+#include "profiler.h"
+
+// --- Definitions ---
+
+#define DSPFIX_LINE_SIZE    128
+#define DSPFIX_ROUNDS       3       // Runs per chain and type, the fastest is kept
+#define DSPFIX_SEED         0x2545F491UL
+
+// Benchmark chains: one block through a low-pass FIR, a low-pass biquad cascade and a real FFT
+#define DSPFIX_BENCH_SIZE   256     // Block and FFT points
+#define DSPFIX_BENCH_TAPS   32
+#define DSPFIX_BENCH_STAGES 2
+#define DSPFIX_BENCH_CUTOFF 0.1f    // Of the sample rate, for both filters
+#define DSPFIX_PI_DOUBLE    3.14159265358979323846
+
+#define DSPFIX_CHAIN_FIR    0x01
+#define DSPFIX_CHAIN_BIQUAD 0x02
+#define DSPFIX_CHAIN_RFFT   0x04
+
+// Reported for outputs identical to the reference
+#define DSPFIX_SNR_EXACT    0xFFFFFFFFUL
+
+_Static_assert(DSPFIX_BENCH_TAPS >= 4 && DSPFIX_BENCH_TAPS % 2 == 0, "arm_fir_init_q15 takes an even number of taps from 4");
+_Static_assert((DSPFIX_BENCH_SIZE & (DSPFIX_BENCH_SIZE - 1)) == 0 && DSPFIX_BENCH_SIZE >= 32,
+               "The real FFTs take a power of two from 32");
+
+// --- Types ---
+
+typedef enum dspfix_type
+{
+    DSPFIX_TYPE_F32 = 0,
+    DSPFIX_TYPE_Q31,
+    DSPFIX_TYPE_Q15,
+    DSPFIX_TYPE_MAX,
+} dspfix_type_t;
+
+typedef union dspfix_samples
+{
+    float32_t af[2 * DSPFIX_BENCH_SIZE];    // Fixed-point FFTs write a pair per point
+    q31_t an[2 * DSPFIX_BENCH_SIZE];
+    q15_t aw[2 * DSPFIX_BENCH_SIZE];
+} dspfix_samples_t;
+
+typedef struct dspfix_work
+{
+    float32_t afInput[DSPFIX_BENCH_SIZE];                  // In [-0.7, 0.7], converted for each type
+    float32_t afTaps[DSPFIX_BENCH_TAPS];
+    float32_t afBiquad[5 * DSPFIX_BENCH_STAGES];
+    float32_t afOut[2 * DSPFIX_BENCH_SIZE];                // Output of the chain under test, as float at full scale
+    double adCos[DSPFIX_BENCH_SIZE];                       // cos(2 pi n / N) for the reference DFT
+    double adRef[DSPFIX_BENCH_SIZE + 2];                   // Reference output: samples, or DC to Nyquist as pairs
+    double adSignal[DSPFIX_BENCH_SIZE];
+    dspfix_samples_t uA;
+    dspfix_samples_t uB;
+    dspfix_samples_t uTaps;
+    dspfix_samples_t uBiquad;
+    dspfix_samples_t uFirState;
+    dspfix_samples_t uBiquadState;
+} dspfix_work_t;
+
+/**
+ * @brief Run a chain once in one type on fresh state
+ * @param psWork - Inputs, returns afOut
+ * @param bChain - DSPFIX_CHAIN_ flags of the stages to run, in FIR, biquad, FFT order
+ * @param pdwTicks - Returns the PROFILER_GetCycles ticks of the stages, conversions and set-up left out
+ * @retval Status code indicating operation success or reason for failure
+ */
+typedef nhns_status_t (*dspfix_run_t)(dspfix_work_t *psWork, uint8_t bChain, uint32_t *pdwTicks);
+
+typedef struct dspfix_chain
+{
+    const char *szName;
+    uint8_t bChain;
+    uint32_t adwSnr[DSPFIX_TYPE_MAX];    // Threshold in dB for each type
+} dspfix_chain_t;
+
+// --- Global Variables ---
+
+static const char *const gaszTypeNames[DSPFIX_TYPE_MAX] = {"f32", "q31", "q15"};
+
+static const dspfix_chain_t gasChains[] = {
+    {"fir 32 taps", DSPFIX_CHAIN_FIR, {120, 120, 60}},
+    {"biquad 2 stages", DSPFIX_CHAIN_BIQUAD, {110, 100, 50}},
+    {"rfft 256", DSPFIX_CHAIN_RFFT, {110, 110, 45}},
+    {"fir+biquad+rfft", DSPFIX_CHAIN_FIR | DSPFIX_CHAIN_BIQUAD | DSPFIX_CHAIN_RFFT, {110, 100, 40}},
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Smallest power of two that brings a magnitude below 1
+ * @param fMax - Largest magnitude
+ * @param fLimit - Largest magnitude allowed after the shift
+ * @retval Shift, 0 when fMax is within fLimit
+ */
+static int8_t DSPFIX_Headroom(float32_t fMax, float32_t fLimit)
+{
+    int8_t nShift = 0;
+
+    while (fMax > fLimit && nShift < 31)
+    {
+        fMax *= 0.5f;
+        nShift++;
+    }
+
+    return nShift;
+}
+
+/**
+ * @brief Round to q31 with saturation, unlike arm_float_to_q31 which truncates
+ * @param fValue - Value in [-1, 1)
+ * @retval q31 value
+ */
+static q31_t DSPFIX_RoundQ31(float32_t fValue)
+{
+    return clip_q63_to_q31((q63_t)llrintf(fValue * 2147483648.0f));
+}
+
+/**
+ * @brief Round to q15 with saturation
+ * @param fValue - Value in [-1, 1)
+ * @retval q15 value
+ */
+static q15_t DSPFIX_RoundQ15(float32_t fValue)
+{
+    return (q15_t)__SSAT((q31_t)lrintf(fValue * 32768.0f), 16);
+}
+
+/*
+ * The runs below are dspfix_run_t, the same source for each type: the
+ * macros in dspfix.h pick every kernel from the instances and buffers. The
+ * output goes back to float with the shifts of the helpers undone.
+ */
+#define DSPFIX_RUN(szSuffix, T, pField, T_FIR, T_BIQUAD, T_RFFT)                                                 \
+    static nhns_status_t DSPFIX_Run##szSuffix(dspfix_work_t *psWork, uint8_t bChain, uint32_t *pdwTicks)         \
+    {                                                                                                            \
+        T_FIR sFir;                                                                                              \
+        T_BIQUAD sBiquad;                                                                                        \
+        T_RFFT sRfft;                                                                                            \
+        T *pSrc            = psWork->uA.pField;                                                                  \
+        T *pDst            = psWork->uB.pField;                                                                  \
+        T *pSwap           = NULL;                                                                               \
+        int8_t nFirShift   = DSPFIX_FirCoeffs(psWork->afTaps, DSPFIX_BENCH_TAPS, psWork->uTaps.pField);          \
+        int8_t nPostShift  = DSPFIX_BiquadCoeffs(psWork->afBiquad, DSPFIX_BENCH_STAGES, psWork->uBiquad.pField); \
+        int8_t nShift      = 0;                                                                                  \
+        uint32_t dwStart   = 0;                                                                                  \
+        nhns_status_t nRet = NHNS_STATUS_OK;                                                                     \
+                                                                                                                 \
+        memset(&psWork->uFirState, 0, sizeof(psWork->uFirState));                                                \
+        memset(&psWork->uBiquadState, 0, sizeof(psWork->uBiquadState));                                          \
+        nRet = DSPFIX_FirInit(&sFir, DSPFIX_BENCH_TAPS, psWork->uTaps.pField, psWork->uFirState.pField,          \
+                              DSPFIX_BENCH_SIZE);                                                                \
+        if (nRet == NHNS_STATUS_OK)                                                                              \
+        {                                                                                                        \
+            nRet = DSPFIX_BiquadInit(&sBiquad, DSPFIX_BENCH_STAGES, psWork->uBiquad.pField,                      \
+                                     psWork->uBiquadState.pField, nPostShift);                                   \
+        }                                                                                                        \
+        if (nRet == NHNS_STATUS_OK)                                                                              \
+        {                                                                                                        \
+            nRet = DSPFIX_RfftInit(&sRfft, DSPFIX_BENCH_SIZE);                                                   \
+        }                                                                                                        \
+        if (nRet != NHNS_STATUS_OK)                                                                              \
+        {                                                                                                        \
+            return nRet;                                                                                         \
+        }                                                                                                        \
+        DSPFIX_FromFloat(psWork->afInput, pSrc, DSPFIX_BENCH_SIZE);                                              \
+                                                                                                                 \
+        dwStart = PROFILER_GetCycles();                                                                          \
+        if (bChain & DSPFIX_CHAIN_FIR)                                                                           \
+        {                                                                                                        \
+            DSPFIX_Fir(&sFir, pSrc, pDst, DSPFIX_BENCH_SIZE);                                                    \
+            nShift += nFirShift;                                                                                 \
+            pSwap = pSrc, pSrc = pDst, pDst = pSwap;                                                             \
+        }                                                                                                        \
+        if (bChain & DSPFIX_CHAIN_BIQUAD)                                                                        \
+        {                                                                                                        \
+            DSPFIX_Biquad(&sBiquad, pSrc, pDst, DSPFIX_BENCH_SIZE);                                              \
+            pSwap = pSrc, pSrc = pDst, pDst = pSwap;                                                             \
+        }                                                                                                        \
+        if (bChain & DSPFIX_CHAIN_RFFT)                                                                          \
+        {                                                                                                        \
+            nShift -= DSPFIX_Normalize(pSrc, DSPFIX_BENCH_SIZE);                                                 \
+            DSPFIX_Rfft(&sRfft, pSrc, pDst);                                                                     \
+            nShift += DSPFIX_RfftShift(&sRfft, DSPFIX_BENCH_SIZE);                                               \
+            pSwap = pSrc, pSrc = pDst, pDst = pSwap;                                                             \
+        }                                                                                                        \
+        *pdwTicks = PROFILER_GetCycles() - dwStart;                                                              \
+                                                                                                                 \
+        DSPFIX_ToFloat(pSrc, psWork->afOut, DSPFIX_RFFT_OUTPUT(T, DSPFIX_BENCH_SIZE), nShift);                   \
+        return NHNS_STATUS_OK;                                                                                   \
+    }
+
+DSPFIX_RUN(F32, float32_t, af, arm_fir_instance_f32, arm_biquad_cascade_df2T_instance_f32, arm_rfft_fast_instance_f32)
+DSPFIX_RUN(Q31, q31_t, an, arm_fir_instance_q31, arm_biquad_casd_df1_inst_q31, arm_rfft_instance_q31)
+DSPFIX_RUN(Q15, q15_t, aw, arm_fir_instance_q15, arm_biquad_casd_df1_inst_q15, arm_rfft_instance_q15)
+
+static const dspfix_run_t gapfnRuns[DSPFIX_TYPE_MAX] = {DSPFIX_RunF32, DSPFIX_RunQ31, DSPFIX_RunQ15};
+
+/**
+ * @brief Design the benchmark's filters and input
+ * @param psWork - Returns afInput, afTaps, afBiquad and adCos
+ */
+static void DSPFIX_Design(dspfix_work_t *psWork)
+{
+    // Second-order Butterworth low-pass at a tenth of the sample rate, as Service/dspbench
+    static const float32_t afStage[5] = {0.067455f, 0.134911f, 0.067455f, 1.142980f, -0.412802f};
+    uint32_t dwSeed                   = DSPFIX_SEED;
+    float32_t fSum                    = 0.0f;
+
+    // 1) Hamming-windowed sinc, symmetric so that the time-reversed order is the same, unity gain at DC
+    for (uint32_t dwTap = 0; dwTap < DSPFIX_BENCH_TAPS; dwTap++)
+    {
+        float32_t fAngle  = 2.0f * PI * DSPFIX_BENCH_CUTOFF * ((float32_t)dwTap - (DSPFIX_BENCH_TAPS - 1) / 2.0f);
+        float32_t fWindow = 0.54f - 0.46f * cosf(2.0f * PI * (float32_t)dwTap / (DSPFIX_BENCH_TAPS - 1));
+
+        psWork->afTaps[dwTap] = sinf(fAngle) / fAngle * fWindow;    // An even count of taps never hits 0
+        fSum += psWork->afTaps[dwTap];
+    }
+    for (uint32_t dwTap = 0; dwTap < DSPFIX_BENCH_TAPS; dwTap++)
+    {
+        psWork->afTaps[dwTap] /= fSum;
+    }
+    for (uint32_t dwStage = 0; dwStage < DSPFIX_BENCH_STAGES; dwStage++)
+    {
+        memcpy(&psWork->afBiquad[5 * dwStage], afStage, sizeof(afStage));
+    }
+
+    // 2) A tone in the pass band, one in the stop band and a little noise, between bins so the FFT leaks
+    for (uint32_t dwIndex = 0; dwIndex < DSPFIX_BENCH_SIZE; dwIndex++)
+    {
+        float32_t fTime = 2.0f * PI * (float32_t)dwIndex / (float32_t)DSPFIX_BENCH_SIZE;
+
+        dwSeed                   = dwSeed * 1664525UL + 1013904223UL;
+        psWork->afInput[dwIndex] = 0.4f * sinf(9.5f * fTime) + 0.25f * sinf(61.0f * fTime + 1.0f) +
+                                   (float32_t)(int32_t)dwSeed / 4294967296.0f / 25.0f;
+        psWork->adCos[dwIndex]   = cos(2.0 * DSPFIX_PI_DOUBLE * (double)dwIndex / DSPFIX_BENCH_SIZE);
+    }
+}
+
+/**
+ * @brief Run a chain in double precision on the float input
+ * @param psWork - Input and designs, returns adRef
+ * @param bChain - DSPFIX_CHAIN_ flags
+ * @retval Number of values in adRef
+ */
+static uint32_t DSPFIX_Reference(dspfix_work_t *psWork, uint8_t bChain)
+{
+    double *pdSignal = psWork->adSignal;
+
+    for (uint32_t dwIndex = 0; dwIndex < DSPFIX_BENCH_SIZE; dwIndex++)
+    {
+        pdSignal[dwIndex] = psWork->afInput[dwIndex];
+    }
+
+    // 1) FIR from rest, in place from the end
+    if (bChain & DSPFIX_CHAIN_FIR)
+    {
+        for (uint32_t dwIndex = DSPFIX_BENCH_SIZE; dwIndex-- > 0;)
+        {
+            double dSum = 0.0;
+
+            for (uint32_t dwTap = 0; dwTap < DSPFIX_BENCH_TAPS && dwTap <= dwIndex; dwTap++)
+            {
+                dSum += (double)psWork->afTaps[dwTap] * pdSignal[dwIndex - dwTap];
+            }
+            pdSignal[dwIndex] = dSum;
+        }
+    }
+
+    // 2) Each biquad stage from rest, direct form I
+    for (uint32_t dwStage = 0; dwStage < DSPFIX_BENCH_STAGES && (bChain & DSPFIX_CHAIN_BIQUAD); dwStage++)
+    {
+        const float32_t *pfStage = &psWork->afBiquad[5 * dwStage];
+        double adX[2]            = {0.0, 0.0};
+        double adY[2]            = {0.0, 0.0};
+
+        for (uint32_t dwIndex = 0; dwIndex < DSPFIX_BENCH_SIZE; dwIndex++)
+        {
+            double dIn  = pdSignal[dwIndex];
+            double dOut = pfStage[0] * dIn + pfStage[1] * adX[0] + pfStage[2] * adX[1] + pfStage[3] * adY[0] +
+                          pfStage[4] * adY[1];
+
+            adX[1]            = adX[0];
+            adX[0]            = dIn;
+            adY[1]            = adY[0];
+            adY[0]            = dOut;
+            pdSignal[dwIndex] = dOut;
+        }
+    }
+
+    // 3) DFT from DC to Nyquist, re and im of each bin
+    if (bChain & DSPFIX_CHAIN_RFFT)
+    {
+        for (uint32_t dwBin = 0; dwBin <= DSPFIX_BENCH_SIZE / 2; dwBin++)
+        {
+            double dReal = 0.0;
+            double dImag = 0.0;
+
+            for (uint32_t dwIndex = 0; dwIndex < DSPFIX_BENCH_SIZE; dwIndex++)
+            {
+                uint32_t dwPhase = (dwBin * dwIndex) % DSPFIX_BENCH_SIZE;
+
+                dReal += pdSignal[dwIndex] * psWork->adCos[dwPhase];
+                dImag -= pdSignal[dwIndex] * psWork->adCos[(dwPhase + 3 * DSPFIX_BENCH_SIZE / 4) % DSPFIX_BENCH_SIZE];
+            }
+            psWork->adRef[2 * dwBin]     = dReal;
+            psWork->adRef[2 * dwBin + 1] = dImag;
+        }
+        return DSPFIX_BENCH_SIZE + 2;
+    }
+
+    memcpy(psWork->adRef, pdSignal, DSPFIX_BENCH_SIZE * sizeof(double));
+    return DSPFIX_BENCH_SIZE;
+}
+
+/**
+ * @brief Signal to noise ratio of afOut, with adRef as signal
+ * @param psWork - Outputs to compare
+ * @param dwCount - Number of values
+ * @retval Whole dB, DSPFIX_SNR_EXACT when the outputs are identical
+ */
+static uint32_t DSPFIX_Snr(const dspfix_work_t *psWork, uint32_t dwCount)
+{
+    double dSignal = 0.0;
+    double dNoise  = 0.0;
+    double dSnr    = 0.0;
+
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        double dRef   = psWork->adRef[dwIndex];
+        double dError = dRef - (double)psWork->afOut[dwIndex];
+
+        dSignal += dRef * dRef;
+        dNoise  += dError * dError;
+    }
+    if (dNoise == 0.0)
+    {
+        return DSPFIX_SNR_EXACT;
+    }
+
+    dSnr = 10.0 * log10(dSignal / dNoise);
+    return (dSnr > 0.0) ? (uint32_t)dSnr : 0;
+}
+
+// --- Functions ---
+
+nhns_status_t DSPFIX_FirInitF32(arm_fir_instance_f32 *psFir, uint16_t wTaps, const float32_t *pCoeffs,
+                                float32_t *pState, uint32_t dwBlock)
+{
+    if (psFir == NULL || pCoeffs == NULL || pState == NULL || wTaps == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    arm_fir_init_f32(psFir, wTaps, pCoeffs, pState, dwBlock);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_FirInitQ31(arm_fir_instance_q31 *psFir, uint16_t wTaps, const q31_t *pCoeffs, q31_t *pState,
+                                uint32_t dwBlock)
+{
+    if (psFir == NULL || pCoeffs == NULL || pState == NULL || wTaps == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    arm_fir_init_q31(psFir, wTaps, pCoeffs, pState, dwBlock);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_FirInitQ15(arm_fir_instance_q15 *psFir, uint16_t wTaps, const q15_t *pCoeffs, q15_t *pState,
+                                uint32_t dwBlock)
+{
+    if (psFir == NULL || pCoeffs == NULL || pState == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Odd or fewer than 4 taps
+    if (arm_fir_init_q15(psFir, wTaps, pCoeffs, pState, dwBlock) != ARM_MATH_SUCCESS)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_BiquadInitF32(arm_biquad_cascade_df2T_instance_f32 *psBiquad, uint8_t bStages,
+                                   const float32_t *pCoeffs, float32_t *pState, int8_t nPostShift)
+{
+    if (psBiquad == NULL || pCoeffs == NULL || pState == NULL || bStages == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (nPostShift != 0)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    arm_biquad_cascade_df2T_init_f32(psBiquad, bStages, pCoeffs, pState);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_BiquadInitQ31(arm_biquad_casd_df1_inst_q31 *psBiquad, uint8_t bStages, const q31_t *pCoeffs,
+                                   q31_t *pState, int8_t nPostShift)
+{
+    if (psBiquad == NULL || pCoeffs == NULL || pState == NULL || bStages == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (nPostShift < 0 || nPostShift > 31)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    arm_biquad_cascade_df1_init_q31(psBiquad, bStages, pCoeffs, pState, nPostShift);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_BiquadInitQ15(arm_biquad_casd_df1_inst_q15 *psBiquad, uint8_t bStages, const q15_t *pCoeffs,
+                                   q15_t *pState, int8_t nPostShift)
+{
+    if (psBiquad == NULL || pCoeffs == NULL || pState == NULL || bStages == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (nPostShift < 0 || nPostShift > 15)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    arm_biquad_cascade_df1_init_q15(psBiquad, bStages, pCoeffs, pState, nPostShift);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPFIX_RfftInitF32(arm_rfft_fast_instance_f32 *psRfft, uint16_t wSize)
+{
+    if (psRfft == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    return (arm_rfft_fast_init_f32(psRfft, wSize) == ARM_MATH_SUCCESS) ? NHNS_STATUS_OK
+                                                                       : NHNS_STATUS_INVALID_CONFIGURATION;
+}
+
+nhns_status_t DSPFIX_RfftInitQ31(arm_rfft_instance_q31 *psRfft, uint16_t wSize)
+{
+    if (psRfft == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    return (arm_rfft_init_q31(psRfft, wSize, 0, 1) == ARM_MATH_SUCCESS) ? NHNS_STATUS_OK
+                                                                        : NHNS_STATUS_INVALID_CONFIGURATION;
+}
+
+nhns_status_t DSPFIX_RfftInitQ15(arm_rfft_instance_q15 *psRfft, uint16_t wSize)
+{
+    if (psRfft == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    return (arm_rfft_init_q15(psRfft, wSize, 0, 1) == ARM_MATH_SUCCESS) ? NHNS_STATUS_OK
+                                                                        : NHNS_STATUS_INVALID_CONFIGURATION;
+}
+
+void DSPFIX_RfftF32(arm_rfft_fast_instance_f32 *psRfft, float32_t *pfSrc, float32_t *pfDst)
+{
+    arm_rfft_fast_f32(psRfft, pfSrc, pfDst, 0);
+}
+
+int8_t DSPFIX_FirCoeffsF32(const float32_t *pfTaps, uint16_t wTaps, float32_t *pfCoeffs)
+{
+    memcpy(pfCoeffs, pfTaps, wTaps * sizeof(float32_t));
+
+    return 0;
+}
+
+int8_t DSPFIX_FirCoeffsQ31(const float32_t *pfTaps, uint16_t wTaps, q31_t *pnCoeffs)
+{
+    float32_t fSum   = 0.0f;
+    float32_t fScale = 0.0f;
+    int8_t nShift    = 0;
+
+    // 1) The absolute sum bounds every output, so at most 1 neither saturates nor overflows the accumulator
+    for (uint32_t dwTap = 0; dwTap < wTaps; dwTap++)
+    {
+        fSum += fabsf(pfTaps[dwTap]);
+    }
+    nShift = DSPFIX_Headroom(fSum, 1.0f);
+    fScale = ldexpf(1.0f, -nShift);
+
+    for (uint32_t dwTap = 0; dwTap < wTaps; dwTap++)
+    {
+        pnCoeffs[dwTap] = DSPFIX_RoundQ31(pfTaps[dwTap] * fScale);
+    }
+
+    return nShift;
+}
+
+int8_t DSPFIX_FirCoeffsQ15(const float32_t *pfTaps, uint16_t wTaps, q15_t *pwCoeffs)
+{
+    float32_t fSum   = 0.0f;
+    float32_t fScale = 0.0f;
+    int8_t nShift    = 0;
+
+    for (uint32_t dwTap = 0; dwTap < wTaps; dwTap++)
+    {
+        fSum += fabsf(pfTaps[dwTap]);
+    }
+    nShift = DSPFIX_Headroom(fSum, 1.0f);
+    fScale = ldexpf(1.0f, -nShift);
+
+    for (uint32_t dwTap = 0; dwTap < wTaps; dwTap++)
+    {
+        pwCoeffs[dwTap] = DSPFIX_RoundQ15(pfTaps[dwTap] * fScale);
+    }
+
+    return nShift;
+}
+
+int8_t DSPFIX_BiquadCoeffsF32(const float32_t *pfCoeffs, uint8_t bStages, float32_t *pfDst)
+{
+    memcpy(pfDst, pfCoeffs, 5U * bStages * sizeof(float32_t));
+
+    return 0;
+}
+
+int8_t DSPFIX_BiquadCoeffsQ31(const float32_t *pfCoeffs, uint8_t bStages, q31_t *pnDst)
+{
+    float32_t fMax   = 0.0f;
+    float32_t fScale = 0.0f;
+    int8_t nShift    = 0;
+
+    // 1) One postShift for the cascade, the kernel multiplies it back after each stage
+    for (uint32_t dwIndex = 0; dwIndex < 5U * bStages; dwIndex++)
+    {
+        fMax = (fabsf(pfCoeffs[dwIndex]) > fMax) ? fabsf(pfCoeffs[dwIndex]) : fMax;
+    }
+    nShift = DSPFIX_Headroom(fMax, 0.99999f);
+    fScale = ldexpf(1.0f, -nShift);
+
+    for (uint32_t dwIndex = 0; dwIndex < 5U * bStages; dwIndex++)
+    {
+        pnDst[dwIndex] = DSPFIX_RoundQ31(pfCoeffs[dwIndex] * fScale);
+    }
+
+    return nShift;
+}
+
+int8_t DSPFIX_BiquadCoeffsQ15(const float32_t *pfCoeffs, uint8_t bStages, q15_t *pwDst)
+{
+    float32_t fMax   = 0.0f;
+    float32_t fScale = 0.0f;
+    int8_t nShift    = 0;
+
+    for (uint32_t dwIndex = 0; dwIndex < 5U * bStages; dwIndex++)
+    {
+        fMax = (fabsf(pfCoeffs[dwIndex]) > fMax) ? fabsf(pfCoeffs[dwIndex]) : fMax;
+    }
+    nShift = DSPFIX_Headroom(fMax, 0.9999f);
+    fScale = ldexpf(1.0f, -nShift);
+
+    // 2) q15 stages are b0, 0, b1, b2, a1, a2, the zero pads the pairs the kernel reads
+    for (uint32_t dwStage = 0; dwStage < bStages; dwStage++)
+    {
+        const float32_t *pfStage = &pfCoeffs[5 * dwStage];
+        q15_t *pwStage           = &pwDst[6 * dwStage];
+
+        pwStage[0] = DSPFIX_RoundQ15(pfStage[0] * fScale);
+        pwStage[1] = 0;
+        pwStage[2] = DSPFIX_RoundQ15(pfStage[1] * fScale);
+        pwStage[3] = DSPFIX_RoundQ15(pfStage[2] * fScale);
+        pwStage[4] = DSPFIX_RoundQ15(pfStage[3] * fScale);
+        pwStage[5] = DSPFIX_RoundQ15(pfStage[4] * fScale);
+    }
+
+    return nShift;
+}
+
+void DSPFIX_FromFloatF32(const float32_t *pfSrc, float32_t *pfDst, uint32_t dwCount)
+{
+    memmove(pfDst, pfSrc, dwCount * sizeof(float32_t));
+}
+
+void DSPFIX_ToFloatF32(const float32_t *pfSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift)
+{
+    arm_scale_f32(pfSrc, ldexpf(1.0f, nShift), pfDst, dwCount);
+}
+
+void DSPFIX_ToFloatQ31(const q31_t *pnSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift)
+{
+    arm_q31_to_float(pnSrc, pfDst, dwCount);
+    arm_scale_f32(pfDst, ldexpf(1.0f, nShift), pfDst, dwCount);
+}
+
+void DSPFIX_ToFloatQ15(const q15_t *pwSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift)
+{
+    arm_q15_to_float(pwSrc, pfDst, dwCount);
+    arm_scale_f32(pfDst, ldexpf(1.0f, nShift), pfDst, dwCount);
+}
+
+int8_t DSPFIX_NormalizeF32(float32_t *pfData, uint32_t dwCount)
+{
+    (void)pfData;
+    (void)dwCount;
+
+    return 0;
+}
+
+int8_t DSPFIX_NormalizeQ31(q31_t *pnData, uint32_t dwCount)
+{
+    uint32_t dwMax = 0;
+    int8_t nShift  = 0;
+
+    // 1) Leading zeros of the largest magnitude past the sign bit
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        uint32_t dwMagnitude = (pnData[dwIndex] < 0) ? 0U - (uint32_t)pnData[dwIndex] : (uint32_t)pnData[dwIndex];
+
+        dwMax = (dwMagnitude > dwMax) ? dwMagnitude : dwMax;
+    }
+    if (dwMax == 0 || dwMax > INT32_MAX)
+    {
+        return 0;
+    }
+    nShift = (int8_t)(__CLZ(dwMax) - 1U);
+
+    for (uint32_t dwIndex = 0; dwIndex < dwCount && nShift != 0; dwIndex++)
+    {
+        pnData[dwIndex] = (q31_t)((uint32_t)pnData[dwIndex] << nShift);
+    }
+
+    return nShift;
+}
+
+int8_t DSPFIX_NormalizeQ15(q15_t *pwData, uint32_t dwCount)
+{
+    uint32_t dwMax = 0;
+    int8_t nShift  = 0;
+
+    for (uint32_t dwIndex = 0; dwIndex < dwCount; dwIndex++)
+    {
+        uint32_t dwMagnitude = (uint32_t)((pwData[dwIndex] < 0) ? -pwData[dwIndex] : pwData[dwIndex]);
+
+        dwMax = (dwMagnitude > dwMax) ? dwMagnitude : dwMax;
+    }
+    if (dwMax == 0 || dwMax > INT16_MAX)
+    {
+        return 0;
+    }
+    nShift = (int8_t)(__CLZ(dwMax) - 17U);
+
+    for (uint32_t dwIndex = 0; dwIndex < dwCount && nShift != 0; dwIndex++)
+    {
+        pwData[dwIndex] = (q15_t)((uint16_t)pwData[dwIndex] << nShift);
+    }
+
+    return nShift;
+}
+
+nhns_status_t DSPFIX_Benchmark(uart_instance_t nID)
+{
+    dspfix_work_t *psWork = NULL;
+    nhns_status_t nRet    = NHNS_STATUS_OK;
+    uint32_t dwFailed     = 0;
+    char szLine[DSPFIX_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Buffers for one chain at a time, about 25 KB
+    psWork = HEAP_Alloc(sizeof(dspfix_work_t), HEAP_REGION_DEFAULT);
+    if (psWork == NULL)
+    {
+        return NHNS_STATUS_NO_MEMORY;
+    }
+    DSPFIX_Design(psWork);
+
+    // 2) Header, one column pair per type
+    nLength = snprintf(szLine, sizeof(szLine), "dspfix: facade %s, best of %u runs at %u samples, %lu ticks/s\r\n",
+                       DSPFIX_FORMAT_NAME, DSPFIX_ROUNDS, DSPFIX_BENCH_SIZE,
+                       (unsigned long)PROFILER_GetCyclesPerSecond());
+    nRet    = UART_PrintLine(nID, szLine, nLength, DSPFIX_LINE_SIZE);
+    nLength = snprintf(szLine, sizeof(szLine), "  %-18s", "chain");
+    for (uint32_t dwType = 0; dwType < DSPFIX_TYPE_MAX && nLength < DSPFIX_LINE_SIZE; dwType++)
+    {
+        nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, " %s /sample    snr", gaszTypeNames[dwType]);
+    }
+    if (nLength < DSPFIX_LINE_SIZE)
+    {
+        nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, "\r\n");
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = UART_PrintLine(nID, szLine, nLength, DSPFIX_LINE_SIZE);
+    }
+
+    // 3) Each chain in each type against the same chain in double
+    for (uint32_t dwChain = 0; dwChain < sizeof(gasChains) / sizeof(gasChains[0]) && nRet == NHNS_STATUS_OK; dwChain++)
+    {
+        const dspfix_chain_t *psChain = &gasChains[dwChain];
+        uint32_t dwCount              = DSPFIX_Reference(psWork, psChain->bChain);
+
+        nLength = snprintf(szLine, sizeof(szLine), "  %-18s", psChain->szName);
+        for (uint32_t dwType = 0; dwType < DSPFIX_TYPE_MAX && nRet == NHNS_STATUS_OK; dwType++)
+        {
+            uint32_t dwBest   = UINT32_MAX;
+            uint32_t dwTicks  = 0;
+            uint32_t dwTenths = 0;
+            uint32_t dwSnr    = 0;
+
+            for (uint32_t dwRound = 0; dwRound < DSPFIX_ROUNDS && nRet == NHNS_STATUS_OK; dwRound++)
+            {
+                nRet   = gapfnRuns[dwType](psWork, psChain->bChain, &dwTicks);
+                dwBest = (dwTicks < dwBest) ? dwTicks : dwBest;
+            }
+
+            // The f32 FFT packs Nyquist into the imaginary part of DC
+            if (dwType == DSPFIX_TYPE_F32 && (psChain->bChain & DSPFIX_CHAIN_RFFT))
+            {
+                psWork->afOut[DSPFIX_BENCH_SIZE]     = psWork->afOut[1];
+                psWork->afOut[DSPFIX_BENCH_SIZE + 1] = 0.0f;
+                psWork->afOut[1]                     = 0.0f;
+            }
+
+            dwSnr    = DSPFIX_Snr(psWork, dwCount);
+            dwTenths = (uint32_t)((uint64_t)dwBest * 10 / DSPFIX_BENCH_SIZE);
+            if (dwSnr != DSPFIX_SNR_EXACT && dwSnr < psChain->adwSnr[dwType])
+            {
+                dwFailed++;
+            }
+            if (nLength < DSPFIX_LINE_SIZE)
+            {
+                nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, " %9lu.%lu %3lu dB%s",
+                                    (unsigned long)(dwTenths / 10), (unsigned long)(dwTenths % 10),
+                                    (unsigned long)((dwSnr == DSPFIX_SNR_EXACT) ? 999 : dwSnr),
+                                    (dwSnr != DSPFIX_SNR_EXACT && dwSnr < psChain->adwSnr[dwType]) ? " FAIL" : "");
+            }
+        }
+        if (nLength < DSPFIX_LINE_SIZE)
+        {
+            nLength += snprintf(szLine + nLength, sizeof(szLine) - nLength, "\r\n");
+        }
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = UART_PrintLine(nID, szLine, nLength, DSPFIX_LINE_SIZE);
+        }
+    }
+
+    // 4) Verdict
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "dspfix: %lu chains, %lu results below their SNR threshold\r\n",
+                           (unsigned long)(sizeof(gasChains) / sizeof(gasChains[0])), (unsigned long)dwFailed);
+        nRet    = UART_PrintLine(nID, szLine, nLength, DSPFIX_LINE_SIZE);
+    }
+    if (nRet == NHNS_STATUS_OK && dwFailed != 0)
+    {
+        nRet = NHNS_STATUS_DATA_MISMATCH;
+    }
+
+    HEAP_Free(psWork);
+
+    return nRet;
+}
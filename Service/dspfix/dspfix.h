@@ -0,0 +1,261 @@
+#ifndef __DSPFIX_H__
+#define __DSPFIX_H__
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * One set of FIR, biquad and real FFT calls over the three CMSIS-DSP data
+ * types. The macros below pick the kernel from the type of the instance or
+ * the samples with _Generic, so code written on dspfix_sample_t builds for
+ * whichever type DSPFIX_FORMAT selects:
+ *
+ * - on the target q15, because the Cortex-M3 has no FPU and every _f32
+ *   kernel runs on soft-float;
+ * - on the host f32, unless DSPFIX_FORMAT is defined on the command line.
+ *
+ * The fixed-point kernels are the _fast ones, which accumulate in 32 bits.
+ * They stay exact only with headroom, so the coefficient helpers scale the
+ * float design into range and return the power of two they took out:
+ *
+ * - DSPFIX_FirCoeffs scales the taps so that their absolute sum is at most 1.
+ *   The output is then never saturated and comes out 2^-shift too small.
+ * - DSPFIX_BiquadCoeffs returns the postShift for DSPFIX_BiquadInit, which
+ *   the kernel puts back, so the response is unchanged.
+ *
+ * DSPFIX_Normalize shifts a block up to full scale before a kernel that loses
+ * bits to its own scaling, the FFT, and returns the shift to undo afterwards.
+ * The fixed-point FFTs scale down by DSPFIX_RfftShift of their size.
+ *
+ * The f32 FFT packs its output as DC, Nyquist and the bins between; the
+ * fixed-point ones write a real and an imaginary part for every bin.
+ */
+
+#define DSPFIX_FORMAT_F32 0
+#define DSPFIX_FORMAT_Q31 1
+#define DSPFIX_FORMAT_Q15 2
+
+#ifndef DSPFIX_FORMAT
+#ifdef NHNS_HOST
+#define DSPFIX_FORMAT DSPFIX_FORMAT_F32
+#else
+#define DSPFIX_FORMAT DSPFIX_FORMAT_Q15
+#endif
+#endif
+
+// Elements of the arrays each kernel takes, for the type T
+#define DSPFIX_FIR_STATE(T, wTaps, dwBlock) ((uint32_t)(wTaps) + (uint32_t)(dwBlock))
+#define DSPFIX_BIQUAD_COEFFS(T, bStages)    (_Generic((T *)0, q15_t *: 6U, default: 5U) * (uint32_t)(bStages))
+#define DSPFIX_BIQUAD_STATE(T, bStages)     (_Generic((T *)0, float32_t *: 2U, default: 4U) * (uint32_t)(bStages))
+#define DSPFIX_RFFT_OUTPUT(T, wSize)        (_Generic((T *)0, float32_t *: 1U, default: 2U) * (uint32_t)(wSize))
+
+// --- Types ---
+
+#if DSPFIX_FORMAT == DSPFIX_FORMAT_F32
+typedef float32_t dspfix_sample_t;
+typedef arm_fir_instance_f32 dspfix_fir_t;
+typedef arm_biquad_cascade_df2T_instance_f32 dspfix_biquad_t;
+typedef arm_rfft_fast_instance_f32 dspfix_rfft_t;
+#define DSPFIX_FORMAT_NAME "f32"
+#elif DSPFIX_FORMAT == DSPFIX_FORMAT_Q31
+typedef q31_t dspfix_sample_t;
+typedef arm_fir_instance_q31 dspfix_fir_t;
+typedef arm_biquad_casd_df1_inst_q31 dspfix_biquad_t;
+typedef arm_rfft_instance_q31 dspfix_rfft_t;
+#define DSPFIX_FORMAT_NAME "q31"
+#elif DSPFIX_FORMAT == DSPFIX_FORMAT_Q15
+typedef q15_t dspfix_sample_t;
+typedef arm_fir_instance_q15 dspfix_fir_t;
+typedef arm_biquad_casd_df1_inst_q15 dspfix_biquad_t;
+typedef arm_rfft_instance_q15 dspfix_rfft_t;
+#define DSPFIX_FORMAT_NAME "q15"
+#else
+#error "DSPFIX_FORMAT must be DSPFIX_FORMAT_F32, DSPFIX_FORMAT_Q31 or DSPFIX_FORMAT_Q15"
+#endif
+
+// --- Type-Generic Calls ---
+
+// Kernels, chosen by the instance
+#define DSPFIX_FirInit(psFir, wTaps, pCoeffs, pState, dwBlock) \
+    _Generic((psFir),                                          \
+        arm_fir_instance_f32 *: DSPFIX_FirInitF32,             \
+        arm_fir_instance_q31 *: DSPFIX_FirInitQ31,             \
+        arm_fir_instance_q15 *: DSPFIX_FirInitQ15)((psFir), (wTaps), (pCoeffs), (pState), (dwBlock))
+#define DSPFIX_Fir(psFir, pSrc, pDst, dwBlock)    \
+    _Generic((psFir),                             \
+        arm_fir_instance_f32 *: arm_fir_f32,      \
+        arm_fir_instance_q31 *: arm_fir_fast_q31, \
+        arm_fir_instance_q15 *: arm_fir_fast_q15)((psFir), (pSrc), (pDst), (dwBlock))
+
+#define DSPFIX_BiquadInit(psBiquad, bStages, pCoeffs, pState, nPostShift) \
+    _Generic((psBiquad),                                                  \
+        arm_biquad_cascade_df2T_instance_f32 *: DSPFIX_BiquadInitF32,     \
+        arm_biquad_casd_df1_inst_q31 *: DSPFIX_BiquadInitQ31,             \
+        arm_biquad_casd_df1_inst_q15 *: DSPFIX_BiquadInitQ15)((psBiquad), (bStages), (pCoeffs), (pState), (nPostShift))
+#define DSPFIX_Biquad(psBiquad, pSrc, pDst, dwBlock)                         \
+    _Generic((psBiquad),                                                     \
+        arm_biquad_cascade_df2T_instance_f32 *: arm_biquad_cascade_df2T_f32, \
+        arm_biquad_casd_df1_inst_q31 *: arm_biquad_cascade_df1_fast_q31,     \
+        arm_biquad_casd_df1_inst_q15 *: arm_biquad_cascade_df1_fast_q15)((psBiquad), (pSrc), (pDst), (dwBlock))
+
+#define DSPFIX_RfftInit(psRfft, wSize)                    \
+    _Generic((psRfft),                                    \
+        arm_rfft_fast_instance_f32 *: DSPFIX_RfftInitF32, \
+        arm_rfft_instance_q31 *: DSPFIX_RfftInitQ31,      \
+        arm_rfft_instance_q15 *: DSPFIX_RfftInitQ15)((psRfft), (wSize))
+#define DSPFIX_Rfft(psRfft, pSrc, pDst)               \
+    _Generic((psRfft),                                \
+        arm_rfft_fast_instance_f32 *: DSPFIX_RfftF32, \
+        arm_rfft_instance_q31 *: arm_rfft_q31,        \
+        arm_rfft_instance_q15 *: arm_rfft_q15)((psRfft), (pSrc), (pDst))
+#define DSPFIX_RfftShift(psRfft, wSize) \
+    _Generic((psRfft), arm_rfft_fast_instance_f32 *: 0, default: (int8_t)(31U - __CLZ((uint32_t)(wSize))))
+
+// Scaling, chosen by the fixed-point side
+#define DSPFIX_FirCoeffs(pfTaps, wTaps, pCoeffs) \
+    _Generic((pCoeffs),                          \
+        float32_t *: DSPFIX_FirCoeffsF32,        \
+        q31_t *: DSPFIX_FirCoeffsQ31,            \
+        q15_t *: DSPFIX_FirCoeffsQ15)((pfTaps), (wTaps), (pCoeffs))
+#define DSPFIX_BiquadCoeffs(pfCoeffs, bStages, pCoeffs) \
+    _Generic((pCoeffs),                                 \
+        float32_t *: DSPFIX_BiquadCoeffsF32,            \
+        q31_t *: DSPFIX_BiquadCoeffsQ31,                \
+        q15_t *: DSPFIX_BiquadCoeffsQ15)((pfCoeffs), (bStages), (pCoeffs))
+#define DSPFIX_FromFloat(pfSrc, pDst, dwCount) \
+    _Generic((pDst),                           \
+        float32_t *: DSPFIX_FromFloatF32,      \
+        q31_t *: arm_float_to_q31,             \
+        q15_t *: arm_float_to_q15)((pfSrc), (pDst), (dwCount))
+#define DSPFIX_ToFloat(pSrc, pfDst, dwCount, nShift) \
+    _Generic((pSrc),                                 \
+        float32_t *: DSPFIX_ToFloatF32,              \
+        const float32_t *: DSPFIX_ToFloatF32,        \
+        q31_t *: DSPFIX_ToFloatQ31,                  \
+        const q31_t *: DSPFIX_ToFloatQ31,            \
+        q15_t *: DSPFIX_ToFloatQ15,                  \
+        const q15_t *: DSPFIX_ToFloatQ15)((pSrc), (pfDst), (dwCount), (nShift))
+#define DSPFIX_Normalize(pData, dwCount)  \
+    _Generic((pData),                     \
+        float32_t *: DSPFIX_NormalizeF32, \
+        q31_t *: DSPFIX_NormalizeQ31,     \
+        q15_t *: DSPFIX_NormalizeQ15)((pData), (dwCount))
+
+// --- Functions ---
+
+/**
+ * @brief Set up an FIR filter, the type-specific halves of DSPFIX_FirInit
+ * @param psFir - Instance to set up
+ * @param wTaps - Number of taps, even and at least 4 for q15
+ * @param pCoeffs - Taps in time-reversed order, kept by the instance
+ * @param pState - DSPFIX_FIR_STATE elements, kept by the instance
+ * @param dwBlock - Samples per call
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPFIX_FirInitF32(arm_fir_instance_f32 *psFir, uint16_t wTaps, const float32_t *pCoeffs,
+                                float32_t *pState, uint32_t dwBlock);
+nhns_status_t DSPFIX_FirInitQ31(arm_fir_instance_q31 *psFir, uint16_t wTaps, const q31_t *pCoeffs, q31_t *pState,
+                                uint32_t dwBlock);
+nhns_status_t DSPFIX_FirInitQ15(arm_fir_instance_q15 *psFir, uint16_t wTaps, const q15_t *pCoeffs, q15_t *pState,
+                                uint32_t dwBlock);
+
+/**
+ * @brief Set up a biquad cascade, the type-specific halves of DSPFIX_BiquadInit
+ * @param psBiquad - Instance to set up
+ * @param bStages - Number of second-order stages
+ * @param pCoeffs - DSPFIX_BIQUAD_COEFFS elements from DSPFIX_BiquadCoeffs, kept by the instance
+ * @param pState - DSPFIX_BIQUAD_STATE elements, kept by the instance
+ * @param nPostShift - Returned by DSPFIX_BiquadCoeffs, 0 for f32
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPFIX_BiquadInitF32(arm_biquad_cascade_df2T_instance_f32 *psBiquad, uint8_t bStages,
+                                   const float32_t *pCoeffs, float32_t *pState, int8_t nPostShift);
+nhns_status_t DSPFIX_BiquadInitQ31(arm_biquad_casd_df1_inst_q31 *psBiquad, uint8_t bStages, const q31_t *pCoeffs,
+                                   q31_t *pState, int8_t nPostShift);
+nhns_status_t DSPFIX_BiquadInitQ15(arm_biquad_casd_df1_inst_q15 *psBiquad, uint8_t bStages, const q15_t *pCoeffs,
+                                   q15_t *pState, int8_t nPostShift);
+
+/**
+ * @brief Set up a forward real FFT, the type-specific halves of DSPFIX_RfftInit
+ * @param psRfft - Instance to set up
+ * @param wSize - Points, a power of two from 32 to 4096
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPFIX_RfftInitF32(arm_rfft_fast_instance_f32 *psRfft, uint16_t wSize);
+nhns_status_t DSPFIX_RfftInitQ31(arm_rfft_instance_q31 *psRfft, uint16_t wSize);
+nhns_status_t DSPFIX_RfftInitQ15(arm_rfft_instance_q15 *psRfft, uint16_t wSize);
+
+/**
+ * @brief Forward arm_rfft_fast_f32 with the signature of the fixed-point FFTs
+ * @param psRfft - Instance
+ * @param pfSrc - wSize samples, overwritten
+ * @param pfDst - Returns the packed spectrum
+ */
+void DSPFIX_RfftF32(arm_rfft_fast_instance_f32 *psRfft, float32_t *pfSrc, float32_t *pfDst);
+
+/**
+ * @brief Convert float FIR taps, scaled down by a power of two until their absolute sum is at most 1
+ * @param pfTaps - Taps in time-reversed order
+ * @param wTaps - Number of taps
+ * @param pfCoeffs - Returns the taps in the kernel's type
+ * @retval Shift taken out, the filter's output is 2^-shift of the float design's
+ */
+int8_t DSPFIX_FirCoeffsF32(const float32_t *pfTaps, uint16_t wTaps, float32_t *pfCoeffs);
+int8_t DSPFIX_FirCoeffsQ31(const float32_t *pfTaps, uint16_t wTaps, q31_t *pnCoeffs);
+int8_t DSPFIX_FirCoeffsQ15(const float32_t *pfTaps, uint16_t wTaps, q15_t *pwCoeffs);
+
+/**
+ * @brief Convert float biquad coefficients to the kernel's layout, halved until they fit
+ * @param pfCoeffs - b0, b1, b2, a1, a2 for every stage, y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2
+ * @param bStages - Number of stages
+ * @param pfDst - Returns DSPFIX_BIQUAD_COEFFS elements in the kernel's type
+ * @retval postShift for DSPFIX_BiquadInit
+ */
+int8_t DSPFIX_BiquadCoeffsF32(const float32_t *pfCoeffs, uint8_t bStages, float32_t *pfDst);
+int8_t DSPFIX_BiquadCoeffsQ31(const float32_t *pfCoeffs, uint8_t bStages, q31_t *pnDst);
+int8_t DSPFIX_BiquadCoeffsQ15(const float32_t *pfCoeffs, uint8_t bStages, q15_t *pwDst);
+
+/**
+ * @brief Copy floats, the f32 half of DSPFIX_FromFloat
+ * @param pfSrc - Values to copy
+ * @param pfDst - Returns the values
+ * @param dwCount - Number of values
+ */
+void DSPFIX_FromFloatF32(const float32_t *pfSrc, float32_t *pfDst, uint32_t dwCount);
+
+/**
+ * @brief Convert to float, multiplied by 2^nShift to undo the scaling of the coefficient helpers, the FFT or
+ *        DSPFIX_Normalize
+ * @param pfSrc - Values to convert
+ * @param pfDst - Returns the values
+ * @param dwCount - Number of values
+ * @param nShift - Power of two to multiply by, may be negative
+ */
+void DSPFIX_ToFloatF32(const float32_t *pfSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift);
+void DSPFIX_ToFloatQ31(const q31_t *pnSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift);
+void DSPFIX_ToFloatQ15(const q15_t *pwSrc, float32_t *pfDst, uint32_t dwCount, int8_t nShift);
+
+/**
+ * @brief Shift a block up until its largest value is at full scale, the block floating point of fixed-point data
+ * @param pfData - Values, shifted in place
+ * @param dwCount - Number of values
+ * @retval Shift applied, the block is 2^shift of what it was; 0 for f32, which needs no headroom
+ */
+int8_t DSPFIX_NormalizeF32(float32_t *pfData, uint32_t dwCount);
+int8_t DSPFIX_NormalizeQ31(q31_t *pnData, uint32_t dwCount);
+int8_t DSPFIX_NormalizeQ15(q15_t *pwData, uint32_t dwCount);
+
+/**
+ * @brief Run the FIR, biquad and FFT chains in every type, print their ticks per sample and SNR
+ * @param nID - UART instance to print the report on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a chain falls below the SNR expected of its type,
+ *       NHNS_STATUS_NO_MEMORY when the buffers do not fit in the heap
+ */
+nhns_status_t DSPFIX_Benchmark(uart_instance_t nID);
+
+#endif    // __DSPFIX_H__
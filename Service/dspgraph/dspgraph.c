@@ -0,0 +1,767 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "dspgraph.h"
+#include "profiler.h"
+
+// --- Definitions ---
+
+#define DSPGRAPH_LINE_SIZE     128
+
+// Owner of a stage that is not a node: the caller writes the input and reads the output
+#define DSPGRAPH_CALLER_WRITES (-1)
+
+// Benchmark graph: DC block and 4x decimation of 1024 samples, then a windowed 256-point spectrum
+#define SPECTRUM_BLOCK         1024    // Input samples per iteration
+#define SPECTRUM_DECIMATION    4
+#define SPECTRUM_FIR_BLOCK     256     // Input samples per decimator firing
+#define SPECTRUM_FIR_TAPS      32
+#define SPECTRUM_FFT_SIZE      (SPECTRUM_BLOCK / SPECTRUM_DECIMATION)
+#define SPECTRUM_BINS          (SPECTRUM_FFT_SIZE / 2)
+#define SPECTRUM_DC_POLE       0.995f
+#define SPECTRUM_TONE_BIN      20      // Whole periods per input block
+#define SPECTRUM_ITERATIONS    32
+
+_Static_assert(SPECTRUM_BLOCK % SPECTRUM_FIR_BLOCK == 0, "The decimator must fire a whole number of times per iteration");
+_Static_assert(SPECTRUM_FIR_BLOCK % SPECTRUM_DECIMATION == 0, "arm_fir_decimate_f32 needs a block that is a multiple of the factor");
+_Static_assert((SPECTRUM_FFT_SIZE & (SPECTRUM_FFT_SIZE - 1)) == 0 && SPECTRUM_FFT_SIZE >= 32 && SPECTRUM_FFT_SIZE <= 4096,
+               "arm_rfft_fast_f32 takes powers of two from 32 to 4096");
+_Static_assert(SPECTRUM_TONE_BIN > 0 && SPECTRUM_TONE_BIN < SPECTRUM_BINS, "The test tone must fall in a bin other than DC");
+
+// --- Types ---
+
+typedef enum spectrum_buffer
+{
+    SPECTRUM_BUFFER_RAW = 0,    // Caller, DC block, decimator
+    SPECTRUM_BUFFER_DECIMATED,  // Decimator, window, FFT
+    SPECTRUM_BUFFER_SPECTRUM,   // FFT, magnitude
+    SPECTRUM_BUFFER_MAGNITUDE,  // Magnitude, caller
+    SPECTRUM_BUFFER_MAX,
+} spectrum_buffer_t;
+
+// --- Global Variables ---
+
+static float32_t gafSpectrumRaw[2 * SPECTRUM_BLOCK];
+static float32_t gafSpectrumDecimated[SPECTRUM_FFT_SIZE];
+static float32_t gafSpectrumSpectrum[SPECTRUM_FFT_SIZE];
+static float32_t gafSpectrumMagnitude[SPECTRUM_BINS];
+
+// y[n] = x[n] - x[n-1] + p y[n-1], CMSIS adds the feedback terms
+static const float32_t gafSpectrumDcBlock[5] = {1.0f, -1.0f, 0.0f, SPECTRUM_DC_POLE, 0.0f};
+static float32_t gafSpectrumDcState[2];
+static float32_t gafSpectrumTaps[SPECTRUM_FIR_TAPS];
+static float32_t gafSpectrumFirState[SPECTRUM_FIR_TAPS + SPECTRUM_FIR_BLOCK - 1];
+static float32_t gafSpectrumWindow[SPECTRUM_FFT_SIZE];
+static bool gfSpectrumDesigned = false;
+
+static dspgraph_buffer_t gasSpectrumBuffers[SPECTRUM_BUFFER_MAX] = {
+    [SPECTRUM_BUFFER_RAW]       = {gafSpectrumRaw,       2 * SPECTRUM_BLOCK, SPECTRUM_BLOCK,    3},
+    [SPECTRUM_BUFFER_DECIMATED] = {gafSpectrumDecimated, SPECTRUM_FFT_SIZE,  SPECTRUM_FFT_SIZE, 3},
+    [SPECTRUM_BUFFER_SPECTRUM]  = {gafSpectrumSpectrum,  SPECTRUM_FFT_SIZE,  SPECTRUM_FFT_SIZE, 2},
+    [SPECTRUM_BUFFER_MAGNITUDE] = {gafSpectrumMagnitude, SPECTRUM_BINS,      SPECTRUM_BINS,     2},
+};
+
+static dspgraph_node_t gasSpectrumNodes[] = {
+    {.szName   = "dc_block",
+     .nKind    = DSPGRAPH_KIND_BIQUAD,
+     .bInput   = SPECTRUM_BUFFER_RAW,
+     .bStage   = 1,
+     .bOutput  = DSPGRAPH_IN_PLACE,
+     .wConsume = SPECTRUM_BLOCK,
+     .wProduce = SPECTRUM_BLOCK,
+     .wRepeat  = 1,
+     .wCount   = 1,
+     .pfCoeffs = gafSpectrumDcBlock,
+     .pfState  = gafSpectrumDcState},
+    {.szName   = "decimate",
+     .nKind    = DSPGRAPH_KIND_FIR_DECIMATE,
+     .bInput   = SPECTRUM_BUFFER_RAW,
+     .bStage   = 2,
+     .bOutput  = SPECTRUM_BUFFER_DECIMATED,
+     .bFactor  = SPECTRUM_DECIMATION,
+     .wConsume = SPECTRUM_FIR_BLOCK,
+     .wProduce = SPECTRUM_FIR_BLOCK / SPECTRUM_DECIMATION,
+     .wRepeat  = SPECTRUM_BLOCK / SPECTRUM_FIR_BLOCK,
+     .wCount   = SPECTRUM_FIR_TAPS,
+     .pfCoeffs = gafSpectrumTaps,
+     .pfState  = gafSpectrumFirState},
+    {.szName   = "window",
+     .nKind    = DSPGRAPH_KIND_WINDOW,
+     .bInput   = SPECTRUM_BUFFER_DECIMATED,
+     .bStage   = 1,
+     .bOutput  = DSPGRAPH_IN_PLACE,
+     .wConsume = SPECTRUM_FFT_SIZE,
+     .wProduce = SPECTRUM_FFT_SIZE,
+     .wRepeat  = 1,
+     .pfCoeffs = gafSpectrumWindow},
+    {.szName   = "rfft",
+     .nKind    = DSPGRAPH_KIND_RFFT,
+     .bInput   = SPECTRUM_BUFFER_DECIMATED,
+     .bStage   = 2,
+     .bOutput  = SPECTRUM_BUFFER_SPECTRUM,
+     .wConsume = SPECTRUM_FFT_SIZE,
+     .wProduce = SPECTRUM_FFT_SIZE,
+     .wRepeat  = 1},
+    {.szName   = "magnitude",
+     .nKind    = DSPGRAPH_KIND_MAGNITUDE,
+     .bInput   = SPECTRUM_BUFFER_SPECTRUM,
+     .bStage   = 1,
+     .bOutput  = SPECTRUM_BUFFER_MAGNITUDE,
+     .wConsume = SPECTRUM_FFT_SIZE,
+     .wProduce = SPECTRUM_BINS,
+     .wRepeat  = 1},
+};
+
+static dspgraph_t gsSpectrum = {
+    .szName    = "spectrum",
+    .psNodes   = gasSpectrumNodes,
+    .dwNodes   = sizeof(gasSpectrumNodes) / sizeof(gasSpectrumNodes[0]),
+    .psBuffers = gasSpectrumBuffers,
+    .dwBuffers = SPECTRUM_BUFFER_MAX,
+    .bInput    = SPECTRUM_BUFFER_RAW,
+    .bOutput   = SPECTRUM_BUFFER_MAGNITUDE,
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Free room for the writer of a buffer
+ * @param psBuffer - Buffer
+ * @retval Samples the writer may add
+ */
+static uint32_t DSPGRAPH_Room(const dspgraph_buffer_t *psBuffer)
+{
+    uint32_t dwUsed = 0;
+
+    for (uint32_t dwStage = 1; dwStage < psBuffer->dwStages; dwStage++)
+    {
+        dwUsed += psBuffer->adwPending[dwStage];
+    }
+
+    return psBuffer->dwSize - dwUsed;
+}
+
+/**
+ * @brief Move a stage past a block, handing it to the next stage
+ * @param psBuffer - Buffer
+ * @param dwStage - Stage that is done with the block
+ * @param dwCount - Samples in the block
+ */
+static void DSPGRAPH_Advance(dspgraph_buffer_t *psBuffer, uint32_t dwStage, uint32_t dwCount)
+{
+    psBuffer->adwPosition[dwStage] += dwCount;
+    if (psBuffer->adwPosition[dwStage] == psBuffer->dwSize)
+    {
+        psBuffer->adwPosition[dwStage] = 0;
+    }
+    if (dwStage != 0)
+    {
+        psBuffer->adwPending[dwStage] -= dwCount;
+    }
+    if (dwStage + 1 < psBuffer->dwStages)
+    {
+        psBuffer->adwPending[dwStage + 1] += dwCount;
+    }
+}
+
+/**
+ * @brief Find who owns a stage of a buffer
+ * @param psGraph - Graph
+ * @param dwBuffer - Buffer
+ * @param dwStage - Stage
+ * @param pdwOwners - Returns how many claim it, exactly one in a valid graph
+ * @retval Schedule position of the first owner, DSPGRAPH_CALLER_WRITES for the caller's input,
+ *         dwNodes for the caller's output
+ */
+static int32_t DSPGRAPH_Owner(const dspgraph_t *psGraph, uint32_t dwBuffer, uint32_t dwStage, uint32_t *pdwOwners)
+{
+    int32_t nOwner = -2;
+
+    *pdwOwners = 0;
+    if (dwBuffer == psGraph->bInput && dwStage == 0)
+    {
+        nOwner = DSPGRAPH_CALLER_WRITES;
+        (*pdwOwners)++;
+    }
+    if (dwBuffer == psGraph->bOutput && dwStage + 1 == psGraph->psBuffers[dwBuffer].dwStages)
+    {
+        nOwner = (int32_t)psGraph->dwNodes;
+        (*pdwOwners)++;
+    }
+    for (uint32_t dwNode = psGraph->dwNodes; dwNode-- > 0;)
+    {
+        const dspgraph_node_t *psNode = &psGraph->psNodes[dwNode];
+
+        if ((psNode->bInput == dwBuffer && psNode->bStage == dwStage) || (psNode->bOutput == dwBuffer && dwStage == 0))
+        {
+            nOwner = (int32_t)dwNode;
+            (*pdwOwners)++;
+        }
+    }
+
+    return nOwner;
+}
+
+/**
+ * @brief Check the rates, sizes and kernel parameters of a node
+ * @param psGraph - Graph
+ * @param psNode - Node
+ * @retval True if the node fits its buffers
+ */
+static bool DSPGRAPH_CheckNode(const dspgraph_t *psGraph, const dspgraph_node_t *psNode)
+{
+    const dspgraph_buffer_t *psIn  = &psGraph->psBuffers[psNode->bInput];
+    const dspgraph_buffer_t *psOut = NULL;
+    bool fInPlace                  = (psNode->bOutput == DSPGRAPH_IN_PLACE);
+
+    // 1) Its firings take exactly what one iteration brings, in blocks that never wrap
+    if (psNode->nKind >= DSPGRAPH_KIND_MAX || psNode->bInput >= psGraph->dwBuffers || psNode->bStage == 0 ||
+        psNode->bStage >= psIn->dwStages || psNode->wConsume == 0 || psNode->wProduce == 0 ||
+        (uint32_t)psNode->wConsume * psNode->wRepeat != psIn->dwTokens || psIn->dwSize % psNode->wConsume != 0)
+    {
+        return false;
+    }
+
+    // 2) In place, a later stage takes the block; otherwise the node is the last reader and the only writer of its output
+    if (fInPlace)
+    {
+        if (psNode->wProduce != psNode->wConsume || psNode->bStage + 1U >= psIn->dwStages)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (psNode->bOutput >= psGraph->dwBuffers || psNode->bOutput == psNode->bInput ||
+            psNode->bStage + 1U != psIn->dwStages)
+        {
+            return false;
+        }
+        psOut = &psGraph->psBuffers[psNode->bOutput];
+        if ((uint32_t)psNode->wProduce * psNode->wRepeat != psOut->dwTokens || psOut->dwSize % psNode->wProduce != 0)
+        {
+            return false;
+        }
+    }
+
+    // 3) What each kernel can do
+    switch (psNode->nKind)
+    {
+        case DSPGRAPH_KIND_BIQUAD:
+            return fInPlace && psNode->wCount != 0 && psNode->pfCoeffs != NULL && psNode->pfState != NULL;
+        case DSPGRAPH_KIND_FIR_DECIMATE:
+            return !fInPlace && psNode->bFactor != 0 && psNode->wConsume == psNode->wProduce * psNode->bFactor &&
+                   psNode->wCount != 0 && psNode->pfCoeffs != NULL && psNode->pfState != NULL;
+        case DSPGRAPH_KIND_WINDOW:
+            return fInPlace && psNode->pfCoeffs != NULL;
+        case DSPGRAPH_KIND_RFFT:
+            return !fInPlace && psNode->wProduce == psNode->wConsume;
+        case DSPGRAPH_KIND_MAGNITUDE:
+            return !fInPlace && psNode->wProduce * 2U == psNode->wConsume;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Check that the graph is a valid static schedule
+ * @param psGraph - Graph
+ * @retval True if every stage has one owner, every node fits and the order follows the data
+ */
+static bool DSPGRAPH_Check(const dspgraph_t *psGraph)
+{
+    uint32_t dwOwners = 0;
+
+    // 1) Buffers that can hold an iteration, the caller's ends included
+    if (psGraph->psNodes == NULL || psGraph->dwNodes == 0 || psGraph->psBuffers == NULL ||
+        psGraph->bInput >= psGraph->dwBuffers || psGraph->bOutput >= psGraph->dwBuffers)
+    {
+        return false;
+    }
+    for (uint32_t dwBuffer = 0; dwBuffer < psGraph->dwBuffers; dwBuffer++)
+    {
+        const dspgraph_buffer_t *psBuffer = &psGraph->psBuffers[dwBuffer];
+
+        if (psBuffer->pfStorage == NULL || psBuffer->dwTokens == 0 || psBuffer->dwSize < psBuffer->dwTokens ||
+            psBuffer->dwStages < 2 || psBuffer->dwStages > DSPGRAPH_MAX_STAGES)
+        {
+            return false;
+        }
+
+        // 2) One writer and one reader per stage
+        for (uint32_t dwStage = 0; dwStage < psBuffer->dwStages; dwStage++)
+        {
+            DSPGRAPH_Owner(psGraph, dwBuffer, dwStage, &dwOwners);
+            if (dwOwners != 1)
+            {
+                return false;
+            }
+        }
+    }
+
+    // 3) Each node fits its buffers and fires after the stage before it
+    for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes; dwNode++)
+    {
+        const dspgraph_node_t *psNode = &psGraph->psNodes[dwNode];
+
+        if (!DSPGRAPH_CheckNode(psGraph, psNode) ||
+            DSPGRAPH_Owner(psGraph, psNode->bInput, psNode->bStage - 1U, &dwOwners) >= (int32_t)dwNode)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set up the CMSIS-DSP instance of a node
+ * @param psNode - Node
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t DSPGRAPH_InitKernel(dspgraph_node_t *psNode)
+{
+    arm_status nStatus = ARM_MATH_SUCCESS;
+
+    switch (psNode->nKind)
+    {
+        case DSPGRAPH_KIND_BIQUAD:
+            arm_biquad_cascade_df2T_init_f32(&psNode->uKernel.sBiquad, (uint8_t)psNode->wCount, psNode->pfCoeffs,
+                                             psNode->pfState);
+            memset(psNode->pfState, 0, 2 * psNode->wCount * sizeof(float32_t));
+            break;
+        case DSPGRAPH_KIND_FIR_DECIMATE:
+            nStatus = arm_fir_decimate_init_f32(&psNode->uKernel.sDecimate, psNode->wCount, psNode->bFactor,
+                                                psNode->pfCoeffs, psNode->pfState, psNode->wConsume);
+            break;
+        case DSPGRAPH_KIND_RFFT:
+            nStatus = arm_rfft_fast_init_f32(&psNode->uKernel.sRfft, psNode->wConsume);
+            break;
+        default:
+            break;
+    }
+
+    return (nStatus == ARM_MATH_SUCCESS) ? NHNS_STATUS_OK : NHNS_STATUS_INVALID_CONFIGURATION;
+}
+
+/**
+ * @brief Fire a node once and charge it the cycles
+ * @param psGraph - Graph
+ * @param psNode - Node, its input holds a block
+ */
+static void DSPGRAPH_Fire(dspgraph_t *psGraph, dspgraph_node_t *psNode)
+{
+    dspgraph_buffer_t *psIn  = &psGraph->psBuffers[psNode->bInput];
+    dspgraph_buffer_t *psOut = NULL;
+    float32_t *pfIn          = &psIn->pfStorage[psIn->adwPosition[psNode->bStage]];
+    float32_t *pfOut         = pfIn;
+    uint32_t dwStart         = 0;
+    uint32_t dwCycles        = 0;
+
+    if (psNode->bOutput != DSPGRAPH_IN_PLACE)
+    {
+        psOut = &psGraph->psBuffers[psNode->bOutput];
+        pfOut = &psOut->pfStorage[psOut->adwPosition[0]];
+    }
+
+    dwStart = PROFILER_GetCycles();
+    switch (psNode->nKind)
+    {
+        case DSPGRAPH_KIND_BIQUAD:
+            arm_biquad_cascade_df2T_f32(&psNode->uKernel.sBiquad, pfIn, pfOut, psNode->wConsume);
+            break;
+        case DSPGRAPH_KIND_FIR_DECIMATE:
+            arm_fir_decimate_f32(&psNode->uKernel.sDecimate, pfIn, pfOut, psNode->wConsume);
+            break;
+        case DSPGRAPH_KIND_WINDOW:
+            arm_mult_f32(pfIn, psNode->pfCoeffs, pfOut, psNode->wConsume);
+            break;
+        case DSPGRAPH_KIND_RFFT:
+            arm_rfft_fast_f32(&psNode->uKernel.sRfft, pfIn, pfOut, 0);
+            break;
+        case DSPGRAPH_KIND_MAGNITUDE:
+            arm_cmplx_mag_f32(pfIn, pfOut, psNode->wProduce);
+            break;
+        default:
+            break;
+    }
+    dwCycles = PROFILER_GetCycles() - dwStart;
+
+    psNode->dwFirings++;
+    psNode->qwCycles += dwCycles;
+    if (dwCycles > psNode->dwMaxCycles)
+    {
+        psNode->dwMaxCycles = dwCycles;
+    }
+
+    DSPGRAPH_Advance(psIn, psNode->bStage, psNode->wConsume);
+    if (psOut != NULL)
+    {
+        DSPGRAPH_Advance(psOut, 0, psNode->wProduce);
+    }
+}
+
+/**
+ * @brief Design the benchmark graph's decimation filter and window
+ */
+static void DSPGRAPH_DesignSpectrum(void)
+{
+    float32_t fSum = 0.0f;
+
+    // 1) Hamming-windowed sinc cutting at the new Nyquist frequency, unity gain at DC
+    for (uint32_t dwTap = 0; dwTap < SPECTRUM_FIR_TAPS; dwTap++)
+    {
+        float32_t fT = (float32_t)dwTap - (SPECTRUM_FIR_TAPS - 1) / 2.0f;
+        float32_t fX = PI * fT / SPECTRUM_DECIMATION;
+
+        gafSpectrumTaps[dwTap] = ((fT == 0.0f) ? 1.0f : sinf(fX) / fX) *
+                                 (0.54f - 0.46f * cosf(2.0f * PI * dwTap / (SPECTRUM_FIR_TAPS - 1)));
+        fSum += gafSpectrumTaps[dwTap];
+    }
+    for (uint32_t dwTap = 0; dwTap < SPECTRUM_FIR_TAPS; dwTap++)
+    {
+        gafSpectrumTaps[dwTap] /= fSum;
+    }
+
+    // 2) Hann window over the FFT frame
+    for (uint32_t dwIndex = 0; dwIndex < SPECTRUM_FFT_SIZE; dwIndex++)
+    {
+        gafSpectrumWindow[dwIndex] = 0.5f - 0.5f * cosf(2.0f * PI * dwIndex / SPECTRUM_FFT_SIZE);
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t DSPGRAPH_Init(dspgraph_t *psGraph)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (psGraph == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    psGraph->fInitDone = false;
+    if (!DSPGRAPH_Check(psGraph))
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    // 2) Empty buffers
+    for (uint32_t dwBuffer = 0; dwBuffer < psGraph->dwBuffers; dwBuffer++)
+    {
+        memset(psGraph->psBuffers[dwBuffer].adwPosition, 0, sizeof(psGraph->psBuffers[dwBuffer].adwPosition));
+        memset(psGraph->psBuffers[dwBuffer].adwPending, 0, sizeof(psGraph->psBuffers[dwBuffer].adwPending));
+    }
+
+    // 3) Kernels from a clean state
+    for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes && nRet == NHNS_STATUS_OK; dwNode++)
+    {
+        nRet = DSPGRAPH_InitKernel(&psGraph->psNodes[dwNode]);
+    }
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    DSPGRAPH_ResetStats(psGraph);
+    psGraph->fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPGRAPH_GetInput(dspgraph_t *psGraph, uint32_t dwCount, float32_t **ppfSamples)
+{
+    dspgraph_buffer_t *psBuffer = NULL;
+
+    // 1) Verify arguments
+    if (psGraph == NULL || ppfSamples == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if graph is initialized
+    if (!psGraph->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) A block that does not wrap, once the graph has taken enough of the previous ones
+    psBuffer = &psGraph->psBuffers[psGraph->bInput];
+    if (dwCount == 0 || psBuffer->adwPosition[0] + dwCount > psBuffer->dwSize)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (DSPGRAPH_Room(psBuffer) < dwCount)
+    {
+        return NHNS_STATUS_NO_MEMORY;
+    }
+    *ppfSamples = &psBuffer->pfStorage[psBuffer->adwPosition[0]];
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPGRAPH_CommitInput(dspgraph_t *psGraph, uint32_t dwCount)
+{
+    float32_t *pfSamples = NULL;
+    nhns_status_t nRet   = DSPGRAPH_GetInput(psGraph, dwCount, &pfSamples);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        DSPGRAPH_Advance(&psGraph->psBuffers[psGraph->bInput], 0, dwCount);
+    }
+
+    return nRet;
+}
+
+nhns_status_t DSPGRAPH_Run(dspgraph_t *psGraph, uint32_t *pdwIterations)
+{
+    dspgraph_buffer_t *psIn  = NULL;
+    dspgraph_buffer_t *psOut = NULL;
+    uint32_t dwIterations    = 0;
+
+    // 1) Verify arguments
+    if (psGraph == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if graph is initialized
+    if (!psGraph->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Whole iterations only, every buffer in between is empty again after each
+    psIn  = &psGraph->psBuffers[psGraph->bInput];
+    psOut = &psGraph->psBuffers[psGraph->bOutput];
+    while (psIn->adwPending[1] >= psIn->dwTokens && DSPGRAPH_Room(psOut) >= psOut->dwTokens)
+    {
+        for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes; dwNode++)
+        {
+            for (uint32_t dwFiring = 0; dwFiring < psGraph->psNodes[dwNode].wRepeat; dwFiring++)
+            {
+                DSPGRAPH_Fire(psGraph, &psGraph->psNodes[dwNode]);
+            }
+        }
+        psGraph->dwIterations++;
+        dwIterations++;
+    }
+
+    if (pdwIterations != NULL)
+    {
+        *pdwIterations = dwIterations;
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPGRAPH_GetOutput(dspgraph_t *psGraph, uint32_t dwCount, const float32_t **ppfSamples)
+{
+    dspgraph_buffer_t *psBuffer = NULL;
+    uint32_t dwStage            = 0;
+
+    // 1) Verify arguments
+    if (psGraph == NULL || ppfSamples == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if graph is initialized
+    if (!psGraph->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) The caller is the last stage of the output buffer
+    psBuffer = &psGraph->psBuffers[psGraph->bOutput];
+    dwStage  = psBuffer->dwStages - 1;
+    if (dwCount == 0 || psBuffer->adwPosition[dwStage] + dwCount > psBuffer->dwSize)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (psBuffer->adwPending[dwStage] < dwCount)
+    {
+        return NHNS_STATUS_NOT_FOUND;
+    }
+    *ppfSamples = &psBuffer->pfStorage[psBuffer->adwPosition[dwStage]];
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t DSPGRAPH_ReleaseOutput(dspgraph_t *psGraph, uint32_t dwCount)
+{
+    const float32_t *pfSamples = NULL;
+    nhns_status_t nRet         = DSPGRAPH_GetOutput(psGraph, dwCount, &pfSamples);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        DSPGRAPH_Advance(&psGraph->psBuffers[psGraph->bOutput], psGraph->psBuffers[psGraph->bOutput].dwStages - 1,
+                         dwCount);
+    }
+
+    return nRet;
+}
+
+void DSPGRAPH_ResetStats(dspgraph_t *psGraph)
+{
+    if (psGraph == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes; dwNode++)
+    {
+        psGraph->psNodes[dwNode].dwFirings   = 0;
+        psGraph->psNodes[dwNode].dwMaxCycles = 0;
+        psGraph->psNodes[dwNode].qwCycles    = 0;
+    }
+    psGraph->dwIterations = 0;
+}
+
+nhns_status_t DSPGRAPH_Dump(const dspgraph_t *psGraph, uart_instance_t nID)
+{
+    uint64_t qwTotal   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    char szLine[DSPGRAPH_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Verify arguments
+    if (psGraph == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if graph is initialized
+    if (!psGraph->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes; dwNode++)
+    {
+        qwTotal += psGraph->psNodes[dwNode].qwCycles;
+    }
+
+    // 3) One line per node, in schedule order, then the iteration
+    nLength = snprintf(szLine, sizeof(szLine), "dspgraph %s: %lu iterations, %lu nodes\r\n", psGraph->szName,
+                       (unsigned long)psGraph->dwIterations, (unsigned long)psGraph->dwNodes);
+    nRet    = UART_PrintLine(nID, szLine, nLength, DSPGRAPH_LINE_SIZE);
+    for (uint32_t dwNode = 0; dwNode < psGraph->dwNodes && nRet == NHNS_STATUS_OK; dwNode++)
+    {
+        const dspgraph_node_t *psNode = &psGraph->psNodes[dwNode];
+        uint32_t dwPermille           = (qwTotal != 0) ? (uint32_t)(psNode->qwCycles * 1000 / qwTotal) : 0;
+
+        nLength = snprintf(szLine, sizeof(szLine), "  %-10s x%-3u %5u -> %-5u %8lu avg %8lu max %3lu.%lu%%\r\n",
+                           psNode->szName, (unsigned)psNode->wRepeat, (unsigned)psNode->wConsume,
+                           (unsigned)psNode->wProduce,
+                           (unsigned long)((psNode->dwFirings != 0) ? psNode->qwCycles / psNode->dwFirings : 0),
+                           (unsigned long)psNode->dwMaxCycles, (unsigned long)(dwPermille / 10),
+                           (unsigned long)(dwPermille % 10));
+        nRet    = UART_PrintLine(nID, szLine, nLength, DSPGRAPH_LINE_SIZE);
+    }
+    if (nRet == NHNS_STATUS_OK && psGraph->dwIterations != 0)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "  %lu cycles per iteration, %lu per input sample\r\n",
+                           (unsigned long)(qwTotal / psGraph->dwIterations),
+                           (unsigned long)(qwTotal / psGraph->dwIterations / psGraph->psBuffers[psGraph->bInput].dwTokens));
+        nRet    = UART_PrintLine(nID, szLine, nLength, DSPGRAPH_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t DSPGRAPH_Benchmark(uart_instance_t nID)
+{
+    const float32_t *pfBins = NULL;
+    float32_t *pfSamples    = NULL;
+    float32_t fStep         = 2.0f * PI * SPECTRUM_TONE_BIN / SPECTRUM_BLOCK;
+    float32_t fCoeff        = 2.0f * cosf(fStep);
+    float32_t fPrev1        = 0.0f;
+    float32_t fPrev2        = 0.0f;
+    uint32_t dwPeak         = 0;
+    uint64_t qwCycles       = 0;
+    nhns_status_t nRet      = NHNS_STATUS_OK;
+    char szLine[DSPGRAPH_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Fresh graph, the filter and window designed once
+    if (!gfSpectrumDesigned)
+    {
+        DSPGRAPH_DesignSpectrum();
+        gfSpectrumDesigned = true;
+    }
+    nRet = DSPGRAPH_Init(&gsSpectrum);
+
+    // 2) A tone of whole periods per block on a DC offset, through the graph one block at a time
+    for (uint32_t dwIteration = 0; dwIteration < SPECTRUM_ITERATIONS && nRet == NHNS_STATUS_OK; dwIteration++)
+    {
+        nRet = DSPGRAPH_GetInput(&gsSpectrum, SPECTRUM_BLOCK, &pfSamples);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            break;
+        }
+
+        // Sine by recurrence from its two previous values, restarted each block
+        fPrev2 = -sinf(2.0f * fStep);
+        fPrev1 = -sinf(fStep);
+        for (uint32_t dwIndex = 0; dwIndex < SPECTRUM_BLOCK; dwIndex++)
+        {
+            float32_t fSine = fCoeff * fPrev1 - fPrev2;
+
+            pfSamples[dwIndex] = 2048.0f + 1000.0f * fSine;
+            fPrev2             = fPrev1;
+            fPrev1             = fSine;
+        }
+
+        DSPGRAPH_CommitInput(&gsSpectrum, SPECTRUM_BLOCK);
+        nRet = DSPGRAPH_Run(&gsSpectrum, NULL);
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = DSPGRAPH_GetOutput(&gsSpectrum, SPECTRUM_BINS, &pfBins);
+        }
+        if (nRet != NHNS_STATUS_OK)
+        {
+            break;
+        }
+
+        // 3) Strongest bin past DC, which also carries the Nyquist term in the packed RFFT output.
+        //    The first frame still holds the step into the DC offset
+        dwPeak = 1;
+        for (uint32_t dwBin = 2; dwBin < SPECTRUM_BINS; dwBin++)
+        {
+            dwPeak = (pfBins[dwBin] > pfBins[dwPeak]) ? dwBin : dwPeak;
+        }
+        DSPGRAPH_ReleaseOutput(&gsSpectrum, SPECTRUM_BINS);
+        if (dwIteration != 0 && dwPeak != SPECTRUM_TONE_BIN)
+        {
+            nRet = NHNS_STATUS_DATA_MISMATCH;
+        }
+    }
+
+    // 4) Where the cycles go, and the input rate they allow
+    if (gsSpectrum.fInitDone)
+    {
+        nhns_status_t nPrint = DSPGRAPH_Dump(&gsSpectrum, nID);
+
+        for (uint32_t dwNode = 0; dwNode < gsSpectrum.dwNodes; dwNode++)
+        {
+            qwCycles += gsSpectrum.psNodes[dwNode].qwCycles;
+        }
+        if (nPrint == NHNS_STATUS_OK)
+        {
+            nLength = snprintf(szLine, sizeof(szLine), "dspgraph: tone in bin %lu of %u, up to %lu samples/s on this core\r\n",
+                               (unsigned long)dwPeak, SPECTRUM_TONE_BIN,
+                               (unsigned long)((qwCycles != 0) ? (uint64_t)PROFILER_GetCyclesPerSecond() *
+                                                                     gsSpectrum.dwIterations * SPECTRUM_BLOCK / qwCycles
+                                                               : 0));
+            nPrint  = UART_PrintLine(nID, szLine, nLength, DSPGRAPH_LINE_SIZE);
+        }
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = nPrint;
+        }
+    }
+
+    return nRet;
+}
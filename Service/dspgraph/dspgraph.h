@@ -0,0 +1,176 @@
+#ifndef __DSPGRAPH_H__
+#define __DSPGRAPH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "arm_math.h"
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Static dataflow graphs of CMSIS-DSP kernels. Everything a graph uses is
+ * declared by its owner: the buffers, the nodes with their coefficients and
+ * state, and the order the nodes fire in, so nothing is allocated.
+ *
+ * Each buffer is a ring of samples with one writer at stage 0 and a chain of
+ * readers behind it, stage 1 to the last. A node that writes its result over
+ * its input (biquad, window) is a reader at a middle stage, and the block it
+ * has processed becomes readable by the next stage without moving. Any other
+ * node reads at the last stage of its input and writes at stage 0 of its
+ * output. Buffer sizes are multiples of every block moved through them, so a
+ * block never wraps and kernels work straight on the ring.
+ *
+ * The schedule is fixed when the graph is written: the nodes, listed in data
+ * order, each fire wRepeat times per iteration, and an iteration takes
+ * dwTokens samples from the input buffer and puts dwTokens in the output one.
+ * DSPGRAPH_Init checks that every buffer gets as many samples per iteration
+ * as its readers take, so a graph that passes runs forever without any buffer
+ * growing. Graphs defined with constants should check the same rates with
+ * _Static_assert.
+ */
+
+#define DSPGRAPH_MAX_STAGES 4       // Writer, in-place nodes and reader of one buffer
+#define DSPGRAPH_IN_PLACE   0xFF    // Node output: the block it read
+
+// --- Types ---
+
+typedef enum dspgraph_kind
+{
+    DSPGRAPH_KIND_BIQUAD = 0,       // arm_biquad_cascade_df2T_f32, in place, wCount stages of 5 coefficients
+    DSPGRAPH_KIND_FIR_DECIMATE,     // arm_fir_decimate_f32, wCount taps, bFactor = wConsume / wProduce
+    DSPGRAPH_KIND_WINDOW,           // arm_mult_f32 by pfCoeffs, in place
+    DSPGRAPH_KIND_RFFT,             // arm_rfft_fast_f32 of wConsume samples, packed spectrum out, input trashed
+    DSPGRAPH_KIND_MAGNITUDE,        // arm_cmplx_mag_f32, wConsume / 2 bins out
+    DSPGRAPH_KIND_MAX,
+} dspgraph_kind_t;
+
+typedef struct dspgraph_buffer
+{
+    float32_t *pfStorage;
+    uint32_t dwSize;                              // Samples
+    uint32_t dwTokens;                            // Samples written and read per iteration
+    uint32_t dwStages;                            // Writer and readers
+    uint32_t adwPosition[DSPGRAPH_MAX_STAGES];    // Where each stage reads or writes next
+    uint32_t adwPending[DSPGRAPH_MAX_STAGES];     // Samples each reader has yet to take, none for the writer
+} dspgraph_buffer_t;
+
+typedef struct dspgraph_node
+{
+    const char *szName;
+    dspgraph_kind_t nKind;
+    uint8_t bInput;                 // Buffer read
+    uint8_t bStage;                 // Stage the node reads at
+    uint8_t bOutput;                // Buffer written at stage 0, DSPGRAPH_IN_PLACE
+    uint8_t bFactor;                // Decimation factor
+    uint16_t wConsume;              // Samples read per firing
+    uint16_t wProduce;              // Samples written per firing
+    uint16_t wRepeat;               // Firings per iteration
+    uint16_t wCount;                // Taps or stages
+    const float32_t *pfCoeffs;      // Taps, biquad coefficients or window
+    float32_t *pfState;             // FIR: wCount + wConsume - 1, biquad: 2 per stage
+
+    union
+    {
+        arm_biquad_cascade_df2T_instance_f32 sBiquad;
+        arm_fir_decimate_instance_f32 sDecimate;
+        arm_rfft_fast_instance_f32 sRfft;
+    } uKernel;
+
+    // Cost, in PROFILER_GetCycles ticks
+    uint32_t dwFirings;
+    uint32_t dwMaxCycles;
+    uint64_t qwCycles;
+} dspgraph_node_t;
+
+typedef struct dspgraph
+{
+    const char *szName;
+    dspgraph_node_t *psNodes;       // In schedule order
+    uint32_t dwNodes;
+    dspgraph_buffer_t *psBuffers;
+    uint32_t dwBuffers;
+    uint8_t bInput;                 // Buffer the caller writes
+    uint8_t bOutput;                // Buffer the caller reads at its last stage
+    bool fInitDone;
+    uint32_t dwIterations;
+} dspgraph_t;
+
+// --- Functions ---
+
+/**
+ * @brief Check the schedule and the buffers, empty them and initialize the kernels
+ * @param psGraph - Graph to set up
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_INVALID_CONFIGURATION when the rates, stages or sizes do not add up
+ */
+nhns_status_t DSPGRAPH_Init(dspgraph_t *psGraph);
+
+/**
+ * @brief Get room for the next input samples, to be filled in place
+ * @param psGraph - Graph to feed
+ * @param dwCount - Samples wanted, a divisor of the input buffer size
+ * @param ppfSamples - Returns where to write them
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_NO_MEMORY until DSPGRAPH_Run makes room
+ */
+nhns_status_t DSPGRAPH_GetInput(dspgraph_t *psGraph, uint32_t dwCount, float32_t **ppfSamples);
+
+/**
+ * @brief Hand the samples written after DSPGRAPH_GetInput to the graph
+ * @param psGraph - Graph to feed
+ * @param dwCount - Samples written, as passed to DSPGRAPH_GetInput
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPGRAPH_CommitInput(dspgraph_t *psGraph, uint32_t dwCount);
+
+/**
+ * @brief Run the schedule for as many iterations as the input and the room in the output allow
+ * @param psGraph - Graph to run
+ * @param pdwIterations - Returns the iterations run, may be NULL
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPGRAPH_Run(dspgraph_t *psGraph, uint32_t *pdwIterations);
+
+/**
+ * @brief Get the oldest output samples without copying them
+ * @param psGraph - Graph to drain
+ * @param dwCount - Samples wanted, a divisor of the output buffer size
+ * @param ppfSamples - Returns where they are
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_NOT_FOUND until the graph has produced them
+ */
+nhns_status_t DSPGRAPH_GetOutput(dspgraph_t *psGraph, uint32_t dwCount, const float32_t **ppfSamples);
+
+/**
+ * @brief Give back output samples from DSPGRAPH_GetOutput
+ * @param psGraph - Graph to drain
+ * @param dwCount - Samples done with, as passed to DSPGRAPH_GetOutput
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPGRAPH_ReleaseOutput(dspgraph_t *psGraph, uint32_t dwCount);
+
+/**
+ * @brief Clear the cost counters of every node
+ * @param psGraph - Graph to clear
+ */
+void DSPGRAPH_ResetStats(dspgraph_t *psGraph);
+
+/**
+ * @brief Print the cycles per firing of each node and its share of the iteration
+ * @param psGraph - Graph to print
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t DSPGRAPH_Dump(const dspgraph_t *psGraph, uart_instance_t nID);
+
+/**
+ * @brief Run a DC block, decimation by 4 and a 256-point magnitude spectrum on a test tone and print where the cycles go
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when the tone does not come out in its bin
+ */
+nhns_status_t DSPGRAPH_Benchmark(uart_instance_t nID);
+
+#endif    // __DSPGRAPH_H__
@@ -0,0 +1,68 @@
+#include <string.h>
+#include "frame.h"
+
+// --- Functions ---
+
+uint8_t *FRAME_Begin(uint8_t *pFrame, uint8_t bType, uint8_t bSequence)
+{
+    pFrame = FRAME_Put8(pFrame, FRAME_SYNC0);
+    pFrame = FRAME_Put8(pFrame, FRAME_SYNC1);
+    pFrame = FRAME_Put8(pFrame, bType);
+    pFrame = FRAME_Put8(pFrame, bSequence);
+
+    // Length is patched in by FRAME_End
+    return FRAME_Put16(pFrame, 0);
+}
+
+uint16_t FRAME_End(uint8_t *pFrame, uint8_t *pEnd)
+{
+    FRAME_Put16(&pFrame[4], (uint16_t)(pEnd - pFrame - FRAME_HEADER_SIZE));
+    pEnd = FRAME_Put16(pEnd, FRAME_Crc16(&pFrame[2], (uint32_t)(pEnd - &pFrame[2])));
+
+    return (uint16_t)(pEnd - pFrame);
+}
+
+uint8_t *FRAME_Put8(uint8_t *pOut, uint8_t bValue)
+{
+    *pOut++ = bValue;
+    return pOut;
+}
+
+uint8_t *FRAME_Put16(uint8_t *pOut, uint16_t bValue)
+{
+    *pOut++ = (uint8_t)bValue;
+    *pOut++ = (uint8_t)(bValue >> 8);
+    return pOut;
+}
+
+uint8_t *FRAME_Put32(uint8_t *pOut, uint32_t dwValue)
+{
+    pOut = FRAME_Put16(pOut, (uint16_t)dwValue);
+    return FRAME_Put16(pOut, (uint16_t)(dwValue >> 16));
+}
+
+uint8_t *FRAME_PutString(uint8_t *pOut, const char *szString, uint8_t bMaxLength)
+{
+    size_t nLength = strnlen(szString, bMaxLength);
+
+    pOut = FRAME_Put8(pOut, (uint8_t)nLength);
+    memcpy(pOut, szString, nLength);
+    return pOut + nLength;
+}
+
+uint16_t FRAME_Crc16(const uint8_t *pData, uint32_t dwLength)
+{
+    uint16_t bCrc = 0xFFFF;
+
+    // Bitwise, frames are small and rare enough not to need a table
+    while (dwLength--)
+    {
+        bCrc ^= (uint16_t)(*pData++) << 8;
+        for (int nBit = 0; nBit < 8; nBit++)
+        {
+            bCrc = (bCrc & 0x8000) ? (uint16_t)((bCrc << 1) ^ 0x1021) : (uint16_t)(bCrc << 1);
+        }
+    }
+
+    return bCrc;
+}
@@ -0,0 +1,70 @@
+#ifndef __FRAME_H__
+#define __FRAME_H__
+
+#include <stdint.h>
+
+// --- Definitions ---
+
+/*
+ * Binary frames share the debug console with plain text. Every frame is
+ *   u8 sync[2] = A5 5A, u8 type, u8 sequence, u16 payload length, payload, u16 CRC-16/CCITT-FALSE
+ * with all fields little-endian. The CRC covers everything from type to the end
+ * of the payload, so a decoder can resynchronize on any byte stream.
+ */
+#define FRAME_SYNC0        0xA5
+#define FRAME_SYNC1        0x5A
+#define FRAME_HEADER_SIZE  6
+#define FRAME_TRAILER_SIZE 2
+#define FRAME_OVERHEAD     (FRAME_HEADER_SIZE + FRAME_TRAILER_SIZE)
+
+// Payload types, decoders skip types they do not know
+#define FRAME_TYPE_RTSTATS 0x01
+#define FRAME_TYPE_DLOG    0x02
+
+// --- Functions ---
+
+/**
+ * @brief Write a frame header
+ * @param pFrame - Start of the frame buffer
+ * @param bType - Payload type
+ * @param bSequence - Sequence number, lets the decoder spot dropped frames
+ * @retval Where the payload starts
+ */
+uint8_t *FRAME_Begin(uint8_t *pFrame, uint8_t bType, uint8_t bSequence);
+
+/**
+ * @brief Patch the payload length into the header and append the CRC
+ * @param pFrame - Start of the frame buffer, as passed to FRAME_Begin
+ * @param pEnd - End of the payload
+ * @retval Total frame length
+ */
+uint16_t FRAME_End(uint8_t *pFrame, uint8_t *pEnd);
+
+/**
+ * @brief Append little-endian fields to a payload
+ * @param pOut - Write position
+ * @param Value - Value to append
+ * @retval Write position after the field
+ */
+uint8_t *FRAME_Put8(uint8_t *pOut, uint8_t bValue);
+uint8_t *FRAME_Put16(uint8_t *pOut, uint16_t bValue);
+uint8_t *FRAME_Put32(uint8_t *pOut, uint32_t dwValue);
+
+/**
+ * @brief Append a length-prefixed string
+ * @param pOut - Write position
+ * @param szString - String to append
+ * @param bMaxLength - Longest string to copy, the rest is cut off
+ * @retval Write position after the field
+ */
+uint8_t *FRAME_PutString(uint8_t *pOut, const char *szString, uint8_t bMaxLength);
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ * @param pData - Data to checksum
+ * @param dwLength - Length of pData
+ * @retval CRC of the data
+ */
+uint16_t FRAME_Crc16(const uint8_t *pData, uint32_t dwLength);
+
+#endif    // __FRAME_H__
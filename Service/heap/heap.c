@@ -0,0 +1,183 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "heap.h"
+#include "FreeRTOS.h"
+
+// --- Definitions ---
+
+#define HEAP_LINE_SIZE       96
+
+#ifdef NHNS_HOST
+// No linker regions on the host, stand-ins of the target's sizes
+#define HEAP_HOST_SRAM1_SIZE (96 * 1024)
+#define HEAP_HOST_SRAM2_SIZE (16 * 1024)
+#endif
+
+// --- Types ---
+
+typedef struct heap_context
+{
+    bool fInitDone;
+    uint8_t *apbStart[HEAP_REGION_MAX];
+    size_t adwSize[HEAP_REGION_MAX];
+} heap_context_t;
+
+// --- Global Variables ---
+
+static heap_context_t gsHeap = {0};
+
+#ifdef NHNS_HOST
+static uint8_t gabHostSram1[HEAP_HOST_SRAM1_SIZE] __attribute__((aligned(portBYTE_ALIGNMENT)));
+static uint8_t gabHostSram2[HEAP_HOST_SRAM2_SIZE] __attribute__((aligned(portBYTE_ALIGNMENT)));
+#else
+// Region bounds, provided by the linker
+extern uint8_t _sheap_sram1[];
+extern uint8_t _eheap_sram1[];
+extern uint8_t _sheap_sram2[];
+extern uint8_t _eheap_sram2[];
+#endif
+
+static const char *const gaszRegionNames[HEAP_REGION_MAX] = {
+    [HEAP_REGION_DEFAULT] = "SRAM1",
+    [HEAP_REGION_DMA]     = "SRAM2 (DMA)",
+};
+
+// Allocator of HEAP_REGION_DMA, a renamed heap_5 built by heap_dma.c
+void HEAP_DmaDefineHeapRegions(const HeapRegion_t *const pxHeapRegions);
+void HEAP_DmaGetHeapStats(HeapStats_t *pxHeapStats);
+void *HEAP_DmaMalloc(size_t xWantedSize);
+void HEAP_DmaFree(void *pv);
+
+// --- Functions ---
+
+nhns_status_t HEAP_Init(void)
+{
+    HeapRegion_t asRegions[2] = {0};
+
+    // 1) Check if module is already initialized
+    if (gsHeap.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Collect the region bounds
+#ifdef NHNS_HOST
+    gsHeap.apbStart[HEAP_REGION_DEFAULT] = gabHostSram1;
+    gsHeap.adwSize[HEAP_REGION_DEFAULT]  = sizeof(gabHostSram1);
+    gsHeap.apbStart[HEAP_REGION_DMA]     = gabHostSram2;
+    gsHeap.adwSize[HEAP_REGION_DMA]      = sizeof(gabHostSram2);
+#else
+    gsHeap.apbStart[HEAP_REGION_DEFAULT] = _sheap_sram1;
+    gsHeap.adwSize[HEAP_REGION_DEFAULT]  = (size_t)(_eheap_sram1 - _sheap_sram1);
+    gsHeap.apbStart[HEAP_REGION_DMA]     = _sheap_sram2;
+    gsHeap.adwSize[HEAP_REGION_DMA]      = (size_t)(_eheap_sram2 - _sheap_sram2);
+#endif
+
+    // 3) One region per allocator, each list ends with an empty entry
+    asRegions[0].pucStartAddress = gsHeap.apbStart[HEAP_REGION_DEFAULT];
+    asRegions[0].xSizeInBytes    = gsHeap.adwSize[HEAP_REGION_DEFAULT];
+    vPortDefineHeapRegions(asRegions);
+
+    asRegions[0].pucStartAddress = gsHeap.apbStart[HEAP_REGION_DMA];
+    asRegions[0].xSizeInBytes    = gsHeap.adwSize[HEAP_REGION_DMA];
+    HEAP_DmaDefineHeapRegions(asRegions);
+
+    gsHeap.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+void *HEAP_Alloc(size_t dwSize, heap_region_t nRegion)
+{
+    switch (nRegion)
+    {
+        case HEAP_REGION_DEFAULT:
+            return pvPortMalloc(dwSize);
+        case HEAP_REGION_DMA:
+            return HEAP_DmaMalloc(dwSize);
+        default:
+            return NULL;
+    }
+}
+
+void HEAP_Free(void *pvBlock)
+{
+    uint8_t *pbBlock = pvBlock;
+
+    if (pbBlock >= gsHeap.apbStart[HEAP_REGION_DMA] &&
+        pbBlock < gsHeap.apbStart[HEAP_REGION_DMA] + gsHeap.adwSize[HEAP_REGION_DMA])
+    {
+        HEAP_DmaFree(pvBlock);
+    }
+    else
+    {
+        vPortFree(pvBlock);
+    }
+}
+
+nhns_status_t HEAP_GetStats(heap_region_t nRegion, heap_stats_t *psStats)
+{
+    HeapStats_t sKernel = {0};
+
+    // 1) Verify arguments
+    if (nRegion <= HEAP_REGION_INVALID || nRegion >= HEAP_REGION_MAX || psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsHeap.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Walk the free list of the region's allocator
+    if (nRegion == HEAP_REGION_DMA)
+    {
+        HEAP_DmaGetHeapStats(&sKernel);
+    }
+    else
+    {
+        vPortGetHeapStats(&sKernel);
+    }
+
+    psStats->dwSize         = (uint32_t)gsHeap.adwSize[nRegion];
+    psStats->dwFree         = (uint32_t)sKernel.xAvailableHeapSpaceInBytes;
+    psStats->dwMinimumFree  = (uint32_t)sKernel.xMinimumEverFreeBytesRemaining;
+    psStats->dwLargestBlock = (uint32_t)sKernel.xSizeOfLargestFreeBlockInBytes;
+    psStats->dwFreeBlocks   = (uint32_t)sKernel.xNumberOfFreeBlocks;
+    psStats->dwAllocations  = (uint32_t)sKernel.xNumberOfSuccessfulAllocations;
+    psStats->dwFrees        = (uint32_t)sKernel.xNumberOfSuccessfulFrees;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t HEAP_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    heap_stats_t sStats;
+    char szLine[HEAP_LINE_SIZE];
+    int nLength = 0;
+
+    nLength = snprintf(szLine, sizeof(szLine), "heap:\r\n%-12s %7s %7s %7s %7s %6s %7s %7s\r\n", "region", "size",
+                       "free", "min", "largest", "blocks", "allocs", "frees");
+    nRet    = UART_PrintLine(nID, szLine, nLength, HEAP_LINE_SIZE);
+
+    for (int nRegion = 0; nRegion < HEAP_REGION_MAX && nRet == NHNS_STATUS_OK; nRegion++)
+    {
+        nRet = HEAP_GetStats((heap_region_t)nRegion, &sStats);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            break;
+        }
+
+        nLength = snprintf(szLine, sizeof(szLine), "%-12s %7lu %7lu %7lu %7lu %6lu %7lu %7lu\r\n",
+                           gaszRegionNames[nRegion], (unsigned long)sStats.dwSize, (unsigned long)sStats.dwFree,
+                           (unsigned long)sStats.dwMinimumFree, (unsigned long)sStats.dwLargestBlock,
+                           (unsigned long)sStats.dwFreeBlocks, (unsigned long)sStats.dwAllocations,
+                           (unsigned long)sStats.dwFrees);
+        nRet    = UART_PrintLine(nID, szLine, nLength, HEAP_LINE_SIZE);
+    }
+
+    return nRet;
+}
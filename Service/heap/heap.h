@@ -0,0 +1,84 @@
+#ifndef __HEAP_H__
+#define __HEAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * SRAM1 (112K) and SRAM2 (16K) sit on separate bus matrix ports. General
+ * allocations, including pvPortMalloc from the kernel, come from SRAM1; DMA
+ * buffers are placed in SRAM2 so Ethernet/USB transfers do not stall the CPU
+ * on its stacks and data. Each region is managed by its own heap_5 instance.
+ */
+typedef enum heap_region
+{
+    HEAP_REGION_INVALID = -1,
+    HEAP_REGION_DEFAULT,    // SRAM1, shared with pvPortMalloc
+    HEAP_REGION_DMA,        // SRAM2
+    HEAP_REGION_MAX,
+} heap_region_t;
+
+// Place a static buffer in SRAM2. The section is not initialized at start-up
+#ifdef NHNS_HOST
+#define HEAP_DMA_BUFFER
+#else
+#define HEAP_DMA_BUFFER __attribute__((section(".sram2")))
+#endif
+
+// --- Types ---
+
+typedef struct heap_stats
+{
+    uint32_t dwSize;
+    uint32_t dwFree;
+    uint32_t dwMinimumFree;
+    uint32_t dwLargestBlock;
+    uint32_t dwFreeBlocks;
+    uint32_t dwAllocations;
+    uint32_t dwFrees;
+} heap_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Hand the linker-defined regions to the allocators
+ * @retval Status code indicating operation success or reason for failure
+ * @note Must run before anything calls pvPortMalloc
+ */
+nhns_status_t HEAP_Init(void);
+
+/**
+ * @brief Allocate from a region
+ * @param dwSize - Number of bytes
+ * @param nRegion - Region to allocate from
+ * @retval Block aligned to portBYTE_ALIGNMENT, NULL if the region is exhausted
+ * @note Not callable from interrupts
+ */
+void *HEAP_Alloc(size_t dwSize, heap_region_t nRegion);
+
+/**
+ * @brief Return a block to the region it came from
+ * @param pvBlock - Block from HEAP_Alloc or pvPortMalloc, NULL is ignored
+ */
+void HEAP_Free(void *pvBlock);
+
+/**
+ * @brief Get the usage of a region
+ * @param nRegion - Region to query
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t HEAP_GetStats(heap_region_t nRegion, heap_stats_t *psStats);
+
+/**
+ * @brief Print the statistics of every region
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t HEAP_Dump(uart_instance_t nID);
+
+#endif    // __HEAP_H__
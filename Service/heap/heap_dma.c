@@ -0,0 +1,22 @@
+/*
+ * Second instance of FreeRTOS heap_5 for HEAP_REGION_DMA. heap_5 keeps one
+ * free list for all of its regions and always allocates first fit, so it
+ * cannot honour a placement request; SRAM2 gets its own copy of the allocator
+ * under HEAP_Dma* names instead, and stays out of reach of pvPortMalloc.
+ */
+
+#include <stddef.h>
+
+#define vPortDefineHeapRegions                HEAP_DmaDefineHeapRegions
+#define vPortGetHeapStats                     HEAP_DmaGetHeapStats
+#define pvPortMalloc                          HEAP_DmaMalloc
+#define pvPortCalloc                          HEAP_DmaCalloc
+#define vPortFree                             HEAP_DmaFree
+#define vPortInitialiseBlocks                 HEAP_DmaInitialiseBlocks
+#define xPortGetFreeHeapSize                  HEAP_DmaGetFreeHeapSize
+#define xPortGetMinimumEverFreeHeapSize       HEAP_DmaGetMinimumEverFreeHeapSize
+#define xPortResetHeapMinimumEverFreeHeapSize HEAP_DmaResetHeapMinimumEverFreeHeapSize
+#define vPortHeapResetState                   HEAP_DmaHeapResetState
+
+// Found relative to the kernel include directory
+#include "../portable/MemMang/heap_5.c"
@@ -0,0 +1,1323 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "kvstore.h"
+#include "board.h"
+#include "clock.h"
+#include "crc.h"
+#include "dlog.h"
+#include "flash.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define KVSTORE_LINE_SIZE        128
+
+#define KVSTORE_MAGIC            0x3153564BU    // "KVS1"
+#define KVSTORE_HEADER_SIZE      16
+#define KVSTORE_SEQUENCE_OFFSET  12
+#define KVSTORE_SECTOR_ROOM      (KVSTORE_SECTOR_SIZE - KVSTORE_HEADER_SIZE)
+#define KVSTORE_SECTOR_NONE      0xFFFFFFFFU
+
+#define KVSTORE_RECORD_HEADER    8
+#define KVSTORE_FLAG_TOMBSTONE   0x01U
+#define KVSTORE_ALIGN(dwLength)  (((dwLength) + 3U) & ~3U)
+#define KVSTORE_RECORD_SIZE(dwKeyLength, dwValueLength) \
+    (KVSTORE_RECORD_HEADER + KVSTORE_ALIGN(dwKeyLength) + KVSTORE_ALIGN(dwValueLength))
+#define KVSTORE_RECORD_MAX       KVSTORE_RECORD_SIZE(KVSTORE_KEY_MAX, KVSTORE_VALUE_MAX)
+
+#define KVSTORE_HEADER_WORD(dwKeyLength, dwFlags, dwValueLength) \
+    ((dwKeyLength) | ((dwFlags) << 8) | ((dwValueLength) << 16))
+#define KVSTORE_KEY_LENGTH(dwHeader)   ((dwHeader) & 0xFFU)
+#define KVSTORE_FLAGS(dwHeader)        (((dwHeader) >> 8) & 0xFFU)
+#define KVSTORE_VALUE_LENGTH(dwHeader) ((dwHeader) >> 16)
+
+// Every sector but the spare one can lose a record's worth at its end, the newest must still take the largest record
+#define KVSTORE_CAPACITY         ((KVSTORE_SECTOR_COUNT - 1) * (KVSTORE_SECTOR_ROOM - KVSTORE_RECORD_MAX))
+
+// Open addressing with linear probing, at most 3/4 full
+#define KVSTORE_INDEX_SIZE       256
+#define KVSTORE_INDEX_MASK       (KVSTORE_INDEX_SIZE - 1)
+
+#define KVSTORE_FNV_OFFSET       0x811C9DC5U
+#define KVSTORE_FNV_PRIME        0x01000193U
+
+#define KVSTORE_GC_STACK_SIZE    (configMINIMAL_STACK_SIZE * 2)
+#define KVSTORE_GC_PRIORITY      (tskIDLE_PRIORITY + 1)
+
+#define KVSTORE_BENCH_KEYS       16
+#define KVSTORE_BENCH_VALUE      32
+#define KVSTORE_BENCH_SETS       4096
+#define KVSTORE_BENCH_WAIT_MS    10000    // Longest a set waits for room, a few erases
+
+_Static_assert(KVSTORE_SECTOR_COUNT >= 2, "The store needs a spare sector besides the records");
+_Static_assert(KVSTORE_KEY_MAX <= 0xFF && KVSTORE_VALUE_MAX <= 0xFFFF, "Lengths must fit the record header");
+_Static_assert((KVSTORE_INDEX_SIZE & KVSTORE_INDEX_MASK) == 0, "The index size must be a power of two");
+_Static_assert(KVSTORE_MAX_KEYS * 4 <= KVSTORE_INDEX_SIZE * 3, "The index must stay at most 3/4 full");
+
+// --- Types ---
+
+typedef enum kvstore_state
+{
+    KVSTORE_STATE_FREE = 0,    // Erased, takes records once its sequence is written
+    KVSTORE_STATE_ACTIVE,      // Holds records
+    KVSTORE_STATE_DIRTY,       // Nothing live left, waits for the erase
+    KVSTORE_STATE_ERASING,     // Owned by the compaction task
+} kvstore_state_t;
+
+typedef struct kvstore_sector
+{
+    kvstore_state_t nState;
+    bool fHeader;           // Free sector whose magic and erase count are written
+    uint32_t dwSequence;
+    uint32_t dwErases;
+    uint32_t dwUsed;        // Offset of the first blank byte
+    uint32_t dwLive;        // Bytes of the records the index points to
+} kvstore_sector_t;
+
+typedef struct kvstore_slot
+{
+    uint32_t dwAddress;    // Latest record of the key, 0 for an empty slot
+    uint32_t dwHash;
+} kvstore_slot_t;
+
+typedef struct kvstore_context
+{
+    bool fInitDone;
+    SemaphoreHandle_t xLock;
+    TaskHandle_t xTask;
+
+    kvstore_sector_t asSectors[KVSTORE_SECTOR_COUNT];
+    uint32_t dwHead;          // Sector taking records, KVSTORE_SECTOR_NONE while none is
+    uint32_t dwCompacting;    // Sector being copied out, KVSTORE_SECTOR_NONE while none is
+    uint32_t dwSequence;      // Sequence of the next sector to take records
+    uint32_t dwFree;          // Sectors in KVSTORE_STATE_FREE
+
+    kvstore_slot_t asIndex[KVSTORE_INDEX_SIZE];
+
+    kvstore_stats_t sStats;    // Counters, the rest is filled in by KVSTORE_GetStats
+} kvstore_context_t;
+
+// --- Global Variables ---
+
+static kvstore_context_t gsKvstore = {0};
+
+static const char *const gaszKvstoreStates[] = {"free", "active", "dirty", "erasing"};
+
+RTOS_SEMAPHORE_DEFINE(kvstore_lock);
+RTOS_TASK_DEFINE(kvstore, KVSTORE_GC_STACK_SIZE);
+
+// --- Static Functions ---
+
+/**
+ * @brief Read a word of the memory-mapped flash
+ * @param dwAddress - Word aligned address
+ * @retval Word
+ */
+static inline uint32_t KVSTORE_Read(uint32_t dwAddress)
+{
+    return *(const uint32_t *)(uintptr_t)dwAddress;
+}
+
+/**
+ * @brief Get the address of a sector
+ * @param dwSector - Sector of the store, from 0
+ * @retval Address of its header
+ */
+static inline uint32_t KVSTORE_SectorAddress(uint32_t dwSector)
+{
+    return KVSTORE_FLASH_ADDRESS + dwSector * KVSTORE_SECTOR_SIZE;
+}
+
+/**
+ * @brief Get the sector a record lies in
+ * @param dwAddress - Record address
+ * @retval Sector state
+ */
+static inline kvstore_sector_t *KVSTORE_SectorOf(uint32_t dwAddress)
+{
+    return &gsKvstore.asSectors[(dwAddress - KVSTORE_FLASH_ADDRESS) / KVSTORE_SECTOR_SIZE];
+}
+
+/**
+ * @brief Check that a range of the flash is erased
+ * @param dwAddress - Word aligned address
+ * @param dwLength - Number of bytes, a multiple of 4
+ * @retval true when every word reads FLASH_ERASED_WORD
+ */
+static bool KVSTORE_IsBlank(uint32_t dwAddress, uint32_t dwLength)
+{
+    for (uint32_t dwOffset = 0; dwOffset < dwLength; dwOffset += sizeof(uint32_t))
+    {
+        if (KVSTORE_Read(dwAddress + dwOffset) != FLASH_ERASED_WORD)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compute the CRC of a record with the CRC unit
+ * @param dwHeader - First word of the record
+ * @param pvKey - Key bytes, in RAM or in the flash
+ * @param dwKeyLength - Key length
+ * @param pvValue - Value bytes, in RAM or in the flash
+ * @param dwValueLength - Value length
+ * @param pdwCrc - Returns the CRC
+ * @retval Status code indicating operation success or reason for failure
+ * @note Key and value are each padded with 0xFF as written to the flash
+ */
+static nhns_status_t KVSTORE_Crc(uint32_t dwHeader, const void *pvKey, uint32_t dwKeyLength, const void *pvValue,
+                                 uint32_t dwValueLength, uint32_t *pdwCrc)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    nhns_status_t nEnd = NHNS_STATUS_OK;
+
+    nRet = CRC_Begin();
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+    nRet = CRC_Update(&dwHeader, sizeof(dwHeader));
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = CRC_Update(pvKey, dwKeyLength);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = CRC_Update(pvValue, dwValueLength);
+    }
+    nEnd = CRC_End(pdwCrc);
+
+    return (nRet != NHNS_STATUS_OK) ? nRet : nEnd;
+}
+
+/**
+ * @brief Hash a key, FNV-1a
+ * @param pbKey - Key bytes
+ * @param dwLength - Key length
+ * @retval Hash
+ */
+static uint32_t KVSTORE_Hash(const uint8_t *pbKey, uint32_t dwLength)
+{
+    uint32_t dwHash = KVSTORE_FNV_OFFSET;
+
+    for (uint32_t dwIndex = 0; dwIndex < dwLength; dwIndex++)
+    {
+        dwHash = (dwHash ^ pbKey[dwIndex]) * KVSTORE_FNV_PRIME;
+    }
+
+    return dwHash;
+}
+
+/**
+ * @brief Get the length of a key
+ * @param szKey - Key
+ * @retval Length, 0 for a missing, empty or too long key
+ */
+static uint32_t KVSTORE_KeyLength(const char *szKey)
+{
+    uint32_t dwLength = 0;
+
+    if (szKey == NULL)
+    {
+        return 0;
+    }
+    while (szKey[dwLength] != '\0')
+    {
+        if (++dwLength > KVSTORE_KEY_MAX)
+        {
+            return 0;
+        }
+    }
+
+    return dwLength;
+}
+
+/**
+ * @brief Check the first word of a record
+ * @param dwHeader - First word
+ * @retval true when the lengths and flags can belong to a record
+ */
+static bool KVSTORE_IsRecord(uint32_t dwHeader)
+{
+    uint32_t dwFlags = KVSTORE_FLAGS(dwHeader);
+
+    return KVSTORE_KEY_LENGTH(dwHeader) != 0 && KVSTORE_KEY_LENGTH(dwHeader) <= KVSTORE_KEY_MAX &&
+           KVSTORE_VALUE_LENGTH(dwHeader) <= KVSTORE_VALUE_MAX && (dwFlags & ~KVSTORE_FLAG_TOMBSTONE) == 0 &&
+           (dwFlags == 0 || KVSTORE_VALUE_LENGTH(dwHeader) == 0);
+}
+
+/**
+ * @brief Look a key up in the index, with the lock held
+ * @param pbKey - Key bytes, in RAM or in the flash
+ * @param dwLength - Key length
+ * @param dwHash - KVSTORE_Hash of the key
+ * @retval Slot of the key, or the empty slot ending its probe sequence
+ */
+static uint32_t KVSTORE_Find(const uint8_t *pbKey, uint32_t dwLength, uint32_t dwHash)
+{
+    uint32_t dwSlot    = dwHash & KVSTORE_INDEX_MASK;
+    uint32_t dwAddress = 0;
+
+    // The index is never full, every probe ends on an empty slot
+    while ((dwAddress = gsKvstore.asIndex[dwSlot].dwAddress) != 0)
+    {
+        if (gsKvstore.asIndex[dwSlot].dwHash == dwHash && KVSTORE_KEY_LENGTH(KVSTORE_Read(dwAddress)) == dwLength &&
+            memcmp((const void *)(uintptr_t)(dwAddress + KVSTORE_RECORD_HEADER), pbKey, dwLength) == 0)
+        {
+            break;
+        }
+        dwSlot = (dwSlot + 1) & KVSTORE_INDEX_MASK;
+    }
+
+    return dwSlot;
+}
+
+/**
+ * @brief Empty a slot, moving back the entries that probed past it, with the lock held
+ * @param dwSlot - Slot of the key
+ */
+static void KVSTORE_Remove(uint32_t dwSlot)
+{
+    uint32_t dwAddress = gsKvstore.asIndex[dwSlot].dwAddress;
+    uint32_t dwHeader  = KVSTORE_Read(dwAddress);
+    uint32_t dwSize    = KVSTORE_RECORD_SIZE(KVSTORE_KEY_LENGTH(dwHeader), KVSTORE_VALUE_LENGTH(dwHeader));
+    uint32_t dwNext    = (dwSlot + 1) & KVSTORE_INDEX_MASK;
+    uint32_t dwHome    = 0;
+
+    // 1) The record is stale from now on
+    KVSTORE_SectorOf(dwAddress)->dwLive -= dwSize;
+    gsKvstore.sStats.dwLive -= dwSize;
+    gsKvstore.sStats.dwKeys--;
+
+    // 2) An entry may fill the hole when its home slot is not between the hole and itself
+    while (gsKvstore.asIndex[dwNext].dwAddress != 0)
+    {
+        dwHome = gsKvstore.asIndex[dwNext].dwHash & KVSTORE_INDEX_MASK;
+        if (((dwNext - dwHome) & KVSTORE_INDEX_MASK) >= ((dwNext - dwSlot) & KVSTORE_INDEX_MASK))
+        {
+            gsKvstore.asIndex[dwSlot] = gsKvstore.asIndex[dwNext];
+            dwSlot                    = dwNext;
+        }
+        dwNext = (dwNext + 1) & KVSTORE_INDEX_MASK;
+    }
+    gsKvstore.asIndex[dwSlot].dwAddress = 0;
+}
+
+/**
+ * @brief Point the index at a record, or drop its key for a tombstone, with the lock held
+ * @param dwAddress - Record address, its CRC checked
+ */
+static void KVSTORE_Apply(uint32_t dwAddress)
+{
+    uint32_t dwHeader    = KVSTORE_Read(dwAddress);
+    uint32_t dwLength    = KVSTORE_KEY_LENGTH(dwHeader);
+    const uint8_t *pbKey = (const uint8_t *)(uintptr_t)(dwAddress + KVSTORE_RECORD_HEADER);
+    uint32_t dwHash      = KVSTORE_Hash(pbKey, dwLength);
+    uint32_t dwSlot      = KVSTORE_Find(pbKey, dwLength, dwHash);
+    uint32_t dwSize      = KVSTORE_RECORD_SIZE(dwLength, KVSTORE_VALUE_LENGTH(dwHeader));
+
+    // 1) The previous record of the key goes stale
+    if (gsKvstore.asIndex[dwSlot].dwAddress != 0)
+    {
+        KVSTORE_Remove(dwSlot);
+        dwSlot = KVSTORE_Find(pbKey, dwLength, dwHash);
+    }
+
+    // 2) Tombstones only hide older records
+    if ((KVSTORE_FLAGS(dwHeader) & KVSTORE_FLAG_TOMBSTONE) != 0)
+    {
+        return;
+    }
+
+    // 3) Mount may meet more keys than the index takes when the limit was lowered
+    if (gsKvstore.sStats.dwKeys >= KVSTORE_MAX_KEYS)
+    {
+        DLOG_WARN("kvstore: index full, record at %x dropped", dwAddress);
+        return;
+    }
+
+    gsKvstore.asIndex[dwSlot].dwAddress = dwAddress;
+    gsKvstore.asIndex[dwSlot].dwHash    = dwHash;
+    KVSTORE_SectorOf(dwAddress)->dwLive += dwSize;
+    gsKvstore.sStats.dwLive += dwSize;
+    gsKvstore.sStats.dwKeys++;
+}
+
+/**
+ * @brief Program bytes, the last word padded with 0xFF
+ * @param dwAddress - Word aligned address
+ * @param pvData - Bytes, in RAM or in the flash
+ * @param dwLength - Number of bytes
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Program(uint32_t dwAddress, const void *pvData, uint32_t dwLength)
+{
+    uint32_t dwWhole   = dwLength & ~3U;
+    uint32_t dwWord    = FLASH_ERASED_WORD;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    if (dwWhole != 0)
+    {
+        nRet = FLASH_Program(dwAddress, pvData, dwWhole);
+    }
+    if (nRet == NHNS_STATUS_OK && dwWhole != dwLength)
+    {
+        memcpy(&dwWord, (const uint8_t *)pvData + dwWhole, dwLength - dwWhole);
+        nRet = FLASH_Program(dwAddress + dwWhole, &dwWord, sizeof(dwWord));
+    }
+
+    return nRet;
+}
+
+/**
+ * @brief Pick the oldest sector holding records, with the lock held
+ * @retval Sector, KVSTORE_SECTOR_NONE when all are free or dirty
+ */
+static uint32_t KVSTORE_Oldest(void)
+{
+    uint32_t dwOldest = KVSTORE_SECTOR_NONE;
+
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        if (gsKvstore.asSectors[dwSector].nState == KVSTORE_STATE_ACTIVE &&
+            (dwOldest == KVSTORE_SECTOR_NONE ||
+             gsKvstore.asSectors[dwSector].dwSequence < gsKvstore.asSectors[dwOldest].dwSequence))
+        {
+            dwOldest = dwSector;
+        }
+    }
+
+    return dwOldest;
+}
+
+/**
+ * @brief Start appending to the least worn free sector, with the lock held
+ * @param dwReserve - Free sectors to leave alone, 1 for writers so compaction always has one
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Open(uint32_t dwReserve)
+{
+    kvstore_sector_t *psSector = NULL;
+    uint32_t dwChosen          = KVSTORE_SECTOR_NONE;
+    uint32_t adwHeader[4]      = {0};
+    nhns_status_t nRet         = NHNS_STATUS_OK;
+
+    if (gsKvstore.dwFree <= dwReserve)
+    {
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 1) Wear leveling
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        if (gsKvstore.asSectors[dwSector].nState == KVSTORE_STATE_FREE &&
+            (dwChosen == KVSTORE_SECTOR_NONE ||
+             gsKvstore.asSectors[dwSector].dwErases < gsKvstore.asSectors[dwChosen].dwErases))
+        {
+            dwChosen = dwSector;
+        }
+    }
+    psSector = &gsKvstore.asSectors[dwChosen];
+
+    // 2) The sequence makes it the newest, a sector never erased by the store gets its whole header now
+    adwHeader[0] = KVSTORE_MAGIC;
+    adwHeader[1] = psSector->dwErases;
+    adwHeader[2] = ~psSector->dwErases;
+    adwHeader[3] = gsKvstore.dwSequence;
+    if (psSector->fHeader)
+    {
+        nRet = FLASH_Program(KVSTORE_SectorAddress(dwChosen) + KVSTORE_SEQUENCE_OFFSET, &adwHeader[3],
+                             sizeof(adwHeader[3]));
+    }
+    else
+    {
+        nRet = FLASH_Program(KVSTORE_SectorAddress(dwChosen), adwHeader, sizeof(adwHeader));
+    }
+
+    gsKvstore.dwFree--;
+    if (nRet != NHNS_STATUS_OK)
+    {
+        DLOG_ERROR("kvstore: sector %u header not written (%d)", dwChosen, nRet);
+        psSector->nState = KVSTORE_STATE_DIRTY;
+        return nRet;
+    }
+
+    psSector->nState     = KVSTORE_STATE_ACTIVE;
+    psSector->dwSequence = gsKvstore.dwSequence++;
+    psSector->dwUsed     = KVSTORE_HEADER_SIZE;
+    psSector->dwLive     = 0;
+    gsKvstore.dwHead     = dwChosen;
+
+    return NHNS_STATUS_OK;
+}
+
+/**
+ * @brief Append a record to the newest sector, with the lock held
+ * @param dwHeader - First word
+ * @param pvKey - Key bytes, in RAM or in the flash
+ * @param pvValue - Value bytes, in RAM or in the flash
+ * @param dwCrc - CRC of the record
+ * @param fCompaction - true for a copy, which may take the last free sector
+ * @param pdwAddress - Returns the record address
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Append(uint32_t dwHeader, const void *pvKey, const void *pvValue, uint32_t dwCrc,
+                                    bool fCompaction, uint32_t *pdwAddress)
+{
+    uint32_t dwKeyLength     = KVSTORE_KEY_LENGTH(dwHeader);
+    uint32_t dwSize          = KVSTORE_RECORD_SIZE(dwKeyLength, KVSTORE_VALUE_LENGTH(dwHeader));
+    uint32_t dwRoom          = 0;
+    uint32_t dwAddress       = 0;
+    kvstore_sector_t *psHead = NULL;
+    nhns_status_t nRet       = NHNS_STATUS_OK;
+
+    // 1) A new sector when the record does not fit the newest
+    if (gsKvstore.dwHead != KVSTORE_SECTOR_NONE)
+    {
+        dwRoom = KVSTORE_SECTOR_SIZE - gsKvstore.asSectors[gsKvstore.dwHead].dwUsed;
+    }
+    if (dwRoom < dwSize)
+    {
+        nRet = KVSTORE_Open(fCompaction ? 0 : 1);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            return nRet;
+        }
+    }
+    // 2) Once compaction has taken the last free sector, writers leave it the room it still needs
+    else if (!fCompaction && gsKvstore.dwFree == 0 && gsKvstore.dwCompacting != KVSTORE_SECTOR_NONE &&
+             dwRoom - dwSize < gsKvstore.asSectors[gsKvstore.dwCompacting].dwLive)
+    {
+        return NHNS_STATUS_BUSY;
+    }
+
+    // 3) First word, key, value and the CRC last. A failed record still takes its space
+    psHead    = &gsKvstore.asSectors[gsKvstore.dwHead];
+    dwAddress = KVSTORE_SectorAddress(gsKvstore.dwHead) + psHead->dwUsed;
+    psHead->dwUsed += dwSize;
+
+    nRet = FLASH_Program(dwAddress, &dwHeader, sizeof(dwHeader));
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = KVSTORE_Program(dwAddress + KVSTORE_RECORD_HEADER, pvKey, dwKeyLength);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = KVSTORE_Program(dwAddress + KVSTORE_RECORD_HEADER + KVSTORE_ALIGN(dwKeyLength), pvValue,
+                               KVSTORE_VALUE_LENGTH(dwHeader));
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = FLASH_Program(dwAddress + sizeof(dwHeader), &dwCrc, sizeof(dwCrc));
+    }
+
+    // 4) Whatever failed to program may not be blank, nothing more goes into this sector
+    if (nRet != NHNS_STATUS_OK)
+    {
+        DLOG_ERROR("kvstore: record at %x not written (%d)", dwAddress, nRet);
+        psHead->dwUsed = KVSTORE_SECTOR_SIZE;
+        return nRet;
+    }
+
+    *pdwAddress = dwAddress;
+
+    return NHNS_STATUS_OK;
+}
+
+/**
+ * @brief Check whether the compaction task has work, with the lock held
+ * @retval true when a sector waits for its erase, or the newest may not take the next record
+ */
+static bool KVSTORE_NeedsCompaction(void)
+{
+    uint32_t dwRoom = 0;
+
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        if (gsKvstore.asSectors[dwSector].nState == KVSTORE_STATE_DIRTY)
+        {
+            return true;
+        }
+    }
+    if (gsKvstore.dwHead != KVSTORE_SECTOR_NONE)
+    {
+        dwRoom = KVSTORE_SECTOR_SIZE - gsKvstore.asSectors[gsKvstore.dwHead].dwUsed;
+    }
+
+    return gsKvstore.dwFree < 2 && dwRoom < KVSTORE_RECORD_MAX && KVSTORE_Oldest() != KVSTORE_SECTOR_NONE;
+}
+
+/**
+ * @brief Classify a sector by its header and contents
+ * @param dwSector - Sector of the store, from 0
+ */
+static void KVSTORE_Classify(uint32_t dwSector)
+{
+    kvstore_sector_t *psSector = &gsKvstore.asSectors[dwSector];
+    uint32_t dwBase            = KVSTORE_SectorAddress(dwSector);
+
+    // 1) A header, with the sequence written once the sector took records
+    if (KVSTORE_Read(dwBase) == KVSTORE_MAGIC && KVSTORE_Read(dwBase + 8) == ~KVSTORE_Read(dwBase + 4))
+    {
+        psSector->dwErases   = KVSTORE_Read(dwBase + 4);
+        psSector->dwSequence = KVSTORE_Read(dwBase + KVSTORE_SEQUENCE_OFFSET);
+        psSector->fHeader    = true;
+        if (psSector->dwSequence != FLASH_ERASED_WORD)
+        {
+            psSector->nState = KVSTORE_STATE_ACTIVE;
+        }
+        else if (KVSTORE_IsBlank(dwBase + KVSTORE_HEADER_SIZE, KVSTORE_SECTOR_ROOM))
+        {
+            psSector->nState = KVSTORE_STATE_FREE;
+            psSector->dwUsed = KVSTORE_HEADER_SIZE;
+        }
+        else
+        {
+            psSector->nState = KVSTORE_STATE_DIRTY;
+        }
+    }
+    // 2) Never used by the store
+    else if (KVSTORE_IsBlank(dwBase, KVSTORE_SECTOR_SIZE))
+    {
+        psSector->nState     = KVSTORE_STATE_FREE;
+        psSector->dwSequence = FLASH_ERASED_WORD;
+    }
+    // 3) A torn erase or header, or foreign data
+    else
+    {
+        psSector->nState = KVSTORE_STATE_DIRTY;
+    }
+}
+
+/**
+ * @brief Replay the records of a sector into the index
+ * @param dwSector - Sector of the store, from 0
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Scan(uint32_t dwSector)
+{
+    kvstore_sector_t *psSector = &gsKvstore.asSectors[dwSector];
+    uint32_t dwBase            = KVSTORE_SectorAddress(dwSector);
+    uint32_t dwOffset          = KVSTORE_HEADER_SIZE;
+    uint32_t dwHeader          = 0;
+    uint32_t dwSize            = 0;
+    uint32_t dwKey             = 0;
+    uint32_t dwCrc             = 0;
+    nhns_status_t nRet         = NHNS_STATUS_OK;
+
+    // 1) Records up to the first blank word
+    while (dwOffset + KVSTORE_RECORD_HEADER <= KVSTORE_SECTOR_SIZE)
+    {
+        dwHeader = KVSTORE_Read(dwBase + dwOffset);
+        if (dwHeader == FLASH_ERASED_WORD)
+        {
+            break;
+        }
+
+        // A torn first word leaves no way to the next record
+        dwSize = KVSTORE_RECORD_SIZE(KVSTORE_KEY_LENGTH(dwHeader), KVSTORE_VALUE_LENGTH(dwHeader));
+        if (!KVSTORE_IsRecord(dwHeader) || dwOffset + dwSize > KVSTORE_SECTOR_SIZE)
+        {
+            dwOffset = KVSTORE_SECTOR_SIZE;
+            break;
+        }
+
+        // A record cut short keeps its space but is never read
+        dwKey = dwBase + dwOffset + KVSTORE_RECORD_HEADER;
+        nRet  = KVSTORE_Crc(dwHeader, (const void *)(uintptr_t)dwKey, KVSTORE_KEY_LENGTH(dwHeader),
+                            (const void *)(uintptr_t)(dwKey + KVSTORE_ALIGN(KVSTORE_KEY_LENGTH(dwHeader))),
+                            KVSTORE_VALUE_LENGTH(dwHeader), &dwCrc);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            return nRet;
+        }
+        if (KVSTORE_Read(dwBase + dwOffset + sizeof(dwHeader)) == dwCrc)
+        {
+            KVSTORE_Apply(dwBase + dwOffset);
+        }
+        else
+        {
+            gsKvstore.sStats.dwTorn++;
+        }
+        dwOffset += dwSize;
+    }
+
+    // 2) Appends resume only on blank flash
+    if (dwOffset < KVSTORE_SECTOR_SIZE && !KVSTORE_IsBlank(dwBase + dwOffset, KVSTORE_SECTOR_SIZE - dwOffset))
+    {
+        dwOffset = KVSTORE_SECTOR_SIZE;
+    }
+    psSector->dwUsed = dwOffset;
+
+    return NHNS_STATUS_OK;
+}
+
+/**
+ * @brief Copy the next record the index points to out of a sector, with the lock held
+ * @param dwSector - Sector being compacted
+ * @param pdwOffset - Offset to search from, moved past the record copied
+ * @retval NHNS_STATUS_NOT_FOUND once nothing is left to copy, otherwise the status of the copy
+ */
+static nhns_status_t KVSTORE_MoveNext(uint32_t dwSector, uint32_t *pdwOffset)
+{
+    uint32_t dwBase      = KVSTORE_SectorAddress(dwSector);
+    uint32_t dwAddress   = 0;
+    uint32_t dwHeader    = 0;
+    uint32_t dwLength    = 0;
+    uint32_t dwSlot      = 0;
+    uint32_t dwCopy      = 0;
+    const uint8_t *pbKey = NULL;
+    nhns_status_t nRet   = NHNS_STATUS_OK;
+
+    while (*pdwOffset + KVSTORE_RECORD_HEADER <= gsKvstore.asSectors[dwSector].dwUsed)
+    {
+        // 1) The end of the records, or the part of a sealed sector after a torn first word
+        dwAddress = dwBase + *pdwOffset;
+        dwHeader  = KVSTORE_Read(dwAddress);
+        if (dwHeader == FLASH_ERASED_WORD || !KVSTORE_IsRecord(dwHeader))
+        {
+            break;
+        }
+        *pdwOffset += KVSTORE_RECORD_SIZE(KVSTORE_KEY_LENGTH(dwHeader), KVSTORE_VALUE_LENGTH(dwHeader));
+
+        // 2) Stale records, tombstones and torn records are left behind
+        dwLength = KVSTORE_KEY_LENGTH(dwHeader);
+        pbKey    = (const uint8_t *)(uintptr_t)(dwAddress + KVSTORE_RECORD_HEADER);
+        dwSlot   = KVSTORE_Find(pbKey, dwLength, KVSTORE_Hash(pbKey, dwLength));
+        if (gsKvstore.asIndex[dwSlot].dwAddress != dwAddress)
+        {
+            continue;
+        }
+
+        // 3) The copy is the same record, CRC included
+        nRet = KVSTORE_Append(dwHeader, pbKey, pbKey + KVSTORE_ALIGN(dwLength),
+                              KVSTORE_Read(dwAddress + sizeof(dwHeader)), true, &dwCopy);
+        if (nRet == NHNS_STATUS_OK)
+        {
+            KVSTORE_Apply(dwCopy);
+            gsKvstore.sStats.dwMoved++;
+        }
+
+        return nRet;
+    }
+
+    return NHNS_STATUS_NOT_FOUND;
+}
+
+/**
+ * @brief Copy the live records of the oldest sector to the newest and mark it for erasing
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Compact(void)
+{
+    uint32_t dwSector  = KVSTORE_SECTOR_NONE;
+    uint32_t dwOffset  = KVSTORE_HEADER_SIZE;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) The oldest sector stops taking records first if it is also the newest
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    dwSector = KVSTORE_Oldest();
+    if (dwSector == KVSTORE_SECTOR_NONE)
+    {
+        nRet = NHNS_STATUS_NOT_FOUND;
+    }
+    else if (dwSector == gsKvstore.dwHead)
+    {
+        nRet = KVSTORE_Open(0);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        gsKvstore.dwCompacting = dwSector;
+    }
+    xSemaphoreGive(gsKvstore.xLock);
+
+    // 2) One record per lock, writers wait for a single copy at most
+    while (nRet == NHNS_STATUS_OK)
+    {
+        xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+        nRet = KVSTORE_MoveNext(dwSector, &dwOffset);
+        xSemaphoreGive(gsKvstore.xLock);
+    }
+    if (dwSector == KVSTORE_SECTOR_NONE)
+    {
+        return nRet;
+    }
+
+    // 3) Until the erase the copies are newer, so a reset in between replays the same contents
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    gsKvstore.dwCompacting = KVSTORE_SECTOR_NONE;
+    if (nRet == NHNS_STATUS_NOT_FOUND)
+    {
+        gsKvstore.asSectors[dwSector].nState = KVSTORE_STATE_DIRTY;
+        gsKvstore.sStats.dwCompactions++;
+        nRet = NHNS_STATUS_OK;
+    }
+    xSemaphoreGive(gsKvstore.xLock);
+
+    return nRet;
+}
+
+/**
+ * @brief Erase the dirty sectors and write their headers, the lock is not held meanwhile
+ */
+static void KVSTORE_EraseDirty(void)
+{
+    kvstore_sector_t *psSector = NULL;
+    uint32_t adwHeader[3]      = {0};
+    nhns_status_t nRet         = NHNS_STATUS_OK;
+
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        psSector = &gsKvstore.asSectors[dwSector];
+
+        // 1) Nothing reads a dirty sector, erasing takes it from the writers too
+        xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+        if (psSector->nState != KVSTORE_STATE_DIRTY)
+        {
+            xSemaphoreGive(gsKvstore.xLock);
+            continue;
+        }
+        psSector->nState = KVSTORE_STATE_ERASING;
+        psSector->dwErases++;
+        xSemaphoreGive(gsKvstore.xLock);
+
+        // 2) The sequence stays blank until the sector takes records
+        adwHeader[0] = KVSTORE_MAGIC;
+        adwHeader[1] = psSector->dwErases;
+        adwHeader[2] = ~psSector->dwErases;
+        nRet         = FLASH_EraseSector(KVSTORE_FIRST_SECTOR + dwSector);
+        if (nRet == NHNS_STATUS_OK)
+        {
+            nRet = FLASH_Program(KVSTORE_SectorAddress(dwSector), adwHeader, sizeof(adwHeader));
+        }
+
+        xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+        if (nRet == NHNS_STATUS_OK)
+        {
+            psSector->nState     = KVSTORE_STATE_FREE;
+            psSector->fHeader    = true;
+            psSector->dwSequence = FLASH_ERASED_WORD;
+            psSector->dwUsed     = KVSTORE_HEADER_SIZE;
+            gsKvstore.dwFree++;
+            gsKvstore.sStats.dwErases++;
+        }
+        else
+        {
+            DLOG_ERROR("kvstore: sector %u not erased (%d)", dwSector, nRet);
+            psSector->nState = KVSTORE_STATE_DIRTY;
+        }
+        xSemaphoreGive(gsKvstore.xLock);
+    }
+}
+
+/**
+ * @brief Compaction task, runs whenever a write leaves the store short of room
+ * @param pvParameters - Unused
+ */
+static void KVSTORE_Task(void *pvParameters)
+{
+    bool fNeeded = false;
+
+    (void)pvParameters;
+
+    while (1)
+    {
+        // 1) Mount may have left dirty sectors, so the first pass runs unasked
+        for (uint32_t dwPass = 0; dwPass < KVSTORE_SECTOR_COUNT; dwPass++)
+        {
+            KVSTORE_EraseDirty();
+
+            xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+            fNeeded = KVSTORE_NeedsCompaction();
+            xSemaphoreGive(gsKvstore.xLock);
+
+            // A sector full of live records only moves, the next pass reaches the stale ones
+            if (!fNeeded || KVSTORE_Compact() != NHNS_STATUS_OK)
+            {
+                break;
+            }
+        }
+        KVSTORE_EraseDirty();
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Append a record and update the index, with the lock held
+ * @param dwHeader - First word
+ * @param pbKey - Key bytes
+ * @param pvValue - Value bytes
+ * @param dwCrc - CRC of the record
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t KVSTORE_Write(uint32_t dwHeader, const uint8_t *pbKey, const void *pvValue, uint32_t dwCrc)
+{
+    uint32_t dwAddress = 0;
+    nhns_status_t nRet = KVSTORE_Append(dwHeader, pbKey, pvValue, dwCrc, false, &dwAddress);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        KVSTORE_Apply(dwAddress);
+    }
+    else
+    {
+        gsKvstore.sStats.dwRefused++;
+    }
+
+    return nRet;
+}
+
+// --- Functions ---
+
+nhns_status_t KVSTORE_Init(void)
+{
+    uint32_t dwPrevious = 0;
+    uint32_t dwNext     = KVSTORE_SECTOR_NONE;
+    uint32_t dwMaxWear  = 0;
+    bool fFirst         = true;
+    nhns_status_t nRet  = NHNS_STATUS_OK;
+
+    // 1) Check if module is already initialized
+    if (gsKvstore.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    gsKvstore.xLock = RTOS_MUTEX_CREATE(kvstore_lock);
+    if (gsKvstore.xLock == NULL)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+    gsKvstore.dwHead       = KVSTORE_SECTOR_NONE;
+    gsKvstore.dwCompacting = KVSTORE_SECTOR_NONE;
+
+    // 2) Sector states, a sector with an unreadable erase count is taken as the most worn
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        KVSTORE_Classify(dwSector);
+        if (gsKvstore.asSectors[dwSector].dwErases > dwMaxWear)
+        {
+            dwMaxWear = gsKvstore.asSectors[dwSector].dwErases;
+        }
+    }
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        if (gsKvstore.asSectors[dwSector].nState == KVSTORE_STATE_DIRTY && !gsKvstore.asSectors[dwSector].fHeader)
+        {
+            gsKvstore.asSectors[dwSector].dwErases = dwMaxWear;
+        }
+        if (gsKvstore.asSectors[dwSector].nState == KVSTORE_STATE_FREE)
+        {
+            gsKvstore.dwFree++;
+        }
+    }
+
+    // 3) Replay oldest first, so later records win and tombstones hide what came before
+    while (1)
+    {
+        dwNext = KVSTORE_SECTOR_NONE;
+        for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+        {
+            kvstore_sector_t *psSector = &gsKvstore.asSectors[dwSector];
+
+            if (psSector->nState == KVSTORE_STATE_ACTIVE && (fFirst || psSector->dwSequence > dwPrevious) &&
+                (dwNext == KVSTORE_SECTOR_NONE || psSector->dwSequence < gsKvstore.asSectors[dwNext].dwSequence))
+            {
+                dwNext = dwSector;
+            }
+        }
+        if (dwNext == KVSTORE_SECTOR_NONE)
+        {
+            break;
+        }
+
+        nRet = KVSTORE_Scan(dwNext);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            return nRet;
+        }
+        dwPrevious           = gsKvstore.asSectors[dwNext].dwSequence;
+        gsKvstore.dwHead     = dwNext;
+        gsKvstore.dwSequence = dwPrevious + 1;
+        fFirst               = false;
+    }
+
+    DLOG_INFO("kvstore: %u keys, %u bytes live, %u free sectors, %u torn records", gsKvstore.sStats.dwKeys,
+              gsKvstore.sStats.dwLive, gsKvstore.dwFree, gsKvstore.sStats.dwTorn);
+
+    // 4) The task erases whatever mount left dirty as soon as the scheduler starts
+    gsKvstore.xTask = RTOS_TASK_CREATE(kvstore, KVSTORE_Task, NULL, KVSTORE_GC_PRIORITY);
+
+    gsKvstore.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t KVSTORE_Set(const char *szKey, const void *pvValue, uint16_t wLength)
+{
+    uint32_t dwKeyLength = KVSTORE_KeyLength(szKey);
+    uint32_t dwHeader    = KVSTORE_HEADER_WORD(dwKeyLength, 0U, (uint32_t)wLength);
+    uint32_t dwSize      = KVSTORE_RECORD_SIZE(dwKeyLength, wLength);
+    uint32_t dwCrc       = 0;
+    uint32_t dwSlot      = 0;
+    uint32_t dwAddress   = 0;
+    uint32_t dwLive      = 0;
+    bool fWake           = false;
+    nhns_status_t nRet   = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (dwKeyLength == 0 || (pvValue == NULL && wLength != 0) || wLength > KVSTORE_VALUE_MAX)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsKvstore.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    nRet = KVSTORE_Crc(dwHeader, szKey, dwKeyLength, pvValue, wLength, &dwCrc);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+
+    // 3) An unchanged value costs no flash
+    dwSlot    = KVSTORE_Find((const uint8_t *)szKey, dwKeyLength, KVSTORE_Hash((const uint8_t *)szKey, dwKeyLength));
+    dwAddress = gsKvstore.asIndex[dwSlot].dwAddress;
+    dwLive    = gsKvstore.sStats.dwLive + dwSize;
+    if (dwAddress != 0)
+    {
+        dwLive -= KVSTORE_RECORD_SIZE(dwKeyLength, KVSTORE_VALUE_LENGTH(KVSTORE_Read(dwAddress)));
+        if (KVSTORE_Read(dwAddress) == dwHeader && KVSTORE_Read(dwAddress + sizeof(dwHeader)) == dwCrc &&
+            (wLength == 0 ||
+             memcmp((const void *)(uintptr_t)(dwAddress + KVSTORE_RECORD_HEADER + KVSTORE_ALIGN(dwKeyLength)), pvValue,
+                    wLength) == 0))
+        {
+            xSemaphoreGive(gsKvstore.xLock);
+            return NHNS_STATUS_OK;
+        }
+    }
+
+    // 4) Admission, so compaction always finds room for what is live
+    if ((dwAddress == 0 && gsKvstore.sStats.dwKeys >= KVSTORE_MAX_KEYS) || dwLive > KVSTORE_CAPACITY)
+    {
+        gsKvstore.sStats.dwRefused++;
+        nRet = NHNS_STATUS_NO_MEMORY;
+    }
+    else
+    {
+        nRet = KVSTORE_Write(dwHeader, (const uint8_t *)szKey, pvValue, dwCrc);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        gsKvstore.sStats.dwSets++;
+    }
+    fWake = KVSTORE_NeedsCompaction();
+
+    xSemaphoreGive(gsKvstore.xLock);
+
+    if (fWake)
+    {
+        xTaskNotifyGive(gsKvstore.xTask);
+    }
+
+    return nRet;
+}
+
+nhns_status_t KVSTORE_Get(const char *szKey, void *pvValue, uint16_t wSize, uint16_t *pwLength)
+{
+    uint32_t dwKeyLength = KVSTORE_KeyLength(szKey);
+    uint32_t dwAddress   = 0;
+    uint32_t dwLength    = 0;
+    nhns_status_t nRet   = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (dwKeyLength == 0 || (pvValue == NULL && wSize != 0) || pwLength == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsKvstore.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Compaction may move the record, the lock keeps it in place while it is copied
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    dwAddress = gsKvstore.asIndex[KVSTORE_Find((const uint8_t *)szKey, dwKeyLength,
+                                               KVSTORE_Hash((const uint8_t *)szKey, dwKeyLength))]
+                    .dwAddress;
+    if (dwAddress == 0)
+    {
+        nRet = NHNS_STATUS_NOT_FOUND;
+    }
+    else
+    {
+        dwLength  = KVSTORE_VALUE_LENGTH(KVSTORE_Read(dwAddress));
+        *pwLength = (uint16_t)dwLength;
+        if (dwLength > wSize)
+        {
+            nRet = NHNS_STATUS_NO_MEMORY;
+        }
+        else if (dwLength != 0)
+        {
+            memcpy(pvValue, (const void *)(uintptr_t)(dwAddress + KVSTORE_RECORD_HEADER + KVSTORE_ALIGN(dwKeyLength)),
+                   dwLength);
+        }
+    }
+    xSemaphoreGive(gsKvstore.xLock);
+
+    return nRet;
+}
+
+nhns_status_t KVSTORE_Delete(const char *szKey)
+{
+    uint32_t dwKeyLength = KVSTORE_KeyLength(szKey);
+    uint32_t dwHeader    = KVSTORE_HEADER_WORD(dwKeyLength, KVSTORE_FLAG_TOMBSTONE, 0U);
+    uint32_t dwCrc       = 0;
+    bool fWake           = false;
+    nhns_status_t nRet   = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (dwKeyLength == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsKvstore.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    nRet = KVSTORE_Crc(dwHeader, szKey, dwKeyLength, NULL, 0, &dwCrc);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    // 3) The tombstone hides the older records until compaction drops them all
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    if (gsKvstore.asIndex[KVSTORE_Find((const uint8_t *)szKey, dwKeyLength,
+                                       KVSTORE_Hash((const uint8_t *)szKey, dwKeyLength))]
+            .dwAddress == 0)
+    {
+        nRet = NHNS_STATUS_NOT_FOUND;
+    }
+    else
+    {
+        nRet = KVSTORE_Write(dwHeader, (const uint8_t *)szKey, NULL, dwCrc);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        gsKvstore.sStats.dwDeletes++;
+    }
+    fWake = KVSTORE_NeedsCompaction();
+    xSemaphoreGive(gsKvstore.xLock);
+
+    if (fWake)
+    {
+        xTaskNotifyGive(gsKvstore.xTask);
+    }
+
+    return nRet;
+}
+
+nhns_status_t KVSTORE_GetStats(kvstore_stats_t *psStats)
+{
+    const kvstore_sector_t *psSector = NULL;
+
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (!gsKvstore.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    *psStats               = gsKvstore.sStats;
+    psStats->dwUsed        = 0;
+    psStats->dwCapacity    = KVSTORE_CAPACITY;
+    psStats->dwFreeSectors = gsKvstore.dwFree;
+    psStats->dwMinWear     = 0xFFFFFFFFU;
+    psStats->dwMaxWear     = 0;
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT; dwSector++)
+    {
+        psSector = &gsKvstore.asSectors[dwSector];
+        if (psSector->nState == KVSTORE_STATE_ACTIVE)
+        {
+            psStats->dwUsed += psSector->dwUsed - KVSTORE_HEADER_SIZE;
+        }
+        if (psSector->dwErases < psStats->dwMinWear)
+        {
+            psStats->dwMinWear = psSector->dwErases;
+        }
+        if (psSector->dwErases > psStats->dwMaxWear)
+        {
+            psStats->dwMaxWear = psSector->dwErases;
+        }
+    }
+    xSemaphoreGive(gsKvstore.xLock);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t KVSTORE_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    kvstore_stats_t sStats;
+    kvstore_sector_t asSectors[KVSTORE_SECTOR_COUNT];
+    char szLine[KVSTORE_LINE_SIZE];
+    int nLength = 0;
+
+    nRet = KVSTORE_GetStats(&sStats);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+    xSemaphoreTake(gsKvstore.xLock, portMAX_DELAY);
+    memcpy(asSectors, gsKvstore.asSectors, sizeof(asSectors));
+    xSemaphoreGive(gsKvstore.xLock);
+
+    // 1) Contents
+    nLength = snprintf(szLine, sizeof(szLine), "kvstore: %lu keys, %lu of %lu bytes live, %lu used, %lu free sectors\r\n",
+                       (unsigned long)sStats.dwKeys, (unsigned long)sStats.dwLive, (unsigned long)sStats.dwCapacity,
+                       (unsigned long)sStats.dwUsed, (unsigned long)sStats.dwFreeSectors);
+    nRet    = UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+
+    // 2) Counters
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "%lu sets, %lu deletes, %lu refused, %lu torn at mount\r\n",
+                           (unsigned long)sStats.dwSets, (unsigned long)sStats.dwDeletes,
+                           (unsigned long)sStats.dwRefused, (unsigned long)sStats.dwTorn);
+        nRet    = UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "%lu compactions, %lu records moved, %lu erases, wear %lu to %lu\r\n",
+                           (unsigned long)sStats.dwCompactions, (unsigned long)sStats.dwMoved,
+                           (unsigned long)sStats.dwErases, (unsigned long)sStats.dwMinWear,
+                           (unsigned long)sStats.dwMaxWear);
+        nRet    = UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+    }
+
+    // 3) Sectors
+    for (uint32_t dwSector = 0; dwSector < KVSTORE_SECTOR_COUNT && nRet == NHNS_STATUS_OK; dwSector++)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "  sector %lu: %-7s seq %08lx, %lu erases, %lu used, %lu live\r\n",
+                           (unsigned long)(KVSTORE_FIRST_SECTOR + dwSector), gaszKvstoreStates[asSectors[dwSector].nState],
+                           (unsigned long)asSectors[dwSector].dwSequence, (unsigned long)asSectors[dwSector].dwErases,
+                           (unsigned long)asSectors[dwSector].dwUsed, (unsigned long)asSectors[dwSector].dwLive);
+        nRet    = UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t KVSTORE_Benchmark(uart_instance_t nID)
+{
+    char szKey[KVSTORE_KEY_MAX + 1];
+    uint32_t adwValue[KVSTORE_BENCH_VALUE / sizeof(uint32_t)];
+    kvstore_stats_t sBefore;
+    kvstore_stats_t sAfter;
+    uint64_t qwStart   = 0;
+    uint32_t dwSetUs   = 0;
+    uint32_t dwGetUs   = 0;
+    uint32_t dwWaits   = 0;
+    uint32_t dwBad     = 0;
+    uint32_t dwSets    = 0;
+    uint16_t wLength   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    char szLine[KVSTORE_LINE_SIZE];
+    int nLength = 0;
+
+    nRet = KVSTORE_GetStats(&sBefore);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    // 1) Sets, a tick at a time while compaction catches up
+    qwStart = CLOCK_GetMicros();
+    for (dwSets = 0; dwSets < KVSTORE_BENCH_SETS && nRet == NHNS_STATUS_OK; dwSets++)
+    {
+        snprintf(szKey, sizeof(szKey), "bench/%02lu", (unsigned long)(dwSets % KVSTORE_BENCH_KEYS));
+        for (uint32_t dwWord = 0; dwWord < RTOS_LENGTH(adwValue); dwWord++)
+        {
+            adwValue[dwWord] = dwSets;
+        }
+        for (uint32_t dwTick = 0; (nRet = KVSTORE_Set(szKey, adwValue, sizeof(adwValue))) == NHNS_STATUS_BUSY &&
+                                  dwTick < pdMS_TO_TICKS(KVSTORE_BENCH_WAIT_MS);
+             dwTick++)
+        {
+            dwWaits++;
+            vTaskDelay(1);
+        }
+    }
+    dwSetUs = (uint32_t)(CLOCK_GetMicros() - qwStart);
+
+    // 2) Gets, each key holds the last value written to it
+    qwStart = CLOCK_GetMicros();
+    for (uint32_t dwGet = 0; dwGet < KVSTORE_BENCH_SETS && nRet == NHNS_STATUS_OK; dwGet++)
+    {
+        snprintf(szKey, sizeof(szKey), "bench/%02lu", (unsigned long)(dwGet % KVSTORE_BENCH_KEYS));
+        if (KVSTORE_Get(szKey, adwValue, sizeof(adwValue), &wLength) != NHNS_STATUS_OK || wLength != sizeof(adwValue) ||
+            adwValue[0] != KVSTORE_BENCH_SETS - KVSTORE_BENCH_KEYS + dwGet % KVSTORE_BENCH_KEYS)
+        {
+            dwBad++;
+        }
+    }
+    dwGetUs = (uint32_t)(CLOCK_GetMicros() - qwStart);
+
+    // 3) Leave the store as it was
+    for (uint32_t dwKey = 0; dwKey < KVSTORE_BENCH_KEYS; dwKey++)
+    {
+        snprintf(szKey, sizeof(szKey), "bench/%02lu", (unsigned long)dwKey);
+        for (uint32_t dwTick = 0;
+             KVSTORE_Delete(szKey) == NHNS_STATUS_BUSY && dwTick < pdMS_TO_TICKS(KVSTORE_BENCH_WAIT_MS); dwTick++)
+        {
+            vTaskDelay(1);
+        }
+    }
+    KVSTORE_GetStats(&sAfter);
+
+    // 4) Report
+    if (nRet != NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "kvstore: set %lu failed (%d)\r\n", (unsigned long)(dwSets - 1),
+                           (int)nRet);
+        UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+        return nRet;
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine), "kvstore: %lu sets in %lu us, %lu us each, %lu ticks waiting for room\r\n",
+                       (unsigned long)dwSets, (unsigned long)dwSetUs, (unsigned long)(dwSetUs / dwSets),
+                       (unsigned long)dwWaits);
+    UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+
+    nLength = snprintf(szLine, sizeof(szLine), "%lu gets in %lu us, %lu ns each, %lu wrong\r\n",
+                       (unsigned long)KVSTORE_BENCH_SETS, (unsigned long)dwGetUs,
+                       (unsigned long)(((uint64_t)dwGetUs * 1000) / KVSTORE_BENCH_SETS), (unsigned long)dwBad);
+    UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+
+    nLength = snprintf(szLine, sizeof(szLine), "%lu compactions, %lu records moved, %lu erases\r\n",
+                       (unsigned long)(sAfter.dwCompactions - sBefore.dwCompactions),
+                       (unsigned long)(sAfter.dwMoved - sBefore.dwMoved),
+                       (unsigned long)(sAfter.dwErases - sBefore.dwErases));
+    UART_PrintLine(nID, szLine, nLength, KVSTORE_LINE_SIZE);
+
+    return (dwBad == 0) ? NHNS_STATUS_OK : NHNS_STATUS_DATA_MISMATCH;
+}
@@ -0,0 +1,120 @@
+#ifndef __KVSTORE_H__
+#define __KVSTORE_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Append-only key-value store in the KVSTORE sectors of the internal flash.
+ * Every set or delete appends a record to the newest sector; a RAM hash index
+ * maps each key to its latest record, and values are read straight from the
+ * memory-mapped flash.
+ *
+ * A sector starts with a 16-byte header
+ *   u32 magic, u32 erase count, u32 inverted erase count, u32 sequence
+ * written right after the erase with the sequence left blank, which is
+ * programmed when the sector takes its first record. Records follow:
+ *   u32 key length (bits 0-7) | flags (bits 8-15) | value length (bits 16-31)
+ *   u32 CRC-32/MPEG-2 of the first word, the key and the value
+ *   key, then value, each padded to a word with 0xFF
+ * The first word is programmed first and the CRC last, so a record cut short
+ * by a power loss is skipped by its length and ignored by its CRC.
+ *
+ * A low-priority task copies the live records of the oldest sector to the
+ * newest and erases it, always keeping one sector erased for the next copy.
+ * Writers never wait for an erase: when no room is left until the task
+ * catches up they get NHNS_STATUS_BUSY. Erased sectors are taken lowest
+ * erase count first.
+ */
+
+#define KVSTORE_KEY_MAX     32      // Bytes, without the terminator
+#define KVSTORE_VALUE_MAX   1024
+#define KVSTORE_MAX_KEYS    192
+
+// --- Types ---
+
+typedef struct kvstore_stats
+{
+    uint32_t dwKeys;
+    uint32_t dwLive;           // Bytes of the records the index points to
+    uint32_t dwUsed;           // Bytes appended to the sectors in use, stale records included
+    uint32_t dwCapacity;       // Most live bytes the store admits
+    uint32_t dwFreeSectors;    // Erased sectors ready for records
+    uint32_t dwSets;
+    uint32_t dwDeletes;
+    uint32_t dwRefused;        // Writes turned away for lack of room, NHNS_STATUS_BUSY or NHNS_STATUS_NO_MEMORY
+    uint32_t dwCompactions;    // Sectors copied out and erased
+    uint32_t dwMoved;          // Records copied by compaction
+    uint32_t dwErases;         // Sector erases since KVSTORE_Init
+    uint32_t dwTorn;           // Records with a bad CRC found at mount
+    uint32_t dwMinWear;        // Lowest and highest erase count of the sectors
+    uint32_t dwMaxWear;
+} kvstore_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Rebuild the index from the flash and create the compaction task
+ * @retval Status code indicating operation success or reason for failure
+ * @note Scans every sector, call it before the scheduler starts and after CRC_Init
+ */
+nhns_status_t KVSTORE_Init(void);
+
+/**
+ * @brief Store a value under a key, replacing the previous one
+ * @param szKey - Key, 1 to KVSTORE_KEY_MAX characters
+ * @param pvValue - Value bytes
+ * @param wLength - Value length, at most KVSTORE_VALUE_MAX
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_BUSY until compaction frees a sector, retry later.
+ *       NHNS_STATUS_NO_MEMORY when the store is full. An unchanged value is not written again
+ */
+nhns_status_t KVSTORE_Set(const char *szKey, const void *pvValue, uint16_t wLength);
+
+/**
+ * @brief Copy out the value of a key
+ * @param szKey - Key
+ * @param pvValue - Buffer to store the value
+ * @param wSize - Size of pvValue
+ * @param pwLength - Returns the value length
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_NOT_FOUND for a missing key, NHNS_STATUS_NO_MEMORY with the
+ *       length set when pvValue is too small
+ */
+nhns_status_t KVSTORE_Get(const char *szKey, void *pvValue, uint16_t wSize, uint16_t *pwLength);
+
+/**
+ * @brief Remove a key
+ * @param szKey - Key
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_NOT_FOUND for a missing key, NHNS_STATUS_BUSY as for KVSTORE_Set
+ */
+nhns_status_t KVSTORE_Delete(const char *szKey);
+
+/**
+ * @brief Get the store counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t KVSTORE_GetStats(kvstore_stats_t *psStats);
+
+/**
+ * @brief Print the counters and the state of each sector
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t KVSTORE_Dump(uart_instance_t nID);
+
+/**
+ * @brief Time sets and gets of 16 keys with 32-byte values and print the cost of each
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note Writes enough to go through every sector, so it costs the flash a few erases.
+ *       The benchmark keys are deleted at the end
+ */
+nhns_status_t KVSTORE_Benchmark(uart_instance_t nID);
+
+#endif    // __KVSTORE_H__
@@ -0,0 +1,803 @@
+#include <stdio.h>
+#include <string.h>
+#include "net.h"
+#include "dlog.h"
+#include "emac.h"
+#include "pool.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define NET_LINE_SIZE        128
+
+#define NET_TASK_STACK_SIZE  (configMINIMAL_STACK_SIZE * 2)
+#define NET_TASK_PRIORITY    (tskIDLE_PRIORITY + 2)
+#define NET_LINK_RETRY_MS    5000
+
+#define NET_ETH_HEADER       14
+#define NET_IP_HEADER        20
+#define NET_UDP_HEADER       8
+#define NET_ICMP_HEADER      8
+#define NET_ARP_PACKET       28
+
+#define NET_ETHERTYPE_IP     0x0800
+#define NET_ETHERTYPE_ARP    0x0806
+#define NET_IP_PROTO_ICMP    1
+#define NET_IP_PROTO_UDP     17
+#define NET_IP_TTL           64
+#define NET_IP_FLAG_DF       0x4000
+#define NET_IP_FRAGMENT_MASK 0x3FFF
+#define NET_IP_BROADCAST     0xFFFFFFFFUL
+#define NET_ARP_REQUEST      1
+#define NET_ARP_REPLY        2
+#define NET_ICMP_ECHO        8
+#define NET_ICMP_ECHO_REPLY  0
+
+// Frames start 2 bytes into their block, so the IP header and the payload behind it are word aligned
+#define NET_FRAME_OFFSET     2
+#define NET_PAYLOAD_OFFSET   (NET_FRAME_OFFSET + NET_ETH_HEADER + NET_IP_HEADER + NET_UDP_HEADER)
+
+_Static_assert(NET_PAYLOAD_OFFSET + NET_UDP_MAX_PAYLOAD <= 1536, "EMAC_POOL blocks must hold a full datagram");
+
+#define NET_ARP_ENTRY(dwIp, b0, b1, b2, b3, b4, b5) {(dwIp), {(b0), (b1), (b2), (b3), (b4), (b5)}},
+
+// --- Types ---
+
+typedef struct net_arp_entry
+{
+    uint32_t dwIp;
+    uint8_t abMac[6];
+} net_arp_entry_t;
+
+typedef struct net_binding
+{
+    uint16_t wPort;
+    net_udp_handler_t pfnHandler;
+} net_binding_t;
+
+typedef struct net_context
+{
+    bool fInitDone;
+    volatile bool fUp;
+    uint16_t wIpId;
+
+    net_arp_entry_t asArp[NET_ARP_TABLE_SIZE];
+    uint32_t dwArpCount;
+
+    net_binding_t asBindings[NET_UDP_BINDINGS];
+
+    net_stats_t sStats;
+} net_context_t;
+
+// --- Global Variables ---
+
+static net_context_t gsNet = {0};
+
+static const net_arp_entry_t gasArpStatic[] = {NET_ARP_STATIC(NET_ARP_ENTRY)};
+
+static const uint8_t gabBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+RTOS_TASK_DEFINE(net, NET_TASK_STACK_SIZE);
+
+// --- Static Functions ---
+
+/**
+ * @brief Append big-endian fields to a header
+ * @param pbOut - Write position
+ * @param Value - Value to append
+ * @retval Write position after the field
+ */
+static uint8_t *NET_Put16(uint8_t *pbOut, uint16_t wValue)
+{
+    pbOut[0] = (uint8_t)(wValue >> 8);
+    pbOut[1] = (uint8_t)wValue;
+
+    return pbOut + 2;
+}
+
+static uint8_t *NET_Put32(uint8_t *pbOut, uint32_t dwValue)
+{
+    return NET_Put16(NET_Put16(pbOut, (uint16_t)(dwValue >> 16)), (uint16_t)dwValue);
+}
+
+/**
+ * @brief Read big-endian fields, received headers are not aligned
+ * @param pbIn - Field position
+ * @retval Field value
+ */
+static uint16_t NET_Get16(const uint8_t *pbIn)
+{
+    return (uint16_t)((pbIn[0] << 8) | pbIn[1]);
+}
+
+static uint32_t NET_Get32(const uint8_t *pbIn)
+{
+    return ((uint32_t)NET_Get16(pbIn) << 16) | NET_Get16(pbIn + 2);
+}
+
+/**
+ * @brief Add bytes to a one's complement sum of big-endian words
+ * @param pbData - Bytes to add
+ * @param dwLength - Number of bytes
+ * @param dwSum - Sum so far
+ * @param fOdd - The first byte is the low half of a word, i.e. an odd number of bytes precedes it
+ * @retval New sum, not folded. A datagram's worth of bytes cannot overflow it
+ */
+static uint32_t NET_Sum(const uint8_t *pbData, uint32_t dwLength, uint32_t dwSum, bool fOdd)
+{
+    uint32_t dwIndex = 0;
+
+    // 1) Finish the word a previous write started
+    if (fOdd && dwLength != 0)
+    {
+        dwSum  += pbData[0];
+        dwIndex = 1;
+    }
+
+    // 2) Whole words
+    for (; dwIndex + 1 < dwLength; dwIndex += 2)
+    {
+        dwSum += ((uint32_t)pbData[dwIndex] << 8) | pbData[dwIndex + 1];
+    }
+
+    // 3) A trailing byte is the high half of the next word
+    if (dwIndex < dwLength)
+    {
+        dwSum += (uint32_t)pbData[dwIndex] << 8;
+    }
+
+    return dwSum;
+}
+
+/**
+ * @brief NET_Sum fused with the copy, so every byte is read once
+ * @param pbDst - Destination
+ * @param pbSrc - Bytes to copy and add
+ * @param dwLength - Number of bytes
+ * @param dwSum - Sum so far
+ * @param fOdd - The first byte is the low half of a word
+ * @retval New sum, not folded
+ */
+static uint32_t NET_CopySum(uint8_t *pbDst, const uint8_t *pbSrc, uint32_t dwLength, uint32_t dwSum, bool fOdd)
+{
+    uint32_t dwIndex = 0;
+    uint8_t bHigh    = 0;
+    uint8_t bLow     = 0;
+
+    if (fOdd && dwLength != 0)
+    {
+        pbDst[0] = pbSrc[0];
+        dwSum   += pbSrc[0];
+        dwIndex  = 1;
+    }
+
+    for (; dwIndex + 1 < dwLength; dwIndex += 2)
+    {
+        bHigh              = pbSrc[dwIndex];
+        bLow               = pbSrc[dwIndex + 1];
+        pbDst[dwIndex]     = bHigh;
+        pbDst[dwIndex + 1] = bLow;
+        dwSum             += ((uint32_t)bHigh << 8) | bLow;
+    }
+
+    if (dwIndex < dwLength)
+    {
+        pbDst[dwIndex] = pbSrc[dwIndex];
+        dwSum         += (uint32_t)pbSrc[dwIndex] << 8;
+    }
+
+    return dwSum;
+}
+
+/**
+ * @brief Turn a sum into an Internet checksum
+ * @param dwSum - One's complement sum, not folded
+ * @retval Complement of the folded sum
+ */
+static uint16_t NET_Fold(uint32_t dwSum)
+{
+    while ((dwSum >> 16) != 0)
+    {
+        dwSum = (dwSum & 0xFFFF) + (dwSum >> 16);
+    }
+
+    return (uint16_t)~dwSum;
+}
+
+/**
+ * @brief Checksum of a header or packet starting on a word boundary
+ * @param pbData - Start of the data
+ * @param dwLength - Number of bytes
+ * @retval Internet checksum, 0 when verifying data that includes a correct checksum
+ */
+static uint16_t NET_Checksum(const uint8_t *pbData, uint32_t dwLength)
+{
+    return NET_Fold(NET_Sum(pbData, dwLength, 0, false));
+}
+
+/**
+ * @brief Find the MAC address of a neighbour
+ * @param dwIp - IPv4 address
+ * @param pbMac - Returns six bytes of MAC address
+ * @retval true if the address is known
+ */
+static bool NET_ArpLookup(uint32_t dwIp, uint8_t *pbMac)
+{
+    bool fFound = false;
+
+    if (dwIp == NET_IP_BROADCAST)
+    {
+        memcpy(pbMac, gabBroadcastMac, sizeof(gabBroadcastMac));
+        return true;
+    }
+
+    taskENTER_CRITICAL();
+    for (uint32_t dwEntry = 0; dwEntry < gsNet.dwArpCount && !fFound; dwEntry++)
+    {
+        if (gsNet.asArp[dwEntry].dwIp == dwIp)
+        {
+            memcpy(pbMac, gsNet.asArp[dwEntry].abMac, sizeof(gsNet.asArp[dwEntry].abMac));
+            fFound = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return fFound;
+}
+
+/**
+ * @brief Write an Ethernet and an IPv4 header
+ * @param pbFrame - Start of the frame
+ * @param pbDstMac - Destination MAC address
+ * @param dwDstIp - Destination address
+ * @param bProtocol - IP protocol of the payload
+ * @param wIpLength - IP header and payload length
+ * @retval Start of the IP payload
+ */
+static uint8_t *NET_PutIpHeader(uint8_t *pbFrame, const uint8_t *pbDstMac, uint32_t dwDstIp, uint8_t bProtocol, uint16_t wIpLength)
+{
+    uint8_t *pbIp  = pbFrame + NET_ETH_HEADER;
+    uint8_t *pbOut = pbIp;
+
+    // 1) Ethernet
+    memcpy(pbFrame, pbDstMac, 6);
+    memcpy(pbFrame + 6, EMAC_GetMacAddress(), 6);
+    NET_Put16(pbFrame + 12, NET_ETHERTYPE_IP);
+
+    // 2) IPv4 without options, never fragmented
+    *pbOut++ = 0x45;
+    *pbOut++ = 0;
+    pbOut    = NET_Put16(pbOut, wIpLength);
+    pbOut    = NET_Put16(pbOut, __atomic_fetch_add(&gsNet.wIpId, 1, __ATOMIC_RELAXED));
+    pbOut    = NET_Put16(pbOut, NET_IP_FLAG_DF);
+    *pbOut++ = NET_IP_TTL;
+    *pbOut++ = bProtocol;
+    pbOut    = NET_Put16(pbOut, 0);
+    pbOut    = NET_Put32(pbOut, NET_IP_ADDRESS);
+    pbOut    = NET_Put32(pbOut, dwDstIp);
+    NET_Put16(pbIp + 10, NET_Checksum(pbIp, NET_IP_HEADER));
+
+    return pbOut;
+}
+
+/**
+ * @brief Hand a frame built at NET_FRAME_OFFSET to the MAC
+ * @param pbBlock - EMAC_POOL block, owned by the driver on success
+ * @param wLength - Frame length
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t NET_Transmit(uint8_t *pbBlock, uint16_t wLength)
+{
+    emac_segment_t sSegment = {pbBlock, NET_FRAME_OFFSET, wLength};
+
+    return EMAC_Transmit(&sSegment, 1);
+}
+
+/**
+ * @brief Answer an ARP request for the board's address
+ * @param pbArp - ARP packet
+ */
+static void NET_InputArp(const uint8_t *pbArp)
+{
+    uint8_t *pbBlock = NULL;
+    uint8_t *pbFrame = NULL;
+    uint8_t *pbOut   = NULL;
+
+    // 1) Only Ethernet/IPv4 requests for us
+    if (NET_Get16(pbArp) != 1 || NET_Get16(pbArp + 2) != NET_ETHERTYPE_IP || pbArp[4] != 6 || pbArp[5] != 4 ||
+        NET_Get16(pbArp + 6) != NET_ARP_REQUEST || NET_Get32(pbArp + 24) != NET_IP_ADDRESS)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    pbBlock = POOL_AllocFrom(EMAC_POOL);
+    if (pbBlock == NULL)
+    {
+        return;
+    }
+
+    // 2) Reply to the sender, the request is not used to learn its address
+    pbFrame = pbBlock + NET_FRAME_OFFSET;
+    memcpy(pbFrame, pbArp + 8, 6);
+    memcpy(pbFrame + 6, EMAC_GetMacAddress(), 6);
+    NET_Put16(pbFrame + 12, NET_ETHERTYPE_ARP);
+
+    pbOut = NET_Put16(pbFrame + NET_ETH_HEADER, 1);
+    pbOut = NET_Put16(pbOut, NET_ETHERTYPE_IP);
+    *pbOut++ = 6;
+    *pbOut++ = 4;
+    pbOut = NET_Put16(pbOut, NET_ARP_REPLY);
+    memcpy(pbOut, EMAC_GetMacAddress(), 6);
+    pbOut = NET_Put32(pbOut + 6, NET_IP_ADDRESS);
+    memcpy(pbOut, pbArp + 8, 10);
+
+    if (NET_Transmit(pbBlock, NET_ETH_HEADER + NET_ARP_PACKET) != NHNS_STATUS_OK)
+    {
+        POOL_Free(pbBlock);
+        return;
+    }
+    gsNet.sStats.dwArpReplies++;
+}
+
+/**
+ * @brief Answer an ICMP echo request with the same data
+ * @param pbFrame - Received frame
+ * @param pbIp - Its IP header
+ * @param wIpLength - IP header and payload length
+ * @param wHeaderLength - IP header length
+ */
+static void NET_InputIcmp(const uint8_t *pbFrame, const uint8_t *pbIp, uint16_t wIpLength, uint16_t wHeaderLength)
+{
+    const uint8_t *pbIcmp = pbIp + wHeaderLength;
+    uint16_t wIcmpLength  = wIpLength - wHeaderLength;
+    uint8_t *pbBlock      = NULL;
+    uint8_t *pbReply      = NULL;
+
+    // 1) Only well-formed echo requests
+    if (wIcmpLength < NET_ICMP_HEADER || pbIcmp[0] != NET_ICMP_ECHO || NET_Checksum(pbIcmp, wIcmpLength) != 0)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    pbBlock = POOL_AllocFrom(EMAC_POOL);
+    if (pbBlock == NULL)
+    {
+        return;
+    }
+
+    // 2) Same identifier, sequence and data back to the sender, options are not echoed
+    pbReply = NET_PutIpHeader(pbBlock + NET_FRAME_OFFSET, pbFrame + 6, NET_Get32(pbIp + 12), NET_IP_PROTO_ICMP,
+                              NET_IP_HEADER + wIcmpLength);
+    memcpy(pbReply, pbIcmp, wIcmpLength);
+    pbReply[0] = NET_ICMP_ECHO_REPLY;
+    NET_Put16(pbReply + 2, 0);
+    NET_Put16(pbReply + 2, NET_Checksum(pbReply, wIcmpLength));
+
+    if (NET_Transmit(pbBlock, NET_ETH_HEADER + NET_IP_HEADER + wIcmpLength) != NHNS_STATUS_OK)
+    {
+        POOL_Free(pbBlock);
+        return;
+    }
+    gsNet.sStats.dwIcmpReplies++;
+}
+
+/**
+ * @brief Pass a UDP datagram to the handler bound to its port
+ * @param pbIp - IP header
+ * @param wIpLength - IP header and payload length
+ * @param wHeaderLength - IP header length
+ */
+static void NET_InputUdp(const uint8_t *pbIp, uint16_t wIpLength, uint16_t wHeaderLength)
+{
+    const uint8_t *pbUdp         = pbIp + wHeaderLength;
+    uint16_t wUdpLength          = 0;
+    uint32_t dwSum               = 0;
+    net_udp_handler_t pfnHandler = NULL;
+
+    // 1) Length must match what the IP header carries
+    if (wIpLength - wHeaderLength < NET_UDP_HEADER)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+    wUdpLength = NET_Get16(pbUdp + 4);
+    if (wUdpLength < NET_UDP_HEADER || wUdpLength > wIpLength - wHeaderLength)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    // 2) A zero checksum means the sender did not compute one
+    if (NET_Get16(pbUdp + 6) != 0)
+    {
+        dwSum = NET_Sum(pbIp + 12, 8, NET_IP_PROTO_UDP + wUdpLength, false);
+        dwSum = NET_Sum(pbUdp, wUdpLength, dwSum, false);
+        if (NET_Fold(dwSum) != 0)
+        {
+            gsNet.sStats.dwRxDropped++;
+            return;
+        }
+    }
+
+    // 3) Find the handler
+    for (uint32_t dwBinding = 0; dwBinding < NET_UDP_BINDINGS && pfnHandler == NULL; dwBinding++)
+    {
+        if (gsNet.asBindings[dwBinding].wPort == NET_Get16(pbUdp + 2))
+        {
+            pfnHandler = gsNet.asBindings[dwBinding].pfnHandler;
+        }
+    }
+    if (pfnHandler == NULL)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    gsNet.sStats.dwUdpRx++;
+    pfnHandler(pbUdp + NET_UDP_HEADER, wUdpLength - NET_UDP_HEADER, NET_Get32(pbIp + 12), NET_Get16(pbUdp));
+}
+
+/**
+ * @brief Dispatch a received frame by protocol
+ * @param psFrame - Frame loaned by the driver
+ */
+static void NET_Input(const emac_frame_t *psFrame)
+{
+    const uint8_t *pbIp    = psFrame->pbData + NET_ETH_HEADER;
+    uint16_t wHeaderLength = 0;
+    uint16_t wIpLength     = 0;
+    uint32_t dwDstIp       = 0;
+
+    gsNet.sStats.dwRxFrames++;
+
+    if (psFrame->wLength < NET_ETH_HEADER)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    // 1) ARP
+    if (NET_Get16(psFrame->pbData + 12) == NET_ETHERTYPE_ARP && psFrame->wLength >= NET_ETH_HEADER + NET_ARP_PACKET)
+    {
+        NET_InputArp(pbIp);
+        return;
+    }
+
+    // 2) Unfragmented IPv4 for us with a valid header
+    if (NET_Get16(psFrame->pbData + 12) != NET_ETHERTYPE_IP || psFrame->wLength < NET_ETH_HEADER + NET_IP_HEADER)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    wHeaderLength = (uint16_t)((pbIp[0] & 0x0F) * 4);
+    wIpLength     = NET_Get16(pbIp + 2);
+    dwDstIp       = NET_Get32(pbIp + 16);
+    if ((pbIp[0] >> 4) != 4 || wHeaderLength < NET_IP_HEADER || wIpLength < wHeaderLength ||
+        wIpLength > psFrame->wLength - NET_ETH_HEADER || (NET_Get16(pbIp + 6) & NET_IP_FRAGMENT_MASK) != 0 ||
+        (dwDstIp != NET_IP_ADDRESS && dwDstIp != NET_IP_BROADCAST) || NET_Checksum(pbIp, wHeaderLength) != 0)
+    {
+        gsNet.sStats.dwRxDropped++;
+        return;
+    }
+
+    // 3) Protocols
+    switch (pbIp[9])
+    {
+        case NET_IP_PROTO_ICMP:
+            NET_InputIcmp(psFrame->pbData, pbIp, wIpLength, wHeaderLength);
+            break;
+        case NET_IP_PROTO_UDP:
+            NET_InputUdp(pbIp, wIpLength, wHeaderLength);
+            break;
+        default:
+            gsNet.sStats.dwRxDropped++;
+            break;
+    }
+}
+
+/**
+ * @brief Bring the link up, then serve every received frame
+ * @param pvParameters - Unused
+ * @note EMAC_Init waits for the PHY, so it runs here rather than before the scheduler
+ */
+static void NET_Task(void *pvParameters)
+{
+    emac_frame_t sFrame = {0};
+    nhns_status_t nRet  = NHNS_STATUS_OK;
+
+    (void)pvParameters;
+
+    // 1) Keep trying until a cable is plugged in
+    while ((nRet = EMAC_Init()) != NHNS_STATUS_OK)
+    {
+        DLOG_WARN("net: no link (%d), retrying", nRet);
+        vTaskDelay(pdMS_TO_TICKS(NET_LINK_RETRY_MS));
+    }
+    gsNet.fUp = true;
+    DLOG_INFO("net: link up, %u.%u.%u.%u", (NET_IP_ADDRESS >> 24) & 0xFF, (NET_IP_ADDRESS >> 16) & 0xFF,
+              (NET_IP_ADDRESS >> 8) & 0xFF, NET_IP_ADDRESS & 0xFF);
+
+    // 2) Replies are built in fresh blocks, so every loaned buffer goes straight back
+    while (1)
+    {
+        if (EMAC_Receive(&sFrame, EMAC_WAIT_FOREVER) == NHNS_STATUS_OK)
+        {
+            NET_Input(&sFrame);
+            EMAC_Release(sFrame.pbData);
+        }
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t NET_Init(void)
+{
+    // 1) Check if module is already initialized
+    if (gsNet.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Static neighbours
+    for (uint32_t dwEntry = 0; dwEntry < RTOS_LENGTH(gasArpStatic); dwEntry++)
+    {
+        NET_ArpSet(gasArpStatic[dwEntry].dwIp, gasArpStatic[dwEntry].abMac);
+    }
+
+    // 3) The task owns the link
+    RTOS_TASK_CREATE(net, NET_Task, NULL, NET_TASK_PRIORITY);
+
+    gsNet.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+bool NET_IsUp(void)
+{
+    return gsNet.fUp;
+}
+
+nhns_status_t NET_ArpSet(uint32_t dwIp, const uint8_t *pbMac)
+{
+    nhns_status_t nRet = NHNS_STATUS_NO_MEMORY;
+    uint32_t dwEntry   = 0;
+
+    if (pbMac == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    taskENTER_CRITICAL();
+    while (dwEntry < gsNet.dwArpCount && gsNet.asArp[dwEntry].dwIp != dwIp)
+    {
+        dwEntry++;
+    }
+    if (dwEntry < NET_ARP_TABLE_SIZE)
+    {
+        gsNet.asArp[dwEntry].dwIp = dwIp;
+        memcpy(gsNet.asArp[dwEntry].abMac, pbMac, sizeof(gsNet.asArp[dwEntry].abMac));
+        if (dwEntry == gsNet.dwArpCount)
+        {
+            gsNet.dwArpCount++;
+        }
+        nRet = NHNS_STATUS_OK;
+    }
+    taskEXIT_CRITICAL();
+
+    return nRet;
+}
+
+nhns_status_t NET_UdpBind(uint16_t wPort, net_udp_handler_t pfnHandler)
+{
+    net_binding_t *psFree = NULL;
+
+    if (wPort == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    taskENTER_CRITICAL();
+    for (uint32_t dwBinding = 0; dwBinding < NET_UDP_BINDINGS; dwBinding++)
+    {
+        if (gsNet.asBindings[dwBinding].wPort == wPort)
+        {
+            psFree = &gsNet.asBindings[dwBinding];
+            break;
+        }
+        if (psFree == NULL && gsNet.asBindings[dwBinding].wPort == 0)
+        {
+            psFree = &gsNet.asBindings[dwBinding];
+        }
+    }
+    if (psFree != NULL)
+    {
+        psFree->wPort      = (pfnHandler != NULL) ? wPort : 0;
+        psFree->pfnHandler = pfnHandler;
+    }
+    taskEXIT_CRITICAL();
+
+    return (psFree != NULL || pfnHandler == NULL) ? NHNS_STATUS_OK : NHNS_STATUS_NO_MEMORY;
+}
+
+nhns_status_t NET_DatagramBegin(net_datagram_t *psDatagram)
+{
+    if (psDatagram == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    psDatagram->pbBlock = POOL_AllocFrom(EMAC_POOL);
+    psDatagram->wLength = 0;
+    psDatagram->dwSum   = 0;
+
+    return (psDatagram->pbBlock != NULL) ? NHNS_STATUS_OK : NHNS_STATUS_NO_MEMORY;
+}
+
+uint8_t *NET_DatagramTail(const net_datagram_t *psDatagram)
+{
+    return psDatagram->pbBlock + NET_PAYLOAD_OFFSET + psDatagram->wLength;
+}
+
+uint16_t NET_DatagramRoom(const net_datagram_t *psDatagram)
+{
+    return NET_UDP_MAX_PAYLOAD - psDatagram->wLength;
+}
+
+nhns_status_t NET_DatagramCommit(net_datagram_t *psDatagram, uint16_t wLength)
+{
+    uint8_t *pbTail = NULL;
+
+    if (psDatagram == NULL || psDatagram->pbBlock == NULL || wLength > NET_DatagramRoom(psDatagram))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    pbTail               = NET_DatagramTail(psDatagram);
+    psDatagram->dwSum    = NET_Sum(pbTail, wLength, psDatagram->dwSum, (psDatagram->wLength & 1) != 0);
+    psDatagram->wLength += wLength;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NET_DatagramWrite(net_datagram_t *psDatagram, const void *pvData, uint16_t wLength)
+{
+    if (psDatagram == NULL || psDatagram->pbBlock == NULL || (pvData == NULL && wLength != 0) ||
+        wLength > NET_DatagramRoom(psDatagram))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    psDatagram->dwSum    = NET_CopySum(NET_DatagramTail(psDatagram), pvData, wLength, psDatagram->dwSum,
+                                       (psDatagram->wLength & 1) != 0);
+    psDatagram->wLength += wLength;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NET_DatagramSend(net_datagram_t *psDatagram, uint32_t dwDstIp, uint16_t wDstPort, uint16_t wSrcPort)
+{
+    uint8_t abDstMac[6];
+    uint8_t *pbUdp      = NULL;
+    uint16_t wUdpLength = 0;
+    uint32_t dwSum      = 0;
+    nhns_status_t nRet  = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (psDatagram == NULL || psDatagram->pbBlock == NULL || wDstPort == 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (!gsNet.fUp)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    if (!NET_ArpLookup(dwDstIp, abDstMac))
+    {
+        __atomic_add_fetch(&gsNet.sStats.dwNoRoute, 1, __ATOMIC_RELAXED);
+        return NHNS_STATUS_NOT_FOUND;
+    }
+
+    // 2) Headers in the room left in front of the payload
+    wUdpLength = NET_UDP_HEADER + psDatagram->wLength;
+    pbUdp      = NET_PutIpHeader(psDatagram->pbBlock + NET_FRAME_OFFSET, abDstMac, dwDstIp, NET_IP_PROTO_UDP,
+                                 NET_IP_HEADER + wUdpLength);
+    NET_Put16(pbUdp, wSrcPort);
+    NET_Put16(pbUdp + 2, wDstPort);
+    NET_Put16(pbUdp + 4, wUdpLength);
+
+    // 3) The payload is already summed, add the pseudo header and the UDP header. 0 means no checksum, send all ones
+    dwSum = psDatagram->dwSum + (NET_IP_ADDRESS >> 16) + (NET_IP_ADDRESS & 0xFFFF) + (dwDstIp >> 16) +
+            (dwDstIp & 0xFFFF) + NET_IP_PROTO_UDP + wUdpLength + wSrcPort + wDstPort + wUdpLength;
+    NET_Put16(pbUdp + 6, (NET_Fold(dwSum) != 0) ? NET_Fold(dwSum) : 0xFFFF);
+
+    // 4) The driver owns the block from here
+    nRet = NET_Transmit(psDatagram->pbBlock, NET_ETH_HEADER + NET_IP_HEADER + wUdpLength);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    __atomic_add_fetch(&gsNet.sStats.dwUdpTx, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&gsNet.sStats.dwUdpTxBytes, psDatagram->wLength, __ATOMIC_RELAXED);
+    psDatagram->pbBlock = NULL;
+
+    return NHNS_STATUS_OK;
+}
+
+void NET_DatagramDiscard(net_datagram_t *psDatagram)
+{
+    if (psDatagram != NULL && psDatagram->pbBlock != NULL)
+    {
+        POOL_Free(psDatagram->pbBlock);
+        psDatagram->pbBlock = NULL;
+    }
+}
+
+nhns_status_t NET_GetStats(net_stats_t *psStats)
+{
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Counters are read one by one, each is exact but they may be from different moments
+    *psStats = gsNet.sStats;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NET_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    net_arp_entry_t sEntry;
+    net_stats_t sStats;
+    const uint8_t *pbMac = EMAC_GetMacAddress();
+    char szLine[NET_LINE_SIZE];
+    int nLength = 0;
+
+    NET_GetStats(&sStats);
+
+    // 1) Own addresses
+    nLength = snprintf(szLine, sizeof(szLine), "net: %s, %u.%u.%u.%u %02x:%02x:%02x:%02x:%02x:%02x\r\n",
+                       gsNet.fUp ? "up" : "down", (unsigned)(NET_IP_ADDRESS >> 24) & 0xFF,
+                       (unsigned)(NET_IP_ADDRESS >> 16) & 0xFF, (unsigned)(NET_IP_ADDRESS >> 8) & 0xFF,
+                       (unsigned)NET_IP_ADDRESS & 0xFF, pbMac[0], pbMac[1], pbMac[2], pbMac[3], pbMac[4], pbMac[5]);
+    nRet    = UART_PrintLine(nID, szLine, nLength, NET_LINE_SIZE);
+
+    // 2) Neighbours, copied out one at a time as NET_ArpSet may run meanwhile
+    for (uint32_t dwEntry = 0; dwEntry < gsNet.dwArpCount && nRet == NHNS_STATUS_OK; dwEntry++)
+    {
+        taskENTER_CRITICAL();
+        sEntry = gsNet.asArp[dwEntry];
+        taskEXIT_CRITICAL();
+
+        nLength = snprintf(szLine, sizeof(szLine), "arp %u.%u.%u.%u %02x:%02x:%02x:%02x:%02x:%02x\r\n",
+                           (unsigned)(sEntry.dwIp >> 24) & 0xFF, (unsigned)(sEntry.dwIp >> 16) & 0xFF,
+                           (unsigned)(sEntry.dwIp >> 8) & 0xFF, (unsigned)sEntry.dwIp & 0xFF, sEntry.abMac[0],
+                           sEntry.abMac[1], sEntry.abMac[2], sEntry.abMac[3], sEntry.abMac[4], sEntry.abMac[5]);
+        nRet    = UART_PrintLine(nID, szLine, nLength, NET_LINE_SIZE);
+    }
+
+    // 3) Counters
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "rx %lu frames, %lu dropped, %lu udp; replied %lu arp %lu icmp\r\n",
+                           (unsigned long)sStats.dwRxFrames, (unsigned long)sStats.dwRxDropped,
+                           (unsigned long)sStats.dwUdpRx, (unsigned long)sStats.dwArpReplies,
+                           (unsigned long)sStats.dwIcmpReplies);
+        nRet    = UART_PrintLine(nID, szLine, nLength, NET_LINE_SIZE);
+    }
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "tx %lu udp, %lu payload bytes, %lu without arp entry\r\n",
+                           (unsigned long)sStats.dwUdpTx, (unsigned long)sStats.dwUdpTxBytes,
+                           (unsigned long)sStats.dwNoRoute);
+        nRet    = UART_PrintLine(nID, szLine, nLength, NET_LINE_SIZE);
+    }
+
+    return nRet;
+}
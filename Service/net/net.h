@@ -0,0 +1,168 @@
+#ifndef __NET_H__
+#define __NET_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Minimal IPv4 stack on Driver/emac: ARP replies, ICMP echo and UDP, without
+ * fragmentation, options or routing. Neighbours are resolved from a static ARP
+ * table, the stack never sends ARP requests.
+ *
+ * Datagrams are built in place in an EMAC_POOL block. The block leaves room for
+ * the Ethernet, IP and UDP headers in front of the payload, so the payload is
+ * written once and the block goes to the MAC as it is. The UDP checksum is
+ * summed while the payload is written, sending only adds the headers to it.
+ */
+
+#define NET_IP4(a, b, c, d)     (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+// Address of the board
+#define NET_IP_ADDRESS          NET_IP4(192, 168, 7, 2)
+
+// Static ARP table as X(IPv4 address, MAC address bytes), NET_ArpSet adds entries at run time
+#define NET_ARP_STATIC(X)       X(NET_IP4(192, 168, 7, 1), 0x02, 0x00, 0x00, 0x00, 0x00, 0x01)
+
+#define NET_ARP_TABLE_SIZE      8
+
+// UDP ports that can be bound to a receive handler at the same time
+#define NET_UDP_BINDINGS        4
+
+// Largest UDP payload that fits a 1500-byte MTU
+#define NET_UDP_MAX_PAYLOAD     1472
+
+// --- Types ---
+
+typedef struct net_datagram
+{
+    uint8_t *pbBlock;    // EMAC_POOL block, NULL when no datagram is open
+    uint16_t wLength;    // Payload bytes written so far
+    uint32_t dwSum;      // One's complement sum of the payload, not folded
+} net_datagram_t;
+
+/**
+ * @brief Handler for datagrams received on a bound port, runs in the net task
+ * @param pbPayload - UDP payload, valid until the handler returns
+ * @param wLength - Payload length
+ * @param dwSrcIp - Sender address
+ * @param wSrcPort - Sender port
+ */
+typedef void (*net_udp_handler_t)(const uint8_t *pbPayload, uint16_t wLength, uint32_t dwSrcIp, uint16_t wSrcPort);
+
+typedef struct net_stats
+{
+    uint32_t dwRxFrames;       // Frames taken from the driver
+    uint32_t dwRxDropped;      // Frames for another host, unknown protocols, unbound ports, bad checksums
+    uint32_t dwArpReplies;
+    uint32_t dwIcmpReplies;
+    uint32_t dwUdpRx;
+    uint32_t dwUdpTx;
+    uint32_t dwUdpTxBytes;     // Payload bytes
+    uint32_t dwNoRoute;        // Datagrams refused for lack of an ARP entry
+} net_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Load the static ARP table and start the net task, which brings the link up and serves received frames
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_Init(void);
+
+/**
+ * @brief Check whether the link is up and datagrams can be sent
+ * @retval true once EMAC_Init succeeded
+ */
+bool NET_IsUp(void);
+
+/**
+ * @brief Add or replace a static ARP entry
+ * @param dwIp - IPv4 address
+ * @param pbMac - Six bytes of MAC address
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_ArpSet(uint32_t dwIp, const uint8_t *pbMac);
+
+/**
+ * @brief Route datagrams sent to a UDP port to a handler
+ * @param wPort - Local port
+ * @param pfnHandler - Handler, NULL removes the binding
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_UdpBind(uint16_t wPort, net_udp_handler_t pfnHandler);
+
+/**
+ * @brief Open a datagram in a fresh EMAC_POOL block, callable from tasks only
+ * @param psDatagram - Datagram to open
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_DatagramBegin(net_datagram_t *psDatagram);
+
+/**
+ * @brief Get where the next payload byte goes, for producers that write in place
+ * @param psDatagram - Open datagram
+ * @retval Write position, NET_DatagramRoom bytes are free from there
+ * @note Bytes written there count once NET_DatagramCommit is called
+ */
+uint8_t *NET_DatagramTail(const net_datagram_t *psDatagram);
+
+/**
+ * @brief Get the number of payload bytes that still fit
+ * @param psDatagram - Open datagram
+ * @retval Free bytes up to NET_UDP_MAX_PAYLOAD
+ */
+uint16_t NET_DatagramRoom(const net_datagram_t *psDatagram);
+
+/**
+ * @brief Add bytes written in place at NET_DatagramTail to the payload and its checksum
+ * @param psDatagram - Open datagram
+ * @param wLength - Number of bytes written
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_DatagramCommit(net_datagram_t *psDatagram, uint16_t wLength);
+
+/**
+ * @brief Copy bytes to the payload, summing them on the way
+ * @param psDatagram - Open datagram
+ * @param pvData - Bytes to append
+ * @param wLength - Number of bytes
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_DatagramWrite(net_datagram_t *psDatagram, const void *pvData, uint16_t wLength);
+
+/**
+ * @brief Prepend the headers and hand the block to the MAC
+ * @param psDatagram - Open datagram, closed on success
+ * @param dwDstIp - Destination address, must be in the ARP table
+ * @param wDstPort - Destination port
+ * @param wSrcPort - Source port
+ * @retval Status code indicating operation success or reason for failure
+ * @note On NHNS_STATUS_BUSY the datagram stays open and can be sent again or discarded
+ */
+nhns_status_t NET_DatagramSend(net_datagram_t *psDatagram, uint32_t dwDstIp, uint16_t wDstPort, uint16_t wSrcPort);
+
+/**
+ * @brief Drop an open datagram and return its block
+ * @param psDatagram - Datagram to close
+ */
+void NET_DatagramDiscard(net_datagram_t *psDatagram);
+
+/**
+ * @brief Get the protocol counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_GetStats(net_stats_t *psStats);
+
+/**
+ * @brief Print the address, the ARP table and the protocol counters
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NET_Dump(uart_instance_t nID);
+
+#endif    // __NET_H__
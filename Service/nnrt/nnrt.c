@@ -0,0 +1,781 @@
+#include <stdio.h>
+#include <string.h>
+#include "heap.h"
+#include "nnrt.h"
+#include "nnrt_tinycnn.h"
+#include "profiler.h"
+#include "ref_functions.h"
+
+// --- Definitions ---
+
+#define NNRT_LINE_SIZE         128
+#define NNRT_ALIGN(dwBytes)    (((dwBytes) + NNRT_ALIGNMENT - 1) & ~(uint32_t)(NNRT_ALIGNMENT - 1))
+
+// Benchmark model, converted by Tools/nnrt_convert.py from Tools/models/tinycnn.json
+#define TINYCNN_SEED       0x1D872B41UL
+#define TINYCNN_INFERENCES 16
+
+// --- Types ---
+
+// A tensor or a layer's scratch buffer, with the layers it lives across
+typedef struct nnrt_block
+{
+    uint32_t dwSize;
+    uint8_t bFirst;
+    uint8_t bLast;
+    uint32_t *pdwOffset;
+} nnrt_block_t;
+
+// --- Static Functions ---
+
+/**
+ * @brief Output size of a convolution or pooling window sliding over a square input
+ * @param dwIn - Input height and width
+ * @param psLayer - Layer with the window, stride and padding
+ * @retval Output height and width, 0 when the window does not fit
+ */
+static uint32_t NNRT_WindowOutput(uint32_t dwIn, const nnrt_layer_t *psLayer)
+{
+    if (psLayer->bKernel == 0 || psLayer->bStride == 0 || dwIn + 2U * psLayer->bPadding < psLayer->bKernel)
+    {
+        return 0;
+    }
+
+    return (dwIn + 2U * psLayer->bPadding - psLayer->bKernel) / psLayer->bStride + 1U;
+}
+
+/**
+ * @brief Name the CMSIS-NN function a layer runs on
+ * @param psModel - Model
+ * @param psLayer - Layer
+ * @retval Function name
+ */
+static const char *NNRT_KernelName(const nnrt_model_t *psModel, const nnrt_layer_t *psLayer)
+{
+    const nnrt_tensor_t *psIn  = &psModel->psTensors[psLayer->bInput];
+    const nnrt_tensor_t *psOut = &psModel->psTensors[psLayer->bOutput];
+
+    switch (psLayer->nKind)
+    {
+        case NNRT_KIND_CONV:
+            if (psIn->wChannels == 3)
+            {
+                return "arm_convolve_HWC_q7_RGB";
+            }
+            return (psIn->wChannels % 4 == 0 && psOut->wChannels % 2 == 0) ? "arm_convolve_HWC_q7_fast"
+                                                                           : "arm_convolve_HWC_q7_basic";
+        case NNRT_KIND_RELU:
+            return "arm_relu_q7";
+        case NNRT_KIND_MAXPOOL:
+            return "arm_maxpool_q7_HWC";
+        case NNRT_KIND_AVEPOOL:
+            return "arm_avepool_q7_HWC";
+        case NNRT_KIND_FC:
+            return "arm_fully_connected_q7";
+        case NNRT_KIND_FC_OPT:
+            return "arm_fully_connected_q7_opt";
+        case NNRT_KIND_SOFTMAX:
+            return "arm_softmax_q7";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * @brief Check the shapes and parameters of a layer and size its scratch buffer
+ * @param psModel - Model, tensor sizes set
+ * @param psLayer - Layer, tensor indices in range
+ * @retval True if the kernel can run the layer
+ */
+static bool NNRT_CheckLayer(const nnrt_model_t *psModel, nnrt_layer_t *psLayer)
+{
+    const nnrt_tensor_t *psIn  = &psModel->psTensors[psLayer->bInput];
+    const nnrt_tensor_t *psOut = &psModel->psTensors[psLayer->bOutput];
+    bool fInPlace              = (psLayer->bInput == psLayer->bOutput);
+
+    // 1) Only ReLU works in place, and the kernels count in 16 bits
+    if (fInPlace != (psLayer->nKind == NNRT_KIND_RELU) || psIn->dwSize > UINT16_MAX || psOut->dwSize > UINT16_MAX ||
+        psLayer->bBiasShift > 31 || psLayer->bOutShift > 31)
+    {
+        return false;
+    }
+
+    // 2) What each kernel can do, and the q15 scratch it asks for
+    psLayer->dwScratch = 0;
+    switch (psLayer->nKind)
+    {
+        case NNRT_KIND_CONV:
+            psLayer->dwScratch = 2U * psIn->wChannels * psLayer->bKernel * psLayer->bKernel * sizeof(q15_t);
+            return psLayer->pbWeights != NULL && psLayer->pbBias != NULL &&
+                   psOut->wDim == NNRT_WindowOutput(psIn->wDim, psLayer);
+        case NNRT_KIND_RELU:
+            return true;
+        case NNRT_KIND_AVEPOOL:
+            psLayer->dwScratch = 2U * psOut->wDim * psIn->wChannels;
+            return psOut->wChannels == psIn->wChannels && psOut->wDim == NNRT_WindowOutput(psIn->wDim, psLayer);
+        case NNRT_KIND_MAXPOOL:
+            return psOut->wChannels == psIn->wChannels && psOut->wDim == NNRT_WindowOutput(psIn->wDim, psLayer);
+        case NNRT_KIND_FC:
+        case NNRT_KIND_FC_OPT:
+            psLayer->dwScratch = psIn->dwSize * sizeof(q15_t);
+            return psLayer->pbWeights != NULL && psLayer->pbBias != NULL && psOut->wDim == 1;
+        case NNRT_KIND_SOFTMAX:
+            return psOut->dwSize == psIn->dwSize;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Check the tables and work out when each tensor is live
+ * @param psModel - Model
+ * @retval True if every layer fits its tensors and reads only what earlier layers wrote
+ */
+static bool NNRT_Check(nnrt_model_t *psModel)
+{
+    bool afWritten[NNRT_MAX_TENSORS] = {false};
+
+    // 1) Tensors of some size, the ends distinct
+    if (psModel->psTensors == NULL || psModel->dwTensors == 0 || psModel->dwTensors > NNRT_MAX_TENSORS ||
+        psModel->psLayers == NULL || psModel->dwLayers == 0 || psModel->dwLayers > NNRT_MAX_LAYERS ||
+        psModel->bInput >= psModel->dwTensors || psModel->bOutput >= psModel->dwTensors ||
+        psModel->bInput == psModel->bOutput || psModel->pbArena == NULL ||
+        ((uintptr_t)psModel->pbArena % NNRT_ALIGNMENT) != 0)
+    {
+        return false;
+    }
+    for (uint32_t dwTensor = 0; dwTensor < psModel->dwTensors; dwTensor++)
+    {
+        nnrt_tensor_t *psTensor = &psModel->psTensors[dwTensor];
+
+        psTensor->dwSize = (uint32_t)psTensor->wDim * psTensor->wDim * psTensor->wChannels;
+        psTensor->bFirst = 0;
+        psTensor->bLast  = 0;
+        if (psTensor->dwSize == 0)
+        {
+            return false;
+        }
+    }
+
+    // 2) Layers in data order: each reads a tensor already written and writes one nobody has
+    afWritten[psModel->bInput] = true;
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+
+        if (psLayer->nKind >= NNRT_KIND_MAX || psLayer->bInput >= psModel->dwTensors ||
+            psLayer->bOutput >= psModel->dwTensors || !afWritten[psLayer->bInput] ||
+            !NNRT_CheckLayer(psModel, psLayer))
+        {
+            return false;
+        }
+        if (psLayer->bOutput != psLayer->bInput)
+        {
+            if (afWritten[psLayer->bOutput])
+            {
+                return false;
+            }
+            afWritten[psLayer->bOutput]                 = true;
+            psModel->psTensors[psLayer->bOutput].bFirst = (uint8_t)dwLayer;
+        }
+        psModel->psTensors[psLayer->bInput].bLast = (uint8_t)dwLayer;
+    }
+    if (!afWritten[psModel->bOutput])
+    {
+        return false;
+    }
+
+    // 3) Tensors never read die where they are written, the output outlives the last layer
+    for (uint32_t dwTensor = 0; dwTensor < psModel->dwTensors; dwTensor++)
+    {
+        nnrt_tensor_t *psTensor = &psModel->psTensors[dwTensor];
+
+        psTensor->bLast = (psTensor->bLast < psTensor->bFirst) ? psTensor->bFirst : psTensor->bLast;
+    }
+    psModel->psTensors[psModel->bOutput].bLast = (uint8_t)(psModel->dwLayers - 1);
+
+    // 4) Pooling may destroy its input, so nothing reads it afterwards
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        const nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+
+        if ((psLayer->nKind == NNRT_KIND_MAXPOOL || psLayer->nKind == NNRT_KIND_AVEPOOL) &&
+            (psModel->psTensors[psLayer->bInput].bLast != dwLayer || psLayer->bInput == psModel->bOutput))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Give every tensor and scratch buffer an arena offset, largest first, at the lowest offset clear of
+ *        everything live at the same time
+ * @param psModel - Checked model
+ */
+static void NNRT_Plan(nnrt_model_t *psModel)
+{
+    nnrt_block_t asBlocks[NNRT_MAX_TENSORS + NNRT_MAX_LAYERS];
+    uint8_t abOrder[NNRT_MAX_TENSORS + NNRT_MAX_LAYERS];
+    uint32_t dwBlocks = 0;
+
+    // 1) Tensors live from their writer to their last reader, scratch for its layer alone
+    psModel->dwPeak     = 0;
+    psModel->dwUnshared = 0;
+    for (uint32_t dwTensor = 0; dwTensor < psModel->dwTensors; dwTensor++)
+    {
+        nnrt_tensor_t *psTensor = &psModel->psTensors[dwTensor];
+
+        asBlocks[dwBlocks] = (nnrt_block_t){NNRT_ALIGN(psTensor->dwSize), psTensor->bFirst, psTensor->bLast,
+                                            &psTensor->dwOffset};
+        dwBlocks++;
+    }
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+
+        psLayer->dwScratchOffset = 0;
+        if (psLayer->dwScratch != 0)
+        {
+            asBlocks[dwBlocks] = (nnrt_block_t){NNRT_ALIGN(psLayer->dwScratch), (uint8_t)dwLayer, (uint8_t)dwLayer,
+                                                &psLayer->dwScratchOffset};
+            dwBlocks++;
+        }
+    }
+
+    // 2) Largest first, so small blocks fill the gaps the large ones leave
+    for (uint32_t dwIndex = 0; dwIndex < dwBlocks; dwIndex++)
+    {
+        uint32_t dwSlot = dwIndex;
+
+        while (dwSlot > 0 && asBlocks[abOrder[dwSlot - 1]].dwSize < asBlocks[dwIndex].dwSize)
+        {
+            abOrder[dwSlot] = abOrder[dwSlot - 1];
+            dwSlot--;
+        }
+        abOrder[dwSlot] = (uint8_t)dwIndex;
+        psModel->dwUnshared += asBlocks[dwIndex].dwSize;
+    }
+
+    // 3) Each block goes past whatever placed block it collides with, until it collides with none
+    for (uint32_t dwIndex = 0; dwIndex < dwBlocks; dwIndex++)
+    {
+        nnrt_block_t *psBlock = &asBlocks[abOrder[dwIndex]];
+        uint32_t dwOffset     = 0;
+        bool fMoved           = true;
+
+        while (fMoved)
+        {
+            fMoved = false;
+            for (uint32_t dwPlaced = 0; dwPlaced < dwIndex; dwPlaced++)
+            {
+                const nnrt_block_t *psOther = &asBlocks[abOrder[dwPlaced]];
+
+                if (psOther->bFirst <= psBlock->bLast && psBlock->bFirst <= psOther->bLast &&
+                    *psOther->pdwOffset < dwOffset + psBlock->dwSize && dwOffset < *psOther->pdwOffset + psOther->dwSize)
+                {
+                    dwOffset = *psOther->pdwOffset + psOther->dwSize;
+                    fMoved   = true;
+                }
+            }
+        }
+
+        *psBlock->pdwOffset = dwOffset;
+        if (dwOffset + psBlock->dwSize > psModel->dwPeak)
+        {
+            psModel->dwPeak = dwOffset + psBlock->dwSize;
+        }
+    }
+}
+
+/**
+ * @brief Run one layer on the CMSIS-NN kernel or its reference implementation
+ * @param psModel - Model
+ * @param psLayer - Layer
+ * @param pbIn - Input tensor, the output too for ReLU
+ * @param pbOut - Output tensor
+ * @param pwScratch - dwScratch bytes
+ * @param fReference - Run the reference from NN_Lib_Tests instead
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_UNSUPPORTED for a reference that does not exist
+ */
+static nhns_status_t NNRT_RunLayer(const nnrt_model_t *psModel, const nnrt_layer_t *psLayer, q7_t *pbIn, q7_t *pbOut,
+                                   q15_t *pwScratch, bool fReference)
+{
+    const nnrt_tensor_t *psIn  = &psModel->psTensors[psLayer->bInput];
+    const nnrt_tensor_t *psOut = &psModel->psTensors[psLayer->bOutput];
+    arm_status nStatus         = ARM_MATH_SUCCESS;
+
+    switch (psLayer->nKind)
+    {
+        case NNRT_KIND_CONV:
+            if (fReference)
+            {
+                arm_convolve_HWC_q7_ref(pbIn, psIn->wDim, psIn->wChannels, psLayer->pbWeights, psOut->wChannels,
+                                        psLayer->bKernel, psLayer->bPadding, psLayer->bStride, psLayer->pbBias,
+                                        psLayer->bBiasShift, psLayer->bOutShift, pbOut, psOut->wDim, pwScratch, NULL);
+            }
+            else if (psIn->wChannels == 3)
+            {
+                nStatus = arm_convolve_HWC_q7_RGB(pbIn, psIn->wDim, psIn->wChannels, psLayer->pbWeights,
+                                                  psOut->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                                  psLayer->bStride, psLayer->pbBias, psLayer->bBiasShift,
+                                                  psLayer->bOutShift, pbOut, psOut->wDim, pwScratch, NULL);
+            }
+            else if (psIn->wChannels % 4 == 0 && psOut->wChannels % 2 == 0)
+            {
+                nStatus = arm_convolve_HWC_q7_fast(pbIn, psIn->wDim, psIn->wChannels, psLayer->pbWeights,
+                                                   psOut->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                                   psLayer->bStride, psLayer->pbBias, psLayer->bBiasShift,
+                                                   psLayer->bOutShift, pbOut, psOut->wDim, pwScratch, NULL);
+            }
+            else
+            {
+                nStatus = arm_convolve_HWC_q7_basic(pbIn, psIn->wDim, psIn->wChannels, psLayer->pbWeights,
+                                                    psOut->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                                    psLayer->bStride, psLayer->pbBias, psLayer->bBiasShift,
+                                                    psLayer->bOutShift, pbOut, psOut->wDim, pwScratch, NULL);
+            }
+            break;
+        case NNRT_KIND_RELU:
+            if (fReference)
+            {
+                arm_relu_q7_ref(pbIn, (uint16_t)psIn->dwSize);
+            }
+            else
+            {
+                arm_relu_q7(pbIn, (uint16_t)psIn->dwSize);
+            }
+            break;
+        case NNRT_KIND_MAXPOOL:
+            if (fReference)
+            {
+                arm_maxpool_q7_HWC_ref(pbIn, psIn->wDim, psIn->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                       psLayer->bStride, psOut->wDim, (q7_t *)pwScratch, pbOut);
+            }
+            else
+            {
+                arm_maxpool_q7_HWC(pbIn, psIn->wDim, psIn->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                   psLayer->bStride, psOut->wDim, (q7_t *)pwScratch, pbOut);
+            }
+            break;
+        case NNRT_KIND_AVEPOOL:
+            if (fReference)
+            {
+                arm_avepool_q7_HWC_ref(pbIn, psIn->wDim, psIn->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                       psLayer->bStride, psOut->wDim, (q7_t *)pwScratch, pbOut);
+            }
+            else
+            {
+                arm_avepool_q7_HWC(pbIn, psIn->wDim, psIn->wChannels, psLayer->bKernel, psLayer->bPadding,
+                                   psLayer->bStride, psOut->wDim, (q7_t *)pwScratch, pbOut);
+            }
+            break;
+        case NNRT_KIND_FC:
+            if (fReference)
+            {
+                arm_fully_connected_q7_ref(pbIn, psLayer->pbWeights, (uint16_t)psIn->dwSize, psOut->wChannels,
+                                           psLayer->bBiasShift, psLayer->bOutShift, psLayer->pbBias, pbOut, pwScratch);
+            }
+            else
+            {
+                nStatus = arm_fully_connected_q7(pbIn, psLayer->pbWeights, (uint16_t)psIn->dwSize, psOut->wChannels,
+                                                 psLayer->bBiasShift, psLayer->bOutShift, psLayer->pbBias, pbOut,
+                                                 pwScratch);
+            }
+            break;
+        case NNRT_KIND_FC_OPT:
+            if (fReference)
+            {
+                arm_fully_connected_q7_opt_ref(pbIn, psLayer->pbWeights, (uint16_t)psIn->dwSize, psOut->wChannels,
+                                               psLayer->bBiasShift, psLayer->bOutShift, psLayer->pbBias, pbOut,
+                                               pwScratch);
+            }
+            else
+            {
+                nStatus = arm_fully_connected_q7_opt(pbIn, psLayer->pbWeights, (uint16_t)psIn->dwSize,
+                                                     psOut->wChannels, psLayer->bBiasShift, psLayer->bOutShift,
+                                                     psLayer->pbBias, pbOut, pwScratch);
+            }
+            break;
+        case NNRT_KIND_SOFTMAX:
+            if (fReference)
+            {
+                return NHNS_STATUS_UNSUPPORTED;
+            }
+            arm_softmax_q7(pbIn, (uint16_t)psIn->dwSize, pbOut);
+            break;
+        default:
+            return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    return (nStatus == ARM_MATH_SUCCESS) ? NHNS_STATUS_OK : NHNS_STATUS_FAIL;
+}
+
+/**
+ * @brief Fill the benchmark model's input with a pseudo-random image
+ * @param pbImage - Input tensor
+ * @param dwSeed - Image to make
+ */
+static void NNRT_FillImage(q7_t *pbImage, uint32_t dwSeed)
+{
+    for (uint32_t dwIndex = 0; dwIndex < TINYCNN_INPUT_DIM * TINYCNN_INPUT_DIM * TINYCNN_INPUT_CHANNELS; dwIndex++)
+    {
+        dwSeed           = dwSeed * 1664525UL + 1013904223UL;
+        pbImage[dwIndex] = (q7_t)(dwSeed >> 24);
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t NNRT_Init(nnrt_model_t *psModel)
+{
+    // 1) Verify arguments
+    if (psModel == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    psModel->fInitDone = false;
+    if (!NNRT_Check(psModel))
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    // 2) Offsets for everything, then whether they fit
+    NNRT_Plan(psModel);
+    if (psModel->dwPeak > psModel->dwArenaSize)
+    {
+        return NHNS_STATUS_NO_MEMORY;
+    }
+
+    NNRT_ResetStats(psModel);
+    psModel->fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NNRT_GetInput(nnrt_model_t *psModel, q7_t **ppbInput)
+{
+    // 1) Verify arguments
+    if (psModel == NULL || ppbInput == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if model is initialized
+    if (!psModel->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    *ppbInput = (q7_t *)&psModel->pbArena[psModel->psTensors[psModel->bInput].dwOffset];
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NNRT_Invoke(nnrt_model_t *psModel)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if (psModel == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if model is initialized
+    if (!psModel->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Layers in order, each charged the cycles of its kernel
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers && nRet == NHNS_STATUS_OK; dwLayer++)
+    {
+        nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+        uint32_t dwStart      = PROFILER_GetCycles();
+        uint32_t dwCycles     = 0;
+
+        nRet     = NNRT_RunLayer(psModel, psLayer,
+                                 (q7_t *)&psModel->pbArena[psModel->psTensors[psLayer->bInput].dwOffset],
+                                 (q7_t *)&psModel->pbArena[psModel->psTensors[psLayer->bOutput].dwOffset],
+                                 (q15_t *)(void *)&psModel->pbArena[psLayer->dwScratchOffset], false);
+        dwCycles = PROFILER_GetCycles() - dwStart;
+
+        psLayer->dwRuns++;
+        psLayer->qwCycles += dwCycles;
+        if (dwCycles > psLayer->dwMaxCycles)
+        {
+            psLayer->dwMaxCycles = dwCycles;
+        }
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        psModel->dwInferences++;
+    }
+
+    return nRet;
+}
+
+nhns_status_t NNRT_GetOutput(nnrt_model_t *psModel, const q7_t **ppbOutput)
+{
+    // 1) Verify arguments
+    if (psModel == NULL || ppbOutput == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if model is initialized
+    if (!psModel->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    *ppbOutput = (const q7_t *)&psModel->pbArena[psModel->psTensors[psModel->bOutput].dwOffset];
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t NNRT_Verify(nnrt_model_t *psModel, uart_instance_t nID)
+{
+    q7_t *pbRefIn          = NULL;
+    q7_t *pbRefOut         = NULL;
+    q15_t *pwRefScratch    = NULL;
+    uint32_t dwMaxTensor   = 0;
+    uint32_t dwMaxScratch  = 0;
+    uint32_t dwMismatches  = 0;
+    nhns_status_t nRet     = NHNS_STATUS_OK;
+    char szLine[NNRT_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Verify arguments
+    if (psModel == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if model is initialized
+    if (!psModel->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) A copy of the largest input, the reference output and scratch, outside the arena
+    for (uint32_t dwTensor = 0; dwTensor < psModel->dwTensors; dwTensor++)
+    {
+        dwMaxTensor = (psModel->psTensors[dwTensor].dwSize > dwMaxTensor) ? psModel->psTensors[dwTensor].dwSize
+                                                                          : dwMaxTensor;
+    }
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        dwMaxScratch = (psModel->psLayers[dwLayer].dwScratch > dwMaxScratch) ? psModel->psLayers[dwLayer].dwScratch
+                                                                             : dwMaxScratch;
+    }
+    pbRefIn      = HEAP_Alloc(dwMaxTensor, HEAP_REGION_DEFAULT);
+    pbRefOut     = HEAP_Alloc(dwMaxTensor, HEAP_REGION_DEFAULT);
+    pwRefScratch = HEAP_Alloc(dwMaxScratch + sizeof(q15_t), HEAP_REGION_DEFAULT);
+    if (pbRefIn == NULL || pbRefOut == NULL || pwRefScratch == NULL)
+    {
+        HEAP_Free(pbRefIn);
+        HEAP_Free(pbRefOut);
+        HEAP_Free(pwRefScratch);
+        return NHNS_STATUS_NO_MEMORY;
+    }
+
+    // 4) Each layer on the kernel in the arena and on the reference from a copy of the same input
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers && nRet == NHNS_STATUS_OK; dwLayer++)
+    {
+        const nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+        const nnrt_tensor_t *psIn   = &psModel->psTensors[psLayer->bInput];
+        const nnrt_tensor_t *psOut  = &psModel->psTensors[psLayer->bOutput];
+        q7_t *pbIn                  = (q7_t *)&psModel->pbArena[psIn->dwOffset];
+        q7_t *pbOut                 = (q7_t *)&psModel->pbArena[psOut->dwOffset];
+        q7_t *pbExpected            = (psLayer->bInput == psLayer->bOutput) ? pbRefIn : pbRefOut;
+        nhns_status_t nReference    = NHNS_STATUS_OK;
+        uint32_t dwByte             = 0;
+
+        memcpy(pbRefIn, pbIn, psIn->dwSize);
+        nRet = NNRT_RunLayer(psModel, psLayer, pbIn, pbOut, (q15_t *)(void *)&psModel->pbArena[psLayer->dwScratchOffset],
+                             false);
+        if (nRet != NHNS_STATUS_OK)
+        {
+            break;
+        }
+        nReference = NNRT_RunLayer(psModel, psLayer, pbRefIn, pbRefOut, pwRefScratch, true);
+
+        while (nReference == NHNS_STATUS_OK && dwByte < psOut->dwSize && pbOut[dwByte] == pbExpected[dwByte])
+        {
+            dwByte++;
+        }
+        if (nReference != NHNS_STATUS_OK)
+        {
+            nLength = snprintf(szLine, sizeof(szLine), "nnrt %s: %-8s %-28s no reference\r\n", psModel->szName,
+                               psLayer->szName, NNRT_KernelName(psModel, psLayer));
+        }
+        else if (dwByte < psOut->dwSize)
+        {
+            dwMismatches++;
+            nLength = snprintf(szLine, sizeof(szLine), "nnrt %s: %-8s %-28s MISMATCH at byte %lu of %lu\r\n",
+                               psModel->szName, psLayer->szName, NNRT_KernelName(psModel, psLayer),
+                               (unsigned long)dwByte, (unsigned long)psOut->dwSize);
+        }
+        else
+        {
+            nLength = snprintf(szLine, sizeof(szLine), "nnrt %s: %-8s %-28s %lu bytes match\r\n", psModel->szName,
+                               psLayer->szName, NNRT_KernelName(psModel, psLayer), (unsigned long)psOut->dwSize);
+        }
+        nRet = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    }
+
+    HEAP_Free(pbRefIn);
+    HEAP_Free(pbRefOut);
+    HEAP_Free(pwRefScratch);
+
+    if (nRet == NHNS_STATUS_OK && dwMismatches != 0)
+    {
+        nRet = NHNS_STATUS_DATA_MISMATCH;
+    }
+
+    return nRet;
+}
+
+void NNRT_ResetStats(nnrt_model_t *psModel)
+{
+    if (psModel == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        psModel->psLayers[dwLayer].dwRuns      = 0;
+        psModel->psLayers[dwLayer].dwMaxCycles = 0;
+        psModel->psLayers[dwLayer].qwCycles    = 0;
+    }
+    psModel->dwInferences = 0;
+}
+
+nhns_status_t NNRT_Dump(const nnrt_model_t *psModel, uart_instance_t nID)
+{
+    uint64_t qwTotal   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    char szLine[NNRT_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Verify arguments
+    if (psModel == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if model is initialized
+    if (!psModel->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+    {
+        qwTotal += psModel->psLayers[dwLayer].qwCycles;
+    }
+
+    // 3) The plan: where each tensor sits and across which layers
+    nLength = snprintf(szLine, sizeof(szLine),
+                       "nnrt %s: arena %lu of %lu bytes, %lu unshared, %lu inferences\r\n", psModel->szName,
+                       (unsigned long)psModel->dwPeak, (unsigned long)psModel->dwArenaSize,
+                       (unsigned long)psModel->dwUnshared, (unsigned long)psModel->dwInferences);
+    nRet    = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    for (uint32_t dwTensor = 0; dwTensor < psModel->dwTensors && nRet == NHNS_STATUS_OK; dwTensor++)
+    {
+        const nnrt_tensor_t *psTensor = &psModel->psTensors[dwTensor];
+
+        nLength = snprintf(szLine, sizeof(szLine), "  tensor %-2lu %3ux%-3ux%-4u %6lu bytes at %6lu, layers %u to %u\r\n",
+                           (unsigned long)dwTensor, (unsigned)psTensor->wDim, (unsigned)psTensor->wDim,
+                           (unsigned)psTensor->wChannels, (unsigned long)psTensor->dwSize,
+                           (unsigned long)psTensor->dwOffset, (unsigned)psTensor->bFirst, (unsigned)psTensor->bLast);
+        nRet    = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    }
+
+    // 4) One line per layer, with its scratch and its share of the inference
+    for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers && nRet == NHNS_STATUS_OK; dwLayer++)
+    {
+        const nnrt_layer_t *psLayer = &psModel->psLayers[dwLayer];
+        uint32_t dwPermille         = (qwTotal != 0) ? (uint32_t)(psLayer->qwCycles * 1000 / qwTotal) : 0;
+
+        nLength = snprintf(szLine, sizeof(szLine), "  %-8s %-28s %5lu scratch %8lu avg %8lu max %3lu.%lu%%\r\n",
+                           psLayer->szName, NNRT_KernelName(psModel, psLayer), (unsigned long)psLayer->dwScratch,
+                           (unsigned long)((psLayer->dwRuns != 0) ? psLayer->qwCycles / psLayer->dwRuns : 0),
+                           (unsigned long)psLayer->dwMaxCycles, (unsigned long)(dwPermille / 10),
+                           (unsigned long)(dwPermille % 10));
+        nRet    = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    }
+    if (nRet == NHNS_STATUS_OK && psModel->dwInferences != 0)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "  %lu cycles per inference\r\n",
+                           (unsigned long)(qwTotal / psModel->dwInferences));
+        nRet    = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t NNRT_Benchmark(uart_instance_t nID)
+{
+    nnrt_model_t *psModel = TINYCNN_GetModel();
+    const q7_t *pbClasses = NULL;
+    q7_t *pbImage         = NULL;
+    uint32_t dwBest       = 0;
+    uint64_t qwCycles     = 0;
+    nhns_status_t nRet    = NHNS_STATUS_OK;
+    char szLine[NNRT_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) Fresh plan, the weights stay in flash
+    nRet = NNRT_Init(psModel);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = NNRT_GetInput(psModel, &pbImage);
+    }
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    // 2) Every layer bit for bit against its reference
+    NNRT_FillImage(pbImage, TINYCNN_SEED);
+    nRet = NNRT_Verify(psModel, nID);
+
+    // 3) Timed inferences, a new image each time since the arena reuses the input's bytes
+    for (uint32_t dwInference = 0; dwInference < TINYCNN_INFERENCES && nRet == NHNS_STATUS_OK; dwInference++)
+    {
+        NNRT_FillImage(pbImage, TINYCNN_SEED + dwInference);
+        nRet = NNRT_Invoke(psModel);
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = NNRT_Dump(psModel, nID);
+    }
+
+    // 4) The class of the last image, and the rate the core could sustain
+    if (nRet == NHNS_STATUS_OK)
+    {
+        NNRT_GetOutput(psModel, &pbClasses);
+        for (uint32_t dwClass = 1; dwClass < TINYCNN_OUTPUTS; dwClass++)
+        {
+            dwBest = (pbClasses[dwClass] > pbClasses[dwBest]) ? dwClass : dwBest;
+        }
+        for (uint32_t dwLayer = 0; dwLayer < psModel->dwLayers; dwLayer++)
+        {
+            qwCycles += psModel->psLayers[dwLayer].qwCycles;
+        }
+        nLength = snprintf(szLine, sizeof(szLine), "nnrt: class %lu, up to %lu inferences/s on this core\r\n",
+                           (unsigned long)dwBest,
+                           (unsigned long)((qwCycles != 0) ? (uint64_t)PROFILER_GetCyclesPerSecond() *
+                                                                 psModel->dwInferences / qwCycles
+                                                           : 0));
+        nRet    = UART_PrintLine(nID, szLine, nLength, NNRT_LINE_SIZE);
+    }
+
+    return nRet;
+}
@@ -0,0 +1,169 @@
+#ifndef __NNRT_H__
+#define __NNRT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "arm_nnfunctions.h"
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * q7 inference on the CMSIS-NN kernels. A model is a set of tables written
+ * offline: the tensors with their shapes, the layers in execution order with
+ * their weights, and a static arena owned by the model. NNRT_Init checks the
+ * shapes, works out from the layer order when each tensor is first written
+ * and last read, and gives each tensor and each layer's scratch buffer an
+ * offset in the arena. Buffers that are never live at the same time share
+ * bytes, so the arena only needs to hold the busiest layer, not the whole
+ * network.
+ *
+ * Tensors are HWC, square, one byte per value. Fully connected layers and
+ * softmax treat their input as a flat vector. ReLU works in place: its
+ * output is its input tensor. Pooling destroys its input on cores with the
+ * DSP extension, so NNRT_Init rejects a model that reads a tensor again after
+ * pooling it.
+ */
+
+#define NNRT_MAX_TENSORS 16
+#define NNRT_MAX_LAYERS  16
+#define NNRT_ALIGNMENT   4     // Arena offsets, for the word loads of the kernels
+
+// --- Types ---
+
+typedef enum nnrt_kind
+{
+    NNRT_KIND_CONV = 0,    // arm_convolve_HWC_q7_fast, _RGB or _basic, whichever the channels allow
+    NNRT_KIND_RELU,        // arm_relu_q7, in place
+    NNRT_KIND_MAXPOOL,     // arm_maxpool_q7_HWC
+    NNRT_KIND_AVEPOOL,     // arm_avepool_q7_HWC
+    NNRT_KIND_FC,          // arm_fully_connected_q7, weights row by row
+    NNRT_KIND_FC_OPT,      // arm_fully_connected_q7_opt, weights interleaved for it
+    NNRT_KIND_SOFTMAX,     // arm_softmax_q7
+    NNRT_KIND_MAX,
+} nnrt_kind_t;
+
+typedef struct nnrt_tensor
+{
+    uint16_t wDim;         // Height and width
+    uint16_t wChannels;
+
+    // Set by NNRT_Init
+    uint32_t dwSize;       // Bytes
+    uint32_t dwOffset;     // In the arena
+    uint8_t bFirst;        // Layer that writes it, 0 for the model input
+    uint8_t bLast;         // Last layer that reads it, the last layer for the model output
+} nnrt_tensor_t;
+
+typedef struct nnrt_layer
+{
+    const char *szName;
+    nnrt_kind_t nKind;
+    uint8_t bInput;               // Tensor read
+    uint8_t bOutput;              // Tensor written, bInput for ReLU
+    uint8_t bKernel;              // Convolution and pooling window
+    uint8_t bStride;
+    uint8_t bPadding;
+    uint8_t bBiasShift;           // Left shift of the bias into the accumulator
+    uint8_t bOutShift;            // Right shift of the accumulator into the output
+    const q7_t *pbWeights;        // Conv: [out][y][x][in], FC: [out][in] or interleaved
+    const q7_t *pbBias;           // One per output channel
+
+    // Set by NNRT_Init
+    uint32_t dwScratch;           // Bytes of q15 scratch
+    uint32_t dwScratchOffset;     // In the arena
+
+    // Cost, in PROFILER_GetCycles ticks
+    uint32_t dwRuns;
+    uint32_t dwMaxCycles;
+    uint64_t qwCycles;
+} nnrt_layer_t;
+
+typedef struct nnrt_model
+{
+    const char *szName;
+    nnrt_tensor_t *psTensors;
+    uint32_t dwTensors;
+    nnrt_layer_t *psLayers;       // In execution order
+    uint32_t dwLayers;
+    uint8_t bInput;               // Tensor the caller fills
+    uint8_t bOutput;              // Tensor the caller reads
+    uint8_t *pbArena;             // NNRT_ALIGNMENT aligned
+    uint32_t dwArenaSize;
+
+    // Set by NNRT_Init
+    uint32_t dwPeak;              // Arena bytes the plan uses
+    uint32_t dwUnshared;          // Bytes with every buffer on its own
+    bool fInitDone;
+    uint32_t dwInferences;
+} nnrt_model_t;
+
+// --- Functions ---
+
+/**
+ * @brief Check the shapes and the layer order and plan the arena
+ * @param psModel - Model to set up
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_INVALID_CONFIGURATION when the tables do not add up,
+ *       NHNS_STATUS_NO_MEMORY when the plan does not fit in the arena
+ */
+nhns_status_t NNRT_Init(nnrt_model_t *psModel);
+
+/**
+ * @brief Get where to write the input tensor
+ * @param psModel - Model to feed
+ * @param ppbInput - Returns the input tensor in the arena
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NNRT_GetInput(nnrt_model_t *psModel, q7_t **ppbInput);
+
+/**
+ * @brief Run every layer once on the input tensor
+ * @param psModel - Model to run
+ * @retval Status code indicating operation success or reason for failure
+ * @note The input tensor is overwritten as the arena is reused
+ */
+nhns_status_t NNRT_Invoke(nnrt_model_t *psModel);
+
+/**
+ * @brief Get the output tensor of the last NNRT_Invoke
+ * @param psModel - Model run
+ * @param ppbOutput - Returns the output tensor in the arena, valid until the next NNRT_Invoke
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NNRT_GetOutput(nnrt_model_t *psModel, const q7_t **ppbOutput);
+
+/**
+ * @brief Run the input tensor through every layer and the reference implementation of its kernel, and print if they match
+ * @param psModel - Model to check, its input tensor filled
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a layer's output differs in any byte. Leaves the
+ *       results of an inference in the arena, with no cost counted. Softmax has no reference
+ */
+nhns_status_t NNRT_Verify(nnrt_model_t *psModel, uart_instance_t nID);
+
+/**
+ * @brief Clear the cost counters of every layer
+ * @param psModel - Model to clear
+ */
+void NNRT_ResetStats(nnrt_model_t *psModel);
+
+/**
+ * @brief Print the arena plan and the cycles of each layer
+ * @param psModel - Model to print
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t NNRT_Dump(const nnrt_model_t *psModel, uart_instance_t nID);
+
+/**
+ * @brief Check a small CNN against the reference kernels, then time it and print the plan and the cycles
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a layer does not match its reference
+ */
+nhns_status_t NNRT_Benchmark(uart_instance_t nID);
+
+#endif    // __NNRT_H__
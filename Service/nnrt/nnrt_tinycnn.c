@@ -0,0 +1,401 @@
+#include "nnrt_tinycnn.h"
+
+/*
+ * Generated by Tools/nnrt_convert.py from tinycnn.json, do not edit.
+ *
+ * layer    type       in    w bias  out bshift oshift
+ * conv1    conv        7    7   10    5      4      9
+ * relu1    relu        5              5
+ * pool1    maxpool     5              5
+ * conv2    conv        5    7   10    4      2      8
+ * relu2    relu        4              4
+ * pool2    avepool     4              4
+ * fc       fc_opt      4    8   12    5      0      7
+ * softmax  softmax     5              7
+ *
+ * Fraction bits per value, then the shifts the kernels apply. The arena holds
+ * 5860 bytes of buffers in 3116.
+ */
+
+// --- Global Variables ---
+
+// conv1, [out][y][x][in]
+static const q7_t gabTinyCnnConv1Weights[600] __attribute__((aligned(NNRT_ALIGNMENT))) = {
+     -33,    6,  -14,   41,  -28,   18,   -1,   16,    9,  -23,  -29,   17,   18,   -4,   -7,  -24,
+     -10,  -83,    9,   34,  -32,    6,    8,   -9,    5,   21,   18,    7,   -9,    5,   -1,  -35,
+     -15,   12,    7,   21,   -6,   13,   10,  -11,   14,    4,   42,    5,   10,  -15,   37,   -9,
+      -9,    5,   17,  -23,    8,   68,   -9,   11,  -40,    2,   13,   16,  -26,   42,   23,    0,
+      16,   28,   12,  -14,    9,   31,   33,   23,   12,    0,   -6,  -19,   33,   18,    2,   23,
+      -2,   25,  -51,   22,    2,    8,   -4,   11,   -8,  -13,   12,    9,    7,   20,  -15,   -1,
+     -20,   26,    8,  -26,   24,  -11,   31,  -13,   -7,   -8,   10,    4,   22,  -40,   -7,   -6,
+     -15,    0,  -29,  -17,    6,    9,   40,   31,  -63,  -26,  -19,  -21,  -24,  -10,   -4,   10,
+       7,    1,  -19,  -22,  -10,  -10,    4,   13,    7,   17,   -3,  -29,   19,  -33,    6,   27,
+     -21,    7,  -13,  -41,   11,   18,    0,  -20,   -4,  -10,  -16,  -32,    0,  -22,   14,   -2,
+     -24,    5,    8,  -21,   19,    1,   49,   -8,   -1,   34,    9,   55,   19,  -36,   39,   18,
+      19,   37,  -16,   44,  -20,    1,  -22,    5,  -19,    1,   10,    2,  -19,   23,   14,   30,
+      21,    7,   45,    8,   14,   -6,  -17,   38,   18,   21,    8,    6,  -26,  -19,  -11,    5,
+       0,    0,   14,   14,  -20,  -10,    9,  -38,   24,  -12,    4,  -45,   -3,   19,  -14,  -16,
+       1,  -18,  -15,   -2,    4,  -19,  -21,   11,  -19,   49,   -5,  -13,   -4,   -5,  -22,   21,
+      -2,   25,  -10,  -14,  -48,  -12,    2,  -25,  -17,    4,    0,   25,   -4,  -52,   45,  -11,
+     -20,    3,   30,    6,  -12,  -33,    8,   -6,  -10,   -9,    6,  -52,    1,  -16,   12,  -34,
+     -12,  -22,   35,  -13,   16,   29,    4,   -7,   20,   20,   14,   15,   39,   -5,   29,   20,
+       2,   17,   31,  -23,   19,   -9,    9,    7,  -25,   15,  -20,   34,    3,   28,  -20,   18,
+      18,   33,   -2,   43,  -31,  -10,   -1,  -14,   12,  -29,    1,    5,   -7,   -7,  -19,   10,
+     -17,    3,  -12,   15,  -31,    3,  -25,    9,   45,    9,   12,   28,  -20,    1,  -49,    4,
+      31,   13,   16,   -2,   10,   21,   -8,   -8,    5,    4,    1,  -35,   -2,   -8,  -50,    6,
+     -31,   -5,   18,  -26,  -16,  -26,  -16,  -18,  -28,  -15,  -12,  -23,   -4,  -17,   16,    0,
+      28,    7,    4,  -16,   -4,    6,   18,    2,   -5,   12,   -5,   22,   12,    4,    7,  -29,
+     -17,   13,   -5,  -10,   20,    2,  -14,    8,  -16,   24,  -16,   30,  -31,  -21,  -25,   15,
+     -10,    4,   51,   45,   20,   -8,   24,    0,   -7,  -47,   32,  -45,   16,  -25,   21,  -48,
+      28,  -21,  -29,   31,    5,   -6,   18,  -15,  -35,  -23,    9,  -49,   26,  -15,   -3,  -20,
+     -29,  -35,   41,    5,   27,  -19,   10,   -8,    2,    3,    7,    1,  -29,   49,    2,   25,
+       2,  -12,    3,   -5,   33,  -19,  -16,   20,   -9,   -4,    0,    3,    9,  -23,  -22,   -5,
+       1,  -36,   -5,  -10,   11,  -12,   46,    1,    1,   22,   12,   15,   -9,   -6,   29,   16,
+       5,   35,   10,   -8,  -42,    9,    8,   22,  -24,   16,   27,   14,    2,  -35,  -39,   -5,
+      23,  -19,   -4,  -15,   -1,  -12,   53,    7,   -3,  -17,  -17,  -36,   -9,  -19,   -9,  -19,
+     -26,    9,   12,   11,   -1,   12,   23,   21,   21,   12,   -9,   -5,   15,   18,  -16,  -13,
+      -5,  -26,  -19,   12,   15,  -11,  -36,  -18,  -40,   -6,   28,   -4,   21,   -6,  -34,   -2,
+     -12,   13,   32,   -4,   13,  -10,    6,   30,  -45,  -24,   35,  -13,  -26,   38,   26,   16,
+      14,  -13,   29,    3,    0,  -53,  -14,  -18,   -9,   -1,  -27,    3,   -8,   24,   -5,    8,
+      10,   24,   -4,   -4,  -13,  -29,   18,  -24,    5,    7,  -36,   27,    1,  -18,    7,  -33,
+     -10,  -16,   22,   -5,    2,  -23,  -35,   -3,
+};
+static const q7_t gabTinyCnnConv1Bias[8] = {
+      41,   10,  -39,  -91,   12,  -21,   22,   27,
+};
+
+// conv2, [out][y][x][in]
+static const q7_t gabTinyCnnConv2Weights[1152] __attribute__((aligned(NNRT_ALIGNMENT))) = {
+      33,   18,    6,   -8,   10,    1,   16,    0,   14,  -25,  -14,   -1,    6,   17,   15,  -13,
+       2,  -17,   34,   18,  -33,   -3,  -18,    6,   14,   -4,   -9,    3,   -1,  -31,   21,  -24,
+      10,  -28,   24,  -11,    0,   13,   -9,   12,  -25,   22,   16,   37,   60,   10,  -11,  -31,
+       0,   19,  -22,  -40,   29,    9,   -5,   35,  -36,   13,    8,   39,   -8,   -4,    1,   16,
+     -43,    5,   12,   23,   36,   13,  -21,    7,   -7,    3,   18,   34,  -13,  -24,    6,  -66,
+      15,  -32,   -6,  -27,   39,  -25,  -15,    0,  -10,    9,   -8,    8,  -10,    9,   22,  -24,
+     -32,   38,    9,   -1,    4,   52,   -2,  -11,   -5,  -24,  -18,    8,   16,    5,  -59,    3,
+      43,   -7,  -29,   -4,  -13,    0,   31,  -33,    0,   -8,   24,    4,   27,    9,   -7,   16,
+     -21,   20,   45,   18,   27,   -1,    1,   35,   -6,    4,   -5,    7,   16,    3,  -22,  -22,
+       9,  -26,  -15,  -21,   35,  -33,  -32,  -25,   19,  -15,  -20,    5,  -14,   -1,  -18,   17,
+      27,   -3,    4,   14,  -14,   47,   -4,    3,  -33,   12,   23,  -17,    4,   -6,   51,   -1,
+      14,  -12,   10,   11,   18,    3,   53,  -12,  -13,  -11,   21,  -10,   10,  -12,    0,   -6,
+       6,   -8,   -6,   -4,   71,    3,    1,   16,  -31,  -22,   -2,   39,  -51,   17,  -24,  -16,
+      13,  -25,  -23,    0,    9,  -55,   33,  -33,   -7,    5,   27,   -4,   40,   -7,  -10,   37,
+      34,   -5,   41,  -28,   -9,   22,   20,   -3,   -8,    4,    2,  -24,   -8,    5,   36,   -5,
+     -26,   27,    9,    1,   33,    7,  -11,  -16,   11,  -29,   31,   24,   30,  -16,   16,   13,
+     -12,   -6,   -7,   41,   22,    2,    8,   -6,   17,  -16,  -15,   34,    3,   45,   -4,   -9,
+      25,   16,  -10,    2,   13,    2,  -24,  -37,    4,    8,   43,   12,   18,  -10,    6,   -8,
+       0,  -21,  -13,   18,  -10,   11,  -19,  -25,   22,   31,   -6,  -10,   49,  -29,  -75,   -8,
+     -33,    8,   26,  -15,  -13,  -34,    0,   32,   19,   10,   46,  -22,   -7,    5,   22,   -9,
+      21,    6,   17,  -12,   11,   -3,   -3,    9,   -6,    2,   -4,  -27,   -4,  -19,  -11,    4,
+     -25,   31,   20,   -8,  -30,   10,    9,   -6,    0,  -15,  -15,  -41,  -19,   25,   11,  -17,
+       8,   35,   10,   22,  -14,  -15,  -21,   21,   -6,  -23,   20,   -1,    0,   18,   24,    6,
+      23,   -7,   49,    6,   15,  -69,   20,    1,    3,    6,  -18,   27,   11,   -7,  -13,   28,
+     -11,  -36,   13,   20,    3,   -4,   -7,   -6,  -13,   15,   18,  -30,   15,   14,   32,   44,
+      -5,   -4,  -29,   -1,   28,   15,  -14,   23,   -8,  -13,   -5,   -8,    4,   10,  -28,   15,
+     -17,   42,   39,   31,    2,   31,  -13,  -30,    4,  -30,   -6,   -7,   24,   21,   -3,    9,
+      23,    8,  -25,    4,   24,  -28,    1,   12,   16,    7,  -16,  -27,    1,  -29,   -8,   -4,
+      43,    5,    2,    8,   -7,   25,  -25,    6,    0,  -38,  -26,  -48,   -4,   -5,  -19,   15,
+      -2,   22,   20,   50,  -26,   12,   41,   10,   12,   28,    1,   -4,   11,  -24,  -10,  -31,
+      16,   16,  -27,    3,  -12,    2,   33,   29,    6,  -13,   28,   25,  -18,   10,  -36,   28,
+      11,    1,  -28,   23,  -14,   20,    3,  -16,    3,  -37,   13,   34,  -12,  -19,    5,  -11,
+      12,    9,    2,  -25,    8,   19,   -6,  -17,  -10,  -15,   18,    8,   17,  -17,  -13,    7,
+     -27,   -2,  -21,   23,  -24,  -28,   25,   13,  -16,  -18,   35,  -21,  -33,  -13,    8,    6,
+     -24,  -35,    9,    7,  -44,   27,    1,   18,   13,  -14,   22,   54,   25,   33,   31,   -8,
+      15,   -3,   -1,   30,    5,  -16,   -2,    6,  -14,   -4,   13,    4,    2,    3,   22,   -2,
+      16,  -24,   -2,  -28,   38,    1,   14,   -9,  -12,   16,  -17,  -21,  -51,  -13,  -11,  -20,
+       8,   -6,  -20,  -17,   25,  -29,  -15,   18,  -16,  -21,   41,   -7,  -37,   14,  -14,  -62,
+      10,    7,    1,  -26,   -1,  -25,   45,  -32,   21,   -1,   12,   -6,   -1,    1,  -18,  -16,
+       7,   10,   14,   -4,   15,  -29,   47,    3,  -17,    3,    0,   -9,   -5,  -20,   11,  -24,
+      33,  -29,   21,   14,   -7,    9,  -25,  -14,  -27,   -7,  -10,  -11,   22,    7,   33,   27,
+      47,   -3,  -10,  -25,   16,  -20,    9,   14,  -16,    7,  -24,   29,    8,    0,  -17,  -29,
+      11,   25,   -4,  -36,  -11,    6,   22,   -1,   -7,   -9,   24,   -3,   51,  -11,   13,   36,
+      -7,   25,  -14,  -60,   -2,  -19,   18,  -14,  -36,    5,   28,   25,   17,   -4,   -4,  -29,
+      -6,  -24,  -16,  -33,   -1,   19,   -9,  -22,   -7,    7,  -12,  -26,  -31,   15,    9,   -4,
+       3,  -13,  -14,   13,    7,   31,   28,    5,    2,   16,   -6,    2,   22,   -1,   23,    6,
+      32,   -6,    1,  -14,   25,  -16,   25,   13,  -30,    7,    9,   14,  -10,  -31,   -7,    3,
+     -17,    8,   -3,   12,   -6,   26,  -15,   11,   14,  -18,    9,   -4,   16,  -18,  -16,   -2,
+      25,  -23,   -2,   10,  -20,  -16,   -9,   -7,   11,  -24,    4,   40,    7,  -34,    7,  -24,
+      16,  -18,   46,  -36,    4,  -43,   -5,    8,  -31,   -4,    6,  -32,   -8,    9,    1,    5,
+      -1,    0,   17,  -10,    2,   26,  -15,   26,  -12,   -8,  -23,  -33,   47,  -41,   -7,   -7,
+     -25,   -8,  -26,  -23,  -32,   32,   15,  -15,  -12,    1,   16,  -27,   20,   27,   -7,   14,
+     -20,   -2,   17,  -10,   19,  -28,   12,  -11,  -62,    4,   -6,  -23,   30,    9,  -17,   -5,
+     -24,  -24,  -11,  -13,   10,   34,    8,    0,   -2,   33,   15,  -44,   -9,    6,   -9,  -23,
+       2,  -27,  -13,  -15,   24,   11,    7,    3,  -16,  -11,   32,   17,   25,   11,  -24,   20,
+       0,   12,    1,   37,  -18,   -4,   20,  -44,  -30,   13,    1,   -9,   -2,   43,   18,  -15,
+       4,   10,   -6,    5,  -24,  -15,   -2,   13,    6,  -20,   23,    6,   35,   25,  -12,  -27,
+     -28,   17,   30,  -14,   -3,   14,  -12,  -51,  -20,   -5,   -2,   23,   12,  -37,    5,  -23,
+     -16,    8,   52,   -2,   12,   18,  -12,   -7,   25,  -16,  -14,   -8,    7,   35,   30,   17,
+      -2,  -22,   31,   -1,   32,  -19,   22,   -6,  -35,  -17,    8,   53,  -37,   15,   19,  -24,
+     -28,   56,   17,  -20,   37,   17,   25,  -27,   -4,    8,   -8,    1,  -13,   17,  -38,   37,
+     -63,    8,   -6,    9,   12,   -1,   -9,  -10,  -15,   13,   17,  -11,   13,  -26,  -24,    9,
+      10,   18,  -22,  -19,    7,    0,  -35,   80,   13,  -57,  -28,    2,  -21,   21,   13,   -8,
+     -14,  -22,   -5,  -48,  -26,  -18,   23,   36,   16,    7,  -14,  -28,  -13,  -24,   -3,  -11,
+      -5,   20,   32,   12,    7,  -39,   28,   21,   -1,   17,    5,  -31,   11,  -20,   23,   17,
+       1,   30,   -4,   16,   18,  -17,   -3,  -24,  -34,   46,   14,  -13,   29,    9,    4,   21,
+      41,  -26,  -40,   -8,   -9,  -24,   19,   59,  -22,  -26,  -41,  -17,  -45,   10,  -10,   -8,
+      -7,  -25,  -19,  -15,   30,    7,   15,    1,    3,   27,   18,  -27,  -12,   13,   48,   24,
+     -17,  -24,   -6,   10,   24,   31,   -8,   36,    2,   35,    2,  -19,   19,    6,   28,  -26,
+     -27,   43,  -35,    7,  -11,   21,    2,   -9,   10,  -11,  -16,    1,  -10,  -43,    4,   14,
+       1,  -12,   12,  -20,   -1,   -9,  -12,    4,  -27,  -16,  -12,  -18,   -3,   39,  -33,   26,
+       9,   20,  -21,   41,   19,  -10,   -2,  -20,    6,  -21,  -12,  -23,    6,  -12,   39,    9,
+};
+static const q7_t gabTinyCnnConv2Bias[16] = {
+       2,    6,   48,    6,  -76,  -57,   -2,  -24,  -59,  -47,    4,  -38,    6,   36,   92,   69,
+};
+
+// fc, interleaved for arm_fully_connected_q7_opt
+static const q7_t gabTinyCnnFcWeights[2560] __attribute__((aligned(NNRT_ALIGNMENT))) = {
+      26,   50,   -4,   28,  -17,   60,  -32,  -13,   16,   26,  -39,   13,   12,  -16,  -28,    0,
+       7,   -8,   26,    6,   37,    4,   -6,  -31,   15,  -25,   28,   11,  -28,  -10,  -32,  -15,
+       6,   51,  -27,   48,   21,    2,   11,   36,   13,   17,  -25,  -19,  -25,   36,   -4,  -11,
+      -2,   38,   21,  -23,   12,    4,   16,  -45,   11,   29,   16,    4,  -10,   44,  -39,    1,
+       2,  -25,   15,   -2,  -19,  -31,   31,    9,    3,  -27,    3,   -6,   16,    1,   13,  -20,
+       2,  -54,    2,  -22,   13,    7,   39,   -3,    7,  -29,   14,  -25,   -3,   19,  -10,   -5,
+      18,   37,   -9,    8,   19,   31,   21,    5,   21,    6,  -20,   19,  -13,   -2,   11,   11,
+      11,   -2,  -14,  -30,   25,  -11,  -18,    1,  -45,    0,   -6,  -16,  -24,  -20,   34,  -17,
+     -18,  -18,  -11,  -24,   -4,   35,   10,  -23,   -4,   39,  -19,  -12,  -21,   -5,   12,   17,
+     -12,   -4,    9,  -14,    0,  -26,   18,  -22,   26,   -1,  -22,    2,    3,   -9,  -54,  -30,
+      -8,  -30,  -46,   32,   -5,   -9,  -25,   -2,    5,  -11,  -64,  -19,    1,  -15,   -8,    0,
+      26,   -3,   20,  -26,   10,    8,   14,  -33,    5,  -11,  -25,  -53,   28,   17,  -22,   23,
+      50,   -7,  -42,   18,   16,  -15,   38,  -56,  -62,   -5,   -2,  -28,   12,   47,   16,  -25,
+      37,  -13,   16,  -24,  -24,   37,  -43,   22,   -6,   10,   -2,  -14,    2,   15,   -1,   14,
+      27,    5,   20,    3,   38,   -5,   21,  -27,   -9,    3,    6,  -23,    0,  -26,    7,   -3,
+       8,   10,  -21,    4,   27,   21,  -14,  -28,   17,   -8,    5,   10,   51,   42,   23,   -5,
+      -9,    1,  -42,   15,   28,   12,   20,    3,  -12,   -1,  -11,   24,    4,  -32,  -27,  -25,
+      -4,   14,  -51,    9,   30,   42,   -7,  -22,    6,   16,   52,    6,  -10,  -20,   -2,   -8,
+     -21,  -31,  -17,   25,   -8,  -12,   10,    5,   25,   21,  -46,   30,   23,   24,   10,   -4,
+      20,   -9,   -3,   32,   36,  -38,    2,    6,  -36,   17,   -4,  -29,   11,   -5,  -12,  -20,
+     -17,    4,   16,  -29,  -34,    7,    5,  -41,   37,   11,    7,  -37,   -9,    8,  -14,   23,
+     -18,   10,    4,   -9,   -9,  -17,   10,  -12,   29,   -4,  -45,   48,   20,  -43,  -46,  -17,
+      21,   12,    8,   16,    9,   -1,   17,   51,   -4,  -22,   -7,   12,  -10,  -25,  -28,   45,
+      20,   17,  -23,  -33,    3,   -5,   -9,  -19,   25,  -23,   -6,   22,   22,  -12,   -1,    7,
+      -3,   14,   25,  -11,  -28,  -41,  -16,   16,   10,   13,   24,  -26,  -13,   22,   12,   49,
+     -17,   -9,  -12,    7,  -17,  -30,    8,   11,   -3,  -37,   -3,   22,   -5,  -33,   66,   27,
+       0,    5,   -5,   -2,    5,  -19,  -19,   -2,  -28,  -36,   -5,   -8,   -9,  -19,   14,   26,
+      35,   26,   35,   -8,   25,  -23,  -73,    8,  -44,  -33,  -48,  -10,   -5,  -43,   23,   12,
+      -8,   -7,  -14,   -6,   13,  -26,   27,   14,   -6,    1,  -18,    9,   37,  -41,   16,   25,
+      16,   45,   36,   -1,   22,  -17,  -15,   -8,   -7,  -30,  -36,    0,  -21,   16,    0,  -24,
+      54,   27,   -8,  -26,  -14,   48,   -7,  -13,  -10,   33,   11,  -18,   41,   21,   26,   -1,
+      -2,    5,    1,    6,   12,  -16,   26,  -15,   -6,   -6,   10,    3,   29,    2,   23,  -21,
+      21,    6,  -15,   15,  -29,  -13,   36,  -14,   -5,  -32,    8,   -8,    2,  -21,   -8,   35,
+      -6,   60,   -3,    4,  -19,   33,  -49,    2,  -20,    9,   -1,   20,   22,   23,  -30,  -26,
+       2,    5,   24,   24,   31,   14,    1,   22,   16,   -7,   17,   44,    6,    3,   14,    3,
+     -39,   19,   -5,   20,   -2,    1,    6,  -11,    2,   41,   -3,  -13,   79,   -6,  -39,  -23,
+      39,  -22,   35,    1,   18,  -23,  -39,   22,   45,   16,   26,   12,   30,   21,   24,   14,
+     -23,   16,    7,   17,    8,   -9,   -6,    7,  -36,   -7,  -10,   25,   -9,   19,   30,   20,
+      22,   -8,   36,  -11,   51,   31,   14,   33,   -6,   12,   -2,   -4,    6,   30,   48,   -5,
+       8,  -18,  -18,    1,  -19,   33,    8,   -3,    6,   28,   26,    7,  -39,   12,   -6,    9,
+       4,   12,   14,  -57,  -10,    7,  -45,   -3,   -8,  -40,   10,  -20,  -19,   -5,  -43,    2,
+     -26,  -26,  -16,  -62,  -12,   22,   10,   -2,  -45,  -38,    8,   11,    8,  -58,  -15,    7,
+      13,   -2,  -32,   46,   25,    6,  -25,  -32,  -17,   47,   -5,  -21,   -6,  -28,  -33,    4,
+      -6,    3,   -2,   -2,  -27,   23,  -50,    5,   52,   23,  -24,  -34,  -65,  -28,  -15,  -34,
+      -4,   16,    6,   32,   21,  -72,   -4,  -25,    8,  -33,   26,    4,  -26,  -25,  -26,  -52,
+      10,    4,  -51,  -19,   -8,   31,   36,   -1,  -12,   -6,   -3,  -20,   -2,   23,   16,   -3,
+     -17,   41,    3,   11,    5,   -3,   10,   22,   43,   -7,   15,   24,   14,  -20,   31,   17,
+       3,  -19,    2,  -19,    0,   -9,   24,  -55,  -32,   17,   54,   32,  -16,  -21,    6,  -16,
+      32,   17,   12,  -23,   -3,    1,    2,   -4,   36,   59,   -4,  -28,   -3,  -19,   11,   29,
+      14,   14,   46,   22,  -31,  -36,  -40,    9,   17,  -37,   -3,   -5,   19,  -29,    3,    1,
+      -3,  -38,  -22,   -3,   30,  -18,  -26,   -2,  -24,  -11,   14,    9,  -23,    9,   67,   16,
+     -20,   -1,    0,   45,   11,   26,    3,  -39,   19,  -10,    5,    1,  -31,   14,   11,   13,
+     -13,   -6,  -25,   63,  -12,   -7,   -9,   -9,   35,    8,   24,  -14,   14,   -6,  -27,    0,
+      -7,   20,  -21,  -21,   10,   34,   20,  -45,  -31,   16,    0,   22,    3,    3,  -34,  -34,
+      16,   55,  -35,  -13,   17,  -25,   -9,   -2,  -26,   -9,   -2,    4,  -27,   19,    2,   -2,
+     -22,   -4,  -36,    8,  -33,   30,  -14,   14,   44,   -6,  -12,   34,   -6,  -18,    4,   15,
+      15,   13,    7,   -4,  -22,    1,   26,   16,   22,   -8,   10,  -16,   -7,   22,   64,   -2,
+      -6,  -33,   13,   -8,   17,  -35,   -6,  -11,  -20,  -55,  -11,   18,  -20,  -18,   11,    3,
+      -4,   -2,    7,  -52,  -16,  -17,   -8,  -23,   21,  -11,    3,  -18,   14,   -5,  -19,   -8,
+     -22,   -9,   -7,   31,   20,   14,  -11,   29,  -18,   18,    0,  -19,  -18,  -33,    0,   -1,
+     -13,   19,  -35,   13,   -2,   27,  -18,  -22,  -17,    9,   67,   -1,  -27,  -14,   15,   16,
+     -16,    1,   16,   -1,    3,  -23,   -6,   -1,   -3,   12,  -19,    4,  -18,   12,   -5,   13,
+       7,  -28,  -16,   -8,   10,   11,    2,   13,  -25,  -34,  -48,   40,  -27,   15,   24,   -8,
+       3,  -34,   -9,  -22,  -43,   -8,   26,   -9,   26,  -17,   39,  -20,   13,  -15,    8,   -7,
+      22,   29,    7,   17,   29,   11,   13,  -11,  -35,    8,   -9,   35,   -7,   10,   15,  -20,
+     -13,   34,   -7,   17,  -22,  -21,   18,  -21,   31,  -16,   19,   44,  -40,   22,   -3,   36,
+      25,  -42,   26,  -26,   25,  -15,   56,  -18,   26,   20,   -5,    3,  -22,    4,   16,    4,
+      -2,   16,   23,   20,   15,    3,   -4,   21,   11,  -28,   -7,   11,  -20,  -36,  -20,   30,
+     -15,  -25,  -15,  -22,   12,  -25,   10,  -14,   11,   25,   29,    3,   10,   37,   -9,   -7,
+     -25,   35,  -62,  -28,   -7,    9,    4,  -35,  -28,  -47,   23,  -39,   -7,  -22,  -17,  -34,
+     -14,   27,  -32,    3,   18,  -23,   38,   42,   10,   18,   17,   18,    9,  -39,    9,   29,
+     -14,   -7,  -24,   24,  -18,  -57,   33,   -8,  -43,   15,   16,   -5,  -43,   19,  -28,   14,
+      -7,  -44,   42,  -15,   32,  -26,   28,    3,   -4,  -19,  -21,   18,  -46,  -37,   27,   30,
+      14,    3,   14,  -18,   45,   36,  -23,   15,  -21,  -14,  -27,  -19,   53,    8,  -24,   17,
+     -19,   -6,  -17,    2,   -3,  -10,  -24,  -12,  -59,   15,    8,  -33,  -28,   -8,   32,   14,
+      14,   23,  -23,   13,   21,   49,  -17,   20,   19,  -25,    8,   22,   34,   28,   -5,   10,
+     -50,   46,  -28,  -37,   11,    8,    6,   20,   23,  -21,   48,  -16,   -1,    6,   16,   29,
+     -16,   24,  -13,   -6,   36,    2,    7,  -18,   15,  -30,   -2,   -1,   31,   -4,    3,   -7,
+      18,    1,  -26,    6,   29,  -33,   14,  -16,  -13,    4,   -1,    2,   -7,   30,  -10,  -13,
+      20,  -23,   22,   25,   15,  -27,   25,  -45,   26,   -6,   24,   22,   10,   26,   -3,  -25,
+      48,  -24,    0,   21,    0,   -5,   30,   -6,   28,   29,   11,   40,   -1,  -15,   13,  -22,
+      23,  -29,    5,    9,   13,  -30,   44,   -9,   28,    7,  -11,  -25,   12,  -51,    0,  -30,
+       2,  -21,   20,   -7,    7,   -5,  -10,  -22,   13,   21,  -23,  -22,    6,   20,  -43,    7,
+     -10,  -26,    1,  -47,   -7,   15,   14,   27,   14,    2,   19,   21,   16,  -32,   61,   14,
+      18,  -12,   -9,   28,  -35,   25,  -18,  -38,    9,   -7,  -11,   45,   17,  -21,    9,  -19,
+      10,   -7,   10,  -18,    2,   28,  -32,    2,   10,   -6,   16,   11,  -27,  -14,  -51,  -40,
+     -22,   12,  -53,  -29,  -17,   49,   -8,   25,   -8,   27,  -33,   37,  -23,    0,  -41,  -34,
+       6,   24,  -35,   22,  -23,   13,   -6,    1,  -29,   -7,   30,  -30,    0,   30,   51,    7,
+       4,    3,   10,   18,   -1,    4,   -7,    8,   30,  -13,   -2,   -4,   11,  -21,   22,  -44,
+      24,  -54,   21,    8,    0,   -8,   13,   16,  -20,   21,   16,   -7,   10,  -38,  -32,   -1,
+      39,   10,  -16,   26,  -61,  -31,  -11,   26,  -14,  -18,   21,   -8,  -31,    4,  -26,   -4,
+     -11,   15,   11,   18,  -27,   23,    9,   -5,   -2,  -28,  -32,   26,   18,  -26,   -4,   40,
+      21,  -29,   30,   -1,   10,   11,    7,  -21,   39,  -14,  -25,   36,   -1,  -24,  -16,   18,
+       3,  -17,  -32,   -6,   -9,  -23,  -29,    7,   22,  -15,   23,  -22,  -13,  -36,    6,   -8,
+       8,  -28,  -32,   10,  -19,   39,   -6,   13,   -5,  -20,   -8,  -16,   -8,  -14,   -3,  -46,
+     -19,  -24,   33,   24,   18,  -17,   -7,    8,   18,    6,  -18,  -20,    6,    1,   47,   31,
+      28,  -11,    0,  -19,  -44,    0,   -2,   15,  -50,  -12,   -9,   -7,   40,   -9,   35,  -20,
+      26,   27,   19,  -39,   14,   18,    0,    8,   -3,    4,   13,  -35,   14,   -9,    7,   15,
+      23,   -7,   -6,   54,   32,   10,   43,  -29,  -44,  -32,   -6,  -46,  -19,   31,  -14,   -2,
+      24,   -7,  -21,   11,   -4,   25,    8,  -42,   42,  -20,  -36,   -3,  -19,  -28,  -22,  -17,
+     -32,   -6,  -16,   -4,  -43,  -20,   -4,   21,  -22,  -17,  -32,   -6,  -18,  -32,    0,  -37,
+     -11,  -24,  -30,   -6,  -24,   13,  -27,    0,   23,   21,    5,  -49,   20,   12,    6,    4,
+       5,    2,    2,   14,   27,   -1,   11,   42,  -11,  -12,  -13,  -16,   28,  -20,    2,    6,
+      -4,    6,   15,   -5,   38,  -14,   19,   21,   24,   20,   32,    9,  -55,   41,   31,   -5,
+       4,  -20,  -38,   -1,  -18,   15,  -25,    1,   12,  -12,  -20,    2,  -15,   14,    9,   12,
+     -22,  -39,  -42,   -5,   23,  -30,   -4,  -25,  -15,    9,    1,   -7,    6,  -10,   33,    4,
+       1,  -12,    2,    5,   18,    2,   11,   36,    9,  -13,   11,    7,   15,  -15,    1,   20,
+     -12,   12,   -9,  -22,   -9,   -7,  -14,   -9,   -6,   48,   16,    8,   22,   -3,   -4,   10,
+      13,  -20,   -1,    1,  -12,  -16,   30,  -15,   -3,   24,  -35,  -41,   28,   -4,  -14,  -24,
+     -35,   28,   33,   -7,  -31,   21,   21,  -11,    2,   16,   -3,    9,  -24,   -5,    4,    1,
+       6,   12,  -11,   -7,    6,  -46,  -12,    8,   22,    6,  -15,    3,  -24,    0,   43,    9,
+      22,  -11,  -52,    6,  -10,   -5,   -1,  -29,   27,    0,   -6,    3,    5,   -4,   33,    9,
+     -25,  -14,   -5,  -46,   -6,   -6,  -10,  -37,  -15,  -56,  -10,  -45,   44,   18,   20,   23,
+       8,  -29,   -6,    4,   22,   13,  -28,  -21,   -3,   -5,   16,   40,  -32,  -28,   13,   -1,
+     -12,    2,   10,  -10,  -14,  -38,  -30,   13,   33,    0,   -9,   19,    3,   -3,   32,   25,
+      -2,  -13,   14,    8,   26,   17,   19,   -7,  -13,   65,  -17,  -22,  -11,   11,  -31,   -5,
+      18,  -56,   15,   12,   44,   55,   18,   -2,   22,   -8,   19,   13,   26,    7,  -14,   55,
+     -19,   22,   -1,  -27,   -8,    9,   15,  -42,  -48,    3,    8,   16,    5,    6,  -14,   39,
+      13,  -10,  -25,  -12,  -13,  -31,  -14,    1,   -7,    1,  -23,  -26,   14,   28,  -20,    9,
+     -21,   -3,  -25,   -8,  -13,   -4,  -24,   29,  -21,   -8,   12,  -53,  -16,  -21,   21,  -13,
+       9,   38,   17,  -38,   11,   20,   20,  -11,  -31,   14,   31,  -19,   10,   13,  -16,   -9,
+      -3,  -17,  -12,  -27,   38,   -3,  -21,   11,    1,   12,  -15,  -17,   12,  -25,  -14,   35,
+      -3,  -12,  -13,  -40,    7,  -27,   -2,    1,   26,   25,   35,   18,   15,   34,  -18,   26,
+     -21,    7,   11,  -35,   46,   -2,   11,  -18,   -6,    4,   59,    3,  -16,   -9,  -35,   -3,
+       0,  -12,   17,    3,  -29,   26,  -17,   41,   19,  -10,  -23,  -29,  -32,   46,    4,  -21,
+     -16,   38,  -40,   -3,    1,  -15,   13,  -24,   28,   12,  -17,  -23,  -17,   15,   23,  -54,
+      -7,    4,   20,   12,  -35,   13,   -3,   27,   -8,    9,    9,    5,  -33,  -30,   19,  -21,
+     -50,   -5,   -6,   13,   45,  -23,  -19,   11,   20,    3,   -1,    1,    5,   20,    8,   -6,
+      37,  -28,  -35,   25,  -21,  -10,    2,  -23,   17,   35,    4,    9,   10,  -27,  -47,  -11,
+      25,   -1,    3,  -23,   -9,  -57,  -21,    5,  -16,  -26,    5,   -6,  -15,   43,    2,    3,
+     -35,   18,   17,   37,  -27,  -22,   15,   -3,   24,  -18,    2,   45,  -14,    7,  -15,   15,
+      -2,   25,   -7,   12,   51,   18,   -4,  -14,  -20,    1,   37,   18,   17,  -30,   13,   10,
+      32,   15,   29,   21,  -47,   -4,   -2,    8,   10,   25,  -15,   -5,  -48,    8,   12,    1,
+      25,  -14,  -21,   12,  -18,   26,   27,    3,   -4,    1,   22,   -6,  -14,  -32,   35,    8,
+     -12,    7,  -21,   20,   42,    5,   -7,    3,   15,  -42,   14,    0,    7,  -54,  -25,  -25,
+      36,    1,   24,   17,  -21,   34,  -15,   -3,   27,  -27,   45,    6,  -56,   -2,  -28,  -23,
+      -5,    0,  -19,  -17,    2,   17,  -25,  -26,    8,    6,   14,   -9,   46,  -23,   -3,   29,
+     -15,   23,  -14,  -13,  -20,   -2,   -2,    1,   14,    7,   17,  -25,    7,    5,  -53,   -3,
+       0,  -13,   -1,  -11,    3,   -5,    4,   16,  -35,   44,  -22,   25,    4,    2,    7,  -20,
+       0,  -11,   21,    0,    6,   -3,    6,  -16,  -22,   -4,  -19,  -32,   16,  -29,   15,  -14,
+      -5,   28,   33,  -14,   29,  -15,  -48,   -7,  -45,   11,  -20,   39,    0,   25,  -11,   11,
+      36,  -36,    8,  -31,    2,    1,  -13,    9,   16,   40,    4,    2,   19,  -15,  -13,   21,
+      38,   20,  -28,   23,    1,  -32,   19,  -15,    3,   49,    5,   21,  -19,  -30,  -39,   -6,
+     -23,   11,    0,   -5,  -17,   52,   -7,  -24,   -4,  -24,   22,   -2,   13,   51,   30,  -21,
+       7,  -26,   -4,   14,  -31,  -15,    4,  -44,   -9,  -30,    4,   -2,  -10,   -5,    4,    1,
+      -7,  -29,   23,  -14,   -7,  -23,   32,   30,  -24,   13,  -24,   13,    7,   12,   20,  -10,
+      -5,  -22,    3,   26,   18,   22,   10,   -2,   -3,  -20,    8,  -14,  -39,   17,  -14,   -1,
+      18,  -18,   16,   29,    4,   10,    5,  -28,  -16,   32,   21,   -2,  -23,   34,   -5,   17,
+       0,  -15,    1,   12,   -2,    1,    7,   -5,    1,   43,    9,   10,   42,    1,  -12,  -12,
+     -25,    3,    7,   24,   17,  -20,    9,  -16,   27,  -23,   -1,    9,  -18,   22,   15,    7,
+      23,   -7,  -21,   -3,    3,  -25,   12,  -31,   -8,   13,    1,  -22,   -2,   13,  -19,    4,
+      -8,   46,   -1,   35,    4,  -10,   -6,   -9,  -42,   -3,   -1,   33,   27,   18,   13,    3,
+       4,  -32,    1,  -29,  -41,   22,   23,   13,    6,   26,  -20,  -19,   -8,   12,   16,   13,
+      -6,  -17,   13,  -39,   11,   -9,    9,   20,    6,  -45,   20,    4,   15,   -8,  -15,   -4,
+       7,    0,  -31,   33,    9,  -16,   22,  -32,   22,   56,   -1,    2,  -26,  -14,   26,   35,
+      -4,   35,  -38,   -1,   30,  -37,  -31,  -18,    8,    4,  -15,   -3,  -20,   49,  -17,  -32,
+     -18,    1,   -5,   -2,    7,   -3,   21,  -21,    4,    4,   12,   -2,   10,  -19,   29,   -8,
+      -4,   32,  -44,  -15,  -30,   56,    7,  -22,  -25,    7,   18,   33,  -12,   14,    3,  -43,
+      -1,  -12,  -14,   53,    6,   18,  -22,  -14,  -13,  -30,   33,   19,   -1,   14,    2,  -35,
+     -39,    2,   31,   33,    9,  -33,   27,  -44,   -6,  -52,   24,    9,  -35,  -21,   16,   25,
+};
+static const q7_t gabTinyCnnFcBias[10] = {
+       0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+};
+
+static uint8_t gabTinyCnnArena[TINYCNN_ARENA_SIZE] __attribute__((aligned(NNRT_ALIGNMENT)));
+
+static nnrt_tensor_t gasTinyCnnTensors[7] = {
+    {16, 3},
+    {16, 8},
+    {8, 8},
+    {8, 16},
+    {4, 16},
+    {1, 10},
+    {1, 10},
+};
+
+static nnrt_layer_t gasTinyCnnLayers[8] = {
+    {.szName     = "conv1",
+     .nKind      = NNRT_KIND_CONV,
+     .bInput     = 0,
+     .bOutput    = 1,
+     .bKernel    = 5,
+     .bStride    = 1,
+     .bPadding   = 2,
+     .bBiasShift = 4,
+     .bOutShift  = 9,
+     .pbWeights  = gabTinyCnnConv1Weights,
+     .pbBias     = gabTinyCnnConv1Bias},
+    {.szName  = "relu1",
+     .nKind   = NNRT_KIND_RELU,
+     .bInput  = 1,
+     .bOutput = 1},
+    {.szName   = "pool1",
+     .nKind    = NNRT_KIND_MAXPOOL,
+     .bInput   = 1,
+     .bOutput  = 2,
+     .bKernel  = 2,
+     .bStride  = 2,
+     .bPadding = 0},
+    {.szName     = "conv2",
+     .nKind      = NNRT_KIND_CONV,
+     .bInput     = 2,
+     .bOutput    = 3,
+     .bKernel    = 3,
+     .bStride    = 1,
+     .bPadding   = 1,
+     .bBiasShift = 2,
+     .bOutShift  = 8,
+     .pbWeights  = gabTinyCnnConv2Weights,
+     .pbBias     = gabTinyCnnConv2Bias},
+    {.szName  = "relu2",
+     .nKind   = NNRT_KIND_RELU,
+     .bInput  = 3,
+     .bOutput = 3},
+    {.szName   = "pool2",
+     .nKind    = NNRT_KIND_AVEPOOL,
+     .bInput   = 3,
+     .bOutput  = 4,
+     .bKernel  = 2,
+     .bStride  = 2,
+     .bPadding = 0},
+    {.szName     = "fc",
+     .nKind      = NNRT_KIND_FC_OPT,
+     .bInput     = 4,
+     .bOutput    = 5,
+     .bBiasShift = 0,
+     .bOutShift  = 7,
+     .pbWeights  = gabTinyCnnFcWeights,
+     .pbBias     = gabTinyCnnFcBias},
+    {.szName  = "softmax",
+     .nKind   = NNRT_KIND_SOFTMAX,
+     .bInput  = 5,
+     .bOutput = 6},
+};
+
+static nnrt_model_t gsTinyCnn = {
+    .szName      = "tinycnn",
+    .psTensors   = gasTinyCnnTensors,
+    .dwTensors   = 7,
+    .psLayers    = gasTinyCnnLayers,
+    .dwLayers    = 8,
+    .bInput      = 0,
+    .bOutput     = 6,
+    .pbArena     = gabTinyCnnArena,
+    .dwArenaSize = TINYCNN_ARENA_SIZE,
+};
+
+// --- Functions ---
+
+nnrt_model_t *TINYCNN_GetModel(void)
+{
+    return &gsTinyCnn;
+}
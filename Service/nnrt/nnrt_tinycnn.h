@@ -0,0 +1,28 @@
+#ifndef __NNRT_TINYCNN_H__
+#define __NNRT_TINYCNN_H__
+
+#include "nnrt.h"
+
+// --- Definitions ---
+
+/*
+ * Generated by Tools/nnrt_convert.py from tinycnn.json, do not edit.
+ * The input is q7 with 7 fraction bits: write round(x * 2^7), saturated.
+ */
+
+#define TINYCNN_INPUT_DIM        16
+#define TINYCNN_INPUT_CHANNELS   3
+#define TINYCNN_INPUT_FRAC_BITS  7
+#define TINYCNN_OUTPUTS          10
+#define TINYCNN_OUTPUT_FRAC_BITS 7
+#define TINYCNN_ARENA_SIZE       3116
+
+// --- Functions ---
+
+/**
+ * @brief Get the tinycnn model, its weights in flash and its arena in RAM
+ * @retval Model to pass to NNRT_Init
+ */
+nnrt_model_t *TINYCNN_GetModel(void);
+
+#endif    // __NNRT_TINYCNN_H__
@@ -0,0 +1,659 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "pool.h"
+#include "profiler.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define POOL_LINE_SIZE     128
+#define POOL_ALIGNMENT     8
+
+// Free-list head: index of the first free block in the low half, update tag in the high half
+#define POOL_INDEX_MASK    0x0000FFFFUL
+#define POOL_INDEX_NONE    POOL_INDEX_MASK
+#define POOL_TAG_ONE       0x00010000UL
+
+// Alloc/free pairs timed per pool by POOL_Benchmark
+#define POOL_BENCH_ROUNDS  1000
+
+#ifdef FW_DEBUG
+// Stress run of POOL_Benchmark: tasks and an interrupt allocating and freeing at once, each holding a few blocks
+#define POOL_STRESS_TASKS      3        // One RTOS_TASK_DEFINE each below
+#define POOL_STRESS_HOLDERS    (POOL_STRESS_TASKS + 1)
+#define POOL_STRESS_MS         500      // How long the tasks run
+#define POOL_STRESS_IRQ_ROUNDS 8        // Per interrupt
+#define POOL_STRESS_HOLD       4
+#define POOL_STRESS_SIGNATURE  0x5A5A0000UL
+#define POOL_STRESS_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+#define POOL_STRESS_TIMEOUT_MS 10000
+#endif
+
+#define POOL_CHECK(dwSize, dwCount)                                                            \
+    _Static_assert((dwSize) % POOL_ALIGNMENT == 0, "pool block size must be a multiple of 8"); \
+    _Static_assert((dwCount) > 0 && (dwCount) < POOL_INDEX_NONE, "pool block count out of range");
+#define POOL_STORAGE(dwSize, dwCount) \
+    static uint8_t gabPool##dwSize[(dwSize) * (dwCount)] __attribute__((aligned(POOL_ALIGNMENT)));
+#define POOL_DESCRIPTOR(dwSize, dwCount) {.pbStorage = gabPool##dwSize, .dwBlockSize = (dwSize), .dwBlocks = (dwCount)},
+#define POOL_SEEN(dwSize, dwCount)       uint32_t adwPool##dwSize[((dwCount) + 31) / 32];
+
+// --- Types ---
+
+typedef struct pool
+{
+    uint8_t *pbStorage;
+    uint32_t dwBlockSize;
+    uint32_t dwBlocks;
+
+    // Only accessed through atomics, free blocks hold the index of the next one in their first word
+    uint32_t dwHead;
+    uint32_t dwUsed;
+    uint32_t dwHighWater;
+    uint32_t dwAllocations;
+    uint32_t dwFailures;
+} pool_t;
+
+typedef struct pool_timing
+{
+    uint32_t dwMin;
+    uint32_t dwMean;
+} pool_timing_t;
+
+// One bit per block of the largest pool, for POOL_Check
+typedef union pool_seen
+{
+    POOL_CLASSES(POOL_SEEN)
+} pool_seen_t;
+
+#ifdef FW_DEBUG
+// A task or the interrupt of the stress run, each only touches its own
+typedef struct pool_holder
+{
+    uint32_t *apdwBlocks[POOL_STRESS_HOLD];
+    uint32_t dwSignature;    // Written into every block held, checked before it is freed
+    uint32_t dwRound;
+    uint32_t dwCorrupted;    // Blocks found overwritten or refused by POOL_Free
+    uint32_t adwAllocations[POOL_ID_MAX];
+    uint32_t adwFailures[POOL_ID_MAX];
+} pool_holder_t;
+
+typedef struct pool_stress
+{
+    bool fCreated;
+    volatile bool fRunning;           // The interrupt only takes part while it is set
+    SemaphoreHandle_t xDone;          // Given by each task at the end of its rounds
+    TaskHandle_t axTasks[POOL_STRESS_TASKS];
+    pool_holder_t asHolders[POOL_STRESS_HOLDERS];    // The tasks, then the interrupt
+} pool_stress_t;
+#endif
+
+// --- Global Variables ---
+
+POOL_CLASSES(POOL_CHECK)
+POOL_CLASSES(POOL_STORAGE)
+
+static pool_t gasPools[POOL_ID_MAX] = {POOL_CLASSES(POOL_DESCRIPTOR)};
+
+static bool gfInitDone = false;
+
+#ifdef FW_DEBUG
+static pool_stress_t gsStress = {0};
+
+RTOS_TASK_DEFINE(pool_stress0, POOL_STRESS_STACK_SIZE);
+RTOS_TASK_DEFINE(pool_stress1, POOL_STRESS_STACK_SIZE);
+RTOS_TASK_DEFINE(pool_stress2, POOL_STRESS_STACK_SIZE);
+RTOS_SEMAPHORE_DEFINE(pool_stress);
+#endif
+
+// --- Static Functions ---
+
+/**
+ * @brief Unlink the first free block
+ * @param psPool - Pool to take from
+ * @retval Block, NULL if the pool is exhausted
+ */
+static void *POOL_Pop(pool_t *psPool)
+{
+    uint32_t dwHead  = __atomic_load_n(&psPool->dwHead, __ATOMIC_ACQUIRE);
+    uint32_t dwNext  = 0;
+    uint8_t *pbBlock = NULL;
+
+    do
+    {
+        if ((dwHead & POOL_INDEX_MASK) == POOL_INDEX_NONE)
+        {
+            return NULL;
+        }
+
+        // The block may be taken and overwritten before the swap, the tag makes the swap fail then
+        pbBlock = psPool->pbStorage + (dwHead & POOL_INDEX_MASK) * psPool->dwBlockSize;
+        dwNext  = ((dwHead + POOL_TAG_ONE) & ~POOL_INDEX_MASK) |
+                 (__atomic_load_n((uint32_t *)pbBlock, __ATOMIC_RELAXED) & POOL_INDEX_MASK);
+    } while (!__atomic_compare_exchange_n(&psPool->dwHead, &dwHead, dwNext, true, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_ACQUIRE));
+
+    return pbBlock;
+}
+
+/**
+ * @brief Link a block back in as the first free one
+ * @param psPool - Pool the block belongs to
+ * @param dwIndex - Index of the block in the pool
+ */
+static void POOL_Push(pool_t *psPool, uint32_t dwIndex)
+{
+    uint32_t *pdwBlock = (uint32_t *)(psPool->pbStorage + dwIndex * psPool->dwBlockSize);
+    uint32_t dwHead    = __atomic_load_n(&psPool->dwHead, __ATOMIC_RELAXED);
+    uint32_t dwNew     = 0;
+
+    do
+    {
+        __atomic_store_n(pdwBlock, dwHead & POOL_INDEX_MASK, __ATOMIC_RELAXED);
+        dwNew = ((dwHead + POOL_TAG_ONE) & ~POOL_INDEX_MASK) | dwIndex;
+    } while (!__atomic_compare_exchange_n(&psPool->dwHead, &dwHead, dwNew, true, __ATOMIC_RELEASE,
+                                          __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief Take a block and update the usage counters
+ * @param psPool - Pool to take from
+ * @retval Block, NULL if the pool is exhausted
+ */
+static void *POOL_Take(pool_t *psPool)
+{
+    void *pvBlock      = POOL_Pop(psPool);
+    uint32_t dwUsed    = 0;
+    uint32_t dwHighest = 0;
+
+    if (pvBlock == NULL)
+    {
+        __atomic_add_fetch(&psPool->dwFailures, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    __atomic_add_fetch(&psPool->dwAllocations, 1, __ATOMIC_RELAXED);
+    dwUsed    = __atomic_add_fetch(&psPool->dwUsed, 1, __ATOMIC_RELAXED);
+    dwHighest = __atomic_load_n(&psPool->dwHighWater, __ATOMIC_RELAXED);
+    while (dwUsed > dwHighest &&
+           !__atomic_compare_exchange_n(&psPool->dwHighWater, &dwHighest, dwUsed, true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED))
+    {
+    }
+
+    return pvBlock;
+}
+
+/**
+ * @brief Take every free block of a pool, check it and give it back
+ * @param psPool - Pool to check
+ * @retval true if the free list held exactly the unused blocks, each once, in range and on a block boundary
+ */
+static bool POOL_Check(pool_t *psPool)
+{
+    uint32_t dwExpected = psPool->dwBlocks - __atomic_load_n(&psPool->dwUsed, __ATOMIC_RELAXED);
+    uint32_t *pdwSeen   = NULL;
+    uint32_t dwTaken    = 0;
+    uint32_t dwIndex    = 0;
+    uint32_t dwOffset   = 0;
+    uint32_t dwChain    = POOL_INDEX_NONE;
+    uint8_t *pbBlock    = NULL;
+    bool fOk            = true;
+    pool_seen_t uSeen   = {0};
+
+    // 1) Drain the free list, chaining the blocks through their second word
+    pdwSeen = (uint32_t *)&uSeen;
+    while ((pbBlock = POOL_Pop(psPool)) != NULL)
+    {
+        dwOffset = (uint32_t)(pbBlock - psPool->pbStorage);
+        if (pbBlock < psPool->pbStorage || dwOffset % psPool->dwBlockSize != 0 ||
+            dwOffset / psPool->dwBlockSize >= psPool->dwBlocks || dwTaken >= psPool->dwBlocks)
+        {
+            return false;
+        }
+
+        // A block listed twice is only a miscount unless it is caught here
+        dwIndex = dwOffset / psPool->dwBlockSize;
+        fOk     = fOk && (pdwSeen[dwIndex / 32] & (1UL << (dwIndex % 32))) == 0;
+        pdwSeen[dwIndex / 32] |= 1UL << (dwIndex % 32);
+
+        ((uint32_t *)pbBlock)[1] = dwChain;
+        dwChain                  = dwIndex;
+        dwTaken++;
+    }
+
+    fOk = fOk && (dwTaken == dwExpected);
+
+    // 2) Give everything back
+    while (dwChain != POOL_INDEX_NONE)
+    {
+        dwIndex = dwChain;
+        dwChain = ((uint32_t *)(psPool->pbStorage + dwIndex * psPool->dwBlockSize))[1];
+        POOL_Push(psPool, dwIndex);
+    }
+
+    return fOk;
+}
+
+/**
+ * @brief Time alloc/free pairs of one pool and of pvPortMalloc with the same size
+ * @param psPool - Pool to time
+ * @param psPoolTiming - Returns the pool timing
+ * @param psHeap - Returns the heap timing
+ */
+static void POOL_Time(pool_t *psPool, pool_timing_t *psPoolTiming, pool_timing_t *psHeap)
+{
+    uint64_t qwPoolTotal = 0;
+    uint64_t qwHeapTotal = 0;
+    uint32_t dwStart     = 0;
+    uint32_t dwCycles    = 0;
+    void *pvBlock        = NULL;
+
+    psPoolTiming->dwMin = UINT32_MAX;
+    psHeap->dwMin       = UINT32_MAX;
+
+    for (uint32_t dwRound = 0; dwRound < POOL_BENCH_ROUNDS; dwRound++)
+    {
+        dwStart = PROFILER_GetCycles();
+        pvBlock = POOL_AllocFrom((pool_id_t)(psPool - gasPools));
+        POOL_Free(pvBlock);
+        dwCycles = PROFILER_GetCycles() - dwStart;
+        qwPoolTotal += dwCycles;
+        psPoolTiming->dwMin = (dwCycles < psPoolTiming->dwMin) ? dwCycles : psPoolTiming->dwMin;
+
+        dwStart = PROFILER_GetCycles();
+        pvBlock = pvPortMalloc(psPool->dwBlockSize);
+        vPortFree(pvBlock);
+        dwCycles = PROFILER_GetCycles() - dwStart;
+        qwHeapTotal += dwCycles;
+        psHeap->dwMin = (dwCycles < psHeap->dwMin) ? dwCycles : psHeap->dwMin;
+    }
+
+    psPoolTiming->dwMean = (uint32_t)(qwPoolTotal / POOL_BENCH_ROUNDS);
+    psHeap->dwMean       = (uint32_t)(qwHeapTotal / POOL_BENCH_ROUNDS);
+}
+
+#ifdef FW_DEBUG
+/**
+ * @brief One stress round: give back the block of the next slot, then take one from the next pool in turn
+ * @param psHolder - Task or interrupt doing the round
+ */
+static void POOL_StressRound(pool_holder_t *psHolder)
+{
+    uint32_t dwSlot    = psHolder->dwRound % POOL_STRESS_HOLD;
+    pool_id_t nPool    = (pool_id_t)((psHolder->dwRound / POOL_STRESS_HOLD + psHolder->dwSignature) % POOL_ID_MAX);
+    uint32_t *pdwBlock = psHolder->apdwBlocks[dwSlot];
+
+    psHolder->dwRound++;
+
+    // 1) A block handed out twice shows up as a signature overwritten by the other holder
+    if (pdwBlock != NULL)
+    {
+        if (pdwBlock[1] != psHolder->dwSignature || POOL_Free(pdwBlock) != NHNS_STATUS_OK)
+        {
+            psHolder->dwCorrupted++;
+        }
+        psHolder->apdwBlocks[dwSlot] = NULL;
+    }
+
+    // 2) The 512-byte pool runs dry with every holder full, so failures are exercised too
+    pdwBlock = POOL_AllocFrom(nPool);
+    if (pdwBlock == NULL)
+    {
+        psHolder->adwFailures[nPool]++;
+        return;
+    }
+    psHolder->adwAllocations[nPool]++;
+    pdwBlock[1]                  = psHolder->dwSignature;
+    psHolder->apdwBlocks[dwSlot] = pdwBlock;
+}
+
+/**
+ * @brief Give back every block a holder still has
+ * @param psHolder - Task or interrupt of the stress run
+ */
+static void POOL_StressRelease(pool_holder_t *psHolder)
+{
+    for (uint32_t dwSlot = 0; dwSlot < POOL_STRESS_HOLD; dwSlot++)
+    {
+        if (psHolder->apdwBlocks[dwSlot] == NULL)
+        {
+            continue;
+        }
+        if (psHolder->apdwBlocks[dwSlot][1] != psHolder->dwSignature || POOL_Free(psHolder->apdwBlocks[dwSlot]) != NHNS_STATUS_OK)
+        {
+            psHolder->dwCorrupted++;
+        }
+        psHolder->apdwBlocks[dwSlot] = NULL;
+    }
+}
+
+/**
+ * @brief Stress task, runs its rounds each time POOL_Benchmark notifies it
+ * @param pvParameters - Its holder
+ */
+static void POOL_StressTask(void *pvParameters)
+{
+    pool_holder_t *psHolder = pvParameters;
+    TickType_t xStart       = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Equal priorities, so the tick slices the tasks in the middle of their allocs and frees
+        xStart = xTaskGetTickCount();
+        while (xTaskGetTickCount() - xStart < pdMS_TO_TICKS(POOL_STRESS_MS))
+        {
+            POOL_StressRound(psHolder);
+        }
+        POOL_StressRelease(psHolder);
+
+        xSemaphoreGive(gsStress.xDone);
+    }
+}
+
+/**
+ * @brief Run the tasks and the interrupt against the pools at once, then check every pool
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t POOL_Stress(uart_instance_t nID)
+{
+    nhns_status_t nRet     = NHNS_STATUS_OK;
+    pool_holder_t *psIrq   = &gsStress.asHolders[POOL_STRESS_TASKS];
+    UBaseType_t uxPriority = uxTaskPriorityGet(NULL);
+    uint32_t dwRounds      = 0;
+    uint32_t dwAllocations = 0;
+    uint32_t dwFailures    = 0;
+    uint32_t dwCorrupted   = 0;
+    bool fFinished         = true;
+    bool fOk               = true;
+    pool_stats_t asBefore[POOL_ID_MAX];
+    pool_stats_t sAfter;
+    char szLine[POOL_LINE_SIZE];
+    int nLength = 0;
+
+    // 1) The tasks stay blocked between runs, at the caller's priority so the tick slices them
+    if (!gsStress.fCreated)
+    {
+        gsStress.xDone      = RTOS_COUNTING_SEMAPHORE_CREATE(pool_stress, POOL_STRESS_TASKS, 0);
+        gsStress.axTasks[0] = RTOS_TASK_CREATE(pool_stress0, POOL_StressTask, &gsStress.asHolders[0], uxPriority);
+        gsStress.axTasks[1] = RTOS_TASK_CREATE(pool_stress1, POOL_StressTask, &gsStress.asHolders[1], uxPriority);
+        gsStress.axTasks[2] = RTOS_TASK_CREATE(pool_stress2, POOL_StressTask, &gsStress.asHolders[2], uxPriority);
+        gsStress.fCreated   = true;
+    }
+
+    // 2) Fresh holders, and the counters to compare against
+    for (uint32_t dwHolder = 0; dwHolder < POOL_STRESS_HOLDERS; dwHolder++)
+    {
+        gsStress.asHolders[dwHolder]             = (pool_holder_t){0};
+        gsStress.asHolders[dwHolder].dwSignature = POOL_STRESS_SIGNATURE | dwHolder;
+    }
+    for (int nPool = 0; nPool < POOL_ID_MAX; nPool++)
+    {
+        POOL_GetStats((pool_id_t)nPool, &asBefore[nPool]);
+    }
+
+    // 3) Start the interrupt, then the tasks, and wait for the tasks
+    gsStress.fRunning = true;
+    for (uint32_t dwTask = 0; dwTask < POOL_STRESS_TASKS; dwTask++)
+    {
+        xTaskNotifyGive(gsStress.axTasks[dwTask]);
+    }
+    for (uint32_t dwTask = 0; dwTask < POOL_STRESS_TASKS && fFinished; dwTask++)
+    {
+        fFinished = (xSemaphoreTake(gsStress.xDone, pdMS_TO_TICKS(POOL_STRESS_TIMEOUT_MS)) == pdTRUE);
+    }
+
+    // 4) Stop the interrupt, a run it is in the middle of ends before the next tick
+    gsStress.fRunning = false;
+    vTaskDelay(2);
+    POOL_StressRelease(psIrq);
+
+    for (uint32_t dwTask = 0; dwTask < POOL_STRESS_TASKS; dwTask++)
+    {
+        dwRounds += gsStress.asHolders[dwTask].dwRound;
+    }
+    nLength = snprintf(szLine, sizeof(szLine), "pool: stress %u ms, %lu task rounds, %lu interrupt rounds%s\r\n%6s %10s %8s %6s %6s %5s\r\n",
+                       POOL_STRESS_MS, (unsigned long)dwRounds, (unsigned long)psIrq->dwRound, fFinished ? "" : ", TIMEOUT",
+                       "size", "allocs", "failures", "used", "peak", "check");
+    nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+
+    // 5) Per pool: the counters moved by what the holders counted, every block came back and is on the free list once
+    for (int nPool = 0; nPool < POOL_ID_MAX && nRet == NHNS_STATUS_OK; nPool++)
+    {
+        dwAllocations = 0;
+        dwFailures    = 0;
+        for (uint32_t dwHolder = 0; dwHolder < POOL_STRESS_HOLDERS; dwHolder++)
+        {
+            dwAllocations += gsStress.asHolders[dwHolder].adwAllocations[nPool];
+            dwFailures += gsStress.asHolders[dwHolder].adwFailures[nPool];
+        }
+
+        POOL_GetStats((pool_id_t)nPool, &sAfter);
+        fOk = fFinished && sAfter.dwAllocations - asBefore[nPool].dwAllocations == dwAllocations &&
+              sAfter.dwFailures - asBefore[nPool].dwFailures == dwFailures && sAfter.dwUsed == asBefore[nPool].dwUsed &&
+              sAfter.dwHighWater <= sAfter.dwBlocks && POOL_Check(&gasPools[nPool]);
+
+        nLength = snprintf(szLine, sizeof(szLine), "%6lu %10lu %8lu %6lu %6lu %5s\r\n", (unsigned long)sAfter.dwBlockSize,
+                           (unsigned long)dwAllocations, (unsigned long)dwFailures, (unsigned long)sAfter.dwUsed,
+                           (unsigned long)sAfter.dwHighWater, fOk ? "ok" : "FAIL");
+        nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+    }
+
+    // 6) No holder found one of its blocks taken by another
+    for (uint32_t dwHolder = 0; dwHolder < POOL_STRESS_HOLDERS; dwHolder++)
+    {
+        dwCorrupted += gsStress.asHolders[dwHolder].dwCorrupted;
+    }
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "pool: %lu blocks found overwritten or refused by POOL_Free\r\n",
+                           (unsigned long)dwCorrupted);
+        nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+    }
+
+    return nRet;
+}
+#endif
+
+// --- Functions ---
+
+nhns_status_t POOL_Init(void)
+{
+    pool_t *psPool = NULL;
+
+    // 1) Check if module is already initialized
+    if (gfInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Every block links to the next one, the last one ends the list
+    for (int nPool = 0; nPool < POOL_ID_MAX; nPool++)
+    {
+        psPool = &gasPools[nPool];
+        for (uint32_t dwIndex = 0; dwIndex < psPool->dwBlocks; dwIndex++)
+        {
+            *(uint32_t *)(psPool->pbStorage + dwIndex * psPool->dwBlockSize) =
+                (dwIndex + 1 < psPool->dwBlocks) ? dwIndex + 1 : POOL_INDEX_NONE;
+        }
+        __atomic_store_n(&psPool->dwHead, 0, __ATOMIC_RELEASE);
+    }
+
+    gfInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+void *POOL_Alloc(size_t dwSize)
+{
+    void *pvBlock = NULL;
+
+    // Fall back to larger classes when the best fit is exhausted, its failure counter still records it
+    for (int nPool = 0; nPool < POOL_ID_MAX && gfInitDone; nPool++)
+    {
+        if (gasPools[nPool].dwBlockSize < dwSize)
+        {
+            continue;
+        }
+
+        pvBlock = POOL_Take(&gasPools[nPool]);
+        if (pvBlock != NULL)
+        {
+            break;
+        }
+    }
+
+    return pvBlock;
+}
+
+void *POOL_AllocFrom(pool_id_t nPool)
+{
+    if (nPool <= POOL_ID_INVALID || nPool >= POOL_ID_MAX || !gfInitDone)
+    {
+        return NULL;
+    }
+
+    return POOL_Take(&gasPools[nPool]);
+}
+
+nhns_status_t POOL_Free(void *pvBlock)
+{
+    uint8_t *pbBlock  = pvBlock;
+    pool_t *psPool    = NULL;
+    uint32_t dwOffset = 0;
+
+    if (pbBlock == NULL)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 1) Find the owning pool from the address
+    for (int nPool = 0; nPool < POOL_ID_MAX; nPool++)
+    {
+        psPool = &gasPools[nPool];
+        if (pbBlock < psPool->pbStorage || pbBlock >= psPool->pbStorage + psPool->dwBlockSize * psPool->dwBlocks)
+        {
+            continue;
+        }
+
+        // 2) Reject pointers into the middle of a block
+        dwOffset = (uint32_t)(pbBlock - psPool->pbStorage);
+        if (dwOffset % psPool->dwBlockSize != 0)
+        {
+            return NHNS_STATUS_BAD_ADDRESS;
+        }
+
+        // 3) Uncount it before it can be taken again, so dwUsed and the peak never exceed dwBlocks
+        __atomic_sub_fetch(&psPool->dwUsed, 1, __ATOMIC_RELAXED);
+        POOL_Push(psPool, dwOffset / psPool->dwBlockSize);
+
+        return NHNS_STATUS_OK;
+    }
+
+    return NHNS_STATUS_BAD_ADDRESS;
+}
+
+nhns_status_t POOL_GetStats(pool_id_t nPool, pool_stats_t *psStats)
+{
+    pool_t *psPool = NULL;
+
+    // 1) Verify arguments
+    if (nPool <= POOL_ID_INVALID || nPool >= POOL_ID_MAX || psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Counters are read one by one, each is exact but they may be from different moments
+    psPool                 = &gasPools[nPool];
+    psStats->dwBlockSize   = psPool->dwBlockSize;
+    psStats->dwBlocks      = psPool->dwBlocks;
+    psStats->dwUsed        = __atomic_load_n(&psPool->dwUsed, __ATOMIC_RELAXED);
+    psStats->dwHighWater   = __atomic_load_n(&psPool->dwHighWater, __ATOMIC_RELAXED);
+    psStats->dwAllocations = __atomic_load_n(&psPool->dwAllocations, __ATOMIC_RELAXED);
+    psStats->dwFailures    = __atomic_load_n(&psPool->dwFailures, __ATOMIC_RELAXED);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t POOL_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    pool_stats_t sStats;
+    char szLine[POOL_LINE_SIZE];
+    int nLength = 0;
+
+    nLength = snprintf(szLine, sizeof(szLine), "pool:\r\n%6s %6s %6s %6s %10s %8s\r\n", "size", "blocks", "used",
+                       "peak", "allocs", "failures");
+    nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+
+    for (int nPool = 0; nPool < POOL_ID_MAX && nRet == NHNS_STATUS_OK; nPool++)
+    {
+        POOL_GetStats((pool_id_t)nPool, &sStats);
+        nLength = snprintf(szLine, sizeof(szLine), "%6lu %6lu %6lu %6lu %10lu %8lu\r\n",
+                           (unsigned long)sStats.dwBlockSize, (unsigned long)sStats.dwBlocks,
+                           (unsigned long)sStats.dwUsed, (unsigned long)sStats.dwHighWater,
+                           (unsigned long)sStats.dwAllocations, (unsigned long)sStats.dwFailures);
+        nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t POOL_Benchmark(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    pool_timing_t sPool;
+    pool_timing_t sHeap;
+    char szLine[POOL_LINE_SIZE];
+    int nLength = 0;
+    bool fOk    = true;
+
+    if (!gfInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine), "pool: %u alloc/free pairs, %lu ticks/s\r\n%6s %5s %10s %10s %10s %10s\r\n",
+                       POOL_BENCH_ROUNDS, (unsigned long)PROFILER_GetCyclesPerSecond(), "size", "check", "pool min",
+                       "pool mean", "heap min", "heap mean");
+    nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+
+    for (int nPool = 0; nPool < POOL_ID_MAX && nRet == NHNS_STATUS_OK; nPool++)
+    {
+        fOk = POOL_Check(&gasPools[nPool]);
+        POOL_Time(&gasPools[nPool], &sPool, &sHeap);
+
+        nLength = snprintf(szLine, sizeof(szLine), "%6lu %5s %10lu %10lu %10lu %10lu\r\n",
+                           (unsigned long)gasPools[nPool].dwBlockSize, fOk ? "ok" : "FAIL", (unsigned long)sPool.dwMin,
+                           (unsigned long)sPool.dwMean, (unsigned long)sHeap.dwMin, (unsigned long)sHeap.dwMean);
+        nRet    = UART_PrintLine(nID, szLine, nLength, POOL_LINE_SIZE);
+    }
+
+#ifdef FW_DEBUG
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nRet = POOL_Stress(nID);
+    }
+#endif
+
+    return nRet;
+}
+
+#ifdef FW_DEBUG
+void POOL_StressIRQHandler(void)
+{
+    pool_holder_t *psIrq = &gsStress.asHolders[POOL_STRESS_TASKS];
+
+    if (!gsStress.fRunning)
+    {
+        return;
+    }
+
+    for (uint32_t dwRound = 0; dwRound < POOL_STRESS_IRQ_ROUNDS; dwRound++)
+    {
+        POOL_StressRound(psIrq);
+    }
+}
+#endif
@@ -0,0 +1,116 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Fixed-size block pools for buffers that are needed in interrupt context or
+ * on deterministic paths, where pvPortMalloc cannot be used. Each pool is a
+ * lock-free LIFO of equal blocks: alloc and free are a single compare-and-swap
+ * loop on the free-list head, so they take constant time and are safe from
+ * tasks and ISRs of any priority without masking interrupts.
+ *
+ * The head packs the index of the first free block with a tag that changes on
+ * every update, so a pop preempted between reading the head and swapping it
+ * cannot succeed on a list that was modified in the meantime (ABA).
+ */
+
+// Block classes as X(block size in bytes, number of blocks), smallest first. Sizes must be multiples of 8.
+// The 1536-byte blocks are Ethernet frame buffers: ETH_RXBUFNB in the RX ring, up to ETH_TXBUFNB queued for
+// sending and the rest for frames loaned to Service/net and datagrams being filled
+#define POOL_CLASSES(X) \
+    X(32, 32)           \
+    X(128, 16)          \
+    X(512, 8)           \
+    X(1536, 24)
+
+#define POOL_ENUM(dwSize, dwCount) POOL_ID_##dwSize,
+
+typedef enum pool_id
+{
+    POOL_ID_INVALID = -1,
+    POOL_CLASSES(POOL_ENUM)
+    POOL_ID_MAX,
+} pool_id_t;
+
+// --- Types ---
+
+typedef struct pool_stats
+{
+    uint32_t dwBlockSize;
+    uint32_t dwBlocks;
+    uint32_t dwUsed;
+    uint32_t dwHighWater;
+    uint32_t dwAllocations;
+    uint32_t dwFailures;
+} pool_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Thread every pool's blocks onto its free list
+ * @retval Status code indicating operation success or reason for failure
+ * @note Must run before the first allocation, e.g. from main before interrupts are enabled
+ */
+nhns_status_t POOL_Init(void);
+
+/**
+ * @brief Take a block of at least dwSize bytes, callable from tasks and ISRs
+ * @param dwSize - Number of bytes needed
+ * @retval Block aligned to 8 bytes from the smallest class that fits and has one left, NULL if none
+ */
+void *POOL_Alloc(size_t dwSize);
+
+/**
+ * @brief Take a block from a given pool, callable from tasks and ISRs
+ * @param nPool - Pool to allocate from
+ * @retval Block aligned to 8 bytes, NULL if the pool is exhausted
+ */
+void *POOL_AllocFrom(pool_id_t nPool);
+
+/**
+ * @brief Return a block to the pool it came from, callable from tasks and ISRs
+ * @param pvBlock - Block from POOL_Alloc or POOL_AllocFrom, NULL is ignored
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t POOL_Free(void *pvBlock);
+
+/**
+ * @brief Get the usage counters of a pool
+ * @param nPool - Pool to query
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t POOL_GetStats(pool_id_t nPool, pool_stats_t *psStats);
+
+/**
+ * @brief Print the usage of every pool
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t POOL_Dump(uart_instance_t nID);
+
+/**
+ * @brief Exhaust and refill every pool to check its integrity, time alloc/free pairs against pvPortMalloc, then
+ *        in debug builds have three tasks and an interrupt allocate and free at once and check the pools and counters
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note Takes the pools' free blocks for a moment, run it from a low priority task while the system is idle
+ */
+nhns_status_t POOL_Benchmark(uart_instance_t nID);
+
+#ifdef FW_DEBUG
+/**
+ * @brief Interrupt side of the POOL_Benchmark stress run, does nothing outside of it
+ * @note Called every millisecond from the HAL tick interrupt, and from the emulated tick on the host.
+ *       Debug builds only, like the stress run itself
+ */
+void POOL_StressIRQHandler(void);
+#endif
+
+#endif    // __POOL_H__
@@ -0,0 +1,47 @@
+#include "rtos.h"
+
+// --- Global Variables ---
+
+// Kernel-owned tasks, handed over through the hooks below
+RTOS_TASK_DEFINE(idle, configMINIMAL_STACK_SIZE);
+RTOS_TASK_DEFINE(timer, configTIMER_TASK_STACK_DEPTH);
+
+// --- Functions ---
+
+/**
+ * @brief Provide the idle task memory, called by vTaskStartScheduler
+ * @param ppxIdleTaskTCBBuffer - Returns the task control block
+ * @param ppxIdleTaskStackBuffer - Returns the stack
+ * @param puxIdleTaskStackSize - Returns the stack depth in words
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer   = &gsRtos_idle_Task;
+    *ppxIdleTaskStackBuffer = gaxRtos_idle_Stack;
+    *puxIdleTaskStackSize   = RTOS_LENGTH(gaxRtos_idle_Stack);
+}
+
+/**
+ * @brief Provide the timer service task memory, called by vTaskStartScheduler
+ * @param ppxTimerTaskTCBBuffer - Returns the task control block
+ * @param ppxTimerTaskStackBuffer - Returns the stack
+ * @param puxTimerTaskStackSize - Returns the stack depth in words
+ * @note The timer command queue is allocated statically by the kernel itself
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer   = &gsRtos_timer_Task;
+    *ppxTimerTaskStackBuffer = gaxRtos_timer_Stack;
+    *puxTimerTaskStackSize   = RTOS_LENGTH(gaxRtos_timer_Stack);
+}
+
+size_t RTOS_GetHeapAllocations(void)
+{
+    HeapStats_t sStats = {0};
+
+    vPortGetHeapStats(&sStats);
+
+    return sStats.xNumberOfSuccessfulAllocations;
+}
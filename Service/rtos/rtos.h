@@ -0,0 +1,101 @@
+#ifndef __RTOS_H__
+#define __RTOS_H__
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "task.h"
+#include "timers.h"
+
+/*
+ * Kernel objects are declared at file scope with RTOS_*_DEFINE and created
+ * with the matching RTOS_*_CREATE, so their control blocks, stacks and storage
+ * are sized by the compiler and placed in .bss instead of the FreeRTOS heap.
+ *
+ * Every buffer goes to its own ".bss.rtos.<name>.<kind>" input section, which
+ * Tools/memory_report.py lists per object when the firmware is linked. Names
+ * must be plain identifiers; the task and timer names given to the kernel are
+ * the same string.
+ */
+
+// --- Definitions ---
+
+#define RTOS_SECTION(name, kind) __attribute__((section(".bss.rtos." #name "." kind)))
+
+#define RTOS_LENGTH(aArray)      (sizeof(aArray) / sizeof((aArray)[0]))
+
+// --- Tasks ---
+
+/** Stack of dwDepth words and task control block */
+#define RTOS_TASK_DEFINE(name, dwDepth)                                               \
+    static StackType_t gaxRtos_##name##_Stack[(dwDepth)] RTOS_SECTION(name, "stack"); \
+    static StaticTask_t gsRtos_##name##_Task RTOS_SECTION(name, "control")
+
+/** TaskHandle_t, cannot fail as the buffers always exist */
+#define RTOS_TASK_CREATE(name, pfnTask, pvParameters, uxPriority)                                          \
+    xTaskCreateStatic((pfnTask), #name, RTOS_LENGTH(gaxRtos_##name##_Stack), (pvParameters), (uxPriority), \
+                      gaxRtos_##name##_Stack, &gsRtos_##name##_Task)
+
+// --- Queues ---
+
+/** Storage for uxLength items of uxItemSize bytes and queue control block */
+#define RTOS_QUEUE_DEFINE(name, uxLength, uxItemSize)                                                \
+    static uint8_t gabRtos_##name##_Storage[(uxLength)][(uxItemSize)] RTOS_SECTION(name, "storage"); \
+    static StaticQueue_t gsRtos_##name##_Queue RTOS_SECTION(name, "control")
+
+/** QueueHandle_t */
+#define RTOS_QUEUE_CREATE(name)                                                                    \
+    xQueueCreateStatic(RTOS_LENGTH(gabRtos_##name##_Storage), sizeof(gabRtos_##name##_Storage[0]), \
+                       &gabRtos_##name##_Storage[0][0], &gsRtos_##name##_Queue)
+
+// --- Semaphores ---
+
+/** Control block shared by binary, counting and mutex semaphores */
+#define RTOS_SEMAPHORE_DEFINE(name) static StaticSemaphore_t gsRtos_##name##_Semaphore RTOS_SECTION(name, "control")
+
+/** SemaphoreHandle_t */
+#define RTOS_BINARY_SEMAPHORE_CREATE(name) xSemaphoreCreateBinaryStatic(&gsRtos_##name##_Semaphore)
+#define RTOS_MUTEX_CREATE(name)            xSemaphoreCreateMutexStatic(&gsRtos_##name##_Semaphore)
+#define RTOS_RECURSIVE_MUTEX_CREATE(name)  xSemaphoreCreateRecursiveMutexStatic(&gsRtos_##name##_Semaphore)
+#define RTOS_COUNTING_SEMAPHORE_CREATE(name, uxMaxCount, uxInitialCount)                       \
+    xSemaphoreCreateCountingStatic((uxMaxCount), (uxInitialCount), &gsRtos_##name##_Semaphore)
+
+// --- Stream and Message Buffers ---
+
+/** Storage of xSize bytes and buffer control block, for stream and message buffers alike */
+#define RTOS_STREAM_BUFFER_DEFINE(name, xSize)                                             \
+    static uint8_t gabRtos_##name##_Storage[(xSize)] RTOS_SECTION(name, "storage");        \
+    static StaticStreamBuffer_t gsRtos_##name##_StreamBuffer RTOS_SECTION(name, "control")
+
+/** StreamBufferHandle_t */
+#define RTOS_STREAM_BUFFER_CREATE(name, xTriggerLevel)                                                     \
+    xStreamBufferCreateStatic(sizeof(gabRtos_##name##_Storage), (xTriggerLevel), gabRtos_##name##_Storage, \
+                              &gsRtos_##name##_StreamBuffer)
+
+/** MessageBufferHandle_t, each message costs sizeof(configMESSAGE_BUFFER_LENGTH_TYPE) extra bytes */
+#define RTOS_MESSAGE_BUFFER_CREATE(name)                                                   \
+    xMessageBufferCreateStatic(sizeof(gabRtos_##name##_Storage), gabRtos_##name##_Storage, \
+                               &gsRtos_##name##_StreamBuffer)
+
+// --- Software Timers ---
+
+/** Timer control block */
+#define RTOS_TIMER_DEFINE(name) static StaticTimer_t gsRtos_##name##_Timer RTOS_SECTION(name, "control")
+
+/** TimerHandle_t */
+#define RTOS_TIMER_CREATE(name, xPeriod, fAutoReload, pvTimerID, pfnCallback)                               \
+    xTimerCreateStatic(#name, (xPeriod), (fAutoReload), (pvTimerID), (pfnCallback), &gsRtos_##name##_Timer)
+
+// --- Functions ---
+
+/**
+ * @brief Count successful FreeRTOS heap allocations since reset
+ * @retval Number of pvPortMalloc calls that returned memory
+ * @note Kernel objects are meant to be created with the macros above, so this stays 0 through start-up
+ */
+size_t RTOS_GetHeapAllocations(void);
+
+#endif    // __RTOS_H__
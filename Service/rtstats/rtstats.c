@@ -0,0 +1,406 @@
+#include <stddef.h>
+#include <string.h>
+#include "rtstats.h"
+#include "board.h"
+#include "frame.h"
+#include "rtos.h"
+#ifdef NHNS_HOST
+#include <time.h>
+#endif
+
+// --- Definitions ---
+
+#define RTSTATS_TASK_STACK_SIZE (configMINIMAL_STACK_SIZE * 2)
+#define RTSTATS_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+
+// One snapshot more than the long window, so it spans RTSTATS_WINDOW_LONG periods
+#define RTSTATS_HISTORY         (RTSTATS_WINDOW_LONG + 1)
+
+// Loads are reported in 0.01 %
+#define RTSTATS_LOAD_FULL       10000
+
+#define RTSTATS_NAME_LENGTH     (configMAX_TASK_NAME_LEN - 1)
+#define RTSTATS_SUMMARY_SIZE    18
+#define RTSTATS_TASK_SIZE       (10 + RTSTATS_NAME_LENGTH)
+#define RTSTATS_ISR_SIZE        (10 + RTSTATS_NAME_LENGTH)
+#define RTSTATS_FRAME_SIZE                                                           \
+    (FRAME_OVERHEAD + RTSTATS_SUMMARY_SIZE + RTSTATS_MAX_TASKS * RTSTATS_TASK_SIZE + \
+     RTSTATS_ISR_MAX * RTSTATS_ISR_SIZE)
+
+// --- Types ---
+
+typedef struct rtstats_task
+{
+    bool fUsed;
+    bool fSeen;
+    UBaseType_t uxTaskNumber;
+    char szName[configMAX_TASK_NAME_LEN];
+    uint8_t bPriority;
+    uint8_t bState;
+    uint16_t bStackFree;
+    uint32_t adwRunTime[RTSTATS_HISTORY];
+} rtstats_task_t;
+
+typedef struct rtstats_isr_slot
+{
+    // Written by the handler only
+    volatile uint32_t dwTime;
+    volatile uint32_t dwCount;
+
+    uint32_t adwTime[RTSTATS_HISTORY];
+    uint32_t adwCount[RTSTATS_HISTORY];
+} rtstats_isr_slot_t;
+
+typedef struct rtstats_context
+{
+    bool fInitDone;
+    volatile bool fStreaming;
+    uart_instance_t nUART;
+    uint8_t bSequence;
+
+    // Snapshot n lives at index n % RTSTATS_HISTORY
+    uint32_t dwSamples;
+    uint32_t adwTimestamp[RTSTATS_HISTORY];
+    rtstats_task_t asTasks[RTSTATS_MAX_TASKS];
+    rtstats_isr_slot_t asIsrs[RTSTATS_ISR_MAX];
+
+    TaskStatus_t asStatus[RTSTATS_MAX_TASKS];
+    uint8_t abFrame[RTSTATS_FRAME_SIZE];
+} rtstats_context_t;
+
+// --- Global Variables ---
+
+static rtstats_context_t gsRtstats = {0};
+
+RTOS_TASK_DEFINE(rtstats, RTSTATS_TASK_STACK_SIZE);
+
+#ifndef NHNS_HOST
+static TIM_HandleTypeDef gsTimer = {0};
+#endif
+
+static const char *const gaszIsrNames[RTSTATS_ISR_MAX] = {
+    [RTSTATS_ISR_DMA1_STREAM1] = "DMA1_Stream1",
+    [RTSTATS_ISR_DMA1_STREAM3] = "DMA1_Stream3",
+    [RTSTATS_ISR_USART3]       = "USART3",
+    [RTSTATS_ISR_RTC_WKUP]     = "RTC_WKUP",
+    [RTSTATS_ISR_EXTI9_5]      = "EXTI9_5",
+    [RTSTATS_ISR_TIM6_DAC]     = "TIM6_DAC",
+    [RTSTATS_ISR_TIM7]         = "TIM7",
+    [RTSTATS_ISR_ETH]          = "ETH",
+    [RTSTATS_ISR_OTG_FS]       = "OTG_FS",
+    [RTSTATS_ISR_DMA2_STREAM7] = "DMA2_Stream7",
+    [RTSTATS_ISR_DMA2_STREAM0] = "DMA2_Stream0",
+    [RTSTATS_ISR_ADC]          = "ADC",
+    [RTSTATS_ISR_DMA2_STREAM4] = "DMA2_Stream4",
+    [RTSTATS_ISR_EXTI0]        = "EXTI0",
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Share of a window spent in a counter
+ * @param dwDelta - Counter increase over the window
+ * @param dwWindow - Length of the window in counter ticks
+ * @retval Load in 0.01 %
+ */
+static uint16_t RTSTATS_Load(uint32_t dwDelta, uint32_t dwWindow)
+{
+    uint64_t qwLoad = 0;
+
+    if (dwWindow == 0)
+    {
+        return 0;
+    }
+
+    qwLoad = ((uint64_t)dwDelta * RTSTATS_LOAD_FULL) / dwWindow;
+
+    return (qwLoad > RTSTATS_LOAD_FULL) ? RTSTATS_LOAD_FULL : (uint16_t)qwLoad;
+}
+
+/**
+ * @brief Find the slot tracking a task, allocating one for tasks seen for the first time
+ * @param psStatus - Task as reported by the kernel
+ * @retval Slot, NULL if all are taken
+ */
+static rtstats_task_t *RTSTATS_FindTask(const TaskStatus_t *psStatus)
+{
+    rtstats_task_t *psFree = NULL;
+
+    for (int nSlot = 0; nSlot < RTSTATS_MAX_TASKS; nSlot++)
+    {
+        rtstats_task_t *psTask = &gsRtstats.asTasks[nSlot];
+
+        if (psTask->fUsed && psTask->uxTaskNumber == psStatus->xTaskNumber)
+        {
+            return psTask;
+        }
+        if (!psTask->fUsed && psFree == NULL)
+        {
+            psFree = psTask;
+        }
+    }
+
+    // A new task has not run before its creation, so its history starts at zero
+    if (psFree != NULL)
+    {
+        memset(psFree, 0, sizeof(*psFree));
+        psFree->fUsed        = true;
+        psFree->uxTaskNumber = psStatus->xTaskNumber;
+        strncpy(psFree->szName, psStatus->pcTaskName, configMAX_TASK_NAME_LEN - 1);
+    }
+
+    return psFree;
+}
+
+/**
+ * @brief Take a snapshot of every task and ISR counter
+ */
+static void RTSTATS_Sample(void)
+{
+    uint32_t dwIndex        = gsRtstats.dwSamples % RTSTATS_HISTORY;
+    uint32_t dwTotal        = 0;
+    UBaseType_t uxTaskCount = 0;
+
+    // 1) Ask the kernel, this fails if there are more tasks than RTSTATS_MAX_TASKS
+    uxTaskCount = uxTaskGetSystemState(gsRtstats.asStatus, RTSTATS_MAX_TASKS, &dwTotal);
+    if (uxTaskCount == 0)
+    {
+        return;
+    }
+
+    // 2) Record each task's counter, slots of deleted tasks are released
+    for (int nSlot = 0; nSlot < RTSTATS_MAX_TASKS; nSlot++)
+    {
+        gsRtstats.asTasks[nSlot].fSeen = false;
+    }
+
+    for (UBaseType_t uxTask = 0; uxTask < uxTaskCount; uxTask++)
+    {
+        const TaskStatus_t *psStatus = &gsRtstats.asStatus[uxTask];
+        rtstats_task_t *psTask       = RTSTATS_FindTask(psStatus);
+
+        if (psTask == NULL)
+        {
+            continue;
+        }
+
+        psTask->fSeen               = true;
+        psTask->bPriority           = (uint8_t)psStatus->uxCurrentPriority;
+        psTask->bState              = (uint8_t)psStatus->eCurrentState;
+        psTask->bStackFree          = (uint16_t)psStatus->usStackHighWaterMark;
+        psTask->adwRunTime[dwIndex] = psStatus->ulRunTimeCounter;
+    }
+
+    for (int nSlot = 0; nSlot < RTSTATS_MAX_TASKS; nSlot++)
+    {
+        if (!gsRtstats.asTasks[nSlot].fSeen)
+        {
+            gsRtstats.asTasks[nSlot].fUsed = false;
+        }
+    }
+
+    // 3) Record ISR counters
+    for (int nIsr = 0; nIsr < RTSTATS_ISR_MAX; nIsr++)
+    {
+        gsRtstats.asIsrs[nIsr].adwTime[dwIndex]  = gsRtstats.asIsrs[nIsr].dwTime;
+        gsRtstats.asIsrs[nIsr].adwCount[dwIndex] = gsRtstats.asIsrs[nIsr].dwCount;
+    }
+
+    gsRtstats.adwTimestamp[dwIndex] = dwTotal;
+    gsRtstats.dwSamples++;
+}
+
+/**
+ * @brief Build the load report from the latest snapshot and queue it on the UART
+ */
+static void RTSTATS_SendReport(void)
+{
+    uint32_t dwShort      = RTSTATS_WINDOW_SHORT;
+    uint32_t dwLong       = RTSTATS_WINDOW_LONG;
+    uint32_t dwNow        = 0;
+    uint32_t dwShortAt    = 0;
+    uint32_t dwLongAt     = 0;
+    uint32_t dwShortTicks = 0;
+    uint32_t dwLongTicks  = 0;
+    uint8_t *pOut         = gsRtstats.abFrame;
+    uint8_t *pCount       = NULL;
+    uint8_t bTasks        = 0;
+
+    // 1) Windows cannot reach further back than the first snapshot
+    if (gsRtstats.dwSamples < 2)
+    {
+        return;
+    }
+    if (dwShort > gsRtstats.dwSamples - 1)
+    {
+        dwShort = gsRtstats.dwSamples - 1;
+    }
+    if (dwLong > gsRtstats.dwSamples - 1)
+    {
+        dwLong = gsRtstats.dwSamples - 1;
+    }
+
+    dwNow        = (gsRtstats.dwSamples - 1) % RTSTATS_HISTORY;
+    dwShortAt    = (gsRtstats.dwSamples - 1 - dwShort) % RTSTATS_HISTORY;
+    dwLongAt     = (gsRtstats.dwSamples - 1 - dwLong) % RTSTATS_HISTORY;
+    dwShortTicks = gsRtstats.adwTimestamp[dwNow] - gsRtstats.adwTimestamp[dwShortAt];
+    dwLongTicks  = gsRtstats.adwTimestamp[dwNow] - gsRtstats.adwTimestamp[dwLongAt];
+
+    // 2) Header
+    pOut = FRAME_Begin(gsRtstats.abFrame, FRAME_TYPE_RTSTATS, gsRtstats.bSequence++);
+
+    // 3) Summary
+    pOut   = FRAME_Put32(pOut, gsRtstats.adwTimestamp[dwNow]);
+    pOut   = FRAME_Put32(pOut, RTSTATS_COUNTER_HZ);
+    pOut   = FRAME_Put32(pOut, dwShortTicks);
+    pOut   = FRAME_Put32(pOut, dwLongTicks);
+    pCount = pOut;
+    pOut   = FRAME_Put8(pOut, 0);
+    pOut   = FRAME_Put8(pOut, RTSTATS_ISR_MAX);
+
+    // 4) Tasks
+    for (int nSlot = 0; nSlot < RTSTATS_MAX_TASKS; nSlot++)
+    {
+        const rtstats_task_t *psTask = &gsRtstats.asTasks[nSlot];
+
+        if (!psTask->fUsed)
+        {
+            continue;
+        }
+
+        pOut = FRAME_Put8(pOut, (uint8_t)psTask->uxTaskNumber);
+        pOut = FRAME_Put8(pOut, psTask->bPriority);
+        pOut = FRAME_Put8(pOut, psTask->bState);
+        pOut = FRAME_Put16(pOut, RTSTATS_Load(psTask->adwRunTime[dwNow] - psTask->adwRunTime[dwShortAt], dwShortTicks));
+        pOut = FRAME_Put16(pOut, RTSTATS_Load(psTask->adwRunTime[dwNow] - psTask->adwRunTime[dwLongAt], dwLongTicks));
+        pOut = FRAME_Put16(pOut, psTask->bStackFree);
+        pOut = FRAME_PutString(pOut, psTask->szName, RTSTATS_NAME_LENGTH);
+        bTasks++;
+    }
+    *pCount = bTasks;
+
+    // 5) Interrupts
+    for (int nIsr = 0; nIsr < RTSTATS_ISR_MAX; nIsr++)
+    {
+        const rtstats_isr_slot_t *psIsr = &gsRtstats.asIsrs[nIsr];
+
+        pOut = FRAME_Put8(pOut, (uint8_t)nIsr);
+        pOut = FRAME_Put32(pOut, psIsr->adwCount[dwNow] - psIsr->adwCount[dwShortAt]);
+        pOut = FRAME_Put16(pOut, RTSTATS_Load(psIsr->adwTime[dwNow] - psIsr->adwTime[dwShortAt], dwShortTicks));
+        pOut = FRAME_Put16(pOut, RTSTATS_Load(psIsr->adwTime[dwNow] - psIsr->adwTime[dwLongAt], dwLongTicks));
+        pOut = FRAME_PutString(pOut, gaszIsrNames[nIsr], RTSTATS_NAME_LENGTH);
+    }
+
+    // 6) Close and queue, a frame that does not fit is dropped
+    UART_TransmitAsync(gsRtstats.nUART, gsRtstats.abFrame, FRAME_End(gsRtstats.abFrame, pOut));
+}
+
+/**
+ * @brief Sample the counters every RTSTATS_PERIOD_MS and stream the report if enabled
+ * @param pvParameters - Unused
+ */
+static void RTSTATS_Task(void *pvParameters)
+{
+    TickType_t xLastWake = xTaskGetTickCount();
+
+    (void)pvParameters;
+
+    while (1)
+    {
+        vTaskDelayUntil(&xLastWake, pdMS_TO_TICKS(RTSTATS_PERIOD_MS));
+
+        RTSTATS_Sample();
+        if (gsRtstats.fStreaming)
+        {
+            RTSTATS_SendReport();
+        }
+    }
+}
+
+// --- Functions ---
+
+void RTSTATS_TimerInit(void)
+{
+#ifndef NHNS_HOST
+    uint32_t dwTimerClock = HAL_RCC_GetPCLK1Freq();
+
+    // 1) APB1 timers are clocked at twice PCLK1 whenever the bus is divided
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        dwTimerClock *= 2;
+    }
+
+    // 2) Free-running 32-bit up-counter, wraps every 71 minutes at 1 MHz
+    gsTimer.Instance               = STATS_TIM;
+    gsTimer.Init.Prescaler         = dwTimerClock / RTSTATS_COUNTER_HZ - 1;
+    gsTimer.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    gsTimer.Init.Period            = 0xFFFFFFFF;
+    gsTimer.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    gsTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    HAL_TIM_Base_Init(&gsTimer);
+    HAL_TIM_Base_Start(&gsTimer);
+#endif
+}
+
+uint32_t RTSTATS_GetCounter(void)
+{
+#ifdef NHNS_HOST
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (uint32_t)((uint64_t)sNow.tv_sec * RTSTATS_COUNTER_HZ + (uint64_t)sNow.tv_nsec / (1000000000UL / RTSTATS_COUNTER_HZ));
+#else
+    // The HAL tick interrupt is timed from HAL_Init on, before the kernel starts the counter
+    return (gsTimer.Instance != NULL) ? __HAL_TIM_GET_COUNTER(&gsTimer) : 0;
+#endif
+}
+
+nhns_status_t RTSTATS_Init(uart_instance_t nID)
+{
+    // 1) Verify arguments
+    if (nID <= UART_INSTANCE_INVALID || nID >= UART_INSTANCE_MAX)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is already initialized
+    if (gsRtstats.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 3) Start sampling
+    gsRtstats.nUART = nID;
+    RTOS_TASK_CREATE(rtstats, RTSTATS_Task, NULL, RTSTATS_TASK_PRIORITY);
+
+    gsRtstats.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+void RTSTATS_SetStreaming(bool fEnable)
+{
+    gsRtstats.fStreaming = fEnable;
+}
+
+bool RTSTATS_IsStreaming(void)
+{
+    return gsRtstats.fStreaming;
+}
+
+uint32_t RTSTATS_IsrEnter(void)
+{
+    return RTSTATS_GetCounter();
+}
+
+void RTSTATS_IsrExit(rtstats_isr_t nIsr, uint32_t dwStart)
+{
+    if (nIsr <= RTSTATS_ISR_INVALID || nIsr >= RTSTATS_ISR_MAX)
+    {
+        return;
+    }
+
+    gsRtstats.asIsrs[nIsr].dwTime += RTSTATS_GetCounter() - dwStart;
+    gsRtstats.asIsrs[nIsr].dwCount++;
+}
@@ -0,0 +1,97 @@
+#ifndef __RTSTATS_H__
+#define __RTSTATS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+// Run-time counter rate, TIM2 on the target, CLOCK_MONOTONIC on the host
+#define RTSTATS_COUNTER_HZ    1000000UL
+
+// Loads are sampled every period and kept for RTSTATS_WINDOW_LONG periods
+#define RTSTATS_PERIOD_MS     1000
+#define RTSTATS_WINDOW_SHORT  1
+#define RTSTATS_WINDOW_LONG   10
+
+// Tasks beyond this count are left out of the report
+#define RTSTATS_MAX_TASKS     16
+
+/*
+ * Report sent as a FRAME_TYPE_RTSTATS frame (see frame.h), payload fields little-endian:
+ *   u32 timestamp, u32 counter Hz, u32 short window ticks, u32 long window ticks, u8 tasks, u8 ISRs
+ *   per task: u8 number, u8 priority, u8 state, u16 short load, u16 long load, u16 stack free words,
+ *             u8 name length, name
+ *   per ISR:  u8 ID, u32 short window count, u16 short load, u16 long load, u8 name length, name
+ * Loads are in units of 0.01 %.
+ */
+
+typedef enum rtstats_isr
+{
+    RTSTATS_ISR_INVALID = -1,
+    RTSTATS_ISR_DMA1_STREAM1,
+    RTSTATS_ISR_DMA1_STREAM3,
+    RTSTATS_ISR_USART3,
+    RTSTATS_ISR_RTC_WKUP,
+    RTSTATS_ISR_EXTI9_5,
+    RTSTATS_ISR_TIM6_DAC,
+    RTSTATS_ISR_TIM7,
+    RTSTATS_ISR_ETH,
+    RTSTATS_ISR_OTG_FS,
+    RTSTATS_ISR_DMA2_STREAM7,
+    RTSTATS_ISR_DMA2_STREAM0,
+    RTSTATS_ISR_ADC,
+    RTSTATS_ISR_DMA2_STREAM4,
+    RTSTATS_ISR_EXTI0,
+    RTSTATS_ISR_MAX,
+} rtstats_isr_t;
+
+// --- Functions ---
+
+/**
+ * @brief Start the run-time counter, called by the kernel through portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+ */
+void RTSTATS_TimerInit(void);
+
+/**
+ * @brief Read the free-running run-time counter
+ * @retval Counter value in RTSTATS_COUNTER_HZ ticks
+ */
+uint32_t RTSTATS_GetCounter(void);
+
+/**
+ * @brief Create the sampling task
+ * @param nID - UART instance reports are streamed on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t RTSTATS_Init(uart_instance_t nID);
+
+/**
+ * @brief Enable or disable the periodic binary report
+ * @param fEnable - true to stream a frame every RTSTATS_PERIOD_MS
+ */
+void RTSTATS_SetStreaming(bool fEnable);
+
+/**
+ * @brief Check whether the periodic report is enabled
+ * @retval true if streaming
+ */
+bool RTSTATS_IsStreaming(void);
+
+/**
+ * @brief Mark the start of an interrupt handler
+ * @retval Timestamp to hand to RTSTATS_IsrExit
+ */
+uint32_t RTSTATS_IsrEnter(void);
+
+/**
+ * @brief Charge an interrupt handler's time to its source
+ * @param nIsr - Interrupt source
+ * @param dwStart - Timestamp returned by RTSTATS_IsrEnter
+ * @note Time is inclusive, a nested handler is also charged to the one it interrupted
+ */
+void RTSTATS_IsrExit(rtstats_isr_t nIsr, uint32_t dwStart);
+
+#endif    // __RTSTATS_H__
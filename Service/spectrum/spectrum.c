@@ -0,0 +1,697 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "profiler.h"
+#include "spectrum.h"
+
+// --- Definitions ---
+
+#define SPECTRUM_LINE_SIZE       128
+#define SPECTRUM_WINDOW_TERMS    5
+#define SPECTRUM_LOG2_CURVE      22714    // 0.3466 in Q16, log2(1 + m) - m ~ 0.3466 m (1 - m)
+#define SPECTRUM_ADC_SHIFT       11       // q15 frame = (sample - midscale) * window >> 11
+
+// Benchmark: two tones into each path at each size, half-overlapping Hann frames
+#define SPECTRUM_BENCH_MIN_SIZE  64
+#define SPECTRUM_BENCH_MAX_SIZE  1024
+#define SPECTRUM_BENCH_FRAMES    32
+#define SPECTRUM_BENCH_CHUNK     256
+#define SPECTRUM_BENCH_RATE      48000
+#define SPECTRUM_BENCH_TONE1     1000     // Hz, -6.0 dB
+#define SPECTRUM_BENCH_TONE2     7500     // Hz, -40.0 dB
+#define SPECTRUM_BENCH_LEVEL1    -60      // Tenths of a dB
+#define SPECTRUM_BENCH_LEVEL2    -400
+#define SPECTRUM_BENCH_TOLERANCE 10       // Tenths of a dB either way
+
+_Static_assert((SPECTRUM_BENCH_MAX_SIZE & (SPECTRUM_BENCH_MAX_SIZE - 1)) == 0 &&
+                   SPECTRUM_BENCH_MIN_SIZE >= SPECTRUM_MIN_SIZE && SPECTRUM_BENCH_MAX_SIZE <= SPECTRUM_MAX_SIZE,
+               "The benchmark sizes are powers of two the analyzer takes");
+
+// --- Global Variables ---
+
+// Cosine terms a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x) + a4 cos(4x) of each window
+static const float32_t gaafWindowTerms[SPECTRUM_WINDOW_MAX][SPECTRUM_WINDOW_TERMS] = {
+    [SPECTRUM_WINDOW_RECTANGLE]       = {1.0f},
+    [SPECTRUM_WINDOW_HANN]            = {0.5f, 0.5f},
+    [SPECTRUM_WINDOW_HAMMING]         = {0.54f, 0.46f},
+    [SPECTRUM_WINDOW_BLACKMAN_HARRIS] = {0.35875f, 0.48829f, 0.14128f, 0.01168f},
+    [SPECTRUM_WINDOW_FLAT_TOP]        = {0.21557895f, 0.41663158f, 0.277263158f, 0.083578947f, 0.006947368f},
+};
+
+static const char *const gaszWindowNames[SPECTRUM_WINDOW_MAX] = {
+    [SPECTRUM_WINDOW_RECTANGLE]       = "rectangle",
+    [SPECTRUM_WINDOW_HANN]            = "hann",
+    [SPECTRUM_WINDOW_HAMMING]         = "hamming",
+    [SPECTRUM_WINDOW_BLACKMAN_HARRIS] = "blackman-harris",
+    [SPECTRUM_WINDOW_FLAT_TOP]        = "flat top",
+};
+
+// --- Static Functions ---
+
+/**
+ * @brief Write tenths of a dB as text with one decimal
+ * @param szText - At least 12 characters
+ * @param nTenths - Level
+ * @retval szText
+ */
+static const char *SPECTRUM_FormatLevel(char *szText, int32_t nTenths)
+{
+    uint32_t dwMagnitude = (uint32_t)((nTenths < 0) ? -nTenths : nTenths);
+
+    snprintf(szText, 12, "%s%lu.%lu", (nTenths < 0) ? "-" : "", (unsigned long)(dwMagnitude / 10),
+             (unsigned long)(dwMagnitude % 10));
+
+    return szText;
+}
+
+/**
+ * @brief Hundredths of a dB of an integer power, 1000 log10(dwPower), without floating point
+ * @param dwPower - Power, not 0
+ * @retval Level, within 0.03 dB
+ */
+static int32_t SPECTRUM_Hundredths(uint32_t dwPower)
+{
+    uint32_t dwExponent = 31U - __CLZ(dwPower);
+    uint32_t dwMantissa = 0;
+    uint32_t dwLog2     = 0;
+
+    // 1) log2 = exponent + log2(1 + m), m the bits below the leading one as Q16
+    dwMantissa = ((dwExponent >= 16) ? (dwPower >> (dwExponent - 16)) : (dwPower << (16 - dwExponent))) & 0xFFFFU;
+    dwLog2     = (dwExponent << 16) + dwMantissa +
+             ((((dwMantissa * (0x10000U - dwMantissa)) >> 16) * SPECTRUM_LOG2_CURVE) >> 16);
+
+    // 2) 1000 log10(2) = 301.03 per octave
+    return (int32_t)(((uint64_t)dwLog2 * 30103U) / 6553600U);
+}
+
+/**
+ * @brief Level of a bin of the published spectrum
+ * @param psSpectrum - Instance
+ * @param dwBin - Bin
+ * @retval Hundredths of a dB relative to a full-scale sine, SPECTRUM_LEVEL_MIN at least
+ */
+static int32_t SPECTRUM_Level(const spectrum_t *psSpectrum, uint32_t dwBin)
+{
+    int32_t nLevel = SPECTRUM_LEVEL_MIN * 10;
+
+    if (psSpectrum->sConfig.nFormat == SPECTRUM_FORMAT_F32)
+    {
+        float32_t fPower = ((const float32_t *)psSpectrum->pvSpectrum)[dwBin];
+
+        if (fPower > 0.0f)
+        {
+            nLevel = (int32_t)lrintf(1000.0f * log10f(fPower / psSpectrum->fFullScale));
+        }
+    }
+    else
+    {
+        uint32_t dwPower = ((const uint32_t *)psSpectrum->pvSpectrum)[dwBin];
+
+        if (dwPower != 0)
+        {
+            nLevel = SPECTRUM_Hundredths(dwPower) - psSpectrum->nFullScaleLevel;
+        }
+    }
+
+    return (nLevel < SPECTRUM_LEVEL_MIN * 10) ? SPECTRUM_LEVEL_MIN * 10 : nLevel;
+}
+
+/**
+ * @brief Power of a bin of the published spectrum, as a key that orders like the power
+ * @param psSpectrum - Instance
+ * @param dwBin - Bin
+ * @retval Key, non-negative floats order like their bit patterns
+ */
+static uint32_t SPECTRUM_Key(const spectrum_t *psSpectrum, uint32_t dwBin)
+{
+    uint32_t dwKey = 0;
+
+    memcpy(&dwKey, (const uint32_t *)psSpectrum->pvSpectrum + dwBin, sizeof(dwKey));
+
+    return dwKey;
+}
+
+/**
+ * @brief Find the strongest peaks of the published spectrum and hand the result out
+ * @param psSpectrum - Instance
+ * @param dwFrames - Frames in the spectrum
+ */
+static void SPECTRUM_Publish(spectrum_t *psSpectrum, uint32_t dwFrames)
+{
+    spectrum_result_t *psResult = &psSpectrum->sResult;
+    uint32_t adwKeys[SPECTRUM_MAX_PEAKS];
+    uint32_t dwBins  = SPECTRUM_BINS(psSpectrum->sConfig.wSize);
+    uint32_t dwPeaks = 0;
+
+    // 1) Local maxima past DC and short of Nyquist, the strongest kept in order
+    for (uint32_t dwBin = 1; dwBin + 1 < dwBins && psSpectrum->sConfig.bPeaks != 0; dwBin++)
+    {
+        uint32_t dwKey  = SPECTRUM_Key(psSpectrum, dwBin);
+        uint32_t dwSlot = 0;
+
+        if (dwKey <= SPECTRUM_Key(psSpectrum, dwBin - 1) || dwKey < SPECTRUM_Key(psSpectrum, dwBin + 1) ||
+            (dwPeaks == psSpectrum->sConfig.bPeaks && dwKey <= adwKeys[dwPeaks - 1]))
+        {
+            continue;
+        }
+        dwSlot = (dwPeaks < psSpectrum->sConfig.bPeaks) ? dwPeaks++ : dwPeaks - 1;
+        while (dwSlot > 0 && adwKeys[dwSlot - 1] < dwKey)
+        {
+            adwKeys[dwSlot]                = adwKeys[dwSlot - 1];
+            psResult->asPeaks[dwSlot].wBin = psResult->asPeaks[dwSlot - 1].wBin;
+            dwSlot--;
+        }
+        adwKeys[dwSlot]                = dwKey;
+        psResult->asPeaks[dwSlot].wBin = (uint16_t)dwBin;
+    }
+
+    // 2) Each peak's top on the parabola through its level and its neighbours'
+    for (uint32_t dwPeak = 0; dwPeak < dwPeaks; dwPeak++)
+    {
+        spectrum_peak_t *psPeak = &psResult->asPeaks[dwPeak];
+        int32_t nBelow          = SPECTRUM_Level(psSpectrum, psPeak->wBin - 1U);
+        int32_t nLevel          = SPECTRUM_Level(psSpectrum, psPeak->wBin);
+        int32_t nAbove          = SPECTRUM_Level(psSpectrum, psPeak->wBin + 1U);
+        int32_t nCurve          = nBelow - 2 * nLevel + nAbove;
+        int32_t nOffset         = 0;    // 1/256 bin
+
+        if (nCurve < 0)
+        {
+            nOffset = (128 * (nBelow - nAbove)) / nCurve;
+            nOffset = (nOffset > 128) ? 128 : ((nOffset < -128) ? -128 : nOffset);
+            nLevel -= ((nBelow - nAbove) * nOffset) / 1024;
+        }
+
+        psPeak->nLevel      = (int16_t)((nLevel >= 0) ? (nLevel + 5) / 10 : (nLevel - 5) / 10);
+        psPeak->dwFrequency = (uint32_t)((((uint64_t)((int32_t)psPeak->wBin * 256 + nOffset)) *
+                                              psSpectrum->sConfig.dwRate +
+                                          (uint64_t)psSpectrum->sConfig.wSize * 128U) /
+                                         ((uint64_t)psSpectrum->sConfig.wSize * 256U));
+    }
+
+    psResult->bPeaks   = (uint8_t)dwPeaks;
+    psResult->dwFrames = dwFrames;
+    psResult->dwSequence++;
+    if (psSpectrum->sConfig.pfnPublish != NULL)
+    {
+        psSpectrum->sConfig.pfnPublish(psResult, psSpectrum->sConfig.pvContext);
+    }
+}
+
+/**
+ * @brief Window, transform and square the float frame, then average it
+ * @param psSpectrum - Instance, the ring full
+ */
+static void SPECTRUM_FrameF32(spectrum_t *psSpectrum)
+{
+    const float32_t *pfWindow = psSpectrum->pvWindow;
+    float32_t *pfFrame        = psSpectrum->pvFrame;
+    float32_t *pfTransform    = psSpectrum->pvTransform;
+    float32_t *pfAverage      = psSpectrum->pvAverage;
+    uint32_t dwSize           = psSpectrum->sConfig.wSize;
+    uint32_t dwBins           = SPECTRUM_BINS(dwSize);
+    uint32_t dwFull           = 1UL << psSpectrum->sConfig.bShift;
+    float32_t fWeight         = 1.0f / (float32_t)dwFull;
+
+    // 1) Oldest sample first, the midscale taken off and the window's 1/2048 bringing it to full scale 1.0
+    for (uint32_t dwIndex = 0; dwIndex < dwSize; dwIndex++)
+    {
+        int32_t nSample = psSpectrum->pwRing[(psSpectrum->dwPosition + dwIndex) & (dwSize - 1)];
+
+        pfFrame[dwIndex] = (float32_t)(nSample - SPECTRUM_ADC_MIDSCALE) * pfWindow[dwIndex];
+    }
+
+    // 2) Packed output: DC and Nyquist as two reals, then a complex pair per bin in between
+    arm_rfft_fast_f32(&psSpectrum->uFft.sF32, pfFrame, pfTransform, 0);
+    pfFrame[0]          = pfTransform[0] * pfTransform[0];
+    pfFrame[dwBins - 1] = pfTransform[1] * pfTransform[1];
+    arm_cmplx_mag_squared_f32(&pfTransform[2], &pfFrame[1], dwBins - 2);
+
+    // 3) The average: the first frame as is, then a step or a sum
+    for (uint32_t dwBin = 0; dwBin < dwBins; dwBin++)
+    {
+        if (psSpectrum->dwAveraged == 0)
+        {
+            pfAverage[dwBin] = pfFrame[dwBin];
+        }
+        else if (psSpectrum->sConfig.nAverage == SPECTRUM_AVERAGE_EXPONENTIAL)
+        {
+            pfAverage[dwBin] += (pfFrame[dwBin] - pfAverage[dwBin]) * fWeight;
+        }
+        else
+        {
+            pfAverage[dwBin] += pfFrame[dwBin];
+        }
+    }
+    psSpectrum->dwAveraged++;
+
+    // 4) Exponential publishes the running average, Welch the mean of a full set
+    if (psSpectrum->sConfig.nAverage == SPECTRUM_AVERAGE_EXPONENTIAL)
+    {
+        SPECTRUM_Publish(psSpectrum, psSpectrum->dwAveraged);
+    }
+    else if (psSpectrum->dwAveraged == dwFull)
+    {
+        arm_scale_f32(pfAverage, fWeight, psSpectrum->pvSpectrum, dwBins);
+        psSpectrum->dwAveraged = 0;
+        SPECTRUM_Publish(psSpectrum, dwFull);
+    }
+}
+
+/**
+ * @brief Window, transform and square the q15 frame, then average it, all in integers
+ * @param psSpectrum - Instance, the ring full
+ */
+static void SPECTRUM_FrameQ15(spectrum_t *psSpectrum)
+{
+    const q15_t *pwWindow = psSpectrum->pvWindow;
+    q15_t *pwFrame        = psSpectrum->pvFrame;
+    q15_t *pwTransform    = psSpectrum->pvTransform;
+    uint32_t *pdwAverage  = psSpectrum->pvAverage;
+    uint32_t dwSize       = psSpectrum->sConfig.wSize;
+    uint32_t dwBins       = SPECTRUM_BINS(dwSize);
+    uint32_t dwShift      = psSpectrum->sConfig.bShift;
+
+    // 1) Oldest sample first: 12 bits to q15 is << 4, by a q15 window is >> 15
+    for (uint32_t dwIndex = 0; dwIndex < dwSize; dwIndex++)
+    {
+        int32_t nSample = psSpectrum->pwRing[(psSpectrum->dwPosition + dwIndex) & (dwSize - 1)];
+
+        pwFrame[dwIndex] = (q15_t)(((nSample - SPECTRUM_ADC_MIDSCALE) * pwWindow[dwIndex]) >> SPECTRUM_ADC_SHIFT);
+    }
+
+    // 2) Complex pairs for every bin, scaled by 1 / wSize. A q15 pair squared fits 32 bits unsigned
+    arm_rfft_q15(&psSpectrum->uFft.sQ15, pwFrame, pwTransform);
+    for (uint32_t dwBin = 0; dwBin < dwBins; dwBin++)
+    {
+        int32_t nReal    = pwTransform[2 * dwBin];
+        int32_t nImag    = pwTransform[2 * dwBin + 1];
+        uint32_t dwPower = (uint32_t)(nReal * nReal) + (uint32_t)(nImag * nImag);
+
+        // 3) The average: the first frame as is, then a step or a sum of shifted powers that cannot overflow
+        if (psSpectrum->sConfig.nAverage == SPECTRUM_AVERAGE_EXPONENTIAL)
+        {
+            pdwAverage[dwBin] =
+                (psSpectrum->dwAveraged == 0)
+                    ? dwPower
+                    : (uint32_t)((int64_t)pdwAverage[dwBin] + (((int64_t)dwPower - pdwAverage[dwBin]) >> dwShift));
+        }
+        else
+        {
+            pdwAverage[dwBin] = ((psSpectrum->dwAveraged == 0) ? 0 : pdwAverage[dwBin]) + (dwPower >> dwShift);
+        }
+    }
+    psSpectrum->dwAveraged++;
+
+    // 4) Exponential publishes the running average, Welch the mean of a full set
+    if (psSpectrum->sConfig.nAverage == SPECTRUM_AVERAGE_EXPONENTIAL)
+    {
+        SPECTRUM_Publish(psSpectrum, psSpectrum->dwAveraged);
+    }
+    else if (psSpectrum->dwAveraged == (1UL << dwShift))
+    {
+        memcpy(psSpectrum->pvSpectrum, pdwAverage, dwBins * sizeof(uint32_t));
+        psSpectrum->dwAveraged = 0;
+        SPECTRUM_Publish(psSpectrum, 1UL << dwShift);
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t SPECTRUM_Init(spectrum_t *psSpectrum, const spectrum_config_t *psConfig, void *pvStorage,
+                            uint32_t dwStorageSize)
+{
+    const float32_t *pfTerms = NULL;
+    uint8_t *pbStorage       = pvStorage;
+    float32_t fSum           = 0.0f;
+    int32_t nSum             = 0;
+    uint32_t dwSize          = 0;
+    uint32_t dwBins          = 0;
+    uint32_t dwFloatBytes    = 0;
+    arm_status nStatus       = ARM_MATH_SUCCESS;
+
+    // 1) Verify arguments
+    if (psSpectrum == NULL || psConfig == NULL || pvStorage == NULL || ((uintptr_t)pvStorage % 4U) != 0)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    psSpectrum->fInitDone = false;
+    dwSize                = psConfig->wSize;
+    dwBins                = SPECTRUM_BINS(dwSize);
+    if (psConfig->nFormat >= SPECTRUM_FORMAT_MAX || psConfig->nWindow >= SPECTRUM_WINDOW_MAX ||
+        psConfig->nAverage >= SPECTRUM_AVERAGE_MAX || dwSize < SPECTRUM_MIN_SIZE || dwSize > SPECTRUM_MAX_SIZE ||
+        (dwSize & (dwSize - 1)) != 0 || psConfig->wHop == 0 || psConfig->wHop > dwSize || psConfig->bShift > 15 ||
+        psConfig->bPeaks > SPECTRUM_MAX_PEAKS || psConfig->dwRate == 0)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+    if (dwStorageSize < SPECTRUM_STORAGE_BYTES(psConfig->nFormat, dwSize))
+    {
+        return NHNS_STATUS_NO_MEMORY;
+    }
+
+    // 2) Spectra first, then the per-sample arrays, widest to narrowest so each stays aligned
+    memset(psSpectrum, 0, sizeof(*psSpectrum));
+    psSpectrum->sConfig     = *psConfig;
+    dwFloatBytes            = (psConfig->nFormat == SPECTRUM_FORMAT_F32) ? sizeof(float32_t) : sizeof(q15_t);
+    psSpectrum->pvAverage   = pbStorage;
+    psSpectrum->pvSpectrum  = pbStorage + 4U * dwBins;
+    psSpectrum->pvTransform = pbStorage + 8U * dwBins;
+    psSpectrum->pvWindow    = (uint8_t *)psSpectrum->pvTransform + 4U * dwSize;    // wSize floats or 2 * wSize q15
+    psSpectrum->pvFrame     = (uint8_t *)psSpectrum->pvWindow + dwFloatBytes * dwSize;
+    psSpectrum->pwRing      = (uint16_t *)((uint8_t *)psSpectrum->pvFrame + dwFloatBytes * dwSize);
+    if (psConfig->nAverage == SPECTRUM_AVERAGE_EXPONENTIAL)
+    {
+        psSpectrum->pvSpectrum = psSpectrum->pvAverage;
+    }
+
+    // 3) The transform for the size and type
+    if (psConfig->nFormat == SPECTRUM_FORMAT_F32)
+    {
+        nStatus = arm_rfft_fast_init_f32(&psSpectrum->uFft.sF32, (uint16_t)dwSize);
+    }
+    else
+    {
+        nStatus = arm_rfft_init_q15(&psSpectrum->uFft.sQ15, dwSize, 0, 1);
+    }
+    if (nStatus != ARM_MATH_SUCCESS)
+    {
+        return NHNS_STATUS_INVALID_CONFIGURATION;
+    }
+
+    // 4) The periodic window, so that frames hopping by a divisor of the size overlap-add evenly
+    pfTerms = gaafWindowTerms[psConfig->nWindow];
+    for (uint32_t dwIndex = 0; dwIndex < dwSize; dwIndex++)
+    {
+        float32_t fAngle = 2.0f * PI * (float32_t)dwIndex / (float32_t)dwSize;
+        float32_t fValue = pfTerms[0] - pfTerms[1] * cosf(fAngle) + pfTerms[2] * cosf(2.0f * fAngle) -
+                           pfTerms[3] * cosf(3.0f * fAngle) + pfTerms[4] * cosf(4.0f * fAngle);
+
+        if (psConfig->nFormat == SPECTRUM_FORMAT_F32)
+        {
+            ((float32_t *)psSpectrum->pvWindow)[dwIndex] = fValue / (float32_t)SPECTRUM_ADC_MIDSCALE;
+            fSum += fValue;
+        }
+        else
+        {
+            q15_t wValue = (q15_t)__SSAT((int32_t)lrintf(fValue * 32768.0f), 16);
+
+            ((q15_t *)psSpectrum->pvWindow)[dwIndex] = wValue;
+            nSum += wValue;
+        }
+    }
+
+    // 5) A full-scale sine peaks at half the window's sum, scaled down by the size on the q15 path
+    if (psConfig->nFormat == SPECTRUM_FORMAT_F32)
+    {
+        psSpectrum->fFullScale = (fSum / 2.0f) * (fSum / 2.0f);
+    }
+    else
+    {
+        float32_t fPeak = (float32_t)nSum / (2.0f * (float32_t)dwSize);
+
+        psSpectrum->nFullScaleLevel = SPECTRUM_Hundredths((uint32_t)lrintf(fPeak * fPeak));
+    }
+
+    psSpectrum->dwUntilFrame = dwSize;
+    psSpectrum->fInitDone    = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SPECTRUM_Process(spectrum_t *psSpectrum, const uint16_t *pwSamples, uint32_t dwCount)
+{
+    // 1) Verify arguments
+    if (psSpectrum == NULL || (pwSamples == NULL && dwCount != 0))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!psSpectrum->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 3) Into the ring in runs that end at its end or at the next frame, whichever is first
+    while (dwCount != 0)
+    {
+        uint32_t dwSize  = psSpectrum->sConfig.wSize;
+        uint32_t dwChunk = dwSize - psSpectrum->dwPosition;
+
+        dwChunk = (dwChunk < dwCount) ? dwChunk : dwCount;
+        dwChunk = (dwChunk < psSpectrum->dwUntilFrame) ? dwChunk : psSpectrum->dwUntilFrame;
+        memcpy(&psSpectrum->pwRing[psSpectrum->dwPosition], pwSamples, dwChunk * sizeof(uint16_t));
+
+        pwSamples += dwChunk;
+        dwCount -= dwChunk;
+        psSpectrum->dwSamples += dwChunk;
+        psSpectrum->dwPosition = (psSpectrum->dwPosition + dwChunk) & (dwSize - 1);
+        psSpectrum->dwUntilFrame -= dwChunk;
+
+        if (psSpectrum->dwUntilFrame == 0)
+        {
+            uint32_t dwStart  = PROFILER_GetCycles();
+            uint32_t dwCycles = 0;
+
+            if (psSpectrum->sConfig.nFormat == SPECTRUM_FORMAT_F32)
+            {
+                SPECTRUM_FrameF32(psSpectrum);
+            }
+            else
+            {
+                SPECTRUM_FrameQ15(psSpectrum);
+            }
+            dwCycles = PROFILER_GetCycles() - dwStart;
+
+            psSpectrum->dwFrames++;
+            psSpectrum->qwCycles += dwCycles;
+            if (dwCycles > psSpectrum->dwMaxCycles)
+            {
+                psSpectrum->dwMaxCycles = dwCycles;
+            }
+            psSpectrum->dwUntilFrame = psSpectrum->sConfig.wHop;
+        }
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SPECTRUM_GetResult(const spectrum_t *psSpectrum, spectrum_result_t *psResult)
+{
+    // 1) Verify arguments
+    if (psSpectrum == NULL || psResult == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!psSpectrum->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    *psResult = psSpectrum->sResult;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SPECTRUM_GetLevels(const spectrum_t *psSpectrum, int16_t *pnLevels, uint32_t dwBins)
+{
+    // 1) Verify arguments
+    if (psSpectrum == NULL || pnLevels == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!psSpectrum->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    if (dwBins > SPECTRUM_BINS(psSpectrum->sConfig.wSize))
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (uint32_t dwBin = 0; dwBin < dwBins; dwBin++)
+    {
+        int32_t nLevel = SPECTRUM_Level(psSpectrum, dwBin);
+
+        pnLevels[dwBin] = (int16_t)((nLevel >= 0) ? (nLevel + 5) / 10 : (nLevel - 5) / 10);
+    }
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t SPECTRUM_Dump(const spectrum_t *psSpectrum, uart_instance_t nID)
+{
+    const spectrum_config_t *psConfig = NULL;
+    nhns_status_t nRet                = NHNS_STATUS_OK;
+    char szLine[SPECTRUM_LINE_SIZE];
+    char szLevel[12];
+    int nLength = 0;
+
+    // 1) Verify arguments
+    if (psSpectrum == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!psSpectrum->fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+    psConfig = &psSpectrum->sConfig;
+
+    // 3) What runs, what it costs, what it found
+    nLength = snprintf(szLine, sizeof(szLine), "spectrum: %s %u points, hop %u, %s, %s over %lu, %lu Hz\r\n",
+                       (psConfig->nFormat == SPECTRUM_FORMAT_F32) ? "f32" : "q15", psConfig->wSize, psConfig->wHop,
+                       gaszWindowNames[psConfig->nWindow],
+                       (psConfig->nAverage == SPECTRUM_AVERAGE_EXPONENTIAL) ? "exponential" : "welch",
+                       (unsigned long)(1UL << psConfig->bShift), (unsigned long)psConfig->dwRate);
+    nRet    = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine),
+                           "  %lu samples, %lu frames at %lu avg %lu max ticks, %lu published\r\n",
+                           (unsigned long)psSpectrum->dwSamples, (unsigned long)psSpectrum->dwFrames,
+                           (unsigned long)((psSpectrum->dwFrames != 0) ? psSpectrum->qwCycles / psSpectrum->dwFrames : 0),
+                           (unsigned long)psSpectrum->dwMaxCycles, (unsigned long)psSpectrum->sResult.dwSequence);
+        nRet    = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+    }
+    for (uint32_t dwPeak = 0; dwPeak < psSpectrum->sResult.bPeaks && nRet == NHNS_STATUS_OK; dwPeak++)
+    {
+        const spectrum_peak_t *psPeak = &psSpectrum->sResult.asPeaks[dwPeak];
+
+        nLength = snprintf(szLine, sizeof(szLine), "  peak %lu: bin %u, %lu Hz, %s dB\r\n", (unsigned long)dwPeak,
+                           psPeak->wBin, (unsigned long)psPeak->dwFrequency,
+                           SPECTRUM_FormatLevel(szLevel, psPeak->nLevel));
+        nRet    = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t SPECTRUM_Benchmark(uart_instance_t nID)
+{
+    static const int32_t anLevels[2]       = {SPECTRUM_BENCH_LEVEL1, SPECTRUM_BENCH_LEVEL2};
+    static const uint32_t adwFrequencies[2] = {SPECTRUM_BENCH_TONE1, SPECTRUM_BENCH_TONE2};
+    spectrum_t *psSpectrum                  = NULL;
+    uint16_t *pwChunk                       = NULL;
+    void *pvStorage                         = NULL;
+    uint32_t dwStorage                      = SPECTRUM_STORAGE_BYTES(SPECTRUM_FORMAT_F32, SPECTRUM_BENCH_MAX_SIZE);
+    nhns_status_t nRet                      = NHNS_STATUS_OK;
+    nhns_status_t nCheck                    = NHNS_STATUS_OK;
+    char szLine[SPECTRUM_LINE_SIZE];
+    char szLevel1[12];
+    char szLevel2[12];
+    int nLength = 0;
+
+    // 1) Storage for the largest size, the instance and a chunk of samples off the heap
+    psSpectrum = HEAP_Alloc(sizeof(spectrum_t), HEAP_REGION_DEFAULT);
+    pwChunk    = HEAP_Alloc(SPECTRUM_BENCH_CHUNK * sizeof(uint16_t), HEAP_REGION_DEFAULT);
+    pvStorage  = HEAP_Alloc(dwStorage, HEAP_REGION_DEFAULT);
+    if (psSpectrum == NULL || pwChunk == NULL || pvStorage == NULL)
+    {
+        HEAP_Free(psSpectrum);
+        HEAP_Free(pwChunk);
+        HEAP_Free(pvStorage);
+        return NHNS_STATUS_NO_MEMORY;
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine),
+                       "spectrum: hann, hop size/2, %lu Hz, tones %lu Hz at -6.0 dB and %lu Hz at -40.0 dB\r\n",
+                       (unsigned long)SPECTRUM_BENCH_RATE, (unsigned long)SPECTRUM_BENCH_TONE1,
+                       (unsigned long)SPECTRUM_BENCH_TONE2);
+    nRet    = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine),
+                           "   size path  ticks/frame  frames/s    tone 1            tone 2\r\n");
+        nRet    = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+    }
+
+    // 2) Each size on each path, fed the same tones in chunks as the sampler would
+    for (uint32_t dwSize = SPECTRUM_BENCH_MIN_SIZE; dwSize <= SPECTRUM_BENCH_MAX_SIZE && nRet == NHNS_STATUS_OK;
+         dwSize <<= 1)
+    {
+        for (uint32_t dwFormat = 0; dwFormat < SPECTRUM_FORMAT_MAX && nRet == NHNS_STATUS_OK; dwFormat++)
+        {
+            spectrum_config_t sConfig = {
+                .nFormat  = (spectrum_format_t)dwFormat,
+                .nWindow  = SPECTRUM_WINDOW_HANN,
+                .nAverage = SPECTRUM_AVERAGE_EXPONENTIAL,
+                .wSize    = (uint16_t)dwSize,
+                .wHop     = (uint16_t)(dwSize / 2),
+                .bShift   = 3,
+                .bPeaks   = 2,
+                .dwRate   = SPECTRUM_BENCH_RATE,
+            };
+            float32_t afStep[2]  = {2.0f * PI * SPECTRUM_BENCH_TONE1 / SPECTRUM_BENCH_RATE,
+                                    2.0f * PI * SPECTRUM_BENCH_TONE2 / SPECTRUM_BENCH_RATE};
+            float32_t afPrev1[2] = {0.0f, 0.0f};
+            float32_t afPrev2[2] = {-sinf(afStep[0]), -sinf(afStep[1])};
+            const spectrum_result_t *psResult = &psSpectrum->sResult;
+
+            nRet = SPECTRUM_Init(psSpectrum, &sConfig, pvStorage, dwStorage);
+
+            // Sines by recurrence from their two previous values, 2048 and 20.5 counts peak
+            while (nRet == NHNS_STATUS_OK && psSpectrum->dwFrames < SPECTRUM_BENCH_FRAMES)
+            {
+                for (uint32_t dwIndex = 0; dwIndex < SPECTRUM_BENCH_CHUNK; dwIndex++)
+                {
+                    float32_t afSine[2];
+
+                    for (uint32_t dwTone = 0; dwTone < 2; dwTone++)
+                    {
+                        afSine[dwTone]  = 2.0f * cosf(afStep[dwTone]) * afPrev1[dwTone] - afPrev2[dwTone];
+                        afPrev2[dwTone] = afPrev1[dwTone];
+                        afPrev1[dwTone] = afSine[dwTone];
+                    }
+                    pwChunk[dwIndex] =
+                        (uint16_t)__USAT(lrintf(SPECTRUM_ADC_MIDSCALE + 1024.0f * afSine[0] + 20.48f * afSine[1]), 12);
+                }
+                nRet = SPECTRUM_Process(psSpectrum, pwChunk, SPECTRUM_BENCH_CHUNK);
+            }
+            if (nRet != NHNS_STATUS_OK)
+            {
+                break;
+            }
+
+            // 3) Both tones, in order, within a bin and the tolerance
+            for (uint32_t dwTone = 0; dwTone < 2; dwTone++)
+            {
+                const spectrum_peak_t *psPeak = &psResult->asPeaks[dwTone];
+
+                if (psResult->bPeaks <= dwTone ||
+                    (uint32_t)abs((int32_t)psPeak->dwFrequency - (int32_t)adwFrequencies[dwTone]) >
+                        SPECTRUM_BENCH_RATE / dwSize ||
+                    abs(psPeak->nLevel - anLevels[dwTone]) > SPECTRUM_BENCH_TOLERANCE)
+                {
+                    nCheck = NHNS_STATUS_DATA_MISMATCH;
+                }
+            }
+
+            nLength = snprintf(
+                szLine, sizeof(szLine), "  %5lu  %s %11lu %9lu   %5lu Hz %6s dB  %5lu Hz %6s dB\r\n",
+                (unsigned long)dwSize, (dwFormat == SPECTRUM_FORMAT_F32) ? "f32" : "q15",
+                (unsigned long)(psSpectrum->qwCycles / psSpectrum->dwFrames),
+                (unsigned long)((uint64_t)PROFILER_GetCyclesPerSecond() * psSpectrum->dwFrames / psSpectrum->qwCycles),
+                (unsigned long)((psResult->bPeaks > 0) ? psResult->asPeaks[0].dwFrequency : 0),
+                SPECTRUM_FormatLevel(szLevel1, (psResult->bPeaks > 0) ? psResult->asPeaks[0].nLevel : 0),
+                (unsigned long)((psResult->bPeaks > 1) ? psResult->asPeaks[1].dwFrequency : 0),
+                SPECTRUM_FormatLevel(szLevel2, (psResult->bPeaks > 1) ? psResult->asPeaks[1].nLevel : 0));
+            nRet = UART_PrintLine(nID, szLine, nLength, SPECTRUM_LINE_SIZE);
+        }
+    }
+
+    HEAP_Free(psSpectrum);
+    HEAP_Free(pwChunk);
+    HEAP_Free(pvStorage);
+
+    return (nRet == NHNS_STATUS_OK) ? nCheck : nRet;
+}
@@ -0,0 +1,198 @@
+#ifndef __SPECTRUM_H__
+#define __SPECTRUM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "arm_math.h"
+#include "nhns_status_codes.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Averaged power spectra of a stream of 12-bit ADC samples, as SAMPLER_Receive
+ * hands them out. The samples go through a ring of one frame; every wHop
+ * samples the last wSize of them are windowed, transformed and squared into
+ * one power spectrum of wSize / 2 + 1 bins, so frames overlap by wSize - wHop
+ * samples. The spectra are then averaged and published with their strongest
+ * peaks.
+ *
+ * The float path runs arm_rfft_fast_f32. The q15 path runs arm_rfft_q15 and
+ * keeps the powers in 32-bit integers, so a core without an FPU does no
+ * floating point per frame. Its transform scales down by wSize to stay in
+ * range, which leaves about 78 dB between a full-scale sine and one count in
+ * a bin under a Hann window. The window, with the ADC offset and scale folded
+ * in, is computed once by SPECTRUM_Init.
+ *
+ * Exponential averaging moves the average by 2^-bShift of the way to each new
+ * spectrum and publishes after every frame. Welch averaging publishes the
+ * mean of each 2^bShift frames. A shift of 0 publishes every spectrum as is.
+ *
+ * Levels are in tenths of a dB below a full-scale sine, the frequency of each
+ * peak interpolated between bins on a parabola through its neighbours.
+ *
+ * The caller owns the storage, SPECTRUM_STORAGE_BYTES for the format and the
+ * size. An instance is used by one task at a time.
+ */
+
+#define SPECTRUM_MIN_SIZE      32      // FFT points, a power of two
+#define SPECTRUM_MAX_SIZE      4096
+#define SPECTRUM_MAX_PEAKS     8
+#define SPECTRUM_ADC_MIDSCALE  2048    // Sample value of 0 V into the window
+#define SPECTRUM_LEVEL_MIN     -2000   // Tenths of a dB reported for an empty bin
+
+#define SPECTRUM_BINS(wSize) ((uint32_t)(wSize) / 2U + 1U)
+
+// Bytes of storage, 4-byte aligned: the ring, window, frame, transform and two spectra
+#define SPECTRUM_STORAGE_BYTES(nFormat, wSize) \
+    ((((nFormat) == SPECTRUM_FORMAT_F32) ? 14U : 10U) * (uint32_t)(wSize) + 8U * SPECTRUM_BINS(wSize))
+
+// --- Types ---
+
+typedef enum spectrum_format
+{
+    SPECTRUM_FORMAT_F32 = 0,    // arm_rfft_fast_f32, float powers
+    SPECTRUM_FORMAT_Q15,        // arm_rfft_q15, 32-bit integer powers
+    SPECTRUM_FORMAT_MAX,
+} spectrum_format_t;
+
+typedef enum spectrum_window
+{
+    SPECTRUM_WINDOW_RECTANGLE = 0,
+    SPECTRUM_WINDOW_HANN,
+    SPECTRUM_WINDOW_HAMMING,
+    SPECTRUM_WINDOW_BLACKMAN_HARRIS,    // 4 terms, sidelobes below -92 dB
+    SPECTRUM_WINDOW_FLAT_TOP,           // Levels within 0.02 dB between bins, wide peaks
+    SPECTRUM_WINDOW_MAX,
+} spectrum_window_t;
+
+typedef enum spectrum_average
+{
+    SPECTRUM_AVERAGE_EXPONENTIAL = 0,   // Every frame, weight 2^-bShift on the newest
+    SPECTRUM_AVERAGE_WELCH,             // Mean of each 2^bShift frames
+    SPECTRUM_AVERAGE_MAX,
+} spectrum_average_t;
+
+typedef struct spectrum_peak
+{
+    uint16_t wBin;            // Strongest bin of the peak
+    int16_t nLevel;           // Tenths of a dB below full scale
+    uint32_t dwFrequency;     // Hz, interpolated
+} spectrum_peak_t;
+
+typedef struct spectrum_result
+{
+    uint32_t dwSequence;      // Publications since SPECTRUM_Init
+    uint32_t dwFrames;        // Frames in the spectrum, all of them for exponential averaging
+    uint8_t bPeaks;           // Local maxima found, strongest first
+    spectrum_peak_t asPeaks[SPECTRUM_MAX_PEAKS];
+} spectrum_result_t;
+
+typedef void (*spectrum_publish_t)(const spectrum_result_t *psResult, void *pvContext);
+
+typedef struct spectrum_config
+{
+    spectrum_format_t nFormat;
+    spectrum_window_t nWindow;
+    spectrum_average_t nAverage;
+    uint16_t wSize;                 // FFT points, SPECTRUM_MIN_SIZE to SPECTRUM_MAX_SIZE
+    uint16_t wHop;                  // Samples between frames, 1 to wSize
+    uint8_t bShift;                 // Averaging weight or length, 0 to 15
+    uint8_t bPeaks;                 // Peaks to publish, up to SPECTRUM_MAX_PEAKS
+    uint32_t dwRate;                // Samples per second, for the peak frequencies
+    spectrum_publish_t pfnPublish;  // Called with each result, may be NULL
+    void *pvContext;                // Passed to pfnPublish
+} spectrum_config_t;
+
+typedef struct spectrum
+{
+    spectrum_config_t sConfig;
+
+    // Carved from the caller's storage by SPECTRUM_Init
+    uint16_t *pwRing;               // Last wSize samples
+    void *pvWindow;                 // float32_t or q15_t, ADC scale folded in
+    void *pvFrame;                  // Windowed frame, then float powers
+    void *pvTransform;              // RFFT output, wSize floats or 2 * wSize q15
+    void *pvAverage;                // float32_t or uint32_t per bin, being averaged
+    void *pvSpectrum;               // float32_t or uint32_t per bin, last published
+
+    union
+    {
+        arm_rfft_fast_instance_f32 sF32;
+        arm_rfft_instance_q15 sQ15;
+    } uFft;
+
+    float32_t fFullScale;           // Power of a full-scale sine in its bin
+    int32_t nFullScaleLevel;        // Hundredths of a dB of the q15 power of a full-scale sine
+    uint32_t dwPosition;            // Next ring slot, the oldest sample once full
+    uint32_t dwUntilFrame;          // Samples until the next frame
+    uint32_t dwAveraged;            // Frames in pvAverage
+    spectrum_result_t sResult;
+    bool fInitDone;
+
+    // Cost, in PROFILER_GetCycles ticks
+    uint32_t dwSamples;
+    uint32_t dwFrames;
+    uint32_t dwMaxCycles;
+    uint64_t qwCycles;
+} spectrum_t;
+
+// --- Functions ---
+
+/**
+ * @brief Check the configuration, compute the window and carve the storage
+ * @param psSpectrum - Instance to set up
+ * @param psConfig - Configuration, copied
+ * @param pvStorage - SPECTRUM_STORAGE_BYTES(nFormat, wSize) bytes, 4-byte aligned, owned until re-initialised
+ * @param dwStorageSize - Bytes at pvStorage
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_INVALID_CONFIGURATION for a size, hop, shift or peak count out of range,
+ *       NHNS_STATUS_NO_MEMORY for too little storage
+ */
+nhns_status_t SPECTRUM_Init(spectrum_t *psSpectrum, const spectrum_config_t *psConfig, void *pvStorage,
+                            uint32_t dwStorageSize);
+
+/**
+ * @brief Add samples to the stream, computing every frame they complete
+ * @param psSpectrum - Instance
+ * @param pwSamples - 12-bit right-aligned samples, oldest first
+ * @param dwCount - Number of samples
+ * @retval Status code indicating operation success or reason for failure
+ * @note Publishing calls pfnPublish from here
+ */
+nhns_status_t SPECTRUM_Process(spectrum_t *psSpectrum, const uint16_t *pwSamples, uint32_t dwCount);
+
+/**
+ * @brief Get the last published result
+ * @param psSpectrum - Instance
+ * @param psResult - Returns the result, dwSequence 0 until the first publication
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SPECTRUM_GetResult(const spectrum_t *psSpectrum, spectrum_result_t *psResult);
+
+/**
+ * @brief Get the levels of the last published spectrum
+ * @param psSpectrum - Instance
+ * @param pnLevels - Returns tenths of a dB below full scale, bin 0 first
+ * @param dwBins - Bins to fill, up to SPECTRUM_BINS(wSize)
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SPECTRUM_GetLevels(const spectrum_t *psSpectrum, int16_t *pnLevels, uint32_t dwBins);
+
+/**
+ * @brief Print the configuration, the frame cost and the peaks of the last result
+ * @param psSpectrum - Instance
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t SPECTRUM_Dump(const spectrum_t *psSpectrum, uart_instance_t nID);
+
+/**
+ * @brief Check both paths on two tones and print the frames per second each sustains at every size
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note NHNS_STATUS_DATA_MISMATCH when a path misses a tone by more than a bin or its level by more than 1 dB
+ */
+nhns_status_t SPECTRUM_Benchmark(uart_instance_t nID);
+
+#endif    // __SPECTRUM_H__
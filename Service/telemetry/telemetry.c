@@ -0,0 +1,388 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "telemetry.h"
+#include "clock.h"
+#include "frame.h"
+#include "profiler.h"
+#include "rtos.h"
+
+// --- Definitions ---
+
+#define TELEMETRY_LINE_SIZE    128
+
+// Ticks a full TX ring or an empty pool is waited for before samples are dropped
+#define TELEMETRY_TX_RETRIES   10
+
+#define TELEMETRY_BENCH_MS     1000
+#define TELEMETRY_BENCH_SAMPLE 64
+
+// --- Types ---
+
+typedef struct telemetry_context
+{
+    bool fInitDone;
+    SemaphoreHandle_t xLock;
+    TimerHandle_t xTimer;
+
+    net_datagram_t sDatagram;
+    uint32_t dwSequence;
+    uint32_t dwPending;    // Samples in the open datagram
+
+    telemetry_stats_t sStats;
+
+    // Counters at the previous TELEMETRY_Dump, for the rates
+    uint64_t qwDumpTime;
+    uint32_t dwDumpDatagrams;
+    uint32_t dwDumpBytes;
+    uint64_t qwDumpCycles;
+} telemetry_context_t;
+
+// --- Global Variables ---
+
+static telemetry_context_t gsTelemetry = {0};
+
+RTOS_SEMAPHORE_DEFINE(telemetry_lock);
+RTOS_TIMER_DEFINE(telemetry_flush);
+
+// --- Static Functions ---
+
+/**
+ * @brief Open a datagram and write its header, with the lock held
+ * @param dwRetries - Ticks to wait for a free EMAC_POOL block
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t TELEMETRY_Open(uint32_t dwRetries)
+{
+    uint8_t abHeader[TELEMETRY_HEADER_SIZE];
+    uint64_t qwNow     = 0;
+    uint32_t dwStart   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    if (!NET_IsUp())
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 1) Blocks come back as the MAC sends the previous datagrams
+    while (1)
+    {
+        dwStart = PROFILER_GetCycles();
+        nRet    = NET_DatagramBegin(&gsTelemetry.sDatagram);
+        gsTelemetry.sStats.qwCycles += PROFILER_GetCycles() - dwStart;
+
+        if (nRet != NHNS_STATUS_NO_MEMORY || dwRetries == 0)
+        {
+            break;
+        }
+        dwRetries--;
+        vTaskDelay(1);
+    }
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    // 2) Header, timestamped with the first sample
+    dwStart = PROFILER_GetCycles();
+    qwNow   = CLOCK_GetMicros();
+    FRAME_Put32(FRAME_Put32(FRAME_Put32(abHeader, gsTelemetry.dwSequence++), (uint32_t)qwNow), (uint32_t)(qwNow >> 32));
+    gsTelemetry.dwPending = 0;
+    nRet                  = NET_DatagramWrite(&gsTelemetry.sDatagram, abHeader, sizeof(abHeader));
+    gsTelemetry.sStats.qwCycles += PROFILER_GetCycles() - dwStart;
+
+    return nRet;
+}
+
+/**
+ * @brief Send the open datagram, with the lock held
+ * @param dwRetries - Ticks to wait for a TX descriptor before the datagram is dropped
+ * @retval Status code indicating operation success or reason for failure
+ */
+static nhns_status_t TELEMETRY_Send(uint32_t dwRetries)
+{
+    uint16_t wLength   = gsTelemetry.sDatagram.wLength;
+    uint32_t dwStart   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    if (gsTelemetry.sDatagram.pbBlock == NULL)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 1) A full ring drains at wire speed, wait for it a few ticks at most
+    while (1)
+    {
+        dwStart = PROFILER_GetCycles();
+        nRet    = NET_DatagramSend(&gsTelemetry.sDatagram, TELEMETRY_DST_IP, TELEMETRY_DST_PORT, TELEMETRY_SRC_PORT);
+        gsTelemetry.sStats.qwCycles += PROFILER_GetCycles() - dwStart;
+
+        if (nRet != NHNS_STATUS_BUSY || dwRetries == 0)
+        {
+            break;
+        }
+        dwRetries--;
+        vTaskDelay(1);
+    }
+
+    // 2) Account for the samples either way
+    if (nRet == NHNS_STATUS_OK)
+    {
+        gsTelemetry.sStats.dwDatagrams++;
+        gsTelemetry.sStats.dwBytes   += wLength;
+        gsTelemetry.sStats.dwRecords += gsTelemetry.dwPending;
+    }
+    else
+    {
+        gsTelemetry.sStats.dwDropped += gsTelemetry.dwPending;
+        NET_DatagramDiscard(&gsTelemetry.sDatagram);
+    }
+    gsTelemetry.dwPending = 0;
+
+    return nRet;
+}
+
+/**
+ * @brief Flush timer callback, skips a period while a publisher holds the lock
+ * @param xTimer - Unused
+ */
+static void TELEMETRY_FlushTimer(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+
+    // The timer task must not block, a busy ring costs this datagram
+    if (xSemaphoreTake(gsTelemetry.xLock, 0) == pdTRUE)
+    {
+        TELEMETRY_Send(0);
+        xSemaphoreGive(gsTelemetry.xLock);
+    }
+}
+
+// --- Functions ---
+
+nhns_status_t TELEMETRY_Init(void)
+{
+    // 1) Check if module is already initialized
+    if (gsTelemetry.fInitDone)
+    {
+        return NHNS_STATUS_OK;
+    }
+
+    // 2) Publishers share one open datagram
+    gsTelemetry.xLock  = RTOS_MUTEX_CREATE(telemetry_lock);
+    gsTelemetry.xTimer = RTOS_TIMER_CREATE(telemetry_flush, pdMS_TO_TICKS(TELEMETRY_FLUSH_MS), pdTRUE, NULL,
+                                           TELEMETRY_FlushTimer);
+    if (gsTelemetry.xLock == NULL || gsTelemetry.xTimer == NULL)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    // 3) The command is queued until the scheduler starts
+    if (xTimerStart(gsTelemetry.xTimer, 0) != pdPASS)
+    {
+        return NHNS_STATUS_FAIL;
+    }
+
+    gsTelemetry.fInitDone = true;
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t TELEMETRY_Publish(uint16_t wChannel, const void *pvData, uint16_t wLength)
+{
+    uint8_t abRecord[TELEMETRY_RECORD_HEADER];
+    uint32_t dwStart   = 0;
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    // 1) Verify arguments
+    if ((pvData == NULL && wLength != 0) || wLength > TELEMETRY_MAX_SAMPLE)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+
+    // 2) Check if module is initialized
+    if (!gsTelemetry.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    xSemaphoreTake(gsTelemetry.xLock, portMAX_DELAY);
+
+    // 3) Send the open datagram if the sample does not fit behind it
+    if (gsTelemetry.sDatagram.pbBlock != NULL &&
+        NET_DatagramRoom(&gsTelemetry.sDatagram) < TELEMETRY_RECORD_HEADER + wLength)
+    {
+        TELEMETRY_Send(TELEMETRY_TX_RETRIES);
+    }
+
+    if (gsTelemetry.sDatagram.pbBlock == NULL)
+    {
+        nRet = TELEMETRY_Open(TELEMETRY_TX_RETRIES);
+    }
+
+    // 4) Append the record, the checksum is summed as it is copied
+    if (nRet == NHNS_STATUS_OK)
+    {
+        dwStart = PROFILER_GetCycles();
+        FRAME_Put16(FRAME_Put16(abRecord, wChannel), wLength);
+        NET_DatagramWrite(&gsTelemetry.sDatagram, abRecord, sizeof(abRecord));
+        NET_DatagramWrite(&gsTelemetry.sDatagram, pvData, wLength);
+        gsTelemetry.dwPending++;
+        gsTelemetry.sStats.qwCycles += PROFILER_GetCycles() - dwStart;
+    }
+    else
+    {
+        gsTelemetry.sStats.dwDropped++;
+    }
+
+    xSemaphoreGive(gsTelemetry.xLock);
+
+    return nRet;
+}
+
+nhns_status_t TELEMETRY_Flush(void)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+
+    if (!gsTelemetry.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    xSemaphoreTake(gsTelemetry.xLock, portMAX_DELAY);
+    nRet = TELEMETRY_Send(TELEMETRY_TX_RETRIES);
+    xSemaphoreGive(gsTelemetry.xLock);
+
+    return nRet;
+}
+
+nhns_status_t TELEMETRY_GetStats(telemetry_stats_t *psStats)
+{
+    if (psStats == NULL)
+    {
+        return NHNS_STATUS_INVALID_ARGUMENT;
+    }
+    if (!gsTelemetry.fInitDone)
+    {
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    xSemaphoreTake(gsTelemetry.xLock, portMAX_DELAY);
+    *psStats = gsTelemetry.sStats;
+    xSemaphoreGive(gsTelemetry.xLock);
+
+    return NHNS_STATUS_OK;
+}
+
+nhns_status_t TELEMETRY_Dump(uart_instance_t nID)
+{
+    nhns_status_t nRet = NHNS_STATUS_OK;
+    telemetry_stats_t sStats;
+    uint64_t qwNow        = CLOCK_GetMicros();
+    uint32_t dwElapsedMs  = (uint32_t)((qwNow - gsTelemetry.qwDumpTime) / 1000);
+    uint32_t dwDatagrams  = 0;
+    uint32_t dwRate       = 0;
+    uint32_t dwKBps       = 0;
+    uint32_t dwCycles     = 0;
+    uint32_t dwNs         = 0;
+    char szLine[TELEMETRY_LINE_SIZE];
+    int nLength = 0;
+
+    nRet = TELEMETRY_GetStats(&sStats);
+    if (nRet != NHNS_STATUS_OK)
+    {
+        return nRet;
+    }
+
+    // 1) Rates and cost per datagram since the previous dump
+    dwDatagrams = sStats.dwDatagrams - gsTelemetry.dwDumpDatagrams;
+    if (dwElapsedMs != 0)
+    {
+        dwRate = (uint32_t)(((uint64_t)dwDatagrams * 1000) / dwElapsedMs);
+        dwKBps = (sStats.dwBytes - gsTelemetry.dwDumpBytes) / dwElapsedMs;
+    }
+    if (dwDatagrams != 0)
+    {
+        dwCycles = (uint32_t)((sStats.qwCycles - gsTelemetry.qwDumpCycles) / dwDatagrams);
+        dwNs     = (uint32_t)(((uint64_t)dwCycles * 1000000000ULL) / PROFILER_GetCyclesPerSecond());
+    }
+    gsTelemetry.qwDumpTime      = qwNow;
+    gsTelemetry.dwDumpDatagrams = sStats.dwDatagrams;
+    gsTelemetry.dwDumpBytes     = sStats.dwBytes;
+    gsTelemetry.qwDumpCycles    = sStats.qwCycles;
+
+    // 2) Totals, then the rates
+    nLength = snprintf(szLine, sizeof(szLine), "telemetry: %lu datagrams, %lu samples, %lu dropped\r\n",
+                       (unsigned long)sStats.dwDatagrams, (unsigned long)sStats.dwRecords,
+                       (unsigned long)sStats.dwDropped);
+    nRet    = UART_PrintLine(nID, szLine, nLength, TELEMETRY_LINE_SIZE);
+
+    if (nRet == NHNS_STATUS_OK)
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "last %lu ms: %lu datagrams/s, %lu kB/s, %lu cycles (%lu ns) each\r\n",
+                           (unsigned long)dwElapsedMs, (unsigned long)dwRate, (unsigned long)dwKBps,
+                           (unsigned long)dwCycles, (unsigned long)dwNs);
+        nRet    = UART_PrintLine(nID, szLine, nLength, TELEMETRY_LINE_SIZE);
+    }
+
+    return nRet;
+}
+
+nhns_status_t TELEMETRY_Benchmark(uart_instance_t nID)
+{
+    uint8_t abSample[TELEMETRY_BENCH_SAMPLE];
+    telemetry_stats_t sBefore;
+    telemetry_stats_t sAfter;
+    uint64_t qwStart      = 0;
+    uint32_t dwElapsedUs  = 0;
+    uint32_t dwDatagrams  = 0;
+    uint32_t dwCycles     = 0;
+    uint32_t dwSequence   = 0;
+    char szLine[TELEMETRY_LINE_SIZE];
+    int nLength = 0;
+
+    if (!NET_IsUp())
+    {
+        nLength = snprintf(szLine, sizeof(szLine), "telemetry: link down\r\n");
+        UART_PrintLine(nID, szLine, nLength, TELEMETRY_LINE_SIZE);
+        return NHNS_STATUS_MODULE_NOT_INIT;
+    }
+
+    // 1) Start from an empty datagram
+    TELEMETRY_Flush();
+    TELEMETRY_GetStats(&sBefore);
+
+    // 2) Samples carry a running counter so the receiver can check them
+    qwStart = CLOCK_GetMicros();
+    while (CLOCK_GetMicros() - qwStart < TELEMETRY_BENCH_MS * 1000ULL)
+    {
+        for (uint32_t dwIndex = 0; dwIndex < sizeof(abSample); dwIndex += sizeof(dwSequence))
+        {
+            FRAME_Put32(&abSample[dwIndex], dwSequence);
+        }
+        dwSequence++;
+        TELEMETRY_Publish(TELEMETRY_CHANNEL_BENCH, abSample, sizeof(abSample));
+    }
+    TELEMETRY_Flush();
+    dwElapsedUs = (uint32_t)(CLOCK_GetMicros() - qwStart);
+    TELEMETRY_GetStats(&sAfter);
+
+    // 3) Report
+    dwDatagrams = sAfter.dwDatagrams - sBefore.dwDatagrams;
+    if (dwDatagrams != 0)
+    {
+        dwCycles = (uint32_t)((sAfter.qwCycles - sBefore.qwCycles) / dwDatagrams);
+    }
+
+    nLength = snprintf(szLine, sizeof(szLine), "telemetry: %lu samples in %lu datagrams, %lu dropped, %lu us\r\n",
+                       (unsigned long)(sAfter.dwRecords - sBefore.dwRecords), (unsigned long)dwDatagrams,
+                       (unsigned long)(sAfter.dwDropped - sBefore.dwDropped), (unsigned long)dwElapsedUs);
+    UART_PrintLine(nID, szLine, nLength, TELEMETRY_LINE_SIZE);
+
+    nLength = snprintf(szLine, sizeof(szLine), "%lu datagrams/s, %lu kB/s, %lu cycles (%lu ns) per datagram\r\n",
+                       (unsigned long)(((uint64_t)dwDatagrams * 1000000) / dwElapsedUs),
+                       (unsigned long)(((uint64_t)(sAfter.dwBytes - sBefore.dwBytes) * 1000) / dwElapsedUs),
+                       (unsigned long)dwCycles,
+                       (unsigned long)(((uint64_t)dwCycles * 1000000000ULL) / PROFILER_GetCyclesPerSecond()));
+
+    return UART_PrintLine(nID, szLine, nLength, TELEMETRY_LINE_SIZE);
+}
@@ -0,0 +1,94 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdint.h>
+#include "nhns_status_codes.h"
+#include "net.h"
+#include "uart.h"
+
+// --- Definitions ---
+
+/*
+ * Batched telemetry over UDP. Samples published by any task are appended to
+ * one open datagram, which is sent when the next sample does not fit or when
+ * the flush period ends, whichever comes first. A datagram is
+ *   u32 sequence, u64 time of its first sample in microseconds,
+ *   then records of u16 channel, u16 length, length bytes
+ * with all fields little-endian, up to NET_UDP_MAX_PAYLOAD bytes. Receivers
+ * read records until the end of the datagram and spot losses by the sequence.
+ */
+
+// Where datagrams go, the address needs an entry in the static ARP table
+#define TELEMETRY_DST_IP          NET_IP4(192, 168, 7, 1)
+#define TELEMETRY_DST_PORT        5005
+#define TELEMETRY_SRC_PORT        5005
+
+// Longest a sample waits in a partly filled datagram
+#define TELEMETRY_FLUSH_MS        20
+
+#define TELEMETRY_HEADER_SIZE     12
+#define TELEMETRY_RECORD_HEADER   4
+#define TELEMETRY_MAX_SAMPLE      (NET_UDP_MAX_PAYLOAD - TELEMETRY_HEADER_SIZE - TELEMETRY_RECORD_HEADER)
+
+// Channel of the samples TELEMETRY_Benchmark publishes
+#define TELEMETRY_CHANNEL_BENCH   0xFFFF
+
+// --- Types ---
+
+typedef struct telemetry_stats
+{
+    uint32_t dwDatagrams;    // Datagrams sent
+    uint32_t dwBytes;        // Payload bytes sent
+    uint32_t dwRecords;      // Samples sent
+    uint32_t dwDropped;      // Samples lost to a missing link, an empty pool or a full TX ring
+    uint64_t qwCycles;       // PROFILER_GetCycles ticks spent publishing and sending, waits excluded
+} telemetry_stats_t;
+
+// --- Functions ---
+
+/**
+ * @brief Create the publisher lock and start the flush timer
+ * @retval Status code indicating operation success or reason for failure
+ * @note NET_Init must have run, samples are dropped until the link is up
+ */
+nhns_status_t TELEMETRY_Init(void);
+
+/**
+ * @brief Append a sample to the open datagram, callable from tasks only
+ * @param wChannel - Channel the receiver sorts samples by
+ * @param pvData - Sample bytes
+ * @param wLength - Sample length, at most TELEMETRY_MAX_SAMPLE
+ * @retval Status code indicating operation success or reason for failure
+ * @note May block for a few ticks when the TX ring is full
+ */
+nhns_status_t TELEMETRY_Publish(uint16_t wChannel, const void *pvData, uint16_t wLength);
+
+/**
+ * @brief Send the open datagram now
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t TELEMETRY_Flush(void);
+
+/**
+ * @brief Get the publisher counters
+ * @param psStats - Returns the statistics
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t TELEMETRY_GetStats(telemetry_stats_t *psStats);
+
+/**
+ * @brief Print the counters, rates since the previous dump and the CPU cost per datagram
+ * @param nID - UART instance to print on
+ * @retval Status code indicating operation success or reason for failure
+ */
+nhns_status_t TELEMETRY_Dump(uart_instance_t nID);
+
+/**
+ * @brief Publish 64-byte samples for one second as fast as possible and print the throughput
+ * @param nID - UART instance to print the results on
+ * @retval Status code indicating operation success or reason for failure
+ * @note Competes with every other publisher, run it while the system is otherwise idle
+ */
+nhns_status_t TELEMETRY_Benchmark(uart_instance_t nID);
+
+#endif    // __TELEMETRY_H__
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Turn deferred log records from the debug UART back into text.
+
+The firmware sends only the offset of each format string in the dlog_fmt ELF
+section plus raw 32-bit arguments (see Service/dlog/dlog.h). This tool reads
+the format strings from the ELF the firmware was built from and does the
+printf formatting on the PC. Console text is passed through unchanged.
+
+Usage: dlog_decode.py [--elf build/NHNS.elf] [input]   (file, FIFO or tty; stdin by default)
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from nhns_frames import TYPE_DLOG, open_input, read_frames
+
+SECTION = "dlog_fmt"
+OFFSET_MASK = 0x00FFFFFF
+COUNT_SHIFT = 24
+LEVEL_SHIFT = 28
+COUNTER_HZ = 1000000
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+CONVERSION_RE = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGcsp%])")
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+
+class Elf:
+    """Just enough of ELF32/ELF64 to read section contents by name and by address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as handle:
+            self.data = handle.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x3A)
+            layout = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", self.data, 0x2E)
+            layout = endian + "IIIIIIIIII"
+        headers = [struct.unpack_from(layout, self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+        self.sections = []
+        for name, kind, flags, addr, offset, size, *_ in headers:
+            start = names[4] + name
+            label = self.data[start:self.data.index(b"\0", start)].decode()
+            self.sections.append((label, kind, flags, addr, offset, size))
+
+    def section(self, name):
+        for label, kind, _, _, offset, size in self.sections:
+            if label == name and kind != SHT_NOBITS:
+                return self.data[offset:offset + size]
+        return None
+
+    def string_at(self, address):
+        """C string at a load address, for %s arguments that point into flash."""
+        for _, kind, flags, addr, offset, size in self.sections:
+            if flags & SHF_ALLOC and kind != SHT_NOBITS and addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                return self.data[start:end if end >= 0 else offset + size].decode("utf-8", "replace")
+        return None
+
+
+def to_signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def format_record(fmt, args, elf):
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        if width == "*":
+            width = str(to_signed(take()))
+        if precision == "*":
+            precision = str(to_signed(take()))
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+        value = take()
+        if conversion in "di":
+            return (spec + "d") % to_signed(value)
+        if conversion in "ouxX":
+            return (spec + conversion) % value
+        if conversion in "eEfFgG":
+            return (spec + conversion) % struct.unpack("<f", struct.pack("<I", value))[0]
+        if conversion == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conversion == "p":
+            return "0x%08x" % value
+        text = elf.string_at(value)
+        return (spec + "s") % (text if text is not None else "<str@0x%08x>" % value)
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode_payload(payload, formats, elf, state):
+    dropped, = struct.unpack_from("<I", payload)
+    if dropped != state["dropped"]:
+        print("--- %d log records dropped ---" % (dropped - state["dropped"]))
+        state["dropped"] = dropped
+    offset = 4
+    while offset + 8 <= len(payload):
+        header, timestamp = struct.unpack_from("<II", payload, offset)
+        count = (header >> COUNT_SHIFT) & 0xF
+        level = LEVELS.get(header >> LEVEL_SHIFT, "?")
+        args = struct.unpack_from("<%dI" % count, payload, offset + 8)
+        offset += 8 + 4 * count
+        start = header & OFFSET_MASK
+        end = formats.find(b"\0", start)
+        if start >= len(formats) or end < 0:
+            print("[%12.6f] %s <unknown format @%d> %s" % (timestamp / COUNTER_HZ, level, start, args))
+            continue
+        text = format_record(formats[start:end].decode("utf-8", "replace"), args, elf)
+        print("[%12.6f] %s %s" % (timestamp / COUNTER_HZ, level, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--elf", default="build/NHNS.elf", help="firmware the records come from")
+    parser.add_argument("input", nargs="?", help="file, FIFO or tty to read, stdin if omitted")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    formats = elf.section(SECTION)
+    if formats is None:
+        print("dlog_decode: %s has no %s section" % (args.elf, SECTION), file=sys.stderr)
+        return 1
+
+    state = {"dropped": 0}
+    try:
+        for kind, _, payload in read_frames(open_input(args.input)):
+            if kind is None:
+                sys.stdout.write(payload.decode("utf-8", "replace"))
+            elif kind == TYPE_DLOG:
+                decode_payload(payload, formats, elf, state)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
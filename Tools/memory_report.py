@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""Per-module flash/RAM usage from a GNU ld map file.
+
+Every input section placed in an allocated output section is charged to the
+module its object file came from (Driver/uart, Library/HAL, libc_nano, ...).
+A section counts towards flash when its load address falls in a read-only
+memory region and towards RAM when its run address falls in a writable one,
+so initialised data is charged to both. ld also prints a load address for
+the zero-filled sections after .data, those never count towards flash.
+
+Kernel objects declared with Service/rtos land in ".bss.rtos.<name>.<kind>"
+input sections; they are listed per object, followed by a breakdown of the
+whole RAM budget including the FreeRTOS heap regions (.heap_* sections).
+
+LTO links hand the linker compiler-generated partitions instead of our object
+files. For those, the symbols listed in the map are looked up in the original
+objects (via --objects/--nm) to recover the module.
+
+Usage: memory_report.py <map> [--objects DIR] [--nm NM]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+REGION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?\s*$")
+OUTPUT_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+INPUT_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*))?\s*$")
+SYMBOL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$")
+LTO_SUFFIX_RE = re.compile(r"\.(lto_priv|constprop|isra|part|cold)\.\d+.*$")
+RTOS_RE = re.compile(r"^\.bss\.rtos\.(\w+)\.(stack|storage|control)$")
+RTOS_KINDS = ("stack", "storage", "control")
+NOLOAD_RE = re.compile(r"^\.(bss|sram2|heap_\w+|_stack|_user_heap_stack)$")
+RESERVE_SECTIONS = ("._user_heap_stack", "._stack")
+
+
+def parse_regions(lines):
+    regions = []
+    in_table = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            in_table = True
+            continue
+        if in_table and line.startswith("Linker script and memory map"):
+            break
+        if not in_table:
+            continue
+        match = REGION_RE.match(line)
+        if match and match.group(1) not in ("Name", "*default*"):
+            regions.append((match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4) or ""))
+    return regions
+
+
+def find_region(regions, address):
+    for name, origin, length, attributes in regions:
+        if origin <= address < origin + length:
+            return name, "w" in attributes
+    return None, False
+
+
+def unwrap(lines):
+    """Join section names that ld wrapped onto their own line with the line that follows."""
+    merged = []
+    pending = None
+    for line in lines:
+        if pending is not None:
+            merged.append(pending + " " + line.lstrip())
+            pending = None
+        elif re.match(r"^ ?\S+$", line) and not line.startswith(" *") and "(" not in line:
+            pending = line
+        else:
+            merged.append(line)
+    return merged
+
+
+def module_of(path, obj_dir):
+    path = path.strip()
+    archive = re.match(r"^(.*?)\.a\((.*)\)$", path)
+    if archive:
+        return os.path.basename(archive.group(1))
+    if obj_dir and path.startswith(obj_dir.rstrip("/") + "/"):
+        path = path[len(obj_dir.rstrip("/")) + 1:]
+    parts = path.split("/")[:-1]
+    if not parts:
+        return os.path.basename(path)
+    return "/".join(parts[:2])
+
+
+def symbol_index(obj_dir, nm):
+    index = {}
+    for root, _, files in os.walk(obj_dir):
+        for name in files:
+            if not name.endswith(".o"):
+                continue
+            path = os.path.join(root, name)
+            try:
+                output = subprocess.run([nm, "--defined-only", path], capture_output=True, text=True).stdout
+            except OSError:
+                return index
+            for line in output.splitlines():
+                fields = line.split()
+                if len(fields) == 3:
+                    index.setdefault(fields[2], module_of(path, obj_dir))
+    return index
+
+
+def print_kernel_objects(rtos):
+    names = sorted(rtos, key=lambda n: (-sum(rtos[n].values()), n))
+    width = max([len(n) for n in names] + [len("Kernel object")])
+    print()
+    print("%-*s %10s %10s %10s %10s" % ((width, "Kernel object") + tuple(k.capitalize() for k in RTOS_KINDS) + ("Total",)))
+    for name in names:
+        sizes = tuple(rtos[name][kind] for kind in RTOS_KINDS)
+        print("%-*s %10d %10d %10d %10d" % ((width, name) + sizes + (sum(sizes),)))
+    totals = tuple(sum(rtos[name][kind] for name in names) for kind in RTOS_KINDS)
+    print("%-*s %10d %10d %10d %10d" % ((width, "Total") + totals + (sum(totals),)))
+
+
+def print_ram_budget(regions, ram, kernel, heap):
+    capacity = sum(length for _, _, length, attributes in regions if "w" in attributes)
+    reserve = ram.get("(heap/stack reserve)", 0)
+    used = sum(ram.values())
+    rows = [
+        ("Kernel objects", kernel),
+        ("FreeRTOS heap", heap),
+        ("Heap/stack reserve", reserve),
+        ("Other data/bss", used - kernel - heap - reserve),
+        ("Free", capacity - used),
+    ]
+    width = max(len(label) for label, _ in rows)
+    print()
+    print("RAM budget, %d bytes" % capacity)
+    for label, size in rows:
+        print("  %-*s %10d (%.1f%%)" % (width, label, size, 100.0 * size / capacity if capacity else 0.0))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map")
+    parser.add_argument("--objects", help="object directory, used to strip paths and attribute LTO partitions")
+    parser.add_argument("--nm", default="nm", help="nm able to read the objects (gcc-nm for LTO)")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as handle:
+        lines = handle.read().splitlines()
+
+    regions = parse_regions(lines)
+    if not regions:
+        print("memory_report: no MEMORY regions in %s, nothing to report" % args.map)
+        return 0
+
+    body = lines[next(i for i, line in enumerate(lines) if line.startswith("Linker script and memory map")) + 1:]
+    body = unwrap(body)
+
+    index = None
+    flash = defaultdict(int)
+    ram = defaultdict(int)
+    region_used = defaultdict(int)
+    rtos = defaultdict(lambda: defaultdict(int))
+    rtos_heap = 0
+
+    out_name = ""
+    out_writable = False
+    out_load_in_flash = False
+    current = None
+
+    def charge(entry):
+        module, size = entry
+        if out_writable:
+            ram[module] += size
+        if out_load_in_flash:
+            flash[module] += size
+
+    for line in body:
+        output = OUTPUT_RE.match(line)
+        if output and not line.startswith(" "):
+            if current:
+                charge(current)
+                current = None
+            out_name = output.group(1)
+            vma = int(output.group(2), 16)
+            size = int(output.group(3), 16)
+            lma = int(output.group(4), 16) if output.group(4) else vma
+            vma_region, out_writable = find_region(regions, vma)
+            lma_region, lma_writable = find_region(regions, lma)
+            out_load_in_flash = lma_region is not None and not lma_writable and not NOLOAD_RE.match(out_name)
+            if vma_region is None:
+                out_writable = False
+            if vma_region:
+                region_used[vma_region] += size
+            if out_load_in_flash and lma_region != vma_region:
+                region_used[lma_region] += size
+            continue
+
+        entry = INPUT_RE.match(line)
+        if entry:
+            if current:
+                charge(current)
+            size = int(entry.group(3), 16)
+            path = entry.group(4) or ""
+            kernel = RTOS_RE.match(entry.group(1))
+            if kernel and out_writable:
+                rtos[kernel.group(1)][kernel.group(2)] += size
+            if size == 0:
+                current = None
+            elif out_name in RESERVE_SECTIONS:
+                current = ("(heap/stack reserve)", size)
+            elif out_name.startswith(".heap_"):
+                current = ("(FreeRTOS heap)", size)
+                rtos_heap += size if out_writable else 0
+            elif entry.group(1) == "*fill*":
+                current = ("(padding)", size)
+            elif ".ltrans" in path:
+                current = ["(lto)", size]
+            else:
+                current = (module_of(path, args.objects), size)
+            continue
+
+        symbol = SYMBOL_RE.match(line)
+        if symbol and isinstance(current, list) and current[0] == "(lto)":
+            if index is None:
+                index = symbol_index(args.objects, args.nm) if args.objects else {}
+            name = LTO_SUFFIX_RE.sub("", symbol.group(2))
+            if name in index:
+                current = (index[name], current[1])
+
+    if current:
+        charge(tuple(current))
+
+    modules = sorted(set(flash) | set(ram), key=lambda m: (-flash[m], -ram[m], m))
+    width = max([len(m) for m in modules] + [len("Module")])
+    print("%-*s %10s %10s" % (width, "Module", "Flash", "RAM"))
+    for module in modules:
+        print("%-*s %10d %10d" % (width, module, flash[module], ram[module]))
+    print("%-*s %10d %10d" % (width, "Total", sum(flash.values()), sum(ram.values())))
+    print()
+    for name, origin, length, _ in regions:
+        used = region_used.get(name, 0)
+        print("%-*s %10d / %d bytes (%.1f%%)" % (width, name, used, length, 100.0 * used / length if length else 0.0))
+
+    if rtos:
+        print_kernel_objects(rtos)
+    print_ram_budget(regions, ram, sum(sum(kinds.values()) for kinds in rtos.values()), rtos_heap)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,72 @@
+"""Binary frames multiplexed onto the debug console (see Service/frame/frame.h).
+
+Frames are A5 5A, u8 type, u8 sequence, u16 length, payload, u16 CRC-16/CCITT-FALSE,
+little-endian. Text and corrupted bytes between frames are handed back separately
+so tools can still show the plain console output.
+"""
+
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+HEADER = struct.Struct("<BBH")
+TYPE_RTSTATS = 0x01
+TYPE_DLOG = 0x02
+
+# Longer announced payloads are taken as a false sync, so text cannot stall the stream
+MAX_PAYLOAD = 4096
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def read_frames(stream):
+    """Yield (type, sequence, payload) for every valid frame and (None, None, text) for bytes in between."""
+    buffer = b""
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            if buffer:
+                yield None, None, buffer
+            return
+        buffer += chunk
+        start = buffer.find(SYNC)
+        if start < 0:
+            # Keep a trailing A5, it may be the start of the next sync
+            keep = 1 if buffer.endswith(SYNC[:1]) else 0
+            if len(buffer) > keep:
+                yield None, None, buffer[:len(buffer) - keep]
+                buffer = buffer[len(buffer) - keep:]
+            continue
+        if start > 0:
+            yield None, None, buffer[:start]
+            buffer = buffer[start:]
+        if len(buffer) < len(SYNC) + HEADER.size:
+            continue
+        kind, sequence, length = HEADER.unpack_from(buffer, len(SYNC))
+        if length > MAX_PAYLOAD:
+            yield None, None, buffer[:1]
+            buffer = buffer[1:]
+            continue
+        total = len(SYNC) + HEADER.size + length + 2
+        if len(buffer) < total:
+            continue
+        body = buffer[len(SYNC):total - 2]
+        (crc,) = struct.unpack_from("<H", buffer, total - 2)
+        if crc16(body) != crc:
+            # Not a frame after all, pass the first byte through as text and rescan
+            yield None, None, buffer[:1]
+            buffer = buffer[1:]
+            continue
+        yield kind, sequence, body[HEADER.size:]
+        buffer = buffer[total:]
+
+
+def open_input(path):
+    return open(path, "rb", buffering=0) if path else sys.stdin.buffer
@@ -0,0 +1,486 @@
+#!/usr/bin/env python3
+"""Convert a float model into the q7 tables Service/nnrt runs from flash.
+
+The model is a JSON layer list, in execution order, after an input shape:
+
+    {"name": "tinycnn",
+     "input": {"dim": 16, "channels": 3, "range": 1.0, "frac_bits": 7},
+     "layers": [
+        {"name": "conv1", "type": "conv", "channels": 8, "kernel": 5, "stride": 1, "padding": 2,
+         "weights": [...], "bias": [...]},
+        {"name": "relu1", "type": "relu"},
+        {"name": "pool1", "type": "maxpool", "kernel": 2, "stride": 2},
+        {"name": "fc", "type": "fc", "outputs": 10, "weights": [...], "bias": [...]},
+        {"name": "softmax", "type": "softmax"}]}
+
+Convolution weights are [out][y][x][in] and fully connected weights [out][in]
+with the input flattened HWC, flat or nested (numpy's tolist() will do).
+Types are conv, relu, maxpool, avepool, fc and softmax. A fully connected layer
+runs on arm_fully_connected_q7_opt unless it says "kernel": "basic".
+
+Every weight, bias and activation gets its own power-of-two scale. The input
+scale fits "range" unless "frac_bits" sets it, saturating the top. Activation
+ranges come from running the float model on the "calibration" inputs, or on
+uniform noise within the input range when there are none. The shifts follow:
+bias_shift = in + weight - bias and out_shift = in + weight - out, in fraction
+bits. The _opt weights are interleaved here, so the firmware never converts.
+
+The tool writes nnrt_<name>.c and nnrt_<name>.h: const weights that the linker
+keeps in flash, the tensor and layer tables, and an arena sized with the same
+plan NNRT_Init makes. It then runs the q7 model bit for bit as the kernels do
+and prints how far it is from the float one.
+
+Usage: nnrt_convert.py model.json [--out-dir Service/nnrt] [--calibrate N] [--seed N]
+"""
+
+import argparse
+import json
+import math
+import os
+import random
+import sys
+
+ALIGNMENT = 4
+MAX_TENSORS = 16
+MAX_LAYERS = 16
+MAX_FRAC = 15
+MIN_FRAC = -8
+KINDS = {"conv": "NNRT_KIND_CONV", "relu": "NNRT_KIND_RELU", "maxpool": "NNRT_KIND_MAXPOOL",
+         "avepool": "NNRT_KIND_AVEPOOL", "fc": "NNRT_KIND_FC", "fc_opt": "NNRT_KIND_FC_OPT",
+         "softmax": "NNRT_KIND_SOFTMAX"}
+
+
+def flatten(values):
+    if isinstance(values, (list, tuple)):
+        return [item for value in values for item in flatten(value)]
+    return [float(values)]
+
+
+def frac_bits(peak):
+    """Most fraction bits that still fit peak in a q7."""
+    for frac in range(MAX_FRAC, MIN_FRAC - 1, -1):
+        if round(peak * 2.0 ** frac) <= 127:
+            return frac
+    raise ValueError("%g does not fit a q7 at any scale" % peak)
+
+
+def quantize(values, frac):
+    return [max(-128, min(127, int(round(value * 2.0 ** frac)))) for value in values]
+
+
+def snr(reference, actual):
+    signal = sum(value * value for value in reference)
+    noise = sum((a - b) * (a - b) for a, b in zip(reference, actual))
+    if noise == 0:
+        return float("inf")
+    if signal == 0:
+        return float("-inf")
+    return 10.0 * math.log10(signal / noise)
+
+
+def window_output(dim, kernel, stride, padding):
+    if kernel == 0 or stride == 0 or dim + 2 * padding < kernel:
+        return 0
+    return (dim + 2 * padding - kernel) // stride + 1
+
+
+class Layer:
+    def __init__(self, spec, index, shape):
+        self.name = spec.get("name", "layer%d" % index)
+        self.type = spec["type"]
+        self.kernel = spec.get("kernel", 0)
+        self.stride = spec.get("stride", 1)
+        self.padding = spec.get("padding", 0)
+        self.weights = flatten(spec["weights"]) if "weights" in spec else None
+        self.bias = flatten(spec["bias"]) if "bias" in spec else None
+        dim, channels = shape
+        if self.type == "conv":
+            self.out_shape = (window_output(dim, self.kernel, self.stride, self.padding), spec["channels"])
+            expected = spec["channels"] * self.kernel * self.kernel * channels
+        elif self.type in ("maxpool", "avepool"):
+            self.out_shape = (window_output(dim, self.kernel, self.stride, self.padding), channels)
+            expected = None
+        elif self.type == "fc":
+            if spec.get("kernel", "opt") not in ("opt", "basic"):
+                raise ValueError("%s: kernel is opt or basic" % self.name)
+            self.type = "fc_opt" if spec.get("kernel", "opt") == "opt" else "fc"
+            self.kernel = 0
+            self.out_shape = (1, spec["outputs"])
+            expected = spec["outputs"] * dim * dim * channels
+        elif self.type in ("relu", "softmax"):
+            self.out_shape = shape
+            expected = None
+        else:
+            raise ValueError("%s: unknown type %s" % (self.name, self.type))
+        if self.out_shape[0] == 0:
+            raise ValueError("%s: the window does not fit the input" % self.name)
+        if expected is not None:
+            if self.weights is None or len(self.weights) != expected:
+                raise ValueError("%s: %d weights expected" % (self.name, expected))
+            if self.bias is None or len(self.bias) != self.out_shape[1]:
+                raise ValueError("%s: %d biases expected" % (self.name, self.out_shape[1]))
+        self.in_frac = self.out_frac = 0
+        self.weight_frac = self.bias_frac = 0
+        self.bias_shift = self.out_shift = 0
+        self.q_weights = self.q_bias = None
+
+
+# --- The layers on HWC vectors, float and as the q7 kernels compute them ---
+
+def conv(x, shape, layer, weights, bias, quant):
+    dim, cin = shape
+    odim, cout = layer.out_shape
+    k, s, p = layer.kernel, layer.stride, layer.padding
+    out = []
+    for oy in range(odim):
+        for ox in range(odim):
+            for oc in range(cout):
+                if quant:
+                    acc = (bias[oc] << layer.bias_shift) + ((1 << layer.out_shift) >> 1)
+                else:
+                    acc = bias[oc]
+                for ky in range(k):
+                    iy = oy * s - p + ky
+                    if iy < 0 or iy >= dim:
+                        continue
+                    for kx in range(k):
+                        ix = ox * s - p + kx
+                        if ix < 0 or ix >= dim:
+                            continue
+                        base = (iy * dim + ix) * cin
+                        wbase = ((oc * k + ky) * k + kx) * cin
+                        for ic in range(cin):
+                            acc += x[base + ic] * weights[wbase + ic]
+                out.append(max(-128, min(127, acc >> layer.out_shift)) if quant else acc)
+    return out
+
+
+def pool(x, shape, layer, quant):
+    dim, channels = shape
+    odim = layer.out_shape[0]
+    k, s, p = layer.kernel, layer.stride, layer.padding
+    out = []
+    for oy in range(odim):
+        for ox in range(odim):
+            for c in range(channels):
+                values = [x[(iy * dim + ix) * channels + c]
+                          for iy in range(oy * s - p, oy * s - p + k) if 0 <= iy < dim
+                          for ix in range(ox * s - p, ox * s - p + k) if 0 <= ix < dim]
+                if layer.type == "maxpool":
+                    out.append(max(values))
+                elif quant:
+                    total = sum(values)
+                    out.append(total // len(values) if total >= 0 else -((-total) // len(values)))
+                else:
+                    out.append(sum(values) / len(values))
+    return out
+
+
+def fully_connected(x, layer, weights, bias, quant):
+    out = []
+    for row in range(layer.out_shape[1]):
+        if quant:
+            acc = (bias[row] << layer.bias_shift) + ((1 << layer.out_shift) >> 1)
+        else:
+            acc = bias[row]
+        base = row * len(x)
+        for col, value in enumerate(x):
+            acc += value * weights[base + col]
+        out.append(max(-128, min(127, acc >> layer.out_shift)) if quant else acc)
+    return out
+
+
+def run(layers, x, shape, quant):
+    """Outputs of every layer, softmax left out: the logits are what gets compared."""
+    outputs = []
+    for layer in layers:
+        if layer.type == "conv":
+            x = conv(x, shape, layer, layer.q_weights if quant else layer.weights,
+                     layer.q_bias if quant else layer.bias, quant)
+        elif layer.type == "relu":
+            x = [max(0, value) for value in x]
+        elif layer.type in ("maxpool", "avepool"):
+            x = pool(x, shape, layer, quant)
+        elif layer.type in ("fc", "fc_opt"):
+            x = fully_connected(x, layer, layer.q_weights if quant else layer.weights,
+                                layer.q_bias if quant else layer.bias, quant)
+        shape = layer.out_shape
+        outputs.append(x)
+    return outputs
+
+
+# --- Conversion ---
+
+def interleave_opt(weights, rows, cols):
+    """Reorder [out][in] weights the way arm_fully_connected_q7_opt reads them."""
+    out = []
+    for r in range(0, rows - rows % 4, 4):
+        for c in range(0, cols - cols % 4, 4):
+            for rr, cc in ((0, 0), (1, 0), (0, 2), (1, 2), (2, 0), (3, 0), (2, 2), (3, 2),
+                           (0, 1), (1, 1), (0, 3), (1, 3), (2, 1), (3, 1), (2, 3), (3, 3)):
+                out.append(weights[(r + rr) * cols + c + cc])
+        for c in range(cols - cols % 4, cols):
+            for rr in range(4):
+                out.append(weights[(r + rr) * cols + c])
+    out.extend(weights[(rows - rows % 4) * cols:])
+    return out
+
+
+def quantize_model(layers, input_frac, calibration, shape):
+    peaks = [0.0] * len(layers)
+    for x in calibration:
+        for index, values in enumerate(run(layers, x, shape, False)):
+            peaks[index] = max(peaks[index], max(abs(value) for value in values))
+
+    frac = input_frac
+    for index, layer in enumerate(layers):
+        layer.in_frac = frac
+        if layer.weights is not None:
+            layer.weight_frac = frac_bits(max(abs(value) for value in layer.weights))
+            layer.bias_frac = frac_bits(max(abs(value) for value in layer.bias))
+            product = frac + layer.weight_frac
+            layer.bias_frac = min(layer.bias_frac, product)
+            frac = min(frac_bits(peaks[index]), product - 1)
+            layer.bias_shift = product - layer.bias_frac
+            layer.out_shift = product - frac
+            if layer.out_shift > 31 or layer.bias_shift > 31:
+                raise ValueError("%s: shifts out of range, check the weight scales" % layer.name)
+            layer.q_weights = quantize(layer.weights, layer.weight_frac)
+            layer.q_bias = quantize(layer.bias, layer.bias_frac)
+        elif layer.type == "softmax":
+            frac = 7
+        layer.out_frac = frac
+
+
+def plan(tensors, layers):
+    """The arena plan of NNRT_Plan in Service/nnrt/nnrt.c, for the arena size."""
+    blocks = []
+    for size, first, last in tensors:
+        blocks.append([(size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT, first, last, 0])
+    for index, layer in enumerate(layers):
+        if layer.scratch:
+            blocks.append([(layer.scratch + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT, index, index, 0])
+    placed = []
+    peak = 0
+    for block in sorted(blocks, key=lambda block: -block[0]):
+        moved = True
+        while moved:
+            moved = False
+            for other in placed:
+                if (other[1] <= block[2] and block[1] <= other[2] and
+                        other[3] < block[3] + block[0] and block[3] < other[3] + other[0]):
+                    block[3] = other[3] + other[0]
+                    moved = True
+        placed.append(block)
+        peak = max(peak, block[3] + block[0])
+    return peak, sum(block[0] for block in blocks)
+
+
+def c_array(values, indent="    ", per_line=16):
+    lines = []
+    for start in range(0, len(values), per_line):
+        lines.append(indent + ", ".join("%4d" % value for value in values[start:start + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def emit(model, layers, shapes, input_frac, out_dir, source):
+    name = model["name"]
+    symbol = model.get("symbol", "".join(part.capitalize() for part in name.split("_")))
+    prefix = name.upper()
+    guard = "__NNRT_%s_H__" % prefix
+
+    # Tensors in a chain: the input, then one per layer that does not work in place
+    tensors = [[shapes[0], 0, 0]]
+    for index, layer in enumerate(layers):
+        tensors[-1][2] = index
+        layer.input = len(tensors) - 1
+        if layer.type != "relu":
+            tensors.append([layer.out_shape, index, index])
+        layer.output = len(tensors) - 1
+    tensors[-1][2] = len(layers) - 1
+    if len(tensors) > MAX_TENSORS or len(layers) > MAX_LAYERS:
+        raise ValueError("nnrt takes up to %d tensors and %d layers" % (MAX_TENSORS, MAX_LAYERS))
+
+    for layer in layers:
+        (dim, cin), (odim, cout) = tensors[layer.input][0], layer.out_shape
+        layer.scratch = {"conv": 2 * cin * layer.kernel * layer.kernel * 2, "avepool": 2 * odim * cin,
+                         "fc": dim * dim * cin * 2, "fc_opt": dim * dim * cin * 2}.get(layer.type, 0)
+    sizes = [(shape[0] * shape[0] * shape[1], first, last) for shape, first, last in tensors]
+    peak, unshared = plan(sizes, layers)
+
+    header = []
+    header.append("#ifndef %s" % guard)
+    header.append("#define %s" % guard)
+    header.append("")
+    header.append('#include "nnrt.h"')
+    header.append("")
+    header.append("// --- Definitions ---")
+    header.append("")
+    header.append("/*")
+    header.append(" * Generated by Tools/nnrt_convert.py from %s, do not edit." % source)
+    header.append(" * The input is q7 with %d fraction bits: write round(x * 2^%d), saturated." % (input_frac, input_frac))
+    header.append(" */")
+    header.append("")
+    defines = [("%s_INPUT_DIM" % prefix, shapes[0][0]),
+               ("%s_INPUT_CHANNELS" % prefix, shapes[0][1]),
+               ("%s_INPUT_FRAC_BITS" % prefix, input_frac),
+               ("%s_OUTPUTS" % prefix, layers[-1].out_shape[0] ** 2 * layers[-1].out_shape[1]),
+               ("%s_OUTPUT_FRAC_BITS" % prefix, layers[-1].out_frac),
+               ("%s_ARENA_SIZE" % prefix, peak)]
+    width = max(len(define) for define, _ in defines)
+    for define, value in defines:
+        header.append("#define %-*s %d" % (width, define, value))
+    header.append("")
+    header.append("// --- Functions ---")
+    header.append("")
+    header.append("/**")
+    header.append(" * @brief Get the %s model, its weights in flash and its arena in RAM" % name)
+    header.append(" * @retval Model to pass to NNRT_Init")
+    header.append(" */")
+    header.append("nnrt_model_t *%s_GetModel(void);" % prefix)
+    header.append("")
+    header.append("#endif    // %s" % guard)
+
+    body = []
+    body.append('#include "nnrt_%s.h"' % name)
+    body.append("")
+    body.append("/*")
+    body.append(" * Generated by Tools/nnrt_convert.py from %s, do not edit." % source)
+    body.append(" *")
+    body.append(" * %-8s %-8s %4s %4s %4s %4s %6s %6s" % ("layer", "type", "in", "w", "bias", "out", "bshift", "oshift"))
+    for layer in layers:
+        if layer.weights is not None:
+            body.append(" * %-8s %-8s %4d %4d %4d %4d %6d %6d" % (layer.name, layer.type, layer.in_frac, layer.weight_frac,
+                                                                 layer.bias_frac, layer.out_frac, layer.bias_shift,
+                                                                 layer.out_shift))
+        else:
+            body.append(" * %-8s %-8s %4d %4s %4s %4d" % (layer.name, layer.type, layer.in_frac, "", "", layer.out_frac))
+    body.append(" *")
+    body.append(" * Fraction bits per value, then the shifts the kernels apply. The arena holds")
+    body.append(" * %d bytes of buffers in %d." % (unshared, peak))
+    body.append(" */")
+    body.append("")
+    body.append("// --- Global Variables ---")
+    body.append("")
+    for layer in layers:
+        if layer.weights is None:
+            continue
+        cname = "".join(part.capitalize() for part in layer.name.replace("-", "_").split("_"))
+        weights = layer.q_weights
+        if layer.type == "fc_opt":
+            weights = interleave_opt(weights, layer.out_shape[1], len(weights) // layer.out_shape[1])
+        layer.weights_symbol = "gab%s%sWeights" % (symbol, cname)
+        layer.bias_symbol = "gab%s%sBias" % (symbol, cname)
+        order = "interleaved for arm_fully_connected_q7_opt" if layer.type == "fc_opt" else \
+            ("[out][y][x][in]" if layer.type == "conv" else "[out][in]")
+        body.append("// %s, %s" % (layer.name, order))
+        body.append("static const q7_t %s[%d] __attribute__((aligned(NNRT_ALIGNMENT))) = {" % (layer.weights_symbol, len(weights)))
+        body.append(c_array(weights))
+        body.append("};")
+        body.append("static const q7_t %s[%d] = {" % (layer.bias_symbol, len(layer.q_bias)))
+        body.append(c_array(layer.q_bias))
+        body.append("};")
+        body.append("")
+    body.append("static uint8_t gab%sArena[%s_ARENA_SIZE] __attribute__((aligned(NNRT_ALIGNMENT)));" % (symbol, prefix))
+    body.append("")
+    body.append("static nnrt_tensor_t gas%sTensors[%d] = {" % (symbol, len(tensors)))
+    for shape, _, _ in tensors:
+        body.append("    {%d, %d}," % shape)
+    body.append("};")
+    body.append("")
+    body.append("static nnrt_layer_t gas%sLayers[%d] = {" % (symbol, len(layers)))
+    for layer in layers:
+        fields = [("szName", '"%s"' % layer.name), ("nKind", KINDS[layer.type]),
+                  ("bInput", layer.input), ("bOutput", layer.output)]
+        if layer.type in ("conv", "maxpool", "avepool"):
+            fields += [("bKernel", layer.kernel), ("bStride", layer.stride), ("bPadding", layer.padding)]
+        if layer.weights is not None:
+            fields += [("bBiasShift", layer.bias_shift), ("bOutShift", layer.out_shift),
+                       ("pbWeights", layer.weights_symbol), ("pbBias", layer.bias_symbol)]
+        width = max(len(field) for field, _ in fields)
+        lines = [".%-*s = %s" % (width, field, value) for field, value in fields]
+        body.append("    {" + (",\n     ".join(lines)) + "},")
+    body.append("};")
+    body.append("")
+    model_fields = [("szName", '"%s"' % name), ("psTensors", "gas%sTensors" % symbol), ("dwTensors", len(tensors)),
+                    ("psLayers", "gas%sLayers" % symbol), ("dwLayers", len(layers)), ("bInput", 0),
+                    ("bOutput", len(tensors) - 1), ("pbArena", "gab%sArena" % symbol),
+                    ("dwArenaSize", "%s_ARENA_SIZE" % prefix)]
+    width = max(len(field) for field, _ in model_fields)
+    body.append("static nnrt_model_t gs%s = {" % symbol)
+    for field, value in model_fields:
+        body.append("    .%-*s = %s," % (width, field, value))
+    body.append("};")
+    body.append("")
+    body.append("// --- Functions ---")
+    body.append("")
+    body.append("nnrt_model_t *%s_GetModel(void)" % prefix)
+    body.append("{")
+    body.append("    return &gs%s;" % symbol)
+    body.append("}")
+
+    base = os.path.join(out_dir, "nnrt_%s" % name)
+    with open(base + ".h", "w") as handle:
+        handle.write("\n".join(header) + "\n")
+    with open(base + ".c", "w") as handle:
+        handle.write("\n".join(body) + "\n")
+    return base, peak, unshared
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("model", help="float model, JSON")
+    parser.add_argument("--out-dir", default="Service/nnrt", help="where to write nnrt_<name>.c and .h")
+    parser.add_argument("--calibrate", type=int, default=16, help="noise inputs when the model has no calibration set")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the noise inputs")
+    args = parser.parse_args()
+
+    with open(args.model) as handle:
+        model = json.load(handle)
+    dim, channels = model["input"]["dim"], model["input"]["channels"]
+    extent = float(model["input"].get("range", 1.0))
+    size = dim * dim * channels
+
+    try:
+        layers, shapes = [], [(dim, channels)]
+        for index, spec in enumerate(model["layers"]):
+            if index and layers[-1].type == "softmax":
+                raise ValueError("softmax has to be the last layer")
+            layers.append(Layer(spec, index, shapes[-1]))
+            shapes.append(layers[-1].out_shape)
+
+        if "calibration" in model:
+            calibration = [flatten(x) for x in model["calibration"]]
+            if any(len(x) != size for x in calibration):
+                raise ValueError("calibration inputs are %d values" % size)
+        else:
+            rng = random.Random(args.seed)
+            calibration = [[rng.uniform(-extent, extent) for _ in range(size)] for _ in range(args.calibrate)]
+        input_frac = model["input"].get("frac_bits",
+                                        frac_bits(max(extent, max(abs(v) for x in calibration for v in x))))
+        quantize_model(layers, input_frac, calibration, shapes[0])
+        base, peak, unshared = emit(model, layers, shapes, input_frac, args.out_dir, os.path.basename(args.model))
+    except (KeyError, ValueError) as error:
+        sys.exit("%s: %s" % (args.model, error))
+
+    # The q7 model next to the float one, on the calibration inputs
+    worst, agree, logits = float("inf"), 0, len(layers) - 1 if layers[-1].type == "softmax" else len(layers)
+    for x in calibration:
+        reference = run(layers, x, shapes[0], False)[logits - 1]
+        q = run(layers, quantize(x, input_frac), shapes[0], True)[logits - 1]
+        scale = 2.0 ** -layers[logits - 1].out_frac
+        actual = [value * scale for value in q]
+        worst = min(worst, snr(reference, actual))
+        agree += reference.index(max(reference)) == actual.index(max(actual))
+    for layer in layers:
+        if layer.weights is not None:
+            print("%-8s %-8s weights SNR %5.1f dB, bias_shift %2d, out_shift %2d" %
+                  (layer.name, layer.type, snr(layer.weights, [v * 2.0 ** -layer.weight_frac for v in layer.q_weights]),
+                   layer.bias_shift, layer.out_shift))
+    print("%s: worst output SNR %.1f dB, top-1 agrees on %d of %d inputs" % (layers[logits - 1].name, worst, agree,
+                                                                             len(calibration)))
+    print("wrote %s.c and .h, arena %d bytes (%d unshared)" % (base, peak, unshared))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Decode run-time statistics frames streamed on the debug UART.
+
+Only frames whose CRC matches are decoded; console text and other frame types
+are skipped. See Service/rtstats/rtstats.h for the payload layout.
+
+Usage: rtstats_decode.py [input]   (file, FIFO or tty; stdin by default)
+"""
+
+import argparse
+import struct
+import sys
+
+from nhns_frames import TYPE_RTSTATS, open_input, read_frames
+
+SUMMARY = struct.Struct("<IIIIBB")
+TASK = struct.Struct("<BBBHHHB")
+ISR = struct.Struct("<BIHHB")
+STATES = {0: "X", 1: "R", 2: "B", 3: "S", 4: "D", 5: "?"}
+
+
+def load(value):
+    return "%6.2f%%" % (value / 100.0)
+
+
+def print_load(payload, sequence):
+    timestamp, hz, short_ticks, long_ticks, tasks, isrs = SUMMARY.unpack_from(payload)
+    offset = SUMMARY.size
+    print("#%-3d t=%.3fs  windows %.1fs / %.1fs" % (sequence, timestamp / hz, short_ticks / hz, long_ticks / hz))
+    print("  %-3s %-16s %4s %5s %8s %8s %6s" % ("id", "task", "prio", "state", "short", "long", "stack"))
+    for _ in range(tasks):
+        number, priority, state, short, long_, stack, length = TASK.unpack_from(payload, offset)
+        offset += TASK.size
+        name = payload[offset:offset + length].decode("ascii", "replace")
+        offset += length
+        print("  %-3d %-16s %4d %5s %8s %8s %6d" % (number, name, priority, STATES.get(state, "?"), load(short), load(long_), stack))
+    print("  %-3s %-16s %10s %8s %8s" % ("irq", "handler", "count", "short", "long"))
+    for _ in range(isrs):
+        number, count, short, long_, length = ISR.unpack_from(payload, offset)
+        offset += ISR.size
+        name = payload[offset:offset + length].decode("ascii", "replace")
+        offset += length
+        print("  %-3d %-16s %10d %8s %8s" % (number, name, count, load(short), load(long_)))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="file, FIFO or tty to read, stdin if omitted")
+    args = parser.parse_args()
+
+    try:
+        for kind, sequence, payload in read_frames(open_input(args.input)):
+            if kind == TYPE_RTSTATS:
+                print_load(payload, sequence)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())